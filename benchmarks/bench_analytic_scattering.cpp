@@ -0,0 +1,157 @@
+// Compares the analytic beam-core integral with the shader's quadratic ray march over random
+// spotlight cones and camera rays: error against a converged integral and time per segment.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Core/Config.h"
+#include "Rendering/AnalyticScattering.h"
+#include "Rendering/VolumetricReference.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+struct Segment
+{
+    DirectX::XMFLOAT3 light;
+    DirectX::XMFLOAT3 origin;
+    DirectX::XMFLOAT3 dir;
+    float t0;
+    float t1;
+};
+
+float Phase(const Segment &s, float t, float g, float &outDist2)
+{
+    const float px = s.origin.x + (s.dir.x * t) - s.light.x;
+    const float py = s.origin.y + (s.dir.y * t) - s.light.y;
+    const float pz = s.origin.z + (s.dir.z * t) - s.light.z;
+    outDist2 = (px * px) + (py * py) + (pz * pz);
+    const float cosTheta = ((s.dir.x * px) + (s.dir.y * py) + (s.dir.z * pz)) / (std::max)(std::sqrt(outDist2), 0.0001f);
+    return AnalyticScattering::HenyeyGreenstein(cosTheta, g);
+}
+
+/**
+ * @brief The shader's march: quadratic step distribution, no jitter (noise 0.5).
+ */
+float March(const Segment &s, float g, int steps)
+{
+    const float length = s.t1 - s.t0;
+    float sum = 0.0f;
+    for (int i = 0; i < steps; ++i)
+    {
+        const float tn = (static_cast<float>(i) + 0.5f) / static_cast<float>(steps);
+        const float tq = 1.0f - ((1.0f - tn) * (1.0f - tn));
+        float dist2;
+        const float phase = Phase(s, s.t0 + (tq * length), g, dist2);
+        sum += phase / (dist2 + 1.0f) * 2.0f * (1.0f - tn) / static_cast<float>(steps) * length;
+    }
+    return sum;
+}
+
+double Converged(const Segment &s, float g)
+{
+    constexpr int STEPS = 20000;
+    const double dt = (static_cast<double>(s.t1) - s.t0) / STEPS;
+    double sum = 0.0;
+    for (int i = 0; i < STEPS; ++i)
+    {
+        float dist2;
+        const float phase = Phase(s, static_cast<float>(s.t0 + ((i + 0.5) * dt)), g, dist2);
+        sum += phase / (static_cast<double>(dist2) + 1.0) * dt;
+    }
+    return sum;
+}
+
+DirectX::XMFLOAT3 Normalize(float x, float y, float z)
+{
+    const float length = std::sqrt((x * x) + (y * y) + (z * z));
+    return {x / length, y / length, z / length};
+}
+
+struct Result
+{
+    double meanError = 0.0;
+    double maxError = 0.0;
+    double nsPerSegment = 0.0;
+};
+
+template <typename F> Result Measure(const std::vector<Segment> &segments, const std::vector<double> &reference, F &&eval)
+{
+    Result result;
+    volatile float sink = 0.0f;
+    const auto start = Clock::now();
+    for (int repeat = 0; repeat < 10; ++repeat)
+        for (const Segment &s : segments)
+            sink = sink + eval(s);
+    result.nsPerSegment = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                          (10.0 * static_cast<double>(segments.size()));
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        const double error = std::fabs(eval(segments[i]) - reference[i]) / reference[i];
+        result.meanError += error / static_cast<double>(segments.size());
+        result.maxError = (std::max)(result.maxError, error);
+    }
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // Lights over a stage aimed at random floor points; camera rays aimed into each beam
+    const float g = Config::Volumetric::DEFAULT_ANISOTROPY;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Segment> segments;
+    while (segments.size() < 2000)
+    {
+        Segment s;
+        s.light = {-15.0f + (30.0f * unit(rng)), 8.0f + (8.0f * unit(rng)), -10.0f + (20.0f * unit(rng))};
+        const DirectX::XMFLOAT3 axis =
+            Normalize(-15.0f + (30.0f * unit(rng)) - s.light.x, -s.light.y, -10.0f + (20.0f * unit(rng)) - s.light.z);
+        const float beam = 0.9f + (0.09f * unit(rng));
+        const float along = 2.0f + (12.0f * unit(rng));
+        const float spread = std::sqrt(1.0f - (beam * beam)) / beam * along * (unit(rng) - 0.5f);
+        const DirectX::XMFLOAT3 target = {s.light.x + (axis.x * along) + spread, s.light.y + (axis.y * along),
+                                          s.light.z + (axis.z * along) - spread};
+        s.origin = {-20.0f + (40.0f * unit(rng)), 1.0f + (10.0f * unit(rng)), -35.0f + (10.0f * unit(rng))};
+        s.dir = Normalize(target.x - s.origin.x, target.y - s.origin.y, target.z - s.origin.z);
+
+        const DirectX::XMFLOAT2 core =
+            VolumetricReference::RayConeIntersect(s.origin, s.dir, s.light, axis, beam, Config::Spotlight::DEFAULT_RANGE);
+        if (core.x < 0.0f || core.y <= core.x + 0.01f)
+            continue;
+        s.t0 = (std::max)(0.0f, core.x);
+        s.t1 = (std::min)(core.y, 100.0f);
+        segments.push_back(s);
+    }
+
+    std::vector<double> reference;
+    for (const Segment &s : segments)
+        reference.push_back(Converged(s, g));
+
+    AnalyticScattering::Table table;
+    const auto buildStart = Clock::now();
+    AnalyticScattering::BuildTable(g, table);
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+    const Result analytic = Measure(segments, reference,
+                                    [&](const Segment &s)
+                                    { return AnalyticScattering::Integrate(table, s.light, s.origin, s.dir, s.t0, s.t1); });
+    std::cout << segments.size() << " beam-core segments, g = " << g << ", table " << table.width << "x"
+              << table.height << " built in " << buildMs << " ms\n"
+              << "  analytic:  mean error " << 100.0 * analytic.meanError << "%, max " << 100.0 * analytic.maxError
+              << "%, " << analytic.nsPerSegment << " ns\n";
+    for (int steps : {16, 32, 128})
+    {
+        const Result march = Measure(segments, reference, [&](const Segment &s) { return March(s, g, steps); });
+        std::cout << "  march " << steps << (steps < 100 ? ":  " : ": ") << " mean error " << 100.0 * march.meanError
+                  << "%, max " << 100.0 * march.maxError << "%, " << march.nsPerSegment << " ns\n";
+    }
+    return 0;
+}
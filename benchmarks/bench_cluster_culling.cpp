@@ -0,0 +1,126 @@
+// Splits the stage model into culling clusters and reports how many triangles the default
+// camera submits after frustum, back-face and occlusion culling, plus build, cull and
+// occlusion buffer times.
+// Run from the repository root (or pass the .obj path).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "Geometry/ClusterBuilder.h"
+#include "Geometry/MeshOptimizer.h"
+#include "Resources/ObjLoader.h"
+#include "Scene/ClusterCuller.h"
+#include "Scene/OcclusionBuffer.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const std::string fileName = argc > 1 ? argv[1] : "data/models/stage.obj";
+    MeshData data;
+    if (!ObjLoader::Load(fileName, data))
+    {
+        std::cerr << "Failed to load " << fileName << std::endl;
+        return 1;
+    }
+    MeshOptimizer::ProcessMesh(data);
+    const float acmrBefore = MeshOptimizer::ComputeACMR(data.indices, data.vertices.size());
+    const double groupMs = BestOfMs(1, [&]() { ClusterBuilder::GroupTriangles(data); });
+    const float acmrAfter = MeshOptimizer::ComputeACMR(data.indices, data.vertices.size());
+
+    std::vector<uint8_t> indexBytes;
+    std::vector<IndexRange> ranges;
+    MeshOptimizer::PackIndices(data.indices, data.shapes, indexBytes, ranges);
+    PackedMeshView view;
+    view.vertices = data.vertices.data();
+    view.vertexCount = data.vertices.size();
+    view.indexBytes = indexBytes.data();
+    view.indexByteCount = indexBytes.size();
+    view.ranges = ranges.data();
+    view.rangeCount = ranges.size();
+
+    std::vector<MeshCluster> clusters;
+    const double buildMs = BestOfMs(3, [&]() { clusters = ClusterBuilder::Build(view); });
+
+    // Default orbit camera and stage placement, as set up by Scene
+    using namespace Config::CameraDefaults;
+    const DirectX::XMFLOAT3 eye = {DISTANCE * std::cos(PITCH) * std::sin(YAW), DISTANCE * std::sin(PITCH),
+                                   -DISTANCE * std::cos(PITCH) * std::cos(YAW)};
+    const DirectX::XMMATRIX viewMatrix =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                  DirectX::XMVectorSet(TARGET_X, TARGET_Y, TARGET_Z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj =
+        DirectX::XMMatrixPerspectiveFovLH(FOV, Config::Display::ASPECT_RATIO, CLIP_NEAR, CLIP_FAR);
+    const DirectX::XMMATRIX world = DirectX::XMMatrixTranslation(0.0f, Config::Room::FLOOR_Y - data.minY, 0.0f);
+
+    const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(world, viewMatrix * proj, eye);
+    std::vector<ClusterRange> visible;
+    ClusterCuller::Stats stats;
+    const double cullMs = BestOfMs(20, [&]() { stats = ClusterCuller::Cull(clusters, frustum, visible); });
+
+    // A spotlight at its default height aimed at the stage center, with the shadow projection
+    const DirectX::XMFLOAT3 lightPos = {0.0f, Config::Spotlight::DEFAULT_HEIGHT, -5.0f};
+    const DirectX::XMMATRIX lightView =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(lightPos.x, lightPos.y, lightPos.z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX lightProj =
+        DirectX::XMMatrixPerspectiveFovLH(Config::Math::PI_DIV_2, 1.0f, 0.1f, Config::Spotlight::DEFAULT_RANGE);
+    std::vector<ClusterRange> lit;
+    const ClusterCuller::Stats lightStats =
+        ClusterCuller::Cull(clusters, ClusterCuller::MakeFrustum(world, lightView * lightProj, lightPos), lit);
+
+    // Occlusion buffer filled with the stage's own largest triangles, as RenderPipeline does
+    const std::vector<DirectX::XMFLOAT3> occluders = OcclusionBuffer::SelectOccluders(view);
+    OcclusionBuffer occlusion;
+    const double occlusionMs = BestOfMs(50,
+                                        [&]()
+                                        {
+                                            occlusion.Begin(viewMatrix * proj);
+                                            occlusion.AddOccluders(occluders.data(), occluders.size() / 3, world);
+                                            occlusion.Finish();
+                                        });
+    std::vector<ClusterRange> unoccluded;
+    ClusterCuller::Stats occlusionStats;
+    const double occludedCullMs = BestOfMs(
+        20, [&]() { occlusionStats = ClusterCuller::Cull(clusters, frustum, unoccluded, true, &occlusion); });
+
+    std::cout << fileName << ": " << data.indices.size() / 3 << " triangles, " << data.shapes.size() << " shapes, "
+              << clusters.size() << " clusters\n"
+              << "  grouping: " << groupMs << " ms (ACMR " << acmrBefore << " -> " << acmrAfter << "), build: " << buildMs
+              << " ms\n"
+              << "  default camera: " << stats.submittedTriangles << " / " << stats.triangles
+              << " triangles submitted ("
+              << 100.0 * static_cast<double>(stats.submittedTriangles) / static_cast<double>((std::max)(stats.triangles, size_t(1)))
+              << "%)\n"
+              << "  clusters: " << stats.visibleClusters << " visible, " << stats.frustumCulled << " outside frustum, "
+              << stats.backfaceCulled << " back-facing\n"
+              << "  draw ranges: " << visible.size() << " (whole mesh: " << data.shapes.size() << " shape draws)\n"
+              << "  spotlight: " << lightStats.submittedTriangles << " / " << lightStats.triangles << " triangles, "
+              << lightStats.frustumCulled << " clusters outside frustum, " << lightStats.backfaceCulled
+              << " back-facing, " << lit.size() << " draw ranges\n"
+              << "  cull: " << cullMs << " ms (" << ThreadPool::Shared().GetThreadCount() + 1 << " threads)\n"
+              << "  occlusion buffer " << occlusion.GetWidth() << "x" << occlusion.GetHeight() << ": "
+              << occlusion.GetRasterizedCount() << " / " << occluders.size() / 3 << " occluder triangles, "
+              << occlusionMs * 1000.0 << " us\n"
+              << "  with occlusion: " << occlusionStats.submittedTriangles << " / " << occlusionStats.triangles
+              << " triangles, " << occlusionStats.occlusionCulled << " clusters occluded, cull " << occludedCullMs
+              << " ms\n";
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Rays marched with epipolar sample placement against per-pixel marching at 1080p, one light at
+// a time from the default orbit camera, over a synthetic stage (floor, pillars and a truss bar)
+// whose depth edges force refinement. Marched samples and the pixels that fall back to marching
+// are shaded with the CPU reference; the difference is measured against its per-pixel render.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "Rendering/EpipolarSampling.h"
+#include "Rendering/VolumetricReference.h"
+#include "bench_lights.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Nearest hit of a ray with an axis-aligned box, or a negative value.
+ */
+float HitBox(const DirectX::XMFLOAT3 &o, const DirectX::XMFLOAT3 &d, const DirectX::XMFLOAT3 &lo,
+             const DirectX::XMFLOAT3 &hi)
+{
+    float tNear = 0.0f;
+    float tFar = 1e30f;
+    const float origin[3] = {o.x, o.y, o.z};
+    const float dir[3] = {d.x, d.y, d.z};
+    const float boxMin[3] = {lo.x, lo.y, lo.z};
+    const float boxMax[3] = {hi.x, hi.y, hi.z};
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (std::fabs(dir[axis]) < 1e-9f)
+        {
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+                return -1.0f;
+            continue;
+        }
+        const float t0 = (boxMin[axis] - origin[axis]) / dir[axis];
+        const float t1 = (boxMax[axis] - origin[axis]) / dir[axis];
+        tNear = (std::max)(tNear, (std::min)(t0, t1));
+        tFar = (std::min)(tFar, (std::max)(t0, t1));
+    }
+    return tNear <= tFar ? tNear : -1.0f;
+}
+
+/**
+ * @brief Distance along a ray to the stage: the floor, four pillars and a truss bar between them.
+ */
+float CastStage(const DirectX::XMFLOAT3 &o, const DirectX::XMFLOAT3 &d)
+{
+    float t = d.y < 0.0f ? -o.y / d.y : 1e30f;
+    const DirectX::XMFLOAT3 boxes[][2] = {
+        {{-10.5f, 0.0f, 3.5f}, {-9.5f, 10.0f, 4.5f}}, {{-3.5f, 0.0f, 3.5f}, {-2.5f, 10.0f, 4.5f}},
+        {{2.5f, 0.0f, 3.5f}, {3.5f, 10.0f, 4.5f}},    {{9.5f, 0.0f, 3.5f}, {10.5f, 10.0f, 4.5f}},
+        {{-10.5f, 9.5f, 3.5f}, {10.5f, 10.0f, 4.5f}},
+    };
+    for (const auto &box : boxes)
+    {
+        const float hit = HitBox(o, d, box[0], box[1]);
+        if (hit >= 0.0f)
+            t = (std::min)(t, hit);
+    }
+    return t;
+}
+
+int main()
+{
+    constexpr int WIDTH = Config::Display::WINDOW_WIDTH;
+    constexpr int HEIGHT = Config::Display::WINDOW_HEIGHT;
+    constexpr int LINES = Config::Volumetric::EPIPOLAR_LINES;
+    constexpr int SAMPLES = Config::Volumetric::EPIPOLAR_SAMPLES;
+    constexpr float THRESHOLD = Config::Volumetric::EPIPOLAR_DEPTH_THRESHOLD;
+    constexpr size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+
+    using namespace Config::CameraDefaults;
+    const DirectX::XMFLOAT3 eye = {DISTANCE * std::cos(PITCH) * std::sin(YAW), DISTANCE * std::sin(PITCH),
+                                   -DISTANCE * std::cos(PITCH) * std::cos(YAW)};
+    const DirectX::XMMATRIX viewMatrix =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                  DirectX::XMVectorSet(TARGET_X, TARGET_Y, TARGET_Z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj =
+        DirectX::XMMatrixPerspectiveFovLH(FOV, Config::Display::ASPECT_RATIO, CLIP_NEAR, CLIP_FAR);
+    const DirectX::XMMATRIX viewProj = viewMatrix * proj;
+    const DirectX::XMMATRIX inverse = DirectX::XMMatrixInverse(nullptr, viewProj);
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, viewProj);
+
+    // Scene depth and camera distance per pixel
+    std::vector<float> depth(PIXELS);
+    std::vector<float> distance(PIXELS);
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        for (int x = 0; x < WIDTH; ++x)
+        {
+            const float ndcX = ((static_cast<float>(x) + 0.5f) / WIDTH * 2.0f) - 1.0f;
+            const float ndcY = 1.0f - ((static_cast<float>(y) + 0.5f) / HEIGHT * 2.0f);
+            DirectX::XMFLOAT3 farPoint;
+            DirectX::XMStoreFloat3(&farPoint, DirectX::XMVector3TransformCoord(
+                                                  DirectX::XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), inverse));
+            DirectX::XMFLOAT3 dir = {farPoint.x - eye.x, farPoint.y - eye.y, farPoint.z - eye.z};
+            const float length = std::sqrt((dir.x * dir.x) + (dir.y * dir.y) + (dir.z * dir.z));
+            dir = {dir.x / length, dir.y / length, dir.z / length};
+            const float t = (std::min)(CastStage(eye, dir), length);
+            const size_t index = (static_cast<size_t>(y) * WIDTH) + x;
+            DirectX::XMFLOAT3 hit;
+            DirectX::XMStoreFloat3(&hit, DirectX::XMVector3TransformCoord(
+                                             DirectX::XMVectorSet(eye.x + (dir.x * t), eye.y + (dir.y * t),
+                                                                  eye.z + (dir.z * t), 1.0f),
+                                             viewProj));
+            depth[index] = t >= length ? 1.0f : hit.z;
+            distance[index] = t;
+        }
+    }
+
+    VolumetricReference::Inputs inputs;
+    inputs.width = WIDTH;
+    inputs.height = HEIGHT;
+    DirectX::XMStoreFloat4x4(&inputs.invViewProj, inverse);
+    inputs.cameraPos = eye;
+    inputs.depth = depth.data();
+    inputs.lightCount = 1;
+    inputs.params.params = {Config::Volumetric::DEFAULT_STEP_COUNT, Config::Volumetric::DEFAULT_DENSITY,
+                            Config::Volumetric::DEFAULT_INTENSITY, Config::Volumetric::DEFAULT_ANISOTROPY};
+
+    std::cout << LINES << " lines x " << SAMPLES << " samples, initial step "
+              << Config::Volumetric::EPIPOLAR_INITIAL_STEP << ", " << WIDTH << "x" << HEIGHT << " (" << PIXELS << " pixels), "
+              << ThreadPool::Shared().GetThreadCount() + 1 << " threads\n"
+              << "light  screen position   lines  marched samples  fallback pixels  rays vs per-pixel  lines+refine ms"
+                 "  difference\n";
+
+    const DirectX::XMFLOAT3 positions[] = {
+        {-9.0f, Config::Spotlight::DEFAULT_HEIGHT, 4.0f},
+        {3.0f, Config::Spotlight::DEFAULT_HEIGHT, 4.0f},
+        {0.0f, 40.0f, 10.0f},
+        {-30.0f, 6.0f, -10.0f},
+    };
+    std::vector<float> reference;
+    for (size_t l = 0; l < std::size(positions); ++l)
+    {
+        const SpotlightData light = BenchLights::AtStageCenter(positions[l]);
+        inputs.lights = &light;
+
+        // The light's projection; lights behind the camera are marched per pixel
+        const DirectX::XMFLOAT3 &p = positions[l];
+        const float clipX = (p.x * m._11) + (p.y * m._21) + (p.z * m._31) + m._41;
+        const float clipY = (p.x * m._12) + (p.y * m._22) + (p.z * m._32) + m._42;
+        const float clipW = (p.x * m._14) + (p.y * m._24) + (p.z * m._34) + m._44;
+        if (clipW <= 0.0f)
+        {
+            std::cout << "  " << l + 1 << "    behind the camera\n";
+            continue;
+        }
+        const DirectX::XMFLOAT2 screen = {((clipX / clipW * 0.5f) + 0.5f) * WIDTH,
+                                          (0.5f - (clipY / clipW * 0.5f)) * HEIGHT};
+
+        // Lines, sample distances and refinement: the part the epipolar mode adds before marching
+        EpipolarSampling::Lines lines;
+        std::vector<float> sampleDistances(static_cast<size_t>(LINES) * SAMPLES, 0.0f);
+        std::vector<uint16_t> left(sampleDistances.size());
+        std::vector<uint16_t> right(sampleDistances.size());
+        size_t marched = 0;
+        const double setupMs = BestOfMs(3, [&]() {
+            EpipolarSampling::GenerateLines(screen, WIDTH, HEIGHT, LINES, lines);
+            marched = 0;
+            for (int k = 0; k < LINES; ++k)
+            {
+                if (!lines.lines[k].valid)
+                    continue;
+                const size_t base = static_cast<size_t>(k) * SAMPLES;
+                for (int s = 0; s < SAMPLES; ++s)
+                {
+                    const DirectX::XMFLOAT2 p = EpipolarSampling::SamplePosition(lines.lines[k], s, SAMPLES);
+                    const int px = std::clamp(static_cast<int>(p.x), 0, WIDTH - 1);
+                    const int py = std::clamp(static_cast<int>(p.y), 0, HEIGHT - 1);
+                    sampleDistances[base + s] = distance[(static_cast<size_t>(py) * WIDTH) + px];
+                }
+                marched += EpipolarSampling::RefineLine(&sampleDistances[base], SAMPLES,
+                                                        Config::Volumetric::EPIPOLAR_INITIAL_STEP, THRESHOLD,
+                                                        &left[base], &right[base]);
+            }
+        });
+        size_t validLines = 0;
+        for (const EpipolarSampling::Line &line : lines.lines)
+            validLines += line.valid ? 1 : 0;
+
+        // March the sources, interpolate along the lines, then resolve the pixels
+        std::vector<DirectX::XMFLOAT3> values(sampleDistances.size(), {0.0f, 0.0f, 0.0f});
+        for (int k = 0; k < LINES; ++k)
+        {
+            if (!lines.lines[k].valid)
+                continue;
+            const size_t base = static_cast<size_t>(k) * SAMPLES;
+            for (int s = 0; s < SAMPLES; ++s)
+            {
+                if (left[base + s] != s)
+                    continue;
+                const DirectX::XMFLOAT2 p = EpipolarSampling::SamplePosition(lines.lines[k], s, SAMPLES);
+                const int px = std::clamp(static_cast<int>(p.x), 0, WIDTH - 1);
+                const int py = std::clamp(static_cast<int>(p.y), 0, HEIGHT - 1);
+                values[base + s] = VolumetricReference::ShadePixel(inputs, px, py);
+            }
+            EpipolarSampling::InterpolateLine(&left[base], &right[base], SAMPLES, &values[base]);
+        }
+
+        VolumetricReference::Render(inputs, reference);
+        size_t fallback = 0;
+        double difference = 0.0;
+        double total = 0.0;
+        for (int y = 0; y < HEIGHT; ++y)
+        {
+            for (int x = 0; x < WIDTH; ++x)
+            {
+                const size_t index = (static_cast<size_t>(y) * WIDTH) + x;
+                DirectX::XMFLOAT3 value;
+                if (!EpipolarSampling::Reconstruct(lines, SAMPLES, values.data(), sampleDistances.data(),
+                                                   static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f,
+                                                   distance[index], THRESHOLD, value))
+                {
+                    ++fallback;
+                    value = VolumetricReference::ShadePixel(inputs, x, y);
+                }
+                const float *expected = &reference[index * 3];
+                difference += std::fabs(value.x - expected[0]) + std::fabs(value.y - expected[1]) +
+                              std::fabs(value.z - expected[2]);
+                total += expected[0] + expected[1] + expected[2];
+            }
+        }
+
+        const size_t rays = marched + fallback;
+        std::cout << "  " << l + 1 << "    (" << static_cast<int>(screen.x) << ", " << static_cast<int>(screen.y)
+                  << ")      " << validLines << "    " << marched << "            " << fallback << "             "
+                  << 100.0 * static_cast<double>(rays) / static_cast<double>(PIXELS) << "%            " << setupMs
+                  << "           " << 100.0 * difference / (std::max)(total, 1e-30) << "%\n";
+    }
+    return 0;
+}
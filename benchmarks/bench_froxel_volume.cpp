@@ -0,0 +1,94 @@
+// Cost of the froxel pipeline (inject, integrate, resolve) against the per-pixel ray march as
+// the number of lights grows, from the default orbit camera with lights over the stage.
+// The march runs at a quarter of the display resolution; its cost grows with the pixel count,
+// the froxel injection's does not.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "Rendering/FroxelVolume.h"
+#include "Rendering/VolumetricReference.h"
+#include "bench_lights.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main()
+{
+    std::vector<SpotlightData> lights;
+    for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+    {
+        const float x = -9.0f + (6.0f * static_cast<float>(i));
+        lights.push_back(BenchLights::AtStageCenter({x, Config::Spotlight::DEFAULT_HEIGHT, 4.0f}));
+    }
+
+    using namespace Config::CameraDefaults;
+    const DirectX::XMFLOAT3 eye = {DISTANCE * std::cos(PITCH) * std::sin(YAW), DISTANCE * std::sin(PITCH),
+                                   -DISTANCE * std::cos(PITCH) * std::cos(YAW)};
+    const DirectX::XMMATRIX viewMatrix =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                  DirectX::XMVectorSet(TARGET_X, TARGET_Y, TARGET_Z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj =
+        DirectX::XMMatrixPerspectiveFovLH(FOV, Config::Display::ASPECT_RATIO, CLIP_NEAR, CLIP_FAR);
+
+    VolumetricReference::Inputs inputs;
+    inputs.width = Config::Display::WINDOW_WIDTH / 4;
+    inputs.height = Config::Display::WINDOW_HEIGHT / 4;
+    DirectX::XMStoreFloat4x4(&inputs.invViewProj, DirectX::XMMatrixInverse(nullptr, viewMatrix * proj));
+    inputs.cameraPos = eye;
+    inputs.lights = lights.data();
+    inputs.params.params = {Config::Volumetric::DEFAULT_STEP_COUNT, Config::Volumetric::DEFAULT_DENSITY,
+                            Config::Volumetric::DEFAULT_INTENSITY, Config::Volumetric::DEFAULT_ANISOTROPY};
+
+    VolumetricReference::Inputs display = inputs;
+    display.width = Config::Display::WINDOW_WIDTH;
+    display.height = Config::Display::WINDOW_HEIGHT;
+
+    FroxelVolume volume;
+    std::cout << "Froxel grid " << volume.GetWidth() << "x" << volume.GetHeight() << "x" << volume.GetDepth()
+              << ", march " << static_cast<int>(inputs.params.params.x) << " steps at " << inputs.width << "x"
+              << inputs.height << ", " << ThreadPool::Shared().GetThreadCount() + 1 << " threads\n"
+              << "lights  inject ms  integrate ms  resolve ms (" << display.width << "x" << display.height
+              << ")  march ms  difference\n";
+
+    std::vector<float> marched;
+    std::vector<float> froxel;
+    for (size_t count = 1; count <= lights.size(); ++count)
+    {
+        inputs.lightCount = count;
+        display.lightCount = count;
+        const double injectMs = BestOfMs(3, [&]() { volume.Inject(inputs); });
+        const double integrateMs = BestOfMs(3, [&]() { volume.Integrate(); });
+        const double resolveMs = BestOfMs(3, [&]() { volume.Resolve(display, froxel); });
+        const double marchMs = BestOfMs(1, [&]() { VolumetricReference::Render(inputs, marched); });
+
+        // Mean absolute difference against the march, relative to its mean, at the march's size
+        volume.Resolve(inputs, froxel);
+        double difference = 0.0;
+        double total = 0.0;
+        for (size_t i = 0; i < marched.size(); ++i)
+        {
+            difference += std::fabs(froxel[i] - marched[i]);
+            total += marched[i];
+        }
+        std::cout << "  " << count << "     " << injectMs << "      " << integrateMs << "          " << resolveMs
+                  << "               " << marchMs << "   " << 100.0 * difference / (std::max)(total, 1e-30) << "%\n";
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Memory accounting of the shared gobo library against one padded texture array per fixture type.
+// Each .gdtf on the command line is a fixture type; with none, the bundled MAC Viper stands in for
+// a rig of eight types that share its stock gobos, each carrying four of the five (and the open
+// gobo). Also times adding each type, the first one decoding everything and later ones mostly
+// hitting the library. Run from the repository root.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Core/Config.h"
+#include "GDTF/GDTFParser.h"
+#include "Resources/GoboLibrary.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+constexpr int RIG_TYPES = 8;
+
+const char *FormatName(TextureBaker::Format format)
+{
+    switch (format)
+    {
+    case TextureBaker::Format::BC1:
+        return "BC1";
+    case TextureBaker::Format::BC4:
+        return "BC4";
+    case TextureBaker::Format::BC7:
+        return "BC7";
+    default:
+        return "RGBA8";
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Fixture types: a name and its images, open gobo first
+    std::vector<std::pair<std::string, std::vector<std::vector<uint8_t>>>> types;
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    const bool rig = paths.empty();
+    if (rig)
+        paths.emplace_back(Config::Fixtures::DEFAULT_GDTF);
+    for (const std::string &path : paths)
+    {
+        GDTF::GDTFParser parser;
+        if (!parser.Load(path))
+        {
+            std::cerr << "Cannot load " << path << std::endl;
+            return 1;
+        }
+        types.emplace_back(path, parser.ExtractGoboImages());
+    }
+    if (rig)
+    {
+        // Type k leaves out gobo k % 5 of the wheel
+        const std::vector<std::vector<uint8_t>> wheel = types[0].second;
+        types.clear();
+        const size_t gobos = wheel.size() - 1;
+        for (int type = 0; type < RIG_TYPES; ++type)
+        {
+            std::vector<std::vector<uint8_t>> files = {wheel[0]};
+            for (size_t gobo = 0; gobo < gobos; ++gobo)
+            {
+                if (gobos < 2 || gobo != static_cast<size_t>(type) % gobos)
+                    files.push_back(wheel[gobo + 1]);
+            }
+            types.emplace_back("type " + std::to_string(type), files);
+        }
+    }
+
+    GoboLibrary library;
+    std::cout << "type                      slots  new slices  add ms" << std::endl;
+    for (const auto &[name, files] : types)
+    {
+        const GoboLibrary::MemoryReport before = library.GetMemoryReport();
+        const auto start = Clock::now();
+        const int fixture = library.AddFixture(name, files);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (fixture < 0)
+        {
+            std::cerr << "No gobo images in " << name << std::endl;
+            return 1;
+        }
+        const std::string label = name.size() > 24 ? "..." + name.substr(name.size() - 21) : name;
+        std::printf("%-24s  %5zu  %10zu  %6.1f\n", label.c_str(), library.GetSlots(fixture).size(),
+                    library.GetMemoryReport().uniqueSlices - before.uniqueSlices, ms);
+    }
+
+    const GoboLibrary::MemoryReport report = library.GetMemoryReport();
+    std::cout << std::endl << "size class  format  slices  KB" << std::endl;
+    for (int i = 0; i < library.GetSizeClassCount(); ++i)
+    {
+        const GoboLibrary::SizeClass &sizeClass = library.GetSizeClass(i);
+        std::printf("%10d  %-6s  %6d  %8.1f\n", sizeClass.size, FormatName(sizeClass.format), sizeClass.image.layers,
+                    static_cast<double>(report.classBytes[static_cast<size_t>(i)]) / 1024.0);
+    }
+    std::cout << std::endl
+              << report.fixtures << " fixture types, " << report.slots << " slots, " << report.uniqueSlices
+              << " unique slices" << std::endl;
+    std::printf("per-fixture padded arrays: %8.1f KB\n", static_cast<double>(report.perFixtureBytes) / 1024.0);
+    std::printf("library:                   %8.1f KB (%.1f%%)\n", static_cast<double>(report.libraryBytes) / 1024.0,
+                100.0 * static_cast<double>(report.libraryBytes) / static_cast<double>(report.perFixtureBytes));
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Gobo slot streaming against loading every wheel image at startup. Startup compares baking all
+// of a GDTF's wheel images into pool slices with only registering their files. Playback runs a
+// cue list over a rig of lights at a fixed frame time: each cue moves some lights to other slots
+// of the wheels, and the run is made with and without prefetching the next cue's slots a few
+// frames ahead (the lookahead), reporting hit rate, placeholder frames and evictions, once with
+// the configured pool and once with one too small for the rig.
+// Usage: bench_gobo_streamer [fixture.gdtf]; run from the repository root.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "GDTF/GDTFParser.h"
+#include "Resources/GoboStreamer.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+constexpr int LIGHTS = 8;
+constexpr int CUES = 24;
+constexpr int FRAMES_PER_CUE = 20;
+constexpr int LOOKAHEAD_FRAMES = 8;
+constexpr int SMALL_POOL_LAYERS = 8;
+constexpr auto FRAME_TIME = std::chrono::milliseconds(8);
+constexpr TextureBaker::Format POOL_FORMAT = TextureBaker::Format::BC7;
+
+/// Slot of every light in every cue; each cue moves three lights.
+std::vector<std::vector<int>> MakeCues(int slotCount)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> slot(0, slotCount - 1);
+    std::uniform_int_distribution<int> light(0, LIGHTS - 1);
+    std::vector<std::vector<int>> cues(CUES, std::vector<int>(LIGHTS, 0));
+    for (int cue = 1; cue < CUES; ++cue)
+    {
+        cues[cue] = cues[cue - 1];
+        for (int move = 0; move < 3; ++move)
+            cues[cue][light(rng)] = slot(rng);
+    }
+    return cues;
+}
+
+struct Run
+{
+    GoboStreamer::Stats stats;
+    int placeholderFrames = 0; ///< Light-frames showing the placeholder instead of their slot.
+};
+
+Run Play(const std::vector<GoboStreamer::Key> &keys, const std::vector<std::vector<uint8_t>> &files,
+         const std::vector<std::vector<int>> &cues, int poolLayers, bool lookahead)
+{
+    GoboStreamer streamer(poolLayers, Config::Gobo::STREAM_LAYER_SIZE, POOL_FORMAT, Config::Gobo::STREAM_MAX_DECODES);
+    for (const auto &file : files)
+        streamer.AddMedia(file);
+    GoboStreamer::Upload placeholder;
+    streamer.SetPlaceholder(keys[0], placeholder);
+
+    Run run;
+    std::vector<GoboStreamer::Upload> uploads;
+    for (int cue = 0; cue < CUES; ++cue)
+    {
+        for (int frame = 0; frame < FRAMES_PER_CUE; ++frame)
+        {
+            const auto start = Clock::now();
+            for (int light = 0; light < LIGHTS; ++light)
+            {
+                const int slot = cues[cue][light];
+                if (streamer.Request(keys[slot]) == GoboStreamer::PLACEHOLDER_LAYER && slot != 0)
+                    ++run.placeholderFrames;
+            }
+            if (lookahead && cue + 1 < CUES && frame >= FRAMES_PER_CUE - LOOKAHEAD_FRAMES)
+            {
+                for (int light = 0; light < LIGHTS; ++light)
+                    streamer.Prefetch(keys[cues[cue + 1][light]]);
+            }
+            streamer.Update(uploads, Config::Gobo::STREAM_UPLOADS_PER_FRAME);
+            uploads.clear();
+            std::this_thread::sleep_until(start + FRAME_TIME);
+        }
+    }
+    run.stats = streamer.GetStats();
+    return run;
+}
+
+void Print(int poolLayers, const char *name, const Run &run)
+{
+    const GoboStreamer::Stats &s = run.stats;
+    std::printf("%4d  %-13s  %6.1f%%  %11d  %9llu  %7llu  %13llu\n", poolLayers, name, s.HitRate() * 100.0,
+                run.placeholderFrames, static_cast<unsigned long long>(s.evictions),
+                static_cast<unsigned long long>(s.decodes), static_cast<unsigned long long>(s.prefetchHits));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::string path = argc > 1 ? argv[1] : Config::Fixtures::DEFAULT_GDTF;
+    GDTF::GDTFParser parser;
+    if (!parser.Load(path))
+    {
+        std::cerr << "Cannot load " << path << std::endl;
+        return 1;
+    }
+
+    // Open, then every wheel slot with an image
+    std::vector<std::vector<uint8_t>> files = {GDTF::GDTFParser::CreateOpenGoboImage()};
+    for (GDTF::WheelMedia &media : parser.ExtractWheelMedia())
+        files.push_back(std::move(media.data));
+    std::cout << files.size() << " slots, pool of " << Config::Gobo::STREAM_POOL_LAYERS << " layers of "
+              << Config::Gobo::STREAM_LAYER_SIZE << "x" << Config::Gobo::STREAM_LAYER_SIZE << std::endl;
+
+    // Startup: bake everything up front, or only register the files
+    auto start = Clock::now();
+    std::vector<TextureBaker::BakedTexture> baked(files.size());
+    ThreadPool::Shared().ParallelFor(files.size(), [&](size_t i) {
+        GoboStreamer::DecodeSlice(files[i], Config::Gobo::STREAM_LAYER_SIZE, POOL_FORMAT, baked[i]);
+    });
+    const double eagerMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    uint64_t eagerBytes = 0;
+    for (const auto &slice : baked)
+        eagerBytes += slice.data.size();
+
+    start = Clock::now();
+    GoboStreamer registry(Config::Gobo::STREAM_POOL_LAYERS, Config::Gobo::STREAM_LAYER_SIZE, POOL_FORMAT, 1);
+    std::vector<GoboStreamer::Key> keys;
+    for (const auto &file : files)
+        keys.push_back(registry.AddMedia(file));
+    const double lazyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    const uint64_t poolBytes =
+        TextureBaker::BakedSize(POOL_FORMAT, Config::Gobo::STREAM_LAYER_SIZE, Config::Gobo::STREAM_LAYER_SIZE,
+                                Config::Gobo::STREAM_POOL_LAYERS);
+    std::printf("startup, all resident: %8.1f ms, %8.1f KB\n", eagerMs, static_cast<double>(eagerBytes) / 1024.0);
+    std::printf("startup, streamed:     %8.1f ms, %8.1f KB pool\n\n", lazyMs, static_cast<double>(poolBytes) / 1024.0);
+
+    // Playback
+    const std::vector<std::vector<int>> cues = MakeCues(static_cast<int>(files.size()));
+    std::cout << LIGHTS << " lights, " << CUES << " cues of " << FRAMES_PER_CUE << " frames" << std::endl;
+    std::cout << "pool  run              hits  placeholder  evictions  decodes  prefetch hits" << std::endl;
+    for (const int poolLayers : {Config::Gobo::STREAM_POOL_LAYERS, SMALL_POOL_LAYERS})
+    {
+        Print(poolLayers, "on demand", Play(keys, files, cues, poolLayers, false));
+        Print(poolLayers, "cue lookahead", Play(keys, files, cues, poolLayers, true));
+    }
+    return 0;
+}
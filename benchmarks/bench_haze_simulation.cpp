@@ -0,0 +1,48 @@
+// Tick cost of the haze simulation over the room, at the runtime grid size and at 128^3, with
+// the default rig of one hazer and one fan running. The first ticks are skipped so that the
+// flow has developed; the budget line compares the cost with the tick period.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "Scene/HazeSimulation.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main()
+{
+    constexpr int WARMUP_TICKS = 10;
+    constexpr int TIMED_TICKS = 20;
+    const float dt = 1.0f / Config::Haze::TICK_RATE;
+    std::cout << "Workers: " << ThreadPool::Shared().GetThreadCount() << std::endl;
+    std::cout << "grid   mean ms  best ms  share of the " << 1000.0f * dt << " ms tick period  haze total"
+              << std::endl;
+
+    for (int size : {Config::Haze::GRID_SIZE, 128})
+    {
+        HazeSimulation haze(size);
+        haze.Emitters().push_back({{-20.0f, 1.0f, 10.0f}, {1.0f, 0.2f, 0.0f}, Config::Haze::HAZER_RADIUS,
+                                   Config::Haze::HAZER_RATE, Config::Haze::HAZER_SPEED});
+        haze.Fans().push_back({{-26.0f, 2.0f, 10.0f}, {1.0f, 0.0f, 0.0f}, Config::Haze::FAN_RADIUS,
+                               Config::Haze::FAN_THRUST});
+        for (int tick = 0; tick < WARMUP_TICKS; ++tick)
+            haze.Step(dt);
+
+        double total = 0.0;
+        double best = 1e30;
+        for (int tick = 0; tick < TIMED_TICKS; ++tick)
+        {
+            const auto start = Clock::now();
+            haze.Step(dt);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            total += ms;
+            best = (std::min)(best, ms);
+        }
+        const double mean = total / TIMED_TICKS;
+        std::cout << size << "^3   " << mean << "    " << best << "    " << 100.0 * mean / (1000.0 * dt) << "%    "
+                  << haze.TotalHaze() << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Builds the per-tile light alias tables for a 1080p screen with growing light counts: time
+// of the eight-wide, multithreaded build against a scalar single-threaded one, and variance of
+// the one-light estimate against picking lights uniformly.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Core/Config.h"
+#include "Rendering/LightSampling.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+constexpr int WIDTH = Config::Display::WINDOW_WIDTH;
+constexpr int HEIGHT = Config::Display::WINDOW_HEIGHT;
+constexpr int TILE = Config::Volumetric::TILE_SIZE;
+constexpr float MIN_DISTANCE = Config::Volumetric::LIGHT_SAMPLING_MIN_DISTANCE;
+constexpr float UNIFORM_MIX = Config::Volumetric::LIGHT_SAMPLING_UNIFORM_MIX;
+
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+/// Normalized ray through the center of tile (tx, ty).
+DirectX::XMFLOAT3 TileRay(const DirectX::XMFLOAT4X4 &inv, const DirectX::XMFLOAT3 &cameraPos, int tx, int ty)
+{
+    const float u = 0.5f * static_cast<float>((tx * TILE) + (std::min)((tx + 1) * TILE, WIDTH)) / WIDTH;
+    const float v = 0.5f * static_cast<float>((ty * TILE) + (std::min)((ty + 1) * TILE, HEIGHT)) / HEIGHT;
+    const DirectX::XMFLOAT3 farPoint = ScreenToWorld(inv, u, v, 1.0f);
+    const float x = farPoint.x - cameraPos.x;
+    const float y = farPoint.y - cameraPos.y;
+    const float z = farPoint.z - cameraPos.z;
+    const float length = std::sqrt((x * x) + (y * y) + (z * z));
+    return {x / length, y / length, z / length};
+}
+
+/**
+ * @brief In-scattering of an unshadowed isotropic point light along a ray from the camera to
+ * infinity: power times the integral of 1 / (r^2 + s^2).
+ */
+double PointScatter(const LightSampling::Light &light, const DirectX::XMFLOAT3 &cameraPos,
+                    const DirectX::XMFLOAT3 &dir)
+{
+    const double lx = light.position.x - cameraPos.x;
+    const double ly = light.position.y - cameraPos.y;
+    const double lz = light.position.z - cameraPos.z;
+    const double along = (lx * dir.x) + (ly * dir.y) + (lz * dir.z);
+    const double r = (std::max)(std::sqrt((std::max)((lx * lx) + (ly * ly) + (lz * lz) - (along * along), 0.0)), 0.05);
+    return light.power * (1.5707963 + std::atan(along / r)) / r;
+}
+
+/// Single-threaded build, one tile and one light at a time.
+void BuildScalar(const std::vector<LightSampling::Light> &lights, const DirectX::XMFLOAT4X4 &inv,
+                 const DirectX::XMFLOAT3 &cameraPos, LightSampling::Tables &tables)
+{
+    const int count = static_cast<int>(lights.size());
+    tables.tilesX = (WIDTH + TILE - 1) / TILE;
+    tables.tilesY = (HEIGHT + TILE - 1) / TILE;
+    tables.lightCount = count;
+    tables.entries.resize(static_cast<size_t>(tables.tilesX) * tables.tilesY * count);
+    std::vector<float> weights(static_cast<size_t>(count));
+    for (int ty = 0; ty < tables.tilesY; ++ty)
+    {
+        for (int tx = 0; tx < tables.tilesX; ++tx)
+        {
+            const DirectX::XMFLOAT3 dir = TileRay(inv, cameraPos, tx, ty);
+            const DirectX::XMFLOAT2 tileMin = {static_cast<float>(tx * TILE) / WIDTH,
+                                               static_cast<float>(ty * TILE) / HEIGHT};
+            const DirectX::XMFLOAT2 tileMax = {static_cast<float>((tx + 1) * TILE) / WIDTH,
+                                               static_cast<float>((ty + 1) * TILE) / HEIGHT};
+            float sum = 0.0f;
+            int nonZero = 0;
+            for (int j = 0; j < count; ++j)
+            {
+                weights[j] = LightSampling::TileWeight(lights[j], cameraPos, dir, tileMin, tileMax, MIN_DISTANCE);
+                sum += weights[j];
+                nonZero += weights[j] > 0.0f ? 1 : 0;
+            }
+            for (int j = 0; j < count && sum > 0.0f; ++j)
+                weights[j] = weights[j] > 0.0f ? ((1.0f - UNIFORM_MIX) * weights[j] / sum) + (UNIFORM_MIX / nonZero)
+                                               : 0.0f;
+            const size_t tile = (static_cast<size_t>(ty) * tables.tilesX) + tx;
+            LightSampling::BuildAliasTable(weights.data(), count, &tables.entries[tile * count]);
+        }
+    }
+}
+
+template <typename F> double TimeMs(F &&build)
+{
+    constexpr int REPEATS = 5;
+    build();
+    const auto start = Clock::now();
+    for (int repeat = 0; repeat < REPEATS; ++repeat)
+        build();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / REPEATS;
+}
+
+} // namespace
+
+int main()
+{
+    const DirectX::XMFLOAT3 cameraPos = {0.0f, 8.0f, -45.0f};
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(
+        DirectX::XMVectorSet(cameraPos.x, cameraPos.y, cameraPos.z, 1.0f), DirectX::XMVectorSet(0.0f, 6.0f, 0.0f, 1.0f),
+        DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        DirectX::XM_PIDIV4, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+    DirectX::XMFLOAT4X4 invViewProj;
+    DirectX::XMStoreFloat4x4(&invViewProj, DirectX::XMMatrixInverse(nullptr, view * proj));
+
+    std::cout << "lights  scalar ms  simd+mt ms  speedup  variance vs uniform" << std::endl;
+    for (int count : {4, 16, 64, 256})
+    {
+        // A rig of lights over the stage, each beam covering a random part of the screen
+        std::mt19937 rng(static_cast<unsigned>(count));
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<LightSampling::Light> lights(static_cast<size_t>(count));
+        for (LightSampling::Light &light : lights)
+        {
+            light.position = {(unit(rng) - 0.5f) * 80.0f, 10.0f + (unit(rng) * 15.0f), (unit(rng) - 0.5f) * 60.0f};
+            light.power = 20.0f + (unit(rng) * 80.0f);
+            const float u = unit(rng);
+            light.screenMin = {u - 0.2f - (unit(rng) * 0.2f), -0.1f};
+            light.screenMax = {u + 0.2f + (unit(rng) * 0.2f), 1.1f};
+        }
+
+        LightSampling::Tables scalar;
+        LightSampling::Tables tables;
+        const double scalarMs = TimeMs([&]() { BuildScalar(lights, invViewProj, cameraPos, scalar); });
+        const double fastMs = TimeMs(
+            [&]()
+            {
+                LightSampling::BuildTileTables(lights, invViewProj, cameraPos, WIDTH, HEIGHT, TILE, MIN_DISTANCE,
+                                               UNIFORM_MIX, tables);
+            });
+
+        // Variance of f_j / p_j for one pick per pixel, summed over tiles, relative to uniform picks
+        double sampled = 0.0;
+        double uniform = 0.0;
+        for (int ty = 0; ty < tables.tilesY; ++ty)
+        {
+            for (int tx = 0; tx < tables.tilesX; ++tx)
+            {
+                const DirectX::XMFLOAT3 dir = TileRay(invViewProj, cameraPos, tx, ty);
+                const size_t first = ((static_cast<size_t>(ty) * tables.tilesX) + tx) * count;
+                double total = 0.0;
+                double secondSampled = 0.0;
+                double secondUniform = 0.0;
+                int reachable = 0;
+                for (int j = 0; j < count; ++j)
+                {
+                    const float pdf = tables.entries[first + j].pdf;
+                    if (pdf <= 0.0f)
+                        continue;
+                    const double f = PointScatter(lights[j], cameraPos, dir);
+                    total += f;
+                    secondSampled += f * f / pdf;
+                    secondUniform += f * f;
+                    ++reachable;
+                }
+                sampled += secondSampled - (total * total);
+                uniform += (secondUniform * reachable) - (total * total);
+            }
+        }
+        std::cout << count << "       " << scalarMs << "      " << fastMs << "      " << scalarMs / fastMs << "x    "
+                  << sampled / (std::max)(uniform, 1e-30) << std::endl;
+    }
+    return 0;
+}
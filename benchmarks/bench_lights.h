@@ -0,0 +1,30 @@
+/**
+ * @file bench_lights.h
+ * @brief Spotlights for the volumetric benchmarks, set up through Spotlight as Scene sets up its
+ * anchor lights.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include "Scene/Spotlight.h"
+
+namespace BenchLights
+{
+
+/**
+ * @brief Default spotlight at a position, aimed at the stage center as Scene::CreateAnchorLight() does.
+ *
+ * @param pos Light position.
+ * @return The light's GPU data, shadow matrix included.
+ */
+inline SpotlightData AtStageCenter(const DirectX::XMFLOAT3 &pos)
+{
+    Spotlight light;
+    light.SetPosition(pos);
+    light.SetDirection({-pos.x, -pos.y, -pos.z});
+    light.UpdateLightMatrix();
+    return light.GetGPUData();
+}
+
+} // namespace BenchLights
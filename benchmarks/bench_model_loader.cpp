@@ -0,0 +1,157 @@
+// Compares the native 3DS/GLB loader against Assimp on every model in a GDTF archive (the
+// bundled MAC Viper fixture by default): import time, output size and bounds after
+// processing, plus the LOD chain built from the native result. Run from the repository root
+// (or pass the .gdtf path).
+
+#include <algorithm>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <miniz/miniz.h>
+#include <string>
+#include <vector>
+#include "GDTF/AssimpModelLoader.h"
+#include "Core/Config.h"
+#include "GDTF/NativeModelLoader.h"
+#include "Geometry/MeshOptimizer.h"
+#include "Geometry/MeshSimplifier.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+struct Summary
+{
+    size_t vertices = 0;
+    size_t triangles = 0;
+    DirectX::XMFLOAT3 min = {0, 0, 0};
+    DirectX::XMFLOAT3 max = {0, 0, 0};
+};
+
+// What ModelLoader does after import, minus the GPU upload
+Summary Process(MeshData &data)
+{
+    Summary summary;
+    GDTF::NativeModelLoader::ScalePositions(data.vertices.data(), data.vertices.size(),
+                                            GDTF::NativeModelLoader::MILLIMETERS_TO_METERS, summary.min, summary.max);
+    MeshOptimizer::ProcessMesh(data);
+    summary.vertices = data.vertices.size();
+    summary.triangles = data.indices.size() / 3;
+    return summary;
+}
+
+bool Close(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f;
+}
+
+bool Compare(const std::string &name, const std::vector<uint8_t> &file)
+{
+    // The importer as it was configured before the native path existed (tangents included)
+    double previousMs = BestOfMs(5,
+                                 [&]()
+                                 {
+                                     Assimp::Importer importer;
+                                     importer.ReadFileFromMemory(
+                                         file.data(), file.size(),
+                                         aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                             aiProcess_SortByPType | aiProcess_GenSmoothNormals |
+                                             aiProcess_CalcTangentSpace | aiProcess_ConvertToLeftHanded,
+                                         name.c_str());
+                                 });
+
+    MeshData assimp;
+    std::string error;
+    bool assimpOk = false;
+    double assimpMs = BestOfMs(
+        5, [&]() { assimpOk = GDTF::AssimpModelLoader::Load(file.data(), file.size(), name, assimp, error); });
+
+    MeshData native;
+    bool nativeOk = false;
+    double nativeMs =
+        BestOfMs(5, [&]() { nativeOk = GDTF::NativeModelLoader::Load(file.data(), file.size(), name, native); });
+
+    std::cout << name << " (" << file.size() / 1024 << " KB)\n"
+              << "  Assimp, previous flags: " << previousMs << " ms\n"
+              << "  AssimpModelLoader:      " << assimpMs << " ms" << (assimpOk ? "" : " FAILED: " + error) << "\n"
+              << "  NativeModelLoader:      " << nativeMs << " ms" << (nativeOk ? "" : " (unsupported)") << "\n";
+    if (!assimpOk || !nativeOk)
+        return !nativeOk; // Unsupported files fall back; only a native result that Assimp rejects is odd
+
+    Summary a = Process(assimp);
+    Summary n = Process(native);
+    bool match = a.vertices == n.vertices && a.triangles == n.triangles && Close(a.min, n.min) && Close(a.max, n.max);
+    // LOD chain as ModelLoader builds it
+    std::vector<MeshSimplifier::LevelReport> lods;
+    double lodMs = BestOfMs(3,
+                            [&]()
+                            {
+                                lods = MeshSimplifier::BuildLodChain(native, Config::Lod::TRIANGLE_RATIOS,
+                                                                     Config::Lod::MAX_ERRORS,
+                                                                     Config::Lod::MAX_LEVELS - 1);
+                            });
+    std::cout << "  LOD chain (" << lodMs << " ms):";
+    for (const auto &lod : lods)
+        std::cout << " " << lod.triangles << " (" << lod.error * 1000.0f << " mm)";
+    std::cout << "\n";
+
+    std::cout << "  speedup " << previousMs / nativeMs << "x, " << n.vertices << " vertices, " << n.triangles
+              << " triangles after processing (Assimp " << a.vertices << ", " << a.triangles << ")\n"
+              << "  output " << (match ? "matches" : "DIFFERS") << "\n";
+    return match;
+}
+
+int main(int argc, char **argv)
+{
+    std::string archive =
+        argc > 1 ? argv[1] : "data/fixtures/Martin_Professional@MAC_Viper_Performance@20230516NoMeas.gdtf";
+
+    mz_zip_archive zip = {};
+    if (!mz_zip_reader_init_file(&zip, archive.c_str(), 0))
+    {
+        std::cerr << "Cannot open " << archive << "\n";
+        return 1;
+    }
+
+    bool ok = true;
+    double nativeTotal = 0.0;
+    const auto count = static_cast<int>(mz_zip_reader_get_num_files(&zip));
+    for (int i = 0; i < count; ++i)
+    {
+        mz_zip_archive_file_stat stat;
+        if (!mz_zip_reader_file_stat(&zip, static_cast<mz_uint>(i), &stat) || stat.m_is_directory)
+            continue;
+        std::string name = stat.m_filename;
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (lower.size() < 4 || (lower.compare(lower.size() - 4, 4, ".3ds") != 0 &&
+                                 lower.compare(lower.size() - 4, 4, ".glb") != 0))
+            continue;
+
+        std::vector<uint8_t> file(static_cast<size_t>(stat.m_uncomp_size));
+        if (!mz_zip_reader_extract_to_mem(&zip, static_cast<mz_uint>(i), file.data(), file.size(), 0))
+            continue;
+
+        ok = Compare(name, file) && ok;
+        MeshData data;
+        nativeTotal += BestOfMs(5, [&]() { GDTF::NativeModelLoader::Load(file.data(), file.size(), name, data); });
+    }
+    mz_zip_reader_end(&zip);
+
+    std::cout << "Native import of all models: " << nativeTotal << " ms\n";
+    return ok ? 0 : 1;
+}
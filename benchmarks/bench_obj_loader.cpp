@@ -0,0 +1,272 @@
+// Compares the chunked ObjLoader against tinyobjloader on the stage model and a synthetic
+// model made of ten offset copies of it, then times a full parse + process against opening
+// the binary mesh cache, with its derived culling data stored or rebuilt. Run from the
+// repository root (or pass the .obj path).
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Core/ThreadPool.h"
+#include "Geometry/ClusterBuilder.h"
+#include "Geometry/MeshOptimizer.h"
+#include "Geometry/VertexQuantizer.h"
+#include "Resources/MeshCache.h"
+#include "Resources/ObjLoader.h"
+#include "Scene/OcclusionBuffer.h"
+#include "tiny_obj_loader.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Same conversion Mesh::LoadFromOBJ performed on top of tinyobjloader
+bool LoadWithTinyObj(const std::string &fileName, MeshData &data)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn;
+    std::string err;
+
+    std::string baseDir;
+    size_t lastSlash = fileName.find_last_of("/\\");
+    if (lastSlash != std::string::npos)
+        baseDir = fileName.substr(0, lastSlash + 1);
+
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, fileName.c_str(), baseDir.c_str()))
+        return false;
+
+    data = MeshData();
+    data.minY = FLT_MAX;
+    for (const auto &shape : shapes)
+    {
+        ShapeInfo info;
+        info.name = shape.name;
+        info.startIndex = static_cast<uint32_t>(data.indices.size());
+        for (const auto &index : shape.mesh.indices)
+        {
+            Vertex vertex = {};
+            const float *p = &attrib.vertices[3 * static_cast<size_t>(index.vertex_index)];
+            vertex.position = {p[0], p[1], p[2]};
+            data.minY = (std::min)(data.minY, p[1]);
+            if (index.normal_index >= 0)
+            {
+                const float *n = &attrib.normals[3 * static_cast<size_t>(index.normal_index)];
+                vertex.normal = {n[0], n[1], n[2]};
+            }
+            if (index.texcoord_index >= 0)
+            {
+                const float *t = &attrib.texcoords[2 * static_cast<size_t>(index.texcoord_index)];
+                vertex.uv = {t[0], 1.0f - t[1]};
+            }
+            data.indices.push_back(static_cast<uint32_t>(data.vertices.size()));
+            data.vertices.push_back(vertex);
+        }
+        info.indexCount = static_cast<uint32_t>(shape.mesh.indices.size());
+        data.shapes.push_back(info);
+    }
+    return true;
+}
+
+// Writes `copies` translated copies of an OBJ into one file, rebasing face indices
+bool WriteReplicatedObj(const std::string &source, const std::string &target, int copies)
+{
+    std::ifstream in(source);
+    if (!in)
+        return false;
+    std::vector<std::string> lines;
+    size_t v = 0, vt = 0, vn = 0;
+    for (std::string line; std::getline(in, line);)
+    {
+        if (line.rfind("v ", 0) == 0)
+            ++v;
+        else if (line.rfind("vt ", 0) == 0)
+            ++vt;
+        else if (line.rfind("vn ", 0) == 0)
+            ++vn;
+        lines.push_back(line);
+    }
+
+    std::ofstream out(target);
+    for (int c = 0; c < copies; ++c)
+    {
+        for (const auto &line : lines)
+        {
+            if (line.rfind("mtllib", 0) == 0 && c > 0)
+                continue;
+            if (line.rfind("v ", 0) == 0)
+            {
+                float x, y, z;
+                std::sscanf(line.c_str() + 2, "%f %f %f", &x, &y, &z);
+                out << "v " << x + static_cast<float>(c) * 120.0f << ' ' << y << ' ' << z << '\n';
+            }
+            else if (line.rfind("f ", 0) == 0)
+            {
+                std::istringstream corners(line.substr(2));
+                out << 'f';
+                for (std::string corner; corners >> corner;)
+                {
+                    long idx[3] = {0, 0, 0};
+                    const size_t bases[3] = {v, vt, vn};
+                    size_t field = 0, start = 0;
+                    out << ' ';
+                    for (size_t i = 0; i <= corner.size(); ++i)
+                    {
+                        if (i == corner.size() || corner[i] == '/')
+                        {
+                            if (i > start)
+                            {
+                                idx[field] = std::stol(corner.substr(start, i - start));
+                                out << (idx[field] > 0 ? idx[field] + static_cast<long>(bases[field] * c) : idx[field]);
+                            }
+                            if (i < corner.size())
+                                out << '/';
+                            ++field;
+                            start = i + 1;
+                        }
+                    }
+                }
+                out << '\n';
+            }
+            else if (line.rfind("o ", 0) == 0 || line.rfind("g ", 0) == 0)
+            {
+                out << line << '_' << c << '\n';
+            }
+            else
+            {
+                out << line << '\n';
+            }
+        }
+    }
+    return true;
+}
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+bool Compare(const std::string &fileName)
+{
+    MeshData reference;
+    MeshData native;
+    double tinyMs = BestOfMs(3, [&]() { LoadWithTinyObj(fileName, reference); });
+    double nativeMs = BestOfMs(3, [&]() { ObjLoader::Load(fileName, native); });
+
+    bool match = reference.vertices.size() == native.vertices.size() &&
+                 reference.shapes.size() == native.shapes.size();
+    for (size_t i = 0; match && i < native.vertices.size(); ++i)
+    {
+        const Vertex &a = reference.vertices[i];
+        const Vertex &b = native.vertices[i];
+        match = a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z &&
+                a.normal.x == b.normal.x && a.uv.y == b.uv.y;
+    }
+    for (size_t s = 0; match && s < native.shapes.size(); ++s)
+    {
+        match = reference.shapes[s].name == native.shapes[s].name &&
+                reference.shapes[s].indexCount == native.shapes[s].indexCount;
+    }
+
+    std::cout << fileName << ": " << native.vertices.size() / 3 << " triangles, " << native.shapes.size()
+              << " shapes\n"
+              << "  tinyobjloader: " << tinyMs << " ms\n"
+              << "  ObjLoader:     " << nativeMs << " ms (" << ThreadPool::Shared().GetThreadCount() + 1
+              << " threads), speedup " << tinyMs / nativeMs << "x\n"
+              << "  output " << (match ? "matches" : "DIFFERS") << "\n";
+    return match;
+}
+
+// Quantized positions, clusters and occluders, as MeshAsset derives them
+void Derive(const PackedMeshView &view, MeshCache::Derived &derived)
+{
+    derived.positionBounds = VertexQuantizer::ComputeBounds(view.vertices, view.vertexCount);
+    derived.positions = VertexQuantizer::QuantizePositions(view.vertices, view.vertexCount, derived.positionBounds);
+    derived.clusters = ClusterBuilder::Build(view);
+    derived.occluderTriangles = OcclusionBuffer::SelectOccluders(view);
+}
+
+// Cold path (parse, process, pack, derive) versus mapping a cache written from its result, with
+// the derived data read from the cache or rebuilt from the mapped mesh
+void CompareCache(const std::string &fileName)
+{
+    const std::string cacheFile = fileName + ".bench.meshcache";
+    std::vector<MeshCache::SourceStamp> stamps;
+    MeshData data;
+    std::vector<uint8_t> indexBytes;
+    std::vector<IndexRange> ranges;
+    PackedMeshView view;
+    MeshCache::Derived derived;
+    double processMs = BestOfMs(3,
+                                [&]()
+                                {
+                                    ObjLoader::Load(fileName, data);
+                                    MeshOptimizer::ProcessMesh(data);
+                                    ClusterBuilder::GroupTriangles(data);
+                                    MeshOptimizer::PackIndices(data.indices, data.shapes, indexBytes, ranges);
+                                    view.vertices = data.vertices.data();
+                                    view.vertexCount = data.vertices.size();
+                                    view.indexBytes = indexBytes.data();
+                                    view.indexByteCount = indexBytes.size();
+                                    view.ranges = ranges.data();
+                                    view.rangeCount = ranges.size();
+                                    Derive(view, derived);
+                                });
+
+    stamps = MeshCache::ComputeStamps({fileName});
+    MeshCache::Write(cacheFile, stamps, view, data.shapes, data.minY, derived);
+
+    size_t cachedVertices = 0;
+    size_t cachedClusters = 0;
+    double cacheMs = BestOfMs(3,
+                              [&]()
+                              {
+                                  MeshCache cache;
+                                  if (cache.Open(cacheFile, MeshCache::ComputeStamps({fileName})))
+                                  {
+                                      cachedVertices = cache.GetView().vertexCount;
+                                      cachedClusters = cache.TakeDerived().clusters.size();
+                                  }
+                              });
+    double rederiveMs = BestOfMs(3,
+                                 [&]()
+                                 {
+                                     MeshCache cache;
+                                     MeshCache::Derived rebuilt;
+                                     if (cache.Open(cacheFile, MeshCache::ComputeStamps({fileName})))
+                                         Derive(cache.GetView(), rebuilt);
+                                 });
+
+    std::cout << "  parse + process + derive: " << processMs << " ms\n"
+              << "  cache (stamp + map + derived): " << cacheMs << " ms, " << cachedVertices << " vertices, "
+              << cachedClusters << " clusters\n"
+              << "  cache, derived rebuilt: " << rederiveMs << " ms\n";
+    std::remove(cacheFile.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    std::string stage = argc > 1 ? argv[1] : "data/models/stage.obj";
+    std::string synthetic = stage.substr(0, stage.find_last_of("/\\") + 1) + "stage_x10.obj";
+
+    bool ok = Compare(stage);
+    CompareCache(stage);
+    if (WriteReplicatedObj(stage, synthetic, 10))
+    {
+        ok = Compare(synthetic) && ok;
+        CompareCache(synthetic);
+        std::remove(synthetic.c_str());
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// CPU phase of scene loading (SceneAssets), timed part by part without a device: the stage
+// OBJ parsed and processed from scratch and then mapped from its cache, the GDTF's models
+// imported and processed, and its gobos prepared. The same work then runs as a task graph,
+// printing its timeline. Last, the whole phase runs on a background thread while the main
+// thread keeps ticking 16 ms frames, the way a loading screen hides it, reporting how many
+// frames went by and the longest one. The stage is copied to a temporary directory so the
+// repository's own cache is left alone.
+// Usage: bench_scene_assets [stage.obj] [fixture.gdtf]; run from the repository root.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "Core/Config.h"
+#include "Core/TaskGraph.h"
+#include "Core/ThreadPool.h"
+#include "GDTF/GDTFParser.h"
+#include "Scene/SceneAssets.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+constexpr auto FRAME_TIME = std::chrono::milliseconds(16);
+
+double MsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/// Copies the OBJ and its companions (MTL, textures) next to each other in a fresh directory.
+std::string CopyStage(const std::string &stageFile)
+{
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "bench_scene_assets";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const fs::path source(stageFile);
+    for (const auto &entry : fs::directory_iterator(source.parent_path()))
+    {
+        if (entry.path().stem() == source.stem() && entry.path().extension() != ".meshcache")
+            fs::copy_file(entry.path(), dir / entry.path().filename());
+    }
+    return (dir / source.filename()).string();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const std::string stageFile = argc > 1 ? argv[1] : "data/models/stage.obj";
+    const std::string fixtureFile = argc > 2 ? argv[2] : Config::Fixtures::DEFAULT_GDTF;
+    const std::string stageCopy = CopyStage(stageFile);
+
+    SceneAssets assets;
+    auto start = Clock::now();
+    if (!assets.LoadStage(stageCopy))
+    {
+        std::cerr << "Cannot load " << stageFile << std::endl;
+        return 1;
+    }
+    const double stageColdMs = MsSince(start);
+
+    start = Clock::now();
+    SceneAssets cached;
+    cached.LoadStage(stageCopy);
+    const double stageCachedMs = MsSince(start);
+
+    start = Clock::now();
+    GDTF::GDTFParser parser;
+    const bool parsed = parser.Load(fixtureFile);
+    const double parseMs = MsSince(start);
+    start = Clock::now();
+    if (parsed)
+        assets.LoadFixture(parser);
+    const double fixtureMs = MsSince(start);
+    start = Clock::now();
+    assets.LoadGobos(parser, fixtureFile);
+    const double gobosMs = MsSince(start);
+
+    size_t vertices = 0;
+    for (const MeshAsset &mesh : assets.fixture.GetMeshes())
+        vertices += mesh.GetView().vertexCount;
+    std::printf("stage, parsed:         %8.1f ms  (%zu vertices, %zu anchors)\n", stageColdMs,
+                assets.stage.GetView().vertexCount, assets.anchorPositions.size());
+    std::printf("stage, from cache:     %8.1f ms\n", stageCachedMs);
+    std::printf("GDTF description:      %8.1f ms\n", parseMs);
+    std::printf("fixture models:        %8.1f ms  (%zu models, %zu vertices)\n", fixtureMs,
+                assets.fixture.GetMeshes().size(), vertices);
+    std::printf("gobos:                 %8.1f ms  (%zu slots, %s)\n", gobosMs, assets.goboSlotNames.size(),
+                Config::Gobo::STREAMING ? "streamed" : "library");
+    std::printf("upload batch:          %8.1f KB\n\n", static_cast<double>(assets.GetUploadBytes()) / 1024.0);
+
+    // The same work as a task graph: the stage, each model and the gobos overlap
+    TaskGraph graph;
+    SceneAssets scheduled;
+    scheduled.AddTasks(graph, stageCopy, fixtureFile);
+    const bool scheduledOk = graph.Run(ThreadPool::Shared());
+    std::printf("task graph:            %8.1f ms  (%s; the parts above, cached, add up to %.1f ms)\n",
+                graph.GetTotalMs(), scheduledOk ? "ok" : "failed", stageCachedMs + parseMs + fixtureMs + gobosMs);
+    graph.WriteTimeline(std::cout);
+    std::cout << std::endl;
+
+    // The whole phase behind a loading screen: frames keep coming while it runs
+    std::atomic<bool> done{false};
+    bool loaded = false;
+    double loadMs = 0.0;
+    SceneAssets background;
+    start = Clock::now();
+    std::thread loader([&]() {
+        loaded = background.Load(stageCopy, fixtureFile);
+        loadMs = MsSince(start);
+        done = true;
+    });
+    int frames = 0;
+    double longestFrameMs = 0.0;
+    while (!done)
+    {
+        const auto frameStart = Clock::now();
+        std::this_thread::sleep_until(frameStart + FRAME_TIME);
+        longestFrameMs = (std::max)(longestFrameMs, MsSince(frameStart));
+        ++frames;
+    }
+    loader.join();
+    std::printf("background Load():     %8.1f ms  (%s), %d frames shown, longest %.1f ms\n", loadMs,
+                loaded ? "ok" : "failed", frames, longestFrameMs);
+
+    std::filesystem::remove_all(std::filesystem::path(stageCopy).parent_path());
+    return 0;
+}
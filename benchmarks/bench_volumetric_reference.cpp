@@ -0,0 +1,104 @@
+// Renders the default view's volumetric lighting on the CPU (lights on the stage anchors, gobo
+// from data/models/gobo.jpg, no shadows or scene depth) and writes it as Radiance HDR.
+// Reports the render time of the vector path against the scalar reference on one row.
+// Run from the repository root (or pass the output path).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "Core/Config.h"
+#include "Core/ThreadPool.h"
+#include "Rendering/VolumetricReference.h"
+#include "Resources/ObjLoader.h"
+#include "bench_lights.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> double BestOfMs(int runs, F &&fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = Clock::now();
+        fn();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const std::string outputName = argc > 1 ? argv[1] : "volumetric_reference.hdr";
+
+    // Lights on the stage anchors, as Scene places them
+    std::vector<SpotlightData> lights;
+    MeshData stage;
+    if (ObjLoader::Load("data/models/stage.obj", stage))
+    {
+        const float stageOffset = Config::Room::FLOOR_Y - stage.minY;
+        for (const auto &shape : stage.shapes)
+        {
+            if (shape.name.find("Anchor.") == 0 && lights.size() < Config::Spotlight::MAX_SPOTLIGHTS)
+            {
+                lights.push_back(
+                    BenchLights::AtStageCenter({shape.center.x, shape.center.y + stageOffset, shape.center.z}));
+            }
+        }
+    }
+    if (lights.empty())
+        lights.push_back(BenchLights::AtStageCenter({0.0f, Config::Spotlight::DEFAULT_HEIGHT, 0.0f}));
+
+    VolumetricReference::TextureArray gobos;
+    std::ifstream goboFile("data/models/gobo.jpg", std::ios::binary);
+    const std::vector<uint8_t> goboData((std::istreambuf_iterator<char>(goboFile)), std::istreambuf_iterator<char>());
+    const bool hasGobo = VolumetricReference::LoadGobos({goboData}, gobos);
+
+    // Default orbit camera
+    using namespace Config::CameraDefaults;
+    const DirectX::XMFLOAT3 eye = {DISTANCE * std::cos(PITCH) * std::sin(YAW), DISTANCE * std::sin(PITCH),
+                                   -DISTANCE * std::cos(PITCH) * std::cos(YAW)};
+    const DirectX::XMMATRIX viewMatrix =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                  DirectX::XMVectorSet(TARGET_X, TARGET_Y, TARGET_Z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj =
+        DirectX::XMMatrixPerspectiveFovLH(FOV, Config::Display::ASPECT_RATIO, CLIP_NEAR, CLIP_FAR);
+
+    VolumetricReference::Inputs inputs;
+    DirectX::XMStoreFloat4x4(&inputs.invViewProj, DirectX::XMMatrixInverse(nullptr, viewMatrix * proj));
+    inputs.cameraPos = eye;
+    inputs.lights = lights.data();
+    inputs.lightCount = lights.size();
+    inputs.params.params = {Config::Volumetric::DEFAULT_STEP_COUNT, Config::Volumetric::DEFAULT_DENSITY,
+                            Config::Volumetric::DEFAULT_INTENSITY, Config::Volumetric::DEFAULT_ANISOTROPY};
+    inputs.gobos = hasGobo ? &gobos : nullptr;
+
+    std::vector<float> rgb;
+    const double renderMs = BestOfMs(1, [&]() { VolumetricReference::Render(inputs, rgb); });
+    const double scalarRowMs = BestOfMs(1,
+                                        [&]()
+                                        {
+                                            for (int x = 0; x < inputs.width; ++x)
+                                                VolumetricReference::ShadePixel(inputs, x, inputs.height / 2);
+                                        });
+    if (!VolumetricReference::WriteHdr(outputName, inputs.width, inputs.height, rgb))
+    {
+        std::cerr << "Failed to write " << outputName << std::endl;
+        return 1;
+    }
+
+    float peak = 0.0f;
+    for (float v : rgb)
+        peak = (std::max)(peak, v);
+    std::cout << inputs.width << "x" << inputs.height << ", " << lights.size() << " lights, "
+              << static_cast<int>(inputs.params.params.x) << " steps, gobo " << (hasGobo ? "loaded" : "open") << "\n"
+              << "  render: " << renderMs << " ms (" << ThreadPool::Shared().GetThreadCount() + 1 << " threads)\n"
+              << "  scalar reference, middle row: " << scalarRowMs << " ms (x" << inputs.height
+              << " for a frame on one thread)\n"
+              << "  peak radiance " << peak << ", written to " << outputName << "\n";
+    return 0;
+}
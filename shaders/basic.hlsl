@@ -6,13 +6,14 @@ cbuffer MatrixBuffer : register(b0) {
     float4 cameraPos;
 };
 
+// dirAngle.w and goboOff.zw are only filled in the volumetric pass's copy (0 elsewhere)
 struct SpotlightData {
     matrix lightViewProj;
     float4 posRange;      // xyz: pos, w: range
-    float4 dirAngle;      // xyz: dir, w: spotAngle
+    float4 dirAngle;      // xyz: dir, w: nearest view depth of the beam (tile mask on)
     float4 colorInt;      // xyz: color, w: intensity
-    float4 coneGobo;      // x: beam, y: field, z: rotation
-    float4 goboOff;       // xy: offset
+    float4 coneGobo;      // x: beam, y: field, z: rotation, w: gobo array layer
+    float4 goboOff;       // xy: offset, z: analytic beam core, w: steps (0: volParams.x)
 };
 
 #define MAX_LIGHTS 4
@@ -36,8 +37,17 @@ cbuffer CeilingLightsBuffer : register(b3) {
     float4 ambientColor;
 };
 
-Texture2DArray goboTexture : register(t0);
-Texture2DArray shadowMap : register(t1);
+cbuffer QuantizationBuffer : register(b4) {
+    float4 quantMin;    // xyz: minimum corner of the mesh bounds
+    float4 quantExtent; // xyz: size of the mesh bounds
+};
+
+cbuffer GoboFormatBuffer : register(b5) {
+    float4 goboFlags; // x: bit i set when light i's gobo array is monochrome (BC4, read red)
+};
+
+Texture2DArray goboTextures[MAX_LIGHTS] : register(t0); // Each light's GoboLibrary size class, t0-t3
+Texture2DArray shadowMap : register(t4);
 SamplerState samLinear : register(s0);
 SamplerComparisonState shadowSampler : register(s1);
 
@@ -65,13 +75,38 @@ PS_INPUT VS(VS_INPUT input) {
     return output;
 }
 
+// VertexQuantizer::QuantizedVertex: UNORM16 position in the mesh bounds, octahedral SNORM16
+// normal, half-float UV
+struct VS_QUANTIZED_INPUT {
+    float4 pos : POSITION;
+    float2 normal : NORMAL;
+    float2 uv : TEXCOORD;
+};
+
+// Inverse of VertexQuantizer::EncodeOctahedral: unfold the lower hemisphere over the diagonals
+float3 DecodeOctahedral(float2 e) {
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0f);
+    n.xy += (n.xy >= 0.0f) ? -t : t;
+    return normalize(n);
+}
+
+PS_INPUT VSQuantized(VS_QUANTIZED_INPUT input) {
+    VS_INPUT full;
+    full.pos = quantMin.xyz + input.pos.xyz * quantExtent.xyz;
+    full.normal = DecodeOctahedral(input.normal);
+    full.uv = input.uv;
+    return VS(full);
+}
+
 float4 PS(PS_INPUT input) : SV_Target {
     float3 normal = normalize(input.normal);
     float3 viewDir = normalize(cameraPos.xyz - input.worldPos);
 
     float3 spotlighting = float3(0,0,0);
 
-    // Loop through spotlights
+    // Loop through spotlights (unrolled: texture arrays are only indexed by literals)
+    [unroll]
     for (int i = 0; i < MAX_LIGHTS; ++i) {
         if (lights[i].colorInt.w <= 0.0f) continue;
 
@@ -114,8 +149,10 @@ float4 PS(PS_INPUT input) : SV_Target {
                 finalUV.y = 1.0f - finalUV.y;
                 
                 // Clamp gobo - sample from texture array using gobo index
-                if (finalUV.x >= 0 && finalUV.x <= 1 && finalUV.y >= 0 && finalUV.y <= 1)
-                     goboColor = goboTexture.Sample(samLinear, float3(finalUV, lights[i].coneGobo.w)).rgb;
+                if (finalUV.x >= 0 && finalUV.x <= 1 && finalUV.y >= 0 && finalUV.y <= 1) {
+                     float3 gobo = goboTextures[i].Sample(samLinear, float3(finalUV, lights[i].coneGobo.w)).rgb;
+                     goboColor = ((uint)goboFlags.x & (1u << i)) != 0 ? gobo.rrr : gobo;
+                }
 
                 // Shadow mapping for each light
                 float2 shadowUV = projCoords.xy * 0.5f + 0.5f;
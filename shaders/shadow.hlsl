@@ -6,10 +6,10 @@ cbuffer MatrixBuffer : register(b0) {
     float4 cameraPos;
 };
 
+// Quantized position stream (R16G16B16A16_UNORM); the [0, 1] to mesh-space
+// scale and offset is folded into the world matrix.
 struct VS_INPUT {
-    float3 pos : POSITION;
-    float3 normal : NORMAL;
-    float2 uv : TEXCOORD;
+    float4 pos : POSITION;
 };
 
 struct PS_INPUT {
@@ -18,7 +18,7 @@ struct PS_INPUT {
 
 PS_INPUT VS(VS_INPUT input) {
     PS_INPUT output;
-    float4 worldPos = mul(float4(input.pos, 1.0f), world);
+    float4 worldPos = mul(float4(input.pos.xyz, 1.0f), world);
     output.pos = mul(worldPos, viewProj);
     return output;
 }
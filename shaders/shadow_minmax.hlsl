@@ -0,0 +1,45 @@
+// Min/max depth mips of the shadow map array, mirrors ShadowMinMax::Build (C++)
+
+cbuffer MinMaxBuffer : register(b0) {
+    float4 minMaxParams; // x: array slice, y: 0 to reduce the shadow map, 1 to reduce the previous level
+};
+
+Texture2DArray<float> shadowMap : register(t0);       // Depths, read for the first level
+Texture2DArray<float2> previousLevel : register(t1);  // (min, max), read for the others
+
+struct VS_INPUT {
+    float3 pos : POSITION;
+};
+
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+};
+
+PS_INPUT VS(VS_INPUT input) {
+    PS_INPUT output;
+    output.pos = float4(input.pos, 1.0f);
+    return output;
+}
+
+// Each output texel covers a 2x2 block of the level below
+float2 PS(PS_INPUT input) : SV_Target {
+    int slice = (int)minMaxParams.x;
+    int2 source = int2(input.pos.xy) * 2;
+    float2 result = float2(1e30f, -1e30f);
+
+    [unroll]
+    for (int j = 0; j < 2; ++j) {
+        [unroll]
+        for (int i = 0; i < 2; ++i) {
+            int4 coord = int4(source + int2(i, j), slice, 0);
+            if (minMaxParams.y < 0.5f) {
+                float depth = shadowMap.Load(coord);
+                result = float2(min(result.x, depth), max(result.y, depth));
+            } else {
+                float2 texel = previousLevel.Load(coord);
+                result = float2(min(result.x, texel.x), max(result.y, texel.y));
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,109 @@
+// Temporal accumulation of the volumetric buffer, mirrors TemporalReprojection (C++)
+
+cbuffer MatrixBuffer : register(b0) {
+    matrix world;
+    matrix view;
+    matrix projection;
+    matrix invViewProj;
+    float4 cameraPos;
+};
+
+cbuffer TemporalBuffer : register(b1) {
+    matrix prevViewProj;   // Previous frame's world-to-clip
+    float4 prevCameraPos;  // xyz: previous camera position, w: blend weight of the current frame
+    float4 temporalParams; // x: 1 to discard the history, y: distance tolerance, zw: texel size
+};
+
+Texture2D currentTexture : register(t0); // This frame's volumetric result
+Texture2D historyTexture : register(t1); // rgb: accumulated result, a: surface distance
+Texture2D depthTexture : register(t2);
+SamplerState samLinear : register(s0);
+
+struct VS_INPUT {
+    float3 pos : POSITION;
+};
+
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+};
+
+struct PS_OUTPUT {
+    float4 color : SV_Target0;   // Volumetric buffer for blur and composite
+    float4 history : SV_Target1; // Next frame's history
+};
+
+PS_INPUT VS(VS_INPUT input) {
+    PS_INPUT output;
+    output.pos = float4(input.pos, 1.0f);
+    return output;
+}
+
+float3 ScreenToWorld(float2 uv, float depth) {
+    float4 clipPos = float4(uv.x * 2.0f - 1.0f, (1.0f - uv.y) * 2.0f - 1.0f, depth, 1.0f);
+    float4 worldPos = mul(clipPos, invViewProj);
+    return worldPos.xyz / worldPos.w;
+}
+
+// TemporalReprojection::Reproject
+bool Reproject(float3 worldPos, out float2 uv) {
+    float4 clipPos = mul(float4(worldPos, 1.0f), prevViewProj);
+    uv = float2(0, 0);
+    if (clipPos.w <= 0.0f) return false;
+    uv = float2(clipPos.x / clipPos.w * 0.5f + 0.5f, 0.5f - clipPos.y / clipPos.w * 0.5f);
+    return all(uv >= 0.0f) && all(uv <= 1.0f);
+}
+
+// TemporalReprojection::IsHistoryValid
+bool IsHistoryValid(float expectedDistance, float historyDistance) {
+    return abs(historyDistance - expectedDistance) <= temporalParams.y * expectedDistance;
+}
+
+// TemporalReprojection::ClampToNeighborhood
+float3 ClampToNeighborhood(float3 history, float3 neighborhoodMin, float3 neighborhoodMax) {
+    return clamp(history, neighborhoodMin, neighborhoodMax);
+}
+
+// TemporalReprojection::ResolvePixel
+float3 ResolvePixel(float3 current, float3 history, float blend) {
+    return lerp(history, current, blend);
+}
+
+PS_OUTPUT PS(PS_INPUT input) {
+    int2 pixel = int2(input.pos.xy);
+    float2 uv = input.pos.xy * temporalParams.zw;
+    float depth = min(depthTexture.Load(int3(pixel, 0)).r, 1.0f);
+    float3 worldPos = ScreenToWorld(uv, depth);
+    float3 current = currentTexture.Load(int3(pixel, 0)).rgb;
+
+    float3 result = current;
+    float2 previousUv;
+    if (temporalParams.x < 0.5f && Reproject(worldPos, previousUv)) {
+        // Keep the bilinear footprint inside the texture: clamp addressing with the border sampler
+        float2 halfTexel = 0.5f * temporalParams.zw;
+        previousUv = clamp(previousUv, halfTexel, 1.0f - halfTexel);
+        float4 history = historyTexture.SampleLevel(samLinear, previousUv, 0);
+        if (IsHistoryValid(length(worldPos - prevCameraPos.xyz), history.a)) {
+            // 3x3 bounds of the current frame, clamped at the image edges
+            uint width, height;
+            currentTexture.GetDimensions(width, height);
+            int2 maxPixel = int2(width, height) - 1;
+            float3 lo = current;
+            float3 hi = current;
+            [unroll]
+            for (int y = -1; y <= 1; ++y) {
+                [unroll]
+                for (int x = -1; x <= 1; ++x) {
+                    float3 n = currentTexture.Load(int3(clamp(pixel + int2(x, y), 0, maxPixel), 0)).rgb;
+                    lo = min(lo, n);
+                    hi = max(hi, n);
+                }
+            }
+            result = ResolvePixel(current, ClampToNeighborhood(history.rgb, lo, hi), prevCameraPos.w);
+        }
+    }
+
+    PS_OUTPUT output;
+    output.color = float4(result, 1.0f);
+    output.history = float4(result, length(worldPos - cameraPos.xyz));
+    return output;
+}
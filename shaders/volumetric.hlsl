@@ -6,13 +6,14 @@ cbuffer MatrixBuffer : register(b0) {
     float4 cameraPos;
 };
 
+// dirAngle.w and goboOff.zw are only filled in the volumetric pass's copy (0 elsewhere)
 struct SpotlightData {
     matrix lightViewProj;
     float4 posRange;      // xyz: pos, w: range
-    float4 dirAngle;      // xyz: dir, w: spotAngle
+    float4 dirAngle;      // xyz: dir, w: nearest view depth of the beam (tile mask on)
     float4 colorInt;      // xyz: color, w: intensity
-    float4 coneGobo;      // x: beam, y: field, z: rotation
-    float4 goboOff;       // xy: offset
+    float4 coneGobo;      // x: beam, y: field, z: rotation, w: gobo array layer
+    float4 goboOff;       // xy: offset, z: analytic beam core, w: steps (0: volParams.x)
 };
 
 #define MAX_LIGHTS 4
@@ -23,12 +24,70 @@ cbuffer SpotlightBuffer : register(b1) {
 
 cbuffer VolumetricBuffer : register(b2) {
     float4 volParams; // x: stepCount, y: density, z: intensity, w: anisotropy (G)
-    float4 volJitter; // x: time
+    float4 volJitter; // x: time, y: 1 to integrate unshadowed beam cores analytically, z: noise offset,
+                      // w: feature bits (FEATURE_TILE_MASK, ..., FEATURE_GOBO_MONO)
+    float4 volScreen; // xy: render target size in pixels, zw: 1 / size
+};
+
+// Bits of volJitter.w: the tile mask and the beams' nearest depths, the min/max shadow intervals,
+// the epipolar samples, the per-tile light picks, the gobo footprint filtering, the simulated haze,
+// and, one bit per light from FEATURE_GOBO_MONO up, a one-channel (BC4) gobo array whose red channel
+// stands for all three
+#define FEATURE_TILE_MASK 1
+#define FEATURE_SHADOW_INTERVALS 2
+#define FEATURE_EPIPOLAR 4
+#define FEATURE_LIGHT_SAMPLING 8
+#define FEATURE_GOBO_SAT 16
+#define FEATURE_HAZE 32
+#define FEATURE_GOBO_MONO 64
+
+cbuffer EpipolarBuffer : register(b3) {
+    float4 epipolarLights[MAX_LIGHTS]; // xy: light position in pixels, z: 1 when the light has epipolar samples
 };
 
 Texture2D depthTexture : register(t0);
-Texture2DArray goboTexture : register(t1);
-Texture2DArray shadowMap : register(t2);
+Texture2DArray shadowMap : register(t1);
+Texture2D<float> inScatterTable : register(t2); // AnalyticScattering::Table for volParams.w
+Texture2D<uint> tileMask : register(t3);        // ConeBounds::TileMask: bit i for light i
+Texture2DArray<float2> shadowMinMax : register(t4); // (min, max) depth mips of shadowMap, see ShadowMinMax
+Texture2D<float4> epipolarLines : register(t5);     // Entry (xy), exit (zw) in pixels, a row per light; x < 0: invalid
+Texture2D<float4> epipolarScatter : register(t6);   // PSEpipolarSamples output, unbound while it runs
+Texture2D<uint2> epipolarSources : register(t7);
+Texture2D<float4> lightTables : register(t8);   // LightSampling::AliasEntry, MAX_LIGHTS texels per tile
+Texture3D<float> hazeDensity : register(t9);    // HazeSimulation's density over the room
+Texture2DArray goboTextures[MAX_LIGHTS] : register(t10); // Each light's GoboLibrary size class, t10-t13
+Texture2DArray<uint4> goboSats[MAX_LIGHTS] : register(t14); // SummedAreaTable of each, one texel wider and taller
+
+// Config::Volumetric::TILE_SIZE
+#define TILE_SIZE 16
+
+// Config::Shadow::MAP_SIZE / DEPTH_BIAS / MINMAX_LEVELS and Config::Volumetric::SHADOW_INTERVALS
+#define SHADOW_MAP_SIZE 2048
+#define SHADOW_BIAS 0.01f
+#define SHADOW_MINMAX_LEVELS 6
+#define SHADOW_INTERVALS 8
+
+// Config::Volumetric::EPIPOLAR_*, and EpipolarSampling's least bilinear weight of matching samples
+#define EPIPOLAR_LINES 512
+#define EPIPOLAR_SAMPLES 512
+#define EPIPOLAR_INITIAL_STEP 16
+#define EPIPOLAR_DEPTH_THRESHOLD 0.1f
+#define EPIPOLAR_MIN_WEIGHT 0.05f
+
+// Config::Volumetric::LIGHT_SAMPLES
+#define LIGHT_SAMPLES 1
+
+// Config::Volumetric::GOBO_SAT_MIN_FOOTPRINT
+#define GOBO_SAT_MIN_FOOTPRINT 1.0f
+
+// Config::Room, the box HazeSimulation covers, and Config::Haze::GRID_SIZE
+#define ROOM_MIN float3(-50.0f, -0.05f, -50.0f)
+#define ROOM_MAX float3(50.0f, 100.0f, 50.0f)
+#define HAZE_GRID_SIZE 64
+
+// Config::Volumetric::ANALYTIC_PROBES / ANALYTIC_MAX_VARIATION
+#define ANALYTIC_PROBES 8
+#define ANALYTIC_MAX_VARIATION 0.05f
 
 SamplerState samLinear : register(s0);
 SamplerComparisonState shadowSampler : register(s1);
@@ -151,133 +210,570 @@ float2 RayConeIntersect(float3 ray_origin, float3 ray_dir, float3 cone_apex, flo
     return float2(-1.0f, -1.0f);
 }
 
-float4 PS(PS_INPUT input) : SV_Target {
-    float2 uv = input.pos.xy / float2(1920.0f, 1080.0f);
+bool FeatureEnabled(uint bit) {
+    return ((uint)volJitter.w & bit) != 0;
+}
 
-    uint2 pixelPos = uint2(input.pos.xy);
-    float depth = depthTexture.Load(uint3(pixelPos, 0)).r;
+// Simulated haze density at a world position relative to volParams.y, 1 without the simulation;
+// clamped to the outer cell centers as HazeSimulation::SampleDensity, so the border never blends in
+float HazeDensity(float3 pos) {
+    if (!FeatureEnabled(FEATURE_HAZE)) return 1.0f;
+    float3 uvw = (pos - ROOM_MIN) / (ROOM_MAX - ROOM_MIN);
+    uvw = clamp(uvw, 0.5f / HAZE_GRID_SIZE, 1.0f - 0.5f / HAZE_GRID_SIZE);
+    return hazeDensity.SampleLevel(samLinear, uvw, 0);
+}
 
-    float3 worldPos = ScreenToWorld(uv, depth);
-    float3 camPos = cameraPos.xyz;
+// Gobo texture coordinates of a point projected by light i, rotated and offset like the gobo
+float2 GoboUV(int i, float2 projected) {
+    float gs, gc;
+    sincos(lights[i].coneGobo.z, gs, gc);
+    float2 rUV;
+    rUV.x = projected.x * gc - projected.y * gs;
+    rUV.y = projected.x * gs + projected.y * gc;
+    rUV += lights[i].goboOff.xy;
+    float2 goboUV = rUV * 0.5f + 0.5f;
+    goboUV.y = 1.0f - goboUV.y;
+    return goboUV;
+}
 
-    if (depth >= 1.0f) {
-        worldPos = ScreenToWorld(uv, 1.0f);
+// Light i's gobo array: each light samples its own GoboLibrary size class. Shader model 5.0 only
+// indexes texture arrays with literals, hence the switches over the MAX_LIGHTS lights
+float3 SampleGobo(int i, float2 uv) {
+    float3 uvw = float3(uv, lights[i].coneGobo.w);
+    float4 gobo;
+    switch (i) {
+    case 0: gobo = goboTextures[0].SampleLevel(samLinear, uvw, 0); break;
+    case 1: gobo = goboTextures[1].SampleLevel(samLinear, uvw, 0); break;
+    case 2: gobo = goboTextures[2].SampleLevel(samLinear, uvw, 0); break;
+    default: gobo = goboTextures[3].SampleLevel(samLinear, uvw, 0); break;
     }
+    return FeatureEnabled(FEATURE_GOBO_MONO << i) ? gobo.rrr : gobo.rgb;
+}
 
-    float3 rayDirVec = worldPos - camPos;
-    float rayLen = length(rayDirVec);
-    float3 rayDir = rayDirVec / max(rayLen, 0.0001f);
+float2 GoboSize(int i) {
+    uint w, h, layers;
+    switch (i) {
+    case 0: goboTextures[0].GetDimensions(w, h, layers); break;
+    case 1: goboTextures[1].GetDimensions(w, h, layers); break;
+    case 2: goboTextures[2].GetDimensions(w, h, layers); break;
+    default: goboTextures[3].GetDimensions(w, h, layers); break;
+    }
+    return float2(w, h);
+}
+
+uint4 LoadGoboSat(int i, int2 p) {
+    int4 location = int4(p, (int)lights[i].coneGobo.w, 0);
+    switch (i) {
+    case 0: return goboSats[0].Load(location);
+    case 1: return goboSats[1].Load(location);
+    case 2: return goboSats[2].Load(location);
+    default: return goboSats[3].Load(location);
+    }
+}
+
+// Average gobo color over a footprint of halfTexels around uv, from the summed-area table;
+// mirrors SummedAreaTable::FootprintAverage (C++), texels outside the gobo are black
+float3 GoboFootprint(int i, float2 uv, float2 halfTexels) {
+    int2 size = (int2)GoboSize(i); // Its table is one texel wider and taller
+    float2 center = uv * size;
+    int2 p0 = (int2)floor(center - halfTexels + 0.5f);
+    int2 p1 = max((int2)floor(center + halfTexels + 0.5f), p0 + 1);
+    float area = (float)(p1.x - p0.x) * (float)(p1.y - p0.y);
+    p0 = clamp(p0, 0, size);
+    p1 = clamp(p1, 0, size);
+
+    uint4 s00 = LoadGoboSat(i, int2(p0.x, p0.y));
+    uint4 s10 = LoadGoboSat(i, int2(p1.x, p0.y));
+    uint4 s01 = LoadGoboSat(i, int2(p0.x, p1.y));
+    uint4 s11 = LoadGoboSat(i, int2(p1.x, p1.y));
+    return (float3)(s11.rgb - s10.rgb - s01.rgb + s00.rgb) / (255.0f * area);
+}
+
+// Shadow times gobo color at a world position lit by light i (the spot factor is not included);
+// lit skips the shadow map where ClassifyInterval already knows the comparison passes. The sample
+// stands for the segment pos +- halfStep: when that covers more than GOBO_SAT_MIN_FOOTPRINT gobo
+// texels either side, the gobo is averaged over the segment's bounding box instead of sampled.
+float3 LightVisibility(int i, float3 pos, float3 halfStep, bool lit) {
+    float shadow = 1.0f;
+
+    // Shadow mapping
+    float4 lightSpacePos = mul(float4(pos, 1.0f), lights[i].lightViewProj);
+    float3 projCoords = float3(0, 0, 0);
+    if (lightSpacePos.w > 0.0f) {
+        projCoords = lightSpacePos.xyz / lightSpacePos.w;
+        float2 shadowUV = projCoords.xy * 0.5f + 0.5f;
+        shadowUV.y = 1.0f - shadowUV.y;
+
+        if (!lit && shadowUV.x >= 0 && shadowUV.x <= 1 && shadowUV.y >= 0 && shadowUV.y <= 1) {
+            shadow = shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV, i), projCoords.z - SHADOW_BIAS).r;
+        }
+    }
+
+    if (shadow <= 0) return float3(0, 0, 0);
+
+    // Gobo sampling
+    float3 goboColor = float3(1,1,1);
+    {
+        float2 goboUV = GoboUV(i, projCoords.xy);
+
+        float2 halfTexels = float2(0, 0);
+        float4 stepEnd = mul(float4(pos + halfStep, 1.0f), lights[i].lightViewProj);
+        if (FeatureEnabled(FEATURE_GOBO_SAT) && lightSpacePos.w > 0.0f && stepEnd.w > 0.0f)
+            halfTexels = abs(GoboUV(i, stepEnd.xy / stepEnd.w) - goboUV) * GoboSize(i);
+
+        if (max(halfTexels.x, halfTexels.y) > GOBO_SAT_MIN_FOOTPRINT)
+            goboColor = GoboFootprint(i, goboUV, halfTexels);
+        else if (goboUV.x >= 0 && goboUV.x <= 1 && goboUV.y >= 0 && goboUV.y <= 1)
+            goboColor = SampleGobo(i, goboUV);
+        else
+            goboColor = float3(0,0,0);
+    }
+    return shadow * goboColor;
+}
+
+#define VIS_LIT 0
+#define VIS_SHADOWED 1
+#define VIS_MIXED 2
+
+// Whether the shadow map of light i lights all of the segment a-b, none of it, or some;
+// mirrors ShadowMinMax::Classify (C++), which documents the bounds
+int ClassifyInterval(int i, float3 a, float3 b) {
+    float4 clipA = mul(float4(a, 1.0f), lights[i].lightViewProj);
+    float4 clipB = mul(float4(b, 1.0f), lights[i].lightViewProj);
+    if (min(clipA.w, clipB.w) <= 1e-3f) return VIS_MIXED;
+
+    float3 ndcA = clipA.xyz / clipA.w;
+    float3 ndcB = clipB.xyz / clipB.w;
+    float2 uvA = float2(ndcA.x * 0.5f + 0.5f, 0.5f - ndcA.y * 0.5f);
+    float2 uvB = float2(ndcB.x * 0.5f + 0.5f, 0.5f - ndcB.y * 0.5f);
+    float2 uvMin = min(uvA, uvB);
+    float2 uvMax = max(uvA, uvB);
+
+    // Nothing is sampled outside the map
+    if (any(uvMax < 0.0f) || any(uvMin > 1.0f)) return VIS_LIT;
+    bool partlyOutside = any(uvMin < 1e-4f) || any(uvMax > 1.0f - 1e-4f);
+
+    // Texels under the bilinear footprint, the border reads as depth 1
+    uvMin = max(uvMin, -1.0f);
+    uvMax = min(uvMax, 2.0f);
+    int2 p0 = (int2)floor(uvMin * SHADOW_MAP_SIZE - 0.75f);
+    int2 p1 = (int2)floor(uvMax * SHADOW_MAP_SIZE - 0.25f) + 1;
+    bool border = any(p0 < 0) || any(p1 >= SHADOW_MAP_SIZE);
+    p0 = max(p0, 0);
+    p1 = min(p1, SHADOW_MAP_SIZE - 1);
+
+    // Finest level where the footprint spans at most two texels per axis
+    int level = 0;
+    [loop]
+    while (level < SHADOW_MINMAX_LEVELS && any((p1 >> (level + 1)) - (p0 >> (level + 1)) > 1)) ++level;
+    if (level == SHADOW_MINMAX_LEVELS) return VIS_MIXED;
+
+    int2 t0 = p0 >> (level + 1);
+    int2 t1 = p1 >> (level + 1);
+    float2 bounds = border ? float2(1.0f, 1.0f) : float2(1e30f, -1e30f);
+    [unroll]
+    for (int y = 0; y < 2; ++y) {
+        [unroll]
+        for (int x = 0; x < 2; ++x) {
+            float2 texel = shadowMinMax.Load(int4(min(t0 + int2(x, y), t1), i, level));
+            bounds = float2(min(bounds.x, texel.x), max(bounds.y, texel.y));
+        }
+    }
 
+    float refMin = min(ndcA.z, ndcB.z) - SHADOW_BIAS - 1e-5f;
+    float refMax = max(ndcA.z, ndcB.z) - SHADOW_BIAS + 1e-5f;
+    if (refMax <= bounds.x) return VIS_LIT;
+    if (!partlyOutside && refMin > bounds.y) return VIS_SHADOWED;
+    return VIS_MIXED;
+}
+
+// Ray marches light i between t_start and t_end
+float3 MarchLight(int i, float3 camPos, float3 rayDir, float t_start, float t_end, int stepCount, float noise) {
+    float3 LPos = lights[i].posRange.xyz;
+    float3 LDir = normalize(lights[i].dirAngle.xyz);
+    float range = lights[i].posRange.w;
+    float beam = lights[i].coneGobo.x;
+    float field = lights[i].coneGobo.y;
     float g = volParams.w;
-    float totalStepCount = volParams.x;
+    float marchDist = t_end - t_start;
     float3 accumulatedLight = float3(0, 0, 0);
 
-    // Better noise: Interleaved Gradient Noise instead of white noise
-    float noise = InterleavedGradientNoise(input.pos.xy);
+    // The march is split in SHADOW_INTERVALS strata groups, classified when the first sample
+    // reaches them; the sample positions stay the same either way
+    bool useIntervals = FeatureEnabled(FEATURE_SHADOW_INTERVALS);
+    int interval = -1;
+    int intervalVisibility = VIS_MIXED;
+
+    for (int s = 0; s < stepCount; ++s) {
+        // Quadratic distribution: more samples near the light (t_enter is closer to light apex)
+        // The noise places the sample inside its stratum, so frames with rotated noise average
+        // to the exact integral (see TemporalReprojection)
+        float t_normalized = ((float)s + noise) / (float)stepCount;
+        // Invert quadratic: denser near light source (t_enter), sparser far (t_exit)
+        // t_quad goes 0->1 but with more density at start
+        float t_quad = 1.0f - (1.0f - t_normalized) * (1.0f - t_normalized);
+
+        if (useIntervals) {
+            int k = min((int)(t_normalized * SHADOW_INTERVALS), SHADOW_INTERVALS - 1);
+            if (k != interval) {
+                interval = k;
+                float n0 = (float)k / SHADOW_INTERVALS;
+                float n1 = (float)(k + 1) / SHADOW_INTERVALS;
+                float q0 = 1.0f - (1.0f - n0) * (1.0f - n0);
+                float q1 = 1.0f - (1.0f - n1) * (1.0f - n1);
+                intervalVisibility = ClassifyInterval(i, camPos + rayDir * lerp(t_start, t_end, q0),
+                                                      camPos + rayDir * lerp(t_start, t_end, q1));
+            }
+            if (intervalVisibility == VIS_SHADOWED) continue;
+        }
+
+        float t = lerp(t_start, t_end, t_quad);
+        float3 currentPos = camPos + rayDir * t;
 
-    // Process each light with cone-aware marching
-    [unroll]
-    for (int i = 0; i < MAX_LIGHTS; ++i) {
-        if (lights[i].colorInt.w <= 0.0f) continue;
-
-        float3 LPos = lights[i].posRange.xyz;
-        float3 LDir = normalize(lights[i].dirAngle.xyz);
-        float range = lights[i].posRange.w;
-        float beam = lights[i].coneGobo.x;
-        float field = lights[i].coneGobo.y;
-
-        // Use field angle (outer cone) for intersection
-        // field is cos(angle), so the cone half-angle cosine
-        float2 cone_t = RayConeIntersect(camPos, rayDir, LPos, LDir, field, range);
-
-        // Skip if no valid intersection
-        if (cone_t.x < 0.0f) continue;
-
-        // Clamp to valid ray segment [0, rayLen] and light range
-        float t_enter = max(0.0f, cone_t.x);
-        float t_exit = min(rayLen, min(cone_t.y, range));
-
-        // Skip if no valid segment
-        if (t_enter >= t_exit) continue;
-
-        float marchDist = t_exit - t_enter;
-
-        // Use full step count per light - cone intersection already limits the march distance
-        int stepCount = (int)totalStepCount;
-
-        for (int s = 0; s < stepCount; ++s) {
-            // Quadratic distribution: more samples near the light (t_enter is closer to light apex)
-            float t_normalized = (float)s / (float)stepCount;
-            // Invert quadratic: denser near light source (t_enter), sparser far (t_exit)
-            // t_quad goes 0->1 but with more density at start
-            float t_quad = 1.0f - (1.0f - t_normalized) * (1.0f - t_normalized);
-
-            // Add jitter to reduce banding
-            float jittered_t = t_quad + (noise - 0.5f) / (float)stepCount;
-            jittered_t = saturate(jittered_t);
-
-            float t = lerp(t_enter, t_exit, jittered_t);
-            float3 currentPos = camPos + rayDir * t;
-
-            // Calculate step length for integration (varies due to quadratic distribution)
-            float next_t_normalized = (float)(s + 1) / (float)stepCount;
-            float next_t_quad = 1.0f - (1.0f - next_t_normalized) * (1.0f - next_t_normalized);
-            float stepLen = (next_t_quad - t_quad) * marchDist;
-
-            float3 toLight = LPos - currentPos;
-            float dist = length(toLight);
-
-            if (dist < range) {
-                float attenuation = lights[i].colorInt.w / (dist * dist + 1.0f);
-                float3 toLightNorm = toLight / max(dist, 0.0001f);
-
-                float cosAngle = dot(-toLightNorm, LDir);
-                float spotEffect = saturate((cosAngle - field) / (max(0.001f, beam - field)));
-
-                if (spotEffect > 0) {
-                    float shadow = 1.0f;
-
-                    // Shadow mapping
-                    float4 lightSpacePos = mul(float4(currentPos, 1.0f), lights[i].lightViewProj);
-                    float3 projCoords = float3(0, 0, 0);
-                    if (lightSpacePos.w > 0.0f) {
-                        projCoords = lightSpacePos.xyz / lightSpacePos.w;
-                        float2 shadowUV = projCoords.xy * 0.5f + 0.5f;
-                        shadowUV.y = 1.0f - shadowUV.y;
-
-                        if (shadowUV.x >= 0 && shadowUV.x <= 1 && shadowUV.y >= 0 && shadowUV.y <= 1) {
-                            shadow = shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV, i), projCoords.z - 0.01f).r;
-                        }
-                    }
-
-                    if (shadow > 0) {
-                        float cosTheta = dot(rayDir, -toLightNorm);
-                        float phase = HenyeyGreenstein(cosTheta, g);
-
-                        // Gobo sampling
-                        float3 goboColor = float3(1,1,1);
-                        {
-                            float gs, gc;
-                            sincos(lights[i].coneGobo.z, gs, gc);
-                            float2 rUV;
-                            rUV.x = projCoords.x * gc - projCoords.y * gs;
-                            rUV.y = projCoords.x * gs + projCoords.y * gc;
-                            rUV += lights[i].goboOff.xy;
-                            float2 goboUV = rUV * 0.5f + 0.5f;
-                            goboUV.y = 1.0f - goboUV.y;
-
-                            if (goboUV.x >= 0 && goboUV.x <= 1 && goboUV.y >= 0 && goboUV.y <= 1)
-                                goboColor = goboTexture.SampleLevel(samLinear, float3(goboUV, lights[i].coneGobo.w), 0).rgb;
-                            else
-                                goboColor = float3(0,0,0);
-                        }
-
-                        accumulatedLight += lights[i].colorInt.xyz * attenuation * spotEffect * shadow * goboColor * phase * volParams.y * stepLen;
-                    }
+        // Step length for integration: derivative of the quadratic mapping over one stratum
+        float stepLen = 2.0f * (1.0f - t_normalized) / (float)stepCount * marchDist;
+
+        float3 toLight = LPos - currentPos;
+        float dist = length(toLight);
+
+        if (dist < range) {
+            float attenuation = lights[i].colorInt.w / (dist * dist + 1.0f);
+            float3 toLightNorm = toLight / max(dist, 0.0001f);
+
+            float cosAngle = dot(-toLightNorm, LDir);
+            float spotEffect = saturate((cosAngle - field) / (max(0.001f, beam - field)));
+
+            if (spotEffect > 0) {
+                float3 visibility = LightVisibility(i, currentPos, rayDir * (0.5f * stepLen),
+                                                    intervalVisibility == VIS_LIT) *
+                                    HazeDensity(currentPos);
+                if (any(visibility > 0)) {
+                    float cosTheta = dot(rayDir, -toLightNorm);
+                    float phase = HenyeyGreenstein(cosTheta, g);
+
+                    accumulatedLight += lights[i].colorInt.xyz * attenuation * spotEffect * visibility * phase * volParams.y * stepLen;
                 }
             }
         }
     }
+    return accumulatedLight;
+}
+
+// Running phase integral T(a, psi), see AnalyticScattering::Lookup
+float InScatterLookup(float a, float psi) {
+    float w, h;
+    inScatterTable.GetDimensions(w, h);
+    float2 coord = float2(sqrt(saturate(a)), saturate(psi / 3.14159f + 0.5f));
+    float2 uv = (coord * (float2(w, h) - 1.0f) + 0.5f) / float2(w, h);
+    return inScatterTable.SampleLevel(samLinear, uv, 0);
+}
+
+// In-scattering of light i over a beam core (spot factor 1) without marching, see
+// AnalyticScattering::Integrate and SegmentProbes. Shadow, gobo and haze are probed at a few points;
+// if they disagree by more than ANALYTIC_MAX_VARIATION, valid is false and the core must be marched.
+float3 AnalyticBeamCore(int i, float3 camPos, float3 rayDir, float t0, float t1, out bool valid) {
+    float3 LPos = lights[i].posRange.xyz;
+    float range = lights[i].posRange.w;
+    float3 toLight = LPos - camPos;
+    float closest = dot(toLight, rayDir);
+    float3 offAxis = cross(toLight, rayDir);
+    float h2 = dot(offAxis, offAxis);
+
+    // The march skips samples beyond the light's range: keep the part of the core inside it
+    float halfChord = sqrt(max(range * range - h2, 0.0f));
+    t0 = max(t0, closest - halfChord);
+    t1 = min(t1, closest + halfChord);
+    valid = true;
+    if (t0 >= t1) return float3(0, 0, 0);
+
+    float hp = sqrt(h2 + 1.0f);
+    float psi0 = atan((t0 - closest) / hp);
+    float psi1 = atan((t1 - closest) / hp);
+
+    float3 visibilitySum = float3(0, 0, 0);
+    float weightSum = 0.0f;
+    float minVisibility = 1e9f;
+    float maxVisibility = 0.0f;
+    [unroll]
+    for (int k = 0; k < ANALYTIC_PROBES; ++k) {
+        float psi = lerp(psi0, psi1, ((float)k + 0.5f) / (float)ANALYTIC_PROBES);
+        float u = hp * tan(psi);
+        float weight = HenyeyGreenstein(u / max(sqrt(h2 + u * u), 0.0001f), volParams.w);
+        float3 probe = camPos + rayDir * (closest + u);
+        float3 visibility = LightVisibility(i, probe, float3(0, 0, 0), false) * HazeDensity(probe);
+        float level = max(visibility.r, max(visibility.g, visibility.b));
+        minVisibility = min(minVisibility, level);
+        maxVisibility = max(maxVisibility, level);
+        visibilitySum += visibility * weight;
+        weightSum += weight;
+    }
+    valid = (maxVisibility - minVisibility) <= ANALYTIC_MAX_VARIATION;
+
+    float a = sqrt(h2) / hp;
+    float integral = (InScatterLookup(a, psi1) - InScatterLookup(a, psi0)) / hp;
+    return lights[i].colorInt.xyz * lights[i].colorInt.w * integral * volParams.y * visibilitySum / max(weightSum, 1e-6f);
+}
+
+// In-scattering of light i along a camera ray ending at rayLen, with cone-aware marching
+float3 ScatterLight(int i, float3 camPos, float3 rayDir, float rayLen, float noise) {
+    float3 LPos = lights[i].posRange.xyz;
+    float3 LDir = normalize(lights[i].dirAngle.xyz);
+    float range = lights[i].posRange.w;
+    float beam = lights[i].coneGobo.x;
+    float field = lights[i].coneGobo.y;
+
+    // Use field angle (outer cone) for intersection
+    // field is cos(angle), so the cone half-angle cosine
+    float2 cone_t = RayConeIntersect(camPos, rayDir, LPos, LDir, field, range);
+
+    // Skip if no valid intersection
+    if (cone_t.x < 0.0f) return float3(0, 0, 0);
+
+    // Clamp to valid ray segment [0, rayLen] and light range
+    float t_enter = max(0.0f, cone_t.x);
+    float t_exit = min(rayLen, min(cone_t.y, range));
+
+    // Skip if no valid segment
+    if (t_enter >= t_exit) return float3(0, 0, 0);
+
+    float marchDist = t_exit - t_enter;
+
+    // Per-light step count from the budget (goboOff.w, see VolumetricBudget), else the global
+    // one; the cone intersection already limits the march distance
+    int stepCount = lights[i].goboOff.w > 0.0f ? (int)lights[i].goboOff.w : (int)volParams.x;
+
+    // Inside the beam angle the spot factor is 1: integrate that core analytically when
+    // enabled for this light (goboOff.z, set for the open gobo) and only march the falloff
+    if (volJitter.y > 0.5f && lights[i].goboOff.z > 0.5f) {
+        float2 core_t = RayConeIntersect(camPos, rayDir, LPos, LDir, beam, range);
+        float core_enter = max(t_enter, core_t.x);
+        float core_exit = min(t_exit, core_t.y);
+        if (core_t.x >= 0.0f && core_enter < core_exit) {
+            bool valid;
+            float3 core = AnalyticBeamCore(i, camPos, rayDir, core_enter, core_exit, valid);
+            if (valid) {
+                int frontSteps = (int)ceil(stepCount * (core_enter - t_enter) / marchDist);
+                int backSteps = (int)ceil(stepCount * (t_exit - core_exit) / marchDist);
+                return core + MarchLight(i, camPos, rayDir, t_enter, core_enter, frontSteps, noise) +
+                       MarchLight(i, camPos, rayDir, core_exit, t_exit, backSteps, noise);
+            }
+        }
+    }
+
+    return MarchLight(i, camPos, rayDir, t_enter, t_exit, stepCount, noise);
+}
+
+// Lights whose beam can reach a pixel's tile (see ConeBounds), all of them without the mask
+uint TileLights(uint2 pixelPos) {
+    return FeatureEnabled(FEATURE_TILE_MASK) ? tileMask.Load(int3(pixelPos / TILE_SIZE, 0)) : 0xFFu;
+}
+
+// Whether light i is worth shading on a ray: on, marked in the tile and not hidden in front of the
+// beam's nearest point (view depth <= distance)
+bool LightReaches(int i, uint tileLights, float rayLen) {
+    if (lights[i].colorInt.w <= 0.0f) return false;
+    if ((tileLights & (1u << i)) == 0) return false;
+    return !FeatureEnabled(FEATURE_TILE_MASK) || rayLen >= lights[i].dirAngle.w;
+}
+
+// Camera distance of the scene and ray direction through a pixel
+float SceneRay(int2 pixelPos, out float3 rayDir) {
+    float2 uv = (float2(pixelPos) + 0.5f) * volScreen.zw;
+    float depth = depthTexture.Load(int3(pixelPos, 0)).r;
+    float3 worldPos = ScreenToWorld(uv, min(depth, 1.0f));
+    float3 rayDirVec = worldPos - cameraPos.xyz;
+    float rayLen = length(rayDirVec);
+    rayDir = rayDirVec / max(rayLen, 0.0001f);
+    return rayLen;
+}
+
+bool IsEpipolarBreak(float a, float b) {
+    return abs(a - b) > EPIPOLAR_DEPTH_THRESHOLD * min(a, b);
+}
+
+float2 EpipolarSamplePosition(float4 lineEnds, int s) {
+    return lerp(lineEnds.xy, lineEnds.zw, (float)s / (EPIPOLAR_SAMPLES - 1));
+}
+
+// Camera distance of the scene at sample s of a line
+float EpipolarSampleDistance(float4 lineEnds, int s) {
+    float3 rayDir;
+    int2 pixelPos = clamp(int2(EpipolarSamplePosition(lineEnds, s)), int2(0, 0), int2(volScreen.xy) - 1);
+    return SceneRay(pixelPos, rayDir);
+}
+
+struct EpipolarOutput {
+    float4 scatter : SV_Target0; // In-scattering (rgb) at the marched samples, camera distance (a) at all
+    uint2 sources : SV_Target1;  // Left and right interpolation sources
+};
+
+// Epipolar sample pass: one texel per sample, one row per line, EPIPOLAR_LINES rows per light;
+// refines the line around the sample and marches it if it is a source, see EpipolarSampling
+EpipolarOutput PSEpipolarSamples(PS_INPUT input) {
+    int s = (int)input.pos.x;
+    int row = (int)input.pos.y;
+    int i = row / EPIPOLAR_LINES;
+
+    EpipolarOutput output;
+    output.scatter = float4(0, 0, 0, 0);
+    output.sources = uint2(s, s);
+    float4 lineEnds = epipolarLines.Load(int3(row % EPIPOLAR_LINES, i, 0));
+    if (epipolarLights[i].z < 0.5f || lineEnds.x < 0.0f) return output;
+
+    float3 rayDir;
+    int2 pixelPos = clamp(int2(EpipolarSamplePosition(lineEnds, s)), int2(0, 0), int2(volScreen.xy) - 1);
+    float rayLen = SceneRay(pixelPos, rayDir);
+    output.scatter.a = rayLen;
+
+    // Nearest sources on either side with no depth break in between; the samples around a break are sources
+    int segmentStart = s - s % EPIPOLAR_INITIAL_STEP;
+    int segmentEnd = min(segmentStart + EPIPOLAR_INITIAL_STEP, EPIPOLAR_SAMPLES - 1);
+    int left = s;
+    float current = rayLen;
+    [loop]
+    while (left > segmentStart) {
+        float previous = EpipolarSampleDistance(lineEnds, left - 1);
+        if (IsEpipolarBreak(previous, current)) break;
+        current = previous;
+        --left;
+    }
+    int right = s;
+    current = rayLen;
+    [loop]
+    while (right < segmentEnd) {
+        float next = EpipolarSampleDistance(lineEnds, right + 1);
+        if (IsEpipolarBreak(current, next)) break;
+        current = next;
+        ++right;
+    }
+    if (left == s || right == s) {
+        left = s;
+        right = s;
+    }
+    output.sources = uint2(left, right);
+
+    if (left == s && LightReaches(i, TileLights(pixelPos), rayLen)) {
+        float noise = frac(InterleavedGradientNoise(float2(pixelPos) + 0.5f) + volJitter.z);
+        output.scatter.rgb = ScatterLight(i, cameraPos.xyz, rayDir, rayLen, noise);
+    }
+    return output;
+}
+
+// Light i's in-scattering at a pixel from the four epipolar samples around it that match its
+// depth; false when too few do and the pixel must be marched, see EpipolarSampling::Reconstruct
+bool ResolveEpipolar(int i, float2 pixel, float pixelDistance, out float3 result) {
+    result = float3(0, 0, 0);
+    float2 screen = volScreen.xy;
+    float2 lightPos = epipolarLights[i].xy;
+    float2 dir = pixel - lightPos;
+    float lineF = 0.0f;
+    float sampleF = 0.0f;
+    if (dot(dir, dir) > 1e-12f) {
+        float2 safeDir = float2(abs(dir.x) < 1e-9f ? 1e-9f : dir.x, abs(dir.y) < 1e-9f ? 1e-9f : dir.y);
+        float2 t0 = -lightPos / safeDir;
+        float2 t1 = (screen - lightPos) / safeDir;
+        float2 tNear = min(t0, t1);
+        float2 tFar = max(t0, t1);
+        float tIn = max(max(tNear.x, tNear.y), 0.0f);
+        float tOut = min(tFar.x, tFar.y);
+
+        // Perimeter parameter of the exit point: one unit per side, clockwise from the top-left
+        float2 exitPos = lightPos + dir * tOut;
+        float p;
+        if (tFar.x < tFar.y)
+            p = dir.x > 0.0f ? 1.0f + saturate(exitPos.y / screen.y) : 3.0f + saturate(1.0f - exitPos.y / screen.y);
+        else
+            p = dir.y > 0.0f ? 2.0f + saturate(1.0f - exitPos.x / screen.x) : saturate(exitPos.x / screen.x);
+        if (p >= 4.0f) p -= 4.0f;
+
+        lineF = p * EPIPOLAR_LINES / 4.0f;
+        sampleF = saturate((1.0f - tIn) / max(tOut - tIn, 1e-6f)) * (EPIPOLAR_SAMPLES - 1);
+    }
+
+    float lineFloor = floor(lineF);
+    int line0 = (int)lineFloor % EPIPOLAR_LINES;
+    int sample0 = min((int)sampleF, EPIPOLAR_SAMPLES - 2);
+    float2 fraction = float2(lineF - lineFloor, sampleF - sample0);
+
+    float3 sum = float3(0, 0, 0);
+    float weightSum = 0.0f;
+    [unroll]
+    for (int j = 0; j < 2; ++j) {
+        int lineIndex = (line0 + j) % EPIPOLAR_LINES;
+        if (epipolarLines.Load(int3(lineIndex, i, 0)).x < 0.0f) continue;
+        int row = i * EPIPOLAR_LINES + lineIndex;
+        [unroll]
+        for (int k = 0; k < 2; ++k) {
+            float weight = (j == 0 ? 1.0f - fraction.x : fraction.x) * (k == 0 ? 1.0f - fraction.y : fraction.y);
+            int s = sample0 + k;
+            float4 scatter = epipolarScatter.Load(int3(s, row, 0));
+            if (weight <= 0.0f || IsEpipolarBreak(scatter.a, pixelDistance)) continue;
+
+            // Samples between sources interpolate them along the line
+            uint2 sources = epipolarSources.Load(int3(s, row, 0));
+            float3 value = scatter.rgb;
+            if (sources.x != sources.y) {
+                float3 a = epipolarScatter.Load(int3(sources.x, row, 0)).rgb;
+                float3 b = epipolarScatter.Load(int3(sources.y, row, 0)).rgb;
+                value = lerp(a, b, (float)(s - (int)sources.x) / (float)(sources.y - sources.x));
+            }
+            sum += value * weight;
+            weightSum += weight;
+        }
+    }
+    if (weightSum < EPIPOLAR_MIN_WEIGHT) return false;
+    result = sum / weightSum;
+    return true;
+}
+
+// Light i's in-scattering at a pixel: from its epipolar samples when they match, else marched
+float3 LightInScatter(int i, float2 pixel, float3 camPos, float3 rayDir, float rayLen, float noise, bool useEpipolar) {
+    float3 epipolar;
+    if (useEpipolar && epipolarLights[i].z > 0.5f && ResolveEpipolar(i, pixel, rayLen, epipolar)) return epipolar;
+    return ScatterLight(i, camPos, rayDir, rayLen, noise);
+}
+
+float4 PS(PS_INPUT input) : SV_Target {
+    uint2 pixelPos = uint2(input.pos.xy);
+
+    uint tileLights = TileLights(pixelPos);
+    if (tileLights == 0) return float4(0, 0, 0, 1.0f);
+
+    float3 rayDir;
+    float rayLen = SceneRay(int2(pixelPos), rayDir);
+    float3 camPos = cameraPos.xyz;
+    float3 accumulatedLight = float3(0, 0, 0);
+
+    // Better noise: Interleaved Gradient Noise instead of white noise, rotated every frame
+    // when the result is accumulated over time (see TemporalReprojection::NoiseOffset)
+    float noise = frac(InterleavedGradientNoise(input.pos.xy) + volJitter.z);
+    bool useEpipolar = FeatureEnabled(FEATURE_EPIPOLAR);
+
+    // Pick LIGHT_SAMPLES lights from the tile's alias table and weigh each by one over its
+    // probability (see LightSampling); the picks change every frame the noise rotates
+    if (FeatureEnabled(FEATURE_LIGHT_SAMPLING)) {
+        int2 tableBase = int2(pixelPos / TILE_SIZE) * int2(MAX_LIGHTS, 1);
+        float pick = frac(InterleavedGradientNoise(input.pos.xy + float2(47.0f, 17.0f)) + volJitter.z);
+        [unroll]
+        for (int k = 0; k < LIGHT_SAMPLES; ++k) {
+            float column = frac(pick + (float)k / LIGHT_SAMPLES) * MAX_LIGHTS;
+            int j = min((int)column, MAX_LIGHTS - 1);
+            float4 entry = lightTables.Load(int3(tableBase + int2(j, 0), 0));
+            int i = column - j < entry.x ? j : (int)entry.y;
+            float pdf = lightTables.Load(int3(tableBase + int2(i, 0), 0)).z;
+            if (pdf <= 0.0f || !LightReaches(i, tileLights, rayLen)) continue;
+            accumulatedLight += LightInScatter(i, input.pos.xy, camPos, rayDir, rayLen, noise, useEpipolar) /
+                                (pdf * LIGHT_SAMPLES);
+        }
+        return float4(accumulatedLight * volParams.z, 1.0f);
+    }
+
+    // Process each light with cone-aware marching
+    [unroll]
+    for (int i = 0; i < MAX_LIGHTS; ++i) {
+        if (!LightReaches(i, tileLights, rayLen)) continue;
+        accumulatedLight += LightInScatter(i, input.pos.xy, camPos, rayDir, rayLen, noise, useEpipolar);
+    }
 
     return float4(accumulatedLight * volParams.z, 1.0f);
-}
\ No newline at end of file
+}
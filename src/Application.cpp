@@ -1,6 +1,10 @@
 #include "Application.h"
-#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include "Core/DebugLog.h"
+#include "Core/TaskGraph.h"
+#include "Core/ThreadPool.h"
 
 Application::~Application()
 {
@@ -9,66 +13,50 @@ Application::~Application()
 
 void Application::Log(const std::string &message)
 {
-    std::ofstream logFile("debug.log", std::ios::app);
-    if (logFile.is_open())
-    {
-        logFile << message << '\n';
-    }
+    DebugLog::Write(message + '\n');
     OutputDebugStringA((message + "\n").c_str());
 }
 
 bool Application::Initialize(HWND hwnd)
 {
     // Clear previous log
-    {
-        std::ofstream logFile("debug.log", std::ios::trunc);
-    }
+    DebugLog::Clear();
 
     Log("Application::Initialize Started");
 
-    // Initialize graphics device (handles device, swap chain, depth buffer)
-    Log("Initializing GraphicsDevice...");
-    if (!m_graphics.Initialize(hwnd))
-    {
-        Log("GraphicsDevice initialization failed");
-        return false;
-    }
-    Log("GraphicsDevice initialized successfully");
-
-    // Initialize render pipeline
-    Log("Initializing RenderPipeline...");
-    if (!m_pipeline.Initialize(m_graphics.GetDevice()))
-    {
-        Log("RenderPipeline initialization failed");
-        return false;
-    }
-    Log("RenderPipeline initialized successfully");
-
-    // Initialize scene (loads meshes, textures, sets up camera and lights)
-    Log("Initializing Scene...");
-    if (!m_scene.Initialize(m_graphics.GetDevice()))
-    {
-        Log("Scene initialization failed");
-        return false;
-    }
-    Log("Scene initialized successfully");
+    // Startup as a task graph: the scene's files load while the device is created and the
+    // passes compile their shaders; only window-bound work stays on this thread
+    TaskGraph startup;
+    SceneAssets assets;
+    auto createDevice = [this, hwnd]() { return m_graphics.Initialize(hwnd); };
+    const TaskGraph::TaskId deviceTask =
+        startup.Add("graphics device", createDevice, {}, TaskGraph::Affinity::Caller);
+    m_pipeline.AddTasks(startup, m_graphics, deviceTask);
+    const TaskGraph::TaskId assetsTask =
+        assets.AddTasks(startup, "data/models/stage.obj", Config::Fixtures::DEFAULT_GDTF);
+
+    // Initialize scene (uploads meshes and textures, sets up camera and lights)
+    auto uploadScene = [this, &assets]() { return m_scene.Initialize(GetDevice(), assets); };
+    startup.Add("scene upload", uploadScene, {deviceTask, assetsTask});
 
     // Create room geometry
-    Log("Creating room geometry...");
-    if (!GeometryGenerator::CreateRoomCube(m_graphics.GetDevice(), m_roomVB, m_roomIB))
-    {
-        Log("Failed to create room cube");
-        return false;
-    }
-    Log("Room Cube Created");
+    auto createRoom = [this]() { return GeometryGenerator::CreateRoomCube(GetDevice(), m_roomVB, m_roomIB); };
+    startup.Add("room geometry", createRoom, {deviceTask});
 
     // Initialize UI
-    if (!m_ui.Initialize(hwnd, m_graphics.GetDevice(), m_graphics.GetContext()))
+    auto initializeUI = [this, hwnd]() { return m_ui.Initialize(hwnd, GetDevice(), GetContext()); };
+    startup.Add("UI", initializeUI, {deviceTask}, TaskGraph::Affinity::Caller);
+
+    const bool succeeded = startup.Run(ThreadPool::Shared());
+    std::ostringstream timeline;
+    startup.WriteTimeline(timeline);
+    Log("Startup timeline (" + std::to_string(ThreadPool::Shared().GetThreadCount()) + " workers):\n" +
+        timeline.str());
+    if (!succeeded)
     {
-        Log("ImGui initialization failed");
+        Log("Application::Initialize failed");
         return false;
     }
-    Log("ImGui Initialized Successfully");
 
     Log("Application::Initialize Completed Successfully");
     return true;
@@ -92,8 +80,10 @@ void Application::Shutdown()
 
 void Application::BeginFrame()
 {
-    // Update scene
+    // Swap in fixture types that finished loading, then update scene
+    m_scene.UpdateFixtureLoads(m_graphics.GetDevice());
     m_scene.Update(Config::PostProcess::FRAME_DELTA);
+    m_scene.UpdateGobos(m_graphics.GetContext());
     m_scene.UpdateCamera();
 
     // Start ImGui frame
@@ -105,11 +95,15 @@ void Application::BeginFrame()
     ctx.cameraPos = m_scene.GetCameraPosition();
     ctx.anchorPositions = m_scene.GetAnchorPositions();
     ctx.fixtureNodes = m_scene.GetFixtureNodes();
+    ctx.fixtureLights = m_scene.GetFixtureLights();
     ctx.spotlight = &m_scene.GetSpotlight();
     ctx.spotlights = &m_scene.GetSpotlights();
     ctx.ceilingLights = &m_scene.GetCeilingLights();
     ctx.stageMesh = m_scene.GetStageMesh();
-    ctx.goboTexture = m_scene.GetGoboTexture();
+    const auto &spotlights = m_scene.GetSpotlights();
+    for (size_t i = 0; i < static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS); ++i)
+        ctx.goboTextures[i] = i < spotlights.size() ? m_scene.GetGoboTexture(spotlights[i].GetGoboClass()) : nullptr;
+    ctx.haze = &m_scene.GetHaze();
     ctx.stageOffset = m_scene.GetStageOffset();
     ctx.time = m_scene.GetTime();
     ctx.roomVB = m_roomVB.Get();
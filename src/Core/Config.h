@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 /**
@@ -41,8 +42,11 @@ constexpr int REFRESH_RATE = 60;
  */
 namespace Shadow
 {
-constexpr int MAP_SIZE = 2048; ///< Resolution of the shadow map texture.
-}
+constexpr int MAP_SIZE = 2048;          ///< Resolution of the shadow map texture.
+constexpr float DEPTH_BIAS = 0.01f;     ///< Subtracted from the receiver depth before comparing (shader constant too).
+constexpr int MINMAX_LEVELS = 6;        ///< Min/max depth mips, the first at half the map size (see ShadowMinMax).
+constexpr bool FIXTURE_CASTERS = false; ///< Draw the other fixtures into each light's map (see ShadowCasters).
+} // namespace Shadow
 
 /**
  * @namespace Room
@@ -107,8 +111,81 @@ constexpr float DEFAULT_ANISOTROPY = 0.509f;
 constexpr float MIN_ANISOTROPY = -0.99f;
 constexpr float MAX_ANISOTROPY = 0.99f;
 constexpr float JITTER_SCALE = 0.005f;
+
+// Analytic in-scattering for unshadowed beam cores (see AnalyticScattering)
+constexpr int INSCATTER_TABLE_WIDTH = 64;       // Distance-to-light axis
+constexpr int INSCATTER_TABLE_HEIGHT = 128;     // Angle-along-ray axis
+constexpr int ANALYTIC_PROBES = 8;              // Shadow/gobo probes per beam core (shader constant too)
+constexpr float ANALYTIC_MAX_VARIATION = 0.05f; // Probe spread above which the core is ray marched
+
+// Froxel grid for the CPU injection pipeline (see FroxelVolume)
+constexpr int FROXEL_GRID_X = 160;      // Screen columns
+constexpr int FROXEL_GRID_Y = 90;       // Screen rows
+constexpr int FROXEL_GRID_Z = 64;       // Exponential depth slices
+constexpr float FROXEL_NEAR = 0.5f;     // Distance of the first slice boundary
+constexpr float FROXEL_FAR = 120.0f;    // Distance of the last slice boundary
+
+// Temporal accumulation (see TemporalReprojection)
+constexpr float TEMPORAL_BLEND = 0.1f;               // Weight of the current frame in the history
+constexpr float TEMPORAL_DISTANCE_TOLERANCE = 0.05f; // Relative surface distance change that rejects history
+constexpr float TEMPORAL_LIGHT_TOLERANCE = 0.01f;    // Relative light change that resets history
+constexpr float TEMPORAL_STEP_DIVISOR = 4.0f;        // Step count reduction while accumulating
+
+// Per-light step budgeting (see VolumetricBudget)
+constexpr float BUDGET_REFERENCE_LENGTH = 20.0f;   // March length that gets the full step count
+constexpr float BUDGET_MIN_IMPORTANCE = 0.25f;     // Step share of the dimmest light relative to the brightest
+constexpr float BUDGET_TARGET_MS = 4.0f;           // GPU time the march is fitted to
+constexpr float BUDGET_SMOOTHING = 0.2f;           // Fraction of the way to the new budget taken each frame
+constexpr double COST_MODEL_FORGETTING = 0.98;     // Weight kept by older timings at each measurement
+constexpr int COST_MODEL_MIN_OBSERVATIONS = 8;     // Timings before the budget follows the model
+constexpr int BUDGET_TIMER_FRAMES = 4;             // GPU timestamp queries in flight
+
+// Screen bounds of the beams and the tile mask built from them (see ConeBounds)
+constexpr int CONE_BOUNDS_SEGMENTS = 16; // Sides of the pyramid around each cone
+constexpr int TILE_SIZE = 16;            // Pixels per tile side (shader constant too)
+
+// Lit/shadowed classification of march intervals from the min/max shadow mips (see ShadowMinMax)
+constexpr int SHADOW_INTERVALS = 8; // Intervals per marched segment (shader constant too)
+
+// Epipolar sample placement (see EpipolarSampling)
+constexpr int EPIPOLAR_LINES = 512;              // Lines per light, a multiple of 4 (shader constant too)
+constexpr int EPIPOLAR_SAMPLES = 512;            // Samples per line (shader constant too)
+constexpr int EPIPOLAR_INITIAL_STEP = 16;        // Samples between marched ones on smooth depth (shader constant too)
+constexpr float EPIPOLAR_DEPTH_THRESHOLD = 0.1f; // Relative camera distance change that breaks (shader constant too)
+
+// Stochastic light selection from per-tile alias tables (see LightSampling)
+constexpr int LIGHT_SAMPLES = 1;                    // Lights picked per pixel (shader constant too)
+constexpr float LIGHT_SAMPLING_MIN_DISTANCE = 1.0f; // Ray-to-light distance below which a light's weight stops growing
+constexpr float LIGHT_SAMPLING_UNIFORM_MIX = 0.1f;  // Share of the probability spread evenly over a tile's lights
+
+// Gobo lookups box-filtered over the march step (see SummedAreaTable)
+constexpr float GOBO_SAT_MIN_FOOTPRINT = 1.0f; // Half-footprint (texels) that switches to the SAT (shader constant too)
 } // namespace Volumetric
 
+/**
+ * @namespace Haze
+ * @brief Haze density simulated over the room (see HazeSimulation).
+ */
+namespace Haze
+{
+constexpr int GRID_SIZE = 64;            // Cells per side of the grid over the room
+constexpr float TICK_RATE = 30.0f;       // Solver ticks per second
+constexpr int MAX_TICKS_PER_UPDATE = 2;  // Ticks per frame before time is dropped
+constexpr int PRESSURE_ITERATIONS = 20;  // Jacobi iterations of the pressure solve
+constexpr int DIFFUSION_ITERATIONS = 4;  // Jacobi iterations of the viscosity and haze diffusion
+constexpr float VISCOSITY = 0.0f;        // Air viscosity in m^2/s; advection already smooths the flow
+constexpr float DIFFUSION = 0.05f;       // Haze diffusion in m^2/s
+constexpr float DISSIPATION = 0.02f;     // Fraction of the haze lost per second
+constexpr float INITIAL_DENSITY = 0.25f; // Density after a reset, relative to the volumetric density
+
+// Default rig: a hazer at the back of the stage and a fan behind it
+constexpr float HAZER_RATE = 4000.0f; // Haze put out per second, density units times m^3
+constexpr float HAZER_SPEED = 6.0f;   // Output speed in m/s
+constexpr float HAZER_RADIUS = 2.0f;  // Radius the output is spread over
+constexpr float FAN_THRUST = 4.0f;    // Acceleration at the fan center in m/s^2
+constexpr float FAN_RADIUS = 6.0f;    // Radius the thrust acts in
+} // namespace Haze
+
 /**
  * @namespace CeilingLights
  * @brief Configuration for the grid of ceiling point lights.
@@ -208,8 +285,75 @@ namespace Vertex
 constexpr unsigned int STRIDE_FULL = 32;
 // Position only (3) = 12 bytes
 constexpr unsigned int STRIDE_POSITION_ONLY = 12;
+// Quantized: UNORM16 position (4) + octahedral SNORM16 normal (2) + half UV (2) = 16 bytes
+constexpr unsigned int STRIDE_QUANTIZED = 16;
+// Quantized position only: UNORM16 (4) = 8 bytes
+constexpr unsigned int STRIDE_QUANTIZED_POSITION = 8;
+// Fixture models are drawn from the 16-byte quantized vertex (see MeshAsset::QuantizeVertices)
+constexpr bool QUANTIZE_FIXTURES = true;
 } // namespace Vertex
 
+/**
+ * @namespace Lod
+ * @brief Mesh level-of-detail generation and selection.
+ */
+namespace Lod
+{
+constexpr int MAX_LEVELS = 4; // Full detail + 3 simplified levels
+// Simplified levels, finest first: share of the full-detail triangles to aim for and largest
+// allowed error relative to the mesh bounding radius
+constexpr float TRIANGLE_RATIOS[MAX_LEVELS - 1] = {0.5f, 0.25f, 0.125f};
+constexpr float MAX_ERRORS[MAX_LEVELS - 1] = {0.01f, 0.025f, 0.06f};
+// Projected diameter, as a fraction of the viewport height, below which LOD 1, 2 and 3 are used
+constexpr float SCENE_SCREEN_SIZES[MAX_LEVELS - 1] = {0.12f, 0.06f, 0.03f};
+// Shadow maps only need the silhouette, so they switch to coarser levels twice as early
+constexpr float SHADOW_SCREEN_SIZES[MAX_LEVELS - 1] = {0.24f, 0.12f, 0.06f};
+} // namespace Lod
+
+/**
+ * @namespace Occlusion
+ * @brief Software occlusion culling against a low-resolution CPU depth buffer.
+ */
+namespace Occlusion
+{
+constexpr int BUFFER_WIDTH = 320;  // Multiple of the tile size
+constexpr int BUFFER_HEIGHT = 180;
+constexpr int TILE_SIZE = 8;         // Pixels per side of a fine hierarchical depth tile
+constexpr int COARSE_TILE_SIZE = 32; // Pixels per side of a coarse tile (multiple of TILE_SIZE)
+// Occluders are a mesh's largest triangles, at most this many, each covering at least
+// MIN_TRIANGLE_AREA times the squared bounding box diagonal
+constexpr size_t MAX_OCCLUDER_TRIANGLES = 2048;
+constexpr float MIN_TRIANGLE_AREA = 1e-4f;
+} // namespace Occlusion
+
+/**
+ * @namespace Gobo
+ * @brief Baking of the gobo texture arrays (mip chains and block compression), the shared
+ * gobo library and slot streaming.
+ */
+namespace Gobo
+{
+constexpr int MONO_TOLERANCE = 8; // Largest channel spread (of 255) of a texel that still counts as grey
+constexpr bool COMPRESS = true;   // Block-compress the arrays; RGBA8 mip chains otherwise
+constexpr bool COLOR_BC7 = true;  // Color arrays as BC7 (1 byte per texel), else BC1 (half a byte)
+
+// GoboLibrary size classes are powers of two, at least this many texels on a side
+constexpr int MIN_SIZE_CLASS = 64;
+// Baked size classes are cached as <prefix>_<size>.texcache
+constexpr char LIBRARY_CACHE_PREFIX[] = "data/fixtures/gobo_library";
+
+// Streaming: wheel slots (gobos, animation wheels, prisms) are decoded when a light selects them,
+// into a fixed pool of texture array layers; off loads every gobo into the library at startup.
+// The pool is one color array of STREAM_LAYER_SIZE layers without summed-area tables, so streamed
+// gobos lose resolution, SAT filtering and the BC4 mono arrays in exchange for a bounded footprint
+constexpr bool STREAMING = false;
+constexpr int STREAM_LAYER_SIZE = 256;      // Side of a pool layer; larger images are halved until they fit
+constexpr int STREAM_POOL_LAYERS = 16;      // Layers in the pool, the placeholder (Open) included
+constexpr int STREAM_MAX_DECODES = 2;       // Slots decoded at once on the shared ThreadPool
+constexpr int STREAM_UPLOADS_PER_FRAME = 2; // Decoded slots copied into the pool per frame
+constexpr int STREAM_LOOKAHEAD = 1;         // Wheel slots on each side of a selected one to prefetch
+} // namespace Gobo
+
 /**
  * @namespace Shaders
  * @brief Paths to shader files.
@@ -222,15 +366,24 @@ constexpr wchar_t VOLUMETRIC[] = L"shaders/volumetric.hlsl";
 constexpr wchar_t BLUR[] = L"shaders/blur.hlsl";
 constexpr wchar_t COMPOSITE[] = L"shaders/composite.hlsl";
 constexpr wchar_t FXAA[] = L"shaders/fxaa.hlsl";
+constexpr wchar_t TEMPORAL[] = L"shaders/temporal.hlsl";
+constexpr wchar_t SHADOW_MINMAX[] = L"shaders/shadow_minmax.hlsl";
 } // namespace Shaders
 
 /**
  * @namespace Fixtures
- * @brief Paths to fixture data files.
+ * @brief Paths to fixture data files, and background loading of fixtures patched at runtime.
  */
 namespace Fixtures
 {
 constexpr char DEFAULT_GDTF[] = "data/fixtures/Martin_Professional@MAC_Viper_Performance@20230516NoMeas.gdtf";
+constexpr char DIRECTORY[] = "data/fixtures"; // .gdtf files offered for patching
+
+// Patched fixtures show a box until their type has loaded in the background
+constexpr int MAX_BACKGROUND_LOADS = 2;   // Fixture types loaded at once on the shared ThreadPool
+constexpr int SWAPS_PER_FRAME = 1;        // Loaded types uploaded and swapped in per frame
+constexpr float PROXY_HALF_WIDTH = 0.35f; // Half width of the box, in meters
+constexpr float PROXY_HEIGHT = 1.0f;      // Height of the box, hanging below the anchor, in meters
 } // namespace Fixtures
 
 } // namespace Config
@@ -0,0 +1,39 @@
+/**
+ * @file DebugLog.cpp
+ * @brief Implementation of the shared debug log.
+ */
+
+#include "DebugLog.h"
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+
+constexpr char LOG_FILE[] = "debug.log";
+
+std::mutex &LogMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+} // namespace
+
+namespace DebugLog
+{
+
+void Clear()
+{
+    std::lock_guard<std::mutex> lock(LogMutex());
+    std::ofstream file(LOG_FILE, std::ios::trunc);
+}
+
+void Write(const std::string &text)
+{
+    std::lock_guard<std::mutex> lock(LogMutex());
+    std::ofstream file(LOG_FILE, std::ios::app);
+    file << text;
+}
+
+} // namespace DebugLog
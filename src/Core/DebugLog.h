@@ -0,0 +1,32 @@
+/**
+ * @file DebugLog.h
+ * @brief The debug.log file, shared by every thread that reports to it.
+ */
+
+#pragma once
+
+#include <string>
+
+/**
+ * @namespace DebugLog
+ * @brief Appends to debug.log under one lock.
+ *
+ * Mesh and fixture loads report from ThreadPool workers while the render thread logs too; each
+ * Write() lands as a whole block instead of interleaving with the others.
+ */
+namespace DebugLog
+{
+
+/**
+ * @brief Empties the log, at the start of a run.
+ */
+void Clear();
+
+/**
+ * @brief Appends text as one block.
+ *
+ * @param text Text to append, with its own line breaks.
+ */
+void Write(const std::string &text);
+
+} // namespace DebugLog
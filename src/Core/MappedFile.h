@@ -0,0 +1,83 @@
+/**
+ * @file MappedFile.h
+ * @brief Read-only memory mapping of files for zero-copy parsing and cache loading.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Maps a whole file read-only into the address space.
+ *
+ * The mapping stays valid until Close() is called or the object is destroyed.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Default constructor. No file is mapped.
+     */
+    MappedFile() = default;
+
+    /**
+     * @brief Destructor. Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Maps a file read-only.
+     *
+     * @param fileName Path to the file.
+     * @return true if the file was opened and mapped (an empty file maps to a null view of size 0).
+     */
+    bool Open(const std::string &fileName);
+
+    /**
+     * @brief Unmaps the file and closes its handles.
+     */
+    void Close();
+
+    /**
+     * @brief Gets the start of the mapped view.
+     * @return Pointer to the first byte, or nullptr if nothing is mapped.
+     */
+    [[nodiscard]] const uint8_t *GetData() const
+    {
+        return m_data;
+    }
+
+    /**
+     * @brief Gets the size of the mapped view.
+     * @return Size in bytes.
+     */
+    [[nodiscard]] size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Checks whether a file is currently open.
+     * @return true if Open() succeeded and Close() has not been called.
+     */
+    [[nodiscard]] bool IsOpen() const
+    {
+        return m_open;
+    }
+
+private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+
+#ifdef _WIN32
+    void *m_fileHandle = nullptr;
+    void *m_mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,272 @@
+/**
+ * @file TaskGraph.cpp
+ * @brief Implementation of the task graph.
+ */
+
+#include "TaskGraph.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace
+{
+
+constexpr int TIMELINE_BAR_WIDTH = 40;
+
+/// The task whose work is running on this thread, so Spawn() knows its parent.
+struct CurrentTask
+{
+    const TaskGraph *graph = nullptr;
+    TaskGraph::TaskId id = 0;
+};
+thread_local CurrentTask t_current;
+
+const char *StateName(TaskGraph::State state)
+{
+    switch (state)
+    {
+    case TaskGraph::State::Succeeded:
+        return "";
+    case TaskGraph::State::Failed:
+        return "  FAILED";
+    case TaskGraph::State::Skipped:
+        return "  skipped";
+    default:
+        return "  pending";
+    }
+}
+
+} // namespace
+
+TaskGraph::TaskId TaskGraph::Add(std::string name, std::function<bool()> work, std::vector<TaskId> dependencies,
+                                 Affinity affinity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const TaskId id = m_tasks.size();
+    m_tasks.emplace_back();
+    Task &task = m_tasks.back();
+    task.timing.name = std::move(name);
+    task.work = std::move(work);
+    task.affinity = affinity;
+
+    // Duplicates and forward references would never be released
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+    for (TaskId dependency : dependencies)
+    {
+        if (dependency >= id)
+            continue;
+        m_tasks[dependency].dependents.push_back(id);
+        ++task.waitingFor;
+    }
+    return id;
+}
+
+TaskGraph::TaskId TaskGraph::Spawn(std::string name, std::function<bool()> work)
+{
+    std::vector<TaskId> ready;
+    TaskId id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = m_tasks.size();
+        m_tasks.emplace_back();
+        Task &task = m_tasks.back();
+        task.timing.name = std::move(name);
+        task.work = std::move(work);
+        task.running = 1;
+        if (t_current.graph == this)
+        {
+            Task &parent = m_tasks[t_current.id];
+            task.parent = t_current.id;
+            task.timing.depth = parent.timing.depth + 1;
+            ++parent.running;
+        }
+
+        // Before Run(), a spawned task is an ordinary task without dependencies
+        if (!m_pool)
+            return id;
+        Release(id, ready);
+    }
+    Dispatch(ready);
+    return id;
+}
+
+bool TaskGraph::Run(ThreadPool &pool)
+{
+    std::vector<TaskId> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pool = &pool;
+        m_start = std::chrono::steady_clock::now();
+        m_completed = 0;
+        for (TaskId id = 0; id < m_tasks.size(); ++id)
+        {
+            m_tasks[id].running = 1;
+            if (m_tasks[id].waitingFor == 0)
+                Release(id, ready);
+        }
+    }
+    Dispatch(ready);
+
+    // Run the caller's tasks as they become ready, until everything has completed
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_changed.wait(lock, [this]() { return !m_callerQueue.empty() || m_completed == m_tasks.size(); });
+        if (m_callerQueue.empty())
+            break;
+        const TaskId id = m_callerQueue.front();
+        m_callerQueue.pop_front();
+        lock.unlock();
+        Execute(id);
+        lock.lock();
+    }
+
+    m_totalMs = NowMs();
+    m_pool = nullptr;
+    return std::all_of(m_tasks.begin(), m_tasks.end(),
+                       [](const Task &task) { return task.timing.state == State::Succeeded; });
+}
+
+TaskGraph::State TaskGraph::GetState(TaskId id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return id < m_tasks.size() ? m_tasks[id].timing.state : State::Pending;
+}
+
+std::vector<TaskGraph::Timing> TaskGraph::GetTimeline() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Timing> timeline;
+    timeline.reserve(m_tasks.size());
+    for (const Task &task : m_tasks)
+        timeline.push_back(task.timing);
+    return timeline;
+}
+
+void TaskGraph::WriteTimeline(std::ostream &out) const
+{
+    const std::vector<Timing> timeline = GetTimeline();
+    size_t nameWidth = 0;
+    for (const Timing &timing : timeline)
+        nameWidth = (std::max)(nameWidth, timing.name.size() + (static_cast<size_t>(timing.depth) * 2));
+
+    const double scale = m_totalMs > 0.0 ? TIMELINE_BAR_WIDTH / m_totalMs : 0.0;
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    for (const Timing &timing : timeline)
+    {
+        // |   ####     | over the length of Run(), so overlapping tasks line up
+        const int first = (std::min)(static_cast<int>(timing.startMs * scale), TIMELINE_BAR_WIDTH - 1);
+        const int last = (std::max)(first + 1, (std::min)(static_cast<int>((timing.endMs * scale) + 0.5),
+                                                          TIMELINE_BAR_WIDTH));
+        std::string bar(TIMELINE_BAR_WIDTH, ' ');
+        if (timing.state != State::Skipped)
+            bar.replace(static_cast<size_t>(first), static_cast<size_t>(last - first),
+                        static_cast<size_t>(last - first), '#');
+
+        const std::string name = std::string(static_cast<size_t>(timing.depth) * 2, ' ') + timing.name;
+        out << "  |" << bar << "| " << std::left << std::setw(static_cast<int>(nameWidth)) << name << std::right
+            << std::setw(9) << timing.startMs << " ->" << std::setw(9) << timing.endMs << " ms ("
+            << std::setw(8) << timing.endMs - timing.startMs << " ms, " << (timing.onCaller ? "caller" : "worker")
+            << ")" << StateName(timing.state) << '\n';
+    }
+    out << "  Total " << m_totalMs << " ms\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void TaskGraph::Release(TaskId id, std::vector<TaskId> &ready)
+{
+    Task &task = m_tasks[id];
+    if (task.dependencyFailed)
+    {
+        task.timing.startMs = task.timing.endMs = NowMs();
+        task.timing.state = State::Skipped;
+        task.failed = true;
+        task.work = nullptr;
+        Complete(id, ready);
+    }
+    else if (task.affinity == Affinity::Caller)
+    {
+        m_callerQueue.push_back(id);
+        m_changed.notify_all();
+    }
+    else
+    {
+        ready.push_back(id);
+    }
+}
+
+void TaskGraph::Dispatch(const std::vector<TaskId> &ready)
+{
+    for (TaskId id : ready)
+        m_pool->Submit([this, id]() { Execute(id); });
+}
+
+void TaskGraph::Execute(TaskId id)
+{
+    Task *task = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        task = &m_tasks[id];
+        task->timing.startMs = NowMs();
+        task->timing.onCaller = task->affinity == Affinity::Caller;
+    }
+
+    const CurrentTask previous = t_current;
+    t_current = {this, id};
+    bool succeeded = false;
+    try
+    {
+        succeeded = task->work();
+    }
+    catch (...)
+    {
+        succeeded = false;
+    }
+    t_current = previous;
+
+    std::vector<TaskId> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        task->timing.endMs = NowMs();
+        task->work = nullptr; // Release what the work captured as soon as it is done
+        Finish(id, !succeeded, ready);
+    }
+    // Once the last task completes, Run() may return and the graph go away: touch nothing then
+    if (!ready.empty())
+        Dispatch(ready);
+}
+
+void TaskGraph::Finish(TaskId id, bool failed, std::vector<TaskId> &ready)
+{
+    Task &task = m_tasks[id];
+    task.failed = task.failed || failed;
+    if (--task.running > 0)
+        return;
+    task.timing.state = task.failed ? State::Failed : State::Succeeded;
+    Complete(id, ready);
+}
+
+void TaskGraph::Complete(TaskId id, std::vector<TaskId> &ready)
+{
+    ++m_completed;
+    const Task &task = m_tasks[id];
+    for (TaskId dependentId : task.dependents)
+    {
+        Task &dependent = m_tasks[dependentId];
+        dependent.dependencyFailed = dependent.dependencyFailed || task.failed;
+        if (--dependent.waitingFor == 0)
+            Release(dependentId, ready);
+    }
+    if (task.parent != NO_TASK)
+        Finish(task.parent, task.failed, ready);
+    if (m_completed == m_tasks.size())
+        m_changed.notify_all();
+}
+
+double TaskGraph::NowMs() const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+}
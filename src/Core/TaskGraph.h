@@ -0,0 +1,189 @@
+/**
+ * @file TaskGraph.h
+ * @brief Dependency graph of named tasks run on a ThreadPool, with a per-task timeline.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+
+/**
+ * @class TaskGraph
+ * @brief Runs tasks as soon as the tasks they depend on have succeeded, overlapping
+ * everything that is independent.
+ *
+ * Tasks run on the pool unless they are bound to the thread that calls Run() (window, UI and
+ * immediate-context work). A running task can spawn child tasks, for work it only discovers
+ * while running (one import per model of a fixture); it completes, and releases its
+ * dependents, once its children have. A task that fails, or whose child fails, skips every
+ * task that depends on it.
+ *
+ * Every task's start and end are recorded relative to the start of Run(), so the startup can
+ * be read as a timeline (WriteTimeline()).
+ */
+class TaskGraph
+{
+public:
+    using TaskId = size_t;
+
+    /**
+     * @brief Where a task may run.
+     */
+    enum class Affinity
+    {
+        Any,   ///< A pool worker.
+        Caller ///< The thread that called Run().
+    };
+
+    /**
+     * @brief Outcome of a task.
+     */
+    enum class State
+    {
+        Pending,
+        Succeeded,
+        Failed, ///< Returned false or threw, or a child did.
+        Skipped ///< A dependency did not succeed.
+    };
+
+    /**
+     * @struct Timing
+     * @brief One row of the timeline.
+     */
+    struct Timing
+    {
+        std::string name;
+        double startMs = 0.0; ///< When the work started, from the start of Run().
+        double endMs = 0.0;   ///< When the work returned (children may end later).
+        State state = State::Pending;
+        bool onCaller = false; ///< Ran on the thread that called Run().
+        int depth = 0;         ///< 0 for added tasks, parent's depth + 1 for spawned ones.
+    };
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    /**
+     * @brief Adds a task. Only valid before Run().
+     *
+     * @param name Name shown in the timeline.
+     * @param work Callable returning false on failure.
+     * @param dependencies Tasks that must succeed first.
+     * @param affinity Where the task may run.
+     * @return Task identifier.
+     */
+    TaskId Add(std::string name, std::function<bool()> work, std::vector<TaskId> dependencies = {},
+               Affinity affinity = Affinity::Any);
+
+    /**
+     * @brief Adds a child task to the task running on this thread; it starts right away.
+     *
+     * Only valid from inside a task's work (not from its ParallelFor iterations on other
+     * threads). The parent completes once all of its children have.
+     *
+     * @param name Name shown in the timeline.
+     * @param work Callable returning false on failure.
+     * @return Task identifier.
+     */
+    TaskId Spawn(std::string name, std::function<bool()> work);
+
+    /**
+     * @brief Runs every task and blocks until all have finished or been skipped.
+     *
+     * The calling thread runs the Affinity::Caller tasks while it waits.
+     *
+     * @param pool Pool the other tasks are queued on.
+     * @return True if every task succeeded.
+     */
+    bool Run(ThreadPool &pool);
+
+    /**
+     * @brief Gets the outcome of a task.
+     */
+    [[nodiscard]] State GetState(TaskId id) const;
+
+    /**
+     * @brief Gets one timeline row per task, in the order tasks were added or spawned.
+     */
+    [[nodiscard]] std::vector<Timing> GetTimeline() const;
+
+    /**
+     * @brief Gets the time Run() took, in milliseconds.
+     */
+    [[nodiscard]] double GetTotalMs() const
+    {
+        return m_totalMs;
+    }
+
+    /**
+     * @brief Writes the timeline, one line per task with a bar over the length of Run().
+     *
+     * @param out Destination stream.
+     */
+    void WriteTimeline(std::ostream &out) const;
+
+private:
+    struct Task
+    {
+        Timing timing;
+        std::function<bool()> work;
+        Affinity affinity = Affinity::Any;
+        std::vector<TaskId> dependents;
+        size_t waitingFor = 0; ///< Dependencies not completed yet.
+        bool dependencyFailed = false;
+        TaskId parent = NO_TASK;
+        size_t running = 0; ///< Its own work plus its children, until it completes.
+        bool failed = false;
+    };
+
+    static constexpr TaskId NO_TASK = ~static_cast<TaskId>(0);
+
+    /**
+     * @brief Hands over a task whose dependencies have completed: to the caller's queue, or to
+     * ready for the pool. Skips it if one of them did not succeed. Called with the lock held.
+     */
+    void Release(TaskId id, std::vector<TaskId> &ready);
+
+    /**
+     * @brief Queues ready tasks on the pool. Called without the lock.
+     */
+    void Dispatch(const std::vector<TaskId> &ready);
+
+    /**
+     * @brief Runs a task's work on the current thread and records its timing.
+     */
+    void Execute(TaskId id);
+
+    /**
+     * @brief Drops one of a task's running counts; at zero the task completes. Called with the
+     * lock held.
+     */
+    void Finish(TaskId id, bool failed, std::vector<TaskId> &ready);
+
+    /**
+     * @brief Releases a completed task's dependents and finishes its part of its parent. Called
+     * with the lock held.
+     */
+    void Complete(TaskId id, std::vector<TaskId> &ready);
+
+    [[nodiscard]] double NowMs() const;
+
+    std::deque<Task> m_tasks; // Stable addresses while tasks are spawned
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<TaskId> m_callerQueue;
+    size_t m_completed = 0;
+    ThreadPool *m_pool = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+    double m_totalMs = 0.0;
+};
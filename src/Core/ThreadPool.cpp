@@ -0,0 +1,128 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        unsigned hardware = std::thread::hardware_concurrency();
+        threadCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    m_workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool &ThreadPool::Shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty())
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &body)
+{
+    if (count == 0)
+        return;
+    if (count == 1)
+    {
+        body(0);
+        return;
+    }
+
+    // Shared state outlives this call in case a helper task only starts after all work is done
+    struct State
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+        const std::function<void(size_t)> *body = nullptr;
+        size_t count = 0;
+    };
+    auto state = std::make_shared<State>();
+    state->body = &body;
+    state->count = count;
+
+    auto drain = [](const std::shared_ptr<State> &s)
+    {
+        for (;;)
+        {
+            size_t i = s->next.fetch_add(1);
+            if (i >= s->count)
+                return;
+            try
+            {
+                (*s->body)(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                if (!s->error)
+                    s->error = std::current_exception();
+            }
+            if (s->done.fetch_add(1) + 1 == s->count)
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                s->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = (std::min)(count - 1, m_workers.size());
+    for (size_t h = 0; h < helpers; ++h)
+    {
+        Enqueue([state, drain]() { drain(state); });
+    }
+
+    drain(state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->done.load() == state->count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ThreadPool.h
+ * @brief Fixed-size worker pool used for CPU-side loading and processing work.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A simple FIFO task queue served by a fixed number of worker threads.
+ *
+ * ParallelFor() lets the calling thread take part in the work, so it can be called from
+ * inside a pool task without deadlocking even when every worker is busy.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Number of workers; 0 uses one less than the hardware thread count (at least 1).
+     */
+    explicit ThreadPool(unsigned threadCount = 0);
+
+    /**
+     * @brief Finishes queued tasks and joins all workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Gets the process-wide pool shared by loaders and processing stages.
+     * @return Reference to the shared pool.
+     */
+    static ThreadPool &Shared();
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return Worker count.
+     */
+    [[nodiscard]] unsigned GetThreadCount() const
+    {
+        return static_cast<unsigned>(m_workers.size());
+    }
+
+    /**
+     * @brief Queues a task for execution on a worker.
+     *
+     * @param task Callable taking no arguments.
+     * @return Future holding the task's result (or exception).
+     */
+    template <typename F> auto Submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        Enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * @brief Runs body(i) for every i in [0, count) across the workers and the calling thread.
+     *
+     * Blocks until all iterations have completed. Iterations are handed out one at a time,
+     * so callers should pass coarse work items (chunks, tiles, slices).
+     *
+     * @param count Number of iterations.
+     * @param body Callable invoked with each iteration index.
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t)> &body);
+
+private:
+    /**
+     * @brief Pushes a type-erased task onto the queue and wakes one worker.
+     */
+    void Enqueue(std::function<void()> task);
+
+    /**
+     * @brief Worker thread main loop.
+     */
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
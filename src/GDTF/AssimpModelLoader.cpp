@@ -0,0 +1,93 @@
+/**
+ * @file AssimpModelLoader.cpp
+ * @brief Conversion of Assimp scenes into MeshData.
+ */
+
+#include "AssimpModelLoader.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+namespace GDTF
+{
+
+bool AssimpModelLoader::Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData,
+                             std::string &outError)
+{
+    Assimp::Importer importer;
+
+    // No tangents: no shader reads them
+    unsigned int flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType |
+                         aiProcess_GenSmoothNormals | aiProcess_ConvertToLeftHanded;
+
+    const aiScene *scene = importer.ReadFileFromMemory(data, size, flags, hint.c_str());
+    if (!scene || !scene->HasMeshes())
+    {
+        outError = importer.GetErrorString();
+        return false;
+    }
+
+    // Size the arrays up front, then fill them in place
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+    {
+        const aiMesh *mesh = scene->mMeshes[m];
+        vertexCount += mesh->mNumVertices;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f)
+        {
+            if (mesh->mFaces[f].mNumIndices == 3)
+                indexCount += 3;
+        }
+    }
+
+    outData = MeshData();
+    outData.vertices.resize(vertexCount);
+    outData.indices.resize(indexCount);
+    outData.shapes.reserve(scene->mNumMeshes);
+
+    Vertex *vertex = outData.vertices.data();
+    uint32_t *index = outData.indices.data();
+    uint32_t vertexOffset = 0;
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+    {
+        const aiMesh *mesh = scene->mMeshes[m];
+
+        ShapeInfo shape;
+        shape.name = mesh->mName.C_Str();
+        shape.startIndex = static_cast<uint32_t>(index - outData.indices.data());
+
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i, ++vertex)
+        {
+            vertex->position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
+
+            if (mesh->HasNormals())
+                vertex->normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+            else
+                vertex->normal = {0, 1, 0};
+
+            if (mesh->HasTextureCoords(0))
+                vertex->uv = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
+            else
+                vertex->uv = {0, 0};
+        }
+
+        // SortByPType leaves points and lines in their own meshes; only triangles are kept
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f)
+        {
+            const aiFace &face = mesh->mFaces[f];
+            if (face.mNumIndices != 3)
+                continue;
+            for (unsigned int j = 0; j < 3; ++j)
+                *index++ = face.mIndices[j] + vertexOffset;
+        }
+
+        shape.indexCount = static_cast<uint32_t>(index - outData.indices.data()) - shape.startIndex;
+        outData.shapes.push_back(shape);
+        vertexOffset += mesh->mNumVertices;
+    }
+
+    return true;
+}
+
+} // namespace GDTF
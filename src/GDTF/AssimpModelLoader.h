@@ -0,0 +1,40 @@
+/**
+ * @file AssimpModelLoader.h
+ * @brief Assimp import into MeshData, used for model formats the native loader does not handle.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../Resources/MeshData.h"
+
+namespace GDTF
+{
+
+/**
+ * @class AssimpModelLoader
+ * @brief Fallback importer covering every format Assimp supports.
+ *
+ * Produces the same layout as NativeModelLoader: left-handed, triangulated, one shape per
+ * Assimp mesh, positions in file units.
+ */
+class AssimpModelLoader
+{
+public:
+    /**
+     * @brief Imports a model from memory.
+     *
+     * @param data Raw file contents.
+     * @param size Size of data in bytes.
+     * @param hint Extension hint (e.g., ".3ds", ".glb").
+     * @param outData Receives vertices, triangle list indices and one shape per mesh.
+     * @param outError Receives Assimp's error string on failure.
+     * @return true if Assimp produced at least one mesh.
+     */
+    static bool Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData,
+                     std::string &outError);
+};
+
+} // namespace GDTF
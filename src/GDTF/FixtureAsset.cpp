@@ -0,0 +1,184 @@
+/**
+ * @file FixtureAsset.cpp
+ * @brief Implementation of the CPU side of GDTF fixture loading.
+ */
+
+#include "FixtureAsset.h"
+#include <sstream>
+#include "../Core/Config.h"
+#include "../Core/DebugLog.h"
+#include "../Core/ThreadPool.h"
+#include "ModelLoader.h"
+
+namespace GDTF
+{
+
+namespace
+{
+
+/// Renumbers the parts' meshes after failed imports were dropped.
+void RemapMeshes(FixtureAsset::Part &part, const std::vector<int> &remap)
+{
+    if (part.mesh >= 0)
+        part.mesh = remap[static_cast<size_t>(part.mesh)];
+    for (auto &child : part.children)
+        RemapMeshes(child, remap);
+}
+
+} // namespace
+
+bool FixtureAsset::Load(GDTFParser &parser)
+{
+    if (!Extract(parser))
+    {
+        return false;
+    }
+    ThreadPool::Shared().ParallelFor(m_imports.size(), [this](size_t i) { ImportModel(i); });
+    Finish();
+    return true;
+}
+
+bool FixtureAsset::Extract(GDTFParser &parser)
+{
+    m_root = {};
+    m_imports.clear();
+    m_meshes.clear();
+    m_modelFiles.clear();
+    m_loaded = false;
+
+    auto gdtfRoot = parser.GetGeometryRoot();
+    if (!gdtfRoot)
+    {
+        return false;
+    }
+
+    // Extract each distinct model once; parts keep an index into the models
+    std::map<std::string, int> models;
+    AddPart(parser, *gdtfRoot, m_root, models);
+    m_loaded = true;
+    return true;
+}
+
+bool FixtureAsset::ImportModel(size_t index)
+{
+    Import &import = m_imports[index];
+    MeshData data;
+    std::ostringstream log;
+    import.imported = ModelLoader::Load(import.file.data(), import.file.size(), m_modelFiles[index], data, log);
+    if (import.imported)
+    {
+        import.mesh.Build(data);
+        if (Config::Vertex::QUANTIZE_FIXTURES)
+            import.mesh.QuantizeVertices();
+    }
+    import.log = log.str();
+    import.file = {};
+    return import.imported;
+}
+
+void FixtureAsset::Finish()
+{
+    // Drop the models that failed to import, keeping the others in order
+    std::string log;
+    std::vector<int> remap(m_imports.size(), -1);
+    for (size_t i = 0; i < m_imports.size(); ++i)
+    {
+        log += m_imports[i].log;
+        if (!m_imports[i].imported)
+            continue;
+        remap[i] = static_cast<int>(m_meshes.size());
+        m_meshes.push_back(std::move(m_imports[i].mesh));
+        m_modelFiles[m_meshes.size() - 1] = m_modelFiles[i];
+    }
+    m_modelFiles.resize(m_meshes.size());
+    m_imports.clear();
+    RemapMeshes(m_root, remap);
+
+    DebugLog::Write(log);
+}
+
+void FixtureAsset::AddPart(GDTFParser &parser, const GeometryNode &node, Part &outPart,
+                           std::map<std::string, int> &models)
+{
+    outPart.name = node.name;
+    outPart.matrix = node.matrix;
+
+    // Check if this node has a model
+    if (!node.model.empty())
+    {
+        std::string modelPath = parser.GetModelFile(node.model);
+        auto found = models.find(modelPath);
+        if (found == models.end())
+        {
+            // A model that is not in the archive is only searched for once
+            std::string foundPath = modelPath;
+            std::vector<uint8_t> modelData;
+            int index = -1;
+            if (ExtractModel(parser, foundPath, modelData))
+            {
+                index = static_cast<int>(m_imports.size());
+                m_imports.emplace_back();
+                m_imports.back().file = std::move(modelData);
+                m_modelFiles.push_back(foundPath); // Hint for the model loader
+            }
+            found = models.emplace(modelPath, index).first;
+        }
+        outPart.mesh = found->second;
+    }
+
+    outPart.children.resize(node.children.size());
+    size_t count = 0;
+    for (const auto &child : node.children)
+    {
+        if (child)
+            AddPart(parser, *child, outPart.children[count++], models);
+    }
+    outPart.children.resize(count);
+}
+
+bool FixtureAsset::ExtractModel(GDTFParser &parser, std::string &modelPath, std::vector<uint8_t> &outData)
+{
+    // Only try to load if it's a known 3D format we support (GLB/GLTF/3DS) or no extension
+    bool isSupported =
+        (modelPath.find(".glb") != std::string::npos || modelPath.find(".gltf") != std::string::npos ||
+         modelPath.find(".3ds") != std::string::npos || modelPath.find('.') == std::string::npos);
+    if (!isSupported)
+    {
+        return false;
+    }
+
+    // Try various search patterns
+    std::vector<std::string> searchPaths;
+    const std::string baseName = modelPath;
+
+    // If no extension, try .glb and .3ds
+    if (baseName.find('.') == std::string::npos)
+    {
+        searchPaths.push_back(baseName + ".glb");
+        searchPaths.push_back("models/" + baseName + ".glb");
+        searchPaths.push_back(baseName + ".3ds");
+        searchPaths.push_back("models/" + baseName + ".3ds");
+        searchPaths.push_back("models/3ds/" + baseName + ".3ds");
+    }
+    else
+    {
+        searchPaths.push_back(baseName);
+        searchPaths.push_back("models/" + baseName);
+        if (baseName.find(".3ds") != std::string::npos)
+        {
+            searchPaths.push_back("models/3ds/" + baseName);
+        }
+    }
+
+    for (const auto &path : searchPaths)
+    {
+        if (parser.ExtractFile(path, outData) && !outData.empty())
+        {
+            modelPath = path;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace GDTF
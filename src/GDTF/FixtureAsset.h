@@ -0,0 +1,148 @@
+/**
+ * @file FixtureAsset.h
+ * @brief CPU side of a GDTF fixture type: its geometry tree and processed models.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "../Resources/MeshAsset.h"
+#include "GDTFParser.h"
+
+namespace GDTF
+{
+
+/**
+ * @class FixtureAsset
+ * @brief A fixture type's geometry tree with every model imported and processed, built
+ * without a device.
+ *
+ * Loading walks the parser's geometry tree, extracts each referenced model from the archive
+ * once, and imports it through ModelLoader into a MeshAsset. Parts refer to their model by
+ * index, so GDTFLoader uploads each model once and every instance of the fixture shares the
+ * resulting meshes.
+ */
+class FixtureAsset
+{
+public:
+    /**
+     * @struct Part
+     * @brief One geometry of the tree.
+     */
+    struct Part
+    {
+        std::string name;           ///< Geometry name (Base, Yoke, Head...).
+        DirectX::XMFLOAT4X4 matrix; ///< Local transformation matrix.
+        int mesh = -1;              ///< Index into GetMeshes(), -1 for a geometry without a model.
+        std::vector<Part> children; ///< Child geometries.
+    };
+
+    /**
+     * @brief Builds the tree and imports the models of a parsed GDTF, in parallel on the
+     * shared pool: Extract(), ImportModel() for each model, then Finish().
+     *
+     * Models that cannot be found or imported leave their parts without a mesh. Import
+     * summaries are appended to debug.log.
+     *
+     * @param parser A GDTFParser that has already successfully loaded a file.
+     * @return False if the GDTF has no geometry.
+     */
+    bool Load(GDTFParser &parser);
+
+    /**
+     * @brief First step of Load(): builds the tree and extracts each distinct model file.
+     *
+     * Until Finish(), GetModelFiles() lists the extracted files, which ImportModel() takes by
+     * index.
+     *
+     * @param parser A GDTFParser that has already successfully loaded a file.
+     * @return False if the GDTF has no geometry.
+     */
+    bool Extract(GDTFParser &parser);
+
+    /**
+     * @brief Imports and processes one extracted model. Distinct models can be imported on
+     * different threads at the same time.
+     *
+     * @param index Index into GetModelFiles().
+     * @return False if the model could not be imported.
+     */
+    bool ImportModel(size_t index);
+
+    /**
+     * @brief Last step of Load(): keeps the imported models, points the parts at them and
+     * appends the import summaries to debug.log.
+     */
+    void Finish();
+
+    /**
+     * @brief Tells whether Load() found a geometry tree.
+     */
+    [[nodiscard]] bool IsLoaded() const
+    {
+        return m_loaded;
+    }
+
+    /**
+     * @brief Gets the root of the geometry tree.
+     */
+    [[nodiscard]] const Part &GetRoot() const
+    {
+        return m_root;
+    }
+
+    /**
+     * @brief Gets the processed models, one per distinct model file.
+     */
+    [[nodiscard]] const std::vector<MeshAsset> &GetMeshes() const
+    {
+        return m_meshes;
+    }
+
+    /**
+     * @brief Gets the archive path each model was loaded from.
+     */
+    [[nodiscard]] const std::vector<std::string> &GetModelFiles() const
+    {
+        return m_modelFiles;
+    }
+
+private:
+    /**
+     * @brief Copies a geometry and its children into parts, extracting each new model file.
+     */
+    void AddPart(GDTFParser &parser, const GeometryNode &node, Part &outPart, std::map<std::string, int> &models);
+
+    /**
+     * @brief Finds a model in the archive under the names and folders GDTF files use.
+     *
+     * @param parser Loaded parser.
+     * @param modelPath Model file from the description; receives the path that was found.
+     * @param outData Receives the file.
+     * @return False if the model is not in a supported format or not in the archive.
+     */
+    static bool ExtractModel(GDTFParser &parser, std::string &modelPath, std::vector<uint8_t> &outData);
+
+    /**
+     * @struct Import
+     * @brief An extracted model file, then its import.
+     */
+    struct Import
+    {
+        std::vector<uint8_t> file;
+        MeshAsset mesh;
+        std::string log;
+        bool imported = false;
+    };
+
+    Part m_root;
+    std::vector<Import> m_imports; ///< Between Extract() and Finish().
+    std::vector<MeshAsset> m_meshes;
+    std::vector<std::string> m_modelFiles;
+    bool m_loaded = false;
+};
+
+} // namespace GDTF
@@ -0,0 +1,137 @@
+/**
+ * @file FixtureLoader.cpp
+ * @brief Implementation of the background fixture type queue.
+ */
+
+#include "FixtureLoader.h"
+#include <algorithm>
+#include <chrono>
+#include "../Core/ThreadPool.h"
+#include "GDTFParser.h"
+
+namespace GDTF
+{
+
+FixtureLoader::FixtureLoader(int maxLoads) : m_maxLoads((std::max)(maxLoads, 1))
+{
+}
+
+FixtureLoader::~FixtureLoader()
+{
+    WaitIdle();
+}
+
+FixtureLoader::Handle FixtureLoader::Request(const std::string &gdtfFile)
+{
+    for (size_t i = 0; i < m_types.size(); ++i)
+    {
+        if (m_types[i].file == gdtfFile)
+            return static_cast<Handle>(i);
+    }
+
+    const auto handle = static_cast<Handle>(m_types.size());
+    Type type;
+    type.file = gdtfFile;
+    m_types.push_back(std::move(type));
+    m_queued.push_back(handle);
+    return handle;
+}
+
+void FixtureLoader::SetPriority(Handle handle, bool visible, float distance)
+{
+    Type &type = m_types[static_cast<size_t>(handle)];
+    type.visible = visible;
+    type.distance = distance;
+}
+
+void FixtureLoader::Update(std::vector<Handle> &outCompleted, int maxCompleted)
+{
+    // Collect the loads that finished
+    for (auto loading = m_loading.begin(); loading != m_loading.end();)
+    {
+        if (loading->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++loading;
+            continue;
+        }
+        Type &type = m_types[static_cast<size_t>(loading->handle)];
+        type.asset = loading->result.get();
+        type.state = type.asset ? State::Ready : State::Failed;
+        m_finished.push_back(loading->handle);
+        loading = m_loading.erase(loading);
+    }
+
+    // Report a few per frame, so the caller's uploads stay within a frame
+    const size_t reported = (std::min)(m_finished.size(), static_cast<size_t>((std::max)(maxCompleted, 0)));
+    for (size_t i = 0; i < reported; ++i)
+    {
+        m_types[static_cast<size_t>(m_finished[i])].reported = true;
+        outCompleted.push_back(m_finished[i]);
+    }
+    m_finished.erase(m_finished.begin(), m_finished.begin() + static_cast<std::ptrdiff_t>(reported));
+
+    // Start the most wanted types; the job only holds the file name, so it never outlives
+    // anything it points to
+    while (static_cast<int>(m_loading.size()) < m_maxLoads && !m_queued.empty())
+    {
+        const auto next = std::min_element(m_queued.begin(), m_queued.end(),
+                                           [this](Handle a, Handle b) { return IsMoreUrgent(a, b); });
+        const Handle handle = *next;
+        m_queued.erase(next);
+
+        Type &type = m_types[static_cast<size_t>(handle)];
+        type.state = State::Loading;
+        const std::string file = type.file;
+        m_loading.push_back({handle, ThreadPool::Shared().Submit([file]() { return Load(file); })});
+    }
+}
+
+void FixtureLoader::WaitIdle()
+{
+    for (const Loading &loading : m_loading)
+        loading.result.wait();
+}
+
+FixtureLoader::State FixtureLoader::GetState(Handle handle) const
+{
+    return m_types[static_cast<size_t>(handle)].state;
+}
+
+const std::string &FixtureLoader::GetFile(Handle handle) const
+{
+    return m_types[static_cast<size_t>(handle)].file;
+}
+
+std::shared_ptr<const FixtureAsset> FixtureLoader::GetAsset(Handle handle) const
+{
+    return m_types[static_cast<size_t>(handle)].asset;
+}
+
+int FixtureLoader::GetPendingCount() const
+{
+    return static_cast<int>(std::count_if(m_types.begin(), m_types.end(), [](const Type &type) {
+        return type.state == State::Queued || type.state == State::Loading || !type.reported;
+    }));
+}
+
+std::shared_ptr<const FixtureAsset> FixtureLoader::Load(const std::string &gdtfFile)
+{
+    GDTFParser parser;
+    auto asset = std::make_shared<FixtureAsset>();
+    if (!parser.Load(gdtfFile) || !asset->Load(parser))
+        return nullptr;
+    return asset;
+}
+
+bool FixtureLoader::IsMoreUrgent(Handle a, Handle b) const
+{
+    const Type &first = m_types[static_cast<size_t>(a)];
+    const Type &second = m_types[static_cast<size_t>(b)];
+    if (first.visible != second.visible)
+        return first.visible;
+    if (first.distance != second.distance)
+        return first.distance < second.distance;
+    return a < b;
+}
+
+} // namespace GDTF
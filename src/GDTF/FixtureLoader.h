@@ -0,0 +1,161 @@
+/**
+ * @file FixtureLoader.h
+ * @brief Background loading of GDTF fixture types, the most wanted first.
+ */
+
+#pragma once
+
+#include <cfloat>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FixtureAsset.h"
+
+namespace GDTF
+{
+
+/**
+ * @class FixtureLoader
+ * @brief Queue of fixture types to parse and import on the shared ThreadPool while frames keep
+ * coming.
+ *
+ * Request() hands back a handle at once; the type loads later, a few at a time, into a
+ * FixtureAsset. The caller shows a proxy meanwhile and tells the loader, every frame, how much
+ * each type is wanted (SetPriority()): types with a visible instance go first, then the
+ * nearest. Update() is called once per frame: it reports the types that finished, a few per
+ * frame so their upload fits in a frame, and starts the next loads.
+ *
+ * The loader never touches the GPU, so the queue runs the same in tests.
+ */
+class FixtureLoader
+{
+public:
+    /// Fixture type, in the order they were requested.
+    using Handle = int;
+
+    /**
+     * @brief Where a fixture type is on its way to the scene.
+     */
+    enum class State
+    {
+        Queued,  ///< Waiting for a load to start.
+        Loading, ///< On the ThreadPool.
+        Ready,   ///< Loaded (reported by Update() once).
+        Failed   ///< Did not load (reported by Update() once).
+    };
+
+    /**
+     * @brief Creates an empty queue.
+     *
+     * @param maxLoads Fixture types loaded at once.
+     */
+    explicit FixtureLoader(int maxLoads);
+
+    /**
+     * @brief Waits for the loads in flight.
+     */
+    ~FixtureLoader();
+
+    FixtureLoader(const FixtureLoader &) = delete;
+    FixtureLoader &operator=(const FixtureLoader &) = delete;
+
+    /**
+     * @brief Queues a fixture type; nothing is read yet.
+     *
+     * @param gdtfFile Path to the .gdtf.
+     * @return Its handle; the same file always gives the same handle.
+     */
+    Handle Request(const std::string &gdtfFile);
+
+    /**
+     * @brief Sets how much a queued type is wanted, until it is set again.
+     *
+     * @param handle Handle from Request().
+     * @param visible Whether an instance is in view.
+     * @param distance Distance from the camera to the nearest instance.
+     */
+    void SetPriority(Handle handle, bool visible, float distance);
+
+    /**
+     * @brief Runs the queue once per frame: collects finished loads and starts the next ones.
+     *
+     * @param outCompleted Receives the types that finished (loaded or failed) since the last
+     * report, in the order they finished.
+     * @param maxCompleted Most types to report; the rest wait for the next frames.
+     */
+    void Update(std::vector<Handle> &outCompleted, int maxCompleted);
+
+    /**
+     * @brief Blocks until every load in flight has finished; the next Update() collects them.
+     */
+    void WaitIdle();
+
+    /**
+     * @brief Gets where a type is.
+     */
+    [[nodiscard]] State GetState(Handle handle) const;
+
+    /**
+     * @brief Gets the .gdtf a type is loaded from.
+     */
+    [[nodiscard]] const std::string &GetFile(Handle handle) const;
+
+    /**
+     * @brief Gets a loaded type, shared with every instance of it.
+     * @return The asset, or nullptr until the type is Ready.
+     */
+    [[nodiscard]] std::shared_ptr<const FixtureAsset> GetAsset(Handle handle) const;
+
+    /**
+     * @brief Gets the number of types requested.
+     */
+    [[nodiscard]] int GetCount() const
+    {
+        return static_cast<int>(m_types.size());
+    }
+
+    /**
+     * @brief Gets the number of types queued, loading or finished but not reported yet.
+     */
+    [[nodiscard]] int GetPendingCount() const;
+
+    /**
+     * @brief Loads a fixture type: parses the description and imports its models.
+     *
+     * @param gdtfFile Path to the .gdtf.
+     * @return The asset, or nullptr if the file has no geometry or cannot be read.
+     */
+    static std::shared_ptr<const FixtureAsset> Load(const std::string &gdtfFile);
+
+private:
+    struct Type
+    {
+        std::string file;
+        State state = State::Queued;
+        bool visible = false;
+        float distance = FLT_MAX;
+        bool reported = false;
+        std::shared_ptr<const FixtureAsset> asset;
+    };
+
+    struct Loading
+    {
+        Handle handle = 0;
+        std::future<std::shared_ptr<const FixtureAsset>> result;
+    };
+
+    /**
+     * @brief Tells whether a type should load before another: visible first, then nearest,
+     * then requested first.
+     */
+    [[nodiscard]] bool IsMoreUrgent(Handle a, Handle b) const;
+
+    int m_maxLoads;
+    std::vector<Type> m_types;
+    std::vector<Handle> m_queued;
+    std::vector<Loading> m_loading;
+    std::vector<Handle> m_finished; ///< Not reported yet, in the order they finished.
+};
+
+} // namespace GDTF
@@ -4,132 +4,68 @@
  */
 
 #include "GDTFLoader.h"
-#include <fstream>
-#include <iostream>
-#include "../Geometry/GeometryGenerator.h"
 #include "../Scene/MeshNode.h"
-#include "ModelLoader.h"
 
 namespace GDTF
 {
 
-std::shared_ptr<SceneGraph::Node> GDTFLoader::BuildSceneGraph(ID3D11Device *device, GDTFParser &parser)
+std::vector<std::shared_ptr<Mesh>> GDTFLoader::CreateMeshes(ID3D11Device *device, const FixtureAsset &asset)
 {
-    auto gdtfRoot = parser.GetGeometryRoot();
-    if (!gdtfRoot)
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    meshes.reserve(asset.GetMeshes().size());
+    for (const MeshAsset &model : asset.GetMeshes())
     {
-        return nullptr;
+        auto mesh = std::make_shared<Mesh>();
+        meshes.push_back(mesh->Create(device, model) ? mesh : nullptr);
     }
+    return meshes;
+}
 
-    std::map<std::string, std::shared_ptr<Mesh>> meshCache;
-    auto root = CreateNodeRecursive(device, parser, gdtfRoot, meshCache);
-
-    return root;
+std::shared_ptr<SceneGraph::Node> GDTFLoader::Instantiate(const FixtureAsset &asset,
+                                                          const std::vector<std::shared_ptr<Mesh>> &meshes)
+{
+    if (!asset.IsLoaded())
+    {
+        return nullptr;
+    }
+    return CreateNodeRecursive(asset.GetRoot(), meshes);
 }
 
-std::shared_ptr<SceneGraph::Node>
-GDTFLoader::CreateNodeRecursive(ID3D11Device *device, GDTFParser &parser, const std::shared_ptr<GeometryNode> &gdtfNode,
-                                std::map<std::string, std::shared_ptr<Mesh>> &meshCache)
+std::shared_ptr<SceneGraph::Node> GDTFLoader::BuildSceneGraph(ID3D11Device *device, GDTFParser &parser)
 {
-    if (!gdtfNode)
+    FixtureAsset asset;
+    if (!asset.Load(parser))
     {
         return nullptr;
     }
+    return Instantiate(asset, CreateMeshes(device, asset));
+}
 
+std::shared_ptr<SceneGraph::Node> GDTFLoader::CreateNodeRecursive(const FixtureAsset::Part &part,
+                                                                  const std::vector<std::shared_ptr<Mesh>> &meshes)
+{
     std::shared_ptr<SceneGraph::Node> sceneNode;
 
-    // Check if this node has a model
-    if (!gdtfNode->model.empty())
+    // Check if this part has a model that made it to the GPU
+    if (part.mesh >= 0 && part.mesh < static_cast<int>(meshes.size()) && meshes[static_cast<size_t>(part.mesh)])
     {
-        std::string modelPath = parser.GetModelFile(gdtfNode->model);
-        std::shared_ptr<Mesh> mesh;
-
-        if (meshCache.count(modelPath))
-        {
-            mesh = meshCache[modelPath];
-        }
-        else
-        {
-            // Try to load model from GDTF
-            std::vector<uint8_t> modelData;
-
-            // Only try to load if it's a known 3D format we support (GLB/GLTF/3DS) or no extension
-            bool isSupported =
-                (modelPath.find(".glb") != std::string::npos || modelPath.find(".gltf") != std::string::npos ||
-                 modelPath.find(".3ds") != std::string::npos || modelPath.find('.') == std::string::npos);
-
-            if (isSupported)
-            {
-                // Try various search patterns
-                std::vector<std::string> searchPaths;
-                std::string baseName = modelPath;
-
-                // If no extension, try .glb and .3ds
-                if (baseName.find('.') == std::string::npos)
-                {
-                    searchPaths.push_back(baseName + ".glb");
-                    searchPaths.push_back("models/" + baseName + ".glb");
-                    searchPaths.push_back(baseName + ".3ds");
-                    searchPaths.push_back("models/" + baseName + ".3ds");
-                    searchPaths.push_back("models/3ds/" + baseName + ".3ds");
-                }
-                else
-                {
-                    searchPaths.push_back(baseName);
-                    searchPaths.push_back("models/" + baseName);
-                    if (baseName.find(".3ds") != std::string::npos)
-                    {
-                        searchPaths.push_back("models/3ds/" + baseName);
-                    }
-                }
-
-                for (const auto &path : searchPaths)
-                {
-                    if (parser.ExtractFile(path, modelData))
-                    {
-                        modelPath = path; // Update hint for Assimp
-                        break;
-                    }
-                }
-            }
-
-            if (!modelData.empty())
-            {
-                mesh = ModelLoader::LoadFromMemory(device, modelData.data(), modelData.size(), modelPath);
-            }
-
-            if (mesh)
-            {
-                meshCache[modelPath] = mesh;
-                std::ofstream log("debug.log", std::ios::app);
-                log << "Loaded model mesh: " << modelPath << " with Assimp.\n";
-            }
-        }
-
-        if (mesh)
-        {
-            sceneNode = std::make_shared<SceneGraph::MeshNode>(mesh, gdtfNode->name);
-        }
+        sceneNode = std::make_shared<SceneGraph::MeshNode>(meshes[static_cast<size_t>(part.mesh)], part.name);
     }
 
     if (!sceneNode)
     {
-        sceneNode = std::make_shared<SceneGraph::Node>(gdtfNode->name);
+        sceneNode = std::make_shared<SceneGraph::Node>(part.name);
     }
 
     // Set local matrix from GDTF
-    sceneNode->SetLocalMatrix(DirectX::XMLoadFloat4x4(&gdtfNode->matrix));
+    sceneNode->SetLocalMatrix(DirectX::XMLoadFloat4x4(&part.matrix));
 
-    for (auto &childGdtf : gdtfNode->children)
+    for (const auto &child : part.children)
     {
-        auto childScene = CreateNodeRecursive(device, parser, childGdtf, meshCache);
-        if (childScene)
-        {
-            sceneNode->AddChild(childScene);
-        }
+        sceneNode->AddChild(CreateNodeRecursive(child, meshes));
     }
 
     return sceneNode;
 }
 
-} // namespace GDTF
\ No newline at end of file
+} // namespace GDTF
@@ -6,10 +6,11 @@
 #pragma once
 
 #include <d3d11.h>
-#include <map>
 #include <memory>
+#include <vector>
 #include "../Resources/Mesh.h"
 #include "../Scene/Node.h"
+#include "FixtureAsset.h"
 #include "GDTFParser.h"
 
 namespace GDTF
@@ -19,8 +20,10 @@ namespace GDTF
  * @class GDTFLoader
  * @brief Orchestrates the creation of a scene graph from parsed GDTF data.
  *
- * This class takes the logical tree from GDTFParser and converts it into
- * a hierarchy of SceneGraph::Node objects, mapping geometry types to specialized nodes.
+ * This class takes the geometry tree of a FixtureAsset and converts it into a hierarchy of
+ * SceneGraph::Node objects, mapping geometries with a model to MeshNodes. Loading is split
+ * in two: the FixtureAsset is built on any thread, then CreateMeshes() uploads its models on
+ * the render thread and Instantiate() makes as many fixtures as needed from the same meshes.
  */
 class GDTFLoader
 {
@@ -36,7 +39,26 @@ public:
     ~GDTFLoader() = default;
 
     /**
-     * @brief Builds a SceneGraph hierarchy from a parsed GDTF.
+     * @brief Creates the GPU meshes of a fixture's models.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param asset A loaded fixture.
+     * @return One mesh per model of the asset, nullptr where creation failed.
+     */
+    static std::vector<std::shared_ptr<Mesh>> CreateMeshes(ID3D11Device *device, const FixtureAsset &asset);
+
+    /**
+     * @brief Builds one instance of a fixture's SceneGraph hierarchy.
+     *
+     * @param asset A loaded fixture.
+     * @param meshes Meshes from CreateMeshes(), shared by every instance.
+     * @return A shared pointer to the root Node, or nullptr if the asset has no geometry.
+     */
+    static std::shared_ptr<SceneGraph::Node> Instantiate(const FixtureAsset &asset,
+                                                         const std::vector<std::shared_ptr<Mesh>> &meshes);
+
+    /**
+     * @brief Builds a SceneGraph hierarchy from a parsed GDTF, loading and uploading in one go.
      *
      * @param device Pointer to the ID3D11Device for mesh creation.
      * @param parser A reference to a GDTFParser that has already successfully loaded a file.
@@ -46,17 +68,14 @@ public:
 
 private:
     /**
-     * @brief Recursively converts GDTF GeometryNodes into SceneGraph Nodes.
+     * @brief Recursively converts fixture parts into SceneGraph Nodes.
      *
-     * @param device Pointer to the ID3D11Device.
-     * @param parser Reference to the GDTFParser.
-     * @param gdtf_node The current GDTF logical node.
-     * @param mesh_cache Cache of loaded meshes.
+     * @param part The current part of the geometry tree.
+     * @param meshes Meshes from CreateMeshes().
      * @return A shared pointer to the created SceneGraph Node.
      */
-    static std::shared_ptr<SceneGraph::Node>
-    CreateNodeRecursive(ID3D11Device *device, GDTFParser &parser, const std::shared_ptr<GeometryNode> &gdtfNode,
-                        std::map<std::string, std::shared_ptr<Mesh>> &meshCache);
+    static std::shared_ptr<SceneGraph::Node> CreateNodeRecursive(const FixtureAsset::Part &part,
+                                                                 const std::vector<std::shared_ptr<Mesh>> &meshes);
 };
 
 } // namespace GDTF
@@ -1,5 +1,6 @@
 #include "GDTFParser.h"
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <miniz/miniz.h>
@@ -238,100 +239,114 @@ std::string GDTFParser::GetModelFile(const std::string &modelName) const
 
 std::vector<std::vector<uint8_t>> GDTFParser::ExtractGoboImages()
 {
+    // First slot is always "Open"
     std::vector<std::vector<uint8_t>> images;
+    images.push_back(CreateOpenGoboImage());
 
-    // First slot is always "Open" (radial gradient - bright center, soft falloff)
-    // Create a simple TGA in memory
+    // Only wheels that contain "Gobo" in the name
+    for (WheelMedia &media : ExtractWheelMedia())
     {
-        const int size = 512;
-        std::vector<uint8_t> circleData;
-        // Simple uncompressed TGA format (easier than PNG)
-        // TGA header (18 bytes)
-        circleData.resize(18 + (static_cast<size_t>(size) * size * 4));
-        circleData[2] = 2; // Uncompressed true-color
-        circleData[12] = size & 0xFF;
-        circleData[13] = (size >> 8) & 0xFF;
-        circleData[14] = size & 0xFF;
-        circleData[15] = (size >> 8) & 0xFF;
-        circleData[16] = 32;   // 32 bits per pixel
-        circleData[17] = 0x20; // Top-left origin
-        // Radial gradient with hard edge cutoff (like real gobos)
-        const float center = size / 2.0f;
-        const float radius = center * 0.40f;      // Circle occupies 50% of diameter
-        const float edgeSoftness = radius * 0.1f; // Soft edge zone
-        for (int y = 0; y < size; ++y)
-        {
-            for (int x = 0; x < size; ++x)
-            {
-                float dx = static_cast<float>(x) - center;
-                float dy = static_cast<float>(y) - center;
-                float dist = std::sqrt((dx * dx) + (dy * dy));
-
-                float brightness = 0.0f;
-                if (dist < radius - edgeSoftness)
-                {
-                    // Inside: gradient from 100% center to 90% near edge
-                    float t = dist / radius;
-                    brightness = 1.0f - (t * t * 0.1f);
-                }
-                else if (dist < radius + edgeSoftness)
-                {
-                    // Soft edge transition
-                    float t = (dist - (radius - edgeSoftness)) / (2.0f * edgeSoftness);
-                    brightness = (1.0f - 0.1f) * (1.0f - t); // Fade from 90% to 0%
-                }
-                // else: black (brightness = 0)
-
-                auto val = static_cast<unsigned char>(brightness * 255.0f);
-                int idx = static_cast<int>(18 + (((static_cast<size_t>(y) * size) + x) * 4));
-                circleData[static_cast<size_t>(idx)] = val;     // B
-                circleData[static_cast<size_t>(idx) + 1] = val; // G
-                circleData[static_cast<size_t>(idx) + 2] = val; // R
-                circleData[static_cast<size_t>(idx) + 3] = 255; // A
-            }
-        }
-        images.push_back(std::move(circleData));
+        if (media.wheel.find("Gobo") != std::string::npos)
+            images.push_back(std::move(media.data));
     }
+    return images;
+}
 
+std::vector<WheelMedia> GDTFParser::ExtractWheelMedia()
+{
+    std::vector<WheelMedia> media;
     for (const auto &wheel : m_goboWheels)
     {
-        // Only process wheels that contain "Gobo" in the name
-        if (wheel.name.find("Gobo") == std::string::npos)
-            continue;
-
         for (const auto &slot : wheel.slots)
         {
-            // Skip empty slots (Open position already added above)
+            // Skip empty slots (Open positions, color filters)
             if (slot.media_file_name.empty())
                 continue;
 
-            // Try common paths and extensions
-            std::vector<std::string> pathsToTry = {"wheels/" + slot.media_file_name + ".png",
-                                                   "wheels/" + slot.media_file_name + ".PNG",
-                                                   "wheels/" + slot.media_file_name + ".jpg",
-                                                   "wheels/" + slot.media_file_name + ".jpeg",
-                                                   slot.media_file_name + ".png",
-                                                   slot.media_file_name};
-
-            std::vector<uint8_t> data;
-            bool found = false;
-            for (const auto &path : pathsToTry)
+            WheelMedia entry;
+            if (ExtractMedia(slot.media_file_name, entry.data) && !entry.data.empty())
             {
-                if (ExtractFile(path, data))
-                {
-                    found = true;
-                    break;
-                }
+                entry.wheel = wheel.name;
+                entry.slot = slot.name;
+                media.push_back(std::move(entry));
             }
+        }
+    }
+    return media;
+}
+
+std::vector<uint8_t> GDTFParser::CreateOpenGoboImage()
+{
+    // Radial gradient - bright center, soft falloff
+    // Create a simple TGA in memory
+    const int size = 512;
+    std::vector<uint8_t> circleData;
+    // Simple uncompressed TGA format (easier than PNG)
+    // TGA header (18 bytes)
+    circleData.resize(18 + (static_cast<size_t>(size) * size * 4));
+    circleData[2] = 2; // Uncompressed true-color
+    circleData[12] = size & 0xFF;
+    circleData[13] = (size >> 8) & 0xFF;
+    circleData[14] = size & 0xFF;
+    circleData[15] = (size >> 8) & 0xFF;
+    circleData[16] = 32;   // 32 bits per pixel
+    circleData[17] = 0x20; // Top-left origin
+    // Radial gradient with hard edge cutoff (like real gobos)
+    const float center = size / 2.0f;
+    const float radius = center * 0.40f;      // Circle occupies 50% of diameter
+    const float edgeSoftness = radius * 0.1f; // Soft edge zone
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            float dx = static_cast<float>(x) - center;
+            float dy = static_cast<float>(y) - center;
+            float dist = std::sqrt((dx * dx) + (dy * dy));
 
-            if (found && !data.empty())
+            float brightness = 0.0f;
+            if (dist < radius - edgeSoftness)
             {
-                images.push_back(std::move(data));
+                // Inside: gradient from 100% center to 90% near edge
+                float t = dist / radius;
+                brightness = 1.0f - (t * t * 0.1f);
             }
+            else if (dist < radius + edgeSoftness)
+            {
+                // Soft edge transition
+                float t = (dist - (radius - edgeSoftness)) / (2.0f * edgeSoftness);
+                brightness = (1.0f - 0.1f) * (1.0f - t); // Fade from 90% to 0%
+            }
+            // else: black (brightness = 0)
+
+            // Gobo images are read as sRGB (see TextureBaker), so encode the linear profile
+            float srgb = brightness <= 0.0031308f ? brightness * 12.92f
+                                                  : (1.055f * std::pow(brightness, 1.0f / 2.4f)) - 0.055f;
+            auto val = static_cast<unsigned char>((srgb * 255.0f) + 0.5f);
+            int idx = static_cast<int>(18 + (((static_cast<size_t>(y) * size) + x) * 4));
+            circleData[static_cast<size_t>(idx)] = val;     // B
+            circleData[static_cast<size_t>(idx) + 1] = val; // G
+            circleData[static_cast<size_t>(idx) + 2] = val; // R
+            circleData[static_cast<size_t>(idx) + 3] = 255; // A
         }
     }
+    return circleData;
+}
 
-    return images;
+bool GDTFParser::ExtractMedia(const std::string &mediaFileName, std::vector<uint8_t> &outData)
+{
+    // Try common paths and extensions
+    const std::vector<std::string> pathsToTry = {"wheels/" + mediaFileName + ".png",
+                                                 "wheels/" + mediaFileName + ".PNG",
+                                                 "wheels/" + mediaFileName + ".jpg",
+                                                 "wheels/" + mediaFileName + ".jpeg",
+                                                 mediaFileName + ".png",
+                                                 mediaFileName};
+    for (const auto &path : pathsToTry)
+    {
+        if (ExtractFile(path, outData))
+            return true;
+    }
+    return false;
 }
 
 } // namespace GDTF
\ No newline at end of file
@@ -66,6 +66,17 @@ struct GoboWheel
     std::vector<GoboSlot> slots; ///< List of slots on this wheel.
 };
 
+/**
+ * @struct WheelMedia
+ * @brief The image of one wheel slot, extracted from the archive.
+ */
+struct WheelMedia
+{
+    std::string wheel;         ///< Name of the wheel (e.g. "Gobo Wheel", "Animation Wheel").
+    std::string slot;          ///< Name of the slot.
+    std::vector<uint8_t> data; ///< Raw image file (PNG/JPG bytes).
+};
+
 /**
  * @class GDTFParser
  * @brief Handles unzipping and XML parsing of GDTF (.gdtf) archives.
@@ -149,6 +160,20 @@ public:
      */
     std::vector<std::vector<uint8_t>> ExtractGoboImages();
 
+    /**
+     * @brief Extracts the image of every wheel slot that has one: gobos, animation wheel
+     * positions, prism facets...
+     *
+     * @return One entry per slot whose MediaFileName was found, wheel by wheel in slot order.
+     */
+    std::vector<WheelMedia> ExtractWheelMedia();
+
+    /**
+     * @brief Creates the image of the "Open" slot, a soft-edged disc, as an uncompressed TGA.
+     * @return Raw image file data.
+     */
+    static std::vector<uint8_t> CreateOpenGoboImage();
+
     /**
      * @brief Gets the actual file name for a model name.
      * @param modelName The name of the model in the geometry tree.
@@ -171,6 +196,14 @@ private:
      */
     static std::shared_ptr<GeometryNode> ParseGeometry(pugi::xml_node node);
 
+    /**
+     * @brief Extracts a slot image, trying the usual folders and extensions of a MediaFileName.
+     * @param mediaFileName MediaFileName of the slot, without extension.
+     * @param outData Receives the raw image file.
+     * @return true if the image was found.
+     */
+    bool ExtractMedia(const std::string &mediaFileName, std::vector<uint8_t> &outData);
+
     std::string m_gdtfPath;                           ///< Path to the source .gdtf archive.
     std::string m_fixtureTypeName;                    ///< Name extracted from the XML.
     std::shared_ptr<GeometryNode> m_geometryRoot;     ///< Root of the logical geometry tree.
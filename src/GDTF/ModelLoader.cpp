@@ -1,104 +1,65 @@
 #include "ModelLoader.h"
-#include <algorithm>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include <assimp/scene.h>
-#include <fstream>
-#include <iostream>
+#include "../Core/Config.h"
+#include "../Geometry/MeshOptimizer.h"
+#include "../Geometry/MeshSimplifier.h"
+#include "../Geometry/VertexQuantizer.h"
+#include "AssimpModelLoader.h"
+#include "NativeModelLoader.h"
 
 namespace GDTF
 {
 
-std::shared_ptr<Mesh> ModelLoader::LoadFromMemory(ID3D11Device *device, const uint8_t *data, size_t size,
-                                                  const std::string &hint)
+bool ModelLoader::Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData, std::ostream &log)
 {
-    Assimp::Importer importer;
-
-    unsigned int flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType |
-                         aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_ConvertToLeftHanded;
-
-    const aiScene *scene = importer.ReadFileFromMemory(data, size, flags, hint.c_str());
-
-    if (!scene || !scene->HasMeshes())
-    {
-        std::ofstream log("debug.log", std::ios::app);
-        log << "Assimp failed to load " << hint << ": " << importer.GetErrorString() << '\n';
-        return nullptr;
-    }
-
-    float minX = 1e10f, minY = 1e10f, minZ = 1e10f;
-    float maxX = -1e10f, maxY = -1e10f, maxZ = -1e10f;
-
-    auto mesh = std::make_shared<Mesh>();
-    std::vector<Vertex> allVertices;
-    std::vector<uint32_t> allIndices;
-    uint32_t vertexOffset = 0;
-
-    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+    const char *loaderName = "Native";
+    std::string error;
+    if (!NativeModelLoader::Load(data, size, hint, outData))
     {
-        aiMesh *aiMesh = scene->mMeshes[m];
-
-        ShapeInfo shape;
-        shape.name = aiMesh->mName.C_Str();
-        shape.startIndex = (uint32_t)allIndices.size();
-
-        for (unsigned int i = 0; i < aiMesh->mNumVertices; ++i)
+        loaderName = "Assimp";
+        if (!AssimpModelLoader::Load(data, size, hint, outData, error))
         {
-            Vertex v;
-            // Scale down by 0.001 to convert from mm to m
-            v.position = {aiMesh->mVertices[i].x * 0.001f, aiMesh->mVertices[i].y * 0.001f,
-                          aiMesh->mVertices[i].z * 0.001f};
-
-            minX = (std::min)(minX, v.position.x);
-            minY = (std::min)(minY, v.position.y);
-            minZ = (std::min)(minZ, v.position.z);
-            maxX = (std::max)(maxX, v.position.x);
-            maxY = (std::max)(maxY, v.position.y);
-            maxZ = (std::max)(maxZ, v.position.z);
-
-            if (aiMesh->HasNormals())
-                v.normal = {aiMesh->mNormals[i].x, aiMesh->mNormals[i].y, aiMesh->mNormals[i].z};
-            else
-                v.normal = {0, 1, 0};
-
-            if (aiMesh->HasTextureCoords(0))
-                v.uv = {aiMesh->mTextureCoords[0][i].x, aiMesh->mTextureCoords[0][i].y};
-            else
-                v.uv = {0, 0};
-
-            allVertices.push_back(v);
+            log << "Assimp failed to load " << hint << ": " << error << '\n';
+            return false;
         }
+    }
 
-        for (unsigned int i = 0; i < aiMesh->mNumFaces; ++i)
-        {
-            aiFace face = aiMesh->mFaces[i];
-            for (unsigned int j = 0; j < face.mNumIndices; ++j)
-                allIndices.push_back(face.mIndices[j] + vertexOffset);
-        }
+    // Scale down to convert from mm to m
+    DirectX::XMFLOAT3 boundsMin;
+    DirectX::XMFLOAT3 boundsMax;
+    NativeModelLoader::ScalePositions(outData.vertices.data(), outData.vertices.size(),
+                                      NativeModelLoader::MILLIMETERS_TO_METERS, boundsMin, boundsMax);
+    outData.minY = boundsMin.y;
 
-        shape.indexCount = aiMesh->mNumFaces * 3;
+    for (auto &shape : outData.shapes)
+    {
         shape.center = {0, 0, 0};
         // Assign a black material
         shape.material.diffuse = {0.05f, 0.05f, 0.05f};
         shape.material.specular = {0.2f, 0.2f, 0.2f};
         shape.material.shininess = 32.0f;
-
-        mesh->AddShape(shape);
-        vertexOffset += aiMesh->mNumVertices;
-    }
-
-    if (!mesh->Create(device, allVertices, allIndices))
-        return nullptr;
-
-    {
-        std::ofstream log("debug.log", std::ios::app);
-        log << "Assimp loaded " << hint << ": " << allVertices.size() << " vertices, " << allIndices.size() / 3
-            << " faces.\n";
-        log << "  Bounds: Min(" << minX << "," << minY << "," << minZ << ") Max(" << maxX << "," << maxY << "," << maxZ
-            << ")\n";
     }
 
-    return mesh;
+    // Counts as the loader returned them; welding below changes the vertex count
+    const size_t loadedVertices = outData.vertices.size();
+    const size_t loadedFaces = outData.indices.size() / 3;
+    MeshOptimizer::Stats stats = MeshOptimizer::ProcessMesh(outData);
+    std::vector<MeshSimplifier::LevelReport> lods = MeshSimplifier::BuildLodChain(
+        outData, Config::Lod::TRIANGLE_RATIOS, Config::Lod::MAX_ERRORS, Config::Lod::MAX_LEVELS - 1);
+
+    log << loaderName << " loaded " << hint << ": " << loadedVertices << " vertices, " << loadedFaces
+        << " faces (before welding).\n";
+    log << "  Welded: " << stats.verticesBefore << " -> " << stats.verticesAfter << " vertices, ACMR "
+        << stats.acmrBefore << " -> " << stats.acmrAfter << "\n";
+    VertexQuantizer::Report quantized = VertexQuantizer::Analyze(outData.vertices.data(), outData.vertices.size());
+    log << "  Vertex memory: " << quantized.fullBytes / 1024 << " KB full, " << quantized.quantizedBytes / 1024
+        << " KB quantized, " << quantized.positionBytes / 1024 << " KB shadow positions (max error "
+        << quantized.maxPositionError << " units, " << quantized.maxNormalErrorDeg << " deg)\n";
+    for (size_t i = 0; i < lods.size(); ++i)
+        log << "  LOD " << i << ": " << lods[i].triangles << " triangles, error " << lods[i].error * 1000.0f << " mm\n";
+    log << "  Bounds: Min(" << boundsMin.x << "," << boundsMin.y << "," << boundsMin.z << ") Max(" << boundsMax.x << ","
+        << boundsMax.y << "," << boundsMax.z << ")\n";
+
+    return true;
 }
 
 } // namespace GDTF
@@ -1,22 +1,22 @@
 /**
  * @file ModelLoader.h
- * @brief Assimp-based 3D model loading for GDTF fixtures.
+ * @brief 3D model loading for GDTF fixtures.
  */
 
 #pragma once
 
-#include <d3d11.h>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <string>
-#include <vector>
-#include "../Resources/Mesh.h"
+#include "../Resources/MeshData.h"
 
 namespace GDTF
 {
 
 /**
  * @class ModelLoader
- * @brief Unified model loader using Assimp to support 3DS, GLB, OBJ, etc.
+ * @brief Unified model loader: native 3DS/GLB parsing with Assimp as the fallback for OBJ, etc.
  */
 class ModelLoader
 {
@@ -24,14 +24,17 @@ public:
     /**
      * @brief Loads a mesh from binary data in memory.
      *
-     * @param device Pointer to D3D11 device.
+     * Scales the model from millimeters to meters, processes it for the vertex cache and builds
+     * its LOD chain. Touches no device and no shared state, so models can load on any thread.
+     *
      * @param data Pointer to raw binary data.
      * @param size Size of data in bytes.
      * @param hint Extension hint (e.g., ".3ds", ".glb").
-     * @return Shared pointer to Mesh, or nullptr on failure.
+     * @param outData Receives the processed mesh, ready for MeshAsset::Build().
+     * @param log Receives a summary of the import (debug.log for the application).
+     * @return true on success.
      */
-    static std::shared_ptr<Mesh> LoadFromMemory(ID3D11Device *device, const uint8_t *data, size_t size,
-                                                const std::string &hint);
+    static bool Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData, std::ostream &log);
 };
 
 } // namespace GDTF
@@ -0,0 +1,876 @@
+/**
+ * @file NativeModelLoader.cpp
+ * @brief 3DS chunk parser and GLB reader producing MeshData without Assimp.
+ */
+
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#include "NativeModelLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "tinygltf/tiny_gltf.h"
+
+using namespace DirectX;
+
+namespace GDTF
+{
+
+namespace
+{
+
+// 3DS chunk identifiers (only the ones that carry geometry)
+constexpr uint16_t CHUNK_MAIN = 0x4D4D;
+constexpr uint16_t CHUNK_EDITOR = 0x3D3D;
+constexpr uint16_t CHUNK_OBJECT = 0x4000;
+constexpr uint16_t CHUNK_TRIMESH = 0x4100;
+constexpr uint16_t CHUNK_VERTICES = 0x4110;
+constexpr uint16_t CHUNK_FACES = 0x4120;
+constexpr uint16_t CHUNK_FACE_MATERIAL = 0x4130;
+constexpr uint16_t CHUNK_UVS = 0x4140;
+constexpr uint16_t CHUNK_SMOOTHING = 0x4150;
+constexpr uint16_t CHUNK_MESH_MATRIX = 0x4160;
+constexpr uint16_t CHUNK_MATERIAL = 0xAFFF;
+constexpr uint16_t CHUNK_MATERIAL_NAME = 0xA000;
+constexpr size_t CHUNK_HEADER_SIZE = 6;
+
+// Relative tolerance used to treat positions as coincident when smoothing (same as Assimp)
+constexpr float COINCIDENT_EPSILON = 1e-5f;
+
+uint16_t ReadU16(const uint8_t *p)
+{
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t ReadU32(const uint8_t *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+float ReadF32(const uint8_t *p)
+{
+    float v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+struct Chunk
+{
+    uint16_t id = 0;
+    const uint8_t *body = nullptr;
+    const uint8_t *end = nullptr;
+};
+
+// Reads the chunk at cursor and advances past it; false if the header or length is invalid
+bool ReadChunk(const uint8_t *&cursor, const uint8_t *end, Chunk &chunk)
+{
+    if (static_cast<size_t>(end - cursor) < CHUNK_HEADER_SIZE)
+        return false;
+    const uint32_t length = ReadU32(cursor + 2);
+    if (length < CHUNK_HEADER_SIZE || length > static_cast<size_t>(end - cursor))
+        return false;
+    chunk.id = ReadU16(cursor);
+    chunk.body = cursor + CHUNK_HEADER_SIZE;
+    chunk.end = cursor + length;
+    cursor = chunk.end;
+    return true;
+}
+
+// Reads a zero-terminated string that must end before `end`
+bool ReadString(const uint8_t *&cursor, const uint8_t *end, std::string &out)
+{
+    const auto *terminator = static_cast<const uint8_t *>(std::memchr(cursor, 0, static_cast<size_t>(end - cursor)));
+    if (!terminator)
+        return false;
+    out.assign(reinterpret_cast<const char *>(cursor), static_cast<size_t>(terminator - cursor));
+    cursor = terminator + 1;
+    return true;
+}
+
+struct FaceGroup3DS
+{
+    std::string material;
+    const uint8_t *faces = nullptr; // uint16 face indices
+    uint32_t count = 0;
+};
+
+struct Mesh3DS
+{
+    std::string name;
+    const uint8_t *positions = nullptr; // float3 per vertex
+    uint32_t vertexCount = 0;
+    const uint8_t *uvs = nullptr; // float2 per vertex
+    uint32_t uvCount = 0;
+    const uint8_t *faces = nullptr; // uint16 a, b, c, flags per face
+    uint32_t faceCount = 0;
+    const uint8_t *smoothing = nullptr; // uint32 group mask per face
+    std::vector<FaceGroup3DS> groups;
+    float matrix[12] = {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0}; // Axis columns, then translation
+};
+
+bool ParseFaces(const Chunk &chunk, Mesh3DS &mesh)
+{
+    if (chunk.end - chunk.body < 2)
+        return false;
+    const uint32_t count = ReadU16(chunk.body);
+    const uint8_t *cursor = chunk.body + 2;
+    if (static_cast<size_t>(chunk.end - cursor) < count * 8u)
+        return false;
+    mesh.faces = cursor;
+    mesh.faceCount = count;
+
+    cursor += count * 8u;
+    Chunk child;
+    while (cursor < chunk.end && ReadChunk(cursor, chunk.end, child))
+    {
+        if (child.id == CHUNK_SMOOTHING && static_cast<size_t>(child.end - child.body) >= count * 4u)
+        {
+            mesh.smoothing = child.body;
+        }
+        else if (child.id == CHUNK_FACE_MATERIAL)
+        {
+            FaceGroup3DS group;
+            const uint8_t *p = child.body;
+            if (!ReadString(p, child.end, group.material) || child.end - p < 2)
+                return false;
+            group.count = ReadU16(p);
+            group.faces = p + 2;
+            if (static_cast<size_t>(child.end - group.faces) < group.count * 2u)
+                return false;
+            mesh.groups.push_back(std::move(group));
+        }
+    }
+    return true;
+}
+
+bool ParseTriMesh(const Chunk &chunk, Mesh3DS &mesh)
+{
+    const uint8_t *cursor = chunk.body;
+    Chunk child;
+    while (cursor < chunk.end)
+    {
+        if (!ReadChunk(cursor, chunk.end, child))
+            return false;
+
+        const size_t bodySize = static_cast<size_t>(child.end - child.body);
+        switch (child.id)
+        {
+        case CHUNK_VERTICES:
+            if (bodySize < 2 || bodySize - 2 < ReadU16(child.body) * 12u)
+                return false;
+            mesh.vertexCount = ReadU16(child.body);
+            mesh.positions = child.body + 2;
+            break;
+        case CHUNK_UVS:
+            if (bodySize < 2 || bodySize - 2 < ReadU16(child.body) * 8u)
+                return false;
+            mesh.uvCount = ReadU16(child.body);
+            mesh.uvs = child.body + 2;
+            break;
+        case CHUNK_MESH_MATRIX:
+            if (bodySize < sizeof(mesh.matrix))
+                return false;
+            std::memcpy(mesh.matrix, child.body, sizeof(mesh.matrix));
+            break;
+        case CHUNK_FACES:
+            if (!ParseFaces(child, mesh))
+                return false;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+bool ParseEditor(const Chunk &editor, std::vector<Mesh3DS> &meshes, std::vector<std::string> &materials)
+{
+    const uint8_t *cursor = editor.body;
+    Chunk chunk;
+    while (cursor < editor.end)
+    {
+        if (!ReadChunk(cursor, editor.end, chunk))
+            return false;
+
+        if (chunk.id == CHUNK_OBJECT)
+        {
+            Mesh3DS mesh;
+            const uint8_t *p = chunk.body;
+            if (!ReadString(p, chunk.end, mesh.name))
+                return false;
+            Chunk child;
+            while (p < chunk.end)
+            {
+                if (!ReadChunk(p, chunk.end, child))
+                    return false;
+                if (child.id == CHUNK_TRIMESH && !ParseTriMesh(child, mesh))
+                    return false;
+            }
+            if (mesh.faceCount > 0)
+                meshes.push_back(std::move(mesh));
+        }
+        else if (chunk.id == CHUNK_MATERIAL)
+        {
+            std::string name;
+            const uint8_t *p = chunk.body;
+            Chunk child;
+            while (p < chunk.end && ReadChunk(p, chunk.end, child))
+            {
+                const uint8_t *s = child.body;
+                if (child.id == CHUNK_MATERIAL_NAME)
+                    ReadString(s, child.end, name);
+            }
+            materials.push_back(name);
+        }
+    }
+    return true;
+}
+
+XMFLOAT3 Sub(const XMFLOAT3 &a, const XMFLOAT3 &b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+XMFLOAT3 Cross(const XMFLOAT3 &a, const XMFLOAT3 &b)
+{
+    return {(a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x)};
+}
+
+XMFLOAT3 NormalizeSafe(const XMFLOAT3 &v)
+{
+    const float length = std::sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+    if (length <= 0.0f)
+        return v;
+    return {v.x / length, v.y / length, v.z / length};
+}
+
+/**
+ * Lists, for every position, the positions within epsilon of it (itself included) in CSR form.
+ * Positions are sorted along a skewed axis like Assimp's SpatialSort so that axis-aligned
+ * geometry does not collapse into one long search window.
+ */
+void FindCoincident(const std::vector<XMFLOAT3> &positions, std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &neighbors)
+{
+    const size_t count = positions.size();
+    XMFLOAT3 lo = {FLT_MAX, FLT_MAX, FLT_MAX};
+    XMFLOAT3 hi = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (const auto &p : positions)
+    {
+        lo = {(std::min)(lo.x, p.x), (std::min)(lo.y, p.y), (std::min)(lo.z, p.z)};
+        hi = {(std::max)(hi.x, p.x), (std::max)(hi.y, p.y), (std::max)(hi.z, p.z)};
+    }
+    const XMFLOAT3 diagonal = Sub(hi, lo);
+    const float epsilon =
+        std::sqrt((diagonal.x * diagonal.x) + (diagonal.y * diagonal.y) + (diagonal.z * diagonal.z)) *
+        COINCIDENT_EPSILON;
+    const float epsilonSq = epsilon * epsilon;
+
+    std::vector<std::pair<float, uint32_t>> sorted(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const XMFLOAT3 &p = positions[i];
+        sorted[i] = {(p.x * 0.8523f) + (p.y * 0.34321f) + (p.z * 0.5736f), static_cast<uint32_t>(i)};
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<uint32_t> rank(count);
+    for (size_t i = 0; i < count; ++i)
+        rank[sorted[i].second] = static_cast<uint32_t>(i);
+
+    // The skew axis has unit length, so coincident points are at most epsilon apart along it
+    offsets.assign(count + 1, 0);
+    neighbors.clear();
+    neighbors.reserve(count);
+    for (size_t v = 0; v < count; ++v)
+    {
+        offsets[v] = static_cast<uint32_t>(neighbors.size());
+        const XMFLOAT3 &p = positions[v];
+        const float key = sorted[rank[v]].first;
+
+        size_t first = rank[v];
+        while (first > 0 && sorted[first - 1].first >= key - epsilon)
+            --first;
+        for (size_t k = first; k < count && sorted[k].first <= key + epsilon; ++k)
+        {
+            const uint32_t u = sorted[k].second;
+            const XMFLOAT3 d = Sub(positions[u], p);
+            if (u == v || (d.x * d.x) + (d.y * d.y) + (d.z * d.z) < epsilonSq)
+                neighbors.push_back(u);
+        }
+    }
+    offsets[count] = static_cast<uint32_t>(neighbors.size());
+}
+
+/**
+ * Per-corner normals from 3DS smoothing groups: each corner sums the area-weighted normals of
+ * the faces touching a coincident position whose group mask intersects its own. Group 0
+ * matches every face, which is what Assimp does for meshes exported without groups.
+ */
+void ComputeSmoothingGroupNormals(const std::vector<XMFLOAT3> &positions, const std::vector<uint32_t> &indices,
+                                  const std::vector<uint32_t> &groups, std::vector<XMFLOAT3> &outNormals)
+{
+    const size_t faceCount = indices.size() / 3;
+    std::vector<XMFLOAT3> faceNormals(faceCount);
+    for (size_t f = 0; f < faceCount; ++f)
+    {
+        const XMFLOAT3 &p0 = positions[indices[(f * 3) + 0]];
+        faceNormals[f] = Cross(Sub(positions[indices[(f * 3) + 1]], p0), Sub(positions[indices[(f * 3) + 2]], p0));
+    }
+
+    // Faces touching each position, one entry per corner
+    std::vector<uint32_t> faceOffsets(positions.size() + 1, 0);
+    for (uint32_t index : indices)
+        ++faceOffsets[index + 1];
+    for (size_t i = 1; i < faceOffsets.size(); ++i)
+        faceOffsets[i] += faceOffsets[i - 1];
+    std::vector<uint32_t> incident(indices.size());
+    std::vector<uint32_t> fill(faceOffsets.begin(), faceOffsets.end() - 1);
+    for (size_t c = 0; c < indices.size(); ++c)
+        incident[fill[indices[c]]++] = static_cast<uint32_t>(c / 3);
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+    FindCoincident(positions, offsets, neighbors);
+
+    outNormals.resize(indices.size());
+    for (size_t c = 0; c < indices.size(); ++c)
+    {
+        const uint32_t group = groups[c / 3];
+        const uint32_t v = indices[c];
+        XMFLOAT3 sum = {0.0f, 0.0f, 0.0f};
+        for (uint32_t n = offsets[v]; n < offsets[v + 1]; ++n)
+        {
+            const uint32_t u = neighbors[n];
+            for (uint32_t i = faceOffsets[u]; i < faceOffsets[u + 1]; ++i)
+            {
+                const uint32_t face = incident[i];
+                if (group != 0 && (groups[face] & group) == 0)
+                    continue;
+                sum = {sum.x + faceNormals[face].x, sum.y + faceNormals[face].y, sum.z + faceNormals[face].z};
+            }
+        }
+        outNormals[c] = NormalizeSafe(sum);
+    }
+}
+
+// Inverts the affine 3DS mesh matrix; returns its determinant (0 leaves `out` untouched)
+float InvertMeshMatrix(const float m[12], float out[12])
+{
+    // Columns of the 3x3 part are m[0..2], m[3..5], m[6..8]; element (row r, column c) is m[c * 3 + r]
+    const double a = m[0], b = m[3], c = m[6];
+    const double d = m[1], e = m[4], f = m[7];
+    const double g = m[2], h = m[5], i = m[8];
+    const double det = (a * ((e * i) - (f * h))) - (b * ((d * i) - (f * g))) + (c * ((d * h) - (e * g)));
+    if (det == 0.0)
+        return 0.0f;
+
+    const double r[9] = {((e * i) - (f * h)) / det, ((c * h) - (b * i)) / det, ((b * f) - (c * e)) / det,
+                         ((f * g) - (d * i)) / det, ((a * i) - (c * g)) / det, ((c * d) - (a * f)) / det,
+                         ((d * h) - (e * g)) / det, ((b * g) - (a * h)) / det, ((a * e) - (b * d)) / det};
+    // r is row-major; store it column-major like the input
+    for (int row = 0; row < 3; ++row)
+        for (int col = 0; col < 3; ++col)
+            out[(col * 3) + row] = static_cast<float>(r[(row * 3) + col]);
+    for (int row = 0; row < 3; ++row)
+    {
+        out[9 + row] = static_cast<float>(-((r[(row * 3) + 0] * m[9]) + (r[(row * 3) + 1] * m[10]) +
+                                            (r[(row * 3) + 2] * m[11])));
+    }
+    return static_cast<float>(det);
+}
+
+bool IsIdentity(const float m[12])
+{
+    static const float identity[12] = {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+    return std::memcmp(m, identity, sizeof(identity)) == 0;
+}
+
+// Appends one 3DS mesh, split into one shape per material like Assimp's 3DS importer
+void Emit3DSMesh(const Mesh3DS &mesh, const std::vector<std::string> &materials, MeshData &out, size_t &cursor)
+{
+    // Positions in mesh-local space (3DS stores them pre-transformed by the mesh matrix)
+    std::vector<XMFLOAT3> positions(mesh.vertexCount);
+    for (uint32_t v = 0; v < mesh.vertexCount; ++v)
+    {
+        const uint8_t *p = mesh.positions + (v * 12u);
+        positions[v] = {ReadF32(p), ReadF32(p + 4), ReadF32(p + 8)};
+    }
+    bool mirrored = false;
+    if (!IsIdentity(mesh.matrix))
+    {
+        float inverse[12];
+        const float det = InvertMeshMatrix(mesh.matrix, inverse);
+        if (det != 0.0f)
+        {
+            for (auto &p : positions)
+            {
+                p = {(inverse[0] * p.x) + (inverse[3] * p.y) + (inverse[6] * p.z) + inverse[9],
+                     (inverse[1] * p.x) + (inverse[4] * p.y) + (inverse[7] * p.z) + inverse[10],
+                     (inverse[2] * p.x) + (inverse[5] * p.y) + (inverse[8] * p.z) + inverse[11]};
+            }
+            mirrored = det < 0.0f;
+        }
+    }
+
+    // Out-of-range indices are clamped, as Assimp does
+    std::vector<uint32_t> indices(mesh.faceCount * 3u);
+    std::vector<uint32_t> groups(mesh.faceCount, 0);
+    for (uint32_t f = 0; f < mesh.faceCount; ++f)
+    {
+        const uint8_t *face = mesh.faces + (f * 8u);
+        for (uint32_t k = 0; k < 3; ++k)
+            indices[(f * 3) + k] = (std::min)(static_cast<uint32_t>(ReadU16(face + (k * 2))), mesh.vertexCount - 1);
+        if (mesh.smoothing)
+            groups[f] = ReadU32(mesh.smoothing + (f * 4u));
+    }
+
+    std::vector<XMFLOAT3> normals;
+    ComputeSmoothingGroupNormals(positions, indices, groups, normals);
+    if (mirrored)
+    {
+        for (auto &p : positions)
+            p.x = -p.x;
+        for (auto &n : normals)
+            n.x = -n.x;
+    }
+
+    // Faces without a material go to the default material, which sorts after the file's own
+    const auto defaultMaterial = static_cast<uint32_t>(materials.size());
+    std::vector<uint32_t> faceMaterial(mesh.faceCount, defaultMaterial);
+    for (const auto &group : mesh.groups)
+    {
+        auto it = std::find(materials.begin(), materials.end(), group.material);
+        const auto material = static_cast<uint32_t>(it - materials.begin());
+        for (uint32_t i = 0; i < group.count; ++i)
+        {
+            const uint32_t face = ReadU16(group.faces + (i * 2u));
+            if (face < mesh.faceCount)
+                faceMaterial[face] = material;
+        }
+    }
+
+    const bool hasUVs = mesh.uvs && mesh.uvCount >= mesh.vertexCount;
+    for (uint32_t material = 0; material <= defaultMaterial; ++material)
+    {
+        ShapeInfo shape;
+        shape.name = mesh.name;
+        shape.startIndex = static_cast<uint32_t>(cursor);
+        for (uint32_t f = 0; f < mesh.faceCount; ++f)
+        {
+            if (faceMaterial[f] != material)
+                continue;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const size_t corner = (f * 3) + k;
+                const uint32_t v = indices[corner];
+                Vertex &vertex = out.vertices[cursor + k];
+
+                // Left-handed: mirror z, flip V, and reverse the winding below
+                vertex.position = {positions[v].x, positions[v].y, -positions[v].z};
+                vertex.normal = {normals[corner].x, normals[corner].y, -normals[corner].z};
+                if (hasUVs)
+                {
+                    const uint8_t *uv = mesh.uvs + (v * 8u);
+                    vertex.uv = {ReadF32(uv), 1.0f - ReadF32(uv + 4)};
+                }
+                else
+                {
+                    vertex.uv = {0.0f, 0.0f};
+                }
+            }
+            out.indices[cursor + 0] = static_cast<uint32_t>(cursor + 2);
+            out.indices[cursor + 1] = static_cast<uint32_t>(cursor + 1);
+            out.indices[cursor + 2] = static_cast<uint32_t>(cursor);
+            cursor += 3;
+        }
+        shape.indexCount = static_cast<uint32_t>(cursor) - shape.startIndex;
+        if (shape.indexCount > 0)
+            out.shapes.push_back(std::move(shape));
+    }
+}
+
+struct AccessorView
+{
+    const uint8_t *data = nullptr;
+    size_t stride = 0;
+    size_t count = 0;
+    int componentType = 0;
+    bool normalized = false;
+};
+
+// Resolves an accessor into the embedded buffer, checking that every element lies inside it
+bool GetAccessor(const tinygltf::Model &model, int index, int type, AccessorView &out)
+{
+    if (index < 0 || static_cast<size_t>(index) >= model.accessors.size())
+        return false;
+    const tinygltf::Accessor &accessor = model.accessors[index];
+    if (accessor.type != type || accessor.sparse.isSparse || accessor.bufferView < 0 ||
+        static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size())
+        return false;
+    const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
+    if (view.buffer < 0 || static_cast<size_t>(view.buffer) >= model.buffers.size())
+        return false;
+    const tinygltf::Buffer &buffer = model.buffers[view.buffer];
+
+    const int stride = accessor.ByteStride(view);
+    const int componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+    const int components = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    if (stride <= 0 || componentSize <= 0 || components <= 0)
+        return false;
+
+    const size_t viewEnd = view.byteOffset + view.byteLength;
+    const size_t start = view.byteOffset + accessor.byteOffset;
+    const size_t elementSize = static_cast<size_t>(componentSize) * static_cast<size_t>(components);
+    if (viewEnd > buffer.data.size() ||
+        (accessor.count > 0 && start + (static_cast<size_t>(stride) * (accessor.count - 1)) + elementSize > viewEnd))
+        return false;
+
+    out.data = buffer.data.data() + start;
+    out.stride = static_cast<size_t>(stride);
+    out.count = accessor.count;
+    out.componentType = accessor.componentType;
+    out.normalized = accessor.normalized;
+    return true;
+}
+
+// Smooth per-vertex normals for primitives that ship without them (what GenSmoothNormals did)
+void ComputeVertexNormals(Vertex *vertices, size_t vertexCount, const uint32_t *indices, size_t indexCount,
+                          uint32_t baseVertex)
+{
+    std::vector<XMFLOAT3> positions(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        positions[v] = vertices[v].position;
+
+    std::vector<XMFLOAT3> accumulated(vertexCount, {0.0f, 0.0f, 0.0f});
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        const uint32_t a = indices[i] - baseVertex, b = indices[i + 1] - baseVertex, c = indices[i + 2] - baseVertex;
+        const XMFLOAT3 n = Cross(Sub(positions[b], positions[a]), Sub(positions[c], positions[a]));
+        for (uint32_t v : {a, b, c})
+            accumulated[v] = {accumulated[v].x + n.x, accumulated[v].y + n.y, accumulated[v].z + n.z};
+    }
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+    FindCoincident(positions, offsets, neighbors);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        XMFLOAT3 sum = {0.0f, 0.0f, 0.0f};
+        for (uint32_t n = offsets[v]; n < offsets[v + 1]; ++n)
+        {
+            const XMFLOAT3 &a = accumulated[neighbors[n]];
+            sum = {sum.x + a.x, sum.y + a.y, sum.z + a.z};
+        }
+        vertices[v].normal = NormalizeSafe(sum);
+    }
+}
+
+float ReadUnitComponent(const uint8_t *p, int componentType)
+{
+    switch (componentType)
+    {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:
+        return ReadF32(p);
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        return static_cast<float>(*p) / 255.0f;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+        return static_cast<float>(ReadU16(p)) / 65535.0f;
+    default:
+        return 0.0f;
+    }
+}
+
+struct Primitive
+{
+    std::string name;
+    AccessorView positions;
+    AccessorView normals;
+    AccessorView uvs;
+    AccessorView indices;
+    size_t indexCount = 0;
+};
+
+bool CollectPrimitives(const tinygltf::Model &model, std::vector<Primitive> &out)
+{
+    for (const auto &mesh : model.meshes)
+    {
+        for (size_t p = 0; p < mesh.primitives.size(); ++p)
+        {
+            const tinygltf::Primitive &source = mesh.primitives[p];
+            if (source.mode != TINYGLTF_MODE_TRIANGLES)
+                return false;
+
+            Primitive primitive;
+            primitive.name = mesh.primitives.size() > 1 ? mesh.name + "-" + std::to_string(p) : mesh.name;
+
+            auto attribute = [&](const char *name) -> int
+            {
+                auto it = source.attributes.find(name);
+                return it == source.attributes.end() ? -1 : it->second;
+            };
+            if (!GetAccessor(model, attribute("POSITION"), TINYGLTF_TYPE_VEC3, primitive.positions) ||
+                primitive.positions.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+                return false;
+
+            const int normal = attribute("NORMAL");
+            if (normal >= 0 && (!GetAccessor(model, normal, TINYGLTF_TYPE_VEC3, primitive.normals) ||
+                                primitive.normals.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT ||
+                                primitive.normals.count != primitive.positions.count))
+                return false;
+
+            const int uv = attribute("TEXCOORD_0");
+            if (uv >= 0)
+            {
+                if (!GetAccessor(model, uv, TINYGLTF_TYPE_VEC2, primitive.uvs) ||
+                    primitive.uvs.count != primitive.positions.count)
+                    return false;
+                if (primitive.uvs.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT && !primitive.uvs.normalized)
+                    return false;
+            }
+
+            if (source.indices >= 0)
+            {
+                if (!GetAccessor(model, source.indices, TINYGLTF_TYPE_SCALAR, primitive.indices))
+                    return false;
+                const int type = primitive.indices.componentType;
+                if (type != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE && type != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+                    type != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
+                    return false;
+                primitive.indexCount = primitive.indices.count - (primitive.indices.count % 3);
+            }
+            else
+            {
+                primitive.indexCount = primitive.positions.count - (primitive.positions.count % 3);
+            }
+
+            if (primitive.indexCount > 0)
+                out.push_back(std::move(primitive));
+        }
+    }
+    return true;
+}
+
+// Appends one glTF primitive starting at the given vertex and index offsets
+bool EmitPrimitive(const Primitive &primitive, MeshData &out, size_t vertexBase, size_t indexBase)
+{
+    const size_t vertexCount = primitive.positions.count;
+    Vertex *vertices = out.vertices.data() + vertexBase;
+    uint32_t *indices = out.indices.data() + indexBase;
+    const auto base = static_cast<uint32_t>(vertexBase);
+
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        const uint8_t *p = primitive.positions.data + (v * primitive.positions.stride);
+        vertices[v].position = {ReadF32(p), ReadF32(p + 4), ReadF32(p + 8)};
+        if (primitive.normals.data)
+        {
+            const uint8_t *n = primitive.normals.data + (v * primitive.normals.stride);
+            vertices[v].normal = {ReadF32(n), ReadF32(n + 4), ReadF32(n + 8)};
+        }
+        // glTF already has its UV origin at the top left, like D3D
+        if (primitive.uvs.data)
+        {
+            const uint8_t *t = primitive.uvs.data + (v * primitive.uvs.stride);
+            const int type = primitive.uvs.componentType;
+            const size_t componentSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(type));
+            vertices[v].uv = {ReadUnitComponent(t, type), ReadUnitComponent(t + componentSize, type)};
+        }
+        else
+        {
+            vertices[v].uv = {0.0f, 0.0f};
+        }
+    }
+
+    for (size_t i = 0; i < primitive.indexCount; ++i)
+    {
+        uint32_t index = static_cast<uint32_t>(i);
+        if (primitive.indices.data)
+        {
+            const uint8_t *p = primitive.indices.data + (i * primitive.indices.stride);
+            switch (primitive.indices.componentType)
+            {
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                index = *p;
+                break;
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                index = ReadU16(p);
+                break;
+            default:
+                index = ReadU32(p);
+                break;
+            }
+        }
+        if (index >= vertexCount)
+            return false;
+        indices[i] = base + index;
+    }
+
+    if (!primitive.normals.data)
+        ComputeVertexNormals(vertices, vertexCount, indices, primitive.indexCount, base);
+
+    // Left-handed: mirror z and reverse the winding
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        vertices[v].position.z = -vertices[v].position.z;
+        vertices[v].normal.z = -vertices[v].normal.z;
+    }
+    for (size_t i = 0; i < primitive.indexCount; i += 3)
+        std::swap(indices[i], indices[i + 2]);
+    return true;
+}
+
+bool HasExtension(const std::string &hint, const char *extension)
+{
+    const size_t length = std::strlen(extension);
+    if (hint.size() < length)
+        return false;
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(hint[hint.size() - length + i])) != extension[i])
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool NativeModelLoader::Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData)
+{
+    if (!data || size < 4)
+        return false;
+    if (std::memcmp(data, "glTF", 4) == 0)
+        return LoadGLB(data, size, outData);
+    if (HasExtension(hint, ".3ds") && ReadU16(data) == CHUNK_MAIN)
+        return Load3DS(data, size, outData);
+    return false;
+}
+
+bool NativeModelLoader::Load3DS(const uint8_t *data, size_t size, MeshData &outData)
+{
+    outData = MeshData();
+    const uint8_t *cursor = data;
+    Chunk main;
+    if (!ReadChunk(cursor, data + size, main) || main.id != CHUNK_MAIN)
+        return false;
+
+    std::vector<Mesh3DS> meshes;
+    std::vector<std::string> materials;
+    cursor = main.body;
+    Chunk chunk;
+    while (cursor < main.end)
+    {
+        if (!ReadChunk(cursor, main.end, chunk))
+            return false;
+        if (chunk.id == CHUNK_EDITOR && !ParseEditor(chunk, meshes, materials))
+            return false;
+    }
+
+    size_t corners = 0;
+    for (const auto &mesh : meshes)
+    {
+        if (mesh.vertexCount == 0)
+            return false; // Faces referencing nothing
+        corners += mesh.faceCount * 3u;
+    }
+    if (corners == 0)
+        return false;
+
+    outData.vertices.resize(corners);
+    outData.indices.resize(corners);
+    size_t written = 0;
+    for (const auto &mesh : meshes)
+        Emit3DSMesh(mesh, materials, outData, written);
+    return true;
+}
+
+bool NativeModelLoader::LoadGLB(const uint8_t *data, size_t size, MeshData &outData)
+{
+    outData = MeshData();
+    tinygltf::TinyGLTF loader;
+    // Textures are not used by fixture meshes; skip decoding them
+    loader.SetImageLoader([](tinygltf::Image *, const int, std::string *, std::string *, int, int,
+                             const unsigned char *, int, void *) { return true; },
+                          nullptr);
+
+    tinygltf::Model model;
+    std::string error;
+    std::string warning;
+    if (!loader.LoadBinaryFromMemory(&model, &error, &warning, data, static_cast<unsigned int>(size)))
+        return false;
+    if (!model.extensionsRequired.empty())
+        return false;
+
+    std::vector<Primitive> primitives;
+    if (!CollectPrimitives(model, primitives) || primitives.empty())
+        return false;
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto &primitive : primitives)
+    {
+        vertexCount += primitive.positions.count;
+        indexCount += primitive.indexCount;
+    }
+    if (vertexCount > UINT32_MAX)
+        return false;
+
+    outData.vertices.resize(vertexCount);
+    outData.indices.resize(indexCount);
+    size_t vertexBase = 0;
+    size_t indexBase = 0;
+    for (const auto &primitive : primitives)
+    {
+        if (!EmitPrimitive(primitive, outData, vertexBase, indexBase))
+        {
+            outData = MeshData();
+            return false;
+        }
+
+        ShapeInfo shape;
+        shape.name = primitive.name;
+        shape.startIndex = static_cast<uint32_t>(indexBase);
+        shape.indexCount = static_cast<uint32_t>(primitive.indexCount);
+        outData.shapes.push_back(std::move(shape));
+
+        vertexBase += primitive.positions.count;
+        indexBase += primitive.indexCount;
+    }
+    return true;
+}
+
+void NativeModelLoader::ScalePositions(Vertex *vertices, size_t count, float scale, XMFLOAT3 &outMin,
+                                       XMFLOAT3 &outMax)
+{
+    if (count == 0)
+    {
+        outMin = {0.0f, 0.0f, 0.0f};
+        outMax = {0.0f, 0.0f, 0.0f};
+        return;
+    }
+
+    const XMVECTOR s = XMVectorReplicate(scale);
+    XMVECTOR lo = XMVectorReplicate(FLT_MAX);
+    XMVECTOR hi = XMVectorReplicate(-FLT_MAX);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const XMVECTOR p = XMVectorMultiply(XMLoadFloat3(&vertices[i].position), s);
+        XMStoreFloat3(&vertices[i].position, p);
+        lo = XMVectorMin(lo, p);
+        hi = XMVectorMax(hi, p);
+    }
+    XMStoreFloat3(&outMin, lo);
+    XMStoreFloat3(&outMax, hi);
+}
+
+} // namespace GDTF
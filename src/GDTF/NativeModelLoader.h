@@ -0,0 +1,83 @@
+/**
+ * @file NativeModelLoader.h
+ * @brief Assimp-free loading of the model formats GDTF archives ship (3DS and binary glTF).
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../Resources/MeshData.h"
+
+namespace GDTF
+{
+
+/**
+ * @class NativeModelLoader
+ * @brief Parses 3DS chunk streams and GLB containers straight into MeshData.
+ *
+ * The output matches what ModelLoader used to get from Assimp with
+ * Triangulate | GenSmoothNormals | ConvertToLeftHanded: one shape per mesh (3DS meshes are
+ * split per material), z mirrored with the winding flipped, and 3DS UVs flipped vertically.
+ * Positions are left in file units; node transforms are ignored like the Assimp path does.
+ * Anything this loader does not understand makes it return false so the caller can fall back
+ * to Assimp.
+ */
+class NativeModelLoader
+{
+public:
+    /// GDTF models are authored in millimeters; the renderer works in meters.
+    static constexpr float MILLIMETERS_TO_METERS = 0.001f;
+
+    /**
+     * @brief Loads a 3DS or GLB model, picking the parser from the hint and the data's magic.
+     *
+     * @param data Raw file contents.
+     * @param size Size of data in bytes.
+     * @param hint File name or extension (e.g., "models/3ds/base.3ds", ".glb").
+     * @param outData Receives vertices, triangle list indices and one shape per sub-mesh.
+     * @return true if the format is supported and the data parsed cleanly.
+     */
+    static bool Load(const uint8_t *data, size_t size, const std::string &hint, MeshData &outData);
+
+    /**
+     * @brief Loads a 3DS chunk stream.
+     *
+     * Vertices are de-indexed per face corner and normals come from the face smoothing groups.
+     *
+     * @param data Raw file contents.
+     * @param size Size of data in bytes.
+     * @param outData Receives the mesh.
+     * @return true on success, false for malformed or empty files.
+     */
+    static bool Load3DS(const uint8_t *data, size_t size, MeshData &outData);
+
+    /**
+     * @brief Loads a binary glTF 2.0 container with all buffers embedded.
+     *
+     * Only triangle-list primitives with float positions are accepted; files that need
+     * extensions, sparse accessors or external buffers are rejected.
+     *
+     * @param data Raw file contents.
+     * @param size Size of data in bytes.
+     * @param outData Receives the mesh.
+     * @return true on success.
+     */
+    static bool LoadGLB(const uint8_t *data, size_t size, MeshData &outData);
+
+    /**
+     * @brief Scales positions in place and computes their bounds in the same pass.
+     *
+     * @param vertices Vertex array.
+     * @param count Number of vertices.
+     * @param scale Uniform scale applied to every position.
+     * @param outMin Receives the minimum corner of the scaled positions.
+     * @param outMax Receives the maximum corner of the scaled positions.
+     */
+    static void ScalePositions(Vertex *vertices, size_t count, float scale, DirectX::XMFLOAT3 &outMin,
+                               DirectX::XMFLOAT3 &outMax);
+};
+
+} // namespace GDTF
@@ -0,0 +1,396 @@
+#include "ClusterBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ClusterBuilder
+{
+
+namespace
+{
+
+/**
+ * @brief Front-face normal of a triangle (D3D clockwise winding), not normalized.
+ */
+DirectX::XMFLOAT3 FaceNormal(const DirectX::XMFLOAT3 &p0, const DirectX::XMFLOAT3 &p1, const DirectX::XMFLOAT3 &p2)
+{
+    const float e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+    const float e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+    return {(e1[1] * e2[2]) - (e1[2] * e2[1]), (e1[2] * e2[0]) - (e1[0] * e2[2]), (e1[0] * e2[1]) - (e1[1] * e2[0])};
+}
+
+/**
+ * @brief Accumulates one cluster's triangles until it is full or turns too far.
+ */
+struct ClusterAccumulator
+{
+    std::vector<uint32_t> vertices;
+    std::vector<DirectX::XMFLOAT3> normals;
+    DirectX::XMFLOAT3 normalSum = {0.0f, 0.0f, 0.0f};
+    uint32_t startIndex = 0;
+    uint32_t indexCount = 0;
+
+    void Reset(uint32_t start)
+    {
+        vertices.clear();
+        normals.clear();
+        normalSum = {0.0f, 0.0f, 0.0f};
+        startIndex = start;
+        indexCount = 0;
+    }
+};
+
+void Finish(const ClusterAccumulator &acc, const Vertex *vertices, uint32_t shape, std::vector<MeshCluster> &out)
+{
+    if (acc.indexCount == 0)
+        return;
+
+    MeshCluster cluster;
+    cluster.shape = shape;
+    cluster.startIndex = acc.startIndex;
+    cluster.indexCount = acc.indexCount;
+
+    // Sphere around the box center
+    DirectX::XMFLOAT3 lo = vertices[acc.vertices[0]].position;
+    DirectX::XMFLOAT3 hi = lo;
+    for (uint32_t v : acc.vertices)
+    {
+        const DirectX::XMFLOAT3 &p = vertices[v].position;
+        lo = {(std::min)(lo.x, p.x), (std::min)(lo.y, p.y), (std::min)(lo.z, p.z)};
+        hi = {(std::max)(hi.x, p.x), (std::max)(hi.y, p.y), (std::max)(hi.z, p.z)};
+    }
+    const DirectX::XMFLOAT3 center = {(lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f};
+    float radiusSq = 0.0f;
+    for (uint32_t v : acc.vertices)
+    {
+        const DirectX::XMFLOAT3 &p = vertices[v].position;
+        const float dx = p.x - center.x;
+        const float dy = p.y - center.y;
+        const float dz = p.z - center.z;
+        radiusSq = (std::max)(radiusSq, (dx * dx) + (dy * dy) + (dz * dz));
+    }
+    cluster.sphere = {center.x, center.y, center.z, std::sqrt(radiusSq)};
+
+    // Normal cone; degenerate triangles have no facing and are ignored
+    const DirectX::XMFLOAT3 &s = acc.normalSum;
+    const float length = std::sqrt((s.x * s.x) + (s.y * s.y) + (s.z * s.z));
+    if (length > 0.0f && !acc.normals.empty())
+    {
+        const DirectX::XMFLOAT3 axis = {s.x / length, s.y / length, s.z / length};
+        float minDot = 1.0f;
+        for (const auto &n : acc.normals)
+            minDot = (std::min)(minDot, (n.x * axis.x) + (n.y * axis.y) + (n.z * axis.z));
+        const float cutoff = minDot > MIN_CONE_COS ? std::sqrt(1.0f - (minDot * minDot)) : 1.0f;
+        cluster.cone = {axis.x, axis.y, axis.z, cutoff};
+    }
+    out.push_back(cluster);
+}
+
+/**
+ * @brief Index (0-5 for +X, -X, +Y, -Y, +Z, -Z) of the axis closest to a direction.
+ */
+uint8_t DominantAxis(const DirectX::XMFLOAT3 &d)
+{
+    const float ax = std::abs(d.x);
+    const float ay = std::abs(d.y);
+    const float az = std::abs(d.z);
+    if (ax >= ay && ax >= az)
+        return d.x >= 0.0f ? 0 : 1;
+    if (ay >= az)
+        return d.y >= 0.0f ? 2 : 3;
+    return d.z >= 0.0f ? 4 : 5;
+}
+
+/**
+ * @brief Greedy grouping of one shape's triangles (indices relative to baseVertex).
+ *
+ * Groups are emitted in growth order and use the same limits as Build(), so Build() cuts the
+ * reordered indices back into (almost exactly) these groups.
+ */
+void GroupShape(const std::vector<Vertex> &vertices, int32_t baseVertex, uint32_t *indices, uint32_t triangleCount)
+{
+    if (triangleCount < 2)
+        return;
+    auto vertexOf = [&](uint32_t corner) { return static_cast<uint32_t>(static_cast<int64_t>(indices[corner]) + baseVertex); };
+
+    // Split vertices along hard edges still share a position, so connectivity uses position ids
+    std::vector<uint32_t> corners(static_cast<size_t>(triangleCount) * 3);
+    for (uint32_t i = 0; i < corners.size(); ++i)
+        corners[i] = i;
+    auto positionLess = [&](uint32_t a, uint32_t b)
+    {
+        const DirectX::XMFLOAT3 &pa = vertices[vertexOf(a)].position;
+        const DirectX::XMFLOAT3 &pb = vertices[vertexOf(b)].position;
+        if (pa.x != pb.x)
+            return pa.x < pb.x;
+        if (pa.y != pb.y)
+            return pa.y < pb.y;
+        return pa.z < pb.z;
+    };
+    std::sort(corners.begin(), corners.end(), positionLess);
+    std::vector<uint32_t> cornerPosition(corners.size());
+    uint32_t positionCount = 0;
+    for (size_t i = 0; i < corners.size(); ++i)
+    {
+        if (i > 0 && positionLess(corners[i - 1], corners[i]))
+            ++positionCount;
+        cornerPosition[corners[i]] = positionCount;
+    }
+    ++positionCount;
+
+    // Triangles around each position (CSR)
+    std::vector<uint32_t> offsets(positionCount + 1, 0);
+    for (uint32_t p : cornerPosition)
+        ++offsets[p + 1];
+    for (uint32_t p = 0; p < positionCount; ++p)
+        offsets[p + 1] += offsets[p];
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    std::vector<uint32_t> around(corners.size());
+    for (uint32_t c = 0; c < corners.size(); ++c)
+        around[fill[cornerPosition[c]]++] = c / 3;
+
+    std::vector<DirectX::XMFLOAT3> normals(triangleCount);
+    std::vector<DirectX::XMFLOAT3> centroids(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const DirectX::XMFLOAT3 &p0 = vertices[vertexOf(t * 3)].position;
+        const DirectX::XMFLOAT3 &p1 = vertices[vertexOf((t * 3) + 1)].position;
+        const DirectX::XMFLOAT3 &p2 = vertices[vertexOf((t * 3) + 2)].position;
+        DirectX::XMFLOAT3 n = FaceNormal(p0, p1, p2);
+        const float length = std::sqrt((n.x * n.x) + (n.y * n.y) + (n.z * n.z));
+        normals[t] = length > 0.0f ? DirectX::XMFLOAT3(n.x / length, n.y / length, n.z / length)
+                                   : DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        centroids[t] = {(p0.x + p1.x + p2.x) / 3.0f, (p0.y + p1.y + p2.y) / 3.0f, (p0.z + p1.z + p2.z) / 3.0f};
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> queued(triangleCount, UINT32_MAX);
+    std::vector<uint32_t> vertexStamp(vertices.size(), UINT32_MAX);
+    std::vector<uint32_t> order;
+    order.reserve(triangleCount);
+    std::vector<uint32_t> group;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> groupStarts;
+    std::vector<uint8_t> groupFacing;
+    uint32_t groupId = 0;
+    uint32_t nextSeed = 0;
+
+    while (order.size() < triangleCount)
+    {
+        while (emitted[nextSeed])
+            ++nextSeed;
+
+        group.clear();
+        candidates.clear();
+        DirectX::XMFLOAT3 normalSum = {0.0f, 0.0f, 0.0f};
+        DirectX::XMFLOAT3 centroidSum = {0.0f, 0.0f, 0.0f};
+        uint32_t vertexCount = 0;
+
+        auto add = [&](uint32_t t)
+        {
+            emitted[t] = 1;
+            group.push_back(t);
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const uint32_t v = vertexOf((t * 3) + k);
+                if (vertexStamp[v] != groupId)
+                {
+                    vertexStamp[v] = groupId;
+                    ++vertexCount;
+                }
+                const uint32_t p = cornerPosition[(t * 3) + k];
+                for (uint32_t i = offsets[p]; i < offsets[p + 1]; ++i)
+                {
+                    if (!emitted[around[i]] && queued[around[i]] != groupId)
+                    {
+                        queued[around[i]] = groupId;
+                        candidates.push_back(around[i]);
+                    }
+                }
+            }
+            normalSum = {normalSum.x + normals[t].x, normalSum.y + normals[t].y, normalSum.z + normals[t].z};
+            centroidSum = {centroidSum.x + centroids[t].x, centroidSum.y + centroids[t].y,
+                           centroidSum.z + centroids[t].z};
+        };
+
+        add(nextSeed);
+        while (group.size() < MAX_TRIANGLES)
+        {
+            const float sumLength =
+                std::sqrt((normalSum.x * normalSum.x) + (normalSum.y * normalSum.y) + (normalSum.z * normalSum.z));
+            const float inverseCount = 1.0f / static_cast<float>(group.size());
+            const DirectX::XMFLOAT3 center = {centroidSum.x * inverseCount, centroidSum.y * inverseCount,
+                                              centroidSum.z * inverseCount};
+
+            // Fewest new vertices first, then nearest to the group
+            size_t best = SIZE_MAX;
+            uint32_t bestNew = 4;
+            float bestDistance = 0.0f;
+            for (size_t c = 0; c < candidates.size();)
+            {
+                const uint32_t t = candidates[c];
+                if (emitted[t])
+                {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                ++c;
+
+                const DirectX::XMFLOAT3 &n = normals[t];
+                if (sumLength > 0.0f && (n.x != 0.0f || n.y != 0.0f || n.z != 0.0f) &&
+                    ((n.x * normalSum.x) + (n.y * normalSum.y) + (n.z * normalSum.z)) < MIN_NORMAL_COS * sumLength)
+                    continue;
+
+                uint32_t newVertices = 0;
+                for (uint32_t k = 0; k < 3; ++k)
+                    newVertices += vertexStamp[vertexOf((t * 3) + k)] != groupId ? 1 : 0;
+                if (vertexCount + newVertices > MAX_VERTICES)
+                    continue;
+
+                const float dx = centroids[t].x - center.x;
+                const float dy = centroids[t].y - center.y;
+                const float dz = centroids[t].z - center.z;
+                const float distance = (dx * dx) + (dy * dy) + (dz * dz);
+                if (newVertices < bestNew || (newVertices == bestNew && distance < bestDistance))
+                {
+                    best = c - 1;
+                    bestNew = newVertices;
+                    bestDistance = distance;
+                }
+            }
+            if (best == SIZE_MAX)
+                break;
+            add(candidates[best]);
+        }
+
+        groupStarts.push_back(static_cast<uint32_t>(order.size()));
+        groupFacing.push_back(DominantAxis(normalSum));
+        order.insert(order.end(), group.begin(), group.end());
+        ++groupId;
+    }
+    groupStarts.push_back(triangleCount);
+
+    // Groups facing the same way go next to each other, so the groups a viewpoint culls tend
+    // to form long runs that leave few, large draw ranges
+    std::vector<uint32_t> groupOrder(groupFacing.size());
+    for (uint32_t g = 0; g < groupOrder.size(); ++g)
+        groupOrder[g] = g;
+    std::stable_sort(groupOrder.begin(), groupOrder.end(),
+                     [&](uint32_t a, uint32_t b) { return groupFacing[a] < groupFacing[b]; });
+    std::vector<uint32_t> sorted;
+    sorted.reserve(triangleCount);
+    for (uint32_t g : groupOrder)
+        sorted.insert(sorted.end(), order.begin() + groupStarts[g], order.begin() + groupStarts[g + 1]);
+    order.swap(sorted);
+
+    std::vector<uint32_t> original(indices, indices + (static_cast<size_t>(triangleCount) * 3));
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+            indices[(i * 3) + k] = original[(static_cast<size_t>(order[i]) * 3) + k];
+    }
+}
+
+} // namespace
+
+void GroupTriangles(MeshData &mesh)
+{
+    if (mesh.shapes.empty())
+    {
+        GroupShape(mesh.vertices, 0, mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size() / 3));
+        return;
+    }
+    for (const auto &shape : mesh.shapes)
+    {
+        if (static_cast<size_t>(shape.startIndex) + shape.indexCount <= mesh.indices.size())
+            GroupShape(mesh.vertices, shape.baseVertex, mesh.indices.data() + shape.startIndex, shape.indexCount / 3);
+    }
+}
+
+std::vector<MeshCluster> Build(const PackedMeshView &view)
+{
+    std::vector<MeshCluster> clusters;
+    const size_t levelCount = (std::max)(view.levelCount, size_t(1));
+    const size_t rangeCount = view.rangeCount / levelCount;
+    if (!view.vertices || !view.indexBytes)
+        return clusters;
+
+    // Per-vertex stamp of the last cluster that used it, to count distinct vertices
+    std::vector<uint32_t> stamp(view.vertexCount, UINT32_MAX);
+    uint32_t clusterId = 0;
+
+    ClusterAccumulator acc;
+    for (size_t r = 0; r < rangeCount; ++r)
+    {
+        const IndexRange &range = view.ranges[r];
+        auto fetch = [&](uint32_t i) { return ReadPackedIndex(view, range, i); };
+
+        acc.Reset(0);
+        for (uint32_t i = 0; i + 2 < range.indexCount; i += 3)
+        {
+            const uint32_t tri[3] = {fetch(i), fetch(i + 1), fetch(i + 2)};
+            if (tri[0] >= view.vertexCount || tri[1] >= view.vertexCount || tri[2] >= view.vertexCount)
+                continue;
+
+            DirectX::XMFLOAT3 n = FaceNormal(view.vertices[tri[0]].position, view.vertices[tri[1]].position,
+                                             view.vertices[tri[2]].position);
+            const float length = std::sqrt((n.x * n.x) + (n.y * n.y) + (n.z * n.z));
+            if (length > 0.0f)
+                n = {n.x / length, n.y / length, n.z / length};
+
+            uint32_t newVertices = 0;
+            for (uint32_t v : tri)
+                newVertices += stamp[v] != clusterId ? 1 : 0;
+
+            // A triangle touching none of the cluster's positions starts a new one
+            bool connected = newVertices < 3;
+            for (uint32_t k = 0; k < 3 && !connected; ++k)
+            {
+                const DirectX::XMFLOAT3 &p = view.vertices[tri[k]].position;
+                for (uint32_t v : acc.vertices)
+                {
+                    const DirectX::XMFLOAT3 &q = view.vertices[v].position;
+                    if (p.x == q.x && p.y == q.y && p.z == q.z)
+                    {
+                        connected = true;
+                        break;
+                    }
+                }
+            }
+
+            bool turns = false;
+            const DirectX::XMFLOAT3 &s = acc.normalSum;
+            const float sumLength = std::sqrt((s.x * s.x) + (s.y * s.y) + (s.z * s.z));
+            if (length > 0.0f && sumLength > 0.0f)
+                turns = ((n.x * s.x) + (n.y * s.y) + (n.z * s.z)) < MIN_NORMAL_COS * sumLength;
+
+            if (acc.indexCount > 0 && (acc.indexCount / 3 >= MAX_TRIANGLES ||
+                                       acc.vertices.size() + newVertices > MAX_VERTICES || turns || !connected))
+            {
+                Finish(acc, view.vertices, static_cast<uint32_t>(r), clusters);
+                acc.Reset(i);
+                ++clusterId;
+            }
+
+            for (uint32_t v : tri)
+            {
+                if (stamp[v] != clusterId)
+                {
+                    stamp[v] = clusterId;
+                    acc.vertices.push_back(v);
+                }
+            }
+            if (length > 0.0f)
+            {
+                acc.normals.push_back(n);
+                acc.normalSum = {acc.normalSum.x + n.x, acc.normalSum.y + n.y, acc.normalSum.z + n.z};
+            }
+            acc.indexCount = i + 3 - acc.startIndex;
+        }
+        Finish(acc, view.vertices, static_cast<uint32_t>(r), clusters);
+        ++clusterId;
+    }
+    return clusters;
+}
+
+} // namespace ClusterBuilder
@@ -0,0 +1,57 @@
+/**
+ * @file ClusterBuilder.h
+ * @brief Splits meshes into small triangle clusters with bounding spheres and normal cones.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Resources/MeshData.h"
+
+/**
+ * @namespace ClusterBuilder
+ * @brief Load-time partitioning used by the CPU cluster culler.
+ *
+ * Clusters are cut from each shape's triangles in index order, so they stay contiguous index
+ * ranges of the existing index buffer and need no extra GPU data. GroupTriangles() arranges
+ * that order at load time so the cuts follow connected surfaces of similar facing.
+ */
+namespace ClusterBuilder
+{
+
+/// Largest number of triangles in one cluster.
+constexpr uint32_t MAX_TRIANGLES = 128;
+
+/// Largest number of distinct vertices in one cluster.
+constexpr uint32_t MAX_VERTICES = 96;
+
+/// A cluster is closed early when a triangle faces more than ~60 degrees away from its average
+/// normal, or touches none of its vertices.
+constexpr float MIN_NORMAL_COS = 0.5f;
+
+/// Normal cones wider than this (smallest normal dot axis) cannot be back-face culled.
+constexpr float MIN_CONE_COS = 0.1f;
+
+/**
+ * @brief Reorders each shape's triangles into connected groups of similar facing.
+ *
+ * Clusters are cut along the index order, so this runs at load time before the indices are
+ * packed: each group grows from a seed through triangles sharing a position, preferring those
+ * that add the fewest vertices and stay closest, within the cluster limits above. Triangles
+ * keep their relative (vertex cache) order inside a group. Only the full-detail level changes.
+ *
+ * @param mesh Mesh processed by MeshOptimizer::ProcessMesh, reordered in place.
+ */
+void GroupTriangles(MeshData &mesh);
+
+/**
+ * @brief Builds clusters for the full-detail level of a packed mesh.
+ *
+ * @param view Vertex array, packed indices and shape ranges (only the first level is used).
+ * @return Clusters in shape order, then index order.
+ */
+std::vector<MeshCluster> Build(const PackedMeshView &view);
+
+} // namespace ClusterBuilder
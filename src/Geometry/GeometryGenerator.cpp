@@ -430,4 +430,46 @@ bool CreateFullScreenQuad(ID3D11Device *device, ComPtr<ID3D11Buffer> &outVb)
     return SUCCEEDED(hr);
 }
 
+MeshData CreateBoxMesh(const DirectX::XMFLOAT3 &boxMin, const DirectX::XMFLOAT3 &boxMax, const MaterialData &material)
+{
+    const float lo[3] = {boxMin.x, boxMin.y, boxMin.z};
+    const float hi[3] = {boxMax.x, boxMax.y, boxMax.z};
+
+    MeshData data;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            // Axes across the face, ordered so its corners run clockwise seen from outside
+            const int u = (axis + (side ? 1 : 2)) % 3;
+            const int v = (axis + (side ? 2 : 1)) % 3;
+            const auto base = static_cast<uint32_t>(data.vertices.size());
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                const bool uHigh = corner == 1 || corner == 2;
+                const bool vHigh = corner >= 2;
+                float position[3];
+                float normal[3] = {0.0f, 0.0f, 0.0f};
+                position[axis] = side ? hi[axis] : lo[axis];
+                position[u] = uHigh ? hi[u] : lo[u];
+                position[v] = vHigh ? hi[v] : lo[v];
+                normal[axis] = side ? 1.0f : -1.0f;
+                data.vertices.push_back({{position[0], position[1], position[2]},
+                                         {normal[0], normal[1], normal[2]},
+                                         {uHigh ? 1.0f : 0.0f, vHigh ? 1.0f : 0.0f}});
+            }
+            data.indices.insert(data.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+    }
+
+    ShapeInfo shape;
+    shape.name = "Box";
+    shape.center = {(boxMin.x + boxMax.x) * 0.5f, (boxMin.y + boxMax.y) * 0.5f, (boxMin.z + boxMax.z) * 0.5f};
+    shape.material = material;
+    shape.indexCount = static_cast<uint32_t>(data.indices.size());
+    data.shapes.push_back(shape);
+    data.minY = boxMin.y;
+    return data;
+}
+
 } // namespace GeometryGenerator
\ No newline at end of file
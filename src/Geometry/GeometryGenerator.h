@@ -70,4 +70,14 @@ bool CreateSphere(ID3D11Device *device, ComPtr<ID3D11Buffer> &outVb, ComPtr<ID3D
  */
 bool CreateFullScreenQuad(ID3D11Device *device, ComPtr<ID3D11Buffer> &outVb);
 
+/**
+ * @brief Builds an axis-aligned box as a single-shape mesh, with flat outward normals.
+ *
+ * @param boxMin Minimum corner.
+ * @param boxMax Maximum corner.
+ * @param material Material of the box's shape.
+ * @return The box geometry (24 vertices, 36 indices), ready for Mesh::Create().
+ */
+MeshData CreateBoxMesh(const DirectX::XMFLOAT3 &boxMin, const DirectX::XMFLOAT3 &boxMax, const MaterialData &material);
+
 } // namespace GeometryGenerator
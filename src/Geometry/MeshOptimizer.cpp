@@ -0,0 +1,439 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace MeshOptimizer
+{
+
+namespace
+{
+
+// Forsyth's "Linear-Speed Vertex Cache Optimisation" tuning constants
+constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRI_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+/**
+ * @brief Bitwise key of a vertex, with -0.0 folded into +0.0 so both weld together.
+ */
+struct VertexKey
+{
+    uint32_t bits[8];
+
+    bool operator==(const VertexKey &other) const
+    {
+        return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+};
+
+struct VertexKeyHash
+{
+    size_t operator()(const VertexKey &key) const
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (uint32_t b : key.bits)
+        {
+            h ^= b;
+            h *= 0x100000001b3ull;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+VertexKey MakeKey(const Vertex &v)
+{
+    const float values[8] = {v.position.x, v.position.y, v.position.z, v.normal.x,
+                             v.normal.y,   v.normal.z,   v.uv.x,       v.uv.y};
+    VertexKey key = {};
+    for (int i = 0; i < 8; ++i)
+    {
+        float f = values[i] == 0.0f ? 0.0f : values[i];
+        std::memcpy(&key.bits[i], &f, sizeof(float));
+    }
+    return key;
+}
+
+/**
+ * @brief Welds the vertices referenced by an index range into a new local vertex array.
+ */
+void WeldRange(const std::vector<Vertex> &src, const uint32_t *indices, size_t count, int32_t baseVertex,
+               std::vector<Vertex> &outVertices, std::vector<uint32_t> &outIndices)
+{
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> lookup;
+    lookup.reserve(count);
+    outVertices.clear();
+    outVertices.reserve(count);
+    outIndices.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vertex &v = src[static_cast<size_t>(static_cast<int64_t>(indices[i]) + baseVertex)];
+        auto result = lookup.emplace(MakeKey(v), static_cast<uint32_t>(outVertices.size()));
+        if (result.second)
+            outVertices.push_back(v);
+        outIndices[i] = result.first->second;
+    }
+}
+
+float VertexScore(int32_t cachePosition, uint32_t activeTris)
+{
+    if (activeTris == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+        {
+            // The most recent triangle's vertices get a fixed score so that the
+            // next triangle doesn't simply reuse the same edge every time.
+            score = LAST_TRI_SCORE;
+        }
+        else
+        {
+            const float scaler = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+            score = 1.0f - (static_cast<float>(cachePosition - 3) * scaler);
+            score = std::pow(score, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Boost vertices with few remaining triangles so lone triangles are not left behind
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(activeTris), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+void WeldVertices(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+    std::vector<Vertex> welded;
+    std::vector<uint32_t> remapped;
+    WeldRange(vertices, indices.data(), indices.size(), 0, welded, remapped);
+    vertices = std::move(welded);
+    indices = std::move(remapped);
+}
+
+void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0 || vertexCount == 0)
+        return;
+
+    // Vertex -> triangle adjacency, stored as one flat list with per-vertex offsets
+    std::vector<uint32_t> activeTris(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        activeTris[indices[i]]++;
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + activeTris[v];
+
+    std::vector<uint32_t> triList(offsets[vertexCount]);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                triList[fill[indices[(t * 3) + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<int32_t> cachePos(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = VertexScore(-1, activeTris[v]);
+
+    std::vector<float> triScore(triCount);
+    std::vector<bool> emitted(triCount, false);
+    int64_t bestTri = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[(t * 3) + 1]] +
+                      vertexScore[indices[(t * 3) + 2]];
+        if (triScore[t] > bestScore)
+        {
+            bestScore = triScore[t];
+            bestTri = static_cast<int64_t>(t);
+        }
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(triCount * 3);
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    size_t scanCursor = 0;
+
+    while (output.size() < triCount * 3)
+    {
+        if (bestTri < 0)
+        {
+            // Nothing in the cache has remaining triangles; resume from the next unemitted one
+            while (emitted[scanCursor])
+                ++scanCursor;
+            bestTri = static_cast<int64_t>(scanCursor);
+        }
+
+        const auto tri = static_cast<size_t>(bestTri);
+        emitted[tri] = true;
+        const uint32_t triVerts[3] = {indices[tri * 3], indices[(tri * 3) + 1], indices[(tri * 3) + 2]};
+
+        for (uint32_t v : triVerts)
+        {
+            output.push_back(v);
+
+            // Remove the triangle from the vertex's active list
+            uint32_t *begin = triList.data() + offsets[v];
+            uint32_t *end = begin + activeTris[v];
+            uint32_t *it = std::find(begin, end, static_cast<uint32_t>(tri));
+            std::swap(*it, *(end - 1));
+            activeTris[v]--;
+        }
+
+        // Emitted vertices move to the front of the cache, others shift back
+        newCache.clear();
+        for (uint32_t v : triVerts)
+        {
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                newCache.push_back(v);
+        }
+        for (uint32_t v : cache)
+        {
+            if (v != triVerts[0] && v != triVerts[1] && v != triVerts[2])
+                newCache.push_back(v);
+        }
+
+        for (size_t i = 0; i < newCache.size(); ++i)
+        {
+            uint32_t v = newCache[i];
+            cachePos[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = VertexScore(cachePos[v], activeTris[v]);
+        }
+
+        bestTri = -1;
+        bestScore = -1.0f;
+        for (uint32_t v : newCache)
+        {
+            for (uint32_t k = 0; k < activeTris[v]; ++k)
+            {
+                uint32_t t = triList[offsets[v] + k];
+                float score = vertexScore[indices[static_cast<size_t>(t) * 3]] +
+                              vertexScore[indices[(static_cast<size_t>(t) * 3) + 1]] +
+                              vertexScore[indices[(static_cast<size_t>(t) * 3) + 2]];
+                triScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTri = t;
+                }
+            }
+        }
+
+        if (newCache.size() > FORSYTH_CACHE_SIZE)
+            newCache.resize(FORSYTH_CACHE_SIZE);
+        std::swap(cache, newCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+    constexpr uint32_t unassigned = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(vertices.size(), unassigned);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (auto &index : indices)
+    {
+        if (remap[index] == unassigned)
+        {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+}
+
+float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0)
+        return 0.0f;
+
+    // FIFO cache simulated with insertion timestamps: a vertex is resident if it was
+    // inserted fewer than cacheSize misses ago.
+    std::vector<uint64_t> insertedAt(vertexCount, 0);
+    uint64_t misses = 0;
+    for (size_t i = 0; i < triCount * 3; ++i)
+    {
+        uint32_t v = indices[i];
+        if (insertedAt[v] == 0 || misses - insertedAt[v] >= cacheSize)
+        {
+            misses++;
+            insertedAt[v] = misses;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(triCount);
+}
+
+Stats ProcessMesh(MeshData &mesh)
+{
+    Stats stats;
+    stats.verticesBefore = mesh.vertices.size();
+
+    const bool hasShapes = !mesh.shapes.empty();
+    if (!hasShapes)
+    {
+        ShapeInfo whole;
+        whole.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        mesh.shapes.push_back(whole);
+    }
+
+    // ACMR of the incoming order, evaluated on absolute vertex indices
+    {
+        std::vector<uint32_t> absolute;
+        absolute.reserve(mesh.indices.size());
+        for (const auto &shape : mesh.shapes)
+        {
+            uint32_t end = (std::min)(shape.startIndex + shape.indexCount, static_cast<uint32_t>(mesh.indices.size()));
+            for (uint32_t i = shape.startIndex; i < end; ++i)
+                absolute.push_back(static_cast<uint32_t>(static_cast<int64_t>(mesh.indices[i]) + shape.baseVertex));
+        }
+        stats.acmrBefore = ComputeACMR(absolute, mesh.vertices.size());
+    }
+
+    std::vector<Vertex> outVertices;
+    std::vector<uint32_t> outIndices;
+    outVertices.reserve(mesh.vertices.size());
+    outIndices.reserve(mesh.indices.size());
+    std::vector<uint32_t> shapeVertexCounts;
+    shapeVertexCounts.reserve(mesh.shapes.size());
+
+    std::vector<Vertex> localVertices;
+    std::vector<uint32_t> localIndices;
+    for (auto &shape : mesh.shapes)
+    {
+        uint32_t start = (std::min)(shape.startIndex, static_cast<uint32_t>(mesh.indices.size()));
+        uint32_t count = (std::min)(shape.indexCount, static_cast<uint32_t>(mesh.indices.size()) - start);
+        count -= count % 3;
+
+        WeldRange(mesh.vertices, mesh.indices.data() + start, count, shape.baseVertex, localVertices, localIndices);
+        OptimizeVertexCache(localIndices, localVertices.size());
+        OptimizeVertexFetch(localVertices, localIndices);
+
+        shape.startIndex = static_cast<uint32_t>(outIndices.size());
+        shape.indexCount = count;
+        shape.baseVertex = static_cast<int32_t>(outVertices.size());
+        shapeVertexCounts.push_back(static_cast<uint32_t>(localVertices.size()));
+
+        outIndices.insert(outIndices.end(), localIndices.begin(), localIndices.end());
+        outVertices.insert(outVertices.end(), localVertices.begin(), localVertices.end());
+    }
+
+    // ACMR after optimization, on absolute indices
+    {
+        std::vector<uint32_t> absolute(outIndices.size());
+        for (const auto &shape : mesh.shapes)
+        {
+            for (uint32_t i = shape.startIndex; i < shape.startIndex + shape.indexCount; ++i)
+                absolute[i] = outIndices[i] + static_cast<uint32_t>(shape.baseVertex);
+        }
+        stats.acmrAfter = ComputeACMR(absolute, outVertices.size());
+    }
+
+    // Group consecutive shapes under a shared base vertex while their span fits in 16 bits.
+    // A shape larger than 64K vertices gets its own batch and keeps 32-bit indices.
+    int32_t batchBase = 0;
+    for (size_t s = 0; s < mesh.shapes.size(); ++s)
+    {
+        auto &shape = mesh.shapes[s];
+        const int32_t first = shape.baseVertex;
+        const int64_t spanEnd = static_cast<int64_t>(first) + shapeVertexCounts[s];
+        if (s == 0 || spanEnd - batchBase > static_cast<int64_t>(MAX_16BIT_VERTICES))
+        {
+            batchBase = first;
+            stats.batches++;
+        }
+
+        const auto offset = static_cast<uint32_t>(first - batchBase);
+        for (uint32_t i = shape.startIndex; i < shape.startIndex + shape.indexCount; ++i)
+            outIndices[i] += offset;
+        shape.baseVertex = batchBase;
+    }
+
+    mesh.vertices = std::move(outVertices);
+    mesh.indices = std::move(outIndices);
+    if (!hasShapes)
+        mesh.shapes.clear();
+
+    stats.verticesAfter = mesh.vertices.size();
+    stats.triangles = mesh.indices.size() / 3;
+    return stats;
+}
+
+void PackIndices(const std::vector<uint32_t> &indices, const std::vector<ShapeInfo> &shapes,
+                 std::vector<uint8_t> &outBytes, std::vector<IndexRange> &outRanges)
+{
+    const auto totalCount = static_cast<uint32_t>(indices.size());
+    std::vector<ShapeInfo> ranges = shapes;
+    if (ranges.empty())
+    {
+        ShapeInfo whole;
+        whole.indexCount = totalCount;
+        ranges.push_back(whole);
+    }
+
+    std::vector<uint16_t> narrow;
+    std::vector<uint32_t> wide;
+    outRanges.clear();
+    for (const auto &shape : ranges)
+    {
+        uint32_t start = (std::min)(shape.startIndex, totalCount);
+        uint32_t count = (std::min)(shape.indexCount, totalCount - start);
+        uint32_t maxIndex = count > 0 ? *std::max_element(indices.begin() + start, indices.begin() + start + count) : 0;
+
+        IndexRange range;
+        range.indexCount = count;
+        range.baseVertex = shape.baseVertex;
+        if (maxIndex <= 0xFFFF)
+        {
+            range.indexSize = sizeof(uint16_t);
+            range.startIndex = static_cast<uint32_t>(narrow.size());
+            for (uint32_t i = start; i < start + count; ++i)
+                narrow.push_back(static_cast<uint16_t>(indices[i]));
+        }
+        else
+        {
+            range.indexSize = sizeof(uint32_t);
+            range.startIndex = static_cast<uint32_t>(wide.size());
+            wide.insert(wide.end(), indices.begin() + start, indices.begin() + start + count);
+        }
+        outRanges.push_back(range);
+    }
+
+    // R32 section must start 4-byte aligned
+    const size_t narrowBytes = ((narrow.size() * sizeof(uint16_t)) + 3) & ~size_t(3);
+    outBytes.assign(narrowBytes + (wide.size() * sizeof(uint32_t)), 0);
+    if (!narrow.empty())
+        std::memcpy(outBytes.data(), narrow.data(), narrow.size() * sizeof(uint16_t));
+    if (!wide.empty())
+        std::memcpy(outBytes.data() + narrowBytes, wide.data(), wide.size() * sizeof(uint32_t));
+
+    for (auto &range : outRanges)
+    {
+        if (range.indexSize == sizeof(uint32_t))
+            range.byteOffset = static_cast<uint32_t>(narrowBytes);
+    }
+}
+
+} // namespace MeshOptimizer
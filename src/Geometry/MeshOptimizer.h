@@ -0,0 +1,107 @@
+/**
+ * @file MeshOptimizer.h
+ * @brief Vertex welding, vertex cache and vertex fetch optimization for loaded meshes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Resources/MeshData.h"
+
+/**
+ * @namespace MeshOptimizer
+ * @brief Post-load processing stage applied to stage and fixture meshes before GPU upload.
+ *
+ * Processing is done independently per shape range so that every shape ends up with a
+ * contiguous block of vertices. Consecutive shapes are then grouped under a common
+ * base vertex so their indices fit in 16 bits.
+ */
+namespace MeshOptimizer
+{
+
+/// Size of the FIFO cache used to report ACMR (matches common post-transform cache sizes).
+constexpr uint32_t ACMR_CACHE_SIZE = 16;
+
+/// Largest vertex span that can be addressed with 16-bit indices.
+constexpr uint32_t MAX_16BIT_VERTICES = 0x10000;
+
+/**
+ * @struct Stats
+ * @brief Before/after figures reported by ProcessMesh.
+ */
+struct Stats
+{
+    size_t verticesBefore = 0; ///< Vertex count of the input mesh.
+    size_t verticesAfter = 0;  ///< Vertex count after welding.
+    size_t triangles = 0;      ///< Triangle count (unchanged by processing).
+    float acmrBefore = 0.0f;   ///< Average cache miss ratio of the input index order.
+    float acmrAfter = 0.0f;    ///< Average cache miss ratio after cache optimization.
+    size_t batches = 0;        ///< Number of distinct base vertices after 16-bit batching.
+};
+
+/**
+ * @brief Merges vertices with bitwise identical position, normal and uv.
+ *
+ * @param vertices Input vertices; replaced by the unique vertices in first-use order.
+ * @param indices Triangle list indices; rewritten to reference the welded vertices.
+ */
+void WeldVertices(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+/**
+ * @brief Reorders triangles for post-transform vertex cache locality (Forsyth's algorithm).
+ *
+ * @param indices Triangle list indices, reordered in place.
+ * @param vertexCount Number of vertices referenced by the indices.
+ */
+void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+/**
+ * @brief Reorders vertices in the order they are first referenced by the index buffer.
+ *
+ * Unreferenced vertices are dropped.
+ *
+ * @param vertices Vertex array, reordered in place.
+ * @param indices Triangle list indices, remapped in place.
+ */
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+/**
+ * @brief Computes the average cache miss ratio (misses per triangle) for a FIFO cache.
+ *
+ * @param indices Triangle list indices.
+ * @param vertexCount Number of vertices referenced by the indices.
+ * @param cacheSize Number of entries in the simulated FIFO cache.
+ * @return Transformed vertices per triangle (0.5 is ideal for regular grids, 3.0 is worst case).
+ */
+float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize = ACMR_CACHE_SIZE);
+
+/**
+ * @brief Runs the full processing stage on a mesh.
+ *
+ * Each shape is welded, cache-optimized and fetch-optimized in isolation, then shapes are
+ * grouped into batches addressable with 16-bit indices by assigning ShapeInfo::baseVertex.
+ * Shape start indices and counts are updated; shape order, names and materials are preserved.
+ * A mesh without shapes is treated as a single shape.
+ *
+ * @param mesh The mesh to process in place.
+ * @return Vertex count and ACMR before and after processing.
+ */
+Stats ProcessMesh(MeshData &mesh);
+
+/**
+ * @brief Packs indices into the mixed 16/32-bit layout used by GPU index buffers.
+ *
+ * Shapes whose indices fit in 16 bits go to a leading R16 section, the rest to a trailing,
+ * 4-byte aligned R32 section. No shapes means a single range covering every index.
+ *
+ * @param indices Triangle list indices, relative to each shape's baseVertex.
+ * @param shapes Shape ranges into the index array.
+ * @param outBytes Receives the packed index data.
+ * @param outRanges Receives one range per shape, in shape order.
+ */
+void PackIndices(const std::vector<uint32_t> &indices, const std::vector<ShapeInfo> &shapes,
+                 std::vector<uint8_t> &outBytes, std::vector<IndexRange> &outRanges);
+
+} // namespace MeshOptimizer
@@ -0,0 +1,639 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include "MeshOptimizer.h"
+
+namespace MeshSimplifier
+{
+
+namespace
+{
+
+/// Extra weight of the planes that pin open borders and attribute seams in place.
+constexpr double BOUNDARY_WEIGHT = 10.0;
+
+/// A collapse is rejected when a surviving triangle's normal turns by more than ~75 degrees.
+constexpr double MIN_NORMAL_COS = 0.25;
+
+/// A level must drop at least this share of the previous level's triangles to be kept.
+constexpr float MIN_LEVEL_REDUCTION = 0.15f;
+
+enum class VertexKind : uint8_t
+{
+    Manifold, ///< Interior vertex, may collapse in any direction.
+    Border,   ///< On an open border, may only collapse along it.
+    Seam,     ///< On an attribute seam, may only collapse along it.
+    Locked    ///< Corner, non-manifold or otherwise fixed.
+};
+
+/**
+ * @brief Symmetric 4x4 error quadric, stored as its 10 unique coefficients plus a weight.
+ */
+struct Quadric
+{
+    double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+    double b0 = 0, b1 = 0, b2 = 0, c = 0;
+    double w = 0;
+
+    void AddPlane(double nx, double ny, double nz, double d, double weight)
+    {
+        a00 += weight * nx * nx;
+        a11 += weight * ny * ny;
+        a22 += weight * nz * nz;
+        a01 += weight * nx * ny;
+        a02 += weight * nx * nz;
+        a12 += weight * ny * nz;
+        b0 += weight * nx * d;
+        b1 += weight * ny * d;
+        b2 += weight * nz * d;
+        c += weight * d * d;
+        w += weight;
+    }
+
+    void Add(const Quadric &q)
+    {
+        a00 += q.a00;
+        a11 += q.a11;
+        a22 += q.a22;
+        a01 += q.a01;
+        a02 += q.a02;
+        a12 += q.a12;
+        b0 += q.b0;
+        b1 += q.b1;
+        b2 += q.b2;
+        c += q.c;
+        w += q.w;
+    }
+
+    /// Weighted mean squared distance of p to the accumulated planes.
+    [[nodiscard]] double Error(const DirectX::XMFLOAT3 &p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                   2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return w > 0.0 ? (std::max)(e, 0.0) / w : 0.0;
+    }
+};
+
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    double error;
+};
+
+/// Half-edge flags produced by ClassifyVertices.
+constexpr uint8_t EDGE_BORDER = 1;
+constexpr uint8_t EDGE_SEAM = 2;
+
+void Cross(const DirectX::XMFLOAT3 &p0, const DirectX::XMFLOAT3 &p1, const DirectX::XMFLOAT3 &p2, double out[3])
+{
+    const double e1[3] = {double(p1.x) - p0.x, double(p1.y) - p0.y, double(p1.z) - p0.z};
+    const double e2[3] = {double(p2.x) - p0.x, double(p2.y) - p0.y, double(p2.z) - p0.z};
+    out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+/**
+ * @brief Maps every vertex to the first referenced vertex with the same position.
+ *
+ * Also links vertices sharing a position into rings (wedges) so a collapse can move all
+ * attribute variants of a position together.
+ */
+void BuildPositionGroups(const Vertex *vertices, size_t vertexCount, const std::vector<uint32_t> &indices,
+                         std::vector<uint32_t> &remap, std::vector<uint32_t> &wedge)
+{
+    remap.assign(vertexCount, UINT32_MAX);
+    wedge.assign(vertexCount, UINT32_MAX);
+
+    struct PositionHash
+    {
+        size_t operator()(const DirectX::XMFLOAT3 &p) const
+        {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+    struct PositionEqual
+    {
+        bool operator()(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b) const
+        {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        }
+    };
+
+    std::unordered_map<DirectX::XMFLOAT3, uint32_t, PositionHash, PositionEqual> first;
+    first.reserve(indices.size() / 2);
+    for (uint32_t index : indices)
+    {
+        if (remap[index] != UINT32_MAX)
+            continue;
+        auto inserted = first.emplace(vertices[index].position, index);
+        const uint32_t canonical = inserted.first->second;
+        remap[index] = canonical;
+        if (canonical == index)
+        {
+            wedge[index] = index;
+        }
+        else
+        {
+            wedge[index] = wedge[canonical];
+            wedge[canonical] = index;
+        }
+    }
+}
+
+/**
+ * @brief Triangles around each position group, in CSR layout.
+ */
+struct Adjacency
+{
+    std::vector<uint32_t> offsets;   ///< First entry of each group in triangles (vertexCount + 1 entries).
+    std::vector<uint32_t> triangles; ///< Triangle numbers (index / 3).
+};
+
+void BuildAdjacency(const std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap, Adjacency &adjacency)
+{
+    const size_t vertexCount = remap.size();
+    adjacency.offsets.assign(vertexCount + 1, 0);
+    for (uint32_t index : indices)
+        adjacency.offsets[remap[index] + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+    adjacency.triangles.resize(indices.size());
+    std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i)
+        adjacency.triangles[fill[remap[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+}
+
+/**
+ * @brief Classifies position groups from the current triangles and flags every half-edge
+ * (one entry per index) as open border or attribute seam.
+ */
+void ClassifyVertices(const std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap,
+                      const std::vector<uint32_t> &wedge, const Adjacency &adjacency, std::vector<VertexKind> &kinds,
+                      std::vector<uint8_t> &edgeFlags)
+{
+    std::vector<uint8_t> borderCount(remap.size(), 0);
+    std::vector<uint8_t> seamCount(remap.size(), 0);
+    std::vector<uint8_t> locked(remap.size(), 0);
+    edgeFlags.assign(indices.size(), 0);
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            const uint32_t a = indices[i + e];
+            const uint32_t b = indices[i + ((e + 1) % 3)];
+            const uint32_t ca = remap[a];
+            const uint32_t cb = remap[b];
+
+            // Look for the same directed edge around a and the opposite one around b
+            size_t same = 0;
+            for (uint32_t k = adjacency.offsets[ca]; k < adjacency.offsets[ca + 1]; ++k)
+            {
+                const uint32_t *tri = &indices[adjacency.triangles[k] * 3];
+                for (int c = 0; c < 3; ++c)
+                    same += (remap[tri[c]] == ca && remap[tri[(c + 1) % 3]] == cb) ? 1 : 0;
+            }
+            bool opposite = false;
+            bool wedgeOpposite = false;
+            for (uint32_t k = adjacency.offsets[cb]; k < adjacency.offsets[cb + 1]; ++k)
+            {
+                const uint32_t *tri = &indices[adjacency.triangles[k] * 3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    const uint32_t x = tri[c];
+                    const uint32_t y = tri[(c + 1) % 3];
+                    opposite = opposite || (remap[x] == cb && remap[y] == ca);
+                    wedgeOpposite = wedgeOpposite || (x == b && y == a);
+                }
+            }
+
+            if (same > 1)
+            {
+                locked[ca] = locked[cb] = 1; // Same directed edge used twice: non-manifold
+            }
+            else if (!opposite)
+            {
+                edgeFlags[i + e] = EDGE_BORDER;
+                borderCount[ca] = static_cast<uint8_t>((std::min)(borderCount[ca] + 1, 255));
+                borderCount[cb] = static_cast<uint8_t>((std::min)(borderCount[cb] + 1, 255));
+            }
+            else if (!wedgeOpposite)
+            {
+                // Geometrically closed but the neighbour uses other wedges: both half-edges
+                // of a seam edge land here, so each endpoint counts every seam edge twice
+                edgeFlags[i + e] = EDGE_SEAM;
+                seamCount[ca] = static_cast<uint8_t>((std::min)(seamCount[ca] + 1, 255));
+                seamCount[cb] = static_cast<uint8_t>((std::min)(seamCount[cb] + 1, 255));
+            }
+        }
+    }
+
+    kinds.assign(remap.size(), VertexKind::Locked);
+    for (uint32_t v = 0; v < remap.size(); ++v)
+    {
+        if (remap[v] != v || locked[v])
+            continue;
+        const bool hasWedges = wedge[v] != v;
+        if (borderCount[v] == 0 && seamCount[v] == 0)
+            kinds[v] = hasWedges ? VertexKind::Locked : VertexKind::Manifold;
+        else if (borderCount[v] == 2 && seamCount[v] == 0 && !hasWedges)
+            kinds[v] = VertexKind::Border;
+        else if (borderCount[v] == 0 && seamCount[v] == 4)
+            kinds[v] = VertexKind::Seam;
+    }
+}
+
+/**
+ * @brief Accumulates area-weighted triangle planes and boundary-preserving edge planes.
+ */
+void ComputeQuadrics(const Vertex *vertices, const std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap,
+                     const std::vector<uint8_t> &edgeFlags, std::vector<Quadric> &quadrics)
+{
+    quadrics.assign(remap.size(), Quadric());
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const uint32_t c[3] = {remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]]};
+        const DirectX::XMFLOAT3 &p0 = vertices[c[0]].position;
+        double n[3];
+        Cross(p0, vertices[c[1]].position, vertices[c[2]].position, n);
+        const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0)
+            continue;
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+        const double d = -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z);
+        const double area = length * 0.5;
+        for (uint32_t v : c)
+            quadrics[v].AddPlane(n[0], n[1], n[2], d, area);
+
+        for (int e = 0; e < 3; ++e)
+        {
+            if (edgeFlags[i + e] == 0)
+                continue;
+            const uint32_t a = c[e];
+            const uint32_t b = c[(e + 1) % 3];
+
+            // Plane through the edge, perpendicular to the triangle
+            const DirectX::XMFLOAT3 &pa = vertices[a].position;
+            const DirectX::XMFLOAT3 &pb = vertices[b].position;
+            const double edge[3] = {double(pb.x) - pa.x, double(pb.y) - pa.y, double(pb.z) - pa.z};
+            double p[3] = {edge[1] * n[2] - edge[2] * n[1], edge[2] * n[0] - edge[0] * n[2],
+                           edge[0] * n[1] - edge[1] * n[0]};
+            const double pl = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            if (pl <= 0.0)
+                continue;
+            p[0] /= pl;
+            p[1] /= pl;
+            p[2] /= pl;
+            const double pd = -(p[0] * pa.x + p[1] * pa.y + p[2] * pa.z);
+            const double weight = BOUNDARY_WEIGHT * (edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]);
+            quadrics[a].AddPlane(p[0], p[1], p[2], pd, weight);
+            quadrics[b].AddPlane(p[0], p[1], p[2], pd, weight);
+        }
+    }
+}
+
+/**
+ * @brief Checks the link condition and triangle flips for moving `from` onto `to`.
+ *
+ * @param triangles Triangle indices (into indices / 3) around `from`.
+ */
+bool IsCollapseValid(const Vertex *vertices, const std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap,
+                     const uint32_t *triangles, size_t triangleCount, const uint32_t *toTriangles,
+                     size_t toTriangleCount, uint32_t from, uint32_t to)
+{
+    // Link condition: the only neighbours both ends share are the opposite corners of the
+    // triangles that contain the edge; anything else pinches the surface
+    uint32_t fromRing[64];
+    size_t fromRingCount = 0;
+    size_t shared = 0;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const uint32_t *tri = &indices[triangles[t] * 3];
+        bool hasTo = false;
+        for (int k = 0; k < 3; ++k)
+            hasTo = hasTo || remap[tri[k]] == to;
+        shared += hasTo ? 1 : 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t c = remap[tri[k]];
+            if (c == from || c == to)
+                continue;
+            if (std::find(fromRing, fromRing + fromRingCount, c) != fromRing + fromRingCount)
+                continue;
+            if (fromRingCount == 64)
+                return false;
+            fromRing[fromRingCount++] = c;
+        }
+    }
+    if (shared == 0)
+        return false;
+
+    uint32_t common[64];
+    size_t commonCount = 0;
+    for (size_t t = 0; t < toTriangleCount; ++t)
+    {
+        const uint32_t *tri = &indices[toTriangles[t] * 3];
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t c = remap[tri[k]];
+            if (std::find(fromRing, fromRing + fromRingCount, c) == fromRing + fromRingCount)
+                continue;
+            if (std::find(common, common + commonCount, c) != common + commonCount)
+                continue;
+            if (commonCount == 64)
+                return false;
+            common[commonCount++] = c;
+        }
+    }
+    if (commonCount != shared)
+        return false;
+
+    // Surviving triangles must keep their orientation and not degenerate
+    const DirectX::XMFLOAT3 &target = vertices[to].position;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const uint32_t *tri = &indices[triangles[t] * 3];
+        const uint32_t c[3] = {remap[tri[0]], remap[tri[1]], remap[tri[2]]};
+        if (c[0] == to || c[1] == to || c[2] == to)
+            continue;
+
+        DirectX::XMFLOAT3 before[3];
+        DirectX::XMFLOAT3 after[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            before[k] = vertices[c[k]].position;
+            after[k] = c[k] == from ? target : before[k];
+        }
+        double n0[3];
+        double n1[3];
+        Cross(before[0], before[1], before[2], n0);
+        Cross(after[0], after[1], after[2], n1);
+        const double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+        const double len0 = std::sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+        const double len1 = std::sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+        if (dot <= MIN_NORMAL_COS * len0 * len1)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Pairs every wedge of `from` with the wedge of `to` it shares triangles with.
+ *
+ * Fails when a wedge touches no wedge of `to` (the collapse would cross a seam) or more
+ * than one.
+ */
+bool MatchWedges(const std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap,
+                 const std::vector<uint32_t> &wedge, const uint32_t *triangles, size_t triangleCount, uint32_t from,
+                 uint32_t to, std::vector<std::pair<uint32_t, uint32_t>> &outPairs)
+{
+    outPairs.clear();
+    uint32_t w = from;
+    do
+    {
+        uint32_t match = UINT32_MAX;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            const uint32_t *tri = &indices[triangles[t] * 3];
+            if (tri[0] != w && tri[1] != w && tri[2] != w)
+                continue;
+            for (int k = 0; k < 3; ++k)
+            {
+                if (remap[tri[k]] != to)
+                    continue;
+                if (match != UINT32_MAX && match != tri[k])
+                    return false;
+                match = tri[k];
+            }
+        }
+        if (match == UINT32_MAX)
+            return false;
+        outPairs.emplace_back(w, match);
+        w = wedge[w];
+    } while (w != from);
+    return true;
+}
+
+} // namespace
+
+float Simplify(const Vertex *vertices, size_t vertexCount, const std::vector<uint32_t> &indices,
+               size_t targetIndexCount, float maxError, std::vector<uint32_t> &outIndices)
+{
+    outIndices.assign(indices.begin(), indices.end() - (indices.size() % 3));
+    if (outIndices.size() <= targetIndexCount || vertexCount == 0)
+        return 0.0f;
+
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> wedge;
+    BuildPositionGroups(vertices, vertexCount, outIndices, remap, wedge);
+
+    Adjacency adjacency;
+    std::vector<VertexKind> kinds;
+    std::vector<uint8_t> edgeFlags;
+    BuildAdjacency(outIndices, remap, adjacency);
+    ClassifyVertices(outIndices, remap, wedge, adjacency, kinds, edgeFlags);
+
+    // Quadrics come from the input surface; later passes only merge them
+    std::vector<Quadric> quadrics;
+    ComputeQuadrics(vertices, outIndices, remap, edgeFlags, quadrics);
+
+    const double maxErrorSq = static_cast<double>(maxError) * maxError;
+    double resultErrorSq = 0.0;
+
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapseRemap(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+
+    for (bool firstPass = true; outIndices.size() > targetIndexCount; firstPass = false)
+    {
+        const size_t triangleCount = outIndices.size() / 3;
+        if (!firstPass)
+        {
+            BuildAdjacency(outIndices, remap, adjacency);
+            ClassifyVertices(outIndices, remap, wedge, adjacency, kinds, edgeFlags);
+        }
+
+        // Candidate collapses along every half-edge, cheapest first
+        candidates.clear();
+        for (size_t i = 0; i < outIndices.size(); i += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                const uint32_t a = remap[outIndices[i + e]];
+                const uint32_t b = remap[outIndices[i + ((e + 1) % 3)]];
+                const bool border = edgeFlags[i + e] == EDGE_BORDER;
+                const bool seam = edgeFlags[i + e] == EDGE_SEAM;
+                const uint32_t ends[2][2] = {{a, b}, {b, a}};
+                // Interior edges show up from both sides; border edges only once
+                for (int dir = 0; dir < (border ? 2 : 1); ++dir)
+                {
+                    const uint32_t from = ends[dir][0];
+                    const uint32_t to = ends[dir][1];
+                    const VertexKind kind = kinds[from];
+                    if (kind == VertexKind::Locked || (kind == VertexKind::Border && !border) ||
+                        (kind == VertexKind::Seam && !seam))
+                        continue;
+                    Quadric q = quadrics[from];
+                    q.Add(quadrics[to]);
+                    candidates.push_back({from, to, q.Error(vertices[to].position)});
+                }
+            }
+        }
+        if (candidates.empty())
+            break;
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse &x, const Collapse &y) { return x.error < y.error; });
+
+        for (size_t v = 0; v < vertexCount; ++v)
+            collapseRemap[v] = static_cast<uint32_t>(v);
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t remaining = triangleCount;
+        size_t collapses = 0;
+        for (const Collapse &candidate : candidates)
+        {
+            if (remaining * 3 <= targetIndexCount)
+                break;
+            if (candidate.error > maxErrorSq)
+                break;
+            if (touched[candidate.from] || touched[candidate.to])
+                continue;
+
+            const uint32_t *fromTriangles = &adjacency.triangles[adjacency.offsets[candidate.from]];
+            const size_t fromCount = adjacency.offsets[candidate.from + 1] - adjacency.offsets[candidate.from];
+            const uint32_t *toTriangles = &adjacency.triangles[adjacency.offsets[candidate.to]];
+            const size_t toCount = adjacency.offsets[candidate.to + 1] - adjacency.offsets[candidate.to];
+            if (!IsCollapseValid(vertices, outIndices, remap, fromTriangles, fromCount, toTriangles, toCount,
+                                 candidate.from, candidate.to))
+                continue;
+            if (!MatchWedges(outIndices, remap, wedge, fromTriangles, fromCount, candidate.from, candidate.to, pairs))
+                continue;
+
+            for (const auto &pair : pairs)
+                collapseRemap[pair.first] = pair.second;
+            quadrics[candidate.to].Add(quadrics[candidate.from]);
+            resultErrorSq = (std::max)(resultErrorSq, candidate.error);
+
+            // Lock the one-ring for the rest of the pass: its triangles are now stale
+            for (size_t t = 0; t < fromCount; ++t)
+            {
+                const uint32_t *tri = &outIndices[fromTriangles[t] * 3];
+                bool removed = false;
+                for (int k = 0; k < 3; ++k)
+                {
+                    touched[remap[tri[k]]] = 1;
+                    removed = removed || remap[tri[k]] == candidate.to;
+                }
+                remaining -= removed ? 1 : 0;
+            }
+            collapses++;
+        }
+
+        if (collapses == 0)
+            break;
+
+        // Apply the pass and drop the triangles that collapsed to an edge
+        size_t write = 0;
+        for (size_t i = 0; i < outIndices.size(); i += 3)
+        {
+            const uint32_t a = collapseRemap[outIndices[i]];
+            const uint32_t b = collapseRemap[outIndices[i + 1]];
+            const uint32_t c = collapseRemap[outIndices[i + 2]];
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c])
+                continue;
+            outIndices[write++] = a;
+            outIndices[write++] = b;
+            outIndices[write++] = c;
+        }
+        outIndices.resize(write);
+    }
+
+    return static_cast<float>(std::sqrt(resultErrorSq));
+}
+
+std::vector<LevelReport> BuildLodChain(MeshData &mesh, const float *triangleRatios, const float *maxErrors,
+                                       size_t levelCount)
+{
+    mesh.lods.clear();
+    std::vector<LevelReport> reports;
+    reports.push_back({mesh.indices.size() / 3, 0.0f});
+    if (mesh.vertices.empty() || mesh.indices.empty())
+        return reports;
+
+    DirectX::XMFLOAT3 minimum = mesh.vertices[0].position;
+    DirectX::XMFLOAT3 maximum = minimum;
+    for (const auto &vertex : mesh.vertices)
+    {
+        minimum = {(std::min)(minimum.x, vertex.position.x), (std::min)(minimum.y, vertex.position.y),
+                   (std::min)(minimum.z, vertex.position.z)};
+        maximum = {(std::max)(maximum.x, vertex.position.x), (std::max)(maximum.y, vertex.position.y),
+                   (std::max)(maximum.z, vertex.position.z)};
+    }
+    const float dx = maximum.x - minimum.x;
+    const float dy = maximum.y - minimum.y;
+    const float dz = maximum.z - minimum.z;
+    const float radius = 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    std::vector<ShapeInfo> shapes = mesh.shapes;
+    if (shapes.empty())
+    {
+        ShapeInfo whole;
+        whole.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        shapes.push_back(whole);
+    }
+
+    // Every level simplifies the full-detail shapes so its error is measured against LOD 0
+    std::vector<uint32_t> absolute;
+    std::vector<uint32_t> simplified;
+    size_t previousTriangles = reports.front().triangles;
+    for (size_t level = 0; level < levelCount; ++level)
+    {
+        LodLevel lod;
+        lod.shapes = shapes;
+        for (size_t s = 0; s < shapes.size(); ++s)
+        {
+            const ShapeInfo &source = shapes[s];
+            ShapeInfo &shape = lod.shapes[s];
+            absolute.clear();
+            for (uint32_t i = source.startIndex; i < source.startIndex + source.indexCount; ++i)
+                absolute.push_back(static_cast<uint32_t>(static_cast<int64_t>(mesh.indices[i]) + source.baseVertex));
+
+            const auto target = static_cast<size_t>(static_cast<float>(absolute.size() / 3) * triangleRatios[level]) * 3;
+            const float error = Simplify(mesh.vertices.data(), mesh.vertices.size(), absolute, target,
+                                         maxErrors[level] * radius, simplified);
+            lod.error = (std::max)(lod.error, error);
+
+            for (uint32_t &index : simplified)
+                index = static_cast<uint32_t>(static_cast<int64_t>(index) - source.baseVertex);
+            MeshOptimizer::OptimizeVertexCache(simplified, mesh.vertices.size() - static_cast<size_t>(source.baseVertex));
+
+            shape.startIndex = static_cast<uint32_t>(lod.indices.size());
+            shape.indexCount = static_cast<uint32_t>(simplified.size());
+            lod.indices.insert(lod.indices.end(), simplified.begin(), simplified.end());
+        }
+
+        const size_t triangles = lod.indices.size() / 3;
+        if (static_cast<float>(triangles) > static_cast<float>(previousTriangles) * (1.0f - MIN_LEVEL_REDUCTION))
+            break;
+        previousTriangles = triangles;
+
+        reports.push_back({triangles, lod.error});
+        if (mesh.shapes.empty())
+            lod.shapes.clear();
+        mesh.lods.push_back(std::move(lod));
+    }
+    return reports;
+}
+
+} // namespace MeshSimplifier
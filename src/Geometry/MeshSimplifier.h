@@ -0,0 +1,69 @@
+/**
+ * @file MeshSimplifier.h
+ * @brief Quadric-error mesh simplification and LOD chain generation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Resources/MeshData.h"
+
+/**
+ * @namespace MeshSimplifier
+ * @brief Builds coarser index buffers over an unchanged vertex array.
+ *
+ * Simplification uses half-edge collapses ordered by quadric error (Garland and Heckbert):
+ * a vertex is merged into one of its neighbours, so every level reuses the full-detail
+ * vertex buffer and only adds indices. Open borders may only slide along themselves;
+ * attribute seams and non-manifold vertices stay locked.
+ */
+namespace MeshSimplifier
+{
+
+/**
+ * @struct LevelReport
+ * @brief Size and accuracy of one generated LOD level.
+ */
+struct LevelReport
+{
+    size_t triangles = 0; ///< Triangle count of the level.
+    float error = 0.0f;   ///< Largest deviation introduced, in mesh units.
+};
+
+/**
+ * @brief Simplifies a triangle list.
+ *
+ * Stops when the index count reaches the target, when the cheapest remaining collapse
+ * would exceed maxError, or when no collapse is possible.
+ *
+ * @param vertices Vertex array referenced by the indices.
+ * @param vertexCount Number of vertices.
+ * @param indices Triangle list indices.
+ * @param targetIndexCount Desired number of indices (a multiple of 3).
+ * @param maxError Largest allowed deviation, in mesh units.
+ * @param outIndices Receives the simplified triangle list.
+ * @return Largest deviation of the applied collapses, in mesh units.
+ */
+float Simplify(const Vertex *vertices, size_t vertexCount, const std::vector<uint32_t> &indices,
+               size_t targetIndexCount, float maxError, std::vector<uint32_t> &outIndices);
+
+/**
+ * @brief Builds the LOD chain of a processed mesh into MeshData::lods.
+ *
+ * Each level simplifies the previous one shape by shape, towards triangleRatios[i] of the
+ * full-detail triangle count and within maxErrors[i] times the mesh bounding radius, then is
+ * reordered for the vertex cache. The chain ends early once a level no longer removes a
+ * meaningful share of triangles.
+ *
+ * @param mesh Mesh processed by MeshOptimizer::ProcessMesh; its lods are replaced.
+ * @param triangleRatios Target triangle fraction of each level relative to LOD 0.
+ * @param maxErrors Largest deviation of each level, relative to the bounding radius.
+ * @param levelCount Number of entries in both arrays.
+ * @return One report per generated level, starting with LOD 0.
+ */
+std::vector<LevelReport> BuildLodChain(MeshData &mesh, const float *triangleRatios, const float *maxErrors,
+                                       size_t levelCount);
+
+} // namespace MeshSimplifier
@@ -0,0 +1,269 @@
+#include "VertexQuantizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "../Core/Config.h"
+
+namespace VertexQuantizer
+{
+
+namespace
+{
+
+float SignNotZero(float v)
+{
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+uint16_t ToUnorm16(float v)
+{
+    v = (std::min)((std::max)(v, 0.0f), 1.0f);
+    return static_cast<uint16_t>(std::lround(v * UNORM16_MAX));
+}
+
+int16_t ToSnorm16(float v)
+{
+    v = (std::min)((std::max)(v, -1.0f), 1.0f);
+    return static_cast<int16_t>(std::lround(v * SNORM16_MAX));
+}
+
+float FromSnorm16(int16_t v)
+{
+    return (std::max)(static_cast<float>(v) / SNORM16_MAX, -1.0f);
+}
+
+float AxisFraction(float value, float min, float extent)
+{
+    return extent > 0.0f ? (value - min) / extent : 0.0f;
+}
+
+} // namespace
+
+Bounds ComputeBounds(const Vertex *vertices, size_t count)
+{
+    Bounds bounds;
+    if (count == 0)
+        return bounds;
+
+    DirectX::XMFLOAT3 lo = {FLT_MAX, FLT_MAX, FLT_MAX};
+    DirectX::XMFLOAT3 hi = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const DirectX::XMFLOAT3 &p = vertices[i].position;
+        lo = {(std::min)(lo.x, p.x), (std::min)(lo.y, p.y), (std::min)(lo.z, p.z)};
+        hi = {(std::max)(hi.x, p.x), (std::max)(hi.y, p.y), (std::max)(hi.z, p.z)};
+    }
+    bounds.min = lo;
+    bounds.extent = {hi.x - lo.x, hi.y - lo.y, hi.z - lo.z};
+    return bounds;
+}
+
+float MaxPositionError(const Bounds &bounds)
+{
+    float longest = (std::max)((std::max)(bounds.extent.x, bounds.extent.y), bounds.extent.z);
+    return 0.5f * longest / UNORM16_MAX;
+}
+
+void EncodePosition(const DirectX::XMFLOAT3 &position, const Bounds &bounds, uint16_t out[3])
+{
+    out[0] = ToUnorm16(AxisFraction(position.x, bounds.min.x, bounds.extent.x));
+    out[1] = ToUnorm16(AxisFraction(position.y, bounds.min.y, bounds.extent.y));
+    out[2] = ToUnorm16(AxisFraction(position.z, bounds.min.z, bounds.extent.z));
+}
+
+DirectX::XMFLOAT3 DecodePosition(const uint16_t in[3], const Bounds &bounds)
+{
+    return {bounds.min.x + (static_cast<float>(in[0]) / UNORM16_MAX) * bounds.extent.x,
+            bounds.min.y + (static_cast<float>(in[1]) / UNORM16_MAX) * bounds.extent.y,
+            bounds.min.z + (static_cast<float>(in[2]) / UNORM16_MAX) * bounds.extent.z};
+}
+
+void EncodeOctahedral(const DirectX::XMFLOAT3 &normal, int16_t out[2])
+{
+    float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (sum <= 0.0f)
+    {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    // Project onto the octahedron, then fold the lower hemisphere over the diagonals
+    float x = normal.x / sum;
+    float y = normal.y / sum;
+    if (normal.z < 0.0f)
+    {
+        float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+        float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+    out[0] = ToSnorm16(x);
+    out[1] = ToSnorm16(y);
+}
+
+DirectX::XMFLOAT3 DecodeOctahedral(const int16_t in[2])
+{
+    float x = FromSnorm16(in[0]);
+    float y = FromSnorm16(in[1]);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    float t = (std::max)(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    float length = std::sqrt((x * x) + (y * y) + (z * z));
+    return {x / length, y / length, z / length};
+}
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu)
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u)); // Inf / NaN
+
+    const int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F)
+        return static_cast<uint16_t>(sign | 0x7C00u); // Overflow to infinity
+
+    if (halfExponent <= 0)
+    {
+        // Subnormal half (or zero)
+        if (halfExponent < -10)
+            return sign;
+        mantissa |= 0x800000u;
+        const auto shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u)))
+            ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        ++half; // May carry into the exponent, which correctly rounds up to the next binade or infinity
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0x1Fu)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0)
+    {
+        bits = sign;
+    }
+    else
+    {
+        // Normalize the subnormal
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400u) == 0)
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+QuantizedVertex Encode(const Vertex &vertex, const Bounds &bounds)
+{
+    QuantizedVertex q = {};
+    EncodePosition(vertex.position, bounds, q.position);
+    EncodeOctahedral(vertex.normal, q.normal);
+    q.uv[0] = FloatToHalf(vertex.uv.x);
+    q.uv[1] = FloatToHalf(vertex.uv.y);
+    return q;
+}
+
+Vertex Decode(const QuantizedVertex &vertex, const Bounds &bounds)
+{
+    Vertex v;
+    v.position = DecodePosition(vertex.position, bounds);
+    v.normal = DecodeOctahedral(vertex.normal);
+    v.uv = {HalfToFloat(vertex.uv[0]), HalfToFloat(vertex.uv[1])};
+    return v;
+}
+
+std::vector<QuantizedVertex> QuantizeVertices(const Vertex *vertices, size_t count, const Bounds &bounds)
+{
+    std::vector<QuantizedVertex> out(count);
+    for (size_t i = 0; i < count; ++i)
+        out[i] = Encode(vertices[i], bounds);
+    return out;
+}
+
+std::vector<QuantizedPosition> QuantizePositions(const Vertex *vertices, size_t count, const Bounds &bounds)
+{
+    std::vector<QuantizedPosition> out(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        EncodePosition(vertices[i].position, bounds, out[i].position);
+        out[i].position[3] = 0;
+    }
+    return out;
+}
+
+Report Analyze(const Vertex *vertices, size_t count)
+{
+    Report report;
+    report.vertexCount = count;
+    report.fullBytes = count * sizeof(Vertex);
+    report.quantizedBytes = count * sizeof(QuantizedVertex);
+    report.positionBytes = count * sizeof(QuantizedPosition);
+
+    const Bounds bounds = ComputeBounds(vertices, count);
+    double maxNormalAngle = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vertex &original = vertices[i];
+        const Vertex decoded = Decode(Encode(original, bounds), bounds);
+
+        report.maxPositionError = (std::max)({report.maxPositionError,
+                                              std::fabs(decoded.position.x - original.position.x),
+                                              std::fabs(decoded.position.y - original.position.y),
+                                              std::fabs(decoded.position.z - original.position.z)});
+        report.maxUvError = (std::max)({report.maxUvError, std::fabs(decoded.uv.x - original.uv.x),
+                                        std::fabs(decoded.uv.y - original.uv.y)});
+
+        // atan2 of |cross| and dot keeps sub-millidegree angles that acos would round away
+        const DirectX::XMFLOAT3 &a = original.normal;
+        const DirectX::XMFLOAT3 &b = decoded.normal;
+        if (a.x != 0.0f || a.y != 0.0f || a.z != 0.0f)
+        {
+            const double cx = (double(a.y) * b.z) - (double(a.z) * b.y);
+            const double cy = (double(a.z) * b.x) - (double(a.x) * b.z);
+            const double cz = (double(a.x) * b.y) - (double(a.y) * b.x);
+            const double dot = (double(a.x) * b.x) + (double(a.y) * b.y) + (double(a.z) * b.z);
+            maxNormalAngle = (std::max)(maxNormalAngle, std::atan2(std::sqrt((cx * cx) + (cy * cy) + (cz * cz)), dot));
+        }
+    }
+    report.maxNormalErrorDeg = static_cast<float>(maxNormalAngle * 180.0 / Config::Math::PI);
+    return report;
+}
+
+} // namespace VertexQuantizer
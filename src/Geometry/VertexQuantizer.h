@@ -0,0 +1,190 @@
+/**
+ * @file VertexQuantizer.h
+ * @brief Compact vertex encodings: bounds-relative 16-bit positions, octahedral normals, half UVs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Resources/MeshData.h"
+
+/**
+ * @namespace VertexQuantizer
+ * @brief CPU encode/decode of the quantized vertex formats.
+ *
+ * Positions are stored as UNORM16 relative to the mesh bounding box, so the GPU decodes them
+ * for free with DXGI_FORMAT_R16G16B16A16_UNORM and a scale/offset folded into the world matrix.
+ * Normals use the octahedral mapping stored as two SNORM16 values; UVs are half floats.
+ */
+namespace VertexQuantizer
+{
+
+/// Largest UNORM16 value.
+constexpr float UNORM16_MAX = 65535.0f;
+
+/// Largest SNORM16 value.
+constexpr float SNORM16_MAX = 32767.0f;
+
+/**
+ * @struct QuantizedPosition
+ * @brief Position-only vertex for depth-only passes (DXGI_FORMAT_R16G16B16A16_UNORM, w unused).
+ */
+struct QuantizedPosition
+{
+    uint16_t position[4];
+};
+
+/**
+ * @struct QuantizedVertex
+ * @brief Full vertex in 16 bytes instead of 32.
+ */
+struct QuantizedVertex
+{
+    uint16_t position[4]; ///< UNORM16 relative to the bounds (w unused).
+    int16_t normal[2];    ///< Octahedral-encoded unit normal, SNORM16.
+    uint16_t uv[2];       ///< Half-float texture coordinates.
+};
+
+static_assert(sizeof(QuantizedPosition) == 8, "QuantizedPosition must match R16G16B16A16_UNORM");
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must stay 16 bytes");
+
+/**
+ * @struct Bounds
+ * @brief Axis-aligned box that positions are quantized against.
+ */
+struct Bounds
+{
+    DirectX::XMFLOAT3 min = {0.0f, 0.0f, 0.0f};    ///< Minimum corner.
+    DirectX::XMFLOAT3 extent = {0.0f, 0.0f, 0.0f}; ///< Size along each axis (0 for flat axes).
+};
+
+/**
+ * @struct Report
+ * @brief Memory footprint and measured round-trip error of a quantized mesh.
+ */
+struct Report
+{
+    size_t vertexCount = 0;         ///< Number of vertices.
+    size_t fullBytes = 0;           ///< Size with the 32-byte Vertex.
+    size_t quantizedBytes = 0;      ///< Size with QuantizedVertex.
+    size_t positionBytes = 0;       ///< Size of the position-only stream.
+    float maxPositionError = 0.0f;  ///< Largest per-axis position error, in mesh units.
+    float maxNormalErrorDeg = 0.0f; ///< Largest angle between original and decoded normal.
+    float maxUvError = 0.0f;        ///< Largest absolute UV error.
+};
+
+/**
+ * @brief Computes the bounding box of a vertex array.
+ * @param vertices Vertex array.
+ * @param count Number of vertices.
+ * @return Bounds (all zero for an empty array).
+ */
+Bounds ComputeBounds(const Vertex *vertices, size_t count);
+
+/**
+ * @brief Largest per-axis position error introduced by EncodePosition for these bounds.
+ * @param bounds Quantization bounds.
+ * @return Half a quantization step along the longest axis.
+ */
+float MaxPositionError(const Bounds &bounds);
+
+/**
+ * @brief Encodes a position as UNORM16 relative to the bounds.
+ *
+ * @param position Position to encode; values outside the bounds are clamped.
+ * @param bounds Quantization bounds.
+ * @param out Receives the x, y and z components.
+ */
+void EncodePosition(const DirectX::XMFLOAT3 &position, const Bounds &bounds, uint16_t out[3]);
+
+/**
+ * @brief Decodes a UNORM16 position.
+ *
+ * @param in Encoded x, y and z components.
+ * @param bounds Bounds used for encoding.
+ * @return Decoded position.
+ */
+DirectX::XMFLOAT3 DecodePosition(const uint16_t in[3], const Bounds &bounds);
+
+/**
+ * @brief Encodes a direction with the octahedral mapping.
+ *
+ * @param normal Direction to encode (need not be normalized; zero maps to +Z).
+ * @param out Receives the two SNORM16 components.
+ */
+void EncodeOctahedral(const DirectX::XMFLOAT3 &normal, int16_t out[2]);
+
+/**
+ * @brief Decodes an octahedral normal.
+ *
+ * @param in Encoded SNORM16 components.
+ * @return Unit-length direction.
+ */
+DirectX::XMFLOAT3 DecodeOctahedral(const int16_t in[2]);
+
+/**
+ * @brief Converts a float to IEEE half precision with round-to-nearest-even.
+ *
+ * @param value Value to convert; out-of-range values become infinity.
+ * @return Half-float bit pattern.
+ */
+uint16_t FloatToHalf(float value);
+
+/**
+ * @brief Converts an IEEE half to float.
+ *
+ * @param value Half-float bit pattern.
+ * @return Exact float value.
+ */
+float HalfToFloat(uint16_t value);
+
+/**
+ * @brief Encodes a full vertex.
+ *
+ * @param vertex Vertex to encode.
+ * @param bounds Quantization bounds of its mesh.
+ * @return Compact vertex.
+ */
+QuantizedVertex Encode(const Vertex &vertex, const Bounds &bounds);
+
+/**
+ * @brief Decodes a quantized vertex.
+ *
+ * @param vertex Compact vertex.
+ * @param bounds Bounds used for encoding.
+ * @return Full-precision vertex.
+ */
+Vertex Decode(const QuantizedVertex &vertex, const Bounds &bounds);
+
+/**
+ * @brief Quantizes a vertex array to the compact full format.
+ *
+ * @param vertices Vertex array.
+ * @param count Number of vertices.
+ * @param bounds Quantization bounds (usually ComputeBounds of the same array).
+ * @return One QuantizedVertex per input vertex.
+ */
+std::vector<QuantizedVertex> QuantizeVertices(const Vertex *vertices, size_t count, const Bounds &bounds);
+
+/**
+ * @brief Builds the position-only stream for depth-only passes.
+ *
+ * @param vertices Vertex array.
+ * @param count Number of vertices.
+ * @param bounds Quantization bounds (usually ComputeBounds of the same array).
+ * @return One QuantizedPosition per input vertex.
+ */
+std::vector<QuantizedPosition> QuantizePositions(const Vertex *vertices, size_t count, const Bounds &bounds);
+
+/**
+ * @brief Measures memory use and round-trip error of quantizing a vertex array.
+ *
+ * @param vertices Vertex array.
+ * @param count Number of vertices.
+ * @return Byte sizes of each format and the largest observed errors.
+ */
+Report Analyze(const Vertex *vertices, size_t count);
+
+} // namespace VertexQuantizer
@@ -0,0 +1,149 @@
+#include "AnalyticScattering.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AnalyticScattering
+{
+
+namespace
+{
+
+/// Same value of pi as the shader's phase function.
+constexpr float SHADER_PI = 3.14159f;
+
+/// Simpson sub-intervals between two table rows.
+constexpr int SUBSTEPS = 32;
+
+/**
+ * @brief Cosine of the scattering angle at angle psi along a ray, for a = h / sqrt(h^2 + 1).
+ */
+double ScatterCosine(double psi, double a)
+{
+    const double s = std::sin(psi);
+    const double c = std::cos(psi) * a;
+    const double length = std::sqrt((s * s) + (c * c));
+    return length > 1e-12 ? s / length : 0.0;
+}
+
+/**
+ * @brief Closest point of the ray line to the light, as distance along the ray, and h'.
+ */
+void RayGeometry(const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                 float &outClosest, float &outH2, float &outHp)
+{
+    const float lx = lightPos.x - origin.x;
+    const float ly = lightPos.y - origin.y;
+    const float lz = lightPos.z - origin.z;
+    outClosest = (lx * dir.x) + (ly * dir.y) + (lz * dir.z);
+
+    // |toLight x dir|^2 rather than |toLight|^2 - closest^2, which cancels badly far from the light
+    const float cx = (ly * dir.z) - (lz * dir.y);
+    const float cy = (lz * dir.x) - (lx * dir.z);
+    const float cz = (lx * dir.y) - (ly * dir.x);
+    outH2 = (cx * cx) + (cy * cy) + (cz * cz);
+    outHp = std::sqrt(outH2 + 1.0f);
+}
+
+} // namespace
+
+float HenyeyGreenstein(float cosTheta, float g)
+{
+    const float g2 = g * g;
+    return (1.0f - g2) / (4.0f * SHADER_PI * std::pow((std::max)(0.001f, 1.0f + g2 - (2.0f * g * cosTheta)), 1.5f));
+}
+
+bool BuildTable(float anisotropy, Table &outTable, int width, int height)
+{
+    if (width < 2 || height < 2)
+        return false;
+
+    outTable.width = width;
+    outTable.height = height;
+    outTable.anisotropy = anisotropy;
+    outTable.values.assign(static_cast<size_t>(width) * height, 0.0f);
+
+    const double rowStep = static_cast<double>(SHADER_PI) / (height - 1);
+    const double h = rowStep / SUBSTEPS;
+    for (int i = 0; i < width; ++i)
+    {
+        const double root = static_cast<double>(i) / (width - 1);
+        const double a = root * root;
+        auto phase = [&](double psi)
+        { return static_cast<double>(HenyeyGreenstein(static_cast<float>(ScatterCosine(psi, a)), anisotropy)); };
+
+        // Running Simpson integral from -pi/2, one row at a time
+        double sum = 0.0;
+        for (int j = 1; j < height; ++j)
+        {
+            const double start = (-0.5 * SHADER_PI) + ((j - 1) * rowStep);
+            double cell = phase(start) + phase(start + rowStep);
+            for (int k = 1; k < SUBSTEPS; ++k)
+                cell += (k % 2 ? 4.0 : 2.0) * phase(start + (k * h));
+            sum += cell * h / 3.0;
+            outTable.values[(static_cast<size_t>(j) * width) + i] = static_cast<float>(sum);
+        }
+    }
+    return true;
+}
+
+float Lookup(const Table &table, float a, float psi)
+{
+    const float x = std::sqrt((std::min)((std::max)(a, 0.0f), 1.0f)) * static_cast<float>(table.width - 1);
+    const float y = (std::min)((std::max)((psi / SHADER_PI) + 0.5f, 0.0f), 1.0f) * static_cast<float>(table.height - 1);
+    const int x0 = (std::min)(static_cast<int>(x), table.width - 2);
+    const int y0 = (std::min)(static_cast<int>(y), table.height - 2);
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+
+    const float *row0 = &table.values[(static_cast<size_t>(y0) * table.width) + x0];
+    const float *row1 = row0 + table.width;
+    const float top = row0[0] + (fx * (row0[1] - row0[0]));
+    const float bottom = row1[0] + (fx * (row1[1] - row1[0]));
+    return top + (fy * (bottom - top));
+}
+
+float Integrate(const Table &table, const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin,
+                const DirectX::XMFLOAT3 &dir, float t0, float t1)
+{
+    if (t1 <= t0)
+        return 0.0f;
+    float closest, h2, hp;
+    RayGeometry(lightPos, origin, dir, closest, h2, hp);
+    const float a = std::sqrt(h2) / hp;
+    const float psi0 = std::atan((t0 - closest) / hp);
+    const float psi1 = std::atan((t1 - closest) / hp);
+    return (Lookup(table, a, psi1) - Lookup(table, a, psi0)) / hp;
+}
+
+float IntegrateIsotropic(const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin,
+                         const DirectX::XMFLOAT3 &dir, float t0, float t1)
+{
+    if (t1 <= t0)
+        return 0.0f;
+    float closest, h2, hp;
+    RayGeometry(lightPos, origin, dir, closest, h2, hp);
+    const float psi0 = std::atan((t0 - closest) / hp);
+    const float psi1 = std::atan((t1 - closest) / hp);
+    return (psi1 - psi0) / (4.0f * SHADER_PI * hp);
+}
+
+void SegmentProbes(const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                   float t0, float t1, float anisotropy, int count, float *outT, float *outWeight)
+{
+    float closest, h2, hp;
+    RayGeometry(lightPos, origin, dir, closest, h2, hp);
+    const float psi0 = std::atan((t0 - closest) / hp);
+    const float psi1 = std::atan((t1 - closest) / hp);
+    for (int k = 0; k < count; ++k)
+    {
+        const float psi = psi0 + ((psi1 - psi0) * ((static_cast<float>(k) + 0.5f) / static_cast<float>(count)));
+        const float u = hp * std::tan(psi);
+        outT[k] = closest + u;
+
+        // Scattering cosine: offset from the closest point over the distance to the light
+        const float distance = std::sqrt(h2 + (u * u));
+        outWeight[k] = HenyeyGreenstein(u / (std::max)(distance, 0.0001f), anisotropy);
+    }
+}
+
+} // namespace AnalyticScattering
@@ -0,0 +1,114 @@
+/**
+ * @file AnalyticScattering.h
+ * @brief Closed-form single scattering along a ray segment lit by a point light.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include "../Core/Config.h"
+
+/**
+ * @namespace AnalyticScattering
+ * @brief Integrates the volumetric shader's in-scattering term without ray marching.
+ *
+ * Inside a beam core (spot factor 1, no shadow or gobo change) the shader accumulates
+ * phase(cos) / (d^2 + 1) along the ray, d being the distance to the light. With h the distance
+ * from the light to the ray line, h' = sqrt(h^2 + 1) and u = h' tan(psi) measured from the
+ * closest point, the integrand becomes phase(cos(psi)) / h' dpsi. The isotropic part is
+ * therefore (psi1 - psi0) / h', and the Henyey-Greenstein weighted part is read from a table
+ * T(a, psi) of its running integral, with a = h / h'. The table is indexed by sqrt(a) so rows
+ * are denser close to the light, where the phase function changes fastest along the ray.
+ *
+ * shaders/volumetric.hlsl mirrors Lookup(), Integrate() and SegmentProbes().
+ */
+namespace AnalyticScattering
+{
+
+/**
+ * @struct Table
+ * @brief Running integral of the phase function for one anisotropy.
+ *
+ * Column i is at sqrt(a) = i / (width - 1), row j at psi = -pi/2 + pi * j / (height - 1).
+ * Uploaded as-is to an R32_FLOAT texture.
+ */
+struct Table
+{
+    int width = 0;
+    int height = 0;
+    float anisotropy = 0.0f;   ///< Henyey-Greenstein g the table was built for.
+    std::vector<float> values; ///< Row-major, height rows of width values.
+};
+
+/**
+ * @brief Henyey-Greenstein phase function, as in the shader.
+ */
+float HenyeyGreenstein(float cosTheta, float g);
+
+/**
+ * @brief Tabulates the phase-weighted running integral for an anisotropy.
+ *
+ * @param anisotropy Henyey-Greenstein g.
+ * @param outTable Receives the table.
+ * @param width Number of distance columns (at least 2).
+ * @param height Number of angle rows (at least 2).
+ * @return False if a size is too small.
+ */
+bool BuildTable(float anisotropy, Table &outTable, int width = Config::Volumetric::INSCATTER_TABLE_WIDTH,
+                int height = Config::Volumetric::INSCATTER_TABLE_HEIGHT);
+
+/**
+ * @brief Bilinear table read, matching a linear texture sample at texel centers.
+ *
+ * @param table Table from BuildTable().
+ * @param a h / sqrt(h^2 + 1), in [0, 1).
+ * @param psi Angle along the ray in [-pi/2, pi/2].
+ * @return Running integral of the phase function up to psi.
+ */
+float Lookup(const Table &table, float a, float psi);
+
+/**
+ * @brief Integrates phase / (d^2 + 1) over a ray segment.
+ *
+ * Multiply by intensity, color and density to get the shader's accumulated light for a
+ * segment where the spot factor, shadow and gobo are all 1.
+ *
+ * @param table Table built for the phase anisotropy.
+ * @param lightPos Light position.
+ * @param origin Ray origin.
+ * @param dir Normalized ray direction.
+ * @param t0 Segment start distance.
+ * @param t1 Segment end distance.
+ * @return The integral, 0 for an empty segment.
+ */
+float Integrate(const Table &table, const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin,
+                const DirectX::XMFLOAT3 &dir, float t0, float t1);
+
+/**
+ * @brief Closed form of Integrate() for an isotropic phase function (g = 0).
+ */
+float IntegrateIsotropic(const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin,
+                         const DirectX::XMFLOAT3 &dir, float t0, float t1);
+
+/**
+ * @brief Places shadow and gobo probes on a segment.
+ *
+ * Probes sit at the centers of equal steps in psi, so each covers the same share of the
+ * isotropic integral; the weights add the phase function. The weighted mean of the
+ * visibility at the probes scales Integrate() when shadows and gobos are not constant.
+ *
+ * @param lightPos Light position.
+ * @param origin Ray origin.
+ * @param dir Normalized ray direction.
+ * @param t0 Segment start distance.
+ * @param t1 Segment end distance.
+ * @param anisotropy Henyey-Greenstein g.
+ * @param count Number of probes.
+ * @param outT Receives count ray distances, increasing.
+ * @param outWeight Receives count phase weights.
+ */
+void SegmentProbes(const DirectX::XMFLOAT3 &lightPos, const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                   float t0, float t1, float anisotropy, int count, float *outT, float *outWeight);
+
+} // namespace AnalyticScattering
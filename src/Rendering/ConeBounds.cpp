@@ -0,0 +1,391 @@
+#include "ConeBounds.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ConeBounds
+{
+
+namespace
+{
+
+constexpr float PI = 3.14159265f;
+constexpr float MIN_CLIP_W = 0.001f; ///< View depth of the near plane the beam is clipped to.
+
+using Face = std::vector<DirectX::XMFLOAT3>;
+
+DirectX::XMFLOAT3 Add(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+DirectX::XMFLOAT3 Sub(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+DirectX::XMFLOAT3 Scale(const DirectX::XMFLOAT3 &a, float s)
+{
+    return {a.x * s, a.y * s, a.z * s};
+}
+
+float Dot(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+DirectX::XMFLOAT3 Cross(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return {(a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x)};
+}
+
+DirectX::XMFLOAT3 Normalize(const DirectX::XMFLOAT3 &v)
+{
+    const float length = std::sqrt(Dot(v, v));
+    if (length <= 0.0f)
+        return {0.0f, 0.0f, 1.0f};
+    return Scale(v, 1.0f / length);
+}
+
+/**
+ * @brief Plane n.p + d >= 0 as (n, d).
+ */
+float PlaneDistance(const DirectX::XMFLOAT4 &plane, const DirectX::XMFLOAT3 &p)
+{
+    return (plane.x * p.x) + (plane.y * p.y) + (plane.z * p.z) + plane.w;
+}
+
+/**
+ * @brief Orders points lying in a plane around their centroid, forming a convex polygon.
+ */
+void SortAroundCentroid(Face &points, const DirectX::XMFLOAT3 &normal)
+{
+    DirectX::XMFLOAT3 centroid = {0.0f, 0.0f, 0.0f};
+    for (const DirectX::XMFLOAT3 &p : points)
+        centroid = Add(centroid, p);
+    centroid = Scale(centroid, 1.0f / static_cast<float>(points.size()));
+
+    const DirectX::XMFLOAT3 side = std::fabs(normal.x) < 0.9f ? DirectX::XMFLOAT3{1.0f, 0.0f, 0.0f}
+                                                               : DirectX::XMFLOAT3{0.0f, 1.0f, 0.0f};
+    const DirectX::XMFLOAT3 u = Normalize(Cross(normal, side));
+    const DirectX::XMFLOAT3 v = Cross(normal, u);
+    std::sort(points.begin(), points.end(), [&](const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b) {
+        const DirectX::XMFLOAT3 da = Sub(a, centroid);
+        const DirectX::XMFLOAT3 db = Sub(b, centroid);
+        return std::atan2(Dot(da, v), Dot(da, u)) < std::atan2(Dot(db, v), Dot(db, u));
+    });
+}
+
+/**
+ * @brief Clips a convex polyhedron, given by its faces, to a half-space and closes the cut.
+ */
+void ClipPolyhedron(std::vector<Face> &faces, const DirectX::XMFLOAT4 &plane)
+{
+    std::vector<Face> clipped;
+    clipped.reserve(faces.size() + 1);
+    Face cap;
+    for (const Face &face : faces)
+    {
+        Face result;
+        for (size_t i = 0; i < face.size(); ++i)
+        {
+            const DirectX::XMFLOAT3 &a = face[i];
+            const DirectX::XMFLOAT3 &b = face[(i + 1) % face.size()];
+            const float da = PlaneDistance(plane, a);
+            const float db = PlaneDistance(plane, b);
+            if (da >= 0.0f)
+                result.push_back(a);
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                const DirectX::XMFLOAT3 p = Add(a, Scale(Sub(b, a), da / (da - db)));
+                result.push_back(p);
+                cap.push_back(p);
+            }
+        }
+        if (result.size() >= 3)
+            clipped.push_back(std::move(result));
+    }
+    if (cap.size() >= 3)
+    {
+        SortAroundCentroid(cap, {plane.x, plane.y, plane.z});
+        clipped.push_back(std::move(cap));
+    }
+    faces = std::move(clipped);
+}
+
+DirectX::XMFLOAT4 ToClip(const DirectX::XMFLOAT4X4 &m, const DirectX::XMFLOAT3 &p)
+{
+    return {(p.x * m._11) + (p.y * m._21) + (p.z * m._31) + m._41,
+            (p.x * m._12) + (p.y * m._22) + (p.z * m._32) + m._42,
+            (p.x * m._13) + (p.y * m._23) + (p.z * m._33) + m._43,
+            (p.x * m._14) + (p.y * m._24) + (p.z * m._34) + m._44};
+}
+
+float CrossZ(const DirectX::XMFLOAT2 &o, const DirectX::XMFLOAT2 &a, const DirectX::XMFLOAT2 &b)
+{
+    return ((a.x - o.x) * (b.y - o.y)) - ((a.y - o.y) * (b.x - o.x));
+}
+
+/**
+ * @brief Convex hull (monotone chain).
+ */
+std::vector<DirectX::XMFLOAT2> ConvexHull(std::vector<DirectX::XMFLOAT2> points)
+{
+    std::sort(points.begin(), points.end(), [](const DirectX::XMFLOAT2 &a, const DirectX::XMFLOAT2 &b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    if (points.size() < 3)
+        return points;
+
+    std::vector<DirectX::XMFLOAT2> hull(points.size() * 2);
+    size_t k = 0;
+    for (const DirectX::XMFLOAT2 &p : points)
+    {
+        while (k >= 2 && CrossZ(hull[k - 2], hull[k - 1], p) <= 0.0f)
+            --k;
+        hull[k++] = p;
+    }
+    const size_t lower = k + 1;
+    for (size_t i = points.size() - 1; i > 0; --i)
+    {
+        const DirectX::XMFLOAT2 &p = points[i - 1];
+        while (k >= lower && CrossZ(hull[k - 2], hull[k - 1], p) <= 0.0f)
+            --k;
+        hull[k++] = p;
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+/**
+ * @brief Keeps the part of a convex polygon on one side of an axis-aligned line (Sutherland-Hodgman).
+ *
+ * @param axis 0 for x, 1 for y.
+ * @param limit Line position.
+ * @param keepBelow True to keep coordinates up to the limit, false to keep those above it.
+ */
+std::vector<DirectX::XMFLOAT2> ClipToLine(const std::vector<DirectX::XMFLOAT2> &polygon, int axis, float limit,
+                                          bool keepBelow)
+{
+    std::vector<DirectX::XMFLOAT2> result;
+    const auto coordinate = [axis](const DirectX::XMFLOAT2 &p) { return axis == 0 ? p.x : p.y; };
+    const auto inside = [&](const DirectX::XMFLOAT2 &p) {
+        return keepBelow ? coordinate(p) <= limit : coordinate(p) >= limit;
+    };
+    for (size_t i = 0; i < polygon.size(); ++i)
+    {
+        const DirectX::XMFLOAT2 &a = polygon[i];
+        const DirectX::XMFLOAT2 &b = polygon[(i + 1) % polygon.size()];
+        if (inside(a))
+            result.push_back(a);
+        if (inside(a) != inside(b))
+        {
+            const float t = (limit - coordinate(a)) / (coordinate(b) - coordinate(a));
+            DirectX::XMFLOAT2 p = {a.x + ((b.x - a.x) * t), a.y + ((b.y - a.y) * t)};
+            (axis == 0 ? p.x : p.y) = limit;
+            result.push_back(p);
+        }
+    }
+    return result;
+}
+
+float PolygonArea(const std::vector<DirectX::XMFLOAT2> &polygon)
+{
+    float area = 0.0f;
+    for (size_t i = 0; i < polygon.size(); ++i)
+    {
+        const DirectX::XMFLOAT2 &a = polygon[i];
+        const DirectX::XMFLOAT2 &b = polygon[(i + 1) % polygon.size()];
+        area += (a.x * b.y) - (b.x * a.y);
+    }
+    return 0.5f * area;
+}
+
+/**
+ * @brief Checks if a rectangle overlaps a convex polygon (separating axis test).
+ *
+ * @param orientation Sign of the polygon's signed area.
+ */
+bool Overlaps(const std::vector<DirectX::XMFLOAT2> &polygon, float orientation, float x0, float y0, float x1, float y1)
+{
+    const DirectX::XMFLOAT2 corners[4] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+    for (size_t i = 0; i < polygon.size(); ++i)
+    {
+        const DirectX::XMFLOAT2 &a = polygon[i];
+        const DirectX::XMFLOAT2 &b = polygon[(i + 1) % polygon.size()];
+        bool allOutside = true;
+        for (const DirectX::XMFLOAT2 &c : corners)
+        {
+            if (CrossZ(a, b, c) * orientation >= 0.0f)
+            {
+                allOutside = false;
+                break;
+            }
+        }
+        if (allOutside)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+Bounds Compute(const SpotlightData &light, const DirectX::XMFLOAT4X4 &viewProj, const DirectX::XMFLOAT3 &cameraPos,
+               const DirectX::XMFLOAT3 &boundsMin, const DirectX::XMFLOAT3 &boundsMax)
+{
+    Bounds bounds;
+    const float range = light.posRange.w;
+    const float field = light.coneGobo.y; // Cosine of the half angle
+    if (light.colorInt.w <= 0.0f || range <= 0.0f || field <= 0.0f)
+        return bounds;
+
+    // Pyramid around the capped cone: the base polygon's inscribed circle is the cone's base
+    constexpr int SEGMENTS = Config::Volumetric::CONE_BOUNDS_SEGMENTS;
+    const float tanField = std::sqrt((std::max)(0.0f, 1.0f - (field * field))) / field;
+    const float radius = range * tanField / std::cos(PI / static_cast<float>(SEGMENTS));
+    const DirectX::XMFLOAT3 apex = {light.posRange.x, light.posRange.y, light.posRange.z};
+    const DirectX::XMFLOAT3 axis = Normalize({light.dirAngle.x, light.dirAngle.y, light.dirAngle.z});
+    const DirectX::XMFLOAT3 side = std::fabs(axis.y) < 0.99f ? DirectX::XMFLOAT3{0.0f, 1.0f, 0.0f}
+                                                              : DirectX::XMFLOAT3{1.0f, 0.0f, 0.0f};
+    const DirectX::XMFLOAT3 u = Normalize(Cross(axis, side));
+    const DirectX::XMFLOAT3 v = Cross(axis, u);
+    const DirectX::XMFLOAT3 baseCenter = Add(apex, Scale(axis, range));
+
+    Face base(SEGMENTS);
+    for (int i = 0; i < SEGMENTS; ++i)
+    {
+        const float angle = 2.0f * PI * static_cast<float>(i) / static_cast<float>(SEGMENTS);
+        base[i] = Add(baseCenter, Add(Scale(u, std::cos(angle) * radius), Scale(v, std::sin(angle) * radius)));
+    }
+    std::vector<Face> faces;
+    faces.reserve(SEGMENTS + 8);
+    for (int i = 0; i < SEGMENTS; ++i)
+        faces.push_back({apex, base[(i + 1) % SEGMENTS], base[i]});
+    faces.push_back(base);
+
+    // The room ends every camera ray; the near plane keeps the projection finite
+    const DirectX::XMFLOAT4 planes[7] = {
+        {1.0f, 0.0f, 0.0f, -boundsMin.x}, {-1.0f, 0.0f, 0.0f, boundsMax.x},
+        {0.0f, 1.0f, 0.0f, -boundsMin.y}, {0.0f, -1.0f, 0.0f, boundsMax.y},
+        {0.0f, 0.0f, 1.0f, -boundsMin.z}, {0.0f, 0.0f, -1.0f, boundsMax.z},
+        {viewProj._14, viewProj._24, viewProj._34, viewProj._44 - MIN_CLIP_W}};
+    for (const DirectX::XMFLOAT4 &plane : planes)
+    {
+        ClipPolyhedron(faces, plane);
+        if (faces.empty())
+            return bounds;
+    }
+
+    // Depth range and projected vertices
+    std::vector<DirectX::XMFLOAT2> points;
+    bounds.nearDepth = 1e30f;
+    bounds.farDepth = 0.0f;
+    for (const Face &face : faces)
+    {
+        for (const DirectX::XMFLOAT3 &p : face)
+        {
+            const DirectX::XMFLOAT4 clip = ToClip(viewProj, p);
+            const float w = (std::max)(clip.w, MIN_CLIP_W);
+            bounds.nearDepth = (std::min)(bounds.nearDepth, w);
+            bounds.farDepth = (std::max)(bounds.farDepth, w);
+            points.push_back({(clip.x / w * 0.5f) + 0.5f, 0.5f - (clip.y / w * 0.5f)});
+        }
+    }
+
+    // From inside the beam every direction may cross it
+    const DirectX::XMFLOAT3 toCamera = Sub(cameraPos, apex);
+    const float along = Dot(toCamera, axis);
+    const float across = std::sqrt((std::max)(0.0f, Dot(toCamera, toCamera) - (along * along)));
+    bounds.containsCamera = along > 0.0f && along < range && across <= along * tanField / std::cos(PI / SEGMENTS) &&
+                            cameraPos.x >= boundsMin.x && cameraPos.x <= boundsMax.x && cameraPos.y >= boundsMin.y &&
+                            cameraPos.y <= boundsMax.y && cameraPos.z >= boundsMin.z && cameraPos.z <= boundsMax.z;
+    if (bounds.containsCamera)
+    {
+        bounds.nearDepth = 0.0f;
+        bounds.outline = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    }
+    else
+    {
+        bounds.outline = ConvexHull(std::move(points));
+        for (int axisIndex = 0; axisIndex < 2 && bounds.outline.size() >= 3; ++axisIndex)
+        {
+            bounds.outline = ClipToLine(bounds.outline, axisIndex, 0.0f, false);
+            if (bounds.outline.size() >= 3)
+                bounds.outline = ClipToLine(bounds.outline, axisIndex, 1.0f, true);
+        }
+        if (bounds.outline.size() < 3)
+        {
+            bounds.outline.clear();
+            return bounds;
+        }
+    }
+
+    bounds.area = std::fabs(PolygonArea(bounds.outline));
+    bounds.visible = bounds.area > 0.0f;
+    bounds.min = bounds.outline[0];
+    bounds.max = bounds.outline[0];
+    for (const DirectX::XMFLOAT2 &p : bounds.outline)
+    {
+        bounds.min = {(std::min)(bounds.min.x, p.x), (std::min)(bounds.min.y, p.y)};
+        bounds.max = {(std::max)(bounds.max.x, p.x), (std::max)(bounds.max.y, p.y)};
+    }
+    return bounds;
+}
+
+void BuildTileMask(const std::vector<Bounds> &bounds, int width, int height, int tileSize, TileMask &outMask)
+{
+    outMask.tileSize = tileSize;
+    outMask.tilesX = (width + tileSize - 1) / tileSize;
+    outMask.tilesY = (height + tileSize - 1) / tileSize;
+    outMask.lights.assign(static_cast<size_t>(outMask.tilesX) * outMask.tilesY, 0);
+    outMask.activeTiles = 0;
+
+    const float tileU = static_cast<float>(tileSize) / static_cast<float>(width);
+    const float tileV = static_cast<float>(tileSize) / static_cast<float>(height);
+    int minX = outMask.tilesX;
+    int minY = outMask.tilesY;
+    int maxX = -1;
+    int maxY = -1;
+    for (size_t light = 0; light < bounds.size() && light < 8; ++light)
+    {
+        const Bounds &b = bounds[light];
+        if (!b.visible)
+            continue;
+
+        const uint8_t bit = static_cast<uint8_t>(1u << light);
+        const float orientation = PolygonArea(b.outline) < 0.0f ? -1.0f : 1.0f;
+        const int x0 = (std::max)(0, static_cast<int>(std::floor(b.min.x / tileU)));
+        const int y0 = (std::max)(0, static_cast<int>(std::floor(b.min.y / tileV)));
+        const int x1 = (std::min)(outMask.tilesX - 1, static_cast<int>(std::floor(b.max.x / tileU)));
+        const int y1 = (std::min)(outMask.tilesY - 1, static_cast<int>(std::floor(b.max.y / tileV)));
+        for (int ty = y0; ty <= y1; ++ty)
+        {
+            for (int tx = x0; tx <= x1; ++tx)
+            {
+                if (b.containsCamera || Overlaps(b.outline, orientation, tx * tileU, ty * tileV, (tx + 1) * tileU,
+                                                 (ty + 1) * tileV))
+                {
+                    outMask.lights[(static_cast<size_t>(ty) * outMask.tilesX) + tx] |= bit;
+                    minX = (std::min)(minX, tx);
+                    minY = (std::min)(minY, ty);
+                    maxX = (std::max)(maxX, tx);
+                    maxY = (std::max)(maxY, ty);
+                }
+            }
+        }
+    }
+
+    for (uint8_t tile : outMask.lights)
+        outMask.activeTiles += tile != 0 ? 1 : 0;
+    if (maxX < minX)
+    {
+        outMask.left = outMask.top = outMask.right = outMask.bottom = 0;
+        return;
+    }
+    outMask.left = minX * tileSize;
+    outMask.top = minY * tileSize;
+    outMask.right = (std::min)(width, (maxX + 1) * tileSize);
+    outMask.bottom = (std::min)(height, (maxY + 1) * tileSize);
+}
+
+} // namespace ConeBounds
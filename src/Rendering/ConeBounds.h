@@ -0,0 +1,93 @@
+/**
+ * @file ConeBounds.h
+ * @brief Conservative screen bounds of spotlight cones and the volumetric tile mask built from them.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Core/Config.h"
+#include "../Scene/Spotlight.h"
+
+/**
+ * @namespace ConeBounds
+ * @brief Finds where on screen, and at which depths, a light's beam can scatter light.
+ *
+ * The shader only gathers light inside the field cone and within the light's range, so the
+ * beam is contained in the cone capped at the range. That cone is replaced by a pyramid with
+ * Config::Volumetric::CONE_BOUNDS_SEGMENTS sides whose base polygon circumscribes the cone's
+ * base, so it contains the cone. The pyramid is clipped to a box (the room, which ends every
+ * camera ray) and to the camera's near plane; the projection of what remains is a convex
+ * polygon that contains every pixel whose ray can cross the beam, and the depth range of its
+ * vertices contains the depth of every point of the beam in front of the camera.
+ *
+ * BuildTileMask() marks, for each screen tile, the lights whose outline touches it, so the
+ * volumetric pass can scissor to the lit tiles and skip lights per tile.
+ */
+namespace ConeBounds
+{
+
+/**
+ * @struct Bounds
+ * @brief Screen footprint of one light's beam.
+ */
+struct Bounds
+{
+    bool visible = false;        ///< Some of the beam is in front of the camera and on screen.
+    bool containsCamera = false; ///< The camera is inside the beam: every pixel may be lit.
+    DirectX::XMFLOAT2 min = {0.0f, 0.0f}; ///< Top-left of the bounding rectangle, in [0, 1] (v down).
+    DirectX::XMFLOAT2 max = {0.0f, 0.0f}; ///< Bottom-right of the bounding rectangle.
+    float nearDepth = 0.0f;               ///< Smallest view depth of the beam in front of the camera.
+    float farDepth = 0.0f;                ///< Largest view depth.
+    float area = 0.0f;                    ///< Fraction of the screen inside the outline.
+    std::vector<DirectX::XMFLOAT2> outline; ///< Convex outline in [0, 1] screen coordinates.
+};
+
+/**
+ * @brief Computes the screen bounds of a light's beam.
+ *
+ * @param light Light as uploaded to the shader (lightViewProj is not used).
+ * @param viewProj World-to-clip matrix (row-vector convention, not transposed).
+ * @param cameraPos Camera position.
+ * @param boundsMin Lower corner of the box the beam is clipped to.
+ * @param boundsMax Upper corner of the box.
+ * @return The bounds; not visible for a light that is off, behind the camera or off screen.
+ */
+Bounds Compute(const SpotlightData &light, const DirectX::XMFLOAT4X4 &viewProj, const DirectX::XMFLOAT3 &cameraPos,
+               const DirectX::XMFLOAT3 &boundsMin, const DirectX::XMFLOAT3 &boundsMax);
+
+/**
+ * @struct TileMask
+ * @brief Lights that may be visible in each screen tile.
+ */
+struct TileMask
+{
+    int tileSize = Config::Volumetric::TILE_SIZE;
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<uint8_t> lights; ///< One byte per tile, row by row: bit i for light i.
+    int left = 0;                ///< Pixel rectangle around all marked tiles (scissor), empty if right <= left.
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+    size_t activeTiles = 0; ///< Tiles with at least one light.
+};
+
+/**
+ * @brief Marks the tiles each outline touches.
+ *
+ * A tile is marked for a light if it overlaps the light's outline (exact convex polygon test),
+ * so every pixel inside the outline is in a marked tile.
+ *
+ * @param bounds One entry per light, at most eight.
+ * @param width Screen width in pixels.
+ * @param height Screen height in pixels.
+ * @param tileSize Tile side in pixels.
+ * @param outMask Receives the mask.
+ */
+void BuildTileMask(const std::vector<Bounds> &bounds, int width, int height, int tileSize, TileMask &outMask);
+
+} // namespace ConeBounds
@@ -0,0 +1,262 @@
+#include "EpipolarSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace EpipolarSampling
+{
+
+namespace
+{
+
+constexpr float MIN_LENGTH = 1e-4f; ///< Shortest line, as a fraction of the light-to-border distance, kept valid.
+constexpr float MIN_WEIGHT = 0.05f; ///< Bilinear weight a pixel needs from matching samples.
+
+enum class Side
+{
+    Top,
+    Right,
+    Bottom,
+    Left
+};
+
+/**
+ * @brief Clips origin + t * dir to the screen rectangle.
+ * @return False if the ray's line misses the rectangle; otherwise tIn <= tOut and the side left through.
+ */
+bool ClipToScreen(const DirectX::XMFLOAT2 &origin, const DirectX::XMFLOAT2 &dir, float width, float height,
+                  float &tIn, float &tOut, Side &exitSide)
+{
+    constexpr float INF = (std::numeric_limits<float>::max)();
+    float nearX = -INF;
+    float farX = INF;
+    if (dir.x != 0.0f)
+    {
+        const float t0 = -origin.x / dir.x;
+        const float t1 = (width - origin.x) / dir.x;
+        nearX = (std::min)(t0, t1);
+        farX = (std::max)(t0, t1);
+    }
+    else if (origin.x < 0.0f || origin.x > width)
+    {
+        return false;
+    }
+
+    float nearY = -INF;
+    float farY = INF;
+    if (dir.y != 0.0f)
+    {
+        const float t0 = -origin.y / dir.y;
+        const float t1 = (height - origin.y) / dir.y;
+        nearY = (std::min)(t0, t1);
+        farY = (std::max)(t0, t1);
+    }
+    else if (origin.y < 0.0f || origin.y > height)
+    {
+        return false;
+    }
+
+    tIn = (std::max)(nearX, nearY);
+    tOut = (std::min)(farX, farY);
+    if (farX < farY)
+        exitSide = dir.x > 0.0f ? Side::Right : Side::Left;
+    else
+        exitSide = dir.y > 0.0f ? Side::Bottom : Side::Top;
+    return tIn <= tOut;
+}
+
+/**
+ * @brief Point of the border at perimeter parameter p in [0, 4): one unit per side, clockwise from the top-left.
+ */
+DirectX::XMFLOAT2 PerimeterPoint(float p, float width, float height)
+{
+    const int side = (std::min)(static_cast<int>(p), 3);
+    const float f = p - static_cast<float>(side);
+    switch (side)
+    {
+    case 0:
+        return {f * width, 0.0f};
+    case 1:
+        return {width, f * height};
+    case 2:
+        return {(1.0f - f) * width, height};
+    default:
+        return {0.0f, (1.0f - f) * height};
+    }
+}
+
+/**
+ * @brief Perimeter parameter of a border point on a given side, the inverse of PerimeterPoint().
+ */
+float PerimeterParameter(const DirectX::XMFLOAT2 &point, Side side, float width, float height)
+{
+    float p = 0.0f;
+    switch (side)
+    {
+    case Side::Top:
+        p = std::clamp(point.x / width, 0.0f, 1.0f);
+        break;
+    case Side::Right:
+        p = 1.0f + std::clamp(point.y / height, 0.0f, 1.0f);
+        break;
+    case Side::Bottom:
+        p = 2.0f + std::clamp(1.0f - (point.x / width), 0.0f, 1.0f);
+        break;
+    case Side::Left:
+        p = 3.0f + std::clamp(1.0f - (point.y / height), 0.0f, 1.0f);
+        break;
+    }
+    return p >= 4.0f ? p - 4.0f : p;
+}
+
+} // namespace
+
+bool GenerateLines(const DirectX::XMFLOAT2 &light, int width, int height, int lineCount, Lines &outLines)
+{
+    outLines = {};
+    if (width <= 0 || height <= 0 || lineCount <= 0 || lineCount % 4 != 0)
+        return false;
+
+    outLines.light = light;
+    outLines.width = static_cast<float>(width);
+    outLines.height = static_cast<float>(height);
+    outLines.lines.resize(static_cast<size_t>(lineCount));
+    for (int k = 0; k < lineCount; ++k)
+    {
+        Line &line = outLines.lines[static_cast<size_t>(k)];
+        const float p = 4.0f * static_cast<float>(k) / static_cast<float>(lineCount);
+        line.exit = PerimeterPoint(p, outLines.width, outLines.height);
+
+        // The border point ends the line only if the line crosses the screen before reaching it
+        const DirectX::XMFLOAT2 dir = {line.exit.x - light.x, line.exit.y - light.y};
+        float tIn = 0.0f;
+        float tOut = 0.0f;
+        Side side = Side::Top;
+        if (!ClipToScreen(light, dir, outLines.width, outLines.height, tIn, tOut, side))
+            continue;
+        tIn = (std::max)(tIn, 0.0f);
+        if (tIn > 1.0f - MIN_LENGTH || tOut - tIn < MIN_LENGTH)
+            continue;
+        line.entry = {light.x + (dir.x * tIn), light.y + (dir.y * tIn)};
+        line.valid = true;
+    }
+    return true;
+}
+
+DirectX::XMFLOAT2 SamplePosition(const Line &line, int sample, int sampleCount)
+{
+    const float f = static_cast<float>(sample) / static_cast<float>(sampleCount - 1);
+    return {line.entry.x + ((line.exit.x - line.entry.x) * f), line.entry.y + ((line.exit.y - line.entry.y) * f)};
+}
+
+Coordinate PixelToEpipolar(const Lines &lines, float x, float y, int sampleCount)
+{
+    const DirectX::XMFLOAT2 dir = {x - lines.light.x, y - lines.light.y};
+    float tIn = 0.0f;
+    float tOut = 0.0f;
+    Side side = Side::Top;
+    if ((dir.x * dir.x) + (dir.y * dir.y) < 1e-12f ||
+        !ClipToScreen(lines.light, dir, lines.width, lines.height, tIn, tOut, side))
+        return {};
+
+    // The line through the pixel leaves the screen where its neighbours do, and starts where they start
+    const DirectX::XMFLOAT2 exit = {lines.light.x + (dir.x * tOut), lines.light.y + (dir.y * tOut)};
+    const float p = PerimeterParameter(exit, side, lines.width, lines.height);
+    tIn = (std::max)(tIn, 0.0f);
+    const float along = (1.0f - tIn) / (std::max)(tOut - tIn, 1e-6f);
+
+    Coordinate coordinate;
+    coordinate.line = p * static_cast<float>(lines.lines.size()) / 4.0f;
+    coordinate.sample = std::clamp(along, 0.0f, 1.0f) * static_cast<float>(sampleCount - 1);
+    return coordinate;
+}
+
+bool IsBreak(float a, float b, float threshold)
+{
+    return std::fabs(a - b) > threshold * (std::min)(a, b);
+}
+
+size_t RefineLine(const float *distances, int sampleCount, int initialStep, float threshold, uint16_t *outLeft,
+                  uint16_t *outRight)
+{
+    const int step = (std::max)(initialStep, 1);
+    std::vector<uint8_t> marched(static_cast<size_t>(sampleCount));
+    size_t count = 0;
+    for (int s = 0; s < sampleCount; ++s)
+    {
+        const bool source = s % step == 0 || s == sampleCount - 1 ||
+                            (s > 0 && IsBreak(distances[s - 1], distances[s], threshold)) ||
+                            (s < sampleCount - 1 && IsBreak(distances[s], distances[s + 1], threshold));
+        marched[static_cast<size_t>(s)] = source ? 1 : 0;
+        count += source ? 1 : 0;
+    }
+
+    // Both samples around a break are sources, so the nearest sources never lie across one
+    int left = 0;
+    for (int s = 0; s < sampleCount; ++s)
+    {
+        if (marched[static_cast<size_t>(s)])
+            left = s;
+        outLeft[s] = static_cast<uint16_t>(left);
+    }
+    int right = sampleCount - 1;
+    for (int s = sampleCount - 1; s >= 0; --s)
+    {
+        if (marched[static_cast<size_t>(s)])
+            right = s;
+        outRight[s] = static_cast<uint16_t>(right);
+    }
+    return count;
+}
+
+void InterpolateLine(const uint16_t *left, const uint16_t *right, int sampleCount, DirectX::XMFLOAT3 *values)
+{
+    for (int s = 0; s < sampleCount; ++s)
+    {
+        if (left[s] == right[s])
+            continue;
+        const DirectX::XMFLOAT3 &a = values[left[s]];
+        const DirectX::XMFLOAT3 &b = values[right[s]];
+        const float f = static_cast<float>(s - left[s]) / static_cast<float>(right[s] - left[s]);
+        values[s] = {a.x + ((b.x - a.x) * f), a.y + ((b.y - a.y) * f), a.z + ((b.z - a.z) * f)};
+    }
+}
+
+bool Reconstruct(const Lines &lines, int sampleCount, const DirectX::XMFLOAT3 *values, const float *distances, float x,
+                 float y, float pixelDistance, float threshold, DirectX::XMFLOAT3 &outValue)
+{
+    const int lineCount = static_cast<int>(lines.lines.size());
+    const Coordinate coordinate = PixelToEpipolar(lines, x, y, sampleCount);
+    const float lineFloor = std::floor(coordinate.line);
+    const int line0 = static_cast<int>(lineFloor) % lineCount;
+    const int lineIndices[2] = {line0, (line0 + 1) % lineCount};
+    const float lineWeights[2] = {1.0f - (coordinate.line - lineFloor), coordinate.line - lineFloor};
+    const int sample0 = (std::min)(static_cast<int>(coordinate.sample), sampleCount - 2);
+    const float sampleFraction = coordinate.sample - static_cast<float>(sample0);
+    const float sampleWeights[2] = {1.0f - sampleFraction, sampleFraction};
+
+    DirectX::XMFLOAT3 sum = {0.0f, 0.0f, 0.0f};
+    float weightSum = 0.0f;
+    for (int j = 0; j < 2; ++j)
+    {
+        if (!lines.lines[static_cast<size_t>(lineIndices[j])].valid)
+            continue;
+        for (int k = 0; k < 2; ++k)
+        {
+            const size_t index = (static_cast<size_t>(lineIndices[j]) * sampleCount) + sample0 + k;
+            const float weight = lineWeights[j] * sampleWeights[k];
+            if (weight <= 0.0f || IsBreak(distances[index], pixelDistance, threshold))
+                continue;
+            sum.x += values[index].x * weight;
+            sum.y += values[index].y * weight;
+            sum.z += values[index].z * weight;
+            weightSum += weight;
+        }
+    }
+    if (weightSum < MIN_WEIGHT)
+        return false;
+    outValue = {sum.x / weightSum, sum.y / weightSum, sum.z / weightSum};
+    return true;
+}
+
+} // namespace EpipolarSampling
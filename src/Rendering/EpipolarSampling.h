@@ -0,0 +1,160 @@
+/**
+ * @file EpipolarSampling.h
+ * @brief Epipolar lines of a light on screen, the refinement of their samples and the reconstruction of pixels.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace EpipolarSampling
+ * @brief Places the volumetric samples of a light along lines radiating from its screen position.
+ *
+ * In-scattering from a light varies mostly across the lines through the light's projection
+ * (epipolar lines) and slowly along them, except where the scene's depth jumps. Lines are
+ * drawn from the light to points spread evenly around the screen's border, a quarter per
+ * edge, and each carries samples spaced evenly between where it enters the screen and the
+ * border. Every initial-step-th sample is ray marched, plus the samples on either side of a
+ * depth break; the others interpolate between the marched samples around them. A pixel then
+ * finds its place between two lines and two samples and blends those of the four whose depth
+ * matches its own, or is ray marched itself when none does.
+ *
+ * For a light off screen the lines start where they enter the screen; lines from the light
+ * to the near side of the screen do not cross it and are invalid. Lights behind the camera
+ * have no usable projection and are marched per pixel.
+ *
+ * This is the CPU implementation of the volumetric shader's epipolar mode, used to test it
+ * and to measure the samples it saves.
+ */
+namespace EpipolarSampling
+{
+
+/**
+ * @struct Line
+ * @brief One epipolar line, in pixel coordinates.
+ */
+struct Line
+{
+    DirectX::XMFLOAT2 entry = {0.0f, 0.0f}; ///< Position of the first sample: the light, or where the line enters.
+    DirectX::XMFLOAT2 exit = {0.0f, 0.0f};  ///< Position of the last sample, on the screen's border.
+    bool valid = false;                     ///< False when the line does not cross the screen.
+};
+
+/**
+ * @struct Lines
+ * @brief All epipolar lines of a light.
+ */
+struct Lines
+{
+    DirectX::XMFLOAT2 light = {0.0f, 0.0f}; ///< Light position in pixels (may be off screen).
+    float width = 0.0f;                     ///< Screen width in pixels.
+    float height = 0.0f;                    ///< Screen height in pixels.
+    std::vector<Line> lines;                ///< Clockwise from the top-left corner.
+};
+
+/**
+ * @struct Coordinate
+ * @brief Position of a pixel between the lines and their samples.
+ */
+struct Coordinate
+{
+    float line = 0.0f;   ///< Fractional line index, in [0, line count) (wraps around).
+    float sample = 0.0f; ///< Fractional sample index, in [0, sample count - 1].
+};
+
+/**
+ * @brief Generates the lines of a light.
+ *
+ * @param light Light position in pixels.
+ * @param width Screen width in pixels.
+ * @param height Screen height in pixels.
+ * @param lineCount Number of lines, a positive multiple of 4.
+ * @param outLines Receives the lines.
+ * @return False if the screen or line count is invalid.
+ */
+bool GenerateLines(const DirectX::XMFLOAT2 &light, int width, int height, int lineCount, Lines &outLines);
+
+/**
+ * @brief Position of a sample along a line.
+ *
+ * @param line The line.
+ * @param sample Sample index, in [0, sampleCount - 1].
+ * @param sampleCount Samples per line (at least 2).
+ * @return Position in pixels.
+ */
+DirectX::XMFLOAT2 SamplePosition(const Line &line, int sample, int sampleCount);
+
+/**
+ * @brief Finds where a screen position lies between the lines and samples.
+ *
+ * @param lines Lines of the light.
+ * @param x Position in pixels (pixel centers are at half-integers).
+ * @param y Position in pixels.
+ * @param sampleCount Samples per line (at least 2).
+ * @return The coordinate; line 0, sample 0 at the light itself.
+ */
+Coordinate PixelToEpipolar(const Lines &lines, float x, float y, int sampleCount);
+
+/**
+ * @brief Whether two neighbouring camera distances are on either side of a depth break.
+ *
+ * @param a First distance.
+ * @param b Second distance.
+ * @param threshold Relative difference above which the distances break.
+ * @return True if |a - b| exceeds threshold times the smaller one.
+ */
+bool IsBreak(float a, float b, float threshold);
+
+/**
+ * @brief Chooses the ray-marched samples of one line.
+ *
+ * Sample s is marched if it is a multiple of initialStep, the last one, or next to a depth
+ * break. Every sample gets the nearest marched samples at or before it (left) and at or
+ * after it (right) with no break in between; both are s itself for a marched sample.
+ *
+ * @param distances Camera distance at each sample.
+ * @param sampleCount Samples on the line.
+ * @param initialStep Samples between marched ones where the depth is smooth.
+ * @param threshold Relative distance difference that marks a break (see IsBreak()).
+ * @param outLeft Receives sampleCount left sources.
+ * @param outRight Receives sampleCount right sources.
+ * @return Number of marched samples.
+ */
+size_t RefineLine(const float *distances, int sampleCount, int initialStep, float threshold, uint16_t *outLeft,
+                  uint16_t *outRight);
+
+/**
+ * @brief Fills the samples that are not marched from their sources, linearly along the line.
+ *
+ * @param left Left sources from RefineLine().
+ * @param right Right sources from RefineLine().
+ * @param sampleCount Samples on the line.
+ * @param values Values per sample: read at the marched samples, written at the others.
+ */
+void InterpolateLine(const uint16_t *left, const uint16_t *right, int sampleCount, DirectX::XMFLOAT3 *values);
+
+/**
+ * @brief Reconstructs a pixel from the four samples around it.
+ *
+ * The samples are weighted bilinearly in line and sample index, those across a depth break
+ * from the pixel getting no weight.
+ *
+ * @param lines Lines of the light.
+ * @param sampleCount Samples per line.
+ * @param values Interpolated value of each sample, line-major.
+ * @param distances Camera distance of each sample, line-major.
+ * @param x Pixel position.
+ * @param y Pixel position.
+ * @param pixelDistance Camera distance of the pixel.
+ * @param threshold Relative distance difference that marks a break.
+ * @param outValue Receives the reconstructed value.
+ * @return False if too little weight remains, and the pixel must be marched.
+ */
+bool Reconstruct(const Lines &lines, int sampleCount, const DirectX::XMFLOAT3 *values, const float *distances, float x,
+                 float y, float pixelDistance, float threshold, DirectX::XMFLOAT3 &outValue);
+
+} // namespace EpipolarSampling
@@ -0,0 +1,172 @@
+/**
+ * @file Float8.h
+ * @brief Eight-lane float vector for the CPU volumetric renderers and the texture baker.
+ */
+
+#pragma once
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+/**
+ * @namespace Simd
+ * @brief Float8 wraps one AVX register, or two SSE registers on baseline x64 builds.
+ *
+ * Only the handful of operations the ray marchers and the mip downsampler need; masks are
+ * all-ones lanes as produced by the comparisons.
+ */
+namespace Simd
+{
+
+/// Lanes in a Float8.
+constexpr int LANES = 8;
+
+#if defined(__AVX__)
+struct Float8
+{
+    __m256 v;
+};
+
+inline Float8 Set1(float a)
+{
+    return {_mm256_set1_ps(a)};
+}
+inline Float8 Load(const float *p)
+{
+    return {_mm256_loadu_ps(p)};
+}
+inline void Store(float *p, Float8 a)
+{
+    _mm256_storeu_ps(p, a.v);
+}
+inline Float8 operator+(Float8 a, Float8 b)
+{
+    return {_mm256_add_ps(a.v, b.v)};
+}
+inline Float8 operator-(Float8 a, Float8 b)
+{
+    return {_mm256_sub_ps(a.v, b.v)};
+}
+inline Float8 operator*(Float8 a, Float8 b)
+{
+    return {_mm256_mul_ps(a.v, b.v)};
+}
+inline Float8 operator/(Float8 a, Float8 b)
+{
+    return {_mm256_div_ps(a.v, b.v)};
+}
+inline Float8 operator&(Float8 a, Float8 b)
+{
+    return {_mm256_and_ps(a.v, b.v)};
+}
+inline Float8 Min(Float8 a, Float8 b)
+{
+    return {_mm256_min_ps(a.v, b.v)};
+}
+inline Float8 Max(Float8 a, Float8 b)
+{
+    return {_mm256_max_ps(a.v, b.v)};
+}
+inline Float8 Sqrt(Float8 a)
+{
+    return {_mm256_sqrt_ps(a.v)};
+}
+inline Float8 Less(Float8 a, Float8 b)
+{
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+}
+/// Lanes of a where mask is set, b elsewhere.
+inline Float8 Select(Float8 mask, Float8 a, Float8 b)
+{
+    return {_mm256_blendv_ps(b.v, a.v, mask.v)};
+}
+inline int MoveMask(Float8 mask)
+{
+    return _mm256_movemask_ps(mask.v);
+}
+/// Low half: a's two halves added; high half: b's. Sums pairs of adjacent RGBA texels.
+inline Float8 SumHalves(Float8 a, Float8 b)
+{
+    return {_mm256_add_ps(_mm256_permute2f128_ps(a.v, b.v, 0x20), _mm256_permute2f128_ps(a.v, b.v, 0x31))};
+}
+#else
+struct Float8
+{
+    __m128 lo, hi;
+};
+
+inline Float8 Set1(float a)
+{
+    return {_mm_set1_ps(a), _mm_set1_ps(a)};
+}
+inline Float8 Load(const float *p)
+{
+    return {_mm_loadu_ps(p), _mm_loadu_ps(p + 4)};
+}
+inline void Store(float *p, Float8 a)
+{
+    _mm_storeu_ps(p, a.lo);
+    _mm_storeu_ps(p + 4, a.hi);
+}
+inline Float8 operator+(Float8 a, Float8 b)
+{
+    return {_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)};
+}
+inline Float8 operator-(Float8 a, Float8 b)
+{
+    return {_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)};
+}
+inline Float8 operator*(Float8 a, Float8 b)
+{
+    return {_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)};
+}
+inline Float8 operator/(Float8 a, Float8 b)
+{
+    return {_mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi)};
+}
+inline Float8 operator&(Float8 a, Float8 b)
+{
+    return {_mm_and_ps(a.lo, b.lo), _mm_and_ps(a.hi, b.hi)};
+}
+inline Float8 Min(Float8 a, Float8 b)
+{
+    return {_mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi)};
+}
+inline Float8 Max(Float8 a, Float8 b)
+{
+    return {_mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi)};
+}
+inline Float8 Sqrt(Float8 a)
+{
+    return {_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)};
+}
+inline Float8 Less(Float8 a, Float8 b)
+{
+    return {_mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi)};
+}
+/// Lanes of a where mask is set, b elsewhere.
+inline Float8 Select(Float8 mask, Float8 a, Float8 b)
+{
+    return {_mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+            _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi))};
+}
+inline int MoveMask(Float8 mask)
+{
+    return _mm_movemask_ps(mask.lo) | (_mm_movemask_ps(mask.hi) << 4);
+}
+/// Low half: a's two halves added; high half: b's. Sums pairs of adjacent RGBA texels.
+inline Float8 SumHalves(Float8 a, Float8 b)
+{
+    return {_mm_add_ps(a.lo, a.hi), _mm_add_ps(b.lo, b.hi)};
+}
+#endif
+
+inline Float8 Saturate(Float8 a)
+{
+    return Min(Max(a, Set1(0.0f)), Set1(1.0f));
+}
+
+} // namespace Simd
@@ -0,0 +1,197 @@
+#include "FroxelVolume.h"
+#include <algorithm>
+#include <cmath>
+#include "../Core/ThreadPool.h"
+
+using namespace Simd;
+
+namespace
+{
+
+/// Clip-space point back to world space, as ScreenToWorld() in the shader.
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+/// Splits a continuous grid coordinate into a clamped cell and a blend weight.
+void GridCoordinate(float coordinate, int count, int &outCell, float &outFraction)
+{
+    if (count < 2 || coordinate <= 0.0f)
+    {
+        outCell = 0;
+        outFraction = 0.0f;
+        return;
+    }
+    if (coordinate >= static_cast<float>(count - 1))
+    {
+        outCell = count - 2;
+        outFraction = 1.0f;
+        return;
+    }
+    outCell = static_cast<int>(coordinate);
+    outFraction = coordinate - static_cast<float>(outCell);
+}
+
+} // namespace
+
+FroxelVolume::FroxelVolume(int width, int height, int depth, float nearDistance, float farDistance)
+    : m_width((std::max)(width, 1)), m_height((std::max)(height, 1)), m_depth((std::max)(depth, 1)),
+      m_rowStride(((m_width + LANES - 1) / LANES) * LANES), m_planes(m_depth + 1),
+      m_near((std::max)(nearDistance, 0.0001f)), m_far((std::max)(farDistance, m_near * 1.001f)),
+      m_logRatio(std::log(m_far / m_near))
+{
+    const size_t plane = static_cast<size_t>(m_height) * m_rowStride;
+    m_rays.assign(plane * 3, 0.0f);
+    m_scattering.assign(plane * m_planes * 3, 0.0f);
+    m_integrated.assign(plane * m_planes * 3, 0.0f);
+}
+
+float FroxelVolume::BoundaryDistance(float boundary) const
+{
+    return m_near * std::exp(m_logRatio * boundary / static_cast<float>(m_depth));
+}
+
+void FroxelVolume::Inject(const VolumetricReference::Inputs &inputs)
+{
+    std::fill(m_scattering.begin(), m_scattering.end(), 0.0f);
+    m_cameraPos = inputs.cameraPos;
+
+    // Rays through the froxel column centers, shared by every slice
+    const size_t plane = static_cast<size_t>(m_height) * m_rowStride;
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (int x = 0; x < m_width; ++x)
+        {
+            const DirectX::XMFLOAT3 farPoint =
+                ScreenToWorld(inputs.invViewProj, (static_cast<float>(x) + 0.5f) / static_cast<float>(m_width),
+                              (static_cast<float>(y) + 0.5f) / static_cast<float>(m_height), 1.0f);
+            const float rx = farPoint.x - m_cameraPos.x;
+            const float ry = farPoint.y - m_cameraPos.y;
+            const float rz = farPoint.z - m_cameraPos.z;
+            const float scale = 1.0f / (std::max)(std::sqrt((rx * rx) + (ry * ry) + (rz * rz)), 0.0001f);
+            const size_t i = (static_cast<size_t>(y) * m_rowStride) + x;
+            m_rays[i] = rx * scale;
+            m_rays[plane + i] = ry * scale;
+            m_rays[(2 * plane) + i] = rz * scale;
+        }
+    }
+
+    const std::vector<VolumetricReference::LightSetup> lights = VolumetricReference::SetupLights(inputs);
+    if (lights.empty())
+        return;
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(m_depth) * m_height,
+                                     [&](size_t row) { InjectRow(inputs, lights, row); });
+}
+
+void FroxelVolume::InjectRow(const VolumetricReference::Inputs &inputs,
+                             const std::vector<VolumetricReference::LightSetup> &lights, size_t row)
+{
+    const int z = static_cast<int>(row / m_height);
+    const int y = static_cast<int>(row % m_height);
+    const float sliceStart = BoundaryDistance(static_cast<float>(z));
+    const float sliceEnd = BoundaryDistance(static_cast<float>(z + 1));
+    const Float8 distance = Set1(0.5f * (sliceStart + sliceEnd));
+    const Float8 weight = Set1(sliceEnd - sliceStart);
+    const Float8 intensity = Set1(inputs.params.params.z);
+    const Float8 zero = Set1(0.0f);
+
+    const size_t plane = static_cast<size_t>(m_height) * m_rowStride;
+    const float *rays = &m_rays[static_cast<size_t>(y) * m_rowStride];
+    alignas(32) float laneIndex[LANES];
+    for (int lane = 0; lane < LANES; ++lane)
+        laneIndex[lane] = static_cast<float>(lane);
+
+    for (int x = 0; x < m_width; x += LANES)
+    {
+        const Float8 ray[3] = {Load(rays + x), Load(rays + plane + x), Load(rays + (2 * plane) + x)};
+        const Float8 pos[3] = {Set1(m_cameraPos.x) + (ray[0] * distance), Set1(m_cameraPos.y) + (ray[1] * distance),
+                               Set1(m_cameraPos.z) + (ray[2] * distance)};
+        const Float8 active = Less(Load(laneIndex), Set1(static_cast<float>(m_width - x)));
+        Float8 rgb[3] = {zero, zero, zero};
+        for (const VolumetricReference::LightSetup &light : lights)
+            VolumetricReference::AccumulateInScatter(inputs, light, pos, ray, active, weight, rgb);
+        for (int channel = 0; channel < 3; ++channel)
+            Store(&m_scattering[Index(channel, z, y, x)], rgb[channel] * intensity);
+    }
+}
+
+void FroxelVolume::Integrate()
+{
+    // Boundary 0 stays zero; boundary z + 1 adds slice z. Columns are independent, one task per row
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(m_height) * 3,
+                                     [&](size_t item)
+                                     {
+                                         const int channel = static_cast<int>(item / m_height);
+                                         const int y = static_cast<int>(item % m_height);
+                                         for (int z = 0; z < m_depth; ++z)
+                                         {
+                                             const float *previous = &m_integrated[Index(channel, z, y, 0)];
+                                             const float *slice = &m_scattering[Index(channel, z, y, 0)];
+                                             float *next = &m_integrated[Index(channel, z + 1, y, 0)];
+                                             for (int x = 0; x < m_rowStride; x += LANES)
+                                                 Store(next + x, Load(previous + x) + Load(slice + x));
+                                         }
+                                     });
+}
+
+void FroxelVolume::Sample(float u, float v, float distance, float *outRgb) const
+{
+    int x0, y0, z0;
+    float fx, fy, fz;
+    GridCoordinate((u * static_cast<float>(m_width)) - 0.5f, m_width, x0, fx);
+    GridCoordinate((v * static_cast<float>(m_height)) - 0.5f, m_height, y0, fy);
+    const float boundary =
+        distance > m_near ? static_cast<float>(m_depth) * std::log(distance / m_near) / m_logRatio : 0.0f;
+    GridCoordinate(boundary, m_planes, z0, fz);
+    const int x1 = (std::min)(x0 + 1, m_width - 1);
+    const int y1 = (std::min)(y0 + 1, m_height - 1);
+    const int z1 = z0 + 1;
+
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        auto bilinear = [&](int z)
+        {
+            const float *row0 = &m_integrated[Index(channel, z, y0, 0)];
+            const float *row1 = &m_integrated[Index(channel, z, y1, 0)];
+            const float top = row0[x0] + (fx * (row0[x1] - row0[x0]));
+            const float bottom = row1[x0] + (fx * (row1[x1] - row1[x0]));
+            return top + (fy * (bottom - top));
+        };
+        const float front = bilinear(z0);
+        outRgb[channel] = front + (fz * (bilinear(z1) - front));
+    }
+}
+
+bool FroxelVolume::Resolve(const VolumetricReference::Inputs &inputs, std::vector<float> &outRgb) const
+{
+    if (inputs.width <= 0 || inputs.height <= 0)
+        return false;
+
+    outRgb.assign(static_cast<size_t>(inputs.width) * inputs.height * 3, 0.0f);
+    ThreadPool::Shared().ParallelFor(
+        static_cast<size_t>(inputs.height),
+        [&](size_t row)
+        {
+            const int y = static_cast<int>(row);
+            const float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(inputs.height);
+            for (int x = 0; x < inputs.width; ++x)
+            {
+                const size_t pixel = (static_cast<size_t>(y) * inputs.width) + x;
+                const float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(inputs.width);
+                const float depth = inputs.depth ? (std::min)(inputs.depth[pixel], 1.0f) : 1.0f;
+                const DirectX::XMFLOAT3 point = ScreenToWorld(inputs.invViewProj, u, v, depth);
+                const float dx = point.x - inputs.cameraPos.x;
+                const float dy = point.y - inputs.cameraPos.y;
+                const float dz = point.z - inputs.cameraPos.z;
+                Sample(u, v, std::sqrt((dx * dx) + (dy * dy) + (dz * dz)), &outRgb[pixel * 3]);
+            }
+        });
+    return true;
+}
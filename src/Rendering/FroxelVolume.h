@@ -0,0 +1,150 @@
+/**
+ * @file FroxelVolume.h
+ * @brief View-aligned froxel grid for volumetric lighting with CPU light injection.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "../Core/Config.h"
+#include "VolumetricReference.h"
+
+/**
+ * @class FroxelVolume
+ * @brief Injects spotlight in-scattering into a frustum grid and integrates it front to back.
+ *
+ * Froxel (x, y, z) covers the screen cell (x, y) between two distances along the camera ray,
+ * the slice boundaries being spaced exponentially from the near to the far distance. Inject()
+ * evaluates every light once per froxel, at the middle of its slice, with the same math as
+ * the per-pixel march (VolumetricReference::AccumulateInScatter), eight froxels of a row at a
+ * time and one task per row on the shared ThreadPool. Integrate() turns the slices into running
+ * sums from the camera, so the light gathered up to any distance is one trilinear lookup.
+ * The cost is froxels x lights instead of pixels x lights x steps.
+ *
+ * The volume has no extinction, as the shader, so integration is a plain prefix sum. Scattering
+ * nearer than the first boundary and beyond the last one is not represented.
+ */
+class FroxelVolume
+{
+public:
+    /**
+     * @brief Allocates the grid.
+     *
+     * @param width Screen columns (at least 1).
+     * @param height Screen rows (at least 1).
+     * @param depth Depth slices (at least 1).
+     * @param nearDistance First slice boundary, along the camera ray.
+     * @param farDistance Last slice boundary (greater than nearDistance).
+     */
+    explicit FroxelVolume(int width = Config::Volumetric::FROXEL_GRID_X, int height = Config::Volumetric::FROXEL_GRID_Y,
+                          int depth = Config::Volumetric::FROXEL_GRID_Z,
+                          float nearDistance = Config::Volumetric::FROXEL_NEAR,
+                          float farDistance = Config::Volumetric::FROXEL_FAR);
+
+    /**
+     * @brief Computes the in-scattering of every light in each froxel.
+     *
+     * Reads the camera, lights, textures and volumetric parameters of inputs; the output size
+     * and scene depth are ignored. The step count is not used either, slices replace steps.
+     *
+     * @param inputs Same inputs as the per-pixel renderer.
+     */
+    void Inject(const VolumetricReference::Inputs &inputs);
+
+    /**
+     * @brief Accumulates the injected slices front to back.
+     */
+    void Integrate();
+
+    /**
+     * @brief Reads the light gathered from the camera up to a distance.
+     *
+     * Trilinear between froxel centers on screen and slice boundaries in depth, with nothing
+     * gathered at the near boundary. Positions outside the grid are clamped.
+     *
+     * @param u Horizontal screen coordinate in [0, 1].
+     * @param v Vertical screen coordinate in [0, 1], down.
+     * @param distance Distance along the camera ray.
+     * @param outRgb Receives three floats.
+     */
+    void Sample(float u, float v, float distance, float *outRgb) const;
+
+    /**
+     * @brief Produces the volumetric image, one Sample() per pixel at its scene depth.
+     *
+     * Uses the camera, output size and depth of inputs, which must match the last Inject().
+     *
+     * @param inputs Same inputs as VolumetricReference::Render().
+     * @param outRgb Receives width * height * 3 floats, rows top to bottom.
+     * @return False if the size is invalid.
+     */
+    bool Resolve(const VolumetricReference::Inputs &inputs, std::vector<float> &outRgb) const;
+
+    /**
+     * @brief Gets the distance of a slice boundary.
+     * @param boundary Boundary index, 0 (near) to the depth (far); fractions interpolate.
+     */
+    [[nodiscard]] float BoundaryDistance(float boundary) const;
+
+    /**
+     * @brief Gets the injected light of one froxel, before Integrate().
+     * @param channel 0, 1 or 2 for red, green or blue.
+     */
+    [[nodiscard]] float GetScattering(int x, int y, int z, int channel) const
+    {
+        return m_scattering[Index(channel, z, y, x)];
+    }
+
+    /**
+     * @brief Gets the number of screen columns.
+     */
+    [[nodiscard]] int GetWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the number of screen rows.
+     */
+    [[nodiscard]] int GetHeight() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Gets the number of depth slices.
+     */
+    [[nodiscard]] int GetDepth() const
+    {
+        return m_depth;
+    }
+
+private:
+    /**
+     * @brief Offset of a froxel in a planar buffer of depth (or depth + 1) slices.
+     */
+    size_t Index(int channel, int z, int y, int x) const
+    {
+        return (((static_cast<size_t>(channel) * m_planes) + z) * m_height + y) * m_rowStride + x;
+    }
+
+    /**
+     * @brief Injects one row of froxels, z * height + y.
+     */
+    void InjectRow(const VolumetricReference::Inputs &inputs,
+                   const std::vector<VolumetricReference::LightSetup> &lights, size_t row);
+
+    int m_width;
+    int m_height;
+    int m_depth;
+    int m_rowStride; ///< Width rounded up to whole eight-froxel batches.
+    int m_planes;    ///< depth + 1, so both buffers share one layout.
+    float m_near;
+    float m_far;
+    float m_logRatio; ///< log(far / near).
+    DirectX::XMFLOAT3 m_cameraPos = {0.0f, 0.0f, 0.0f};
+    std::vector<float> m_rays;       ///< Normalized ray of each screen cell, x, y and z planes.
+    std::vector<float> m_scattering; ///< Light injected per froxel, r, g and b planes of depth slices.
+    std::vector<float> m_integrated; ///< Light gathered up to each boundary, depth + 1 slices (0 is zero).
+};
@@ -0,0 +1,237 @@
+#include "LightSampling.h"
+#include <algorithm>
+#include <cmath>
+#include "../Core/ThreadPool.h"
+#include "Float8.h"
+
+namespace LightSampling
+{
+
+namespace
+{
+
+using namespace Simd;
+
+/// Clip-space point back to world space, as ScreenToWorld() in the shader.
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+/**
+ * @brief Vose's alias method, with a caller-provided stack of count indices.
+ *
+ * Scaled weights average one; each column below one is topped up from a column above one,
+ * which becomes its alias. The stack holds the columns below one from the front and those
+ * at or above one from the back.
+ */
+float BuildTable(const float *weights, int count, int *stack, AliasEntry *outEntries)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i)
+        sum += weights[i];
+    if (!(sum > 0.0f))
+    {
+        for (int i = 0; i < count; ++i)
+            outEntries[i] = {1.0f, static_cast<float>(i), 0.0f, 0.0f};
+        return 0.0f;
+    }
+
+    const float scale = static_cast<float>(count) / sum;
+    int small = 0;
+    int large = count;
+    for (int i = 0; i < count; ++i)
+    {
+        outEntries[i] = {weights[i] * scale, static_cast<float>(i), weights[i] / sum, 0.0f};
+        if (outEntries[i].threshold < 1.0f)
+            stack[small++] = i;
+        else
+            stack[--large] = i;
+    }
+
+    while (small > 0 && large < count)
+    {
+        const int under = stack[--small];
+        const int over = stack[large];
+        outEntries[under].alias = static_cast<float>(over);
+        AliasEntry &donor = outEntries[over];
+        donor.threshold = (donor.threshold + outEntries[under].threshold) - 1.0f;
+        if (donor.threshold < 1.0f)
+        {
+            ++large;
+            stack[small++] = over;
+        }
+    }
+
+    // What is left is one up to rounding
+    for (int i = 0; i < small; ++i)
+        outEntries[stack[i]].threshold = 1.0f;
+    for (int i = large; i < count; ++i)
+        outEntries[stack[i]].threshold = 1.0f;
+    return sum;
+}
+
+/// Spreads a share of the probability evenly over the lights with a weight.
+void MixUniform(float *weights, int count, float uniformMix)
+{
+    float sum = 0.0f;
+    int nonZero = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        sum += weights[i];
+        nonZero += weights[i] > 0.0f ? 1 : 0;
+    }
+    if (!(sum > 0.0f))
+        return;
+
+    const float scale = (1.0f - uniformMix) / sum;
+    const float share = uniformMix / static_cast<float>(nonZero);
+    for (int i = 0; i < count; ++i)
+        weights[i] = weights[i] > 0.0f ? (weights[i] * scale) + share : 0.0f;
+}
+
+/**
+ * @brief Builds the tables of one row of tiles, eight tiles at a time.
+ */
+void BuildRow(const std::vector<Light> &lights, const DirectX::XMFLOAT4X4 &invViewProj,
+              const DirectX::XMFLOAT3 &cameraPos, int width, int height, int tileSize, float minDistance,
+              float uniformMix, Tables &tables, int ty)
+{
+    const int count = tables.lightCount;
+    const float tileU = static_cast<float>(tileSize) / static_cast<float>(width);
+    const float tileV = static_cast<float>(tileSize) / static_cast<float>(height);
+    const float minV = static_cast<float>(ty) * tileV;
+    const float maxV = static_cast<float>(ty + 1) * tileV;
+    const float centerV = 0.5f * static_cast<float>((ty * tileSize) + (std::min)((ty + 1) * tileSize, height)) /
+                          static_cast<float>(height);
+
+    std::vector<float> weights(static_cast<size_t>(count) * LANES);
+    std::vector<float> tileWeights(static_cast<size_t>(count));
+    std::vector<int> stack(static_cast<size_t>(count));
+    alignas(32) float rays[3][LANES];
+    alignas(32) float minU[LANES];
+    alignas(32) float maxU[LANES];
+    const Float8 zero = Set1(0.0f);
+
+    for (int tx0 = 0; tx0 < tables.tilesX; tx0 += LANES)
+    {
+        // Rays through the tile centers; lanes past the row repeat its last tile
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            const int tx = (std::min)(tx0 + lane, tables.tilesX - 1);
+            minU[lane] = static_cast<float>(tx) * tileU;
+            maxU[lane] = static_cast<float>(tx + 1) * tileU;
+            const float centerU = 0.5f * static_cast<float>((tx * tileSize) + (std::min)((tx + 1) * tileSize, width)) /
+                                  static_cast<float>(width);
+            const DirectX::XMFLOAT3 farPoint = ScreenToWorld(invViewProj, centerU, centerV, 1.0f);
+            const float rx = farPoint.x - cameraPos.x;
+            const float ry = farPoint.y - cameraPos.y;
+            const float rz = farPoint.z - cameraPos.z;
+            const float scale = 1.0f / (std::max)(std::sqrt((rx * rx) + (ry * ry) + (rz * rz)), 0.0001f);
+            rays[0][lane] = rx * scale;
+            rays[1][lane] = ry * scale;
+            rays[2][lane] = rz * scale;
+        }
+        const Float8 dir[3] = {Load(rays[0]), Load(rays[1]), Load(rays[2])};
+        const Float8 tileMinU = Load(minU);
+        const Float8 tileMaxU = Load(maxU);
+
+        for (int j = 0; j < count; ++j)
+        {
+            const Light &light = lights[static_cast<size_t>(j)];
+            const float overlapV = (std::min)(maxV, light.screenMax.y) - (std::max)(minV, light.screenMin.y);
+            if (light.power <= 0.0f || overlapV < 0.0f)
+            {
+                Store(&weights[static_cast<size_t>(j) * LANES], zero);
+                continue;
+            }
+
+            // Distance from the light to the ray, from the camera on
+            const Float8 toLight[3] = {Set1(light.position.x - cameraPos.x), Set1(light.position.y - cameraPos.y),
+                                       Set1(light.position.z - cameraPos.z)};
+            const Float8 along = Max((toLight[0] * dir[0]) + (toLight[1] * dir[1]) + (toLight[2] * dir[2]), zero);
+            const Float8 offset[3] = {toLight[0] - (along * dir[0]), toLight[1] - (along * dir[1]),
+                                      toLight[2] - (along * dir[2])};
+            const Float8 distance = Sqrt((offset[0] * offset[0]) + (offset[1] * offset[1]) + (offset[2] * offset[2]));
+            const Float8 weight = Set1(light.power) / Max(distance, Set1(minDistance));
+
+            // Tiles outside the beam's rectangle get nothing; touching counts, as for the tile mask
+            const Float8 overlapU = Min(tileMaxU, Set1(light.screenMax.x)) - Max(tileMinU, Set1(light.screenMin.x));
+            Store(&weights[static_cast<size_t>(j) * LANES], Select(Less(overlapU, zero), zero, weight));
+        }
+
+        const int lanes = (std::min)(LANES, tables.tilesX - tx0);
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            for (int j = 0; j < count; ++j)
+                tileWeights[static_cast<size_t>(j)] = weights[(static_cast<size_t>(j) * LANES) + lane];
+            MixUniform(tileWeights.data(), count, uniformMix);
+            const size_t tile = (static_cast<size_t>(ty) * tables.tilesX) + tx0 + lane;
+            BuildTable(tileWeights.data(), count, stack.data(), &tables.entries[tile * count]);
+        }
+    }
+}
+
+} // namespace
+
+float BuildAliasTable(const float *weights, int count, AliasEntry *outEntries)
+{
+    std::vector<int> stack(static_cast<size_t>(count));
+    return BuildTable(weights, count, stack.data(), outEntries);
+}
+
+int Sample(const AliasEntry *entries, int count, float u)
+{
+    const float x = u * static_cast<float>(count);
+    const int column = std::clamp(static_cast<int>(x), 0, count - 1);
+    return x - static_cast<float>(column) < entries[column].threshold ? column
+                                                                      : static_cast<int>(entries[column].alias);
+}
+
+float TileWeight(const Light &light, const DirectX::XMFLOAT3 &cameraPos, const DirectX::XMFLOAT3 &rayDir,
+                 const DirectX::XMFLOAT2 &tileMin, const DirectX::XMFLOAT2 &tileMax, float minDistance)
+{
+    const float overlapU = (std::min)(tileMax.x, light.screenMax.x) - (std::max)(tileMin.x, light.screenMin.x);
+    const float overlapV = (std::min)(tileMax.y, light.screenMax.y) - (std::max)(tileMin.y, light.screenMin.y);
+    if (light.power <= 0.0f || overlapU < 0.0f || overlapV < 0.0f)
+        return 0.0f;
+
+    const float lx = light.position.x - cameraPos.x;
+    const float ly = light.position.y - cameraPos.y;
+    const float lz = light.position.z - cameraPos.z;
+    const float along = (std::max)((lx * rayDir.x) + (ly * rayDir.y) + (lz * rayDir.z), 0.0f);
+    const float ox = lx - (along * rayDir.x);
+    const float oy = ly - (along * rayDir.y);
+    const float oz = lz - (along * rayDir.z);
+    const float distance = std::sqrt((ox * ox) + (oy * oy) + (oz * oz));
+    return light.power / (std::max)(distance, minDistance);
+}
+
+bool BuildTileTables(const std::vector<Light> &lights, const DirectX::XMFLOAT4X4 &invViewProj,
+                     const DirectX::XMFLOAT3 &cameraPos, int width, int height, int tileSize, float minDistance,
+                     float uniformMix, Tables &outTables)
+{
+    if (width <= 0 || height <= 0 || tileSize <= 0 || lights.empty())
+        return false;
+
+    outTables.tilesX = (width + tileSize - 1) / tileSize;
+    outTables.tilesY = (height + tileSize - 1) / tileSize;
+    outTables.lightCount = static_cast<int>(lights.size());
+    outTables.entries.resize(static_cast<size_t>(outTables.tilesX) * outTables.tilesY * lights.size());
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(outTables.tilesY),
+                                     [&](size_t row)
+                                     {
+                                         BuildRow(lights, invViewProj, cameraPos, width, height, tileSize, minDistance,
+                                                  std::clamp(uniformMix, 0.0f, 1.0f), outTables,
+                                                  static_cast<int>(row));
+                                     });
+    return true;
+}
+
+} // namespace LightSampling
@@ -0,0 +1,126 @@
+/**
+ * @file LightSampling.h
+ * @brief Per-tile alias tables for picking the lights a volumetric pixel marches.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @namespace LightSampling
+ * @brief Importance sampling of the lights each screen tile marches.
+ *
+ * With many beams, marching every light at every pixel does not scale. In this mode a pixel
+ * picks a few lights at random, from a distribution built for its tile, and divides what it
+ * gathers by their probability, so the expected result is the sum over all lights; temporal
+ * accumulation then averages the picks of successive frames.
+ *
+ * A light's weight in a tile is its power (intensity times color luminance) over the distance
+ * from the light to the camera ray through the tile's center, the in-scattering of a point
+ * light along a ray falling off roughly as one over that distance. Lights whose screen
+ * rectangle does not touch the tile get no weight, and a share of the probability is spread
+ * evenly over the others so that no light the tile can see is picked too rarely.
+ *
+ * Each tile's distribution is stored as an alias table (Vose's method): picking a light takes
+ * one uniform number and one lookup, whatever the light count. Weights are evaluated for eight
+ * tiles at a time and tile rows are built in parallel on the shared ThreadPool.
+ */
+namespace LightSampling
+{
+
+/**
+ * @struct AliasEntry
+ * @brief One column of an alias table, laid out as the shader's float4 texel.
+ */
+struct AliasEntry
+{
+    float threshold = 1.0f; ///< Keep this column's light below this fraction, take the alias above.
+    float alias = 0.0f;     ///< Index of the other light of the column (a float for the texture).
+    float pdf = 0.0f;       ///< Probability of picking this column's own light.
+    float padding = 0.0f;
+};
+
+/**
+ * @struct Light
+ * @brief What the tile weights need of a light.
+ */
+struct Light
+{
+    DirectX::XMFLOAT3 position = {0.0f, 0.0f, 0.0f};
+    float power = 0.0f;                          ///< Intensity times luminance; 0 for a light off or off screen.
+    DirectX::XMFLOAT2 screenMin = {0.0f, 0.0f}; ///< Top-left of the beam's screen rectangle, in [0, 1] (v down).
+    DirectX::XMFLOAT2 screenMax = {0.0f, 0.0f}; ///< Bottom-right of the rectangle.
+};
+
+/**
+ * @struct Tables
+ * @brief Alias tables of all tiles.
+ */
+struct Tables
+{
+    int tilesX = 0;
+    int tilesY = 0;
+    int lightCount = 0;               ///< Entries per tile.
+    std::vector<AliasEntry> entries;  ///< Tile by tile, row by row; lightCount entries each.
+};
+
+/**
+ * @brief Builds the alias table of a discrete distribution.
+ *
+ * @param weights count non-negative weights.
+ * @param count Number of outcomes (at least 1).
+ * @param outEntries Receives count entries. With a zero total every entry keeps its own
+ *        outcome with a zero pdf.
+ * @return Sum of the weights.
+ */
+float BuildAliasTable(const float *weights, int count, AliasEntry *outEntries);
+
+/**
+ * @brief Picks an outcome from an alias table.
+ *
+ * @param entries Table from BuildAliasTable().
+ * @param count Number of entries.
+ * @param u Uniform number in [0, 1).
+ * @return Outcome index.
+ */
+int Sample(const AliasEntry *entries, int count, float u);
+
+/**
+ * @brief Weight of a light for a tile, as BuildTileTables() evaluates it eight tiles at a time.
+ *
+ * @param light The light.
+ * @param cameraPos Camera position.
+ * @param rayDir Normalized direction of the ray through the tile's center.
+ * @param tileMin Top-left of the tile, in [0, 1] screen coordinates.
+ * @param tileMax Bottom-right of the tile.
+ * @param minDistance Ray-to-light distance below which the weight stops growing.
+ * @return The weight, before the uniform share is mixed in.
+ */
+float TileWeight(const Light &light, const DirectX::XMFLOAT3 &cameraPos, const DirectX::XMFLOAT3 &rayDir,
+                 const DirectX::XMFLOAT2 &tileMin, const DirectX::XMFLOAT2 &tileMax, float minDistance);
+
+/**
+ * @brief Builds the alias tables of every tile.
+ *
+ * A tile's pdf is (1 - uniformMix) times the normalized TileWeight() plus uniformMix split
+ * evenly over the lights with a non-zero weight.
+ *
+ * @param lights Lights to choose from; the table of each tile has one entry per light.
+ * @param invViewProj Clip-to-world matrix (row-vector convention, not transposed).
+ * @param cameraPos Camera position.
+ * @param width Screen width in pixels.
+ * @param height Screen height in pixels.
+ * @param tileSize Tile side in pixels.
+ * @param minDistance Ray-to-light distance below which weights stop growing.
+ * @param uniformMix Share of the probability spread evenly, in [0, 1].
+ * @param outTables Receives the tables.
+ * @return False if the screen, tile size or light list is invalid.
+ */
+bool BuildTileTables(const std::vector<Light> &lights, const DirectX::XMFLOAT4X4 &invViewProj,
+                     const DirectX::XMFLOAT3 &cameraPos, int width, int height, int tileSize, float minDistance,
+                     float uniformMix, Tables &outTables);
+
+} // namespace LightSampling
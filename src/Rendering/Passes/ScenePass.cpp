@@ -14,14 +14,31 @@ bool ScenePass::Initialize(ID3D11Device *device)
     if (!m_basicShader.LoadFromFile(device, Config::Shaders::BASIC, layout))
         return false;
 
+    // Quantized meshes: VertexQuantizer::QuantizedVertex, decoded in VSQuantized
+    std::vector<D3D11_INPUT_ELEMENT_DESC> quantizedLayout = {
+        {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    };
+
+    if (!m_quantizedShader.LoadVertexShader(device, Config::Shaders::BASIC, "VSQuantized", quantizedLayout) ||
+        !m_quantizedShader.LoadPixelShader(device, Config::Shaders::BASIC, "PS"))
+        return false;
+
     // Initialize material buffer
     if (!m_materialBuffer.Initialize(device))
         return false;
 
+    if (!m_quantizationBuffer.Initialize(device))
+        return false;
+
     // Initialize spotlight array buffer
     if (!m_spotlightArrayBuffer.Initialize(device))
         return false;
 
+    if (!m_goboFormatBuffer.Initialize(device))
+        return false;
+
     // Create no-cull rasterizer state for room rendering
     D3D11_RASTERIZER_DESC rd = {};
     rd.FillMode = D3D11_FILL_SOLID;
@@ -35,9 +52,26 @@ void ScenePass::Shutdown()
     m_noCullState.Reset();
 }
 
+void ScenePass::BindMeshShader(ID3D11DeviceContext *context, const Mesh &mesh)
+{
+    if (!mesh.IsQuantized())
+    {
+        m_basicShader.Bind(context);
+        return;
+    }
+
+    const VertexQuantizer::Bounds &bounds = mesh.GetPositionBounds();
+    QuantizationBuffer qb = {};
+    qb.boundsMin = {bounds.min.x, bounds.min.y, bounds.min.z, 0.0f};
+    qb.boundsExtent = {bounds.extent.x, bounds.extent.y, bounds.extent.z, 0.0f};
+    m_quantizationBuffer.Update(context, qb);
+    m_quantizedShader.Bind(context);
+    context->VSSetConstantBuffers(4, 1, m_quantizationBuffer.GetAddressOf());
+}
+
 void ScenePass::Execute(ID3D11DeviceContext *context, const std::vector<Spotlight> &spotlights,
                         ID3D11DepthStencilView *dsv, ID3D11Buffer *roomVb, ID3D11Buffer *roomIb, Mesh *stageMesh,
-                        float stageOffset, float roomSpecular, float roomShininess)
+                        float stageOffset, float roomSpecular, float roomShininess, unsigned int monochromeGobos)
 {
     // Update spotlight buffer
     SpotlightArrayBuffer spotData;
@@ -50,6 +84,11 @@ void ScenePass::Execute(ID3D11DeviceContext *context, const std::vector<Spotligh
     }
     m_spotlightArrayBuffer.Update(context, spotData);
 
+    // BC4 gobo arrays hold one channel, whose red stands for all three
+    GoboFormatBuffer gb = {};
+    gb.flags.x = static_cast<float>(monochromeGobos);
+    m_goboFormatBuffer.Update(context, gb);
+
     // Set viewport
     D3D11_VIEWPORT viewport = {};
     viewport.Width = static_cast<float>(Config::Display::WINDOW_WIDTH);
@@ -61,8 +100,9 @@ void ScenePass::Execute(ID3D11DeviceContext *context, const std::vector<Spotligh
     // Bind shader
     m_basicShader.Bind(context);
 
-    // Bind spotlight buffer to slot 1 (matching b1 in shader)
+    // Bind spotlight buffer to slot 1 and gobo formats to slot 5 (matching b1 and b5 in shader)
     context->PSSetConstantBuffers(1, 1, m_spotlightArrayBuffer.GetAddressOf());
+    context->PSSetConstantBuffers(5, 1, m_goboFormatBuffer.GetAddressOf());
 
     // Render Room with dark gray material
     {
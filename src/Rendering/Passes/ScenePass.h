@@ -24,6 +24,25 @@ __declspec(align(16)) struct MaterialBuffer
     DirectX::XMFLOAT4 specParams; ///< Specular parameters: x: intensity, y: shininess, zw: unused.
 };
 
+/**
+ * @struct QuantizationBuffer
+ * @brief Bounds the scene shader's VSQuantized decodes UNORM16 positions against.
+ */
+__declspec(align(16)) struct QuantizationBuffer
+{
+    DirectX::XMFLOAT4 boundsMin;    ///< xyz: minimum corner of the mesh bounds, w: unused.
+    DirectX::XMFLOAT4 boundsExtent; ///< xyz: size of the mesh bounds, w: unused.
+};
+
+/**
+ * @struct GoboFormatBuffer
+ * @brief Which lights' gobo arrays the scene shader reads as one channel.
+ */
+__declspec(align(16)) struct GoboFormatBuffer
+{
+    DirectX::XMFLOAT4 flags; ///< x: bit i set when light i's gobo array is BC4 (read red), yzw: unused.
+};
+
 /**
  * @class ScenePass
  * @brief Renders the static scene geometry, including the room and the stage.
@@ -81,10 +100,11 @@ public:
      * @param stageOffset Vertical offset for stage placement.
      * @param roomSpecular Specular intensity for the room material.
      * @param roomShininess Shininess exponent for the room material.
+     * @param monochromeGobos Bit i set when light i's gobo array is BC4 (read red for all channels).
      */
     void Execute(ID3D11DeviceContext *context, const std::vector<Spotlight> &spotlights, ID3D11DepthStencilView *dsv,
                  ID3D11Buffer *roomVb, ID3D11Buffer *roomIb, Mesh *stageMesh, float stageOffset, float roomSpecular,
-                 float roomShininess);
+                 float roomShininess, unsigned int monochromeGobos = 0);
 
     /**
      * @brief Gets the internal shader used by this pass.
@@ -95,6 +115,15 @@ public:
         return m_basicShader;
     }
 
+    /**
+     * @brief Binds the scene shader matching a mesh's vertex format: VSQuantized, with the mesh's
+     * bounds in b4, for quantized meshes, the full-precision one otherwise.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param mesh Mesh about to be drawn.
+     */
+    void BindMeshShader(ID3D11DeviceContext *context, const Mesh &mesh);
+
     /**
      * @brief Gets the material constant buffer for updating parameters.
      * @return Reference to the ConstantBuffer of MaterialBuffer.
@@ -106,8 +135,11 @@ public:
 
 private:
     Shader m_basicShader;
+    Shader m_quantizedShader; ///< Same pixel shader, VSQuantized reading QuantizedVertex.
     ConstantBuffer<MaterialBuffer> m_materialBuffer;
+    ConstantBuffer<QuantizationBuffer> m_quantizationBuffer;
     ConstantBuffer<SpotlightArrayBuffer> m_spotlightArrayBuffer;
+    ConstantBuffer<GoboFormatBuffer> m_goboFormatBuffer;
     RenderTarget *m_renderTarget = nullptr;
 
     // Rasterizer state for room (no culling)
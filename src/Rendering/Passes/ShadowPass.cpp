@@ -61,10 +61,9 @@ bool ShadowPass::Initialize(ID3D11Device *device)
         return false;
 
     // Load shadow shader
+    // Depth only needs positions: read the mesh's quantized position stream
     std::vector<D3D11_INPUT_ELEMENT_DESC> layout = {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0},
-        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
     };
     if (!m_shadowShader.LoadFromFile(device, Config::Shaders::SHADOW, layout))
         return false;
@@ -73,11 +72,72 @@ bool ShadowPass::Initialize(ID3D11Device *device)
     if (!m_matrixBuffer.Initialize(device))
         return false;
 
+    // Min/max depth mips, the first level at half the map size
+    D3D11_TEXTURE2D_DESC mmDesc = {};
+    mmDesc.Width = Config::Shadow::MAP_SIZE / 2;
+    mmDesc.Height = Config::Shadow::MAP_SIZE / 2;
+    mmDesc.MipLevels = Config::Shadow::MINMAX_LEVELS;
+    mmDesc.ArraySize = Config::Spotlight::MAX_SPOTLIGHTS;
+    mmDesc.Format = DXGI_FORMAT_R32G32_FLOAT;
+    mmDesc.SampleDesc.Count = 1;
+    mmDesc.Usage = D3D11_USAGE_DEFAULT;
+    mmDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+    hr = device->CreateTexture2D(&mmDesc, nullptr, &m_minMaxTexture);
+    if (FAILED(hr))
+        return false;
+
+    for (int level = 0; level < Config::Shadow::MINMAX_LEVELS; ++level)
+    {
+        for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+        {
+            D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = {};
+            rtvDesc.Format = mmDesc.Format;
+            rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+            rtvDesc.Texture2DArray.MipSlice = level;
+            rtvDesc.Texture2DArray.FirstArraySlice = i;
+            rtvDesc.Texture2DArray.ArraySize = 1;
+            hr = device->CreateRenderTargetView(m_minMaxTexture.Get(), &rtvDesc, &m_minMaxRTV[level][i]);
+            if (FAILED(hr))
+                return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC levelDesc = {};
+        levelDesc.Format = mmDesc.Format;
+        levelDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        levelDesc.Texture2DArray.MostDetailedMip = level;
+        levelDesc.Texture2DArray.MipLevels = 1;
+        levelDesc.Texture2DArray.FirstArraySlice = 0;
+        levelDesc.Texture2DArray.ArraySize = Config::Spotlight::MAX_SPOTLIGHTS;
+        hr = device->CreateShaderResourceView(m_minMaxTexture.Get(), &levelDesc, &m_minMaxLevelSRV[level]);
+        if (FAILED(hr))
+            return false;
+    }
+    hr = device->CreateShaderResourceView(m_minMaxTexture.Get(), nullptr, &m_minMaxSRV);
+    if (FAILED(hr))
+        return false;
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> fsLayout = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    };
+    if (!m_minMaxShader.LoadFromFile(device, Config::Shaders::SHADOW_MINMAX, fsLayout))
+        return false;
+    if (!m_minMaxBuffer.Initialize(device))
+        return false;
+
     return true;
 }
 
 void ShadowPass::Shutdown()
 {
+    m_minMaxSRV.Reset();
+    for (auto &levelSrv : m_minMaxLevelSRV)
+        levelSrv.Reset();
+    for (auto &levelRtvs : m_minMaxRTV)
+    {
+        for (auto &rtv : levelRtvs)
+            rtv.Reset();
+    }
+    m_minMaxTexture.Reset();
     m_shadowSRV.Reset();
     for (auto &dsv : m_shadowDSV)
         dsv.Reset();
@@ -86,7 +146,7 @@ void ShadowPass::Shutdown()
 }
 
 void ShadowPass::Execute(ID3D11DeviceContext *context, const SpotlightData &spotData, int lightIndex, Mesh *mesh,
-                         float stageOffset)
+                         float stageOffset, const ClusterRange *ranges, size_t rangeCount)
 {
     if (!mesh || lightIndex < 0 || lightIndex >= Config::Spotlight::MAX_SPOTLIGHTS)
         return;
@@ -110,7 +170,9 @@ void ShadowPass::Execute(ID3D11DeviceContext *context, const SpotlightData &spot
 
     // Update matrix buffer with combined light view-projection matrix
     ShadowMatrixBuffer mb;
-    mb.world = DirectX::XMMatrixTranspose(DirectX::XMMatrixTranslation(0.0f, stageOffset, 0.0f));
+    // Positions are decoded from [0, 1] to mesh space as part of the world transform
+    mb.world = DirectX::XMMatrixTranspose(mesh->GetPositionDecodeMatrix() *
+                                          DirectX::XMMatrixTranslation(0.0f, stageOffset, 0.0f));
     mb.viewProj = DirectX::XMMatrixTranspose(lightViewProj);
     mb.padding1 = DirectX::XMMatrixIdentity();
     mb.padding2 = DirectX::XMMatrixIdentity();
@@ -121,6 +183,70 @@ void ShadowPass::Execute(ID3D11DeviceContext *context, const SpotlightData &spot
     context->VSSetConstantBuffers(0, 1, m_matrixBuffer.GetAddressOf());
     m_shadowShader.Bind(context);
 
-    // Draw mesh
-    mesh->Draw(context);
+    // Draw mesh (only the clusters this light can see, when culled)
+    if (ranges)
+        mesh->DrawClusterRangePositions(context, ranges, rangeCount);
+    else
+        mesh->DrawPositions(context);
+}
+
+void ShadowPass::DrawCaster(ID3D11DeviceContext *context, const SpotlightData &spotData, Mesh *mesh,
+                            DirectX::FXMMATRIX world, size_t lod)
+{
+    if (!mesh)
+        return;
+
+    ShadowMatrixBuffer mb;
+    mb.world = DirectX::XMMatrixTranspose(mesh->GetPositionDecodeMatrix() * world);
+    mb.viewProj = spotData.lightViewProj; // Already transposed
+    mb.padding1 = DirectX::XMMatrixIdentity();
+    mb.padding2 = DirectX::XMMatrixIdentity();
+    mb.cameraPos = {0.0f, 0.0f, 0.0f, 0.0f};
+    m_matrixBuffer.Update(context, mb);
+
+    mesh->DrawPositions(context, lod);
+}
+
+void ShadowPass::BuildMinMax(ID3D11DeviceContext *context, int lightIndex, ID3D11Buffer *fullScreenVb)
+{
+    if (lightIndex < 0 || lightIndex >= Config::Spotlight::MAX_SPOTLIGHTS)
+        return;
+
+    // The scene pass reads its matrices from slot 0 of the pixel stage: put them back afterwards
+    ComPtr<ID3D11Buffer> previousBuffer;
+    context->PSGetConstantBuffers(0, 1, &previousBuffer);
+
+    m_minMaxShader.Bind(context);
+    UINT stride = Config::Vertex::STRIDE_POSITION_ONLY;
+    UINT offset = 0;
+    context->IASetVertexBuffers(0, 1, &fullScreenVb, &stride, &offset);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->PSSetConstantBuffers(0, 1, m_minMaxBuffer.GetAddressOf());
+
+    // Each level reduces 2x2 texels of the one below, the first one reads the depths
+    for (int level = 0; level < Config::Shadow::MINMAX_LEVELS; ++level)
+    {
+        context->OMSetRenderTargets(1, m_minMaxRTV[level][lightIndex].GetAddressOf(), nullptr);
+
+        D3D11_VIEWPORT vp = {};
+        vp.Width = static_cast<float>((Config::Shadow::MAP_SIZE / 2) >> level);
+        vp.Height = vp.Width;
+        vp.MinDepth = 0.0f;
+        vp.MaxDepth = 1.0f;
+        context->RSSetViewports(1, &vp);
+
+        ShadowMinMaxBuffer mb;
+        mb.params = {static_cast<float>(lightIndex), level == 0 ? 0.0f : 1.0f, 0.0f, 0.0f};
+        m_minMaxBuffer.Update(context, mb);
+
+        ID3D11ShaderResourceView *srvs[] = {m_shadowSRV.Get(), level > 0 ? m_minMaxLevelSRV[level - 1].Get() : nullptr};
+        context->PSSetShaderResources(0, 2, srvs);
+        context->Draw(6, 0);
+
+        ID3D11ShaderResourceView *nullSrvs[2] = {nullptr, nullptr};
+        context->PSSetShaderResources(0, 2, nullSrvs);
+    }
+
+    context->OMSetRenderTargets(0, nullptr, nullptr);
+    context->PSSetConstantBuffers(0, 1, previousBuffer.GetAddressOf());
 }
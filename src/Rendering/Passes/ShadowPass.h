@@ -5,6 +5,7 @@
 #include <wrl/client.h>
 #include "../../Core/Config.h"
 #include "../../Core/ConstantBuffer.h"
+#include "../../Resources/MeshData.h"
 #include "../../Resources/Shader.h"
 #include "IRenderPass.h"
 
@@ -29,12 +30,24 @@ __declspec(align(16)) struct ShadowMatrixBuffer
     DirectX::XMFLOAT4 cameraPos; ///< Unused, kept for layout alignment.
 };
 
+/**
+ * @struct ShadowMinMaxBuffer
+ * @brief Parameters of one reduction of the min/max depth mips.
+ */
+__declspec(align(16)) struct ShadowMinMaxBuffer
+{
+    DirectX::XMFLOAT4 params; ///< x: array slice, y: 0 to reduce the shadow map, 1 to reduce the previous level.
+};
+
 /**
  * @class ShadowPass
  * @brief Renders the scene's depth from each spotlight's perspective into a shadow map array.
  *
  * The generated shadow map array is used in subsequent passes (scene and volumetric)
  * to calculate shadows and light occlusion for up to MAX_SPOTLIGHTS spotlights.
+ * BuildMinMax() reduces a light's slice into min/max depth mips (see ShadowMinMax), which the
+ * volumetric pass uses to skip shadow lookups where a stretch of a beam is entirely lit or
+ * entirely shadowed.
  */
 class ShadowPass : public IRenderPass
 {
@@ -72,9 +85,32 @@ public:
      * @param lightIndex Index of the light (0 to MAX_SHADOW_LIGHTS-1).
      * @param mesh Pointer to the mesh to render (usually the stage).
      * @param stageOffset Vertical offset for the mesh.
+     * @param ranges Culled cluster ranges to draw, or nullptr to draw the whole mesh.
+     * @param rangeCount Number of ranges.
      */
     void Execute(ID3D11DeviceContext *context, const SpotlightData &spotData, int lightIndex, Mesh *mesh,
-                 float stageOffset);
+                 float stageOffset, const ClusterRange *ranges = nullptr, size_t rangeCount = 0);
+
+    /**
+     * @brief Draws an additional shadow caster into the slice bound by the last Execute() call.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param spotData Parameters of the spotlight passed to Execute().
+     * @param mesh Pointer to the mesh to render.
+     * @param world World matrix of the mesh.
+     * @param lod Level of detail to draw.
+     */
+    void DrawCaster(ID3D11DeviceContext *context, const SpotlightData &spotData, Mesh *mesh,
+                    DirectX::FXMMATRIX world, size_t lod);
+
+    /**
+     * @brief Builds the min/max depth mips of a light's slice, once all its casters are drawn.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param lightIndex Index of the light (0 to MAX_SHADOW_LIGHTS-1).
+     * @param fullScreenVb Vertex buffer for a full-screen quad.
+     */
+    void BuildMinMax(ID3D11DeviceContext *context, int lightIndex, ID3D11Buffer *fullScreenVb);
 
     /**
      * @brief Gets the shader resource view of the shadow map array.
@@ -85,6 +121,15 @@ public:
         return m_shadowSRV.Get();
     }
 
+    /**
+     * @brief Gets the shader resource view of the min/max depth mips (R32G32: min, max).
+     * @return Pointer to the min/max texture array SRV, all levels.
+     */
+    [[nodiscard]] ID3D11ShaderResourceView *GetMinMaxSRV() const
+    {
+        return m_minMaxSRV.Get();
+    }
+
     /**
      * @brief Gets the sampler state used for shadow comparison.
      * @return Pointer to the shadow sampler state.
@@ -104,4 +149,12 @@ private:
     // Shader and constant buffer
     Shader m_shadowShader;
     ConstantBuffer<ShadowMatrixBuffer> m_matrixBuffer;
+
+    // Min/max depth mips: one render target per level and slice, one input view per level
+    ComPtr<ID3D11Texture2D> m_minMaxTexture;
+    ComPtr<ID3D11RenderTargetView> m_minMaxRTV[Config::Shadow::MINMAX_LEVELS][Config::Spotlight::MAX_SPOTLIGHTS];
+    ComPtr<ID3D11ShaderResourceView> m_minMaxLevelSRV[Config::Shadow::MINMAX_LEVELS];
+    ComPtr<ID3D11ShaderResourceView> m_minMaxSRV;
+    Shader m_minMaxShader;
+    ConstantBuffer<ShadowMinMaxBuffer> m_minMaxBuffer;
 };
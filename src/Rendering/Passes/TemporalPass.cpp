@@ -0,0 +1,82 @@
+#include "TemporalPass.h"
+
+bool TemporalPass::Initialize(ID3D11Device *device)
+{
+    // Load temporal shader with position-only layout
+    std::vector<D3D11_INPUT_ELEMENT_DESC> fsLayout = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    };
+
+    if (!m_temporalShader.LoadFromFile(device, Config::Shaders::TEMPORAL, fsLayout))
+        return false;
+
+    if (!m_temporalBuffer.Initialize(device))
+        return false;
+
+    // Half floats: 8-bit targets cannot hold the small per-frame blend steps, and alpha stores distance
+    for (RenderTarget &history : m_history)
+    {
+        if (!history.Create(device, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT,
+                            DXGI_FORMAT_R16G16B16A16_FLOAT))
+            return false;
+    }
+    m_hasHistory = false;
+
+    return true;
+}
+
+void TemporalPass::Shutdown()
+{
+    for (RenderTarget &history : m_history)
+        history.Shutdown();
+    m_hasHistory = false;
+}
+
+void TemporalPass::Execute(ID3D11DeviceContext *context, RenderTarget *currentRt, RenderTarget *outputRt,
+                           ID3D11Buffer *fullScreenVb, ID3D11ShaderResourceView *depthSrv,
+                           ID3D11SamplerState *sampler, DirectX::FXMMATRIX viewProj,
+                           const DirectX::XMFLOAT3 &cameraPos, bool reset)
+{
+    TemporalBuffer tb;
+    tb.prevViewProj = DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_prevViewProj));
+    tb.prevCameraPos = {m_prevCameraPos.x, m_prevCameraPos.y, m_prevCameraPos.z, Config::Volumetric::TEMPORAL_BLEND};
+    tb.temporalParams = {reset || !m_hasHistory ? 1.0f : 0.0f, Config::Volumetric::TEMPORAL_DISTANCE_TOLERANCE,
+                         1.0f / Config::Display::WINDOW_WIDTH, 1.0f / Config::Display::WINDOW_HEIGHT};
+    m_temporalBuffer.Update(context, tb);
+
+    // Read the latest history, write the other one together with the output
+    RenderTarget &previous = m_history[m_historyIndex];
+    RenderTarget &next = m_history[1 - m_historyIndex];
+    ID3D11RenderTargetView *rtvs[] = {outputRt->GetRTV(), next.GetRTV()};
+    context->OMSetRenderTargets(2, rtvs, nullptr);
+
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = static_cast<float>(Config::Display::WINDOW_WIDTH);
+    viewport.Height = static_cast<float>(Config::Display::WINDOW_HEIGHT);
+    viewport.MinDepth = 0.0f;
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+
+    context->PSSetConstantBuffers(1, 1, m_temporalBuffer.GetAddressOf());
+    ID3D11ShaderResourceView *srvs[] = {currentRt->GetSRV(), previous.GetSRV(), depthSrv};
+    context->PSSetShaderResources(0, 3, srvs);
+    context->PSSetSamplers(0, 1, &sampler);
+
+    m_temporalShader.Bind(context);
+    UINT stride = Config::Vertex::STRIDE_POSITION_ONLY;
+    UINT offset = 0;
+    context->IASetVertexBuffers(0, 1, &fullScreenVb, &stride, &offset);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->Draw(6, 0);
+
+    // Unbind SRVs and the history target before they are used the other way round
+    ID3D11ShaderResourceView *nullSrvs[3] = {nullptr};
+    context->PSSetShaderResources(0, 3, nullSrvs);
+    ID3D11RenderTargetView *nullRtvs[2] = {nullptr};
+    context->OMSetRenderTargets(2, nullRtvs, nullptr);
+
+    m_historyIndex = 1 - m_historyIndex;
+    m_hasHistory = true;
+    DirectX::XMStoreFloat4x4(&m_prevViewProj, viewProj);
+    m_prevCameraPos = cameraPos;
+}
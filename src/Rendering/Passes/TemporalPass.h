@@ -0,0 +1,93 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <wrl/client.h>
+#include "../../Core/Config.h"
+#include "../../Core/ConstantBuffer.h"
+#include "../../Resources/Shader.h"
+#include "../RenderTarget.h"
+#include "IRenderPass.h"
+
+using Microsoft::WRL::ComPtr;
+
+/**
+ * @struct TemporalBuffer
+ * @brief Parameters for the temporal accumulation shader.
+ */
+__declspec(align(16)) struct TemporalBuffer
+{
+    DirectX::XMMATRIX prevViewProj;    ///< Previous frame's view-projection (transposed).
+    DirectX::XMFLOAT4 prevCameraPos;   ///< xyz: previous camera position, w: blend weight of the current frame.
+    DirectX::XMFLOAT4 temporalParams;  ///< x: 1 to discard the history, y: distance tolerance, zw: texel size.
+};
+
+/**
+ * @class TemporalPass
+ * @brief Accumulates the volumetric buffer over frames (see TemporalReprojection).
+ *
+ * Reprojects the previous result through last frame's camera, rejects it where the surface
+ * distance changed, clamps it to the current 3x3 neighborhood and blends. The history is kept
+ * in two half-float targets used in turn, its alpha holding each pixel's surface distance.
+ */
+class TemporalPass : public IRenderPass
+{
+public:
+    /**
+     * @brief Default constructor for the TemporalPass class.
+     */
+    TemporalPass() = default;
+
+    /**
+     * @brief Destructor for the TemporalPass class.
+     */
+    ~TemporalPass() override = default;
+
+    /**
+     * @brief Initializes the shader, constant buffer and history targets.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @return true if initialization succeeded, false otherwise.
+     */
+    bool Initialize(ID3D11Device *device) override;
+
+    /**
+     * @brief Shuts down the pass and releases resources.
+     */
+    void Shutdown() override;
+
+    /**
+     * @brief Resolves the current frame against the history.
+     *
+     * Expects the pipeline's matrix buffer (current invViewProj and camera) in slot b0.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param currentRt This frame's volumetric result.
+     * @param outputRt Receives the accumulated result.
+     * @param fullScreenVb Vertex buffer for a full-screen quad.
+     * @param depthSrv Shader resource view of the scene's depth buffer.
+     * @param sampler Linear sampler for the history.
+     * @param viewProj Current view-projection (not transposed), kept for the next frame.
+     * @param cameraPos Current camera position, kept for the next frame.
+     * @param reset True to discard the history (light change, first frame).
+     */
+    void Execute(ID3D11DeviceContext *context, RenderTarget *currentRt, RenderTarget *outputRt,
+                 ID3D11Buffer *fullScreenVb, ID3D11ShaderResourceView *depthSrv, ID3D11SamplerState *sampler,
+                 DirectX::FXMMATRIX viewProj, const DirectX::XMFLOAT3 &cameraPos, bool reset);
+
+    /**
+     * @brief Forgets the history, so the next frame starts accumulating anew.
+     */
+    void Reset()
+    {
+        m_hasHistory = false;
+    }
+
+private:
+    Shader m_temporalShader;
+    ConstantBuffer<TemporalBuffer> m_temporalBuffer;
+    RenderTarget m_history[2];
+    int m_historyIndex = 0; ///< Target holding the latest history.
+    bool m_hasHistory = false;
+    DirectX::XMFLOAT4X4 m_prevViewProj = {};
+    DirectX::XMFLOAT3 m_prevCameraPos = {0.0f, 0.0f, 0.0f};
+};
@@ -1,5 +1,30 @@
 #include "VolumetricPass.h"
-#include "../RenderTarget.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "../../Scene/HazeSimulation.h"
+
+namespace
+{
+
+// The room's walls, floor and ceiling end every beam and camera ray
+const DirectX::XMFLOAT3 ROOM_MIN = {-Config::Room::HALF_WIDTH, Config::Room::FLOOR_Y, -Config::Room::HALF_WIDTH};
+const DirectX::XMFLOAT3 ROOM_MAX = {Config::Room::HALF_WIDTH, Config::Room::CEILING_Y, Config::Room::HALF_WIDTH};
+
+// Lights nearer the camera plane than this (clip w) have no usable screen position
+constexpr float EPIPOLAR_MIN_W = 1e-3f;
+
+// Epipolar sample targets: a texel per sample, a row per line of each light
+constexpr int EPIPOLAR_ROWS = Config::Volumetric::EPIPOLAR_LINES * Config::Spotlight::MAX_SPOTLIGHTS;
+
+// Textures bound to the main draw: t0-t5 before the sample pass, t6-t7 from it, then t8; t9 the
+// haze, then a gobo array and its summed-area tables per light
+constexpr UINT VOLUMETRIC_SRV_COUNT = 10 + (2 * Config::Spotlight::MAX_SPOTLIGHTS);
+constexpr UINT GOBO_SLOT = 10;
+constexpr UINT GOBO_SAT_SLOT = GOBO_SLOT + Config::Spotlight::MAX_SPOTLIGHTS;
+
+} // namespace
 
 bool VolumetricPass::Initialize(ID3D11Device *device)
 {
@@ -11,6 +36,11 @@ bool VolumetricPass::Initialize(ID3D11Device *device)
     if (!m_volumetricShader.LoadFromFile(device, Config::Shaders::VOLUMETRIC, fsLayout))
         return false;
 
+    // Epipolar sample pass: same file, its own pixel shader
+    if (!m_epipolarShader.LoadVertexShader(device, Config::Shaders::VOLUMETRIC, "VS", fsLayout) ||
+        !m_epipolarShader.LoadPixelShader(device, Config::Shaders::VOLUMETRIC, "PSEpipolarSamples"))
+        return false;
+
     // Initialize constant buffer
     if (!m_volumetricBuffer.Initialize(device))
         return false;
@@ -19,14 +49,330 @@ bool VolumetricPass::Initialize(ID3D11Device *device)
     if (!m_spotlightArrayBuffer.Initialize(device))
         return false;
 
+    // In-scattering table texture, filled on first use
+    D3D11_TEXTURE2D_DESC tableDesc = {};
+    tableDesc.Width = Config::Volumetric::INSCATTER_TABLE_WIDTH;
+    tableDesc.Height = Config::Volumetric::INSCATTER_TABLE_HEIGHT;
+    tableDesc.MipLevels = 1;
+    tableDesc.ArraySize = 1;
+    tableDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    tableDesc.SampleDesc.Count = 1;
+    tableDesc.Usage = D3D11_USAGE_DEFAULT;
+    tableDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&tableDesc, nullptr, &m_inScatterTexture)))
+        return false;
+    if (FAILED(device->CreateShaderResourceView(m_inScatterTexture.Get(), nullptr, &m_inScatterSRV)))
+        return false;
+    m_inScatterTable = {};
+
+    // Timestamp queries for the step budget's cost model
+    D3D11_QUERY_DESC disjointDesc = {D3D11_QUERY_TIMESTAMP_DISJOINT, 0};
+    D3D11_QUERY_DESC timestampDesc = {D3D11_QUERY_TIMESTAMP, 0};
+    for (GpuTimer &timer : m_timers)
+    {
+        if (FAILED(device->CreateQuery(&disjointDesc, &timer.disjoint)) ||
+            FAILED(device->CreateQuery(&timestampDesc, &timer.begin)) ||
+            FAILED(device->CreateQuery(&timestampDesc, &timer.end)))
+            return false;
+        timer.pending = false;
+    }
+
+    // Tile mask texture, one texel per tile, and the scissor state for the tiles' rectangle
+    D3D11_TEXTURE2D_DESC maskDesc = {};
+    constexpr int TILE = Config::Volumetric::TILE_SIZE;
+    maskDesc.Width = (Config::Display::WINDOW_WIDTH + TILE - 1) / TILE;
+    maskDesc.Height = (Config::Display::WINDOW_HEIGHT + TILE - 1) / TILE;
+    maskDesc.MipLevels = 1;
+    maskDesc.ArraySize = 1;
+    maskDesc.Format = DXGI_FORMAT_R8_UINT;
+    maskDesc.SampleDesc.Count = 1;
+    maskDesc.Usage = D3D11_USAGE_DEFAULT;
+    maskDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&maskDesc, nullptr, &m_tileMaskTexture)))
+        return false;
+    if (FAILED(device->CreateShaderResourceView(m_tileMaskTexture.Get(), nullptr, &m_tileMaskSRV)))
+        return false;
+
+    // Epipolar line ends, a row per light, and the sample targets
+    D3D11_TEXTURE2D_DESC linesDesc = {};
+    linesDesc.Width = Config::Volumetric::EPIPOLAR_LINES;
+    linesDesc.Height = Config::Spotlight::MAX_SPOTLIGHTS;
+    linesDesc.MipLevels = 1;
+    linesDesc.ArraySize = 1;
+    linesDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    linesDesc.SampleDesc.Count = 1;
+    linesDesc.Usage = D3D11_USAGE_DEFAULT;
+    linesDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&linesDesc, nullptr, &m_epipolarLinesTexture)))
+        return false;
+    if (FAILED(device->CreateShaderResourceView(m_epipolarLinesTexture.Get(), nullptr, &m_epipolarLinesSRV)))
+        return false;
+    if (!m_epipolarBuffer.Initialize(device) ||
+        !m_epipolarScatterRT.Create(device, Config::Volumetric::EPIPOLAR_SAMPLES, EPIPOLAR_ROWS,
+                                    DXGI_FORMAT_R16G16B16A16_FLOAT) ||
+        !m_epipolarSourcesRT.Create(device, Config::Volumetric::EPIPOLAR_SAMPLES, EPIPOLAR_ROWS,
+                                    DXGI_FORMAT_R16G16_UINT))
+        return false;
+    m_epipolarLineEnds.assign(static_cast<size_t>(EPIPOLAR_ROWS), {-1.0f, -1.0f, -1.0f, -1.0f});
+
+    // Light alias tables, MAX_SPOTLIGHTS texels per tile
+    D3D11_TEXTURE2D_DESC tablesDesc = maskDesc;
+    tablesDesc.Width = maskDesc.Width * Config::Spotlight::MAX_SPOTLIGHTS;
+    tablesDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    if (FAILED(device->CreateTexture2D(&tablesDesc, nullptr, &m_lightTablesTexture)))
+        return false;
+    if (FAILED(device->CreateShaderResourceView(m_lightTablesTexture.Get(), nullptr, &m_lightTablesSRV)))
+        return false;
+
+    // Simulated haze density, the box cells of the grid
+    D3D11_TEXTURE3D_DESC hazeDesc = {};
+    hazeDesc.Width = Config::Haze::GRID_SIZE;
+    hazeDesc.Height = Config::Haze::GRID_SIZE;
+    hazeDesc.Depth = Config::Haze::GRID_SIZE;
+    hazeDesc.MipLevels = 1;
+    hazeDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    hazeDesc.Usage = D3D11_USAGE_DEFAULT;
+    hazeDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture3D(&hazeDesc, nullptr, &m_hazeTexture)))
+        return false;
+    if (FAILED(device->CreateShaderResourceView(m_hazeTexture.Get(), nullptr, &m_hazeSRV)))
+        return false;
+
+    D3D11_RASTERIZER_DESC rd = {};
+    rd.FillMode = D3D11_FILL_SOLID;
+    rd.CullMode = D3D11_CULL_NONE;
+    rd.DepthClipEnable = TRUE;
+    rd.ScissorEnable = TRUE;
+    if (FAILED(device->CreateRasterizerState(&rd, &m_scissorState)))
+        return false;
+
     // Set default parameters
     m_params.params = {Config::Volumetric::DEFAULT_STEP_COUNT, Config::Volumetric::DEFAULT_DENSITY,
                        Config::Volumetric::DEFAULT_INTENSITY, Config::Volumetric::DEFAULT_ANISOTROPY};
     m_params.jitter = {0.0f, 0.0f, 0.0f, 0.0f};
+    constexpr float WIDTH = static_cast<float>(Config::Display::WINDOW_WIDTH);
+    constexpr float HEIGHT = static_cast<float>(Config::Display::WINDOW_HEIGHT);
+    m_params.screen = {WIDTH, HEIGHT, 1.0f / WIDTH, 1.0f / HEIGHT};
+
+    return true;
+}
+
+void VolumetricPass::UpdateInScatterTable(ID3D11DeviceContext *context)
+{
+    if (!m_inScatterTable.values.empty() && m_inScatterTable.anisotropy == m_params.params.w)
+        return;
+
+    AnalyticScattering::BuildTable(m_params.params.w, m_inScatterTable);
+    context->UpdateSubresource(m_inScatterTexture.Get(), 0, nullptr, m_inScatterTable.values.data(),
+                               m_inScatterTable.width * sizeof(float), 0);
+}
+
+void VolumetricPass::BudgetSteps(SpotlightArrayBuffer &spotData, const std::vector<ConeBounds::Bounds> &bounds,
+                                 float maxSteps, const DirectX::XMFLOAT3 &cameraPos)
+{
+    constexpr int PIXELS = Config::Display::WINDOW_WIDTH * Config::Display::WINDOW_HEIGHT;
+
+    // Beams end at the room's walls and floor, usually well before their range
+    const size_t count = bounds.size();
+    std::vector<VolumetricBudget::LightEstimate> estimates(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SpotlightData &light = spotData.lights[i];
+        estimates[i] = VolumetricBudget::EstimateLight(light, bounds[i], cameraPos,
+                                                       VolumetricBudget::BeamLength(light, ROOM_MIN, ROOM_MAX));
+    }
+
+    // What the lights ask for, then what fits the target time once the model knows the GPU
+    const float minSteps = (std::min)(Config::Volumetric::MIN_STEP_COUNT, maxSteps);
+    std::vector<float> steps;
+    const double fullSamples = VolumetricBudget::Allocate(estimates, PIXELS, (std::numeric_limits<double>::max)(),
+                                                          minSteps, maxSteps, steps);
+    m_budgetStats.coveredPixels = VolumetricBudget::CountCoveredPixels(estimates, PIXELS);
+    m_budgetStats.fullSamples = fullSamples;
+    if (!m_stepBudget)
+    {
+        steps.assign(count, maxSteps);
+    }
+    else if (m_costModel.IsCalibrated())
+    {
+        const double fit = m_costModel.SamplesFor(Config::Volumetric::BUDGET_TARGET_MS, m_budgetStats.coveredPixels);
+        if (fit >= 0.0)
+        {
+            // Move toward the new budget over a few frames so step counts do not flicker, and
+            // never bank more than the lights ask for, so a sudden load grows in gradually
+            const double step = (fit - m_sampleBudget) * Config::Volumetric::BUDGET_SMOOTHING;
+            const double smoothed = m_sampleBudget > 0.0 ? m_sampleBudget + step : fit;
+            m_sampleBudget = (std::min)(smoothed, fullSamples);
+            if (m_sampleBudget < fullSamples)
+                VolumetricBudget::Allocate(estimates, PIXELS, m_sampleBudget, minSteps, maxSteps, steps);
+        }
+    }
+
+    m_budgetStats.samples = VolumetricBudget::CountSamples(estimates, PIXELS, steps);
+    m_budgetStats.predictedMs = m_costModel.Predict(m_budgetStats.coveredPixels, m_budgetStats.samples);
+    for (size_t i = 0; i < static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS); ++i)
+        m_budgetStats.steps[i] = i < count ? steps[i] : 0.0f;
+
+    // Zero leaves the light to the global step count
+    for (size_t i = 0; i < count; ++i)
+        spotData.lights[i].goboOff.w = m_stepBudget ? steps[i] : 0.0f;
+}
+
+void VolumetricPass::UpdateTileMask(ID3D11DeviceContext *context, SpotlightArrayBuffer &spotData,
+                                    const std::vector<ConeBounds::Bounds> &bounds)
+{
+    ConeBounds::BuildTileMask(bounds, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT,
+                              Config::Volumetric::TILE_SIZE, m_tileMask);
+    if (!m_tileMaskEnabled)
+        return;
+
+    context->UpdateSubresource(m_tileMaskTexture.Get(), 0, nullptr, m_tileMask.lights.data(),
+                               static_cast<UINT>(m_tileMask.tilesX), 0);
+
+    // No pixel nearer than the beam can reach it: view depth never exceeds the distance
+    for (size_t i = 0; i < bounds.size(); ++i)
+        spotData.lights[i].dirAngle.w = bounds[i].nearDepth;
+}
+
+bool VolumetricPass::UpdateEpipolar(ID3D11DeviceContext *context, const SpotlightArrayBuffer &spotData,
+                                    const std::vector<ConeBounds::Bounds> &bounds, const DirectX::XMFLOAT4X4 &viewProj)
+{
+    constexpr int LINES = Config::Volumetric::EPIPOLAR_LINES;
+    constexpr float WIDTH = static_cast<float>(Config::Display::WINDOW_WIDTH);
+    constexpr float HEIGHT = static_cast<float>(Config::Display::WINDOW_HEIGHT);
+
+    EpipolarBuffer epipolar = {};
+    bool any = false;
+    std::fill(m_epipolarLineEnds.begin(), m_epipolarLineEnds.end(), DirectX::XMFLOAT4(-1.0f, -1.0f, -1.0f, -1.0f));
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        if (!bounds[i].visible)
+            continue;
+
+        // Row-vector projection of the light's position; behind the camera it is marched per pixel
+        const DirectX::XMFLOAT4 &pos = spotData.lights[i].posRange;
+        const DirectX::XMFLOAT4X4 &m = viewProj;
+        const float clipX = (pos.x * m._11) + (pos.y * m._21) + (pos.z * m._31) + m._41;
+        const float clipY = (pos.x * m._12) + (pos.y * m._22) + (pos.z * m._32) + m._42;
+        const float clipW = (pos.x * m._14) + (pos.y * m._24) + (pos.z * m._34) + m._44;
+        if (clipW <= EPIPOLAR_MIN_W)
+            continue;
+        const DirectX::XMFLOAT2 light = {((clipX / clipW) * 0.5f + 0.5f) * WIDTH,
+                                         (0.5f - ((clipY / clipW) * 0.5f)) * HEIGHT};
+        if (!EpipolarSampling::GenerateLines(light, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT,
+                                             LINES, m_epipolarLines))
+            continue;
+
+        for (int k = 0; k < LINES; ++k)
+        {
+            const EpipolarSampling::Line &line = m_epipolarLines.lines[static_cast<size_t>(k)];
+            const size_t row = (i * LINES) + static_cast<size_t>(k);
+            if (line.valid)
+                m_epipolarLineEnds[row] = {line.entry.x, line.entry.y, line.exit.x, line.exit.y};
+        }
+        epipolar.lights[i] = {light.x, light.y, 1.0f, 0.0f};
+        any = true;
+    }
+    if (!any)
+        return false;
 
+    context->UpdateSubresource(m_epipolarLinesTexture.Get(), 0, nullptr, m_epipolarLineEnds.data(),
+                               LINES * sizeof(DirectX::XMFLOAT4), 0);
+    m_epipolarBuffer.Update(context, epipolar);
     return true;
 }
 
+void VolumetricPass::UpdateLightTables(ID3D11DeviceContext *context, const SpotlightArrayBuffer &spotData,
+                                       const std::vector<ConeBounds::Bounds> &bounds,
+                                       const DirectX::XMFLOAT4X4 &viewProj, const DirectX::XMFLOAT3 &cameraPos)
+{
+    // Every slot gets a table entry; lights that are off or off screen have no power
+    std::vector<LightSampling::Light> lights(Config::Spotlight::MAX_SPOTLIGHTS);
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+        const SpotlightData &data = spotData.lights[i];
+        LightSampling::Light &light = lights[i];
+        light.position = {data.posRange.x, data.posRange.y, data.posRange.z};
+        if (!bounds[i].visible || data.colorInt.w <= 0.0f)
+            continue;
+        const float luminance = (0.2126f * data.colorInt.x) + (0.7152f * data.colorInt.y) + (0.0722f * data.colorInt.z);
+        light.power = data.colorInt.w * luminance;
+        light.screenMin = bounds[i].min;
+        light.screenMax = bounds[i].max;
+    }
+
+    DirectX::XMFLOAT4X4 invViewProj;
+    DirectX::XMStoreFloat4x4(&invViewProj, DirectX::XMMatrixInverse(nullptr, DirectX::XMLoadFloat4x4(&viewProj)));
+    if (!LightSampling::BuildTileTables(lights, invViewProj, cameraPos, Config::Display::WINDOW_WIDTH,
+                                        Config::Display::WINDOW_HEIGHT, Config::Volumetric::TILE_SIZE,
+                                        Config::Volumetric::LIGHT_SAMPLING_MIN_DISTANCE,
+                                        Config::Volumetric::LIGHT_SAMPLING_UNIFORM_MIX, m_lightTables))
+        return;
+
+    const UINT rowPitch =
+        static_cast<UINT>(m_lightTables.tilesX * m_lightTables.lightCount * sizeof(LightSampling::AliasEntry));
+    context->UpdateSubresource(m_lightTablesTexture.Get(), 0, nullptr, m_lightTables.entries.data(), rowPitch, 0);
+}
+
+void VolumetricPass::MarchEpipolarSamples(ID3D11DeviceContext *context)
+{
+    ID3D11RenderTargetView *rtvs[] = {m_epipolarScatterRT.GetRTV(), m_epipolarSourcesRT.GetRTV()};
+    context->OMSetRenderTargets(2, rtvs, nullptr);
+
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = static_cast<float>(Config::Volumetric::EPIPOLAR_SAMPLES);
+    viewport.Height = static_cast<float>(EPIPOLAR_ROWS);
+    viewport.MinDepth = 0.0f;
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+
+    m_epipolarShader.Bind(context);
+    context->Draw(6, 0);
+
+    // The main draw reads the targets
+    ID3D11RenderTargetView *nullRtvs[2] = {nullptr};
+    context->OMSetRenderTargets(2, nullRtvs, nullptr);
+}
+
+void VolumetricPass::ReadTimers(ID3D11DeviceContext *context)
+{
+    for (GpuTimer &timer : m_timers)
+    {
+        if (!timer.pending)
+            continue;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        UINT64 begin = 0;
+        UINT64 end = 0;
+        const UINT flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+        if (context->GetData(timer.disjoint.Get(), &disjoint, sizeof(disjoint), flags) != S_OK ||
+            context->GetData(timer.begin.Get(), &begin, sizeof(begin), flags) != S_OK ||
+            context->GetData(timer.end.Get(), &end, sizeof(end), flags) != S_OK)
+            continue;
+
+        timer.pending = false;
+        if (disjoint.Disjoint || disjoint.Frequency == 0 || end < begin)
+            continue;
+        const double milliseconds = static_cast<double>(end - begin) * 1000.0 / static_cast<double>(disjoint.Frequency);
+        m_costModel.Observe(timer.coveredPixels, timer.samples, milliseconds);
+        m_budgetStats.measuredMs = milliseconds;
+    }
+}
+
+void VolumetricPass::UpdateHazeDensity(ID3D11DeviceContext *context, const HazeSimulation *haze)
+{
+    m_hazeActive = haze && haze->IsEnabled() && haze->GetSize() == Config::Haze::GRID_SIZE;
+    if (!m_hazeActive || haze->GetVersion() == m_hazeVersion)
+        return;
+
+    // The grid's ghost cells are skipped through the pitches, so the density is uploaded in place
+    constexpr UINT ROW = (Config::Haze::GRID_SIZE + 2) * sizeof(float);
+    const std::vector<float> &density = haze->GetDensity();
+    context->UpdateSubresource(m_hazeTexture.Get(), 0, nullptr, &density[haze->Index(1, 1, 1)], ROW,
+                               ROW * (Config::Haze::GRID_SIZE + 2));
+    m_hazeVersion = haze->GetVersion();
+}
+
 void VolumetricPass::Shutdown()
 {
     // Shader cleans up automatically via ComPtr
@@ -34,22 +380,93 @@ void VolumetricPass::Shutdown()
 
 void VolumetricPass::Execute(ID3D11DeviceContext *context, const std::vector<Spotlight> &spotlights,
                              RenderTarget *volumetricRt, ID3D11Buffer *fullScreenVb, ID3D11ShaderResourceView *depthSrv,
-                             ID3D11ShaderResourceView *goboSrv, ID3D11ShaderResourceView *shadowSrv,
-                             ID3D11SamplerState *sampler, ID3D11SamplerState *shadowSampler, float time)
+                             ID3D11ShaderResourceView *const *goboSrvs, ID3D11ShaderResourceView *const *goboSatSrvs,
+                             ID3D11ShaderResourceView *shadowSrv, ID3D11ShaderResourceView *shadowMinMaxSrv,
+                             ID3D11SamplerState *sampler, ID3D11SamplerState *shadowSampler,
+                             const DirectX::XMFLOAT4X4 &viewProj,
+                             const DirectX::XMFLOAT3 &cameraPos, float time)
 {
-    // Update jitter time
-    m_params.jitter.x = time * Config::Volumetric::JITTER_SCALE;
-    m_volumetricBuffer.Update(context, m_params);
-
     // Update spotlight buffer
     SpotlightArrayBuffer spotData;
     std::memset(&spotData, 0, sizeof(spotData)); // Clear potentially unused slots
 
     size_t count = (std::min)(spotlights.size(), static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS));
+    std::vector<SpotlightData> lights(count);
     for (size_t i = 0; i < count; ++i)
     {
         spotData.lights[i] = spotlights[i].GetGPUData();
+        lights[i] = spotData.lights[i];
+
+        // The analytic beam core assumes the open gobo (slot 0); other gobos are always marched
+        spotData.lights[i].goboOff.z = spotlights[i].GetGoboIndex() == 0 ? 1.0f : 0.0f;
+    }
+
+    // A light whose gobo moved to another array can keep its layer; that changes the light too
+    bool gobosChanged = false;
+    for (size_t i = 0; i < static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS); ++i)
+    {
+        gobosChanged = gobosChanged || goboSrvs[i] != m_prevGoboSrvs[i];
+        m_prevGoboSrvs[i] = goboSrvs[i];
+    }
+
+    // Any change to the lights or scattering parameters makes the accumulated result stale
+    const DirectX::XMFLOAT4 &params = m_params.params;
+    m_lightStateChanged = TemporalReprojection::LightStateChanged(m_prevLights, lights) || gobosChanged ||
+                          params.x != m_prevParams.x || params.y != m_prevParams.y || params.z != m_prevParams.z ||
+                          params.w != m_prevParams.w;
+    m_prevLights = std::move(lights);
+    m_prevParams = params;
+
+    // Screen bounds of the beams, cut by the room, for the step budget, the tile mask and the epipolar lines
+    std::vector<ConeBounds::Bounds> bounds(count);
+    for (size_t i = 0; i < count; ++i)
+        bounds[i] = ConeBounds::Compute(spotData.lights[i], viewProj, cameraPos, ROOM_MIN, ROOM_MAX);
+    const bool epipolar = m_epipolar && UpdateEpipolar(context, spotData, bounds, viewProj);
+
+    // Update jitter time; when accumulating, rotate the noise and march fewer steps, unless the
+    // history is about to be discarded
+    m_params.jitter.x = time * Config::Volumetric::JITTER_SCALE;
+    m_params.jitter.y = m_analyticScattering ? 1.0f : 0.0f;
+    m_params.jitter.z = m_temporal ? TemporalReprojection::NoiseOffset(m_frameIndex++) : 0.0f;
+    unsigned int features = m_tileMaskEnabled ? VOLUMETRIC_FEATURE_TILE_MASK : 0;
+    if (m_shadowIntervals && shadowMinMaxSrv)
+        features |= VOLUMETRIC_FEATURE_SHADOW_INTERVALS;
+    if (epipolar)
+        features |= VOLUMETRIC_FEATURE_EPIPOLAR;
+    if (m_lightSampling)
+        features |= VOLUMETRIC_FEATURE_LIGHT_SAMPLING;
+    if (m_hazeActive)
+        features |= VOLUMETRIC_FEATURE_HAZE;
+    bool goboSats = m_goboFootprint;
+    for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+    {
+        if (!goboSrvs[i])
+            continue;
+        goboSats = goboSats && goboSatSrvs[i];
+
+        // A BC4 gobo array reads back as (r, 0, 0, 1); the shader broadcasts red
+        D3D11_SHADER_RESOURCE_VIEW_DESC goboDesc;
+        goboSrvs[i]->GetDesc(&goboDesc);
+        if (goboDesc.Format == DXGI_FORMAT_BC4_UNORM)
+            features |= VOLUMETRIC_FEATURE_GOBO_MONO << i;
     }
+    if (goboSats)
+        features |= VOLUMETRIC_FEATURE_GOBO_SAT;
+    m_params.jitter.w = static_cast<float>(features);
+    VolumetricBuffer upload = m_params;
+    if (m_temporal && !m_lightStateChanged)
+        upload.params.x = (std::max)(Config::Volumetric::MIN_STEP_COUNT,
+                                     std::floor(params.x / Config::Volumetric::TEMPORAL_STEP_DIVISOR));
+    m_volumetricBuffer.Update(context, upload);
+    if (m_analyticScattering)
+        UpdateInScatterTable(context);
+
+    // Per-light step counts, the global count being the most any light gets
+    ReadTimers(context);
+    BudgetSteps(spotData, bounds, upload.params.x, cameraPos);
+    UpdateTileMask(context, spotData, bounds);
+    if (m_lightSampling)
+        UpdateLightTables(context, spotData, bounds, viewProj, cameraPos);
     m_spotlightArrayBuffer.Update(context, spotData);
 
     // Clear and bind volumetric render target
@@ -66,26 +483,79 @@ void VolumetricPass::Execute(ID3D11DeviceContext *context, const std::vector<Spo
     context->RSSetViewports(1, &viewport);
 
     // Bind constant buffers
-    ID3D11Buffer *buffers[] = {m_spotlightArrayBuffer.Get(), m_volumetricBuffer.Get()};
-    context->PSSetConstantBuffers(1, 2, buffers); // Start at slot 1 (SpotlightBuffer)
+    ID3D11Buffer *buffers[] = {m_spotlightArrayBuffer.Get(), m_volumetricBuffer.Get(), m_epipolarBuffer.Get()};
+    context->PSSetConstantBuffers(1, 3, buffers); // Start at slot 1 (SpotlightBuffer)
 
-    // Bind textures: depth, gobo, shadow
-    ID3D11ShaderResourceView *srvs[] = {depthSrv, goboSrv, shadowSrv};
-    context->PSSetShaderResources(0, 3, srvs);
+    // Bind textures: depth, shadow, in-scattering table, tile mask, shadow min-max, epipolar lines, the haze
+    // density, and each light's gobo array and its summed-area tables
+    ID3D11ShaderResourceView *srvs[] = {depthSrv, shadowSrv, m_inScatterSRV.Get(), m_tileMaskSRV.Get(),
+                                        shadowMinMaxSrv, m_epipolarLinesSRV.Get()};
+    context->PSSetShaderResources(0, 6, srvs);
+    context->PSSetShaderResources(9, 1, m_hazeSRV.GetAddressOf());
+    context->PSSetShaderResources(GOBO_SLOT, Config::Spotlight::MAX_SPOTLIGHTS, goboSrvs);
+    context->PSSetShaderResources(GOBO_SAT_SLOT, Config::Spotlight::MAX_SPOTLIGHTS, goboSatSrvs);
 
     // Bind samplers
     ID3D11SamplerState *samplers[] = {sampler, shadowSampler};
     context->PSSetSamplers(0, 2, samplers);
 
-    // Bind shader and draw fullscreen quad
-    m_volumetricShader.Bind(context);
+    // Bind the fullscreen quad
     UINT stride = Config::Vertex::STRIDE_POSITION_ONLY;
     UINT offset = 0;
     context->IASetVertexBuffers(0, 1, &fullScreenVb, &stride, &offset);
     context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    // Only the rectangle around the lit tiles is shaded; with no lit tile there is nothing to draw
+    if (m_tileMaskEnabled && m_tileMask.activeTiles == 0)
+    {
+        ID3D11ShaderResourceView *nullSrvs[VOLUMETRIC_SRV_COUNT] = {nullptr};
+        context->PSSetShaderResources(0, VOLUMETRIC_SRV_COUNT, nullSrvs);
+        return;
+    }
+
+    // Time the draws for the cost model, unless this timer's last measurement is still in flight
+    GpuTimer &timer = m_timers[m_timerIndex];
+    const bool timed = !timer.pending;
+    if (timed)
+    {
+        context->Begin(timer.disjoint.Get());
+        context->End(timer.begin.Get());
+    }
+
+    // Epipolar samples first, over the whole sample target, then back to the volumetric target
+    if (epipolar)
+    {
+        MarchEpipolarSamples(context);
+        volumetricRt->Bind(context);
+        context->RSSetViewports(1, &viewport);
+        ID3D11ShaderResourceView *sampleSrvs[] = {m_epipolarScatterRT.GetSRV(), m_epipolarSourcesRT.GetSRV()};
+        context->PSSetShaderResources(6, 2, sampleSrvs);
+    }
+
+    context->PSSetShaderResources(8, 1, m_lightTablesSRV.GetAddressOf());
+
+    // Only the rectangle around the lit tiles is shaded
+    if (m_tileMaskEnabled)
+    {
+        const D3D11_RECT scissor = {m_tileMask.left, m_tileMask.top, m_tileMask.right, m_tileMask.bottom};
+        context->RSSetState(m_scissorState.Get());
+        context->RSSetScissorRects(1, &scissor);
+    }
+    m_volumetricShader.Bind(context);
     context->Draw(6, 0);
+    if (timed)
+    {
+        context->End(timer.end.Get());
+        context->End(timer.disjoint.Get());
+        timer.pending = true;
+        timer.coveredPixels = m_budgetStats.coveredPixels;
+        timer.samples = m_budgetStats.samples;
+        m_timerIndex = (m_timerIndex + 1) % Config::Volumetric::BUDGET_TIMER_FRAMES;
+    }
+    if (m_tileMaskEnabled)
+        context->RSSetState(nullptr);
 
     // Unbind SRVs to avoid conflicts
-    ID3D11ShaderResourceView *nullSrvs[3] = {nullptr};
-    context->PSSetShaderResources(0, 3, nullSrvs);
+    ID3D11ShaderResourceView *nullSrvs[VOLUMETRIC_SRV_COUNT] = {nullptr};
+    context->PSSetShaderResources(0, VOLUMETRIC_SRV_COUNT, nullSrvs);
 }
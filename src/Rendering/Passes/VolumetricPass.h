@@ -7,29 +7,36 @@
 #include "../../Core/ConstantBuffer.h"
 #include "../../Resources/Shader.h"
 #include "../../Scene/Spotlight.h"
+#include "../AnalyticScattering.h"
+#include "../ConeBounds.h"
+#include "../EpipolarSampling.h"
+#include "../LightSampling.h"
+#include "../RenderTarget.h"
+#include "../TemporalReprojection.h"
+#include "../VolumetricBudget.h"
+#include "../VolumetricBuffer.h"
 #include "IRenderPass.h"
 
 using Microsoft::WRL::ComPtr;
 
-class RenderTarget;
+class HazeSimulation;
 
 /**
- * @struct VolumetricBuffer
- * @brief Parameters for the volumetric lighting (ray marching) shader.
+ * @struct SpotlightArrayBuffer
+ * @brief Array of spotlights for the volumetric shader.
  */
-__declspec(align(16)) struct VolumetricBuffer
+__declspec(align(16)) struct SpotlightArrayBuffer
 {
-    DirectX::XMFLOAT4 params; ///< x: stepCount, y: density, z: intensity, w: anisotropy.
-    DirectX::XMFLOAT4 jitter; ///< x: time-based jitter offset, yzw: unused.
+    SpotlightData lights[Config::Spotlight::MAX_SPOTLIGHTS];
 };
 
 /**
- * @struct SpotlightArrayBuffer
- * @brief Array of spotlights for the volumetric shader.
+ * @struct EpipolarBuffer
+ * @brief Screen positions of the lights whose in-scattering comes from epipolar samples.
  */
-__declspec(align(16)) struct SpotlightArrayBuffer
+__declspec(align(16)) struct EpipolarBuffer
 {
-    SpotlightData lights[Config::Spotlight::MAX_SPOTLIGHTS];
+    DirectX::XMFLOAT4 lights[Config::Spotlight::MAX_SPOTLIGHTS]; ///< xy: position in pixels, z: 1 if sampled.
 };
 
 /**
@@ -38,6 +45,46 @@ __declspec(align(16)) struct SpotlightArrayBuffer
  *
  * This pass renders the spotlight's cone by sampling the shadow map and gobo texture
  * along rays from the camera, creating the "god rays" or "volumetric lighting" effect.
+ * For lights with the open gobo, the unshadowed core of the beam can be integrated in
+ * closed form (see AnalyticScattering) so only the beam's falloff is ray marched.
+ * When the result is accumulated over frames (TemporalPass), the march noise is rotated every
+ * frame and the step count divided by Config::Volumetric::TEMPORAL_STEP_DIVISOR, except on
+ * frames where the lights changed and the history is discarded.
+ *
+ * With step budgeting on, each light gets its own step count (see VolumetricBudget), at most
+ * the global one, fitted to the samples a CostModel expects to take
+ * Config::Volumetric::BUDGET_TARGET_MS. The model is calibrated from GPU timestamps of the
+ * draw, read back a few frames later without stalling.
+ *
+ * With the tile mask on, the screen bounds of every beam (see ConeBounds) mark the
+ * Config::Volumetric::TILE_SIZE tiles each light can reach. The draw is scissored to the
+ * rectangle around the marked tiles and skipped when there is none; the shader reads the
+ * mask to return early in unmarked tiles and to skip lights per tile, and the nearest depth
+ * of each beam (dirAngle.w) to skip lights in front of the scene's depth.
+ *
+ * With shadow intervals on, each march is cut into Config::Volumetric::SHADOW_INTERVALS
+ * groups of strata, which the shader classifies against the shadow map's min/max mips
+ * (see ShadowMinMax): fully shadowed groups are skipped and fully lit ones sample the
+ * gobo only. The sample positions do not change, so neither does the image.
+ *
+ * With epipolar sampling on, the lights in front of the camera are marched only at samples
+ * along lines from their screen position (see EpipolarSampling): a first draw renders one
+ * texel per sample, finds the interpolation sources around it and marches the sources; the
+ * main draw then blends, per pixel and light, the samples around it that match its depth,
+ * and marches the pixel where none does.
+ *
+ * With light sampling on, a pixel marches LIGHT_SAMPLES lights picked from its tile's alias
+ * table (see LightSampling) instead of every light, dividing by their probability; the picks
+ * change with the per-frame noise, so temporal accumulation is what removes the noise.
+ *
+ * With gobo footprint filtering on and the gobo's summed-area tables given (see
+ * SummedAreaTable), a march step that spans more than GOBO_SAT_MIN_FOOTPRINT gobo texels
+ * either side averages the gobo over the step's bounding box instead of taking one bilinear
+ * sample, so coarse steps do not alias fine gobo patterns.
+ *
+ * With a haze simulation enabled (see HazeSimulation), its density grid is uploaded to a 3D
+ * texture whenever it ticks, and the march and the analytic cores' probes scale the density
+ * parameter by the simulated density at each sample.
  */
 class VolumetricPass : public IRenderPass
 {
@@ -73,16 +120,36 @@ public:
      * @param volumetricRt The render target where the volumetric effect will be rendered.
      * @param fullScreenVb Vertex buffer for a full-screen quad.
      * @param depthSrv Shader resource view of the scene's depth buffer.
-     * @param goboSrv Shader resource view of the spotlight's gobo texture.
+     * @param goboSrvs Gobo texture array of each light (MAX_SPOTLIGHTS entries, nullptr for none).
+     * @param goboSatSrvs Summed-area tables of those arrays (MAX_SPOTLIGHTS entries); if any light
+     *        with a gobo has none, the gobos are always sampled bilinearly.
      * @param shadowSrv Shader resource view of the light's shadow map.
+     * @param shadowMinMaxSrv Shader resource view of the shadow map's min/max depth mips.
      * @param sampler Linear sampler for texture sampling.
      * @param shadowSampler Comparison sampler for shadow map sampling.
+     * @param viewProj Camera world-to-clip matrix (not transposed), for the step budget.
+     * @param cameraPos Camera position, for the step budget.
      * @param time Total elapsed time used for jittering.
      */
     void Execute(ID3D11DeviceContext *context, const std::vector<Spotlight> &spotlights, RenderTarget *volumetricRt,
-                 ID3D11Buffer *fullScreenVb, ID3D11ShaderResourceView *depthSrv, ID3D11ShaderResourceView *goboSrv,
-                 ID3D11ShaderResourceView *shadowSrv, ID3D11SamplerState *sampler, ID3D11SamplerState *shadowSampler,
-                 float time);
+                 ID3D11Buffer *fullScreenVb, ID3D11ShaderResourceView *depthSrv,
+                 ID3D11ShaderResourceView *const *goboSrvs, ID3D11ShaderResourceView *const *goboSatSrvs,
+                 ID3D11ShaderResourceView *shadowSrv,
+                 ID3D11ShaderResourceView *shadowMinMaxSrv, ID3D11SamplerState *sampler,
+                 ID3D11SamplerState *shadowSampler, const DirectX::XMFLOAT4X4 &viewProj,
+                 const DirectX::XMFLOAT3 &cameraPos, float time);
+
+    /**
+     * @brief Uploads the simulated haze density if it has changed since the last upload.
+     *
+     * Until the next call, the march scales the density parameter by the simulated density;
+     * without a simulation, with a disabled one or one of another grid size than
+     * Config::Haze::GRID_SIZE, the haze is uniform.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param haze The haze simulation, or nullptr.
+     */
+    void UpdateHazeDensity(ID3D11DeviceContext *context, const HazeSimulation *haze);
 
     /**
      * @brief Gets a reference to the internal volumetric parameters.
@@ -111,9 +178,291 @@ public:
         return m_volumetricBuffer;
     }
 
+    /**
+     * @brief Enables or disables analytic integration of unshadowed beam cores.
+     * @param enabled True to integrate beam cores analytically, false to ray march everything.
+     */
+    void SetAnalyticScatteringEnabled(bool enabled)
+    {
+        m_analyticScattering = enabled;
+    }
+
+    /**
+     * @brief Checks if analytic integration of beam cores is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsAnalyticScatteringEnabled() const
+    {
+        return m_analyticScattering;
+    }
+
+    /**
+     * @brief Enables or disables the per-frame jitter and reduced step count for temporal accumulation.
+     * @param enabled True when TemporalPass accumulates this pass's output.
+     */
+    void SetTemporalEnabled(bool enabled)
+    {
+        m_temporal = enabled;
+    }
+
+    /**
+     * @brief Checks if the pass renders for temporal accumulation.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsTemporalEnabled() const
+    {
+        return m_temporal;
+    }
+
+    /**
+     * @brief Enables or disables per-light step counts fitted to the GPU time budget.
+     * @param enabled True to budget steps per light, false to march every light with the global count.
+     */
+    void SetStepBudgetEnabled(bool enabled)
+    {
+        m_stepBudget = enabled;
+    }
+
+    /**
+     * @brief Checks if per-light step budgeting is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsStepBudgetEnabled() const
+    {
+        return m_stepBudget;
+    }
+
+    /**
+     * @brief Enables or disables the screen tile mask and scissor built from the beams' bounds.
+     * @param enabled True to only shade the tiles and lights the beams reach, false to shade everything.
+     */
+    void SetTileMaskEnabled(bool enabled)
+    {
+        m_tileMaskEnabled = enabled;
+    }
+
+    /**
+     * @brief Checks if the tile mask is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsTileMaskEnabled() const
+    {
+        return m_tileMaskEnabled;
+    }
+
+    /**
+     * @brief Enables or disables the lit/shadowed classification of march intervals.
+     * @param enabled True to skip shadow lookups where the min/max mips decide, false to sample every step.
+     */
+    void SetShadowIntervalsEnabled(bool enabled)
+    {
+        m_shadowIntervals = enabled;
+    }
+
+    /**
+     * @brief Checks if the classification of march intervals is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsShadowIntervalsEnabled() const
+    {
+        return m_shadowIntervals;
+    }
+
+    /**
+     * @brief Enables or disables epipolar sample placement.
+     * @param enabled True to march the lights' epipolar samples and interpolate pixels from them.
+     */
+    void SetEpipolarEnabled(bool enabled)
+    {
+        m_epipolar = enabled;
+    }
+
+    /**
+     * @brief Checks if epipolar sample placement is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsEpipolarEnabled() const
+    {
+        return m_epipolar;
+    }
+
+    /**
+     * @brief Enables or disables stochastic light selection from per-tile alias tables.
+     * @param enabled True to march a few picked lights per pixel instead of all of them.
+     */
+    void SetLightSamplingEnabled(bool enabled)
+    {
+        m_lightSampling = enabled;
+    }
+
+    /**
+     * @brief Checks if stochastic light selection is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsLightSamplingEnabled() const
+    {
+        return m_lightSampling;
+    }
+
+    /**
+     * @brief Enables or disables box filtering of the gobo over each march step's footprint.
+     * @param enabled True to average the gobo from its summed-area tables where steps are coarse.
+     */
+    void SetGoboFootprintEnabled(bool enabled)
+    {
+        m_goboFootprint = enabled;
+    }
+
+    /**
+     * @brief Checks if gobo footprint filtering is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsGoboFootprintEnabled() const
+    {
+        return m_goboFootprint;
+    }
+
+    /**
+     * @brief Gets the tile mask of the last Execute().
+     * @return Lights per tile, active tile count and scissor rectangle.
+     */
+    [[nodiscard]] const ConeBounds::TileMask &GetTileMask() const
+    {
+        return m_tileMask;
+    }
+
+    /**
+     * @brief Gets the step budget of the last Execute().
+     * @return Step counts, samples and predicted and measured GPU time.
+     */
+    [[nodiscard]] const VolumetricBudget::Stats &GetBudgetStats() const
+    {
+        return m_budgetStats;
+    }
+
+    /**
+     * @brief Checks whether the lights or parameters of the last Execute() invalidate the history.
+     * @return True if the accumulated result must be discarded.
+     */
+    [[nodiscard]] bool HasLightStateChanged() const
+    {
+        return m_lightStateChanged;
+    }
+
 private:
+    /**
+     * @brief GPU timestamps around one frame's draw and the budget they measure.
+     */
+    struct GpuTimer
+    {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        bool pending = false;
+        double coveredPixels = 0.0;
+        double samples = 0.0;
+    };
+
+    /**
+     * @brief Rebuilds and uploads the in-scattering table when the anisotropy has changed.
+     */
+    void UpdateInScatterTable(ID3D11DeviceContext *context);
+
+    /**
+     * @brief Chooses the step count of each light and writes it to goboOff.w.
+     */
+    void BudgetSteps(SpotlightArrayBuffer &spotData, const std::vector<ConeBounds::Bounds> &bounds, float maxSteps,
+                     const DirectX::XMFLOAT3 &cameraPos);
+
+    /**
+     * @brief Builds and uploads the tile mask and writes each beam's nearest depth to dirAngle.w.
+     */
+    void UpdateTileMask(ID3D11DeviceContext *context, SpotlightArrayBuffer &spotData,
+                        const std::vector<ConeBounds::Bounds> &bounds);
+
+    /**
+     * @brief Generates and uploads the epipolar lines of the visible lights in front of the camera.
+     * @return False if no light has any, and the sample draw can be skipped.
+     */
+    bool UpdateEpipolar(ID3D11DeviceContext *context, const SpotlightArrayBuffer &spotData,
+                        const std::vector<ConeBounds::Bounds> &bounds, const DirectX::XMFLOAT4X4 &viewProj);
+
+    /**
+     * @brief Builds and uploads the lights' alias tables for each tile.
+     */
+    void UpdateLightTables(ID3D11DeviceContext *context, const SpotlightArrayBuffer &spotData,
+                           const std::vector<ConeBounds::Bounds> &bounds, const DirectX::XMFLOAT4X4 &viewProj,
+                           const DirectX::XMFLOAT3 &cameraPos);
+
+    /**
+     * @brief Marches the epipolar samples into the sample targets, with the inputs of the main draw bound.
+     */
+    void MarchEpipolarSamples(ID3D11DeviceContext *context);
+
+    /**
+     * @brief Feeds the timings that have arrived to the cost model, without waiting for the others.
+     */
+    void ReadTimers(ID3D11DeviceContext *context);
+
     Shader m_volumetricShader;
     ConstantBuffer<VolumetricBuffer> m_volumetricBuffer;
     ConstantBuffer<SpotlightArrayBuffer> m_spotlightArrayBuffer;
     VolumetricBuffer m_params;
+
+    // Phase integral table for the analytic path, rebuilt when the anisotropy changes
+    ComPtr<ID3D11Texture2D> m_inScatterTexture;
+    ComPtr<ID3D11ShaderResourceView> m_inScatterSRV;
+    AnalyticScattering::Table m_inScatterTable;
+    bool m_analyticScattering = true;
+
+    // Temporal accumulation state: frame counter for the noise offset, last frame's lights and gobo arrays
+    bool m_temporal = true;
+    uint32_t m_frameIndex = 0;
+    bool m_lightStateChanged = true;
+    std::vector<SpotlightData> m_prevLights;
+    ID3D11ShaderResourceView *m_prevGoboSrvs[Config::Spotlight::MAX_SPOTLIGHTS] = {}; // Identity only, not owned
+    DirectX::XMFLOAT4 m_prevParams = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    // Step budgeting: cost model, smoothed sample budget and timestamp queries in flight
+    bool m_stepBudget = true;
+    VolumetricBudget::CostModel m_costModel;
+    VolumetricBudget::Stats m_budgetStats;
+    double m_sampleBudget = 0.0;
+    GpuTimer m_timers[Config::Volumetric::BUDGET_TIMER_FRAMES];
+    int m_timerIndex = 0;
+
+    // Tile mask: lights per screen tile (R8_UINT) and the scissor state that clips the draw to it
+    bool m_tileMaskEnabled = true;
+    ConeBounds::TileMask m_tileMask;
+    ComPtr<ID3D11Texture2D> m_tileMaskTexture;
+    ComPtr<ID3D11ShaderResourceView> m_tileMaskSRV;
+    ComPtr<ID3D11RasterizerState> m_scissorState;
+
+    bool m_shadowIntervals = true;
+
+    // Epipolar sampling: line ends per light, and per sample the in-scattering, distance and sources
+    bool m_epipolar = false;
+    Shader m_epipolarShader;
+    ConstantBuffer<EpipolarBuffer> m_epipolarBuffer;
+    EpipolarSampling::Lines m_epipolarLines;
+    std::vector<DirectX::XMFLOAT4> m_epipolarLineEnds;
+    ComPtr<ID3D11Texture2D> m_epipolarLinesTexture;
+    ComPtr<ID3D11ShaderResourceView> m_epipolarLinesSRV;
+    RenderTarget m_epipolarScatterRT;
+    RenderTarget m_epipolarSourcesRT;
+
+    // Stochastic light selection: alias tables of every tile, MAX_SPOTLIGHTS texels each
+    bool m_lightSampling = false;
+    LightSampling::Tables m_lightTables;
+    ComPtr<ID3D11Texture2D> m_lightTablesTexture;
+    ComPtr<ID3D11ShaderResourceView> m_lightTablesSRV;
+
+    // Gobo lookups averaged over the march step's footprint, from the gobo's summed-area tables
+    bool m_goboFootprint = true;
+
+    // Simulated haze density over the room; versions start at 1, so 0 means nothing uploaded
+    bool m_hazeActive = false;
+    size_t m_hazeVersion = 0;
+    ComPtr<ID3D11Texture3D> m_hazeTexture;
+    ComPtr<ID3D11ShaderResourceView> m_hazeSRV;
 };
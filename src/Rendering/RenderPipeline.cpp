@@ -1,8 +1,11 @@
 #include "RenderPipeline.h"
+#include "../Core/GraphicsDevice.h"
 #include "../Geometry/GeometryGenerator.h"
+#include "../Scene/LodSelector.h"
 #include "../Resources/Mesh.h"
 #include "../Resources/Texture.h"
 #include "../Scene/MeshNode.h"
+#include "../Scene/ShadowCasters.h"
 
 RenderPipeline::~RenderPipeline()
 {
@@ -11,35 +14,69 @@ RenderPipeline::~RenderPipeline()
 
 bool RenderPipeline::Initialize(ID3D11Device *device)
 {
-    m_device = device;
+    // Initialize all passes
+    for (const auto &pass : CreatePasses())
+    {
+        if (!pass.second->Initialize(device))
+            return false;
+    }
+    if (!CreateSharedResources(device))
+        return false;
+    ConfigurePasses();
+    return true;
+}
 
+TaskGraph::TaskId RenderPipeline::AddTasks(TaskGraph &graph, const GraphicsDevice &graphics,
+                                           TaskGraph::TaskId deviceTask)
+{
+    // Device creation methods are free-threaded, so each pass compiles its shaders on its own
+    std::vector<TaskGraph::TaskId> tasks;
+    for (const auto &[name, pass] : CreatePasses())
+    {
+        IRenderPass *renderPass = pass; // Structured bindings cannot be captured in C++17
+        auto initialize = [&graphics, renderPass]() { return renderPass->Initialize(graphics.GetDevice()); };
+        tasks.push_back(graph.Add(std::string(name) + " pass", initialize, {deviceTask}));
+    }
+    auto createShared = [this, &graphics]() { return CreateSharedResources(graphics.GetDevice()); };
+    tasks.push_back(graph.Add("pipeline resources", createShared, {deviceTask}));
+
+    auto configure = [this]()
+    {
+        ConfigurePasses();
+        return true;
+    };
+    return graph.Add("render pipeline", configure, tasks);
+}
+
+std::vector<std::pair<const char *, IRenderPass *>> RenderPipeline::CreatePasses()
+{
     // Create render passes
     m_shadowPass = std::make_unique<ShadowPass>();
     m_scenePass = std::make_unique<ScenePass>();
     m_volumetricPass = std::make_unique<VolumetricPass>();
+    m_temporalPass = std::make_unique<TemporalPass>();
     m_blurPass = std::make_unique<BlurPass>();
     m_compositePass = std::make_unique<CompositePass>();
     m_fxaaPass = std::make_unique<FXAAPass>();
 
-    // Initialize all passes
-    if (!m_shadowPass->Initialize(device))
-        return false;
-    if (!m_scenePass->Initialize(device))
-        return false;
-    if (!m_volumetricPass->Initialize(device))
-        return false;
-    if (!m_blurPass->Initialize(device))
-        return false;
-    if (!m_compositePass->Initialize(device))
-        return false;
-    if (!m_fxaaPass->Initialize(device))
-        return false;
+    return {{"shadow", m_shadowPass.get()},         {"scene", m_scenePass.get()},
+            {"volumetric", m_volumetricPass.get()}, {"temporal", m_temporalPass.get()},
+            {"blur", m_blurPass.get()},             {"composite", m_compositePass.get()},
+            {"FXAA", m_fxaaPass.get()}};
+}
+
+bool RenderPipeline::CreateSharedResources(ID3D11Device *device)
+{
+    m_device = device;
 
     // Create shared render targets
     if (!m_sceneRT.Create(device, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT))
         return false;
     if (!m_volRT.Create(device, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT))
         return false;
+    if (!m_volCurrentRT.Create(device, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT,
+                               DXGI_FORMAT_R16G16B16A16_FLOAT))
+        return false;
     if (!m_blurTempRT.Create(device, Config::Display::WINDOW_WIDTH, Config::Display::WINDOW_HEIGHT))
         return false;
 
@@ -75,6 +112,11 @@ bool RenderPipeline::Initialize(ID3D11Device *device)
     if (!m_ceilingLightsBuffer.Initialize(device))
         return false;
 
+    return true;
+}
+
+void RenderPipeline::ConfigurePasses()
+{
     // Set scene render target for scene pass
     m_scenePass->SetRenderTarget(&m_sceneRT);
 
@@ -83,8 +125,7 @@ bool RenderPipeline::Initialize(ID3D11Device *device)
                                             Config::Volumetric::DEFAULT_INTENSITY,
                                             Config::Volumetric::DEFAULT_ANISOTROPY};
     m_volumetricPass->GetParams().jitter = {0.0f, 0.0f, 0.0f, 0.0f};
-
-    return true;
+    m_volumetricPass->SetTemporalEnabled(m_enableTemporal);
 }
 
 void RenderPipeline::Shutdown()
@@ -95,6 +136,8 @@ void RenderPipeline::Shutdown()
         m_scenePass->Shutdown();
     if (m_volumetricPass)
         m_volumetricPass->Shutdown();
+    if (m_temporalPass)
+        m_temporalPass->Shutdown();
     if (m_blurPass)
         m_blurPass->Shutdown();
     if (m_compositePass)
@@ -104,6 +147,7 @@ void RenderPipeline::Shutdown()
 
     m_sceneRT.Shutdown();
     m_volRT.Shutdown();
+    m_volCurrentRT.Shutdown();
     m_blurTempRT.Shutdown();
     m_fullScreenVB.Reset();
     m_linearSampler.Reset();
@@ -151,7 +195,7 @@ void RenderPipeline::Render(ID3D11DeviceContext *context, const RenderContext &c
     // 2. Scene Pass (renders to m_sceneRT)
     RenderScenePass(context, ctx);
 
-    // 3. Volumetric Pass (renders to m_volRT)
+    // 3. Volumetric Pass (renders to m_volRT, accumulated over frames when temporal is enabled)
     RenderVolumetricPass(context, ctx);
 
     // 4. Blur Pass (blurs m_volRT using m_blurTempRT as temp)
@@ -169,14 +213,48 @@ void RenderPipeline::Render(ID3D11DeviceContext *context, const RenderContext &c
 
 void RenderPipeline::RenderShadowPass(ID3D11DeviceContext *context, const RenderContext &ctx)
 {
+    m_shadowCullStats = {};
     if (ctx.spotlights && !ctx.spotlights->empty())
     {
         // Render shadow map for each spotlight (up to MAX_SPOTLIGHTS)
         int numLights = (std::min)(static_cast<int>(ctx.spotlights->size()), Config::Spotlight::MAX_SPOTLIGHTS);
+        const bool cullStage =
+            m_enableClusterCulling && ctx.stageMesh && !ctx.stageMesh->GetClusters().empty();
+        const DirectX::XMMATRIX stageWorld = DirectX::XMMatrixTranslation(0.0f, ctx.stageOffset, 0.0f);
 
         for (int i = 0; i < numLights; ++i)
         {
-            m_shadowPass->Execute(context, ctx.spotlights->at(i).GetGPUData(), i, ctx.stageMesh, ctx.stageOffset);
+            const SpotlightData &spotData = ctx.spotlights->at(i).GetGPUData();
+            const DirectX::XMMATRIX lightViewProj = DirectX::XMMatrixTranspose(spotData.lightViewProj);
+            if (cullStage)
+            {
+                // Only clusters inside the light frustum and facing the light reach the shadow map
+                const DirectX::XMFLOAT3 lightPos = {spotData.posRange.x, spotData.posRange.y, spotData.posRange.z};
+                const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(stageWorld, lightViewProj, lightPos);
+                const ClusterCuller::Stats stats =
+                    ClusterCuller::Cull(ctx.stageMesh->GetClusters(), frustum, m_visibleRanges);
+                m_shadowCullStats.clusters += stats.clusters;
+                m_shadowCullStats.visibleClusters += stats.visibleClusters;
+                m_shadowCullStats.frustumCulled += stats.frustumCulled;
+                m_shadowCullStats.backfaceCulled += stats.backfaceCulled;
+                m_shadowCullStats.triangles += stats.triangles;
+                m_shadowCullStats.submittedTriangles += stats.submittedTriangles;
+                m_shadowPass->Execute(context, spotData, i, ctx.stageMesh, ctx.stageOffset, m_visibleRanges.data(),
+                                      m_visibleRanges.size());
+            }
+            else
+            {
+                m_shadowPass->Execute(context, spotData, i, ctx.stageMesh, ctx.stageOffset);
+            }
+
+            if (Config::Shadow::FIXTURE_CASTERS)
+            {
+                ShadowCasters::Select(ctx.fixtureLights, ctx.fixtureNodes.size(), i, m_shadowCasters);
+                for (const size_t f : m_shadowCasters)
+                    RenderShadowCasterRecursive(context, ctx.fixtureNodes[f], spotData, lightViewProj);
+            }
+
+            m_shadowPass->BuildMinMax(context, i, m_fullScreenVB.Get());
         }
     }
 }
@@ -217,10 +295,18 @@ void RenderPipeline::RenderScenePass(ID3D11DeviceContext *context, const RenderC
     context->VSSetConstantBuffers(0, 1, m_matrixBuffer.GetAddressOf());
     context->PSSetConstantBuffers(3, 1, m_ceilingLightsBuffer.GetAddressOf());
 
-    // Bind textures
-    ID3D11ShaderResourceView *goboSrv = ctx.goboTexture ? ctx.goboTexture->GetSRV() : nullptr;
-    ID3D11ShaderResourceView *srvs[] = {goboSrv, m_shadowPass->GetShadowSRV()};
-    context->PSSetShaderResources(0, 2, srvs);
+    // Bind textures: each light's gobo array, then the shadow maps
+    ID3D11ShaderResourceView *srvs[Config::Spotlight::MAX_SPOTLIGHTS + 1] = {};
+    unsigned int monochromeGobos = 0;
+    for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+    {
+        const Texture *gobo = ctx.goboTextures[i];
+        srvs[i] = gobo ? gobo->GetSRV() : nullptr;
+        if (gobo && gobo->IsMonochrome())
+            monochromeGobos |= 1u << i;
+    }
+    srvs[Config::Spotlight::MAX_SPOTLIGHTS] = m_shadowPass->GetShadowSRV();
+    context->PSSetShaderResources(0, Config::Spotlight::MAX_SPOTLIGHTS + 1, srvs);
 
     ID3D11SamplerState *samplers[] = {m_linearSampler.Get(), m_shadowPass->GetShadowSampler()};
     context->PSSetSamplers(0, 2, samplers);
@@ -232,19 +318,55 @@ void RenderPipeline::RenderScenePass(ID3D11DeviceContext *context, const RenderC
     // Execute scene pass (room with identity world)
     m_scenePass->Execute(context, lights, ctx.depthStencilView, ctx.roomVB, ctx.roomIB,
                          nullptr, // Skip stage in scene pass for now
-                         ctx.stageOffset, ctx.roomSpecular, ctx.roomShininess);
+                         ctx.stageOffset, ctx.roomSpecular, ctx.roomShininess, monochromeGobos);
 
     // Render stage with offset world matrix and per-shape materials from MTL
+    const DirectX::XMMATRIX viewProj = view * proj;
+    m_sceneCullStats = {};
+    m_fixtureMeshesTested = 0;
+    m_fixtureMeshesOccluded = 0;
+
+    // The stage is the only large occluder; fill the occlusion buffer before anything is culled
+    const OcclusionBuffer *occlusion = nullptr;
+    m_occlusionBuffer.Begin(viewProj);
+    if (m_enableOcclusionCulling && ctx.stageMesh && !ctx.stageMesh->GetOccluderTriangles().empty())
+    {
+        const auto &occluders = ctx.stageMesh->GetOccluderTriangles();
+        m_occlusionBuffer.AddOccluders(occluders.data(), occluders.size() / 3,
+                                       DirectX::XMMatrixTranslation(0.0f, ctx.stageOffset, 0.0f));
+        m_occlusionBuffer.Finish();
+        occlusion = &m_occlusionBuffer;
+    }
+
     if (ctx.stageMesh)
     {
-        mb.world = DirectX::XMMatrixTranspose(DirectX::XMMatrixTranslation(0.0f, ctx.stageOffset, 0.0f));
+        const DirectX::XMMATRIX stageWorld = DirectX::XMMatrixTranslation(0.0f, ctx.stageOffset, 0.0f);
+        mb.world = DirectX::XMMatrixTranspose(stageWorld);
         m_matrixBuffer.Update(context, mb);
         m_scenePass->GetShader().Bind(context);
 
+        // Ranges come out sorted by shape, so each shape's visible ranges follow each other
+        const bool cullStage = m_enableClusterCulling && !ctx.stageMesh->GetClusters().empty();
+        if (cullStage)
+        {
+            const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(stageWorld, viewProj, ctx.cameraPos);
+            m_sceneCullStats =
+                ClusterCuller::Cull(ctx.stageMesh->GetClusters(), frustum, m_visibleRanges, true, occlusion);
+        }
+        size_t nextRange = 0;
+
         const auto &shapes = ctx.stageMesh->GetShapes();
         for (size_t i = 0; i < shapes.size(); ++i)
         {
             const auto &shape = shapes[i];
+            size_t firstRange = nextRange;
+            if (cullStage)
+            {
+                while (nextRange < m_visibleRanges.size() && m_visibleRanges[nextRange].shape == i)
+                    ++nextRange;
+                if (nextRange == firstRange)
+                    continue;
+            }
 
             MaterialBuffer mbMat = {};
             mbMat.color =
@@ -255,33 +377,55 @@ void RenderPipeline::RenderScenePass(ID3D11DeviceContext *context, const RenderC
             m_scenePass->GetMaterialBuffer().Update(context, mbMat);
             context->PSSetConstantBuffers(2, 1, m_scenePass->GetMaterialBuffer().GetAddressOf());
 
-            ctx.stageMesh->DrawShape(context, i);
+            if (cullStage)
+                ctx.stageMesh->DrawClusterRanges(context, &m_visibleRanges[firstRange], nextRange - firstRange);
+            else
+                ctx.stageMesh->DrawShape(context, i);
         }
     }
 
     // Render GDTF Fixtures
     for (const auto &node : ctx.fixtureNodes)
     {
-        RenderNodeRecursive(context, node, mb);
+        RenderNodeRecursive(context, node, mb, viewProj, occlusion);
     }
 }
 
 void RenderPipeline::RenderNodeRecursive(ID3D11DeviceContext *context, const std::shared_ptr<SceneGraph::Node> &node,
-                                         PipelineMatrixBuffer &mb)
+                                         PipelineMatrixBuffer &mb, DirectX::FXMMATRIX viewProj,
+                                         const OcclusionBuffer *occlusion)
 {
     if (!node)
         return;
 
     // Check if it's a mesh node
     auto meshNode = std::dynamic_pointer_cast<SceneGraph::MeshNode>(node);
-    if (meshNode && meshNode->GetMesh())
+    bool occluded = false;
+    if (meshNode && meshNode->GetMesh() && occlusion)
+    {
+        // Hidden meshes are skipped, but their children have their own bounds
+        DirectX::XMFLOAT3 boxMin;
+        DirectX::XMFLOAT3 boxMax;
+        meshNode->GetMesh()->GetBoundingBox(boxMin, boxMax);
+        occluded = !occlusion->IsBoxVisible(boxMin, boxMax, node->GetWorldMatrix() * viewProj);
+        ++m_fixtureMeshesTested;
+        m_fixtureMeshesOccluded += occluded ? 1 : 0;
+    }
+    if (meshNode && meshNode->GetMesh() && !occluded)
     {
         // Update world matrix
-        mb.world = DirectX::XMMatrixTranspose(node->GetWorldMatrix());
+        const DirectX::XMMATRIX world = node->GetWorldMatrix();
+        mb.world = DirectX::XMMatrixTranspose(world);
         m_matrixBuffer.Update(context, mb);
 
         auto mesh = meshNode->GetMesh();
         const auto &shapes = mesh->GetShapes();
+        m_scenePass->BindMeshShader(context, *mesh);
+
+        const DirectX::XMFLOAT4 sphere = LodSelector::TransformSphere(mesh->GetBoundingSphere(), world);
+        const size_t lod =
+            LodSelector::SelectLod(LodSelector::ProjectedSize(sphere, viewProj), Config::Lod::SCENE_SCREEN_SIZES,
+                                   Config::Lod::MAX_LEVELS - 1, mesh->GetLodCount());
 
         for (size_t i = 0; i < shapes.size(); ++i)
         {
@@ -295,14 +439,39 @@ void RenderPipeline::RenderNodeRecursive(ID3D11DeviceContext *context, const std
             m_scenePass->GetMaterialBuffer().Update(context, mbMat);
             context->PSSetConstantBuffers(2, 1, m_scenePass->GetMaterialBuffer().GetAddressOf());
 
-            mesh->DrawShape(context, i);
+            mesh->DrawShape(context, i, lod);
         }
     }
 
     // Recurse to children
     for (const auto &child : node->GetChildren())
     {
-        RenderNodeRecursive(context, child, mb);
+        RenderNodeRecursive(context, child, mb, viewProj, occlusion);
+    }
+}
+
+void RenderPipeline::RenderShadowCasterRecursive(ID3D11DeviceContext *context,
+                                                 const std::shared_ptr<SceneGraph::Node> &node,
+                                                 const SpotlightData &spotData, DirectX::FXMMATRIX lightViewProj)
+{
+    if (!node)
+        return;
+
+    auto meshNode = std::dynamic_pointer_cast<SceneGraph::MeshNode>(node);
+    if (meshNode && meshNode->GetMesh())
+    {
+        auto mesh = meshNode->GetMesh();
+        const DirectX::XMMATRIX world = node->GetWorldMatrix();
+        const DirectX::XMFLOAT4 sphere = LodSelector::TransformSphere(mesh->GetBoundingSphere(), world);
+        const size_t lod =
+            LodSelector::SelectLod(LodSelector::ProjectedSize(sphere, lightViewProj), Config::Lod::SHADOW_SCREEN_SIZES,
+                                   Config::Lod::MAX_LEVELS - 1, mesh->GetLodCount());
+        m_shadowPass->DrawCaster(context, spotData, mesh.get(), world, lod);
+    }
+
+    for (const auto &child : node->GetChildren())
+    {
+        RenderShadowCasterRecursive(context, child, spotData, lightViewProj);
     }
 }
 
@@ -318,16 +487,41 @@ void RenderPipeline::RenderVolumetricPass(ID3D11DeviceContext *context, const Re
     // Note: Spotlight buffer (b1) is now handled internally by VolumetricPass::Execute
     // using the provided spotlights vector.
 
-    ID3D11ShaderResourceView *goboSrv = ctx.goboTexture ? ctx.goboTexture->GetSRV() : nullptr;
+    ID3D11ShaderResourceView *goboSrvs[Config::Spotlight::MAX_SPOTLIGHTS] = {};
+    ID3D11ShaderResourceView *goboSatSrvs[Config::Spotlight::MAX_SPOTLIGHTS] = {};
+    for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+    {
+        if (const Texture *gobo = ctx.goboTextures[i])
+        {
+            goboSrvs[i] = gobo->GetSRV();
+            goboSatSrvs[i] = gobo->GetSummedAreaSRV();
+        }
+    }
 
     const std::vector<Spotlight> emptyLights;
     const std::vector<Spotlight> &lights = ctx.spotlights ? *ctx.spotlights : emptyLights;
 
-    m_volumetricPass->Execute(context, lights, &m_volRT, m_fullScreenVB.Get(), ctx.depthSRV, goboSrv,
-                              m_shadowPass->GetShadowSRV(), m_linearSampler.Get(), m_shadowPass->GetShadowSampler(),
+    // With temporal accumulation the march goes to a separate target and is resolved into m_volRT
+    const DirectX::XMMATRIX viewProj = ctx.camera->GetViewMatrix() * ctx.camera->GetProjectionMatrix();
+    DirectX::XMFLOAT4X4 viewProjF;
+    DirectX::XMStoreFloat4x4(&viewProjF, viewProj);
+    RenderTarget *marchRt = m_enableTemporal ? &m_volCurrentRT : &m_volRT;
+    m_volumetricPass->UpdateHazeDensity(context, ctx.haze);
+    m_volumetricPass->Execute(context, lights, marchRt, m_fullScreenVB.Get(), ctx.depthSRV, goboSrvs,
+                              goboSatSrvs, m_shadowPass->GetShadowSRV(), m_shadowPass->GetMinMaxSRV(),
+                              m_linearSampler.Get(), m_shadowPass->GetShadowSampler(), viewProjF, ctx.cameraPos,
                               ctx.time);
 
     ClearShaderResources(context);
+
+    if (m_enableTemporal)
+    {
+        m_temporalPass->Execute(context, &m_volCurrentRT, &m_volRT, m_fullScreenVB.Get(), ctx.depthSRV,
+                                m_linearSampler.Get(), viewProj, ctx.cameraPos,
+                                m_volumetricPass->HasLightStateChanged());
+
+        ClearShaderResources(context);
+    }
 }
 
 void RenderPipeline::RenderBlurPass(ID3D11DeviceContext *context)
@@ -2,11 +2,16 @@
 
 #include <d3d11.h>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 #include <wrl/client.h>
 #include "../Core/ConstantBuffer.h"
+#include "../Core/TaskGraph.h"
 #include "../Scene/Camera.h"
 #include "../Scene/CeilingLights.h"
+#include "../Scene/ClusterCuller.h"
+#include "../Scene/OcclusionBuffer.h"
 #include "../Scene/Node.h"
 #include "../Scene/Spotlight.h"
 #include "Passes/BlurPass.h"
@@ -14,11 +19,14 @@
 #include "Passes/FXAAPass.h"
 #include "Passes/ScenePass.h"
 #include "Passes/ShadowPass.h"
+#include "Passes/TemporalPass.h"
 #include "Passes/VolumetricPass.h"
 #include "RenderTarget.h"
 
 using Microsoft::WRL::ComPtr;
 
+class GraphicsDevice;
+class HazeSimulation;
 class Mesh;
 class Texture;
 
@@ -47,11 +55,13 @@ struct RenderContext
     // Scene data
     std::vector<DirectX::XMFLOAT3> anchorPositions;              ///< Positions of fixture anchors.
     std::vector<std::shared_ptr<SceneGraph::Node>> fixtureNodes; ///< Fixture hierarchies.
+    std::vector<int> fixtureLights;                              ///< Spotlight each fixture drives, -1 for none.
     Spotlight *spotlight;                                        ///< Pointer to the main spotlight.
     std::vector<Spotlight> *spotlights;                          ///< Pointer to the list of all spotlights.
     CeilingLights *ceilingLights;                                ///< Pointer to the ceiling lights collection.
     Mesh *stageMesh;                                             ///< Pointer to the stage geometry mesh.
-    Texture *goboTexture;                                        ///< Pointer to the gobo texture for the spotlight.
+    Texture *goboTextures[Config::Spotlight::MAX_SPOTLIGHTS];    ///< Gobo array of each light (its library size class).
+    const HazeSimulation *haze;                                  ///< Simulated haze, or nullptr for uniform haze.
     float stageOffset;                                           ///< Vertical offset for the stage.
     float time;                                                  ///< Total elapsed time for animations.
 
@@ -99,6 +109,19 @@ public:
      */
     bool Initialize(ID3D11Device *device);
 
+    /**
+     * @brief Adds what Initialize() does to a task graph: one task per pass (its shader
+     * compiles and state objects) and one for the shared resources, side by side.
+     *
+     * The device is only read when the tasks run, after deviceTask.
+     *
+     * @param graph Graph the tasks are added to.
+     * @param graphics Graphics device, initialized by deviceTask.
+     * @param deviceTask Task that creates the device.
+     * @return A task that completes once the pipeline is ready.
+     */
+    TaskGraph::TaskId AddTasks(TaskGraph &graph, const GraphicsDevice &graphics, TaskGraph::TaskId deviceTask);
+
     /**
      * @brief Shuts down the pipeline and releases all internal resources.
      */
@@ -150,6 +173,171 @@ public:
         return m_enableVolBlur;
     }
 
+    /**
+     * @brief Enables or disables analytic integration of unshadowed beam cores.
+     * @param enabled Set to true to integrate beam cores analytically, false to ray march everything.
+     */
+    void SetAnalyticScatteringEnabled(bool enabled)
+    {
+        m_volumetricPass->SetAnalyticScatteringEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if analytic integration of beam cores is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsAnalyticScatteringEnabled() const
+    {
+        return m_volumetricPass->IsAnalyticScatteringEnabled();
+    }
+
+    /**
+     * @brief Enables or disables temporal accumulation of the volumetric buffer.
+     * @param enabled Set to true to accumulate over frames with fewer march steps per frame.
+     */
+    void SetTemporalAccumulationEnabled(bool enabled)
+    {
+        m_enableTemporal = enabled;
+        m_volumetricPass->SetTemporalEnabled(enabled);
+        if (!enabled)
+            m_temporalPass->Reset();
+    }
+
+    /**
+     * @brief Checks if temporal accumulation of the volumetric buffer is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsTemporalAccumulationEnabled() const
+    {
+        return m_enableTemporal;
+    }
+
+    /**
+     * @brief Enables or disables per-light step counts fitted to the volumetric GPU time budget.
+     * @param enabled Set to true to budget march steps per light, false to use the global step count.
+     */
+    void SetStepBudgetEnabled(bool enabled)
+    {
+        m_volumetricPass->SetStepBudgetEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if per-light step budgeting is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsStepBudgetEnabled() const
+    {
+        return m_volumetricPass->IsStepBudgetEnabled();
+    }
+
+    /**
+     * @brief Enables or disables the volumetric tile mask built from the beams' screen bounds.
+     * @param enabled Set to true to only shade the tiles and lights the beams reach.
+     */
+    void SetTileMaskEnabled(bool enabled)
+    {
+        m_volumetricPass->SetTileMaskEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if the volumetric tile mask is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsTileMaskEnabled() const
+    {
+        return m_volumetricPass->IsTileMaskEnabled();
+    }
+
+    /**
+     * @brief Enables or disables the lit/shadowed classification of march intervals.
+     * @param enabled Set to true to skip shadow lookups where the min/max shadow mips decide.
+     */
+    void SetShadowIntervalsEnabled(bool enabled)
+    {
+        m_volumetricPass->SetShadowIntervalsEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if the lit/shadowed classification of march intervals is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsShadowIntervalsEnabled() const
+    {
+        return m_volumetricPass->IsShadowIntervalsEnabled();
+    }
+
+    /**
+     * @brief Enables or disables epipolar sample placement for the volumetric pass.
+     * @param enabled Set to true to march samples along the lights' epipolar lines and interpolate pixels.
+     */
+    void SetEpipolarEnabled(bool enabled)
+    {
+        m_volumetricPass->SetEpipolarEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if epipolar sample placement is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsEpipolarEnabled() const
+    {
+        return m_volumetricPass->IsEpipolarEnabled();
+    }
+
+    /**
+     * @brief Enables or disables stochastic light selection for the volumetric pass.
+     * @param enabled Set to true to march a few lights per pixel, picked from per-tile alias tables.
+     */
+    void SetLightSamplingEnabled(bool enabled)
+    {
+        m_volumetricPass->SetLightSamplingEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if stochastic light selection is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsLightSamplingEnabled() const
+    {
+        return m_volumetricPass->IsLightSamplingEnabled();
+    }
+
+    /**
+     * @brief Enables or disables gobo footprint filtering for the volumetric pass.
+     * @param enabled Set to true to average the gobo over coarse march steps from its summed-area tables.
+     */
+    void SetGoboFootprintEnabled(bool enabled)
+    {
+        m_volumetricPass->SetGoboFootprintEnabled(enabled);
+    }
+
+    /**
+     * @brief Checks if gobo footprint filtering is enabled.
+     * @return true if enabled, false otherwise.
+     */
+    [[nodiscard]] bool IsGoboFootprintEnabled() const
+    {
+        return m_volumetricPass->IsGoboFootprintEnabled();
+    }
+
+    /**
+     * @brief Gets the tile mask of the last volumetric pass.
+     * @return Lights per tile, active tile count and scissor rectangle.
+     */
+    [[nodiscard]] const ConeBounds::TileMask &GetVolumetricTileMask() const
+    {
+        return m_volumetricPass->GetTileMask();
+    }
+
+    /**
+     * @brief Gets the step budget of the last volumetric pass.
+     * @return Per-light step counts, samples and predicted and measured GPU time.
+     */
+    [[nodiscard]] const VolumetricBudget::Stats &GetVolumetricBudgetStats() const
+    {
+        return m_volumetricPass->GetBudgetStats();
+    }
+
     /**
      * @brief Sets the number of blur passes to perform on the volumetric buffer.
      * @param passes The number of blur iterations.
@@ -168,6 +356,85 @@ public:
         return m_blurPasses;
     }
 
+    /**
+     * @brief Enables or disables CPU cluster culling of the stage mesh.
+     * @param enabled True to draw only the clusters each camera or light can see.
+     */
+    void SetClusterCullingEnabled(bool enabled)
+    {
+        m_enableClusterCulling = enabled;
+    }
+
+    /**
+     * @brief Checks if CPU cluster culling of the stage mesh is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsClusterCullingEnabled() const
+    {
+        return m_enableClusterCulling;
+    }
+
+    /**
+     * @brief Enables or disables software occlusion culling in the camera pass.
+     * @param enabled True to skip stage clusters and fixture meshes hidden behind the stage.
+     */
+    void SetOcclusionCullingEnabled(bool enabled)
+    {
+        m_enableOcclusionCulling = enabled;
+    }
+
+    /**
+     * @brief Checks if software occlusion culling is enabled.
+     * @return True if enabled.
+     */
+    [[nodiscard]] bool IsOcclusionCullingEnabled() const
+    {
+        return m_enableOcclusionCulling;
+    }
+
+    /**
+     * @brief Gets the occlusion buffer of the last camera pass.
+     * @return The buffer; empty when occlusion culling was off.
+     */
+    [[nodiscard]] const OcclusionBuffer &GetOcclusionBuffer() const
+    {
+        return m_occlusionBuffer;
+    }
+
+    /**
+     * @brief Gets the number of fixture meshes tested against the occlusion buffer in the last camera pass.
+     */
+    [[nodiscard]] size_t GetFixtureMeshesTested() const
+    {
+        return m_fixtureMeshesTested;
+    }
+
+    /**
+     * @brief Gets the number of fixture meshes skipped as occluded in the last camera pass.
+     */
+    [[nodiscard]] size_t GetFixtureMeshesOccluded() const
+    {
+        return m_fixtureMeshesOccluded;
+    }
+
+    /**
+     * @brief Gets the stage culling counts of the last camera pass.
+     * @return Clusters and triangles submitted versus total.
+     */
+    [[nodiscard]] const ClusterCuller::Stats &GetSceneCullStats() const
+    {
+        return m_sceneCullStats;
+    }
+
+    /**
+     * @brief Gets the stage culling counts of the last shadow pass, summed over all lights.
+     * @return Clusters and triangles submitted versus total.
+     */
+    [[nodiscard]] const ClusterCuller::Stats &GetShadowCullStats() const
+    {
+        return m_shadowCullStats;
+    }
+
     /**
      * @brief Provides access to the volumetric pass parameters for modification (e.g., via UI).
      * @return A reference to the VolumetricBuffer struct containing parameters.
@@ -187,6 +454,26 @@ public:
     }
 
 private:
+    /**
+     * @brief Creates the passes, not initialized yet.
+     *
+     * @return The passes with their names, in execution order.
+     */
+    std::vector<std::pair<const char *, IRenderPass *>> CreatePasses();
+
+    /**
+     * @brief Creates the render targets, geometry, sampler and constant buffers the passes share.
+     *
+     * @param device Pointer to the ID3D11Device used for resource creation.
+     * @return true if every resource was created.
+     */
+    bool CreateSharedResources(ID3D11Device *device);
+
+    /**
+     * @brief Connects the initialized passes to the shared resources and sets their defaults.
+     */
+    void ConfigurePasses();
+
     /**
      * @brief Executes the shadow mapping pass.
      *
@@ -209,9 +496,23 @@ private:
      * @param context Pointer to the ID3D11DeviceContext.
      * @param node The node to render.
      * @param mb Matrix buffer to update for each node.
+     * @param viewProj Camera view-projection used to pick each mesh's level of detail.
+     * @param occlusion Finished occlusion buffer for the camera, or nullptr to draw every mesh.
      */
     void RenderNodeRecursive(ID3D11DeviceContext *context, const std::shared_ptr<SceneGraph::Node> &node,
-                             PipelineMatrixBuffer &mb);
+                             PipelineMatrixBuffer &mb, DirectX::FXMMATRIX viewProj,
+                             const OcclusionBuffer *occlusion = nullptr);
+
+    /**
+     * @brief Helper to recursively draw scene graph meshes into the current shadow map slice.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param node The node to render.
+     * @param spotData The spotlight whose shadow map is being rendered.
+     * @param lightViewProj The light's view-projection (not transposed), used to pick LODs.
+     */
+    void RenderShadowCasterRecursive(ID3D11DeviceContext *context, const std::shared_ptr<SceneGraph::Node> &node,
+                                     const SpotlightData &spotData, DirectX::FXMMATRIX lightViewProj);
 
     /**
      * @brief Executes the volumetric lighting pass.
@@ -263,6 +564,7 @@ private:
     std::unique_ptr<ShadowPass> m_shadowPass;
     std::unique_ptr<ScenePass> m_scenePass;
     std::unique_ptr<VolumetricPass> m_volumetricPass;
+    std::unique_ptr<TemporalPass> m_temporalPass;
     std::unique_ptr<BlurPass> m_blurPass;
     std::unique_ptr<CompositePass> m_compositePass;
     std::unique_ptr<FXAAPass> m_fxaaPass;
@@ -270,6 +572,7 @@ private:
     // Shared render targets
     RenderTarget m_sceneRT;
     RenderTarget m_volRT;
+    RenderTarget m_volCurrentRT; ///< This frame's march before temporal accumulation.
     RenderTarget m_blurTempRT;
 
     // Shared geometry
@@ -289,7 +592,23 @@ private:
     // Configuration state
     bool m_enableFXAA = true;
     bool m_enableVolBlur = true;
+    bool m_enableTemporal = true;
     int m_blurPasses = Config::PostProcess::DEFAULT_BLUR_PASSES;
+    bool m_enableClusterCulling = true;
+    bool m_enableOcclusionCulling = true;
+
+    // Stage cluster culling results (reused every frame)
+    std::vector<ClusterRange> m_visibleRanges;
+    ClusterCuller::Stats m_sceneCullStats;
+    ClusterCuller::Stats m_shadowCullStats;
+
+    // Fixtures casting into the shadow map being rendered (Config::Shadow::FIXTURE_CASTERS)
+    std::vector<size_t> m_shadowCasters;
+
+    // Camera occlusion buffer, filled from the stage's occluder triangles
+    OcclusionBuffer m_occlusionBuffer;
+    size_t m_fixtureMeshesTested = 0;
+    size_t m_fixtureMeshesOccluded = 0;
 
     // Cached device pointer (for sampler creation if needed)
     ID3D11Device *m_device = nullptr;
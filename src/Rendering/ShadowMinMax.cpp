@@ -0,0 +1,149 @@
+#include "ShadowMinMax.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ShadowMinMax
+{
+
+namespace
+{
+
+constexpr float MIN_CLIP_W = 1e-3f;   ///< Segments reaching closer to the light's plane are not classified.
+constexpr float TEXEL_MARGIN = 0.25f; ///< Widening of the footprint, in texels, for the rounding of sample positions.
+constexpr float UV_MARGIN = 1e-4f;    ///< Same for the test against the map's edges.
+constexpr float DEPTH_MARGIN = 1e-5f; ///< Same for the depths compared.
+
+} // namespace
+
+bool Build(const float *depth, int size, int levelCount, MipChain &outChain)
+{
+    outChain = {};
+    if (!depth || size < 2 || (size & (size - 1)) != 0)
+        return false;
+
+    outChain.baseSize = size;
+    int levelSize = size / 2;
+    for (int level = 0; level < levelCount && levelSize >= 1; ++level, levelSize /= 2)
+    {
+        std::vector<DirectX::XMFLOAT2> texels(static_cast<size_t>(levelSize) * levelSize);
+        const int sourceSize = levelSize * 2;
+        for (int y = 0; y < levelSize; ++y)
+        {
+            for (int x = 0; x < levelSize; ++x)
+            {
+                float lo = (std::numeric_limits<float>::max)();
+                float hi = -(std::numeric_limits<float>::max)();
+                for (int j = 0; j < 2; ++j)
+                {
+                    for (int i = 0; i < 2; ++i)
+                    {
+                        const size_t source = (static_cast<size_t>((y * 2) + j) * sourceSize) + (x * 2) + i;
+                        if (level == 0)
+                        {
+                            lo = (std::min)(lo, depth[source]);
+                            hi = (std::max)(hi, depth[source]);
+                        }
+                        else
+                        {
+                            lo = (std::min)(lo, outChain.levels.back()[source].x);
+                            hi = (std::max)(hi, outChain.levels.back()[source].y);
+                        }
+                    }
+                }
+                texels[(static_cast<size_t>(y) * levelSize) + x] = {lo, hi};
+            }
+        }
+        outChain.sizes.push_back(levelSize);
+        outChain.levels.push_back(std::move(texels));
+    }
+    return true;
+}
+
+Visibility Classify(const MipChain &chain, const DirectX::XMFLOAT4X4 &lightViewProj, const DirectX::XMFLOAT3 &a,
+                    const DirectX::XMFLOAT3 &b, float bias)
+{
+    if (chain.levels.empty())
+        return Visibility::Mixed;
+
+    // Ends of the segment in shadow map coordinates
+    const DirectX::XMFLOAT4X4 &m = lightViewProj;
+    float u[2];
+    float v[2];
+    float z[2];
+    const DirectX::XMFLOAT3 ends[2] = {a, b};
+    for (int e = 0; e < 2; ++e)
+    {
+        const DirectX::XMFLOAT3 &p = ends[e];
+        const float clipX = (p.x * m._11) + (p.y * m._12) + (p.z * m._13) + m._14;
+        const float clipY = (p.x * m._21) + (p.y * m._22) + (p.z * m._23) + m._24;
+        const float clipZ = (p.x * m._31) + (p.y * m._32) + (p.z * m._33) + m._34;
+        const float clipW = (p.x * m._41) + (p.y * m._42) + (p.z * m._43) + m._44;
+        if (clipW <= MIN_CLIP_W)
+            return Visibility::Mixed;
+        u[e] = (clipX / clipW * 0.5f) + 0.5f;
+        v[e] = 0.5f - (clipY / clipW * 0.5f);
+        z[e] = clipZ / clipW;
+    }
+    float uMin = (std::min)(u[0], u[1]);
+    float uMax = (std::max)(u[0], u[1]);
+    float vMin = (std::min)(v[0], v[1]);
+    float vMax = (std::max)(v[0], v[1]);
+
+    // The shader does not sample outside the map: those points are lit
+    if (uMax < 0.0f || uMin > 1.0f || vMax < 0.0f || vMin > 1.0f)
+        return Visibility::Lit;
+    const bool partlyOutside =
+        uMin < UV_MARGIN || uMax > 1.0f - UV_MARGIN || vMin < UV_MARGIN || vMax > 1.0f - UV_MARGIN;
+
+    // Texels under the bilinear footprint of the box; the border reads as depth 1
+    // (clamped first: past one map size out, the box only reaches more border)
+    uMin = (std::max)(uMin, -1.0f);
+    vMin = (std::max)(vMin, -1.0f);
+    uMax = (std::min)(uMax, 2.0f);
+    vMax = (std::min)(vMax, 2.0f);
+    const int size = chain.baseSize;
+    int x0 = static_cast<int>(std::floor((uMin * size) - 0.5f - TEXEL_MARGIN));
+    int y0 = static_cast<int>(std::floor((vMin * size) - 0.5f - TEXEL_MARGIN));
+    int x1 = static_cast<int>(std::floor((uMax * size) - 0.5f + TEXEL_MARGIN)) + 1;
+    int y1 = static_cast<int>(std::floor((vMax * size) - 0.5f + TEXEL_MARGIN)) + 1;
+    const bool border = x0 < 0 || y0 < 0 || x1 >= size || y1 >= size;
+    x0 = (std::max)(x0, 0);
+    y0 = (std::max)(y0, 0);
+    x1 = (std::min)(x1, size - 1);
+    y1 = (std::min)(y1, size - 1);
+
+    // Finest level where the footprint spans at most two texels per axis
+    int level = 0;
+    const int levelCount = static_cast<int>(chain.levels.size());
+    while (level < levelCount &&
+           ((x1 >> (level + 1)) - (x0 >> (level + 1)) > 1 || (y1 >> (level + 1)) - (y0 >> (level + 1)) > 1))
+        ++level;
+    if (level == levelCount)
+        return Visibility::Mixed;
+
+    float lo = border ? 1.0f : (std::numeric_limits<float>::max)();
+    float hi = border ? 1.0f : -(std::numeric_limits<float>::max)();
+    const int levelSize = chain.sizes[level];
+    const std::vector<DirectX::XMFLOAT2> &texels = chain.levels[level];
+    for (int ty = y0 >> (level + 1); ty <= y1 >> (level + 1); ++ty)
+    {
+        for (int tx = x0 >> (level + 1); tx <= x1 >> (level + 1); ++tx)
+        {
+            const DirectX::XMFLOAT2 &texel = texels[(static_cast<size_t>(ty) * levelSize) + tx];
+            lo = (std::min)(lo, texel.x);
+            hi = (std::max)(hi, texel.y);
+        }
+    }
+
+    // Comparisons pass when the biased depth is at most the stored one (LESS_EQUAL)
+    const float refMin = (std::min)(z[0], z[1]) - bias - DEPTH_MARGIN;
+    const float refMax = (std::max)(z[0], z[1]) - bias + DEPTH_MARGIN;
+    if (refMax <= lo)
+        return Visibility::Lit;
+    if (!partlyOutside && refMin > hi)
+        return Visibility::Shadowed;
+    return Visibility::Mixed;
+}
+
+} // namespace ShadowMinMax
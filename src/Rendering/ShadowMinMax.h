@@ -0,0 +1,80 @@
+/**
+ * @file ShadowMinMax.h
+ * @brief Min/max depth mips of a shadow map and the lit/shadowed classification of march intervals.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include "../Core/Config.h"
+
+/**
+ * @namespace ShadowMinMax
+ * @brief Tells, for a segment of a camera ray, if the shadow map lights all of it, none of it, or some.
+ *
+ * Each texel of level m stores the smallest and largest depth of a 2^(m+1) texel wide block of
+ * the shadow map. A segment projects to a segment in the light's clip space, along which the
+ * depth after the perspective divide is monotonic, so its depths lie between those of its ends
+ * and the shadow texels it can touch lie in the bounding box of its ends, widened by the
+ * bilinear footprint of the comparison filter. Reading the level where that box spans at most
+ * two texels per axis gives bounds on every depth the shader compares against:
+ *
+ * - Lit: every comparison passes, the shadow factor is 1 without sampling.
+ * - Shadowed: every comparison fails, the samples contribute nothing.
+ * - Mixed: the shadow map must be sampled.
+ *
+ * This is the CPU implementation of the volumetric shader's ClassifyInterval(), used to validate
+ * it against brute-force sampling; ShadowPass builds the same mips on the GPU.
+ */
+namespace ShadowMinMax
+{
+
+/**
+ * @enum Visibility
+ * @brief Classification of a segment.
+ */
+enum class Visibility : uint8_t
+{
+    Lit,
+    Shadowed,
+    Mixed
+};
+
+/**
+ * @struct MipChain
+ * @brief Min/max depth mips of one shadow map slice.
+ */
+struct MipChain
+{
+    int baseSize = 0;                                   ///< Shadow map texels per side.
+    std::vector<int> sizes;                             ///< Texels per side of each level.
+    std::vector<std::vector<DirectX::XMFLOAT2>> levels; ///< Row-major (min, max) depths per level.
+};
+
+/**
+ * @brief Builds the mips of a square shadow map.
+ *
+ * @param depth size * size depths, row-major.
+ * @param size Texels per side (a power of two).
+ * @param levelCount Levels to build, the first at size / 2; fewer if the map gets to one texel.
+ * @param outChain Receives the mips.
+ * @return False if the size is not a power of two of at least 2.
+ */
+bool Build(const float *depth, int size, int levelCount, MipChain &outChain);
+
+/**
+ * @brief Classifies the segment between two world positions.
+ *
+ * @param chain Mips of the light's shadow map.
+ * @param lightViewProj Light matrix as in SpotlightData (transposed: row j gives clip component j).
+ * @param a Segment start.
+ * @param b Segment end.
+ * @param bias Depth bias subtracted before comparing (Config::Shadow::DEPTH_BIAS).
+ * @return Lit, Shadowed, or Mixed when the mips cannot tell (or the segment crosses the light's plane).
+ */
+Visibility Classify(const MipChain &chain, const DirectX::XMFLOAT4X4 &lightViewProj, const DirectX::XMFLOAT3 &a,
+                    const DirectX::XMFLOAT3 &b, float bias = Config::Shadow::DEPTH_BIAS);
+
+} // namespace ShadowMinMax
@@ -0,0 +1,187 @@
+#include "TemporalReprojection.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace TemporalReprojection
+{
+
+namespace
+{
+
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+float Distance(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    const float dz = a.z - b.z;
+    return std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+}
+
+bool Near(float a, float b, float tolerance)
+{
+    return std::fabs(a - b) <= tolerance * (std::max)(1.0f, (std::max)(std::fabs(a), std::fabs(b)));
+}
+
+bool Near(const DirectX::XMFLOAT4 &a, const DirectX::XMFLOAT4 &b, float tolerance)
+{
+    return Near(a.x, b.x, tolerance) && Near(a.y, b.y, tolerance) && Near(a.z, b.z, tolerance) &&
+           Near(a.w, b.w, tolerance);
+}
+
+/// Bilinear read of a per-pixel buffer at texel centers, clamped to the edges (samLinear in the shader).
+void SampleBilinear(const std::vector<float> &buffer, int channels, int width, int height, float u, float v,
+                    float *out)
+{
+    const float maxX = static_cast<float>(width - 1);
+    const float maxY = static_cast<float>(height - 1);
+    const float x = (std::min)((std::max)((u * static_cast<float>(width)) - 0.5f, 0.0f), maxX);
+    const float y = (std::min)((std::max)((v * static_cast<float>(height)) - 0.5f, 0.0f), maxY);
+    const int x0 = static_cast<int>(x);
+    const int y0 = static_cast<int>(y);
+    const int x1 = (std::min)(x0 + 1, width - 1);
+    const int y1 = (std::min)(y0 + 1, height - 1);
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+    for (int c = 0; c < channels; ++c)
+    {
+        auto at = [&](int px, int py) { return buffer[(((static_cast<size_t>(py) * width) + px) * channels) + c]; };
+        const float top = at(x0, y0) + (fx * (at(x1, y0) - at(x0, y0)));
+        const float bottom = at(x0, y1) + (fx * (at(x1, y1) - at(x0, y1)));
+        out[c] = top + (fy * (bottom - top));
+    }
+}
+
+} // namespace
+
+float NoiseOffset(uint32_t frameIndex)
+{
+    const double value = static_cast<double>(frameIndex) * 0.6180339887498949;
+    return static_cast<float>(value - std::floor(value));
+}
+
+bool Reproject(const DirectX::XMFLOAT4X4 &viewProj, const DirectX::XMFLOAT3 &worldPos, DirectX::XMFLOAT2 &outUv)
+{
+    const DirectX::XMFLOAT4X4 &m = viewProj;
+    const float x = (worldPos.x * m._11) + (worldPos.y * m._21) + (worldPos.z * m._31) + m._41;
+    const float y = (worldPos.x * m._12) + (worldPos.y * m._22) + (worldPos.z * m._32) + m._42;
+    const float w = (worldPos.x * m._14) + (worldPos.y * m._24) + (worldPos.z * m._34) + m._44;
+    if (w <= 0.0f)
+        return false;
+
+    outUv = {((x / w) * 0.5f) + 0.5f, 0.5f - ((y / w) * 0.5f)};
+    return outUv.x >= 0.0f && outUv.x <= 1.0f && outUv.y >= 0.0f && outUv.y <= 1.0f;
+}
+
+bool IsHistoryValid(float expectedDistance, float historyDistance, float tolerance)
+{
+    return std::fabs(historyDistance - expectedDistance) <= tolerance * expectedDistance;
+}
+
+DirectX::XMFLOAT3 ClampToNeighborhood(const DirectX::XMFLOAT3 &history, const DirectX::XMFLOAT3 &neighborhoodMin,
+                                      const DirectX::XMFLOAT3 &neighborhoodMax)
+{
+    return {(std::min)((std::max)(history.x, neighborhoodMin.x), neighborhoodMax.x),
+            (std::min)((std::max)(history.y, neighborhoodMin.y), neighborhoodMax.y),
+            (std::min)((std::max)(history.z, neighborhoodMin.z), neighborhoodMax.z)};
+}
+
+DirectX::XMFLOAT3 ResolvePixel(const DirectX::XMFLOAT3 &current, const DirectX::XMFLOAT3 &history, float blend)
+{
+    return {history.x + (blend * (current.x - history.x)), history.y + (blend * (current.y - history.y)),
+            history.z + (blend * (current.z - history.z))};
+}
+
+bool LightStateChanged(const std::vector<SpotlightData> &previous, const std::vector<SpotlightData> &current,
+                       float tolerance)
+{
+    if (previous.size() != current.size())
+        return true;
+    for (size_t i = 0; i < current.size(); ++i)
+    {
+        const SpotlightData &a = previous[i];
+        const SpotlightData &b = current[i];
+        if (!Near(a.posRange, b.posRange, tolerance) || !Near(a.dirAngle, b.dirAngle, tolerance) ||
+            !Near(a.colorInt, b.colorInt, tolerance) || !Near(a.coneGobo.x, b.coneGobo.x, tolerance) ||
+            !Near(a.coneGobo.y, b.coneGobo.y, tolerance) || a.coneGobo.w != b.coneGobo.w)
+            return true;
+    }
+    return false;
+}
+
+bool Accumulate(const View &view, const std::vector<float> &currentRgb, bool reset, History &history, float blend)
+{
+    const size_t pixels = static_cast<size_t>(view.width) * view.height;
+    if (view.width <= 0 || view.height <= 0 || currentRgb.size() != pixels * 3)
+        return false;
+
+    const bool hasHistory = !reset && history.width == view.width && history.height == view.height &&
+                            history.rgb.size() == pixels * 3 && history.distance.size() == pixels;
+    std::vector<float> rgb(pixels * 3);
+    std::vector<float> distance(pixels);
+    for (int y = 0; y < view.height; ++y)
+    {
+        for (int x = 0; x < view.width; ++x)
+        {
+            const size_t pixel = (static_cast<size_t>(y) * view.width) + x;
+            const float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(view.width);
+            const float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(view.height);
+            const float depth = view.depth ? (std::min)(view.depth[pixel], 1.0f) : 1.0f;
+            const DirectX::XMFLOAT3 worldPos = ScreenToWorld(view.invViewProj, u, v, depth);
+            distance[pixel] = Distance(worldPos, view.cameraPos);
+
+            const DirectX::XMFLOAT3 current = {currentRgb[pixel * 3], currentRgb[(pixel * 3) + 1],
+                                               currentRgb[(pixel * 3) + 2]};
+            DirectX::XMFLOAT3 result = current;
+            DirectX::XMFLOAT2 previousUv;
+            if (hasHistory && Reproject(history.viewProj, worldPos, previousUv))
+            {
+                float previousDistance;
+                SampleBilinear(history.distance, 1, view.width, view.height, previousUv.x, previousUv.y,
+                               &previousDistance);
+                if (IsHistoryValid(Distance(worldPos, history.cameraPos), previousDistance))
+                {
+                    // 3x3 bounds of the current frame, clamped at the image edges
+                    DirectX::XMFLOAT3 lo = current;
+                    DirectX::XMFLOAT3 hi = current;
+                    for (int ny = (std::max)(y - 1, 0); ny <= (std::min)(y + 1, view.height - 1); ++ny)
+                    {
+                        for (int nx = (std::max)(x - 1, 0); nx <= (std::min)(x + 1, view.width - 1); ++nx)
+                        {
+                            const float *n = &currentRgb[((static_cast<size_t>(ny) * view.width) + nx) * 3];
+                            lo = {(std::min)(lo.x, n[0]), (std::min)(lo.y, n[1]), (std::min)(lo.z, n[2])};
+                            hi = {(std::max)(hi.x, n[0]), (std::max)(hi.y, n[1]), (std::max)(hi.z, n[2])};
+                        }
+                    }
+                    float previous[3];
+                    SampleBilinear(history.rgb, 3, view.width, view.height, previousUv.x, previousUv.y, previous);
+                    result = ResolvePixel(current, ClampToNeighborhood({previous[0], previous[1], previous[2]}, lo, hi),
+                                          blend);
+                }
+            }
+            rgb[pixel * 3] = result.x;
+            rgb[(pixel * 3) + 1] = result.y;
+            rgb[(pixel * 3) + 2] = result.z;
+        }
+    }
+
+    history.width = view.width;
+    history.height = view.height;
+    history.rgb = std::move(rgb);
+    history.distance = std::move(distance);
+    history.viewProj = view.viewProj;
+    history.cameraPos = view.cameraPos;
+    return true;
+}
+
+} // namespace TemporalReprojection
@@ -0,0 +1,137 @@
+/**
+ * @file TemporalReprojection.h
+ * @brief Reprojection, history rejection and accumulation for the temporal volumetric resolve.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Core/Config.h"
+#include "../Scene/Spotlight.h"
+
+/**
+ * @namespace TemporalReprojection
+ * @brief Accumulates the volumetric buffer over frames with a rotating per-frame jitter.
+ *
+ * Each frame the march offsets its per-pixel noise by NoiseOffset(frame), so consecutive frames
+ * sample different points along every ray. The resolve reconstructs each pixel's world
+ * position from the scene depth, projects it with the previous frame's view-projection and
+ * reads the history there. The history is discarded when the distance it stored for that
+ * point disagrees with the distance from the previous camera (disocclusion), or when the
+ * lights changed (LightStateChanged()). Otherwise it is clamped to the range of the current
+ * frame's 3x3 neighborhood and blended with the current value.
+ *
+ * shaders/temporal.hlsl mirrors Reproject(), IsHistoryValid(), ClampToNeighborhood() and
+ * ResolvePixel(); Accumulate() runs the same resolve on the CPU.
+ */
+namespace TemporalReprojection
+{
+
+/**
+ * @struct View
+ * @brief Camera of one frame and the scene depth it was rendered with.
+ */
+struct View
+{
+    int width = Config::Display::WINDOW_WIDTH;
+    int height = Config::Display::WINDOW_HEIGHT;
+    DirectX::XMFLOAT4X4 viewProj = {};    ///< World-to-clip (row-vector convention, not transposed).
+    DirectX::XMFLOAT4X4 invViewProj = {}; ///< Clip-to-world.
+    DirectX::XMFLOAT3 cameraPos = {0.0f, 0.0f, 0.0f};
+    const float *depth = nullptr;         ///< width * height depths; nullptr for the far plane everywhere.
+};
+
+/**
+ * @struct History
+ * @brief Accumulated result of the previous frames.
+ */
+struct History
+{
+    int width = 0;
+    int height = 0;
+    std::vector<float> rgb;      ///< Three floats per pixel.
+    std::vector<float> distance; ///< Camera distance of each pixel's surface, for rejection.
+    DirectX::XMFLOAT4X4 viewProj = {};
+    DirectX::XMFLOAT3 cameraPos = {0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * @brief Offset added to the march noise on a given frame.
+ *
+ * Golden-ratio sequence: every run of frames covers [0, 1) evenly, so the history converges
+ * to the average over all offsets.
+ *
+ * @param frameIndex Frame counter.
+ * @return Offset in [0, 1).
+ */
+float NoiseOffset(uint32_t frameIndex);
+
+/**
+ * @brief Projects a world position with a previous frame's view-projection.
+ *
+ * @param viewProj Previous world-to-clip matrix (row-vector convention).
+ * @param worldPos Position to project.
+ * @param outUv Receives the screen coordinate (v down).
+ * @return False if the point was behind that camera or off screen.
+ */
+bool Reproject(const DirectX::XMFLOAT4X4 &viewProj, const DirectX::XMFLOAT3 &worldPos, DirectX::XMFLOAT2 &outUv);
+
+/**
+ * @brief Tests whether a history sample belongs to the same surface.
+ *
+ * @param expectedDistance Distance from the previous camera to the current surface point.
+ * @param historyDistance Distance stored in the history.
+ * @param tolerance Accepted relative difference.
+ * @return True if the history can be used.
+ */
+bool IsHistoryValid(float expectedDistance, float historyDistance,
+                    float tolerance = Config::Volumetric::TEMPORAL_DISTANCE_TOLERANCE);
+
+/**
+ * @brief Clamps a history color to the bounds of the current neighborhood, per channel.
+ */
+DirectX::XMFLOAT3 ClampToNeighborhood(const DirectX::XMFLOAT3 &history, const DirectX::XMFLOAT3 &neighborhoodMin,
+                                      const DirectX::XMFLOAT3 &neighborhoodMax);
+
+/**
+ * @brief Blends the current value into a (clamped) history.
+ *
+ * @param current Current frame's value.
+ * @param history Clamped history.
+ * @param blend Weight of the current frame.
+ * @return history + blend * (current - history).
+ */
+DirectX::XMFLOAT3 ResolvePixel(const DirectX::XMFLOAT3 &current, const DirectX::XMFLOAT3 &history, float blend);
+
+/**
+ * @brief Compares the lights of two frames for changes that invalidate the history.
+ *
+ * Position, direction, range, color, intensity, cone angles and gobo slot are compared with
+ * a relative tolerance. Gobo rotation and offset are ignored: they animate continuously and
+ * the neighborhood clamp follows them.
+ *
+ * @param previous Previous frame's lights.
+ * @param current Current frame's lights.
+ * @param tolerance Accepted relative change.
+ * @return True if a light was added, removed or changed.
+ */
+bool LightStateChanged(const std::vector<SpotlightData> &previous, const std::vector<SpotlightData> &current,
+                       float tolerance = Config::Volumetric::TEMPORAL_LIGHT_TOLERANCE);
+
+/**
+ * @brief Runs the temporal resolve on the CPU, as shaders/temporal.hlsl does on the GPU.
+ *
+ * @param view Current camera and depth.
+ * @param currentRgb Current frame's volumetric buffer, three floats per pixel.
+ * @param reset True to discard the history (for example after LightStateChanged()).
+ * @param history Previous result; replaced with the current one (it is empty on the first frame).
+ * @param blend Weight of the current frame where the history is kept.
+ * @return False if the sizes do not match.
+ */
+bool Accumulate(const View &view, const std::vector<float> &currentRgb, bool reset, History &history,
+                float blend = Config::Volumetric::TEMPORAL_BLEND);
+
+} // namespace TemporalReprojection
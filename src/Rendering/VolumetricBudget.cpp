@@ -0,0 +1,265 @@
+#include "VolumetricBudget.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace VolumetricBudget
+{
+
+namespace
+{
+
+constexpr float PI = 3.14159265f;
+constexpr double MILLION = 1.0e6;
+constexpr double RIDGE = 1.0e-6; ///< Keeps the fit solvable while all measurements come from one budget.
+
+DirectX::XMFLOAT3 Sub(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+float Dot(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+DirectX::XMFLOAT3 Normalize(const DirectX::XMFLOAT3 &v)
+{
+    const float length = std::sqrt(Dot(v, v));
+    if (length <= 0.0f)
+        return {0.0f, 0.0f, 1.0f};
+    return {v.x / length, v.y / length, v.z / length};
+}
+
+/**
+ * @brief Average of the shader's 1 / (d^2 + 1) attenuation over a cone of the given length.
+ *
+ * Volume weighted, with d the distance along the axis: 3 / L^3 * integral of d^2 / (d^2 + 1).
+ */
+float MeanAttenuation(float length)
+{
+    if (length < 0.01f)
+        return 1.0f;
+    return 3.0f * (length - std::atan(length)) / (length * length * length);
+}
+
+float Luminance(const DirectX::XMFLOAT4 &color)
+{
+    return (0.2126f * color.x) + (0.7152f * color.y) + (0.0722f * color.z);
+}
+
+} // namespace
+
+float BeamLength(const SpotlightData &light, const DirectX::XMFLOAT3 &boundsMin, const DirectX::XMFLOAT3 &boundsMax)
+{
+    const float origin[3] = {light.posRange.x, light.posRange.y, light.posRange.z};
+    const DirectX::XMFLOAT3 axis = Normalize({light.dirAngle.x, light.dirAngle.y, light.dirAngle.z});
+    const float dir[3] = {axis.x, axis.y, axis.z};
+    const float lo[3] = {boundsMin.x, boundsMin.y, boundsMin.z};
+    const float hi[3] = {boundsMax.x, boundsMax.y, boundsMax.z};
+
+    // Slab test: the beam ends at the nearest exit plane
+    float tEnter = 0.0f;
+    float tExit = light.posRange.w;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (std::fabs(dir[i]) < 1e-6f)
+        {
+            if (origin[i] < lo[i] || origin[i] > hi[i])
+                return 0.0f;
+            continue;
+        }
+        float t0 = (lo[i] - origin[i]) / dir[i];
+        float t1 = (hi[i] - origin[i]) / dir[i];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        tEnter = (std::max)(tEnter, t0);
+        tExit = (std::min)(tExit, t1);
+    }
+    return tEnter < tExit ? tExit : 0.0f;
+}
+
+LightEstimate EstimateLight(const SpotlightData &light, const ConeBounds::Bounds &bounds,
+                            const DirectX::XMFLOAT3 &cameraPos, float length)
+{
+    LightEstimate estimate;
+    const float range = (std::min)(length, light.posRange.w);
+    const float field = light.coneGobo.y; // Cosine of the half angle
+    const float brightness = light.colorInt.w * Luminance(light.colorInt);
+    if (!bounds.visible || brightness <= 0.0f || range <= 0.0f || field <= 0.0f)
+        return estimate;
+    estimate.coverage = (std::min)(1.0f, bounds.area);
+
+    const DirectX::XMFLOAT3 apex = {light.posRange.x, light.posRange.y, light.posRange.z};
+    const DirectX::XMFLOAT3 axis = Normalize({light.dirAngle.x, light.dirAngle.y, light.dirAngle.z});
+    const float radius = range * std::sqrt((std::max)(0.0f, 1.0f - (field * field))) / field;
+
+    // A ray along the axis crosses the whole range, one across it the mean chord of the
+    // cone's cross-sections (pi / 4 of the diameter averaged along the axis)
+    const DirectX::XMFLOAT3 center = {apex.x + (axis.x * range * 0.5f), apex.y + (axis.y * range * 0.5f),
+                                      apex.z + (axis.z * range * 0.5f)};
+    const float facing = std::fabs(Dot(Normalize(Sub(center, cameraPos)), axis));
+    const float across = 0.25f * PI * radius;
+    estimate.marchLength = (std::min)(range, across + ((range - across) * facing));
+    estimate.importance = brightness * MeanAttenuation(range);
+    return estimate;
+}
+
+double Allocate(const std::vector<LightEstimate> &estimates, int pixelCount, double sampleBudget, float minSteps,
+                float maxSteps, std::vector<float> &outSteps)
+{
+    outSteps.assign(estimates.size(), minSteps);
+    if (estimates.empty())
+        return 0.0;
+
+    // Requested steps: march length, then brightness relative to the brightest light
+    float brightest = 0.0f;
+    for (const LightEstimate &e : estimates)
+        brightest = (std::max)(brightest, e.importance * e.marchLength);
+
+    std::vector<double> request(estimates.size(), 0.0);
+    std::vector<double> cost(estimates.size(), 0.0); // Samples per step
+    double requested = 0.0;
+    for (size_t i = 0; i < estimates.size(); ++i)
+    {
+        const LightEstimate &e = estimates[i];
+        if (e.coverage <= 0.0f || brightest <= 0.0f)
+            continue;
+        const float lengthScale = (std::min)(1.0f, e.marchLength / Config::Volumetric::BUDGET_REFERENCE_LENGTH);
+        const float importanceScale = (std::max)(Config::Volumetric::BUDGET_MIN_IMPORTANCE,
+                                                 std::sqrt(e.importance * e.marchLength / brightest));
+        request[i] = (std::max)(static_cast<double>(minSteps), static_cast<double>(maxSteps) * lengthScale *
+                                                                   importanceScale);
+        cost[i] = static_cast<double>(e.coverage) * pixelCount;
+        requested += request[i] * cost[i];
+    }
+
+    // Scale the requests down to the budget; lights held at minSteps leave the rest to the others
+    double scale = 1.0;
+    if (requested > sampleBudget)
+    {
+        std::vector<bool> atMinimum(estimates.size(), false);
+        for (size_t pass = 0; pass < estimates.size(); ++pass)
+        {
+            double fixedSamples = 0.0;
+            double scalable = 0.0;
+            for (size_t i = 0; i < estimates.size(); ++i)
+            {
+                if (atMinimum[i])
+                    fixedSamples += minSteps * cost[i];
+                else
+                    scalable += request[i] * cost[i];
+            }
+            scale = scalable > 0.0 ? (std::max)(0.0, sampleBudget - fixedSamples) / scalable : 0.0;
+
+            bool changed = false;
+            for (size_t i = 0; i < estimates.size(); ++i)
+            {
+                if (!atMinimum[i] && cost[i] > 0.0 && request[i] * scale < minSteps)
+                {
+                    atMinimum[i] = true;
+                    changed = true;
+                }
+            }
+            if (!changed)
+                break;
+        }
+    }
+
+    for (size_t i = 0; i < estimates.size(); ++i)
+    {
+        if (cost[i] > 0.0)
+            outSteps[i] = std::floor(std::clamp(static_cast<float>(request[i] * scale), minSteps, maxSteps));
+    }
+    return CountSamples(estimates, pixelCount, outSteps);
+}
+
+double CountSamples(const std::vector<LightEstimate> &estimates, int pixelCount, const std::vector<float> &steps)
+{
+    double samples = 0.0;
+    for (size_t i = 0; i < estimates.size() && i < steps.size(); ++i)
+        samples += static_cast<double>(estimates[i].coverage) * pixelCount * steps[i];
+    return samples;
+}
+
+double CountCoveredPixels(const std::vector<LightEstimate> &estimates, int pixelCount)
+{
+    double pixels = 0.0;
+    for (const LightEstimate &e : estimates)
+        pixels += static_cast<double>(e.coverage) * pixelCount;
+    return pixels;
+}
+
+CostModel::CostModel()
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        m_rhs[r] = 0.0;
+        for (int c = 0; c < 3; ++c)
+            m_normal[r][c] = 0.0;
+    }
+}
+
+void CostModel::Observe(double coveredPixels, double samples, double milliseconds)
+{
+    const double x[3] = {1.0, coveredPixels / MILLION, samples / MILLION};
+    const double forgetting = Config::Volumetric::COST_MODEL_FORGETTING;
+    for (int r = 0; r < 3; ++r)
+    {
+        m_rhs[r] = (m_rhs[r] * forgetting) + (x[r] * milliseconds);
+        for (int c = 0; c < 3; ++c)
+            m_normal[r][c] = (m_normal[r][c] * forgetting) + (x[r] * x[c]);
+    }
+    ++m_observations;
+    Solve();
+}
+
+void CostModel::Solve()
+{
+    // Gaussian elimination with partial pivoting on the regularized normal equations
+    double a[3][4];
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+            a[r][c] = m_normal[r][c] + (r == c ? RIDGE * (m_normal[0][0] + 1.0) : 0.0);
+        a[r][3] = m_rhs[r];
+    }
+    for (int col = 0; col < 3; ++col)
+    {
+        int pivot = col;
+        for (int r = col + 1; r < 3; ++r)
+        {
+            if (std::fabs(a[r][col]) > std::fabs(a[pivot][col]))
+                pivot = r;
+        }
+        if (std::fabs(a[pivot][col]) < 1e-12)
+            return;
+        for (int c = 0; c < 4; ++c)
+            std::swap(a[col][c], a[pivot][c]);
+        for (int r = 0; r < 3; ++r)
+        {
+            if (r == col)
+                continue;
+            const double f = a[r][col] / a[col][col];
+            for (int c = col; c < 4; ++c)
+                a[r][c] -= f * a[col][c];
+        }
+    }
+    for (int r = 0; r < 3; ++r)
+        m_coefficients[r] = a[r][3] / a[r][r];
+}
+
+double CostModel::Predict(double coveredPixels, double samples) const
+{
+    return m_coefficients[0] + (m_coefficients[1] * coveredPixels / MILLION) + (m_coefficients[2] * samples / MILLION);
+}
+
+double CostModel::SamplesFor(double milliseconds, double coveredPixels) const
+{
+    if (m_coefficients[2] <= 0.0)
+        return -1.0;
+    const double remaining = milliseconds - m_coefficients[0] - (m_coefficients[1] * coveredPixels / MILLION);
+    return (std::max)(0.0, remaining / m_coefficients[2] * MILLION);
+}
+
+} // namespace VolumetricBudget
@@ -0,0 +1,180 @@
+/**
+ * @file VolumetricBudget.h
+ * @brief Per-light step counts for the volumetric march, fitted to a sample budget.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include "../Core/Config.h"
+#include "../Scene/Spotlight.h"
+#include "ConeBounds.h"
+
+/**
+ * @namespace VolumetricBudget
+ * @brief Decides how many march steps each light gets from its cone's footprint on screen.
+ *
+ * The march costs one sample per covered pixel and step, per light. EstimateLight() predicts,
+ * for each cone, the fraction of the screen it covers (the area of its ConeBounds outline),
+ * the length of a typical camera ray inside it and how bright such a ray gets. Allocate()
+ * gives each light a step count that grows with its march length (a short chord through a
+ * distant narrow beam needs few samples to resolve) and, more weakly, with its brightness
+ * relative to the brightest light, then scales all of them down until the samples fit the
+ * budget.
+ *
+ * CostModel learns the GPU time of the march as a function of covered pixels and samples from
+ * timestamp measurements, so the pass can predict the cost of an allocation before drawing and
+ * pick the budget that meets a target time. The shader reads the result from goboOff.w.
+ */
+namespace VolumetricBudget
+{
+
+/**
+ * @struct LightEstimate
+ * @brief Screen footprint and brightness of one light's cone.
+ */
+struct LightEstimate
+{
+    float coverage = 0.0f;    ///< Fraction of the screen inside the projected cone, 0 to 1.
+    float marchLength = 0.0f; ///< Typical length of a camera ray inside the cone.
+    float importance = 0.0f;  ///< Typical in-scattered light of such a ray (before density and phase).
+};
+
+/**
+ * @struct Stats
+ * @brief Budget of one frame, for display.
+ */
+struct Stats
+{
+    double coveredPixels = 0.0; ///< Covered pixels summed over lights.
+    double samples = 0.0;       ///< Samples of the uploaded step counts.
+    double fullSamples = 0.0;   ///< Samples the lights asked for before fitting the budget.
+    double predictedMs = 0.0;   ///< CostModel prediction for this frame.
+    double measuredMs = 0.0;    ///< Latest GPU timing (a few frames old), zero until one arrives.
+    float steps[Config::Spotlight::MAX_SPOTLIGHTS] = {}; ///< Uploaded step count of each light.
+};
+
+/**
+ * @brief Distance along a light's axis to where its beam leaves a box (the room).
+ *
+ * @param light Light as uploaded to the shader.
+ * @param boundsMin Lower corner of the box.
+ * @param boundsMax Upper corner of the box.
+ * @return The exit distance, at most the light's range; zero if the axis misses the box.
+ */
+[[nodiscard]] float BeamLength(const SpotlightData &light, const DirectX::XMFLOAT3 &boundsMin,
+                               const DirectX::XMFLOAT3 &boundsMax);
+
+/**
+ * @brief Estimates the footprint of a light's cone.
+ *
+ * The coverage is the area of the cone's outline (ConeBounds), the march length and
+ * brightness come from the cone cut at the given length.
+ *
+ * @param light Light as uploaded to the shader.
+ * @param bounds Screen bounds of the light (ConeBounds::Compute()).
+ * @param cameraPos Camera position.
+ * @param length Length of the cone, usually BeamLength().
+ * @return The estimate; all zero for a light that is off or entirely off screen.
+ */
+LightEstimate EstimateLight(const SpotlightData &light, const ConeBounds::Bounds &bounds,
+                            const DirectX::XMFLOAT3 &cameraPos, float length);
+
+/**
+ * @brief Distributes a sample budget over lights.
+ *
+ * Each light first asks for maxSteps scaled by its march length over
+ * Config::Volumetric::BUDGET_REFERENCE_LENGTH and by the square root of its brightness
+ * (importance x march length) relative to the brightest light, never less than
+ * Config::Volumetric::BUDGET_MIN_IMPORTANCE of it. If those requests cost more than the
+ * budget, they are scaled down together; lights that reach minSteps stay there and the
+ * others share the rest.
+ *
+ * @param estimates One estimate per light.
+ * @param pixelCount Pixels of the marched image.
+ * @param sampleBudget Samples (covered pixels x steps, summed over lights) to fit in.
+ * @param minSteps Fewest steps a light gets.
+ * @param maxSteps Most steps a light gets.
+ * @param outSteps Receives one step count per light (whole numbers).
+ * @return Samples of the allocation (above the budget only if minSteps does not fit).
+ */
+double Allocate(const std::vector<LightEstimate> &estimates, int pixelCount, double sampleBudget, float minSteps,
+                float maxSteps, std::vector<float> &outSteps);
+
+/**
+ * @brief Samples a step allocation costs.
+ *
+ * @param estimates One estimate per light.
+ * @param pixelCount Pixels of the marched image.
+ * @param steps One step count per light.
+ */
+[[nodiscard]] double CountSamples(const std::vector<LightEstimate> &estimates, int pixelCount,
+                                  const std::vector<float> &steps);
+
+/**
+ * @brief Covered pixels summed over lights (a pixel covered by two cones counts twice).
+ *
+ * @param estimates One estimate per light.
+ * @param pixelCount Pixels of the marched image.
+ */
+[[nodiscard]] double CountCoveredPixels(const std::vector<LightEstimate> &estimates, int pixelCount);
+
+/**
+ * @class CostModel
+ * @brief Linear model of the march's GPU time, fitted to measurements as they come.
+ *
+ * time = overhead + perPixel x covered pixels + perSample x samples, fitted by least squares
+ * with older measurements fading out (Config::Volumetric::COST_MODEL_FORGETTING), so the
+ * model follows changes of resolution, shadow maps or GPU clocks.
+ */
+class CostModel
+{
+public:
+    CostModel();
+
+    /**
+     * @brief Adds a measurement.
+     *
+     * @param coveredPixels Covered pixels of the measured frame (CountCoveredPixels()).
+     * @param samples Samples of the measured frame (Allocate()).
+     * @param milliseconds Measured GPU time.
+     */
+    void Observe(double coveredPixels, double samples, double milliseconds);
+
+    /**
+     * @brief Predicts the GPU time of a frame.
+     *
+     * @param coveredPixels Covered pixels of the frame.
+     * @param samples Samples of the frame.
+     * @return Predicted milliseconds; zero before the first measurement.
+     */
+    [[nodiscard]] double Predict(double coveredPixels, double samples) const;
+
+    /**
+     * @brief Finds the samples that fit a time, the inverse of Predict() for given covered pixels.
+     *
+     * @param milliseconds Target GPU time.
+     * @param coveredPixels Covered pixels of the frame.
+     * @return Samples, at least zero; negative if the model cannot tell yet.
+     */
+    [[nodiscard]] double SamplesFor(double milliseconds, double coveredPixels) const;
+
+    /**
+     * @brief Checks if enough measurements were seen to trust SamplesFor().
+     */
+    [[nodiscard]] bool IsCalibrated() const
+    {
+        return m_observations >= Config::Volumetric::COST_MODEL_MIN_OBSERVATIONS;
+    }
+
+private:
+    void Solve();
+
+    double m_normal[3][3]; ///< Weighted sums of x x^T, x = (1, pixels, samples) in millions.
+    double m_rhs[3];       ///< Weighted sums of x time.
+    double m_coefficients[3] = {0.0, 0.0, 0.0};
+    int m_observations = 0;
+};
+
+} // namespace VolumetricBudget
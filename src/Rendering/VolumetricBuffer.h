@@ -0,0 +1,25 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+/// Bits of VolumetricBuffer::jitter.w, FEATURE_* in the shader.
+constexpr unsigned int VOLUMETRIC_FEATURE_TILE_MASK = 1;
+constexpr unsigned int VOLUMETRIC_FEATURE_SHADOW_INTERVALS = 2;
+constexpr unsigned int VOLUMETRIC_FEATURE_EPIPOLAR = 4;
+constexpr unsigned int VOLUMETRIC_FEATURE_LIGHT_SAMPLING = 8;
+constexpr unsigned int VOLUMETRIC_FEATURE_GOBO_SAT = 16;
+constexpr unsigned int VOLUMETRIC_FEATURE_HAZE = 32;
+constexpr unsigned int VOLUMETRIC_FEATURE_GOBO_MONO = 64; // Light 0; light i is GOBO_MONO << i
+
+/**
+ * @struct VolumetricBuffer
+ * @brief Parameters for the volumetric lighting (ray marching) shader.
+ *
+ * Kept free of Direct3D headers so the CPU reference renderer can share it.
+ */
+struct alignas(16) VolumetricBuffer
+{
+    DirectX::XMFLOAT4 params; ///< x: stepCount, y: density, z: intensity, w: anisotropy.
+    DirectX::XMFLOAT4 jitter; ///< x: jitter offset, y: analytic beam cores, z: noise offset, w: feature bits.
+    DirectX::XMFLOAT4 screen; ///< xy: render target size in pixels, zw: 1 / size.
+};
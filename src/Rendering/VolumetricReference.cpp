@@ -0,0 +1,597 @@
+#include "VolumetricReference.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../Core/ThreadPool.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+
+namespace VolumetricReference
+{
+
+using namespace Simd;
+
+namespace
+{
+
+// ---------------------------------------------------------------------------------------------
+// Shader helpers
+// ---------------------------------------------------------------------------------------------
+
+float Frac(float x)
+{
+    return x - std::floor(x);
+}
+
+float Saturate(float x)
+{
+    return (std::min)((std::max)(x, 0.0f), 1.0f);
+}
+
+float InterleavedGradientNoise(float px, float py)
+{
+    return Frac(52.9829189f * Frac((px * 0.06711056f) + (py * 0.00583715f)));
+}
+
+float HenyeyGreenstein(float cosTheta, float g)
+{
+    const float g2 = g * g;
+    return (1.0f - g2) / (4.0f * 3.14159f * std::pow((std::max)(0.001f, 1.0f + g2 - (2.0f * g * cosTheta)), 1.5f));
+}
+
+float Dot(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+}
+
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+/// D3D rounds a float array index to the nearest slice and clamps it.
+int ArraySlice(const TextureArray &texture, float index)
+{
+    return (std::min)((std::max)(static_cast<int>(std::floor(index + 0.5f)), 0), texture.layers - 1);
+}
+
+/// Bilinear RGB sample with a black border (samLinear).
+DirectX::XMFLOAT3 SampleGobo(const TextureArray &texture, float u, float v, int slice)
+{
+    const float x = (u * static_cast<float>(texture.width)) - 0.5f;
+    const float y = (v * static_cast<float>(texture.height)) - 0.5f;
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+
+    DirectX::XMFLOAT3 result = {0.0f, 0.0f, 0.0f};
+    const float *layer = texture.texels.data() +
+                         (static_cast<size_t>(slice) * texture.width * texture.height * texture.channels);
+    for (int j = 0; j < 2; ++j)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            const int tx = x0 + i;
+            const int ty = y0 + j;
+            if (tx < 0 || ty < 0 || tx >= texture.width || ty >= texture.height)
+                continue;
+            const float weight = (i ? fx : 1.0f - fx) * (j ? fy : 1.0f - fy);
+            const float *texel = layer + ((static_cast<size_t>(ty) * texture.width + tx) * texture.channels);
+            result.x += weight * texel[0];
+            result.y += weight * texel[1];
+            result.z += weight * texel[2];
+        }
+    }
+    return result;
+}
+
+/// Bilinear percentage-closer sample (LESS_EQUAL, border depth 1), as SampleCmpLevelZero.
+float SampleShadow(const TextureArray &texture, float u, float v, int slice, float reference)
+{
+    const float x = (u * static_cast<float>(texture.width)) - 0.5f;
+    const float y = (v * static_cast<float>(texture.height)) - 0.5f;
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+
+    float lit = 0.0f;
+    const float *layer = texture.texels.data() + (static_cast<size_t>(slice) * texture.width * texture.height);
+    for (int j = 0; j < 2; ++j)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            const int tx = x0 + i;
+            const int ty = y0 + j;
+            const bool inside = tx >= 0 && ty >= 0 && tx < texture.width && ty < texture.height;
+            const float depth = inside ? layer[(static_cast<size_t>(ty) * texture.width) + tx] : 1.0f;
+            if (reference <= depth)
+                lit += (i ? fx : 1.0f - fx) * (j ? fy : 1.0f - fy);
+        }
+    }
+    return lit;
+}
+
+} // namespace
+
+std::vector<LightSetup> SetupLights(const Inputs &inputs)
+{
+    std::vector<LightSetup> setups;
+    const size_t count = (std::min)(inputs.lightCount, static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS));
+    for (size_t i = 0; i < count && inputs.lights; ++i)
+    {
+        const SpotlightData &light = inputs.lights[i];
+        if (light.colorInt.w <= 0.0f)
+            continue;
+
+        LightSetup setup;
+        setup.pos = {light.posRange.x, light.posRange.y, light.posRange.z};
+        const float length = std::sqrt((light.dirAngle.x * light.dirAngle.x) + (light.dirAngle.y * light.dirAngle.y) +
+                                       (light.dirAngle.z * light.dirAngle.z));
+        setup.dir = {light.dirAngle.x / length, light.dirAngle.y / length, light.dirAngle.z / length};
+        setup.color = {light.colorInt.x, light.colorInt.y, light.colorInt.z};
+        setup.intensity = light.colorInt.w;
+        setup.range = light.posRange.w;
+        setup.beam = light.coneGobo.x;
+        setup.field = light.coneGobo.y;
+        setup.goboSin = std::sin(light.coneGobo.z);
+        setup.goboCos = std::cos(light.coneGobo.z);
+        setup.goboOffset = {light.goboOff.x, light.goboOff.y};
+        setup.goboSlice = inputs.gobos ? ArraySlice(*inputs.gobos, light.coneGobo.w) : 0;
+        setup.shadowSlice = inputs.shadowMaps ? ArraySlice(*inputs.shadowMaps, static_cast<float>(i)) : 0;
+        setup.stepCount = static_cast<int>(light.goboOff.w > 0.0f ? light.goboOff.w : inputs.params.params.x);
+        DirectX::XMStoreFloat4x4(&setup.lightViewProj, light.lightViewProj);
+        setups.push_back(setup);
+    }
+    return setups;
+}
+
+float ShadowAndGobo(const Inputs &inputs, const LightSetup &light, float projX, float projY, float projZ,
+                    bool inFront, DirectX::XMFLOAT3 &outGobo)
+{
+    float shadow = 1.0f;
+    if (inFront && inputs.shadowMaps)
+    {
+        const float u = (projX * 0.5f) + 0.5f;
+        const float v = 1.0f - ((projY * 0.5f) + 0.5f);
+        if (u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f)
+            shadow = SampleShadow(*inputs.shadowMaps, u, v, light.shadowSlice, projZ - Config::Shadow::DEPTH_BIAS);
+    }
+    if (shadow <= 0.0f)
+        return 0.0f;
+
+    const float rx = (projX * light.goboCos) - (projY * light.goboSin) + light.goboOffset.x;
+    const float ry = (projX * light.goboSin) + (projY * light.goboCos) + light.goboOffset.y;
+    const float u = (rx * 0.5f) + 0.5f;
+    const float v = 1.0f - ((ry * 0.5f) + 0.5f);
+    if (u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f)
+        outGobo = inputs.gobos ? SampleGobo(*inputs.gobos, u, v, light.goboSlice) : DirectX::XMFLOAT3{1.0f, 1.0f, 1.0f};
+    else
+        outGobo = {0.0f, 0.0f, 0.0f};
+    return shadow;
+}
+
+void AccumulateInScatter(const Inputs &inputs, const LightSetup &light, const Float8 pos[3], const Float8 ray[3],
+                         Float8 active, Float8 weight, Float8 outRgb[3])
+{
+    const Float8 zero = Set1(0.0f);
+    const Float8 toX = Set1(light.pos.x) - pos[0];
+    const Float8 toY = Set1(light.pos.y) - pos[1];
+    const Float8 toZ = Set1(light.pos.z) - pos[2];
+    const Float8 dist2 = (toX * toX) + (toY * toY) + (toZ * toZ);
+    const Float8 dist = Sqrt(dist2);
+    Float8 mask = active & Less(dist, Set1(light.range));
+    if (MoveMask(mask) == 0)
+        return;
+
+    const Float8 attenuation = Set1(light.intensity) / (dist2 + Set1(1.0f));
+    const Float8 invDist = Set1(1.0f) / Max(dist, Set1(0.0001f));
+    const Float8 nX = toX * invDist;
+    const Float8 nY = toY * invDist;
+    const Float8 nZ = toZ * invDist;
+    const Float8 cosAngle = zero - ((nX * Set1(light.dir.x)) + (nY * Set1(light.dir.y)) + (nZ * Set1(light.dir.z)));
+    const Float8 spotEffect =
+        Saturate((cosAngle - Set1(light.field)) / Set1((std::max)(0.001f, light.beam - light.field)));
+    mask = mask & Less(zero, spotEffect);
+    const int lanes = MoveMask(mask);
+    if (lanes == 0)
+        return;
+
+    // Light-space position; texture lookups are gathered one lane at a time
+    const DirectX::XMFLOAT4X4 &m = light.lightViewProj;
+    const Float8 clipX = (pos[0] * Set1(m._11)) + (pos[1] * Set1(m._12)) + (pos[2] * Set1(m._13)) + Set1(m._14);
+    const Float8 clipY = (pos[0] * Set1(m._21)) + (pos[1] * Set1(m._22)) + (pos[2] * Set1(m._23)) + Set1(m._24);
+    const Float8 clipZ = (pos[0] * Set1(m._31)) + (pos[1] * Set1(m._32)) + (pos[2] * Set1(m._33)) + Set1(m._34);
+    const Float8 clipW = (pos[0] * Set1(m._41)) + (pos[1] * Set1(m._42)) + (pos[2] * Set1(m._43)) + Set1(m._44);
+    const Float8 inFront = Less(zero, clipW);
+    const Float8 safeW = Select(inFront, clipW, Set1(1.0f));
+    alignas(32) float projX[LANES];
+    alignas(32) float projY[LANES];
+    alignas(32) float projZ[LANES];
+    Store(projX, Select(inFront, clipX / safeW, zero));
+    Store(projY, Select(inFront, clipY / safeW, zero));
+    Store(projZ, Select(inFront, clipZ / safeW, zero));
+    const int frontLanes = MoveMask(inFront);
+
+    alignas(32) float shadow[LANES] = {};
+    alignas(32) float goboR[LANES] = {};
+    alignas(32) float goboG[LANES] = {};
+    alignas(32) float goboB[LANES] = {};
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        if (!(lanes & (1 << lane)))
+            continue;
+        DirectX::XMFLOAT3 gobo = {0.0f, 0.0f, 0.0f};
+        shadow[lane] = ShadowAndGobo(inputs, light, projX[lane], projY[lane], projZ[lane],
+                                     (frontLanes & (1 << lane)) != 0, gobo);
+        goboR[lane] = gobo.x;
+        goboG[lane] = gobo.y;
+        goboB[lane] = gobo.z;
+    }
+
+    // Henyey-Greenstein phase, pow(x, 1.5) as x * sqrt(x)
+    const float g = inputs.params.params.w;
+    const Float8 g2 = Set1(g * g);
+    const Float8 cosTheta = zero - ((ray[0] * nX) + (ray[1] * nY) + (ray[2] * nZ));
+    const Float8 base = Max(Set1(0.001f), Set1(1.0f) + g2 - (Set1(2.0f * g) * cosTheta));
+    const Float8 phase = (Set1(1.0f) - g2) / (Set1(4.0f * 3.14159f) * base * Sqrt(base));
+
+    const Float8 scatter = attenuation * spotEffect * Load(shadow) * phase * Set1(inputs.params.params.y) * weight;
+    outRgb[0] = outRgb[0] + Select(mask, Set1(light.color.x) * scatter * Load(goboR), zero);
+    outRgb[1] = outRgb[1] + Select(mask, Set1(light.color.y) * scatter * Load(goboG), zero);
+    outRgb[2] = outRgb[2] + Select(mask, Set1(light.color.z) * scatter * Load(goboB), zero);
+}
+
+namespace
+{
+
+/**
+ * @brief Camera ray of one pixel, as at the top of the pixel shader.
+ */
+void PixelRay(const Inputs &inputs, int x, int y, DirectX::XMFLOAT3 &outDir, float &outLength, float &outNoise)
+{
+    const float px = static_cast<float>(x) + 0.5f; // SV_Position is the pixel center
+    const float py = static_cast<float>(y) + 0.5f;
+    float depth = inputs.depth ? inputs.depth[(static_cast<size_t>(y) * inputs.width) + x] : 1.0f;
+    if (depth >= 1.0f)
+        depth = 1.0f;
+
+    const DirectX::XMFLOAT3 worldPos = ScreenToWorld(inputs.invViewProj, px / static_cast<float>(inputs.width),
+                                                     py / static_cast<float>(inputs.height), depth);
+    const DirectX::XMFLOAT3 ray = {worldPos.x - inputs.cameraPos.x, worldPos.y - inputs.cameraPos.y,
+                                   worldPos.z - inputs.cameraPos.z};
+    outLength = std::sqrt(Dot(ray, ray));
+    const float scale = 1.0f / (std::max)(outLength, 0.0001f);
+    outDir = {ray.x * scale, ray.y * scale, ray.z * scale};
+
+    // Rotated by the per-frame offset when accumulating over frames (see TemporalReprojection)
+    outNoise = Frac(InterleavedGradientNoise(px, py) + inputs.params.jitter.z);
+}
+
+/**
+ * @brief Clamps a cone intersection to the ray and light range; false when nothing is left.
+ */
+bool MarchSegment(const Inputs &inputs, const LightSetup &light, const DirectX::XMFLOAT3 &dir, float rayLength,
+                  float &outEnter, float &outExit)
+{
+    const DirectX::XMFLOAT2 cone =
+        RayConeIntersect(inputs.cameraPos, dir, light.pos, light.dir, light.field, light.range);
+    if (cone.x < 0.0f)
+        return false;
+    outEnter = (std::max)(0.0f, cone.x);
+    outExit = (std::min)(rayLength, (std::min)(cone.y, light.range));
+    return outEnter < outExit;
+}
+
+/**
+ * @brief Marches eight horizontally adjacent pixels of one row.
+ *
+ * @param count Pixels in this batch (the rest of the lanes are idle).
+ * @param outRgb Output position of the first pixel.
+ */
+void ShadeBatch(const Inputs &inputs, const std::vector<LightSetup> &lights, int x0, int y, int count, float *outRgb)
+{
+    alignas(32) float dirX[LANES] = {};
+    alignas(32) float dirY[LANES] = {};
+    alignas(32) float dirZ[LANES] = {};
+    float rayLength[LANES] = {};
+    alignas(32) float noise[LANES] = {};
+    for (int lane = 0; lane < count; ++lane)
+    {
+        DirectX::XMFLOAT3 dir;
+        PixelRay(inputs, x0 + lane, y, dir, rayLength[lane], noise[lane]);
+        dirX[lane] = dir.x;
+        dirY[lane] = dir.y;
+        dirZ[lane] = dir.z;
+    }
+    const Float8 rayX = Load(dirX);
+    const Float8 rayY = Load(dirY);
+    const Float8 rayZ = Load(dirZ);
+    const Float8 ray[3] = {rayX, rayY, rayZ};
+    const Float8 camX = Set1(inputs.cameraPos.x);
+    const Float8 camY = Set1(inputs.cameraPos.y);
+    const Float8 camZ = Set1(inputs.cameraPos.z);
+
+    const Float8 zero = Set1(0.0f);
+    Float8 acc[3] = {zero, zero, zero};
+
+    for (const LightSetup &light : lights)
+    {
+        const int stepCount = light.stepCount;
+        alignas(32) float enter[LANES] = {};
+        alignas(32) float exit[LANES] = {};
+        alignas(32) float laneActive[LANES] = {};
+        bool any = false;
+        for (int lane = 0; lane < count; ++lane)
+        {
+            const DirectX::XMFLOAT3 dir = {dirX[lane], dirY[lane], dirZ[lane]};
+            if (!MarchSegment(inputs, light, dir, rayLength[lane], enter[lane], exit[lane]))
+                continue;
+            laneActive[lane] = 1.0f;
+            any = true;
+        }
+        if (!any || stepCount <= 0)
+            continue;
+
+        const Float8 active = Less(zero, Load(laneActive));
+        const Float8 tEnter = Load(enter);
+        const Float8 marchDist = Load(exit) - tEnter;
+        const Float8 laneNoise = Load(noise);
+        const Float8 invSteps = Set1(1.0f / static_cast<float>(stepCount));
+        for (int s = 0; s < stepCount; ++s)
+        {
+            // Quadratic distribution, denser near the entry point, noise within the stratum (see the shader)
+            const Float8 tNormalized = (Set1(static_cast<float>(s)) + laneNoise) * invSteps;
+            const Float8 remaining = Set1(1.0f) - tNormalized;
+            const Float8 t = tEnter + ((Set1(1.0f) - (remaining * remaining)) * marchDist);
+            const Float8 stepLen = Set1(2.0f) * remaining * invSteps * marchDist;
+            const Float8 pos[3] = {camX + (rayX * t), camY + (rayY * t), camZ + (rayZ * t)};
+            AccumulateInScatter(inputs, light, pos, ray, active, stepLen, acc);
+        }
+    }
+
+    alignas(32) float r[LANES];
+    alignas(32) float gr[LANES];
+    alignas(32) float b[LANES];
+    const Float8 intensity = Set1(inputs.params.params.z);
+    Store(r, acc[0] * intensity);
+    Store(gr, acc[1] * intensity);
+    Store(b, acc[2] * intensity);
+    for (int lane = 0; lane < count; ++lane)
+    {
+        outRgb[(lane * 3) + 0] = r[lane];
+        outRgb[(lane * 3) + 1] = gr[lane];
+        outRgb[(lane * 3) + 2] = b[lane];
+    }
+}
+
+} // namespace
+
+DirectX::XMFLOAT2 RayConeIntersect(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                                   const DirectX::XMFLOAT3 &apex, const DirectX::XMFLOAT3 &axis, float cosAngle,
+                                   float maxRange)
+{
+    const DirectX::XMFLOAT3 co = {origin.x - apex.x, origin.y - apex.y, origin.z - apex.z};
+    const float coLength = std::sqrt(Dot(co, co));
+    const float cos2 = cosAngle * cosAngle;
+
+    // Camera inside the cone: in front of the apex, within the angle and the range
+    const bool inFrontOfApex = Dot(co, axis) > 0.0f;
+    const float cosToCamera = coLength > 0.0001f ? Dot(co, axis) / coLength : 0.0f;
+    const bool insideCone = inFrontOfApex && cosToCamera >= cosAngle && coLength < maxRange;
+
+    const float dv = Dot(dir, axis);
+    const float cv = Dot(co, axis);
+    const float dd = Dot(dir, dir);
+    const float cd = Dot(co, dir);
+    const float cc = Dot(co, co);
+    const float a = (dv * dv) - (cos2 * dd);
+    const float b = 2.0f * ((dv * cv) - (cos2 * cd));
+    const float c = (cv * cv) - (cos2 * cc);
+
+    if (std::fabs(a) < 0.00001f)
+        return insideCone ? DirectX::XMFLOAT2{0.0f, maxRange} : DirectX::XMFLOAT2{-1.0f, -1.0f};
+
+    const float discriminant = (b * b) - (4.0f * a * c);
+    if (discriminant < 0.0f)
+        return insideCone ? DirectX::XMFLOAT2{0.0f, maxRange} : DirectX::XMFLOAT2{-1.0f, -1.0f};
+
+    const float sqrtDisc = std::sqrt(discriminant);
+    float t1 = (-b - sqrtDisc) / (2.0f * a);
+    float t2 = (-b + sqrtDisc) / (2.0f * a);
+    if (t1 > t2)
+        std::swap(t1, t2);
+
+    // Hits must be in front of the camera and on the forward nappe of the cone
+    const DirectX::XMFLOAT3 p1 = {origin.x + (dir.x * t1) - apex.x, origin.y + (dir.y * t1) - apex.y,
+                                  origin.z + (dir.z * t1) - apex.z};
+    const DirectX::XMFLOAT3 p2 = {origin.x + (dir.x * t2) - apex.x, origin.y + (dir.y * t2) - apex.y,
+                                  origin.z + (dir.z * t2) - apex.z};
+    const bool valid1 = t1 > 0.0f && Dot(p1, axis) > 0.0f;
+    const bool valid2 = t2 > 0.0f && Dot(p2, axis) > 0.0f;
+
+    if (insideCone)
+    {
+        if (valid2)
+            return {0.0f, t2};
+        if (valid1)
+            return {0.0f, t1};
+        return {0.0f, maxRange};
+    }
+    if (valid1 && valid2)
+        return {t1, t2};
+    if (valid1)
+        return {t1, maxRange};
+    if (valid2)
+        return {0.0f, t2};
+    return {-1.0f, -1.0f};
+}
+
+DirectX::XMFLOAT3 ShadePixel(const Inputs &inputs, int x, int y)
+{
+    DirectX::XMFLOAT3 rayDir;
+    float rayLength;
+    float noise;
+    PixelRay(inputs, x, y, rayDir, rayLength, noise);
+
+    const float g = inputs.params.params.w;
+    DirectX::XMFLOAT3 accumulated = {0.0f, 0.0f, 0.0f};
+
+    for (const LightSetup &light : SetupLights(inputs))
+    {
+        float tEnter;
+        float tExit;
+        if (!MarchSegment(inputs, light, rayDir, rayLength, tEnter, tExit))
+            continue;
+        const float marchDist = tExit - tEnter;
+        const int stepCount = light.stepCount;
+
+        for (int s = 0; s < stepCount; ++s)
+        {
+            const float tNormalized = (static_cast<float>(s) + noise) / static_cast<float>(stepCount);
+            const float tQuad = 1.0f - ((1.0f - tNormalized) * (1.0f - tNormalized));
+            const float t = tEnter + (tQuad * marchDist);
+            const DirectX::XMFLOAT3 pos = {inputs.cameraPos.x + (rayDir.x * t), inputs.cameraPos.y + (rayDir.y * t),
+                                           inputs.cameraPos.z + (rayDir.z * t)};
+            const float stepLen = 2.0f * (1.0f - tNormalized) / static_cast<float>(stepCount) * marchDist;
+
+            const DirectX::XMFLOAT3 toLight = {light.pos.x - pos.x, light.pos.y - pos.y, light.pos.z - pos.z};
+            const float dist = std::sqrt(Dot(toLight, toLight));
+            if (dist >= light.range)
+                continue;
+
+            const float attenuation = light.intensity / ((dist * dist) + 1.0f);
+            const float invDist = 1.0f / (std::max)(dist, 0.0001f);
+            const DirectX::XMFLOAT3 toLightNorm = {toLight.x * invDist, toLight.y * invDist, toLight.z * invDist};
+            const float cosAngle = -Dot(toLightNorm, light.dir);
+            const float spotEffect =
+                Saturate((cosAngle - light.field) / (std::max)(0.001f, light.beam - light.field));
+            if (spotEffect <= 0.0f)
+                continue;
+
+            const DirectX::XMFLOAT4X4 &m = light.lightViewProj;
+            const float clipX = (pos.x * m._11) + (pos.y * m._12) + (pos.z * m._13) + m._14;
+            const float clipY = (pos.x * m._21) + (pos.y * m._22) + (pos.z * m._23) + m._24;
+            const float clipZ = (pos.x * m._31) + (pos.y * m._32) + (pos.z * m._33) + m._34;
+            const float clipW = (pos.x * m._41) + (pos.y * m._42) + (pos.z * m._43) + m._44;
+            const bool inFront = clipW > 0.0f;
+            DirectX::XMFLOAT3 gobo = {0.0f, 0.0f, 0.0f};
+            const float shadow = ShadowAndGobo(inputs, light, inFront ? clipX / clipW : 0.0f,
+                                               inFront ? clipY / clipW : 0.0f, inFront ? clipZ / clipW : 0.0f, inFront,
+                                               gobo);
+            if (shadow <= 0.0f)
+                continue;
+
+            const float phase = HenyeyGreenstein(-Dot(rayDir, toLightNorm), g);
+            const float scatter = attenuation * spotEffect * shadow * phase * inputs.params.params.y * stepLen;
+            accumulated.x += light.color.x * scatter * gobo.x;
+            accumulated.y += light.color.y * scatter * gobo.y;
+            accumulated.z += light.color.z * scatter * gobo.z;
+        }
+    }
+
+    const float intensity = inputs.params.params.z;
+    return {accumulated.x * intensity, accumulated.y * intensity, accumulated.z * intensity};
+}
+
+bool Render(const Inputs &inputs, std::vector<float> &outRgb)
+{
+    if (inputs.width <= 0 || inputs.height <= 0)
+        return false;
+
+    outRgb.assign(static_cast<size_t>(inputs.width) * inputs.height * 3, 0.0f);
+    const std::vector<LightSetup> lights = SetupLights(inputs);
+    if (lights.empty())
+        return true;
+
+    const int tilesX = (inputs.width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tilesY = (inputs.height + TILE_SIZE - 1) / TILE_SIZE;
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(tilesX) * tilesY,
+                                     [&](size_t tile)
+                                     {
+                                         const int tileX = static_cast<int>(tile % tilesX) * TILE_SIZE;
+                                         const int tileY = static_cast<int>(tile / tilesX) * TILE_SIZE;
+                                         const int endX = (std::min)(inputs.width, tileX + TILE_SIZE);
+                                         const int endY = (std::min)(inputs.height, tileY + TILE_SIZE);
+                                         for (int y = tileY; y < endY; ++y)
+                                         {
+                                             for (int x = tileX; x < endX; x += LANES)
+                                             {
+                                                 const size_t pixel = (static_cast<size_t>(y) * inputs.width) + x;
+                                                 ShadeBatch(inputs, lights, x, y, (std::min)(LANES, endX - x),
+                                                            &outRgb[pixel * 3]);
+                                             }
+                                         }
+                                     });
+    return true;
+}
+
+bool LoadGobos(const std::vector<std::vector<uint8_t>> &filesData, TextureArray &outGobos)
+{
+    struct ImageData
+    {
+        unsigned char *pixels;
+        int width;
+        int height;
+    };
+    std::vector<ImageData> images;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    for (const auto &fileData : filesData)
+    {
+        int w, h, c;
+        unsigned char *pixels =
+            stbi_load_from_memory(fileData.data(), static_cast<int>(fileData.size()), &w, &h, &c, 4);
+        if (!pixels)
+            continue;
+        images.push_back({pixels, w, h});
+        maxWidth = (std::max)(maxWidth, w);
+        maxHeight = (std::max)(maxHeight, h);
+    }
+    if (images.empty())
+        return false;
+
+    outGobos.width = maxWidth;
+    outGobos.height = maxHeight;
+    outGobos.layers = static_cast<int>(images.size());
+    outGobos.channels = 4;
+    outGobos.texels.assign(static_cast<size_t>(maxWidth) * maxHeight * 4 * images.size(), 0.0f);
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        // Centered in the largest size; transparent pixels become black (gobo mask)
+        const ImageData &image = images[i];
+        const int offsetX = (maxWidth - image.width) / 2;
+        const int offsetY = (maxHeight - image.height) / 2;
+        float *layer = outGobos.texels.data() + (i * maxWidth * maxHeight * 4);
+        for (int y = 0; y < image.height; ++y)
+        {
+            for (int x = 0; x < image.width; ++x)
+            {
+                const unsigned char *src = image.pixels + ((static_cast<size_t>(y) * image.width + x) * 4);
+                float *dst = layer + ((static_cast<size_t>(y + offsetY) * maxWidth + (x + offsetX)) * 4);
+                const bool opaque = src[3] >= 128;
+                for (int k = 0; k < 3; ++k)
+                    dst[k] = opaque ? static_cast<float>(src[k]) / 255.0f : 0.0f;
+                dst[3] = static_cast<float>(src[3]) / 255.0f;
+            }
+        }
+        stbi_image_free(image.pixels);
+    }
+    return true;
+}
+
+bool WriteHdr(const std::string &fileName, int width, int height, const std::vector<float> &rgb)
+{
+    if (width <= 0 || height <= 0 || rgb.size() < static_cast<size_t>(width) * height * 3)
+        return false;
+    return stbi_write_hdr(fileName.c_str(), width, height, 3, rgb.data()) != 0;
+}
+
+} // namespace VolumetricReference
@@ -0,0 +1,182 @@
+/**
+ * @file VolumetricReference.h
+ * @brief CPU port of shaders/volumetric.hlsl for offline previews and shader validation.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Core/Config.h"
+#include "../Scene/Spotlight.h"
+#include "Float8.h"
+#include "VolumetricBuffer.h"
+
+/**
+ * @namespace VolumetricReference
+ * @brief Renders the volumetric pass on the CPU with the same inputs and math as the shader.
+ *
+ * The image is split into tiles rendered in parallel on the shared ThreadPool. Within a tile,
+ * eight neighbouring pixels are marched together: the per-sample math runs on eight lanes
+ * (AVX when the compiler targets it, otherwise two SSE registers), while texture lookups are
+ * done per lane. ShadePixel() is a straight scalar transcription of the pixel shader, kept as
+ * the readable reference the vector path is tested against. Beam cores are always ray marched,
+ * as when the shader's analytic path is disabled (see AnalyticScattering).
+ * AccumulateInScatter() is the per-sample kernel, shared with FroxelVolume's light injection.
+ */
+namespace VolumetricReference
+{
+
+/// Pixels per side of a parallel work item (a multiple of the eight-ray batch).
+constexpr int TILE_SIZE = 16;
+
+/**
+ * @struct TextureArray
+ * @brief CPU copy of a Texture2DArray, sampled like the GPU with border addressing.
+ */
+struct TextureArray
+{
+    int width = 0;
+    int height = 0;
+    int layers = 0;
+    int channels = 4;          ///< 4 for gobos (RGBA in [0, 1]), 1 for shadow depths.
+    std::vector<float> texels; ///< Layer-major, then row-major.
+};
+
+/**
+ * @struct Inputs
+ * @brief Everything the volumetric pixel shader reads.
+ */
+struct Inputs
+{
+    int width = Config::Display::WINDOW_WIDTH;   ///< Output width in pixels.
+    int height = Config::Display::WINDOW_HEIGHT; ///< Output height in pixels.
+    DirectX::XMFLOAT4X4 invViewProj = {};        ///< Clip-to-world (row-vector convention, not transposed).
+    DirectX::XMFLOAT3 cameraPos = {0.0f, 0.0f, 0.0f};
+    const float *depth = nullptr;                ///< width * height scene depths; nullptr for the far plane everywhere.
+    const SpotlightData *lights = nullptr;       ///< As uploaded to the GPU (lightViewProj transposed).
+    size_t lightCount = 0;                       ///< At most Config::Spotlight::MAX_SPOTLIGHTS are used.
+    VolumetricBuffer params = {};                ///< Step count, density, intensity and anisotropy.
+    const TextureArray *gobos = nullptr;         ///< Gobo slices; nullptr for an open (white) gobo.
+    const TextureArray *shadowMaps = nullptr;    ///< One layer per light; nullptr for no shadows.
+};
+
+/**
+ * @struct LightSetup
+ * @brief Per-light values that are uniform over the image.
+ */
+struct LightSetup
+{
+    DirectX::XMFLOAT3 pos;
+    DirectX::XMFLOAT3 dir; ///< Normalized.
+    DirectX::XMFLOAT3 color;
+    float intensity;
+    float range;
+    float beam;
+    float field;
+    float goboSin;
+    float goboCos;
+    DirectX::XMFLOAT2 goboOffset;
+    int goboSlice;
+    int shadowSlice;
+    int stepCount; ///< goboOff.w when set (see VolumetricBudget), else params.x.
+    DirectX::XMFLOAT4X4 lightViewProj; ///< Transposed, as in SpotlightData: row j gives clip component j.
+};
+
+/**
+ * @brief Prepares the enabled lights (positive intensity, at most MAX_SPOTLIGHTS).
+ */
+std::vector<LightSetup> SetupLights(const Inputs &inputs);
+
+/**
+ * @brief Shadow and gobo terms at one point, as sampled by the shader.
+ *
+ * @param inputs Textures to sample.
+ * @param light Light from SetupLights().
+ * @param projX Light-space x after the perspective divide (0 when w <= 0, as in the shader).
+ * @param projY Light-space y after the perspective divide.
+ * @param projZ Light-space depth after the perspective divide.
+ * @param inFront True when the light-space w is positive.
+ * @param outGobo Receives the gobo color (only meaningful when the result is positive).
+ * @return Shadow factor in [0, 1].
+ */
+float ShadowAndGobo(const Inputs &inputs, const LightSetup &light, float projX, float projY, float projZ,
+                    bool inFront, DirectX::XMFLOAT3 &outGobo);
+
+/**
+ * @brief Adds one light's in-scattering at eight points, the body of the shader's march loop.
+ *
+ * Adds color * attenuation * spot * shadow * gobo * phase * density * weight to outRgb in the
+ * lanes of active that are within the light's range and cone.
+ *
+ * @param inputs Textures and volumetric parameters.
+ * @param light Light from SetupLights().
+ * @param pos Sample positions (x, y, z).
+ * @param ray Normalized view direction at each sample (x, y, z).
+ * @param active Lanes to evaluate.
+ * @param weight Path length each sample stands for.
+ * @param outRgb Accumulated radiance (r, g, b), before the intensity parameter.
+ */
+void AccumulateInScatter(const Inputs &inputs, const LightSetup &light, const Simd::Float8 pos[3],
+                         const Simd::Float8 ray[3], Simd::Float8 active, Simd::Float8 weight, Simd::Float8 outRgb[3]);
+
+/**
+ * @brief Intersects a ray with a spotlight cone, as RayConeIntersect() in the shader.
+ *
+ * @param origin Ray origin.
+ * @param dir Normalized ray direction.
+ * @param apex Cone apex (light position).
+ * @param axis Normalized cone axis.
+ * @param cosAngle Cosine of the cone half-angle.
+ * @param maxRange Light range.
+ * @return Entry and exit distances, or (-1, -1) when the ray misses.
+ */
+DirectX::XMFLOAT2 RayConeIntersect(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                                   const DirectX::XMFLOAT3 &apex, const DirectX::XMFLOAT3 &axis, float cosAngle,
+                                   float maxRange);
+
+/**
+ * @brief Shades one pixel with the scalar transcription of the shader.
+ *
+ * @param inputs Camera, lights and textures.
+ * @param x Pixel column.
+ * @param y Pixel row.
+ * @return In-scattered radiance, already scaled by the intensity parameter.
+ */
+DirectX::XMFLOAT3 ShadePixel(const Inputs &inputs, int x, int y);
+
+/**
+ * @brief Renders the whole image with the parallel eight-ray path.
+ *
+ * @param inputs Camera, lights and textures.
+ * @param outRgb Receives width * height RGB triplets, row-major from the top.
+ * @return False if the size is invalid.
+ */
+bool Render(const Inputs &inputs, std::vector<float> &outRgb);
+
+/**
+ * @brief Decodes gobo images into a texture array the way Texture::CreateTextureArray() does.
+ *
+ * Pixels under 50% alpha become black and smaller images are centered in the largest size.
+ *
+ * @param filesData Encoded images (any format stb_image reads).
+ * @param outGobos Receives the RGBA slices.
+ * @return False if no image could be decoded.
+ */
+bool LoadGobos(const std::vector<std::vector<uint8_t>> &filesData, TextureArray &outGobos);
+
+/**
+ * @brief Writes an RGB float image as Radiance HDR.
+ *
+ * @param fileName Output path (.hdr).
+ * @param width Image width.
+ * @param height Image height.
+ * @param rgb width * height RGB triplets.
+ * @return True on success.
+ */
+bool WriteHdr(const std::string &fileName, int width, int height, const std::vector<float> &rgb);
+
+} // namespace VolumetricReference
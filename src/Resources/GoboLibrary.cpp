@@ -0,0 +1,174 @@
+#include "GoboLibrary.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "../Core/Config.h"
+#include "../Core/ThreadPool.h"
+#include "MeshCache.h"
+
+namespace
+{
+
+constexpr int CHANNELS = 4;
+constexpr int BLOCK_SIZE = 4;
+
+/// Format of an array holding slices of both formats: grey only while every slice is grey.
+TextureBaker::Format Combine(TextureBaker::Format arrayFormat, TextureBaker::Format sliceFormat)
+{
+    return sliceFormat == TextureBaker::Format::BC4 ? arrayFormat : sliceFormat;
+}
+
+/// Content key of a decoded image: its size and its pixels.
+uint64_t HashImage(const TextureBaker::Image &image)
+{
+    const uint64_t hashes[] = {static_cast<uint64_t>(image.width), static_cast<uint64_t>(image.height),
+                               MeshCache::HashBytes(image.rgba.data(), image.rgba.size())};
+    return MeshCache::HashBytes(reinterpret_cast<const uint8_t *>(hashes), sizeof(hashes));
+}
+
+} // namespace
+
+int GoboLibrary::AddFixture(const std::string &name, const std::vector<std::vector<uint8_t>> &filesData)
+{
+    const int existing = FindFixture(name);
+    if (existing >= 0)
+        return existing;
+
+    // Decode, hash and classify every image in parallel; the library itself is filled in slot order
+    struct Decoded
+    {
+        TextureBaker::Image image;
+        uint64_t hash = 0;
+        TextureBaker::Format format = TextureBaker::Format::RGBA8;
+        bool valid = false;
+    };
+    std::vector<Decoded> decoded(filesData.size());
+    ThreadPool::Shared().ParallelFor(filesData.size(), [&](size_t i) {
+        Decoded &entry = decoded[i];
+        entry.valid = TextureBaker::DecodeImage(filesData[i], entry.image);
+        if (!entry.valid)
+            return;
+        entry.hash = HashImage(entry.image);
+        entry.format = TextureBaker::ChooseFormat(entry.image);
+    });
+    if (std::none_of(decoded.begin(), decoded.end(), [](const Decoded &entry) { return entry.valid; }))
+        return -1;
+
+    Fixture fixture;
+    fixture.name = name;
+    fixture.slots.resize(decoded.size());
+    bool first = true;
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        const Decoded &entry = decoded[i];
+        if (!entry.valid)
+            continue;
+        fixture.slots[i] = Insert(entry.image, entry.hash, entry.format);
+
+        // The array this fixture type would have had on its own (see TextureBaker::DecodeSlices)
+        fixture.paddedWidth = (std::max)(fixture.paddedWidth, entry.image.width);
+        fixture.paddedHeight = (std::max)(fixture.paddedHeight, entry.image.height);
+        fixture.paddedFormat = first ? entry.format : Combine(fixture.paddedFormat, entry.format);
+        first = false;
+    }
+    fixture.paddedWidth = (fixture.paddedWidth + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    fixture.paddedHeight = (fixture.paddedHeight + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    m_fixtures.push_back(std::move(fixture));
+    return static_cast<int>(m_fixtures.size()) - 1;
+}
+
+int GoboLibrary::FindFixture(const std::string &name) const
+{
+    for (size_t i = 0; i < m_fixtures.size(); ++i)
+    {
+        if (m_fixtures[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int GoboLibrary::SizeClassFor(int width, int height)
+{
+    int size = Config::Gobo::MIN_SIZE_CLASS;
+    while (size < width || size < height)
+        size *= 2;
+    return size;
+}
+
+GoboLibrary::MemoryReport GoboLibrary::GetMemoryReport() const
+{
+    MemoryReport report;
+    report.fixtures = m_fixtures.size();
+    for (const SizeClass &sizeClass : m_classes)
+    {
+        const uint64_t bytes =
+            TextureBaker::BakedSize(sizeClass.format, sizeClass.size, sizeClass.size, sizeClass.image.layers);
+        report.classBytes.push_back(bytes);
+        report.libraryBytes += bytes;
+        report.uniqueSlices += static_cast<size_t>(sizeClass.image.layers);
+    }
+    for (const Fixture &fixture : m_fixtures)
+    {
+        report.slots += fixture.slots.size();
+
+        // Slots that failed to decode were dropped from the per-fixture arrays too
+        const auto layers = static_cast<int>(std::count_if(fixture.slots.begin(), fixture.slots.end(),
+                                                           [](const SlotRef &slot) { return slot.sizeClass >= 0; }));
+        report.perFixtureBytes +=
+            TextureBaker::BakedSize(fixture.paddedFormat, fixture.paddedWidth, fixture.paddedHeight, layers);
+    }
+    return report;
+}
+
+GoboLibrary::SlotRef GoboLibrary::Insert(const TextureBaker::Image &image, uint64_t hash, TextureBaker::Format format)
+{
+    const auto found = m_byHash.find(hash);
+    if (found != m_byHash.end() && SliceMatches(found->second, image))
+        return found->second;
+
+    // Append to the size class, creating it on first use
+    const int size = SizeClassFor(image.width, image.height);
+    auto sizeClass = std::find_if(m_classes.begin(), m_classes.end(),
+                                  [size](const SizeClass &candidate) { return candidate.size == size; });
+    if (sizeClass == m_classes.end())
+    {
+        SizeClass added;
+        added.size = size;
+        added.image.width = size;
+        added.image.height = size;
+        added.format = format;
+        m_classes.push_back(std::move(added));
+        sizeClass = m_classes.end() - 1;
+    }
+
+    SlotRef ref;
+    ref.sizeClass = static_cast<int>(sizeClass - m_classes.begin());
+    ref.layer = sizeClass->image.layers++;
+    sizeClass->image.rgba.resize(sizeClass->image.rgba.size() + (static_cast<size_t>(size) * size * CHANNELS), 0);
+    TextureBaker::CopyCentered(image, sizeClass->image, ref.layer);
+    sizeClass->format = Combine(sizeClass->format, format);
+    sizeClass->hashes.push_back(hash);
+    ++sizeClass->revision;
+
+    // A colliding hash keeps pointing at the first image; the newcomer is simply never shared
+    if (found == m_byHash.end())
+        m_byHash.emplace(hash, ref);
+    return ref;
+}
+
+bool GoboLibrary::SliceMatches(const SlotRef &ref, const TextureBaker::Image &image) const
+{
+    // Compare the whole slice, the black border included, against the image placed the same way
+    const SizeClass &sizeClass = m_classes[static_cast<size_t>(ref.sizeClass)];
+    if (SizeClassFor(image.width, image.height) != sizeClass.size)
+        return false;
+    TextureBaker::Image placed;
+    placed.width = sizeClass.size;
+    placed.height = sizeClass.size;
+    placed.layers = 1;
+    const size_t sliceBytes = static_cast<size_t>(sizeClass.size) * sizeClass.size * CHANNELS;
+    placed.rgba.assign(sliceBytes, 0);
+    TextureBaker::CopyCentered(image, placed, 0);
+    return std::memcmp(placed.rgba.data(), &sizeClass.image.rgba[static_cast<size_t>(ref.layer) * sliceBytes],
+                       sliceBytes) == 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file GoboLibrary.h
+ * @brief Gobo images shared by every fixture type, stored once each by content.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TextureBaker.h"
+
+/**
+ * @class GoboLibrary
+ * @brief Deduplicated gobo slices, bucketed by size class, with a slot remap per fixture type.
+ *
+ * Each fixture type used to get its own texture array, every slice padded to the largest image
+ * of its wheel, so stock gobos shared by several types were stored once per type and often at
+ * the size of the biggest one. The library keys each decoded image by a hash of its pixels and
+ * stores it once, in the size class it fits: the smallest power-of-two square of at least
+ * Config::Gobo::MIN_SIZE_CLASS texels, the image centered on black. Each class becomes one
+ * texture array. A fixture type only gets a remap table from its wheel slots to (class, layer).
+ *
+ * The library grows as fixture types load: new images are appended to their class, whose
+ * revision goes up so only the classes that changed are baked and uploaded again. Layers never
+ * move, so remap tables stay valid.
+ */
+class GoboLibrary
+{
+public:
+    /**
+     * @struct SlotRef
+     * @brief Where a wheel slot's image lives in the library.
+     */
+    struct SlotRef
+    {
+        int sizeClass = -1; ///< Index of the size class (see GetSizeClass()), -1 if the image did not decode.
+        int layer = 0;      ///< Slice in that class's array.
+    };
+
+    /**
+     * @struct SizeClass
+     * @brief The slices of one size, the contents of one texture array.
+     */
+    struct SizeClass
+    {
+        int size = 0;                                              ///< Width and height of the slices.
+        TextureBaker::Image image;                                 ///< All slices, sRGB RGBA8.
+        TextureBaker::Format format = TextureBaker::Format::RGBA8; ///< Bake format (BC4 while every slice is grey).
+        std::vector<uint64_t> hashes;                              ///< Content hash of each slice.
+        uint32_t revision = 0;                                     ///< Bumped whenever slices are added.
+    };
+
+    /**
+     * @struct MemoryReport
+     * @brief Baked texture memory of the library against one padded array per fixture type.
+     */
+    struct MemoryReport
+    {
+        size_t fixtures = 0;              ///< Fixture types added.
+        size_t slots = 0;                 ///< Wheel slots over all fixture types.
+        size_t uniqueSlices = 0;          ///< Slices stored in the library.
+        uint64_t libraryBytes = 0;        ///< Every level of every size class, in its format.
+        uint64_t perFixtureBytes = 0;     ///< Per-fixture arrays padded to their largest image, for comparison.
+        std::vector<uint64_t> classBytes; ///< libraryBytes split by size class.
+    };
+
+    /**
+     * @brief Adds a fixture type's gobo images, in slot order.
+     *
+     * Images are decoded in parallel. An image already in the library (same size and pixels)
+     * is shared; a new one is appended to its size class. Adding a name that is already in the
+     * library returns the existing fixture without decoding anything.
+     *
+     * @param name Fixture type name (e.g. the GDTF path).
+     * @param filesData Raw image files, one per slot.
+     * @return Index of the fixture type, or -1 if no image decoded.
+     */
+    int AddFixture(const std::string &name, const std::vector<std::vector<uint8_t>> &filesData);
+
+    /**
+     * @brief Finds a fixture type by name.
+     * @return Index of the fixture type, or -1.
+     */
+    [[nodiscard]] int FindFixture(const std::string &name) const;
+
+    /**
+     * @brief Gets the slot remap table of a fixture type.
+     * @param fixture Index from AddFixture().
+     * @return One entry per slot, in the order the images were given.
+     */
+    [[nodiscard]] const std::vector<SlotRef> &GetSlots(int fixture) const
+    {
+        return m_fixtures[static_cast<size_t>(fixture)].slots;
+    }
+
+    /**
+     * @brief Gets the number of size classes.
+     */
+    [[nodiscard]] int GetSizeClassCount() const
+    {
+        return static_cast<int>(m_classes.size());
+    }
+
+    /**
+     * @brief Gets a size class; classes are never removed or reordered.
+     */
+    [[nodiscard]] const SizeClass &GetSizeClass(int sizeClass) const
+    {
+        return m_classes[static_cast<size_t>(sizeClass)];
+    }
+
+    /**
+     * @brief Size class an image of this size goes to.
+     * @return Power of two side length, at least Config::Gobo::MIN_SIZE_CLASS.
+     */
+    static int SizeClassFor(int width, int height);
+
+    /**
+     * @brief Totals the baked memory of the library and of the per-fixture arrays it replaces.
+     */
+    [[nodiscard]] MemoryReport GetMemoryReport() const;
+
+private:
+    /**
+     * @struct Fixture
+     * @brief A fixture type's slots, plus what its own padded array would have been.
+     */
+    struct Fixture
+    {
+        std::string name;
+        std::vector<SlotRef> slots;
+        int paddedWidth = 0;
+        int paddedHeight = 0;
+        TextureBaker::Format paddedFormat = TextureBaker::Format::RGBA8;
+    };
+
+    /**
+     * @brief Finds an image in the library or appends it to its size class.
+     */
+    SlotRef Insert(const TextureBaker::Image &image, uint64_t hash, TextureBaker::Format format);
+
+    /**
+     * @brief Checks that a slice holds exactly an image, centered, so hash collisions never share.
+     */
+    [[nodiscard]] bool SliceMatches(const SlotRef &ref, const TextureBaker::Image &image) const;
+
+    std::vector<SizeClass> m_classes;
+    std::vector<Fixture> m_fixtures;
+    std::unordered_map<uint64_t, SlotRef> m_byHash;
+};
@@ -0,0 +1,272 @@
+#include "GoboStreamer.h"
+#include <algorithm>
+#include <chrono>
+#include "../Core/ThreadPool.h"
+#include "MeshCache.h"
+
+namespace
+{
+
+constexpr int CHANNELS = 4;
+
+} // namespace
+
+GoboStreamer::GoboStreamer(int capacity, int layerSize, TextureBaker::Format format, int maxDecodes)
+    : m_layerSize(layerSize), m_format(format), m_maxDecodes((std::max)(maxDecodes, 1)),
+      m_layers(static_cast<size_t>((std::max)(capacity, 2)))
+{
+}
+
+GoboStreamer::~GoboStreamer()
+{
+    WaitIdle();
+}
+
+GoboStreamer::Key GoboStreamer::AddMedia(std::vector<uint8_t> fileData)
+{
+    const Key key = MeshCache::HashBytes(fileData.data(), fileData.size());
+    Media &media = m_media[key];
+    if (!media.file)
+        media.file = std::make_shared<const std::vector<uint8_t>>(std::move(fileData));
+    return key;
+}
+
+bool GoboStreamer::SetPlaceholder(Key key, Upload &outUpload)
+{
+    const auto found = m_media.find(key);
+    if (found == m_media.end() || !DecodeSlice(*found->second.file, m_layerSize, m_format, outUpload.baked))
+        return false;
+
+    // The slot leaves the layer it streamed into, and an earlier placeholder goes back to streaming
+    Media &media = found->second;
+    if (media.state == State::Resident)
+        m_layers[static_cast<size_t>(media.layer)].used = false;
+    Layer &layer = m_layers[PLACEHOLDER_LAYER];
+    if (layer.used && layer.key != key)
+    {
+        Media &previous = m_media[layer.key];
+        previous.state = State::Idle;
+        previous.layer = -1;
+    }
+
+    media.state = State::Resident;
+    media.layer = PLACEHOLDER_LAYER;
+    media.prefetched = false;
+    layer.key = key;
+    layer.used = true;
+    layer.lastUse = layer.lastRequest = m_frame;
+    outUpload.key = key;
+    outUpload.layer = PLACEHOLDER_LAYER;
+    return true;
+}
+
+int GoboStreamer::Request(Key key)
+{
+    ++m_stats.requests;
+    const auto found = m_media.find(key);
+    if (found == m_media.end())
+    {
+        ++m_stats.misses;
+        return PLACEHOLDER_LAYER;
+    }
+
+    Media &media = found->second;
+    if (media.state == State::Resident)
+    {
+        ++m_stats.hits;
+        if (media.prefetched)
+            ++m_stats.prefetchHits;
+        media.prefetched = false;
+        Layer &layer = m_layers[static_cast<size_t>(media.layer)];
+        layer.lastUse = layer.lastRequest = m_frame;
+        return media.layer;
+    }
+
+    // Queue it ahead of the prefetches; a prefetched slot still waiting is queued again in front
+    ++m_stats.misses;
+    if (media.state == State::Idle || (media.state == State::Queued && media.prefetched))
+        m_requested.push_back(key);
+    if (media.state == State::Idle)
+        media.state = State::Queued;
+    media.prefetched = false;
+    return PLACEHOLDER_LAYER;
+}
+
+void GoboStreamer::Prefetch(Key key)
+{
+    const auto found = m_media.find(key);
+    if (found == m_media.end())
+        return;
+
+    Media &media = found->second;
+    if (media.state == State::Resident)
+    {
+        m_layers[static_cast<size_t>(media.layer)].lastUse = m_frame;
+    }
+    else if (media.state == State::Idle)
+    {
+        ++m_stats.prefetches;
+        media.state = State::Queued;
+        media.prefetched = true;
+        m_prefetched.push_back(key);
+    }
+}
+
+void GoboStreamer::Update(std::vector<Upload> &outUploads, int maxUploads)
+{
+    // Collect the decodes that finished
+    for (auto decode = m_decoding.begin(); decode != m_decoding.end();)
+    {
+        if (decode->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++decode;
+            continue;
+        }
+        std::unique_ptr<TextureBaker::BakedTexture> baked = decode->result.get();
+        Media &media = m_media[decode->key];
+        if (baked)
+        {
+            ++m_stats.decodes;
+            media.state = State::Ready;
+            m_ready.emplace_back(decode->key, std::move(baked));
+        }
+        else
+        {
+            ++m_stats.failedDecodes;
+            media.state = State::Failed;
+        }
+        decode = m_decoding.erase(decode);
+    }
+
+    // Place requested slots first, then prefetched ones, each in the order they finished
+    std::stable_partition(m_ready.begin(), m_ready.end(),
+                          [this](const auto &ready) { return !m_media[ready.first].prefetched; });
+    size_t placed = 0;
+    while (placed < m_ready.size() && static_cast<int>(placed) < maxUploads)
+    {
+        auto &[key, baked] = m_ready[placed];
+        Media &media = m_media[key];
+        const int layer = AllocateLayer(!media.prefetched);
+        if (layer < 0)
+            break;
+
+        media.state = State::Resident;
+        media.layer = layer;
+        Layer &slot = m_layers[static_cast<size_t>(layer)];
+        slot.key = key;
+        slot.used = true;
+        slot.lastUse = m_frame;
+        slot.lastRequest = media.prefetched ? 0 : m_frame;
+        outUploads.push_back({key, layer, std::move(*baked)});
+        ++m_stats.uploads;
+        ++placed;
+    }
+    m_ready.erase(m_ready.begin(), m_ready.begin() + static_cast<std::ptrdiff_t>(placed));
+
+    // Start decodes; the job only holds the file, so it never outlives anything it points to
+    while (static_cast<int>(m_decoding.size()) < m_maxDecodes && !(m_requested.empty() && m_prefetched.empty()))
+    {
+        std::deque<Key> &queue = m_requested.empty() ? m_prefetched : m_requested;
+        const Key key = queue.front();
+        queue.pop_front();
+        Media &media = m_media[key];
+        if (media.state != State::Queued)
+            continue; // Queued twice, or evicted and queued again since
+
+        media.state = State::Decoding;
+        const std::shared_ptr<const std::vector<uint8_t>> file = media.file;
+        const int layerSize = m_layerSize;
+        const TextureBaker::Format format = m_format;
+        m_decoding.push_back({key, ThreadPool::Shared().Submit([file, layerSize, format]() {
+                                  auto baked = std::make_unique<TextureBaker::BakedTexture>();
+                                  if (!DecodeSlice(*file, layerSize, format, *baked))
+                                      baked.reset();
+                                  return baked;
+                              })});
+    }
+    ++m_frame;
+}
+
+void GoboStreamer::RejectUpload(Key key)
+{
+    const auto found = m_media.find(key);
+    if (found == m_media.end() || found->second.state != State::Resident)
+        return;
+
+    // The layer's contents are undefined, so nothing may point at it; the slice would not fit again
+    Media &media = found->second;
+    m_layers[static_cast<size_t>(media.layer)].used = false;
+    media.state = State::Failed;
+    media.layer = -1;
+    media.prefetched = false;
+    ++m_stats.rejectedUploads;
+}
+
+void GoboStreamer::WaitIdle()
+{
+    for (const Decode &decode : m_decoding)
+        decode.result.wait();
+}
+
+int GoboStreamer::GetLayer(Key key) const
+{
+    const auto found = m_media.find(key);
+    return found != m_media.end() && found->second.state == State::Resident ? found->second.layer : -1;
+}
+
+int GoboStreamer::GetResidentCount() const
+{
+    return static_cast<int>(std::count_if(m_layers.begin(), m_layers.end(), [](const Layer &l) { return l.used; }));
+}
+
+int GoboStreamer::GetPendingCount() const
+{
+    return static_cast<int>(std::count_if(m_media.begin(), m_media.end(), [](const auto &entry) {
+        const State state = entry.second.state;
+        return state == State::Queued || state == State::Decoding || state == State::Ready;
+    }));
+}
+
+bool GoboStreamer::DecodeSlice(const std::vector<uint8_t> &fileData, int layerSize, TextureBaker::Format format,
+                               TextureBaker::BakedTexture &outBaked)
+{
+    TextureBaker::Image image;
+    if (!TextureBaker::DecodeImage(fileData, image))
+        return false;
+    TextureBaker::ShrinkToFit(image, layerSize);
+
+    TextureBaker::Image slice;
+    slice.width = layerSize;
+    slice.height = layerSize;
+    slice.layers = 1;
+    slice.rgba.assign(static_cast<size_t>(layerSize) * layerSize * CHANNELS, 0);
+    TextureBaker::CopyCentered(image, slice, 0);
+    return TextureBaker::Bake(slice, format, outBaked);
+}
+
+int GoboStreamer::AllocateLayer(bool forRequest)
+{
+    int victim = -1;
+    for (int i = PLACEHOLDER_LAYER + 1; i < static_cast<int>(m_layers.size()); ++i)
+    {
+        const Layer &layer = m_layers[static_cast<size_t>(i)];
+        if (!layer.used)
+            return i;
+        if (layer.lastRequest == m_frame || (!forRequest && layer.lastUse == m_frame))
+            continue;
+        if (victim < 0 || layer.lastUse < m_layers[static_cast<size_t>(victim)].lastUse)
+            victim = i;
+    }
+    if (victim < 0)
+        return -1;
+
+    // The evicted slot goes back to Idle, to be decoded again if it is selected later
+    Layer &layer = m_layers[static_cast<size_t>(victim)];
+    Media &evicted = m_media[layer.key];
+    evicted.state = State::Idle;
+    evicted.layer = -1;
+    evicted.prefetched = false;
+    layer.used = false;
+    ++m_stats.evictions;
+    return victim;
+}
@@ -0,0 +1,278 @@
+/**
+ * @file GoboStreamer.h
+ * @brief On-demand residency of wheel slot images in a fixed pool of texture array layers.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "TextureBaker.h"
+
+/**
+ * @class GoboStreamer
+ * @brief LRU cache of decoded wheel slots, filled by an asynchronous decode queue.
+ *
+ * Loading every gobo, animation wheel position and prism image at startup costs decode time and
+ * memory for slots that may never be selected. The streamer only keeps the raw image files,
+ * keyed by a hash of their bytes so a file shared by several fixture types is one entry. A slot
+ * is decoded when a light selects it (Request()) or is expected to soon (Prefetch()), on the
+ * shared ThreadPool: decoded, halved until it fits the layer size, centered and baked into a
+ * full mip chain of the pool format. Finished slices take a free layer of the pool, or the least
+ * recently used one, and come out of Update() for the caller to copy into the texture array.
+ *
+ * Layer 0 holds the placeholder (SetPlaceholder()), which Request() returns until a slot is
+ * resident. A layer requested since the last Update() is never evicted, so a pool smaller than
+ * the number of slots on stage stalls new slots instead of thrashing.
+ *
+ * The streamer never touches the GPU, so the policy and the queue run the same in tests.
+ */
+class GoboStreamer
+{
+public:
+    /// Content key of an image file (see AddMedia()).
+    using Key = uint64_t;
+
+    /// Layer of the placeholder, returned for slots that are not resident.
+    static constexpr int PLACEHOLDER_LAYER = 0;
+
+    /**
+     * @struct Stats
+     * @brief Counters since construction or ResetStats().
+     */
+    struct Stats
+    {
+        uint64_t requests = 0;        ///< Request() calls.
+        uint64_t hits = 0;            ///< Requests for a resident slot.
+        uint64_t misses = 0;          ///< Requests answered with the placeholder.
+        uint64_t prefetches = 0;      ///< Prefetch() calls that queued a decode.
+        uint64_t prefetchHits = 0;    ///< First requests for a slot a prefetch made resident.
+        uint64_t decodes = 0;         ///< Slots decoded and baked.
+        uint64_t failedDecodes = 0;   ///< Files that did not decode; their slots stay on the placeholder.
+        uint64_t evictions = 0;       ///< Resident slots whose layer was taken by another one.
+        uint64_t uploads = 0;         ///< Slices handed out by Update().
+        uint64_t rejectedUploads = 0; ///< Slices the pool did not take; their slots stay on the placeholder.
+
+        /**
+         * @brief Fraction of requests that found their slot resident.
+         */
+        [[nodiscard]] double HitRate() const
+        {
+            return requests > 0 ? static_cast<double>(hits) / static_cast<double>(requests) : 0.0;
+        }
+    };
+
+    /**
+     * @struct Upload
+     * @brief A decoded slice to copy into a pool layer.
+     */
+    struct Upload
+    {
+        Key key = 0;
+        int layer = 0;
+        TextureBaker::BakedTexture baked; ///< One slice, every level, in the pool format.
+    };
+
+    /**
+     * @brief Creates an empty pool.
+     *
+     * @param capacity Layers in the pool, the placeholder included (at least 2).
+     * @param layerSize Width and height of a layer (a multiple of 4).
+     * @param format Storage format of the layers.
+     * @param maxDecodes Slots decoded at once.
+     */
+    GoboStreamer(int capacity, int layerSize, TextureBaker::Format format, int maxDecodes);
+
+    /**
+     * @brief Waits for the decodes in flight.
+     */
+    ~GoboStreamer();
+
+    GoboStreamer(const GoboStreamer &) = delete;
+    GoboStreamer &operator=(const GoboStreamer &) = delete;
+
+    /**
+     * @brief Registers an image file; nothing is decoded yet.
+     *
+     * @param fileData Raw image file.
+     * @return Its key; the same bytes always give the same key.
+     */
+    Key AddMedia(std::vector<uint8_t> fileData);
+
+    /**
+     * @brief Decodes a registered image now into the placeholder layer, which it keeps.
+     *
+     * @param key Key from AddMedia().
+     * @param outUpload Receives the slice to copy into layer 0.
+     * @return False if the key is unknown or the file does not decode.
+     */
+    bool SetPlaceholder(Key key, Upload &outUpload);
+
+    /**
+     * @brief Gets the layer of a slot a light shows this frame, queueing its decode on a miss.
+     *
+     * @param key Key from AddMedia().
+     * @return The slot's layer, or PLACEHOLDER_LAYER until it is resident.
+     */
+    int Request(Key key);
+
+    /**
+     * @brief Queues a slot expected to be requested soon, behind the requested ones. A resident
+     * slot moves to the most recently used end instead.
+     *
+     * @param key Key from AddMedia().
+     */
+    void Prefetch(Key key);
+
+    /**
+     * @brief Runs the queue once per frame: collects finished decodes, places them in layers and
+     * starts the next decodes.
+     *
+     * @param outUploads Receives the slices placed this frame, to copy into their layers.
+     * @param maxUploads Most slices to place; the rest wait for the next frames.
+     */
+    void Update(std::vector<Upload> &outUploads, int maxUploads);
+
+    /**
+     * @brief Takes back a slice Update() handed out whose copy into the pool failed: its layer is
+     * freed and the slot stays on the placeholder, like a file that does not decode.
+     *
+     * @param key Key of the rejected Upload.
+     */
+    void RejectUpload(Key key);
+
+    /**
+     * @brief Blocks until every decode in flight has finished; the next Update() collects them.
+     */
+    void WaitIdle();
+
+    /**
+     * @brief Gets the layer of a resident slot, without counting a request.
+     * @return The layer, or -1 if the slot is not resident.
+     */
+    [[nodiscard]] int GetLayer(Key key) const;
+
+    /**
+     * @brief Gets the number of layers holding a slot, the placeholder included.
+     */
+    [[nodiscard]] int GetResidentCount() const;
+
+    /**
+     * @brief Gets the number of slots queued, decoding or waiting for a layer.
+     */
+    [[nodiscard]] int GetPendingCount() const;
+
+    /**
+     * @brief Gets the number of layers in the pool.
+     */
+    [[nodiscard]] int GetCapacity() const
+    {
+        return static_cast<int>(m_layers.size());
+    }
+
+    /**
+     * @brief Gets the width and height of a layer.
+     */
+    [[nodiscard]] int GetLayerSize() const
+    {
+        return m_layerSize;
+    }
+
+    /**
+     * @brief Gets the storage format of the layers.
+     */
+    [[nodiscard]] TextureBaker::Format GetFormat() const
+    {
+        return m_format;
+    }
+
+    /**
+     * @brief Gets the hit, miss and eviction counters.
+     */
+    [[nodiscard]] const Stats &GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief Zeroes the counters.
+     */
+    void ResetStats()
+    {
+        m_stats = {};
+    }
+
+    /**
+     * @brief Decodes an image file into one pool slice: halved until it fits, centered on black
+     * and baked with every level.
+     *
+     * @param fileData Raw image file.
+     * @param layerSize Width and height of the slice.
+     * @param format Storage format.
+     * @param outBaked Receives the slice.
+     * @return False if the file does not decode.
+     */
+    static bool DecodeSlice(const std::vector<uint8_t> &fileData, int layerSize, TextureBaker::Format format,
+                            TextureBaker::BakedTexture &outBaked);
+
+private:
+    /**
+     * @brief Where a slot is on its way to residency.
+     */
+    enum class State
+    {
+        Idle,     ///< Not resident, nothing queued.
+        Queued,   ///< Waiting for a decode to start.
+        Decoding, ///< On the ThreadPool.
+        Ready,    ///< Decoded, waiting for a layer.
+        Resident, ///< In a layer.
+        Failed    ///< Did not decode.
+    };
+
+    struct Media
+    {
+        std::shared_ptr<const std::vector<uint8_t>> file;
+        State state = State::Idle;
+        int layer = -1;
+        bool prefetched = false; ///< Made resident by a prefetch, not requested since.
+    };
+
+    struct Layer
+    {
+        Key key = 0;
+        bool used = false;
+        uint64_t lastUse = 0;     ///< Frame of the last request or prefetch, the LRU order.
+        uint64_t lastRequest = 0; ///< Frame of the last request; requested this frame pins the layer.
+    };
+
+    struct Decode
+    {
+        Key key = 0;
+        std::future<std::unique_ptr<TextureBaker::BakedTexture>> result;
+    };
+
+    /**
+     * @brief Finds a free layer, or evicts the least recently used one not requested this frame.
+     * @param forRequest A prefetched slot also leaves alone the layers prefetched this frame.
+     * @return The layer, or -1 if every layer is pinned.
+     */
+    int AllocateLayer(bool forRequest);
+
+    int m_layerSize;
+    TextureBaker::Format m_format;
+    int m_maxDecodes;
+
+    std::unordered_map<Key, Media> m_media;
+    std::vector<Layer> m_layers;
+    std::deque<Key> m_requested;  ///< Decodes to start first.
+    std::deque<Key> m_prefetched; ///< Decodes to start when no request waits.
+    std::vector<Decode> m_decoding;
+    std::vector<std::pair<Key, std::unique_ptr<TextureBaker::BakedTexture>>> m_ready;
+    uint64_t m_frame = 1;
+    Stats m_stats;
+};
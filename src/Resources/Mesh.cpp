@@ -1,163 +1,207 @@
-#define TINYOBJLOADER_IMPLEMENTATION
 #include "Mesh.h"
-#include "tiny_obj_loader.h"
+#include <algorithm>
+#include "../Core/Config.h"
 
 Mesh::Mesh() = default;
 
 bool Mesh::LoadFromOBJ(ID3D11Device *device, const std::string &fileName)
 {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    [[maybe_unused]] std::string warn;
-    [[maybe_unused]] std::string err;
-
-    // Extract directory path for MTL file loading
-    std::string mtlBaseDir;
-    size_t lastSlash = fileName.find_last_of("/\\\\");
-    if (lastSlash != std::string::npos)
-    {
-        mtlBaseDir = fileName.substr(0, lastSlash + 1);
-    }
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, fileName.c_str(), mtlBaseDir.c_str()))
-    {
-        return false;
-    }
-
-    // Build material data from MTL
-    std::vector<MaterialData> materialDataList;
-    for (const auto &mat : materials)
-    {
-        MaterialData md;
-        md.diffuse = {mat.diffuse[0], mat.diffuse[1], mat.diffuse[2]};
-        md.specular = {mat.specular[0], mat.specular[1], mat.specular[2]};
-        md.shininess = mat.shininess > 0.0f ? mat.shininess : 32.0f;
-        materialDataList.push_back(md);
-    }
-
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
+    MeshAsset asset;
+    return asset.LoadOBJ(fileName) && Create(device, asset);
+}
 
-    float globalMinY = FLT_MAX;
-    uint32_t currentIndex = 0;
+bool Mesh::Create(ID3D11Device *device, const MeshData &data)
+{
+    MeshAsset asset;
+    asset.Build(data);
+    return Create(device, asset);
+}
 
-    for (const auto &shape : shapes)
-    {
-        ShapeInfo info;
-        info.name = shape.name;
-        info.startIndex = currentIndex;
+bool Mesh::Create(ID3D11Device *device, const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+{
+    MeshData data;
+    data.vertices = vertices;
+    data.indices = indices;
+    data.shapes = m_shapes;
+    data.minY = m_minY;
+    return Create(device, data);
+}
 
-        float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
-        float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+bool Mesh::Create(ID3D11Device *device, const MeshAsset &asset)
+{
+    const PackedMeshView &view = asset.GetView();
+    m_shapes = asset.GetShapes();
+    m_minY = asset.GetMinY();
 
-        for (const auto &index : shape.mesh.indices)
-        {
-            Vertex vertex = {};
+    // Create vertex buffer, from the compact vertices when the asset has them
+    const std::vector<VertexQuantizer::QuantizedVertex> &quantized = asset.GetQuantizedVertices();
+    m_vertexStride = quantized.empty() ? sizeof(Vertex) : Config::Vertex::STRIDE_QUANTIZED;
 
-            float vx = attrib.vertices[(3 * index.vertex_index) + 0];
-            float vy = attrib.vertices[(3 * index.vertex_index) + 1];
-            float vz = attrib.vertices[(3 * index.vertex_index) + 2];
+    D3D11_BUFFER_DESC vbd = {};
+    vbd.Usage = D3D11_USAGE_DEFAULT;
+    vbd.ByteWidth = m_vertexStride * (UINT)view.vertexCount;
+    vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
-            minX = (std::min)(minX, vx);
-            minY = (std::min)(minY, vy);
-            minZ = (std::min)(minZ, vz);
-            maxX = (std::max)(maxX, vx);
-            maxY = (std::max)(maxY, vy);
-            maxZ = (std::max)(maxZ, vz);
+    D3D11_SUBRESOURCE_DATA vinitData = {};
+    vinitData.pSysMem = quantized.empty() ? static_cast<const void *>(view.vertices) : quantized.data();
 
-            globalMinY = (std::min)(globalMinY, vy);
+    HRESULT hr = device->CreateBuffer(&vbd, &vinitData, &m_vertexBuffer);
+    if (FAILED(hr))
+        return false;
 
-            vertex.position = {vx, vy, vz};
+    // Position-only stream for depth-only passes, quantized against the mesh bounds
+    m_positionBounds = asset.GetPositionBounds();
+    const std::vector<VertexQuantizer::QuantizedPosition> &positions = asset.GetPositions();
 
-            if (index.normal_index >= 0)
-            {
-                vertex.normal = {attrib.normals[(3 * index.normal_index) + 0],
-                                 attrib.normals[(3 * index.normal_index) + 1],
-                                 attrib.normals[(3 * index.normal_index) + 2]};
-            }
+    D3D11_BUFFER_DESC pbd = vbd;
+    pbd.ByteWidth = Config::Vertex::STRIDE_QUANTIZED_POSITION * (UINT)positions.size();
+    D3D11_SUBRESOURCE_DATA pinitData = {};
+    pinitData.pSysMem = positions.data();
 
-            if (index.texcoord_index >= 0)
-            {
-                vertex.uv = {attrib.texcoords[(2 * index.texcoord_index) + 0],
-                             1.0f - attrib.texcoords[(2 * index.texcoord_index) + 1]};
-            }
+    hr = device->CreateBuffer(&pbd, &pinitData, &m_positionBuffer);
+    if (FAILED(hr))
+        return false;
 
-            vertices.push_back(vertex);
-            indices.push_back((uint32_t)indices.size());
-        }
+    const size_t levelCount = (std::max)(view.levelCount, size_t(1));
+    const size_t rangesPerLevel = view.rangeCount / levelCount;
 
-        info.indexCount = (uint32_t)shape.mesh.indices.size();
-        currentIndex += info.indexCount;
+    m_indexCount = 0;
+    m_shapeRanges.clear();
+    for (size_t i = 0; i < rangesPerLevel * levelCount; ++i)
+    {
+        const IndexRange &packed = view.ranges[i];
+        DrawRange range;
+        range.format = packed.indexSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        range.byteOffset = packed.byteOffset;
+        range.startIndex = packed.startIndex;
+        range.indexCount = packed.indexCount;
+        range.baseVertex = packed.baseVertex;
+        m_shapeRanges.push_back(range);
+        m_indexCount += i < rangesPerLevel ? packed.indexCount : 0;
+    }
 
-        // Get material from first face (shapes typically use one material)
-        if (!shape.mesh.material_ids.empty() && shape.mesh.material_ids[0] >= 0)
+    // Merge ranges that continue each other so whole-mesh draws stay a handful of calls
+    m_drawBatches.assign(levelCount, {});
+    for (size_t i = 0; i < m_shapeRanges.size(); ++i)
+    {
+        const DrawRange &range = m_shapeRanges[i];
+        std::vector<DrawRange> &batches = m_drawBatches[i / rangesPerLevel];
+        if (range.indexCount == 0)
+            continue;
+        if (!batches.empty())
         {
-            auto matId = static_cast<size_t>(shape.mesh.material_ids[0]);
-            if (matId < materialDataList.size())
+            DrawRange &last = batches.back();
+            if (last.format == range.format && last.byteOffset == range.byteOffset &&
+                last.baseVertex == range.baseVertex && last.startIndex + last.indexCount == range.startIndex)
             {
-                info.material = materialDataList[matId];
+                last.indexCount += range.indexCount;
+                continue;
             }
         }
-
-        info.center = {(minX + maxX) * 0.5f, (minY + maxY) * 0.5f, (minZ + maxZ) * 0.5f};
-        m_shapes.push_back(info);
+        batches.push_back(range);
     }
 
-    m_minY = globalMinY;
-    return Create(device, vertices, indices);
-}
-
-bool Mesh::Create(ID3D11Device *device, const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
-{
-    m_indexCount = (UINT)indices.size();
-
-    // Create vertex buffer
-    D3D11_BUFFER_DESC vbd = {};
-    vbd.Usage = D3D11_USAGE_DEFAULT;
-    vbd.ByteWidth = sizeof(Vertex) * (UINT)vertices.size();
-    vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-    D3D11_SUBRESOURCE_DATA vinitData = {};
-    vinitData.pSysMem = vertices.data();
-
-    HRESULT hr = device->CreateBuffer(&vbd, &vinitData, &m_vertexBuffer);
-    if (FAILED(hr))
-        return false;
+    m_clusters = asset.GetClusters();
+    m_occluderTriangles = asset.GetOccluderTriangles();
 
     // Create index buffer
     D3D11_BUFFER_DESC ibd = {};
     ibd.Usage = D3D11_USAGE_DEFAULT;
-    ibd.ByteWidth = sizeof(uint32_t) * m_indexCount;
+    ibd.ByteWidth = (UINT)view.indexByteCount;
     ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
     D3D11_SUBRESOURCE_DATA iinitData = {};
-    iinitData.pSysMem = indices.data();
+    iinitData.pSysMem = view.indexBytes;
 
     hr = device->CreateBuffer(&ibd, &iinitData, &m_indexBuffer);
     return SUCCEEDED(hr);
 }
 
-void Mesh::Draw(ID3D11DeviceContext *context)
+void Mesh::Draw(ID3D11DeviceContext *context, size_t lod)
+{
+    DrawBatches(context, m_vertexBuffer.Get(), m_vertexStride, lod);
+}
+
+void Mesh::DrawPositions(ID3D11DeviceContext *context, size_t lod)
+{
+    DrawBatches(context, m_positionBuffer.Get(), Config::Vertex::STRIDE_QUANTIZED_POSITION, lod);
+}
+
+void Mesh::DrawBatches(ID3D11DeviceContext *context, ID3D11Buffer *vertexBuffer, UINT stride, size_t lod)
+{
+    if (m_drawBatches.empty())
+        return;
+    lod = (std::min)(lod, m_drawBatches.size() - 1);
+
+    UINT offset = 0;
+    context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    DXGI_FORMAT boundFormat = DXGI_FORMAT_UNKNOWN;
+    UINT boundOffset = 0;
+    for (const auto &batch : m_drawBatches[lod])
+    {
+        if (batch.format != boundFormat || batch.byteOffset != boundOffset)
+        {
+            context->IASetIndexBuffer(m_indexBuffer.Get(), batch.format, batch.byteOffset);
+            boundFormat = batch.format;
+            boundOffset = batch.byteOffset;
+        }
+        context->DrawIndexed(batch.indexCount, batch.startIndex, batch.baseVertex);
+    }
+}
+
+void Mesh::DrawShape(ID3D11DeviceContext *context, size_t shapeIndex, size_t lod)
 {
-    UINT stride = sizeof(Vertex);
+    if (m_drawBatches.empty())
+        return;
+    const size_t rangesPerLevel = m_shapeRanges.size() / m_drawBatches.size();
+    if (shapeIndex >= rangesPerLevel)
+        return;
+    lod = (std::min)(lod, m_drawBatches.size() - 1);
+    const auto &range = m_shapeRanges[(lod * rangesPerLevel) + shapeIndex];
+
     UINT offset = 0;
-    context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-    context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+    context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &m_vertexStride, &offset);
+    context->IASetIndexBuffer(m_indexBuffer.Get(), range.format, range.byteOffset);
     context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    context->DrawIndexed(m_indexCount, 0, 0);
+    context->DrawIndexed(range.indexCount, range.startIndex, range.baseVertex);
 }
 
-void Mesh::DrawShape(ID3D11DeviceContext *context, size_t shapeIndex)
+void Mesh::DrawClusterRanges(ID3D11DeviceContext *context, const ClusterRange *ranges, size_t count)
 {
-    if (shapeIndex >= m_shapes.size())
+    DrawRanges(context, m_vertexBuffer.Get(), m_vertexStride, ranges, count);
+}
+
+void Mesh::DrawClusterRangePositions(ID3D11DeviceContext *context, const ClusterRange *ranges, size_t count)
+{
+    DrawRanges(context, m_positionBuffer.Get(), Config::Vertex::STRIDE_QUANTIZED_POSITION, ranges, count);
+}
+
+void Mesh::DrawRanges(ID3D11DeviceContext *context, ID3D11Buffer *vertexBuffer, UINT stride,
+                      const ClusterRange *ranges, size_t count)
+{
+    if (m_drawBatches.empty() || count == 0)
         return;
-    const auto &shape = m_shapes[shapeIndex];
+    const size_t rangesPerLevel = m_shapeRanges.size() / m_drawBatches.size();
 
-    UINT stride = sizeof(Vertex);
     UINT offset = 0;
-    context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-    context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+    context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
     context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    context->DrawIndexed(shape.indexCount, shape.startIndex, 0);
-}
\ No newline at end of file
+
+    DXGI_FORMAT boundFormat = DXGI_FORMAT_UNKNOWN;
+    UINT boundOffset = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (ranges[i].shape >= rangesPerLevel)
+            continue;
+        const DrawRange &shape = m_shapeRanges[ranges[i].shape];
+        if (shape.format != boundFormat || shape.byteOffset != boundOffset)
+        {
+            context->IASetIndexBuffer(m_indexBuffer.Get(), shape.format, shape.byteOffset);
+            boundFormat = shape.format;
+            boundOffset = shape.byteOffset;
+        }
+        context->DrawIndexed(ranges[i].indexCount, shape.startIndex + ranges[i].startIndex, shape.baseVertex);
+    }
+}
@@ -1,54 +1,33 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <cmath>
 #include <d3d11.h>
 #include <string>
 #include <vector>
 #include <wrl/client.h>
+#include "../Core/Config.h"
+#include "../Geometry/VertexQuantizer.h"
+#include "MeshAsset.h"
+#include "MeshData.h"
 
 using Microsoft::WRL::ComPtr;
 
-/**
- * @struct Vertex
- * @brief Represents a single vertex in a 3D mesh.
- */
-struct Vertex
-{
-    DirectX::XMFLOAT3 position; ///< 3D position of the vertex.
-    DirectX::XMFLOAT3 normal;   ///< Normal vector for lighting calculations.
-    DirectX::XMFLOAT2 uv;       ///< Texture coordinates.
-};
-
-/**
- * @struct MaterialData
- * @brief Material properties loaded from MTL files.
- */
-struct MaterialData
-{
-    DirectX::XMFLOAT3 diffuse = {1.0f, 1.0f, 1.0f};  ///< Diffuse color (Kd).
-    DirectX::XMFLOAT3 specular = {0.5f, 0.5f, 0.5f}; ///< Specular color (Ks).
-    float shininess = 32.0f;                         ///< Shininess exponent (Ns).
-};
-
-/**
- * @struct ShapeInfo
- * @brief Metadata about a specific shape or object within a mesh file.
- */
-struct ShapeInfo
-{
-    std::string name;         ///< Name of the shape.
-    DirectX::XMFLOAT3 center; ///< Computed center point of the shape.
-    MaterialData material;    ///< Material properties for this shape.
-    uint32_t startIndex = 0;  ///< Starting index in the index buffer.
-    uint32_t indexCount = 0;  ///< Number of indices for this shape.
-};
-
 /**
  * @class Mesh
  * @brief Represents a 3D geometry loaded from an external file.
  *
  * This class handles the loading of OBJ files, creates GPU buffers (vertex and index),
- * and provides a method to draw the geometry.
+ * and provides a method to draw the geometry. Shapes whose indices fit in 16 bits (relative
+ * to ShapeInfo::baseVertex) are stored as R16 indices, the rest as R32, in a single buffer.
+ * Processed OBJ files are written to a MeshCache and memory-mapped on later loads. All the
+ * processing happens in a MeshAsset, which can be built on any thread; creation only uploads it.
+ * A second vertex stream holds 16-bit quantized positions for depth-only passes. Meshes whose
+ * asset was quantized (MeshAsset::QuantizeVertices()) keep their main stream as 16-byte
+ * QuantizedVertex, drawn with the scene shader's VSQuantized.
+ * Simplified LOD levels share the vertex buffers and append their own index ranges.
+ * The full-detail level is also split into small clusters so passes can draw only the
+ * index ranges a CPU culler kept.
  */
 class Mesh
 {
@@ -76,6 +55,9 @@ public:
     /**
      * @brief Creates a mesh from raw vertex and index data.
      *
+     * Shapes must be added with AddShape() before calling this so the index buffer can be
+     * split per shape into 16-bit and 32-bit sections.
+     *
      * @param device Pointer to the ID3D11Device.
      * @param vertices Vector of vertices.
      * @param indices Vector of indices.
@@ -83,6 +65,28 @@ public:
      */
     bool Create(ID3D11Device *device, const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
 
+    /**
+     * @brief Creates a mesh from processed CPU mesh data, taking over its shapes and minimum Y.
+     *
+     * Levels in MeshData::lods are packed after the full-detail indices in the same buffer.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param data Mesh arrays and shape ranges.
+     * @return true if successful.
+     */
+    bool Create(ID3D11Device *device, const MeshData &data);
+
+    /**
+     * @brief Creates the GPU buffers from a mesh processed on the CPU, taking over its shapes and
+     * minimum Y. Only buffer creation is left to do, so this is the render-thread half of loading.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param asset Packed arrays, quantized positions, clusters and occluders (see MeshAsset). If it
+     * holds quantized vertices, they are uploaded instead of the full-precision ones.
+     * @return true if successful.
+     */
+    bool Create(ID3D11Device *device, const MeshAsset &asset);
+
     /**
      * @brief Adds a shape to the mesh.
      * @param info Shape metadata.
@@ -96,16 +100,65 @@ public:
      * @brief Binds the vertex and index buffers and issues a draw call for entire mesh.
      *
      * @param context Pointer to the ID3D11DeviceContext.
+     * @param lod Level of detail (0 is full detail), clamped to the available levels.
+     */
+    void Draw(ID3D11DeviceContext *context, size_t lod = 0);
+
+    /**
+     * @brief Draws the entire mesh from the quantized position-only stream.
+     *
+     * Positions arrive as UNORM16 (DXGI_FORMAT_R16G16B16A16_UNORM) and must be decoded with
+     * GetPositionDecodeMatrix() before the world transform.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param lod Level of detail (0 is full detail), clamped to the available levels.
      */
-    void Draw(ID3D11DeviceContext *context);
+    void DrawPositions(ID3D11DeviceContext *context, size_t lod = 0);
 
     /**
      * @brief Draws a single shape from the mesh by index.
      *
      * @param context Pointer to the ID3D11DeviceContext.
      * @param shapeIndex Index of the shape to draw.
+     * @param lod Level of detail (0 is full detail), clamped to the available levels.
+     */
+    void DrawShape(ID3D11DeviceContext *context, size_t shapeIndex, size_t lod = 0);
+
+    /**
+     * @brief Draws full-detail index ranges kept by ClusterCuller::Cull().
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param ranges Ranges relative to their shape's full-detail indices.
+     * @param count Number of ranges.
+     */
+    void DrawClusterRanges(ID3D11DeviceContext *context, const ClusterRange *ranges, size_t count);
+
+    /**
+     * @brief Draws culled index ranges from the quantized position-only stream.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param ranges Ranges relative to their shape's full-detail indices.
+     * @param count Number of ranges.
      */
-    void DrawShape(ID3D11DeviceContext *context, size_t shapeIndex);
+    void DrawClusterRangePositions(ID3D11DeviceContext *context, const ClusterRange *ranges, size_t count);
+
+    /**
+     * @brief Gets the culling clusters of the full-detail level.
+     * @return Clusters in shape order, with mesh-space bounds.
+     */
+    [[nodiscard]] const std::vector<MeshCluster> &GetClusters() const
+    {
+        return m_clusters;
+    }
+
+    /**
+     * @brief Gets the triangles used when this mesh hides others in the occlusion buffer.
+     * @return Three mesh-space positions per triangle (see OcclusionBuffer::SelectOccluders).
+     */
+    [[nodiscard]] const std::vector<DirectX::XMFLOAT3> &GetOccluderTriangles() const
+    {
+        return m_occluderTriangles;
+    }
 
     /**
      * @brief Gets the metadata for all shapes found in the mesh file.
@@ -125,11 +178,104 @@ public:
         return m_minY;
     }
 
+    /**
+     * @brief Gets the number of LOD levels, including full detail.
+     * @return 1 for meshes without simplified levels.
+     */
+    [[nodiscard]] size_t GetLodCount() const
+    {
+        return m_drawBatches.size();
+    }
+
+    /**
+     * @brief Gets the sphere enclosing the mesh's bounding box, used for LOD selection.
+     * @return Center in xyz and radius in w, in mesh space.
+     */
+    [[nodiscard]] DirectX::XMFLOAT4 GetBoundingSphere() const
+    {
+        const auto &b = m_positionBounds;
+        const float radius =
+            0.5f * std::sqrt((b.extent.x * b.extent.x) + (b.extent.y * b.extent.y) + (b.extent.z * b.extent.z));
+        return {b.min.x + (0.5f * b.extent.x), b.min.y + (0.5f * b.extent.y), b.min.z + (0.5f * b.extent.z), radius};
+    }
+
+    /**
+     * @brief Gets the axis-aligned bounding box of the mesh.
+     *
+     * @param outMin Receives the minimum corner in mesh space.
+     * @param outMax Receives the maximum corner in mesh space.
+     */
+    void GetBoundingBox(DirectX::XMFLOAT3 &outMin, DirectX::XMFLOAT3 &outMax) const
+    {
+        const auto &b = m_positionBounds;
+        outMin = b.min;
+        outMax = {b.min.x + b.extent.x, b.min.y + b.extent.y, b.min.z + b.extent.z};
+    }
+
+    /**
+     * @brief Tells whether the main vertex stream is QuantizedVertex rather than Vertex.
+     */
+    [[nodiscard]] bool IsQuantized() const
+    {
+        return m_vertexStride == Config::Vertex::STRIDE_QUANTIZED;
+    }
+
+    /**
+     * @brief Gets the bounds the quantized positions are relative to.
+     */
+    [[nodiscard]] const VertexQuantizer::Bounds &GetPositionBounds() const
+    {
+        return m_positionBounds;
+    }
+
+    /**
+     * @brief Gets the transform from quantized [0, 1] positions to mesh space.
+     * @return Scale by the bounds extent followed by a translation to the bounds minimum.
+     */
+    [[nodiscard]] DirectX::XMMATRIX GetPositionDecodeMatrix() const
+    {
+        return DirectX::XMMatrixScaling(m_positionBounds.extent.x, m_positionBounds.extent.y,
+                                        m_positionBounds.extent.z) *
+               DirectX::XMMatrixTranslation(m_positionBounds.min.x, m_positionBounds.min.y, m_positionBounds.min.z);
+    }
+
 private:
+    /**
+     * @struct DrawRange
+     * @brief GPU location of a run of indices sharing one index format and base vertex.
+     */
+    struct DrawRange
+    {
+        DXGI_FORMAT format = DXGI_FORMAT_R32_UINT; ///< R16_UINT or R32_UINT.
+        UINT byteOffset = 0;                       ///< Offset of the format's section in the index buffer.
+        UINT startIndex = 0;                       ///< First index within that section.
+        UINT indexCount = 0;                       ///< Number of indices.
+        INT baseVertex = 0;                        ///< Value added to each index.
+    };
+
+    /**
+     * @brief Binds one vertex stream and issues the merged draw batches.
+     */
+    void DrawBatches(ID3D11DeviceContext *context, ID3D11Buffer *vertexBuffer, UINT stride, size_t lod);
+
+    /**
+     * @brief Binds one vertex stream and issues one draw per culled cluster range.
+     */
+    void DrawRanges(ID3D11DeviceContext *context, ID3D11Buffer *vertexBuffer, UINT stride, const ClusterRange *ranges,
+                    size_t count);
+
     ComPtr<ID3D11Buffer> m_vertexBuffer;
+    UINT m_vertexStride = sizeof(Vertex); ///< sizeof(Vertex), or STRIDE_QUANTIZED for QuantizedVertex.
+    ComPtr<ID3D11Buffer> m_positionBuffer; ///< Quantized positions for depth-only passes.
     ComPtr<ID3D11Buffer> m_indexBuffer;
+    VertexQuantizer::Bounds m_positionBounds;
     UINT m_indexCount{0};
 
+    std::vector<DrawRange> m_shapeRanges;              ///< One range per shape (or one for the whole mesh), per level.
+    std::vector<std::vector<DrawRange>> m_drawBatches; ///< Per level, shape ranges merged for whole-mesh draws.
+    std::vector<MeshCluster> m_clusters;               ///< Culling clusters of the full-detail level.
+    std::vector<DirectX::XMFLOAT3> m_occluderTriangles; ///< Largest triangles, for the occlusion buffer.
+
     std::vector<ShapeInfo> m_shapes;
     float m_minY{0.0f};
 };
@@ -0,0 +1,139 @@
+#include "MeshAsset.h"
+#include <sstream>
+#include "../Core/DebugLog.h"
+#include "../Geometry/ClusterBuilder.h"
+#include "../Geometry/MeshOptimizer.h"
+#include "../Scene/OcclusionBuffer.h"
+#include "ObjLoader.h"
+
+bool MeshAsset::LoadOBJ(const std::string &fileName)
+{
+    // The cache depends on the OBJ and its companion MTL
+    std::string mtlName = fileName;
+    size_t extension = mtlName.find_last_of('.');
+    mtlName = (extension != std::string::npos ? mtlName.substr(0, extension) : mtlName) + ".mtl";
+    const std::vector<MeshCache::SourceStamp> stamps = MeshCache::ComputeStamps({fileName, mtlName});
+    const std::string cacheFile = MeshCache::GetCachePath(fileName);
+
+    auto cache = std::make_unique<MeshCache>();
+    if (cache->Open(cacheFile, stamps))
+    {
+        m_shapes = cache->GetShapes();
+        m_minY = cache->GetMinY();
+        m_view = cache->GetView();
+        // The quantized positions, clusters and occluders were derived before the cache was written
+        m_derived = cache->TakeDerived();
+        m_quantizedVertices.clear();
+        m_cache = std::move(cache);
+        m_vertices.clear();
+        m_indexBytes.clear();
+        m_ranges.clear();
+
+        std::ostringstream log;
+        log << "Loaded " << fileName << " from cache: " << m_view.vertexCount << " vertices, " << m_shapes.size()
+            << " shapes.\n";
+        DebugLog::Write(log.str());
+        return true;
+    }
+
+    MeshData data;
+    if (!ObjLoader::Load(fileName, data))
+    {
+        return false;
+    }
+
+    // Weld the de-indexed corners and reorder for the post-transform and fetch caches
+    MeshOptimizer::Stats stats = MeshOptimizer::ProcessMesh(data);
+    // Then gather triangles into connected, similarly facing runs for cluster culling
+    ClusterBuilder::GroupTriangles(data);
+
+    m_cache.reset();
+    m_vertices = std::move(data.vertices);
+    m_shapes = std::move(data.shapes);
+    m_minY = data.minY;
+    MeshOptimizer::PackIndices(data.indices, m_shapes, m_indexBytes, m_ranges);
+    SetView(1);
+    Derive();
+
+    bool cached = MeshCache::Write(cacheFile, stamps, m_view, m_shapes, m_minY, m_derived);
+    VertexQuantizer::Report quantized = VertexQuantizer::Analyze(m_view.vertices, m_view.vertexCount);
+    std::ostringstream log;
+    log << "Processed " << fileName << ": " << stats.verticesBefore << " -> " << stats.verticesAfter
+        << " vertices, ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << ", " << stats.batches
+        << " index batch(es)" << (cached ? ", cached." : ", cache not written.") << "\n";
+    log << "  Vertex memory: " << quantized.fullBytes / 1024 << " KB full, " << quantized.quantizedBytes / 1024
+        << " KB quantized, " << quantized.positionBytes / 1024 << " KB shadow positions (max error "
+        << quantized.maxPositionError << " units, " << quantized.maxNormalErrorDeg << " deg, uv "
+        << quantized.maxUvError << ").\n";
+    log << "  Culling clusters: " << m_derived.clusters.size() << " for " << data.indices.size() / 3
+        << " triangles, " << m_derived.occluderTriangles.size() / 3 << " occluder triangles.\n";
+    DebugLog::Write(log.str());
+    return true;
+}
+
+void MeshAsset::Build(const MeshData &data)
+{
+    m_cache.reset();
+    m_vertices = data.vertices;
+    m_shapes = data.shapes;
+    m_minY = data.minY;
+
+    // Full detail first, then each simplified level in its own 4-byte aligned block
+    m_indexBytes.clear();
+    m_ranges.clear();
+    MeshOptimizer::PackIndices(data.indices, data.shapes, m_indexBytes, m_ranges);
+    for (const auto &lod : data.lods)
+    {
+        std::vector<uint8_t> levelBytes;
+        std::vector<IndexRange> levelRanges;
+        MeshOptimizer::PackIndices(lod.indices, lod.shapes, levelBytes, levelRanges);
+
+        m_indexBytes.resize((m_indexBytes.size() + 3) & ~size_t(3), 0);
+        const auto levelOffset = static_cast<uint32_t>(m_indexBytes.size());
+        m_indexBytes.insert(m_indexBytes.end(), levelBytes.begin(), levelBytes.end());
+        for (auto &range : levelRanges)
+        {
+            range.byteOffset += levelOffset;
+            m_ranges.push_back(range);
+        }
+    }
+    SetView(data.lods.size() + 1);
+    Derive();
+}
+
+void MeshAsset::QuantizeVertices()
+{
+    m_quantizedVertices =
+        VertexQuantizer::QuantizeVertices(m_view.vertices, m_view.vertexCount, m_derived.positionBounds);
+}
+
+size_t MeshAsset::GetUploadBytes() const
+{
+    const size_t vertexBytes = m_quantizedVertices.empty()
+                                   ? m_view.vertexCount * sizeof(Vertex)
+                                   : m_quantizedVertices.size() * sizeof(VertexQuantizer::QuantizedVertex);
+    const size_t positionBytes = m_derived.positions.size() * sizeof(VertexQuantizer::QuantizedPosition);
+    return vertexBytes + positionBytes + m_view.indexByteCount;
+}
+
+void MeshAsset::SetView(size_t levelCount)
+{
+    m_view.vertices = m_vertices.data();
+    m_view.vertexCount = m_vertices.size();
+    m_view.indexBytes = m_indexBytes.data();
+    m_view.indexByteCount = m_indexBytes.size();
+    m_view.ranges = m_ranges.data();
+    m_view.rangeCount = m_ranges.size();
+    m_view.levelCount = levelCount;
+}
+
+void MeshAsset::Derive()
+{
+    // Position-only stream for depth-only passes, quantized against the mesh bounds
+    m_derived.positionBounds = VertexQuantizer::ComputeBounds(m_view.vertices, m_view.vertexCount);
+    m_derived.positions =
+        VertexQuantizer::QuantizePositions(m_view.vertices, m_view.vertexCount, m_derived.positionBounds);
+    m_quantizedVertices.clear();
+    m_derived.clusters = ClusterBuilder::Build(m_view);
+    m_derived.occluderTriangles = OcclusionBuffer::SelectOccluders(m_view);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file MeshAsset.h
+ * @brief Mesh processed on the CPU, ready to be copied into GPU buffers.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Geometry/VertexQuantizer.h"
+#include "MeshCache.h"
+#include "MeshData.h"
+
+/**
+ * @class MeshAsset
+ * @brief Everything Mesh::Create() needs, computed without a device: the vertex array, the
+ * packed 16/32-bit indices of every LOD level, the quantized position stream, the culling
+ * clusters and the occluder triangles.
+ *
+ * An asset is either built from MeshData or loaded from an OBJ file, in which case its arrays
+ * may point straight into a mapped MeshCache. It owns whatever its view points to, so it can
+ * be loaded on any thread and moved to the render thread for upload.
+ */
+class MeshAsset
+{
+public:
+    MeshAsset() = default;
+    MeshAsset(MeshAsset &&) = default;
+    MeshAsset &operator=(MeshAsset &&) = default;
+    MeshAsset(const MeshAsset &) = delete;
+    MeshAsset &operator=(const MeshAsset &) = delete;
+
+    /**
+     * @brief Loads an OBJ file from its MeshCache, or parses and processes it and writes the cache.
+     *
+     * Appends a summary to debug.log.
+     *
+     * @param fileName Path to the .obj file; its .mtl is part of the cache key.
+     * @return true if loading succeeded.
+     */
+    bool LoadOBJ(const std::string &fileName);
+
+    /**
+     * @brief Packs processed mesh data, taking over its shapes and minimum Y.
+     *
+     * Levels in MeshData::lods are packed after the full-detail indices, each in its own
+     * 4-byte aligned block.
+     *
+     * @param data Mesh arrays and shape ranges.
+     */
+    void Build(const MeshData &data);
+
+    /**
+     * @brief Encodes the vertices as QuantizedVertex against the position bounds, so Mesh::Create()
+     * uploads the 16-byte format instead of Vertex. Opt-in, for meshes whose precision allows it.
+     */
+    void QuantizeVertices();
+
+    /**
+     * @brief Gets the vertex and packed index arrays.
+     */
+    [[nodiscard]] const PackedMeshView &GetView() const
+    {
+        return m_view;
+    }
+
+    /**
+     * @brief Gets the shape metadata.
+     */
+    [[nodiscard]] const std::vector<ShapeInfo> &GetShapes() const
+    {
+        return m_shapes;
+    }
+
+    /**
+     * @brief Gets the minimum Y coordinate of the mesh.
+     */
+    [[nodiscard]] float GetMinY() const
+    {
+        return m_minY;
+    }
+
+    /**
+     * @brief Gets the bounds the positions were quantized against.
+     */
+    [[nodiscard]] const VertexQuantizer::Bounds &GetPositionBounds() const
+    {
+        return m_derived.positionBounds;
+    }
+
+    /**
+     * @brief Gets the 16-bit positions of the depth-only stream.
+     */
+    [[nodiscard]] const std::vector<VertexQuantizer::QuantizedPosition> &GetPositions() const
+    {
+        return m_derived.positions;
+    }
+
+    /**
+     * @brief Gets the compact vertices, empty unless QuantizeVertices() was called.
+     */
+    [[nodiscard]] const std::vector<VertexQuantizer::QuantizedVertex> &GetQuantizedVertices() const
+    {
+        return m_quantizedVertices;
+    }
+
+    /**
+     * @brief Gets the culling clusters of the full-detail level.
+     */
+    [[nodiscard]] const std::vector<MeshCluster> &GetClusters() const
+    {
+        return m_derived.clusters;
+    }
+
+    /**
+     * @brief Gets the occluder triangles, three positions each.
+     */
+    [[nodiscard]] const std::vector<DirectX::XMFLOAT3> &GetOccluderTriangles() const
+    {
+        return m_derived.occluderTriangles;
+    }
+
+    /**
+     * @brief Gets the number of bytes the upload copies into vertex and index buffers.
+     */
+    [[nodiscard]] size_t GetUploadBytes() const;
+
+private:
+    /**
+     * @brief Points the view at the owned arrays.
+     */
+    void SetView(size_t levelCount);
+
+    /**
+     * @brief Computes the quantized positions, clusters and occluders from the view.
+     */
+    void Derive();
+
+    std::unique_ptr<MeshCache> m_cache; ///< Mapping the view points into, when loaded from a cache.
+    std::vector<Vertex> m_vertices;
+    std::vector<uint8_t> m_indexBytes;
+    std::vector<IndexRange> m_ranges;
+    PackedMeshView m_view;
+
+    std::vector<ShapeInfo> m_shapes;
+    float m_minY = 0.0f;
+    MeshCache::Derived m_derived; ///< Quantized positions, clusters and occluders (cached with the mesh).
+    std::vector<VertexQuantizer::QuantizedVertex> m_quantizedVertices;
+};
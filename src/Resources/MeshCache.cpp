@@ -0,0 +1,388 @@
+#include "MeshCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "../Core/ThreadPool.h"
+
+namespace
+{
+
+constexpr char CACHE_MAGIC[8] = {'S', 'R', 'M', 'E', 'S', 'H', 'C', '\0'};
+constexpr uint64_t SECTION_ALIGNMENT = 16;
+constexpr size_t HASH_BLOCK_BYTES = 1 << 20;
+
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+
+/**
+ * @brief Fixed-size header at the start of every cache file. Offsets are from the file start.
+ */
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexStride;
+    uint32_t sourceCount;
+    uint32_t shapeCount;
+    uint64_t vertexCount;
+    uint64_t indexByteCount;
+    uint64_t rangeCount;
+    uint64_t positionCount;
+    uint64_t clusterCount;
+    uint64_t occluderVertexCount;
+    uint64_t stampOffset;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t rangeOffset;
+    uint64_t positionOffset;
+    uint64_t clusterOffset;
+    uint64_t occluderOffset;
+    uint64_t shapeOffset;
+    uint64_t nameOffset;
+    uint64_t nameBytes;
+    uint64_t fileSize;
+    float minY;
+    float boundsMin[3];
+    float boundsExtent[3];
+    uint32_t reserved;
+};
+
+/**
+ * @brief ShapeInfo without the std::string, as stored on disk.
+ */
+struct ShapeRecord
+{
+    float center[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    uint32_t startIndex;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+uint64_t AlignUp(uint64_t value)
+{
+    return (value + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t Avalanche(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Word-at-a-time multiply/rotate hash of one block
+uint64_t HashBlock(const uint8_t *data, size_t size)
+{
+    uint64_t h = PRIME3 ^ (static_cast<uint64_t>(size) * PRIME1);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h ^= RotateLeft(word * PRIME2, 31) * PRIME1;
+        h = (RotateLeft(h, 27) * PRIME1) + PRIME3;
+    }
+    for (; i < size; ++i)
+    {
+        h ^= data[i] * PRIME3;
+        h = RotateLeft(h, 11) * PRIME1;
+    }
+    return Avalanche(h);
+}
+
+bool SameStamp(const MeshCache::SourceStamp &a, const MeshCache::SourceStamp &b)
+{
+    return a.size == b.size && a.modifiedAt == b.modifiedAt && a.hash == b.hash;
+}
+
+bool SectionFits(uint64_t offset, uint64_t bytes, uint64_t fileSize)
+{
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+void WritePadding(std::ofstream &out, uint64_t &position, uint64_t target)
+{
+    static const char zeros[SECTION_ALIGNMENT] = {};
+    while (position < target)
+    {
+        auto count = static_cast<std::streamsize>((std::min)(target - position, SECTION_ALIGNMENT));
+        out.write(zeros, count);
+        position += static_cast<uint64_t>(count);
+    }
+}
+
+} // namespace
+
+uint64_t MeshCache::HashBytes(const uint8_t *data, size_t size)
+{
+    const size_t blockCount = (size + HASH_BLOCK_BYTES - 1) / HASH_BLOCK_BYTES;
+    std::vector<uint64_t> blockHashes(blockCount);
+    ThreadPool::Shared().ParallelFor(blockCount,
+                                     [&](size_t b)
+                                     {
+                                         size_t start = b * HASH_BLOCK_BYTES;
+                                         size_t bytes = (std::min)(HASH_BLOCK_BYTES, size - start);
+                                         blockHashes[b] = HashBlock(data + start, bytes);
+                                     });
+
+    uint64_t h = static_cast<uint64_t>(size) * PRIME1;
+    for (uint64_t blockHash : blockHashes)
+    {
+        h ^= blockHash;
+        h = (RotateLeft(h, 27) * PRIME1) + PRIME3;
+    }
+    return Avalanche(h);
+}
+
+std::vector<MeshCache::SourceStamp> MeshCache::ComputeStamps(const std::vector<std::string> &fileNames)
+{
+    std::vector<SourceStamp> stamps(fileNames.size());
+    for (size_t i = 0; i < fileNames.size(); ++i)
+    {
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(fileNames[i], error);
+        if (error)
+            continue;
+
+        MappedFile file;
+        if (!file.Open(fileNames[i]))
+            continue;
+
+        stamps[i].size = file.GetSize();
+        stamps[i].modifiedAt = static_cast<int64_t>(modified.time_since_epoch().count());
+        stamps[i].hash = HashBytes(file.GetData(), file.GetSize());
+    }
+    return stamps;
+}
+
+std::string MeshCache::GetCachePath(const std::string &sourceFile)
+{
+    return sourceFile + ".meshcache";
+}
+
+bool MeshCache::Write(const std::string &cacheFile, const std::vector<SourceStamp> &stamps, const PackedMeshView &view,
+                      const std::vector<ShapeInfo> &shapes, float minY, const Derived &derived)
+{
+    std::vector<ShapeRecord> records(shapes.size());
+    std::string names;
+    for (size_t s = 0; s < shapes.size(); ++s)
+    {
+        const ShapeInfo &shape = shapes[s];
+        ShapeRecord &record = records[s];
+        record.center[0] = shape.center.x;
+        record.center[1] = shape.center.y;
+        record.center[2] = shape.center.z;
+        record.diffuse[0] = shape.material.diffuse.x;
+        record.diffuse[1] = shape.material.diffuse.y;
+        record.diffuse[2] = shape.material.diffuse.z;
+        record.specular[0] = shape.material.specular.x;
+        record.specular[1] = shape.material.specular.y;
+        record.specular[2] = shape.material.specular.z;
+        record.shininess = shape.material.shininess;
+        record.startIndex = shape.startIndex;
+        record.indexCount = shape.indexCount;
+        record.baseVertex = shape.baseVertex;
+        record.nameOffset = static_cast<uint32_t>(names.size());
+        record.nameLength = static_cast<uint32_t>(shape.name.size());
+        names += shape.name;
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.vertexStride = sizeof(Vertex);
+    header.sourceCount = static_cast<uint32_t>(stamps.size());
+    header.shapeCount = static_cast<uint32_t>(records.size());
+    header.vertexCount = view.vertexCount;
+    header.indexByteCount = view.indexByteCount;
+    header.rangeCount = view.rangeCount;
+    header.positionCount = derived.positions.size();
+    header.clusterCount = derived.clusters.size();
+    header.occluderVertexCount = derived.occluderTriangles.size();
+    header.minY = minY;
+    header.boundsMin[0] = derived.positionBounds.min.x;
+    header.boundsMin[1] = derived.positionBounds.min.y;
+    header.boundsMin[2] = derived.positionBounds.min.z;
+    header.boundsExtent[0] = derived.positionBounds.extent.x;
+    header.boundsExtent[1] = derived.positionBounds.extent.y;
+    header.boundsExtent[2] = derived.positionBounds.extent.z;
+    header.stampOffset = AlignUp(sizeof(FileHeader));
+    header.vertexOffset = AlignUp(header.stampOffset + (stamps.size() * sizeof(SourceStamp)));
+    header.indexOffset = AlignUp(header.vertexOffset + (view.vertexCount * sizeof(Vertex)));
+    header.rangeOffset = AlignUp(header.indexOffset + view.indexByteCount);
+    header.positionOffset = AlignUp(header.rangeOffset + (view.rangeCount * sizeof(IndexRange)));
+    header.clusterOffset =
+        AlignUp(header.positionOffset + (header.positionCount * sizeof(VertexQuantizer::QuantizedPosition)));
+    header.occluderOffset = AlignUp(header.clusterOffset + (header.clusterCount * sizeof(MeshCluster)));
+    header.shapeOffset = AlignUp(header.occluderOffset + (header.occluderVertexCount * sizeof(DirectX::XMFLOAT3)));
+    header.nameOffset = AlignUp(header.shapeOffset + (records.size() * sizeof(ShapeRecord)));
+    header.nameBytes = names.size();
+    header.fileSize = header.nameOffset + header.nameBytes;
+
+    const std::string tempFile = cacheFile + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        uint64_t position = 0;
+        auto section = [&](uint64_t offset, const void *data, uint64_t bytes)
+        {
+            WritePadding(out, position, offset);
+            if (bytes > 0)
+                out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+            position += bytes;
+        };
+
+        section(0, &header, sizeof(header));
+        section(header.stampOffset, stamps.data(), stamps.size() * sizeof(SourceStamp));
+        section(header.vertexOffset, view.vertices, view.vertexCount * sizeof(Vertex));
+        section(header.indexOffset, view.indexBytes, view.indexByteCount);
+        section(header.rangeOffset, view.ranges, view.rangeCount * sizeof(IndexRange));
+        section(header.positionOffset, derived.positions.data(),
+                header.positionCount * sizeof(VertexQuantizer::QuantizedPosition));
+        section(header.clusterOffset, derived.clusters.data(), header.clusterCount * sizeof(MeshCluster));
+        section(header.occluderOffset, derived.occluderTriangles.data(),
+                header.occluderVertexCount * sizeof(DirectX::XMFLOAT3));
+        section(header.shapeOffset, records.data(), records.size() * sizeof(ShapeRecord));
+        section(header.nameOffset, names.data(), names.size());
+
+        if (!out)
+        {
+            out.close();
+            std::remove(tempFile.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, cacheFile, error);
+    if (error)
+    {
+        std::filesystem::remove(tempFile, error);
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::Open(const std::string &cacheFile, const std::vector<SourceStamp> &stamps)
+{
+    m_view = PackedMeshView();
+    m_shapes.clear();
+    m_minY = 0.0f;
+    m_derived = Derived();
+
+    if (!m_file.Open(cacheFile) || m_file.GetSize() < sizeof(FileHeader))
+    {
+        m_file.Close();
+        return false;
+    }
+
+    const uint8_t *base = m_file.GetData();
+    const uint64_t fileSize = m_file.GetSize();
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    bool valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 && header.version == VERSION &&
+                 header.vertexStride == sizeof(Vertex) && header.fileSize == fileSize &&
+                 header.sourceCount == stamps.size() &&
+                 SectionFits(header.stampOffset, header.sourceCount * sizeof(SourceStamp), fileSize) &&
+                 SectionFits(header.vertexOffset, header.vertexCount * sizeof(Vertex), fileSize) &&
+                 SectionFits(header.indexOffset, header.indexByteCount, fileSize) &&
+                 SectionFits(header.rangeOffset, header.rangeCount * sizeof(IndexRange), fileSize) &&
+                 header.positionCount == header.vertexCount && header.occluderVertexCount % 3 == 0 &&
+                 SectionFits(header.positionOffset,
+                             header.positionCount * sizeof(VertexQuantizer::QuantizedPosition), fileSize) &&
+                 SectionFits(header.clusterOffset, header.clusterCount * sizeof(MeshCluster), fileSize) &&
+                 SectionFits(header.occluderOffset, header.occluderVertexCount * sizeof(DirectX::XMFLOAT3),
+                             fileSize) &&
+                 SectionFits(header.shapeOffset, header.shapeCount * sizeof(ShapeRecord), fileSize) &&
+                 SectionFits(header.nameOffset, header.nameBytes, fileSize);
+
+    for (size_t i = 0; valid && i < stamps.size(); ++i)
+    {
+        SourceStamp stored;
+        std::memcpy(&stored, base + header.stampOffset + (i * sizeof(SourceStamp)), sizeof(stored));
+        valid = SameStamp(stored, stamps[i]);
+    }
+
+    const auto *ranges = reinterpret_cast<const IndexRange *>(base + header.rangeOffset);
+    for (uint64_t r = 0; valid && r < header.rangeCount; ++r)
+    {
+        const IndexRange &range = ranges[r];
+        valid = (range.indexSize == sizeof(uint16_t) || range.indexSize == sizeof(uint32_t)) &&
+                SectionFits(range.byteOffset + (static_cast<uint64_t>(range.startIndex) * range.indexSize),
+                            static_cast<uint64_t>(range.indexCount) * range.indexSize, header.indexByteCount);
+    }
+
+    // Clusters address a range's indices, so they must stay inside it
+    std::vector<MeshCluster> clusters(valid ? header.clusterCount : 0);
+    if (!clusters.empty())
+        std::memcpy(clusters.data(), base + header.clusterOffset, clusters.size() * sizeof(MeshCluster));
+    for (const MeshCluster &cluster : clusters)
+    {
+        valid = valid && cluster.shape < header.rangeCount &&
+                static_cast<uint64_t>(cluster.startIndex) + cluster.indexCount <= ranges[cluster.shape].indexCount;
+    }
+
+    if (!valid)
+    {
+        m_file.Close();
+        return false;
+    }
+
+    const auto *records = reinterpret_cast<const ShapeRecord *>(base + header.shapeOffset);
+    const auto *names = reinterpret_cast<const char *>(base + header.nameOffset);
+    m_shapes.resize(header.shapeCount);
+    for (uint32_t s = 0; s < header.shapeCount; ++s)
+    {
+        const ShapeRecord &record = records[s];
+        ShapeInfo &shape = m_shapes[s];
+        if (SectionFits(record.nameOffset, record.nameLength, header.nameBytes))
+            shape.name.assign(names + record.nameOffset, record.nameLength);
+        shape.center = {record.center[0], record.center[1], record.center[2]};
+        shape.material.diffuse = {record.diffuse[0], record.diffuse[1], record.diffuse[2]};
+        shape.material.specular = {record.specular[0], record.specular[1], record.specular[2]};
+        shape.material.shininess = record.shininess;
+        shape.startIndex = record.startIndex;
+        shape.indexCount = record.indexCount;
+        shape.baseVertex = record.baseVertex;
+    }
+
+    m_view.vertices = reinterpret_cast<const Vertex *>(base + header.vertexOffset);
+    m_view.vertexCount = header.vertexCount;
+    m_view.indexBytes = base + header.indexOffset;
+    m_view.indexByteCount = header.indexByteCount;
+    m_view.ranges = ranges;
+    m_view.rangeCount = header.rangeCount;
+    m_minY = header.minY;
+
+    m_derived.positionBounds.min = {header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]};
+    m_derived.positionBounds.extent = {header.boundsExtent[0], header.boundsExtent[1], header.boundsExtent[2]};
+    m_derived.positions.resize(header.positionCount);
+    if (!m_derived.positions.empty())
+        std::memcpy(m_derived.positions.data(), base + header.positionOffset,
+                    m_derived.positions.size() * sizeof(VertexQuantizer::QuantizedPosition));
+    m_derived.clusters = std::move(clusters);
+    m_derived.occluderTriangles.resize(header.occluderVertexCount);
+    if (!m_derived.occluderTriangles.empty())
+        std::memcpy(m_derived.occluderTriangles.data(), base + header.occluderOffset,
+                    m_derived.occluderTriangles.size() * sizeof(DirectX::XMFLOAT3));
+    return true;
+}
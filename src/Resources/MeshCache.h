@@ -0,0 +1,151 @@
+/**
+ * @file MeshCache.h
+ * @brief Versioned binary cache of processed meshes, loaded by memory mapping.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Core/MappedFile.h"
+#include "../Geometry/VertexQuantizer.h"
+#include "MeshData.h"
+
+/**
+ * @class MeshCache
+ * @brief Stores a processed mesh (vertices, packed indices, shape ranges, materials, bounds)
+ * and the data derived from it for culling and depth-only passes next to its source file, and
+ * maps it back on later runs.
+ *
+ * A cache is only used when its format version matches and every source file it was built
+ * from still has the same size, modification time and content hash. The vertex and index
+ * arrays of an opened cache point straight into the mapping, so they can be handed to buffer
+ * creation without copying.
+ */
+class MeshCache
+{
+public:
+    /// Bump whenever the file layout or the processing that produced it changes.
+    static constexpr uint32_t VERSION = 3;
+
+    /**
+     * @struct SourceStamp
+     * @brief Identity of one source file the cache was built from.
+     */
+    struct SourceStamp
+    {
+        uint64_t size = 0;      ///< File size in bytes (0 if the file does not exist).
+        int64_t modifiedAt = 0; ///< Last write time in file clock ticks.
+        uint64_t hash = 0;      ///< 64-bit content hash.
+    };
+
+    /**
+     * @struct Derived
+     * @brief What MeshAsset derives from the mesh, stored so a cache hit does not rebuild it.
+     */
+    struct Derived
+    {
+        VertexQuantizer::Bounds positionBounds;                    ///< Bounds the positions are quantized against.
+        std::vector<VertexQuantizer::QuantizedPosition> positions; ///< Depth-only positions, one per vertex.
+        std::vector<MeshCluster> clusters;                         ///< Culling clusters.
+        std::vector<DirectX::XMFLOAT3> occluderTriangles;          ///< Occluder triangle corners, three per triangle.
+    };
+
+    /**
+     * @brief Computes stamps for a list of source files.
+     *
+     * Missing files get a zero stamp, so a companion file appearing later invalidates the cache.
+     * Hashing is split into blocks hashed in parallel.
+     *
+     * @param fileNames Source files (e.g. the .obj and its .mtl).
+     * @return One stamp per file, in the same order.
+     */
+    static std::vector<SourceStamp> ComputeStamps(const std::vector<std::string> &fileNames);
+
+    /**
+     * @brief Hashes a block of memory.
+     *
+     * @param data Start of the data.
+     * @param size Size in bytes.
+     * @return 64-bit hash (independent of thread count).
+     */
+    static uint64_t HashBytes(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Gets the cache file path used for a source file.
+     * @param sourceFile Path to the source model.
+     * @return Source path with a ".meshcache" suffix.
+     */
+    static std::string GetCachePath(const std::string &sourceFile);
+
+    /**
+     * @brief Writes a cache file.
+     *
+     * The file is written under a temporary name and renamed into place, so a crash never
+     * leaves a truncated cache behind.
+     *
+     * @param cacheFile Destination path.
+     * @param stamps Stamps of the source files.
+     * @param view Vertex and packed index arrays.
+     * @param shapes Shape metadata (names, centers, materials, index ranges).
+     * @param minY Minimum Y coordinate of the mesh.
+     * @param derived Data derived from the mesh.
+     * @return true if the file was written.
+     */
+    static bool Write(const std::string &cacheFile, const std::vector<SourceStamp> &stamps, const PackedMeshView &view,
+                      const std::vector<ShapeInfo> &shapes, float minY, const Derived &derived);
+
+    /**
+     * @brief Maps a cache file and validates it against the current source stamps.
+     *
+     * @param cacheFile Path to the cache.
+     * @param stamps Current stamps of the source files.
+     * @return true if the cache exists, is well-formed and up to date.
+     */
+    bool Open(const std::string &cacheFile, const std::vector<SourceStamp> &stamps);
+
+    /**
+     * @brief Gets the mapped mesh arrays. Valid while this object stays open.
+     * @return View into the mapping.
+     */
+    [[nodiscard]] const PackedMeshView &GetView() const
+    {
+        return m_view;
+    }
+
+    /**
+     * @brief Gets the shape metadata read from the cache.
+     * @return Const reference to the shapes.
+     */
+    [[nodiscard]] const std::vector<ShapeInfo> &GetShapes() const
+    {
+        return m_shapes;
+    }
+
+    /**
+     * @brief Gets the minimum Y coordinate stored in the cache.
+     * @return The minimum Y value.
+     */
+    [[nodiscard]] float GetMinY() const
+    {
+        return m_minY;
+    }
+
+    /**
+     * @brief Moves the derived data read from the cache out of it (empty afterwards).
+     * @return The derived data.
+     */
+    [[nodiscard]] Derived TakeDerived()
+    {
+        return std::move(m_derived);
+    }
+
+private:
+    MappedFile m_file;
+    PackedMeshView m_view;
+    std::vector<ShapeInfo> m_shapes;
+    float m_minY = 0.0f;
+    Derived m_derived;
+};
@@ -0,0 +1,151 @@
+/**
+ * @file MeshData.h
+ * @brief CPU-side vertex, material and shape definitions shared by loaders and GPU meshes.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @struct Vertex
+ * @brief Represents a single vertex in a 3D mesh.
+ */
+struct Vertex
+{
+    DirectX::XMFLOAT3 position; ///< 3D position of the vertex.
+    DirectX::XMFLOAT3 normal;   ///< Normal vector for lighting calculations.
+    DirectX::XMFLOAT2 uv;       ///< Texture coordinates.
+};
+
+/**
+ * @struct MaterialData
+ * @brief Material properties loaded from MTL files.
+ */
+struct MaterialData
+{
+    DirectX::XMFLOAT3 diffuse = {1.0f, 1.0f, 1.0f};  ///< Diffuse color (Kd).
+    DirectX::XMFLOAT3 specular = {0.5f, 0.5f, 0.5f}; ///< Specular color (Ks).
+    float shininess = 32.0f;                         ///< Shininess exponent (Ns).
+};
+
+/**
+ * @struct ShapeInfo
+ * @brief Metadata about a specific shape or object within a mesh file.
+ */
+struct ShapeInfo
+{
+    std::string name;         ///< Name of the shape.
+    DirectX::XMFLOAT3 center; ///< Computed center point of the shape.
+    MaterialData material;    ///< Material properties for this shape.
+    uint32_t startIndex = 0;  ///< Starting index in the index buffer.
+    uint32_t indexCount = 0;  ///< Number of indices for this shape.
+    int32_t baseVertex = 0;   ///< Value added to each index before fetching (lets indices stay 16-bit).
+};
+
+/**
+ * @struct LodLevel
+ * @brief A simplified index list over the same vertices as the full-detail mesh.
+ */
+struct LodLevel
+{
+    std::vector<uint32_t> indices; ///< Triangle list indices, relative to each shape's baseVertex.
+    std::vector<ShapeInfo> shapes; ///< The mesh's shapes with this level's index ranges.
+    float error = 0.0f;            ///< Largest deviation from the full-detail surface, in mesh units.
+};
+
+/**
+ * @struct MeshData
+ * @brief Geometry of a mesh as plain CPU arrays, before any GPU buffer is created.
+ */
+struct MeshData
+{
+    std::vector<Vertex> vertices;  ///< Vertex array.
+    std::vector<uint32_t> indices; ///< Triangle list indices, relative to each shape's baseVertex.
+    std::vector<ShapeInfo> shapes; ///< Shape ranges into the index array.
+    std::vector<LodLevel> lods;    ///< Progressively coarser levels after the full-detail one (may be empty).
+    float minY = 0.0f;             ///< Minimum Y coordinate over all vertices.
+};
+
+/**
+ * @struct IndexRange
+ * @brief Location of one shape's indices inside a packed 16/32-bit index buffer.
+ */
+struct IndexRange
+{
+    uint32_t byteOffset = 0; ///< Offset of the range's section (R16 or R32) in the packed bytes.
+    uint32_t startIndex = 0; ///< First index within that section.
+    uint32_t indexCount = 0; ///< Number of indices.
+    int32_t baseVertex = 0;  ///< Value added to each index.
+    uint32_t indexSize = 4;  ///< 2 for R16 indices, 4 for R32.
+};
+
+/**
+ * @struct MeshCluster
+ * @brief A small run of consecutive triangles within one shape, with culling bounds.
+ */
+struct MeshCluster
+{
+    DirectX::XMFLOAT4 sphere = {0.0f, 0.0f, 0.0f, 0.0f}; ///< Bounding sphere: center xyz, radius w (mesh space).
+    DirectX::XMFLOAT4 cone = {0.0f, 0.0f, 0.0f, 1.0f};   ///< Normal cone: front-face axis xyz, sine of spread w.
+    uint32_t shape = 0;                                  ///< Index of the shape (or 0 for the whole mesh).
+    uint32_t startIndex = 0;                             ///< First index, relative to the shape's range.
+    uint32_t indexCount = 0;                             ///< Number of indices.
+};
+
+/**
+ * @struct ClusterRange
+ * @brief Merged run of visible clusters, drawn with a single call.
+ */
+struct ClusterRange
+{
+    uint32_t shape = 0;      ///< Index of the shape (or 0 for the whole mesh).
+    uint32_t startIndex = 0; ///< First index, relative to the shape's range.
+    uint32_t indexCount = 0; ///< Number of indices.
+};
+
+/**
+ * @struct PackedMeshView
+ * @brief Non-owning view of GPU-ready vertex and packed index arrays.
+ *
+ * The arrays may live in a MeshData-derived buffer or directly in a memory-mapped cache file.
+ */
+struct PackedMeshView
+{
+    const Vertex *vertices = nullptr;    ///< Vertex array.
+    size_t vertexCount = 0;              ///< Number of vertices.
+    const uint8_t *indexBytes = nullptr; ///< R16 section followed by a 4-byte aligned R32 section.
+    size_t indexByteCount = 0;           ///< Size of the packed index data in bytes.
+    const IndexRange *ranges = nullptr;  ///< One range per shape (or one for the whole mesh), per LOD level.
+    size_t rangeCount = 0;               ///< Number of ranges.
+    size_t levelCount = 1;               ///< Number of LOD levels; ranges are grouped level by level.
+};
+
+/**
+ * @brief Reads one packed index and applies the range's base vertex.
+ *
+ * @param view Packed mesh arrays.
+ * @param range Range the index belongs to.
+ * @param i Index position within the range.
+ * @return Vertex index into view.vertices.
+ */
+inline uint32_t ReadPackedIndex(const PackedMeshView &view, const IndexRange &range, uint32_t i)
+{
+    const uint8_t *bytes = view.indexBytes + range.byteOffset + (static_cast<size_t>(range.startIndex + i) * range.indexSize);
+    uint32_t index = 0;
+    if (range.indexSize == sizeof(uint16_t))
+    {
+        uint16_t narrow;
+        std::memcpy(&narrow, bytes, sizeof(narrow));
+        index = narrow;
+    }
+    else
+    {
+        std::memcpy(&index, bytes, sizeof(index));
+    }
+    return static_cast<uint32_t>(static_cast<int64_t>(index) + range.baseVertex);
+}
@@ -0,0 +1,540 @@
+#include "ObjLoader.h"
+#include <algorithm>
+#include <cfloat>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include "../Core/MappedFile.h"
+#include "../Core/ThreadPool.h"
+
+namespace
+{
+
+constexpr int32_t NO_INDEX = -1;
+
+/**
+ * @brief Zero-based attribute indices of one triangle corner.
+ */
+struct Corner
+{
+    int32_t v = NO_INDEX;
+    int32_t vt = NO_INDEX;
+    int32_t vn = NO_INDEX;
+};
+
+/**
+ * @brief A run of triangles inside a chunk, optionally opened by an `o`/`g` statement.
+ */
+struct Segment
+{
+    std::string name;
+    bool startsShape = false; ///< false for the leading run that continues the previous chunk's shape.
+    size_t firstTri = 0;
+};
+
+/**
+ * @brief Everything parsed from one line-aligned chunk, with chunk-local attribute numbering.
+ */
+struct ChunkResult
+{
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<Corner> corners;             ///< Three per triangle.
+    std::vector<int32_t> triMaterial;        ///< Index into materialNames, or -1 for the material active at chunk start.
+    std::vector<std::string> materialNames;  ///< Distinct `usemtl` names seen in this chunk.
+    int32_t endMaterial = -1;                ///< Material active at the end of the chunk (-1 = unchanged).
+    std::vector<Segment> segments;           ///< Always starts with a continuation segment.
+    std::vector<std::string> materialLibs;   ///< `mtllib` file names.
+    std::vector<uint32_t> relativeFixups;    ///< cornerIndex * 3 + component of negative (relative) references.
+    std::vector<size_t> quads;               ///< First triangle of each quad, whose diagonal is picked after merging.
+};
+
+bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char *SkipSpace(const char *p, const char *end)
+{
+    while (p < end && IsSpace(*p))
+        ++p;
+    return p;
+}
+
+const char *SkipToken(const char *p, const char *end)
+{
+    while (p < end && !IsSpace(*p))
+        ++p;
+    return p;
+}
+
+const char *ParseFloat(const char *p, const char *end, float &out)
+{
+    p = SkipSpace(p, end);
+    if (p < end && *p == '+')
+        ++p;
+    auto result = std::from_chars(p, end, out);
+    if (result.ec != std::errc())
+    {
+        out = 0.0f;
+        return SkipToken(p, end);
+    }
+    return result.ptr;
+}
+
+const char *ParseInt(const char *p, const char *end, int32_t &out)
+{
+    if (p < end && *p == '+')
+        ++p;
+    auto result = std::from_chars(p, end, out);
+    if (result.ec != std::errc())
+    {
+        out = 0;
+        return p;
+    }
+    return result.ptr;
+}
+
+std::string RestOfLine(const char *p, const char *end)
+{
+    p = SkipSpace(p, end);
+    const char *last = end;
+    while (last > p && IsSpace(*(last - 1)))
+        --last;
+    return {p, static_cast<size_t>(last - p)};
+}
+
+bool StartsWith(const char *p, const char *end, const char *keyword)
+{
+    size_t len = std::strlen(keyword);
+    return static_cast<size_t>(end - p) > len && std::memcmp(p, keyword, len) == 0 && IsSpace(p[len]);
+}
+
+/**
+ * @brief Converts an OBJ index (1-based, or negative relative) to a 0-based index.
+ * @return true if the result is chunk-relative and needs the chunk's base added after merging.
+ */
+bool ResolveIndex(int32_t raw, size_t localCount, int32_t &out)
+{
+    if (raw > 0)
+    {
+        out = raw - 1;
+        return false;
+    }
+    if (raw < 0)
+    {
+        out = static_cast<int32_t>(localCount) + raw;
+        return true;
+    }
+    out = NO_INDEX;
+    return false;
+}
+
+void ParseChunk(const char *begin, const char *end, ChunkResult &out)
+{
+    out.segments.push_back({std::string(), false, 0});
+    int32_t currentMaterial = -1;
+    std::vector<Corner> polygon;
+    std::vector<uint8_t> polygonRelative; // bit per component
+
+    const char *line = begin;
+    while (line < end)
+    {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        if (!lineEnd)
+            lineEnd = end;
+
+        const char *p = SkipSpace(line, lineEnd);
+        if (p < lineEnd && *p != '#')
+        {
+            if (p[0] == 'v' && p + 1 < lineEnd && IsSpace(p[1]))
+            {
+                float x, y, z;
+                p = ParseFloat(p + 1, lineEnd, x);
+                p = ParseFloat(p, lineEnd, y);
+                ParseFloat(p, lineEnd, z);
+                out.positions.insert(out.positions.end(), {x, y, z});
+            }
+            else if (StartsWith(p, lineEnd, "vn"))
+            {
+                float x, y, z;
+                p = ParseFloat(p + 2, lineEnd, x);
+                p = ParseFloat(p, lineEnd, y);
+                ParseFloat(p, lineEnd, z);
+                out.normals.insert(out.normals.end(), {x, y, z});
+            }
+            else if (StartsWith(p, lineEnd, "vt"))
+            {
+                float u, v = 0.0f;
+                p = ParseFloat(p + 2, lineEnd, u);
+                if (SkipSpace(p, lineEnd) < lineEnd)
+                    ParseFloat(p, lineEnd, v);
+                out.texcoords.insert(out.texcoords.end(), {u, v});
+            }
+            else if (p[0] == 'f' && p + 1 < lineEnd && IsSpace(p[1]))
+            {
+                polygon.clear();
+                polygonRelative.clear();
+                p = SkipSpace(p + 1, lineEnd);
+                while (p < lineEnd)
+                {
+                    Corner corner;
+                    uint8_t relative = 0;
+                    int32_t raw = 0;
+                    p = ParseInt(p, lineEnd, raw);
+                    relative |= ResolveIndex(raw, out.positions.size() / 3, corner.v) ? 1 : 0;
+                    if (p < lineEnd && *p == '/')
+                    {
+                        ++p;
+                        if (p < lineEnd && *p != '/')
+                        {
+                            p = ParseInt(p, lineEnd, raw);
+                            relative |= ResolveIndex(raw, out.texcoords.size() / 2, corner.vt) ? 2 : 0;
+                        }
+                        if (p < lineEnd && *p == '/')
+                        {
+                            ++p;
+                            p = ParseInt(p, lineEnd, raw);
+                            relative |= ResolveIndex(raw, out.normals.size() / 3, corner.vn) ? 4 : 0;
+                        }
+                    }
+                    polygon.push_back(corner);
+                    polygonRelative.push_back(relative);
+                    p = SkipSpace(SkipToken(p, lineEnd), lineEnd);
+                }
+
+                // Fan triangulation; quads may be re-split along the other diagonal once positions are global
+                if (polygon.size() == 4)
+                    out.quads.push_back(out.triMaterial.size());
+                for (size_t i = 1; i + 1 < polygon.size(); ++i)
+                {
+                    const size_t fan[3] = {0, i, i + 1};
+                    for (size_t k : fan)
+                    {
+                        const auto cornerIndex = static_cast<uint32_t>(out.corners.size());
+                        for (uint32_t c = 0; c < 3; ++c)
+                        {
+                            if (polygonRelative[k] & (1u << c))
+                                out.relativeFixups.push_back((cornerIndex * 3) + c);
+                        }
+                        out.corners.push_back(polygon[k]);
+                    }
+                    out.triMaterial.push_back(currentMaterial);
+                }
+            }
+            else if ((p[0] == 'o' || p[0] == 'g') && (p + 1 == lineEnd || IsSpace(p[1])))
+            {
+                out.segments.push_back({RestOfLine(p + 1, lineEnd), true, out.triMaterial.size()});
+            }
+            else if (StartsWith(p, lineEnd, "usemtl"))
+            {
+                std::string name = RestOfLine(p + 6, lineEnd);
+                auto it = std::find(out.materialNames.begin(), out.materialNames.end(), name);
+                currentMaterial = static_cast<int32_t>(std::distance(out.materialNames.begin(), it));
+                if (it == out.materialNames.end())
+                    out.materialNames.push_back(std::move(name));
+            }
+            else if (StartsWith(p, lineEnd, "mtllib"))
+            {
+                out.materialLibs.push_back(RestOfLine(p + 6, lineEnd));
+            }
+        }
+
+        line = lineEnd + 1;
+    }
+
+    out.endMaterial = currentMaterial;
+}
+
+void ParseMtl(const std::string &text, std::unordered_map<std::string, MaterialData> &materials)
+{
+    MaterialData *current = nullptr;
+    const char *line = text.data();
+    const char *end = text.data() + text.size();
+    while (line < end)
+    {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        if (!lineEnd)
+            lineEnd = end;
+
+        const char *p = SkipSpace(line, lineEnd);
+        if (StartsWith(p, lineEnd, "newmtl"))
+        {
+            current = &materials[RestOfLine(p + 6, lineEnd)];
+            *current = MaterialData();
+        }
+        else if (current && StartsWith(p, lineEnd, "Kd"))
+        {
+            p = ParseFloat(p + 2, lineEnd, current->diffuse.x);
+            p = ParseFloat(p, lineEnd, current->diffuse.y);
+            ParseFloat(p, lineEnd, current->diffuse.z);
+        }
+        else if (current && StartsWith(p, lineEnd, "Ks"))
+        {
+            p = ParseFloat(p + 2, lineEnd, current->specular.x);
+            p = ParseFloat(p, lineEnd, current->specular.y);
+            ParseFloat(p, lineEnd, current->specular.z);
+        }
+        else if (current && StartsWith(p, lineEnd, "Ns"))
+        {
+            float ns = 0.0f;
+            ParseFloat(p + 2, lineEnd, ns);
+            current->shininess = ns > 0.0f ? ns : 32.0f;
+        }
+
+        line = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Shape being assembled from segments during the sequential merge.
+ */
+struct ShapeBuild
+{
+    std::string name;
+    size_t firstTri = 0;
+    size_t triCount = 0;
+    std::string material;
+    bool hasMaterial = false;
+};
+
+} // namespace
+
+bool ObjLoader::Load(const std::string &fileName, MeshData &outData)
+{
+    MappedFile file;
+    if (!file.Open(fileName))
+        return false;
+
+    std::string baseDir;
+    size_t lastSlash = fileName.find_last_of("/\\");
+    if (lastSlash != std::string::npos)
+    {
+        baseDir = fileName.substr(0, lastSlash + 1);
+    }
+
+    return LoadFromMemory(reinterpret_cast<const char *>(file.GetData()), file.GetSize(), baseDir, outData);
+}
+
+bool ObjLoader::LoadFromMemory(const char *text, size_t size, const std::string &baseDir, MeshData &outData,
+                               size_t chunkBytes)
+{
+    outData = MeshData();
+    ThreadPool &pool = ThreadPool::Shared();
+
+    // Split at line boundaries
+    size_t chunkCount = (std::max)(static_cast<size_t>(1), size / (std::max)(chunkBytes, static_cast<size_t>(1)));
+    std::vector<size_t> bounds(chunkCount + 1, size);
+    bounds[0] = 0;
+    for (size_t c = 1; c < chunkCount; ++c)
+    {
+        size_t pos = (std::max)(bounds[c - 1], (size * c) / chunkCount);
+        const void *newline = pos < size ? std::memchr(text + pos, '\n', size - pos) : nullptr;
+        bounds[c] = newline ? static_cast<size_t>(static_cast<const char *>(newline) - text) + 1 : size;
+    }
+
+    std::vector<ChunkResult> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, [&](size_t c) { ParseChunk(text + bounds[c], text + bounds[c + 1], chunks[c]); });
+
+    // Global numbering: each chunk's attributes follow those of the chunks before it
+    std::vector<size_t> positionBase(chunkCount + 1, 0);
+    std::vector<size_t> normalBase(chunkCount + 1, 0);
+    std::vector<size_t> texcoordBase(chunkCount + 1, 0);
+    std::vector<size_t> triBase(chunkCount + 1, 0);
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        positionBase[c + 1] = positionBase[c] + chunks[c].positions.size() / 3;
+        normalBase[c + 1] = normalBase[c] + chunks[c].normals.size() / 3;
+        texcoordBase[c + 1] = texcoordBase[c] + chunks[c].texcoords.size() / 2;
+        triBase[c + 1] = triBase[c] + chunks[c].triMaterial.size();
+    }
+
+    std::vector<float> positions(positionBase[chunkCount] * 3);
+    std::vector<float> normals(normalBase[chunkCount] * 3);
+    std::vector<float> texcoords(texcoordBase[chunkCount] * 2);
+    pool.ParallelFor(chunkCount,
+                     [&](size_t c)
+                     {
+                         ChunkResult &chunk = chunks[c];
+                         std::copy(chunk.positions.begin(), chunk.positions.end(),
+                                   positions.begin() + static_cast<std::ptrdiff_t>(positionBase[c] * 3));
+                         std::copy(chunk.normals.begin(), chunk.normals.end(),
+                                   normals.begin() + static_cast<std::ptrdiff_t>(normalBase[c] * 3));
+                         std::copy(chunk.texcoords.begin(), chunk.texcoords.end(),
+                                   texcoords.begin() + static_cast<std::ptrdiff_t>(texcoordBase[c] * 2));
+
+                         const size_t bases[3] = {positionBase[c], texcoordBase[c], normalBase[c]};
+                         for (uint32_t fixup : chunk.relativeFixups)
+                         {
+                             Corner &corner = chunk.corners[fixup / 3];
+                             int32_t *component = fixup % 3 == 0 ? &corner.v : (fixup % 3 == 1 ? &corner.vt : &corner.vn);
+                             *component += static_cast<int32_t>(bases[fixup % 3]);
+                         }
+                     });
+
+    // Materials from every referenced library
+    std::unordered_map<std::string, MaterialData> materials;
+    for (const auto &chunk : chunks)
+    {
+        for (const auto &lib : chunk.materialLibs)
+        {
+            std::ifstream mtlFile(baseDir + lib, std::ios::binary);
+            if (mtlFile)
+            {
+                std::string mtlText((std::istreambuf_iterator<char>(mtlFile)), std::istreambuf_iterator<char>());
+                ParseMtl(mtlText, materials);
+            }
+        }
+    }
+
+    // Assemble shapes in file order, carrying the active material and open shape across chunks
+    std::vector<ShapeBuild> shapes;
+    std::string activeMaterial;
+    bool hasActiveMaterial = false;
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        const ChunkResult &chunk = chunks[c];
+        const size_t chunkTris = chunk.triMaterial.size();
+        for (size_t s = 0; s < chunk.segments.size(); ++s)
+        {
+            const Segment &segment = chunk.segments[s];
+            const size_t segmentEnd = s + 1 < chunk.segments.size() ? chunk.segments[s + 1].firstTri : chunkTris;
+
+            if (segment.startsShape || shapes.empty())
+            {
+                ShapeBuild shape;
+                shape.name = segment.name;
+                shape.firstTri = triBase[c] + segment.firstTri;
+                shapes.push_back(shape);
+            }
+
+            ShapeBuild &shape = shapes.back();
+            if (segmentEnd > segment.firstTri && shape.triCount == 0)
+            {
+                int32_t local = chunk.triMaterial[segment.firstTri];
+                if (local >= 0)
+                {
+                    shape.material = chunk.materialNames[static_cast<size_t>(local)];
+                    shape.hasMaterial = true;
+                }
+                else
+                {
+                    shape.material = activeMaterial;
+                    shape.hasMaterial = hasActiveMaterial;
+                }
+            }
+            shape.triCount += segmentEnd - segment.firstTri;
+        }
+
+        if (chunk.endMaterial >= 0)
+        {
+            activeMaterial = chunk.materialNames[static_cast<size_t>(chunk.endMaterial)];
+            hasActiveMaterial = true;
+        }
+    }
+
+    // Emit one vertex per corner, chunks in parallel
+    const size_t totalTris = triBase[chunkCount];
+    outData.vertices.resize(totalTris * 3);
+    outData.indices.resize(totalTris * 3);
+    const size_t positionCount = positions.size() / 3;
+    const size_t normalCount = normals.size() / 3;
+    const size_t texcoordCount = texcoords.size() / 2;
+    pool.ParallelFor(chunkCount,
+                     [&](size_t c)
+                     {
+                         ChunkResult &chunk = chunks[c];
+                         auto position = [&](const Corner &corner)
+                         {
+                             DirectX::XMFLOAT3 p = {};
+                             if (corner.v >= 0 && static_cast<size_t>(corner.v) < positionCount)
+                                 p = {positions[static_cast<size_t>(corner.v) * 3],
+                                      positions[(static_cast<size_t>(corner.v) * 3) + 1],
+                                      positions[(static_cast<size_t>(corner.v) * 3) + 2]};
+                             return p;
+                         };
+
+                         // Split quads along the shorter diagonal, as tinyobjloader does
+                         for (size_t quad : chunk.quads)
+                         {
+                             Corner *tri = &chunk.corners[quad * 3];
+                             const Corner q[4] = {tri[0], tri[1], tri[2], tri[5]};
+                             DirectX::XMFLOAT3 p0 = position(q[0]), p1 = position(q[1]);
+                             DirectX::XMFLOAT3 p2 = position(q[2]), p3 = position(q[3]);
+                             float d02 = ((p2.x - p0.x) * (p2.x - p0.x)) + ((p2.y - p0.y) * (p2.y - p0.y)) +
+                                         ((p2.z - p0.z) * (p2.z - p0.z));
+                             float d13 = ((p3.x - p1.x) * (p3.x - p1.x)) + ((p3.y - p1.y) * (p3.y - p1.y)) +
+                                         ((p3.z - p1.z) * (p3.z - p1.z));
+                             if (d02 >= d13)
+                             {
+                                 const Corner split[6] = {q[0], q[1], q[3], q[1], q[2], q[3]};
+                                 std::copy(split, split + 6, tri);
+                             }
+                         }
+
+                         size_t out = triBase[c] * 3;
+                         for (const Corner &corner : chunk.corners)
+                         {
+                             Vertex vertex = {};
+                             vertex.position = position(corner);
+                             if (corner.vn >= 0 && static_cast<size_t>(corner.vn) < normalCount)
+                             {
+                                 const float *src = &normals[static_cast<size_t>(corner.vn) * 3];
+                                 vertex.normal = {src[0], src[1], src[2]};
+                             }
+                             if (corner.vt >= 0 && static_cast<size_t>(corner.vt) < texcoordCount)
+                             {
+                                 const float *src = &texcoords[static_cast<size_t>(corner.vt) * 2];
+                                 vertex.uv = {src[0], 1.0f - src[1]};
+                             }
+                             outData.vertices[out] = vertex;
+                             outData.indices[out] = static_cast<uint32_t>(out);
+                             ++out;
+                         }
+                     });
+
+    // Shape ranges, bounds centers and materials
+    shapes.erase(std::remove_if(shapes.begin(), shapes.end(), [](const ShapeBuild &s) { return s.triCount == 0; }),
+                 shapes.end());
+    outData.shapes.resize(shapes.size());
+    std::vector<float> shapeMinY(shapes.size(), FLT_MAX);
+    pool.ParallelFor(shapes.size(),
+                     [&](size_t s)
+                     {
+                         const ShapeBuild &build = shapes[s];
+                         ShapeInfo &info = outData.shapes[s];
+                         info.name = build.name;
+                         info.startIndex = static_cast<uint32_t>(build.firstTri * 3);
+                         info.indexCount = static_cast<uint32_t>(build.triCount * 3);
+                         if (build.hasMaterial)
+                         {
+                             auto it = materials.find(build.material);
+                             if (it != materials.end())
+                                 info.material = it->second;
+                         }
+
+                         float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+                         float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+                         for (uint32_t i = info.startIndex; i < info.startIndex + info.indexCount; ++i)
+                         {
+                             const DirectX::XMFLOAT3 &p = outData.vertices[i].position;
+                             minX = (std::min)(minX, p.x);
+                             minY = (std::min)(minY, p.y);
+                             minZ = (std::min)(minZ, p.z);
+                             maxX = (std::max)(maxX, p.x);
+                             maxY = (std::max)(maxY, p.y);
+                             maxZ = (std::max)(maxZ, p.z);
+                         }
+                         info.center = {(minX + maxX) * 0.5f, (minY + maxY) * 0.5f, (minZ + maxZ) * 0.5f};
+                         shapeMinY[s] = minY;
+                     });
+
+    outData.minY = FLT_MAX;
+    for (float y : shapeMinY)
+        outData.minY = (std::min)(outData.minY, y);
+
+    return true;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file ObjLoader.h
+ * @brief Multithreaded Wavefront OBJ/MTL parser producing CPU mesh data.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "MeshData.h"
+
+/**
+ * @class ObjLoader
+ * @brief Native OBJ loader that parses line-aligned chunks of a memory-mapped file in parallel.
+ *
+ * Output matches what Mesh::LoadFromOBJ used to build from tinyobjloader: one shape per
+ * `o`/`g` statement (shapes without faces are dropped), quads split along their shorter
+ * diagonal and larger polygons fan-triangulated, one de-indexed vertex per triangle corner,
+ * V flipped, and each shape taking the material active at its first face.
+ */
+class ObjLoader
+{
+public:
+    /// Smallest chunk handed to a worker; smaller files are parsed on fewer threads.
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 256 * 1024;
+
+    /**
+     * @brief Loads an OBJ file and the MTL libraries it references.
+     *
+     * @param fileName Path to the .obj file; MTL files are resolved relative to its directory.
+     * @param outData Receives vertices, indices, shapes (with materials and centers) and minimum Y.
+     * @return true if the file could be read.
+     */
+    static bool Load(const std::string &fileName, MeshData &outData);
+
+    /**
+     * @brief Parses OBJ text already in memory.
+     *
+     * @param text Start of the OBJ text (need not be null-terminated).
+     * @param size Size of the text in bytes.
+     * @param baseDir Directory prefix used to resolve `mtllib` statements (may be empty).
+     * @param outData Receives the parsed mesh.
+     * @param chunkBytes Minimum chunk size per worker (exposed for tests).
+     * @return true on success.
+     */
+    static bool LoadFromMemory(const char *text, size_t size, const std::string &baseDir, MeshData &outData,
+                               size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+};
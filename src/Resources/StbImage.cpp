@@ -0,0 +1,6 @@
+// The stb implementations live in their own translation unit so that tools built without
+// Direct3D (see VolumetricReference) can link them without Texture.cpp.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
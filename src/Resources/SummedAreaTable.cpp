@@ -0,0 +1,100 @@
+#include "SummedAreaTable.h"
+#include <algorithm>
+#include <cmath>
+#include "../Core/ThreadPool.h"
+
+namespace SummedAreaTable
+{
+
+namespace
+{
+
+/// Columns summed vertically by one task: a cache-friendly run of each row.
+constexpr int COLUMN_BAND = 64;
+
+} // namespace
+
+bool Build(const uint8_t *rgba, int width, int height, int layers, Table &outTable)
+{
+    if (!rgba || width <= 0 || height <= 0 || layers <= 0 ||
+        static_cast<size_t>(width) * static_cast<size_t>(height) > MAX_TEXELS)
+        return false;
+
+    outTable.width = width;
+    outTable.height = height;
+    outTable.layers = layers;
+    outTable.sums.assign(outTable.Index(layers, 0, 0), 0u);
+
+    // Running sums along each row, into entries 1..width of the row below
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(layers) * height,
+                                     [&](size_t row)
+                                     {
+                                         const int layer = static_cast<int>(row / height);
+                                         const int y = static_cast<int>(row % height);
+                                         const uint8_t *src = rgba + (row * width * CHANNELS);
+                                         uint32_t *dst = &outTable.sums[outTable.Index(layer, 1, y + 1)];
+                                         uint32_t running[CHANNELS] = {0u, 0u, 0u, 0u};
+                                         for (int x = 0; x < width; ++x)
+                                         {
+                                             for (int c = 0; c < CHANNELS; ++c)
+                                             {
+                                                 running[c] += src[(x * CHANNELS) + c];
+                                                 dst[(x * CHANNELS) + c] = running[c];
+                                             }
+                                         }
+                                     });
+
+    // Then down each column, a band of columns per task so rows are read in runs
+    const int bands = (width + COLUMN_BAND - 1) / COLUMN_BAND;
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(layers) * bands,
+                                     [&](size_t item)
+                                     {
+                                         const int layer = static_cast<int>(item / bands);
+                                         const int x0 = 1 + (static_cast<int>(item % bands) * COLUMN_BAND);
+                                         const int x1 = (std::min)(x0 + COLUMN_BAND, width + 1);
+                                         const size_t count = static_cast<size_t>(x1 - x0) * CHANNELS;
+                                         for (int y = 2; y <= height; ++y)
+                                         {
+                                             const uint32_t *above = &outTable.sums[outTable.Index(layer, x0, y - 1)];
+                                             uint32_t *row = &outTable.sums[outTable.Index(layer, x0, y)];
+                                             for (size_t i = 0; i < count; ++i)
+                                                 row[i] += above[i];
+                                         }
+                                     });
+    return true;
+}
+
+void BoxSum(const Table &table, int layer, int x0, int y0, int x1, int y1, uint32_t *outSum)
+{
+    x0 = std::clamp(x0, 0, table.width);
+    x1 = std::clamp(x1, 0, table.width);
+    y0 = std::clamp(y0, 0, table.height);
+    y1 = std::clamp(y1, 0, table.height);
+    const uint32_t *s00 = &table.sums[table.Index(layer, x0, y0)];
+    const uint32_t *s10 = &table.sums[table.Index(layer, x1, y0)];
+    const uint32_t *s01 = &table.sums[table.Index(layer, x0, y1)];
+    const uint32_t *s11 = &table.sums[table.Index(layer, x1, y1)];
+
+    // Unsigned arithmetic wraps, so the difference is exact even if the entries overflowed
+    for (int c = 0; c < CHANNELS; ++c)
+        outSum[c] = s11[c] - s10[c] - s01[c] + s00[c];
+}
+
+void FootprintAverage(const Table &table, int layer, float u, float v, float halfWidth, float halfHeight,
+                      float *outAverage)
+{
+    const float cx = u * static_cast<float>(table.width);
+    const float cy = v * static_cast<float>(table.height);
+    const int x0 = static_cast<int>(std::floor(cx - halfWidth + 0.5f));
+    const int y0 = static_cast<int>(std::floor(cy - halfHeight + 0.5f));
+    const int x1 = (std::max)(static_cast<int>(std::floor(cx + halfWidth + 0.5f)), x0 + 1);
+    const int y1 = (std::max)(static_cast<int>(std::floor(cy + halfHeight + 0.5f)), y0 + 1);
+
+    uint32_t sum[CHANNELS];
+    BoxSum(table, layer, x0, y0, x1, y1, sum);
+    const float scale = 1.0f / (255.0f * static_cast<float>(x1 - x0) * static_cast<float>(y1 - y0));
+    for (int c = 0; c < CHANNELS; ++c)
+        outAverage[c] = static_cast<float>(sum[c]) * scale;
+}
+
+} // namespace SummedAreaTable
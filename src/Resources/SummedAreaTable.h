@@ -0,0 +1,99 @@
+/**
+ * @file SummedAreaTable.h
+ * @brief Integer summed-area tables of RGBA8 texture arrays, for box-filtered gobo lookups.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace SummedAreaTable
+ * @brief Per-slice summed-area tables, so the average of any texel rectangle costs four reads.
+ *
+ * Entry (x, y) of a slice holds the sums of every channel over the texels left of x and above
+ * y, so the table is one texel wider and taller than the image and its first row and column
+ * are zero. Sums are stored as 32-bit integers: they are exact, and the difference of four
+ * entries is exact even where the entries wrap around, which a float table loses past 2^24
+ * (a 512 x 512 white gobo already sums to 66.8 million). Images up to MAX_TEXELS texels per
+ * slice fit without wrapping.
+ *
+ * Build() runs on the shared ThreadPool: one task per row for the horizontal prefix sums,
+ * then one per band of columns for the vertical ones.
+ */
+namespace SummedAreaTable
+{
+
+/// Channels per entry, as the RGBA8 source and the R32G32B32A32_UINT texture.
+constexpr int CHANNELS = 4;
+
+/// Largest slice whose full sum of 255s fits in 32 bits.
+constexpr size_t MAX_TEXELS = 0xFFFFFFFFu / 255u;
+
+/**
+ * @struct Table
+ * @brief Summed-area tables of all slices.
+ */
+struct Table
+{
+    int width = 0;  ///< Image width; the table is width + 1 entries wide.
+    int height = 0; ///< Image height; the table is height + 1 entries tall.
+    int layers = 0;
+    std::vector<uint32_t> sums; ///< Slice by slice, row by row, CHANNELS per entry.
+
+    /**
+     * @brief Index of the first channel of entry (x, y) of a slice.
+     */
+    [[nodiscard]] size_t Index(int layer, int x, int y) const
+    {
+        const size_t rowEntries = static_cast<size_t>(width) + 1;
+        return ((((static_cast<size_t>(layer) * (static_cast<size_t>(height) + 1)) + y) * rowEntries) + x) * CHANNELS;
+    }
+};
+
+/**
+ * @brief Builds the tables of an RGBA8 texture array.
+ *
+ * @param rgba layers * height * width * 4 bytes, slice by slice.
+ * @param width Image width.
+ * @param height Image height.
+ * @param layers Number of slices.
+ * @param outTable Receives the tables.
+ * @return False if the input is empty or a slice is larger than MAX_TEXELS.
+ */
+bool Build(const uint8_t *rgba, int width, int height, int layers, Table &outTable);
+
+/**
+ * @brief Sums the texels of a rectangle.
+ *
+ * @param table The tables.
+ * @param layer Slice.
+ * @param x0 First column; the rectangle is clamped to the image.
+ * @param y0 First row.
+ * @param x1 Column past the last one.
+ * @param y1 Row past the last one.
+ * @param outSum Receives CHANNELS sums.
+ */
+void BoxSum(const Table &table, int layer, int x0, int y0, int x1, int y1, uint32_t *outSum);
+
+/**
+ * @brief Averages a footprint the way the volumetric shader does.
+ *
+ * The footprint's corners are rounded to texel edges, keeping at least one texel. Texels
+ * outside the image count as black (border addressing), so the sum is divided by the whole
+ * rectangle's area.
+ *
+ * @param table The tables.
+ * @param layer Slice.
+ * @param u Footprint center, in [0, 1] across the image.
+ * @param v Footprint center, in [0, 1] down the image.
+ * @param halfWidth Half the footprint's width, in texels.
+ * @param halfHeight Half the footprint's height, in texels.
+ * @param outAverage Receives CHANNELS averages in [0, 1].
+ */
+void FootprintAverage(const Table &table, int layer, float u, float v, float halfWidth, float halfHeight,
+                      float *outAverage);
+
+} // namespace SummedAreaTable
@@ -1,7 +1,28 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include "Texture.h"
+#include "SummedAreaTable.h"
+#include "TextureBaker.h"
 #include "stb_image.h"
 
+namespace
+{
+
+DXGI_FORMAT ToDxgiFormat(TextureBaker::Format format)
+{
+    switch (format)
+    {
+    case TextureBaker::Format::BC1:
+        return DXGI_FORMAT_BC1_UNORM_SRGB;
+    case TextureBaker::Format::BC4:
+        return DXGI_FORMAT_BC4_UNORM;
+    case TextureBaker::Format::BC7:
+        return DXGI_FORMAT_BC7_UNORM_SRGB;
+    default:
+        return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    }
+}
+
+} // namespace
+
 Texture::Texture() = default;
 
 bool Texture::LoadFromFile(ID3D11Device *device, const std::string &fileName)
@@ -97,113 +118,151 @@ bool Texture::LoadFromMemory(ID3D11Device *device, const std::vector<uint8_t> &d
     return SUCCEEDED(hr);
 }
 
-bool Texture::CreateTextureArray(ID3D11Device *device, const std::vector<std::vector<uint8_t>> &filesData)
+bool Texture::CreateTextureArray(ID3D11Device *device, const std::vector<std::vector<uint8_t>> &filesData,
+                                 bool summedAreaTable, const std::string &cacheFile)
+{
+    TextureBaker::BakedTexture baked;
+    return TextureBaker::BakeCached(filesData, cacheFile, baked) && CreateFromBaked(device, baked, summedAreaTable);
+}
+
+bool Texture::CreateTextureArray(ID3D11Device *device, const TextureBaker::Image &image, bool summedAreaTable,
+                                 const std::string &cacheFile)
+{
+    TextureBaker::BakedTexture baked;
+    return TextureBaker::BakeCached(image, cacheFile, baked) && CreateFromBaked(device, baked, summedAreaTable);
+}
+
+bool Texture::CreateLayerPool(ID3D11Device *device, int size, int layers, TextureBaker::Format format)
+{
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = static_cast<UINT>(size);
+    desc.Height = static_cast<UINT>(size);
+    desc.MipLevels = static_cast<UINT>(TextureBaker::MipCount(size, size));
+    desc.ArraySize = static_cast<UINT>(layers);
+    desc.Format = ToDxgiFormat(format);
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // Layers start out undefined; the owner fills each one before a light points at it
+    if (FAILED(device->CreateTexture2D(&desc, nullptr, &m_pool)))
+        return false;
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    srvDesc.Texture2DArray.MostDetailedMip = 0;
+    srvDesc.Texture2DArray.MipLevels = desc.MipLevels;
+    srvDesc.Texture2DArray.FirstArraySlice = 0;
+    srvDesc.Texture2DArray.ArraySize = desc.ArraySize;
+    if (FAILED(device->CreateShaderResourceView(m_pool.Get(), &srvDesc, &m_srv)))
+        return false;
+    m_monochrome = format == TextureBaker::Format::BC4;
+    return true;
+}
+
+bool Texture::UpdateLayer(ID3D11DeviceContext *context, int layer, const TextureBaker::BakedTexture &baked)
 {
-    if (filesData.empty())
+    if (!m_pool)
+        return false;
+    D3D11_TEXTURE2D_DESC desc;
+    m_pool->GetDesc(&desc);
+    if (baked.layers != 1 || baked.width != static_cast<int>(desc.Width) ||
+        baked.height != static_cast<int>(desc.Height) || baked.mipLevels != static_cast<int>(desc.MipLevels) ||
+        ToDxgiFormat(baked.format) != desc.Format || layer < 0 || layer >= static_cast<int>(desc.ArraySize))
         return false;
 
-    // Load all images and determine max dimensions
-    struct ImageData
+    for (int mip = 0; mip < baked.mipLevels; ++mip)
     {
-        unsigned char *pixels;
-        int width;
-        int height;
-    };
-    std::vector<ImageData> images;
-    int maxWidth = 0, maxHeight = 0;
-
-    for (const auto &fileData : filesData)
+        const TextureBaker::Subresource &level = baked.Level(0, mip);
+        context->UpdateSubresource(m_pool.Get(), D3D11CalcSubresource(mip, layer, desc.MipLevels), nullptr,
+                                   &baked.data[level.offset], level.rowPitch, level.bytes);
+    }
+    return true;
+}
+
+bool Texture::CreateFromBaked(ID3D11Device *device, const TextureBaker::BakedTexture &baked, bool summedAreaTable)
+{
+    // Create texture array
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = static_cast<UINT>(baked.width);
+    desc.Height = static_cast<UINT>(baked.height);
+    desc.MipLevels = static_cast<UINT>(baked.mipLevels);
+    desc.ArraySize = static_cast<UINT>(baked.layers);
+    desc.Format = ToDxgiFormat(baked.format);
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // One subresource per level of each slice, in D3D11CalcSubresource order
+    std::vector<D3D11_SUBRESOURCE_DATA> subDatas(baked.subresources.size());
+    for (size_t i = 0; i < subDatas.size(); ++i)
     {
-        int w, h, c;
-        unsigned char *pixels =
-            stbi_load_from_memory(fileData.data(), static_cast<int>(fileData.size()), &w, &h, &c, 4);
-        if (pixels)
-        {
-            // Convert transparent pixels to black (gobo mask)
-            for (int i = 0; i < w * h; ++i)
-            {
-                int idx = i * 4;
-                if (pixels[idx + 3] < 128) // Alpha < 50%
-                {
-                    pixels[idx] = 0;     // R
-                    pixels[idx + 1] = 0; // G
-                    pixels[idx + 2] = 0; // B
-                }
-            }
-            images.push_back({pixels, w, h});
-            maxWidth = (std::max)(maxWidth, w);
-            maxHeight = (std::max)(maxHeight, h);
-        }
+        subDatas[i].pSysMem = &baked.data[baked.subresources[i].offset];
+        subDatas[i].SysMemPitch = baked.subresources[i].rowPitch;
+        subDatas[i].SysMemSlicePitch = baked.subresources[i].bytes;
     }
 
-    if (images.empty())
+    ComPtr<ID3D11Texture2D> texture;
+    if (FAILED(device->CreateTexture2D(&desc, subDatas.data(), &texture)))
+        return false;
+
+    // Create SRV for texture array
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    srvDesc.Texture2DArray.MostDetailedMip = 0;
+    srvDesc.Texture2DArray.MipLevels = desc.MipLevels;
+    srvDesc.Texture2DArray.FirstArraySlice = 0;
+    srvDesc.Texture2DArray.ArraySize = desc.ArraySize;
+
+    if (FAILED(device->CreateShaderResourceView(texture.Get(), &srvDesc, &m_srv)))
+        return false;
+    m_monochrome = baked.format == TextureBaker::Format::BC4;
+
+    // The summed-area tables average the top level as the sampler reads it, in linear light
+    if (!summedAreaTable)
+        return true;
+    std::vector<uint8_t> slices;
+    TextureBaker::DecodeLinearSlices(baked, slices);
+    return CreateSummedAreaTable(device, slices, baked.width, baked.height, baked.layers);
+}
+
+bool Texture::CreateSummedAreaTable(ID3D11Device *device, const std::vector<uint8_t> &rgba, int width, int height,
+                                    int layers)
+{
+    SummedAreaTable::Table table;
+    if (!SummedAreaTable::Build(rgba.data(), width, height, layers, table))
         return false;
 
-    // Create texture array
     D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = maxWidth;
-    desc.Height = maxHeight;
+    desc.Width = static_cast<UINT>(width + 1);
+    desc.Height = static_cast<UINT>(height + 1);
     desc.MipLevels = 1;
-    desc.ArraySize = static_cast<UINT>(images.size());
-    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.ArraySize = static_cast<UINT>(layers);
+    desc.Format = DXGI_FORMAT_R32G32B32A32_UINT;
     desc.SampleDesc.Count = 1;
-    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
     desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
-    // Prepare subresource data for each slice
-    std::vector<D3D11_SUBRESOURCE_DATA> subDatas(images.size());
-    std::vector<std::vector<unsigned char>> resizedImages(images.size());
-
-    for (size_t i = 0; i < images.size(); ++i)
+    std::vector<D3D11_SUBRESOURCE_DATA> subDatas(static_cast<size_t>(layers));
+    for (int i = 0; i < layers; ++i)
     {
-        // If image is smaller than max, we need to resize/pad it
-        if (images[i].width != maxWidth || images[i].height != maxHeight)
-        {
-            resizedImages[i].resize(static_cast<size_t>(maxWidth) * static_cast<size_t>(maxHeight) * 4, 0);
-            // Copy centered
-            int offsetX = (maxWidth - images[i].width) / 2;
-            int offsetY = (maxHeight - images[i].height) / 2;
-            for (int y = 0; y < images[i].height; ++y)
-            {
-                for (int x = 0; x < images[i].width; ++x)
-                {
-                    int srcIdx = (y * images[i].width + x) * 4;
-                    int dstIdx = ((y + offsetY) * maxWidth + (x + offsetX)) * 4;
-                    resizedImages[i][static_cast<size_t>(dstIdx)] = images[i].pixels[srcIdx];
-                    resizedImages[i][static_cast<size_t>(dstIdx) + 1] = images[i].pixels[srcIdx + 1];
-                    resizedImages[i][static_cast<size_t>(dstIdx) + 2] = images[i].pixels[srcIdx + 2];
-                    resizedImages[i][static_cast<size_t>(dstIdx) + 3] = images[i].pixels[srcIdx + 3];
-                }
-            }
-            subDatas[i].pSysMem = resizedImages[i].data();
-        }
-        else
-        {
-            subDatas[i].pSysMem = images[i].pixels;
-        }
-        subDatas[i].SysMemPitch = maxWidth * 4;
-        subDatas[i].SysMemSlicePitch = 0;
+        subDatas[static_cast<size_t>(i)].pSysMem = &table.sums[table.Index(i, 0, 0)];
+        subDatas[static_cast<size_t>(i)].SysMemPitch = (width + 1) * SummedAreaTable::CHANNELS * sizeof(uint32_t);
+        subDatas[static_cast<size_t>(i)].SysMemSlicePitch = 0;
     }
 
     ComPtr<ID3D11Texture2D> texture;
-    HRESULT hr = device->CreateTexture2D(&desc, subDatas.data(), &texture);
-
-    // Free loaded images
-    for (auto &img : images)
-        stbi_image_free(img.pixels);
-
-    if (FAILED(hr))
+    if (FAILED(device->CreateTexture2D(&desc, subDatas.data(), &texture)))
         return false;
 
-    // Create SRV for texture array
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Format = desc.Format;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
     srvDesc.Texture2DArray.MostDetailedMip = 0;
     srvDesc.Texture2DArray.MipLevels = 1;
     srvDesc.Texture2DArray.FirstArraySlice = 0;
-    srvDesc.Texture2DArray.ArraySize = static_cast<UINT>(images.size());
-
-    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, &m_srv);
-    return SUCCEEDED(hr);
+    srvDesc.Texture2DArray.ArraySize = static_cast<UINT>(layers);
+    return SUCCEEDED(device->CreateShaderResourceView(texture.Get(), &srvDesc, &m_summedAreaSrv));
 }
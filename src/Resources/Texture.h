@@ -8,6 +8,13 @@
 
 using Microsoft::WRL::ComPtr;
 
+namespace TextureBaker
+{
+enum class Format : uint32_t;
+struct Image;
+struct BakedTexture;
+} // namespace TextureBaker
+
 /**
  * @class Texture
  * @brief Manages the loading and usage of 2D textures.
@@ -50,11 +57,64 @@ public:
     /**
      * @brief Creates a Texture2DArray from multiple images.
      *
+     * The slices are baked by TextureBaker into full mip chains, block compressed as BC4 when
+     * every slice is grey (see IsMonochrome()) or as BC7/BC1 otherwise.
+     *
      * @param device Pointer to the ID3D11Device.
      * @param filesData List of raw file data buffers.
+     * @param summedAreaTable Also build the slices' summed-area tables (see SummedAreaTable),
+     *        for box-filtered lookups through GetSummedAreaSRV().
+     * @param cacheFile Baked texture cache to read, or to write if it is missing or stale;
+     *        empty to always bake.
+     * @return true if creation succeeded.
+     */
+    bool CreateTextureArray(ID3D11Device *device, const std::vector<std::vector<uint8_t>> &filesData,
+                            bool summedAreaTable = false, const std::string &cacheFile = {});
+
+    /**
+     * @brief Creates a Texture2DArray from decoded slices, e.g. a GoboLibrary size class.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param image Slices to bake, all the same size (a multiple of 4).
+     * @param summedAreaTable Also build the slices' summed-area tables.
+     * @param cacheFile Baked texture cache keyed by the slices' pixels; empty to always bake.
+     * @return true if creation succeeded.
+     */
+    bool CreateTextureArray(ID3D11Device *device, const TextureBaker::Image &image, bool summedAreaTable = false,
+                            const std::string &cacheFile = {});
+
+    /**
+     * @brief Creates the immutable array and its view from levels baked beforehand (see
+     * TextureBaker::BakeCached()), and optionally the summed-area tables of its top level.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param baked Every level of every slice.
+     * @param summedAreaTable Also build the slices' summed-area tables.
+     * @return true if creation succeeded.
+     */
+    bool CreateFromBaked(ID3D11Device *device, const TextureBaker::BakedTexture &baked, bool summedAreaTable = false);
+
+    /**
+     * @brief Creates an empty Texture2DArray whose layers are filled one at a time with
+     * UpdateLayer(), e.g. the GoboStreamer pool.
+     *
+     * @param device Pointer to the ID3D11Device.
+     * @param size Width and height of the layers.
+     * @param layers Number of layers.
+     * @param format Storage format; every level down to 1x1 is allocated.
      * @return true if creation succeeded.
      */
-    bool CreateTextureArray(ID3D11Device *device, const std::vector<std::vector<uint8_t>> &filesData);
+    bool CreateLayerPool(ID3D11Device *device, int size, int layers, TextureBaker::Format format);
+
+    /**
+     * @brief Copies every level of a baked slice into a layer of a pool.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     * @param layer Destination layer.
+     * @param baked One slice with the pool's size, format and levels.
+     * @return False if this is not a pool or the slice does not match it.
+     */
+    bool UpdateLayer(ID3D11DeviceContext *context, int layer, const TextureBaker::BakedTexture &baked);
 
     /**
      * @brief Gets the shader resource view of the texture.
@@ -65,6 +125,35 @@ public:
         return m_srv.Get();
     }
 
+    /**
+     * @brief Gets the summed-area tables of a texture array, an R32G32B32A32_UINT array one
+     * texel wider and taller than the texture.
+     * @return Pointer to the ID3D11ShaderResourceView, or nullptr if none was built.
+     */
+    [[nodiscard]] ID3D11ShaderResourceView *GetSummedAreaSRV() const
+    {
+        return m_summedAreaSrv.Get();
+    }
+
+    /**
+     * @brief Checks if a texture array was stored with one channel (BC4), which reads back as
+     * (r, 0, 0, 1): shaders broadcast red instead of using the color.
+     * @return True for monochrome arrays.
+     */
+    [[nodiscard]] bool IsMonochrome() const
+    {
+        return m_monochrome;
+    }
+
 private:
+    /**
+     * @brief Builds the summed-area tables of RGBA8 slices and creates their texture array.
+     */
+    bool CreateSummedAreaTable(ID3D11Device *device, const std::vector<uint8_t> &rgba, int width, int height,
+                               int layers);
+
     ComPtr<ID3D11ShaderResourceView> m_srv;
+    ComPtr<ID3D11ShaderResourceView> m_summedAreaSrv;
+    ComPtr<ID3D11Texture2D> m_pool; ///< Texture behind a layer pool, the target of UpdateLayer().
+    bool m_monochrome = false;
 };
@@ -0,0 +1,1241 @@
+#include "TextureBaker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <utility>
+#include "../Core/Config.h"
+#include "../Core/MappedFile.h"
+#include "../Core/ThreadPool.h"
+#include "../Rendering/Float8.h"
+#include "MeshCache.h"
+#include "stb_image.h"
+
+namespace TextureBaker
+{
+
+namespace
+{
+
+constexpr char CACHE_MAGIC[8] = {'S', 'R', 'T', 'E', 'X', 'C', '\0', '\0'};
+constexpr int BLOCK_SIZE = 4;
+constexpr int BLOCK_TEXELS = BLOCK_SIZE * BLOCK_SIZE;
+constexpr int CHANNELS = 4;
+
+/// Entries of the linear to sRGB table: fine enough that dark values round like the exact curve.
+constexpr int SRGB_ENCODE_STEPS = 65536;
+
+/// BC7 interpolation weights for 4-bit indices, out of 64.
+constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/**
+ * @brief Fixed-size header at the start of a cache file; the levels follow at dataOffset, in
+ * the layout Bake() produces for the same format and size.
+ */
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layers;
+    uint32_t mipLevels;
+    uint64_t key;
+    uint64_t dataOffset;
+    uint64_t dataBytes;
+    uint64_t fileSize;
+};
+
+float SrgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float c)
+{
+    return c <= 0.0031308f ? c * 12.92f : (1.055f * std::pow(c, 1.0f / 2.4f)) - 0.055f;
+}
+
+const float *SrgbDecodeTable()
+{
+    static const std::vector<float> table = []
+    {
+        std::vector<float> values(256);
+        for (int i = 0; i < 256; ++i)
+            values[i] = SrgbToLinear(static_cast<float>(i) / 255.0f);
+        return values;
+    }();
+    return table.data();
+}
+
+const uint8_t *SrgbEncodeTable()
+{
+    static const std::vector<uint8_t> table = []
+    {
+        std::vector<uint8_t> values(SRGB_ENCODE_STEPS);
+        for (int i = 0; i < SRGB_ENCODE_STEPS; ++i)
+        {
+            const float srgb = LinearToSrgb(static_cast<float>(i) / (SRGB_ENCODE_STEPS - 1));
+            values[i] = static_cast<uint8_t>(std::clamp((srgb * 255.0f) + 0.5f, 0.0f, 255.0f));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+uint8_t EncodeSrgb(const uint8_t *table, float linear)
+{
+    return table[static_cast<int>((std::clamp(linear, 0.0f, 1.0f) * (SRGB_ENCODE_STEPS - 1)) + 0.5f)];
+}
+
+uint8_t EncodeLinear(float linear)
+{
+    return static_cast<uint8_t>((std::clamp(linear, 0.0f, 1.0f) * 255.0f) + 0.5f);
+}
+
+bool IsSrgb(Format format)
+{
+    return format != Format::BC4;
+}
+
+bool IsBlockCompressed(Format format)
+{
+    return format != Format::RGBA8;
+}
+
+int BlockBytes(Format format)
+{
+    return format == Format::BC7 ? 16 : 8;
+}
+
+/// Fills the subresource table the way Bake() and the cache lay levels out; returns the data size.
+uint64_t Layout(BakedTexture &texture)
+{
+    const int mipLevels = texture.mipLevels;
+    texture.subresources.assign(static_cast<size_t>(texture.layers) * mipLevels, Subresource());
+    uint64_t offset = 0;
+    for (int layer = 0; layer < texture.layers; ++layer)
+    {
+        for (int mip = 0; mip < mipLevels; ++mip)
+        {
+            Subresource &level =
+                texture.subresources[static_cast<size_t>(mip) + (static_cast<size_t>(layer) * mipLevels)];
+            level.offset = offset;
+            level.width = static_cast<uint32_t>((std::max)(texture.width >> mip, 1));
+            level.height = static_cast<uint32_t>((std::max)(texture.height >> mip, 1));
+            if (IsBlockCompressed(texture.format))
+            {
+                const uint32_t blocksX = (level.width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+                const uint32_t blocksY = (level.height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+                level.rowPitch = blocksX * BlockBytes(texture.format);
+                level.bytes = level.rowPitch * blocksY;
+            }
+            else
+            {
+                level.rowPitch = level.width * CHANNELS;
+                level.bytes = level.rowPitch * level.height;
+            }
+            offset += level.bytes;
+        }
+    }
+    return offset;
+}
+
+/// Gathers a 4x4 block of RGBA8 texels, repeating the last row and column of levels under 4 texels.
+void FetchBlock(const uint8_t *rgba, int width, int height, int bx, int by, uint8_t *block)
+{
+    for (int y = 0; y < BLOCK_SIZE; ++y)
+    {
+        const int sy = (std::min)((by * BLOCK_SIZE) + y, height - 1);
+        for (int x = 0; x < BLOCK_SIZE; ++x)
+        {
+            const int sx = (std::min)((bx * BLOCK_SIZE) + x, width - 1);
+            std::memcpy(block + (((y * BLOCK_SIZE) + x) * CHANNELS),
+                        rgba + ((((static_cast<size_t>(sy) * width) + sx)) * CHANNELS), CHANNELS);
+        }
+    }
+}
+
+/// Principal axis of the block's colors (power iteration on the covariance), and their mean.
+void PrincipalAxis(const float (*colors)[3], int count, float mean[3], float axis[3])
+{
+    mean[0] = mean[1] = mean[2] = 0.0f;
+    for (int i = 0; i < count; ++i)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += colors[i][c];
+    for (int c = 0; c < 3; ++c)
+        mean[c] /= static_cast<float>(count);
+
+    float cov[6] = {};
+    for (int i = 0; i < count; ++i)
+    {
+        const float r = colors[i][0] - mean[0];
+        const float g = colors[i][1] - mean[1];
+        const float b = colors[i][2] - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    axis[0] = axis[1] = axis[2] = 1.0f;
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        const float x = (cov[0] * axis[0]) + (cov[1] * axis[1]) + (cov[2] * axis[2]);
+        const float y = (cov[1] * axis[0]) + (cov[3] * axis[1]) + (cov[4] * axis[2]);
+        const float z = (cov[2] * axis[0]) + (cov[4] * axis[1]) + (cov[5] * axis[2]);
+        const float length = std::sqrt((x * x) + (y * y) + (z * z));
+        if (length < 1e-6f)
+        {
+            axis[0] = axis[1] = axis[2] = 0.0f;
+            return;
+        }
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+}
+
+/// Block colors at the two ends of their spread along the principal axis.
+void AxisEndpoints(const float (*colors)[3], int count, float low[3], float high[3])
+{
+    float mean[3];
+    float axis[3];
+    PrincipalAxis(colors, count, mean, axis);
+    float minT = 0.0f;
+    float maxT = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const float t = ((colors[i][0] - mean[0]) * axis[0]) + ((colors[i][1] - mean[1]) * axis[1]) +
+                        ((colors[i][2] - mean[2]) * axis[2]);
+        minT = (std::min)(minT, t);
+        maxT = (std::max)(maxT, t);
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        low[c] = std::clamp(mean[c] + (minT * axis[c]), 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + (maxT * axis[c]), 0.0f, 255.0f);
+    }
+}
+
+/// Endpoints that best fit the colors for fixed weights, by least squares per channel:
+/// color ~ (1 - w) * low + w * high.
+bool FitEndpoints(const float (*colors)[3], const float *weights, int count, float low[3], float high[3])
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float ap[3] = {};
+    float bp[3] = {};
+    for (int i = 0; i < count; ++i)
+    {
+        const float a = 1.0f - weights[i];
+        const float b = weights[i];
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < 3; ++c)
+        {
+            ap[c] += a * colors[i][c];
+            bp[c] += b * colors[i][c];
+        }
+    }
+    const float det = (aa * bb) - (ab * ab);
+    if (std::fabs(det) < 1e-6f)
+        return false;
+    for (int c = 0; c < 3; ++c)
+    {
+        low[c] = std::clamp(((bb * ap[c]) - (ab * bp[c])) / det, 0.0f, 255.0f);
+        high[c] = std::clamp(((aa * bp[c]) - (ab * ap[c])) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+int SquaredDistance(const int *a, const uint8_t *b)
+{
+    const int dr = a[0] - b[0];
+    const int dg = a[1] - b[1];
+    const int db = a[2] - b[2];
+    return (dr * dr) + (dg * dg) + (db * db);
+}
+
+/// Picks the nearest palette entry for every texel; returns the summed squared error.
+int AssignIndices(const uint8_t *block, const int (*palette)[3], int paletteSize, int *indices)
+{
+    int total = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        int best = std::numeric_limits<int>::max();
+        for (int p = 0; p < paletteSize; ++p)
+        {
+            const int error = SquaredDistance(palette[p], block + (i * CHANNELS));
+            if (error < best)
+            {
+                best = error;
+                indices[i] = p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+void Bc4Palette(int r0, int r1, int *palette)
+{
+    palette[0] = r0;
+    palette[1] = r1;
+    if (r0 > r1)
+    {
+        for (int i = 1; i <= 6; ++i)
+            palette[i + 1] = (((7 - i) * r0) + (i * r1) + 3) / 7;
+    }
+    else
+    {
+        for (int i = 1; i <= 4; ++i)
+            palette[i + 1] = (((5 - i) * r0) + (i * r1) + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+int Bc4Assign(const int *values, int r0, int r1, int *indices)
+{
+    int palette[8];
+    Bc4Palette(r0, r1, palette);
+    int total = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        int best = std::numeric_limits<int>::max();
+        for (int p = 0; p < 8; ++p)
+        {
+            const int d = values[i] - palette[p];
+            if (d * d < best)
+            {
+                best = d * d;
+                indices[i] = p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+/// Tries endpoint pairs inset from (high, low) by up to two steps, in the mode their order selects.
+void Bc4Search(const int *values, int high, int low, bool eightValues, int &bestError, int *bestEndpoints,
+               int *bestIndices)
+{
+    int indices[BLOCK_TEXELS];
+    for (int inHigh = 0; inHigh <= 2; ++inHigh)
+    {
+        for (int inLow = 0; inLow <= 2; ++inLow)
+        {
+            const int h = high - inHigh;
+            const int l = low + inLow;
+            if (h < l || (eightValues && h == l))
+                continue;
+            const int r0 = eightValues ? h : l;
+            const int r1 = eightValues ? l : h;
+            const int error = Bc4Assign(values, r0, r1, indices);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestEndpoints[0] = r0;
+                bestEndpoints[1] = r1;
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+        }
+    }
+}
+
+void EncodeBc4(const uint8_t *block, uint8_t *out)
+{
+    int values[BLOCK_TEXELS];
+    int low = 255;
+    int high = 0;
+    int innerLow = 255;
+    int innerHigh = 0;
+    bool extremes = false;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        values[i] = block[i * CHANNELS];
+        low = (std::min)(low, values[i]);
+        high = (std::max)(high, values[i]);
+        if (values[i] == 0 || values[i] == 255)
+        {
+            extremes = true;
+        }
+        else
+        {
+            innerLow = (std::min)(innerLow, values[i]);
+            innerHigh = (std::max)(innerHigh, values[i]);
+        }
+    }
+
+    int endpoints[2] = {high, low};
+    int indices[BLOCK_TEXELS] = {};
+    if (high != low)
+    {
+        // Eight interpolated values between the extremes, or six between the inner values plus
+        // exact 0 and 255, which suits the anti-aliased edges of masks
+        int bestError = std::numeric_limits<int>::max();
+        Bc4Search(values, high, low, true, bestError, endpoints, indices);
+        if (extremes && innerLow <= innerHigh)
+            Bc4Search(values, innerHigh, innerLow, false, bestError, endpoints, indices);
+    }
+
+    out[0] = static_cast<uint8_t>(endpoints[0]);
+    out[1] = static_cast<uint8_t>(endpoints[1]);
+    uint64_t bits = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+        bits |= static_cast<uint64_t>(indices[i]) << (3 * i);
+    for (int b = 0; b < 6; ++b)
+        out[2 + b] = static_cast<uint8_t>(bits >> (8 * b));
+}
+
+void DecodeBc4(const uint8_t *in, uint8_t *block)
+{
+    int palette[8];
+    Bc4Palette(in[0], in[1], palette);
+    uint64_t bits = 0;
+    for (int b = 0; b < 6; ++b)
+        bits |= static_cast<uint64_t>(in[2 + b]) << (8 * b);
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        const auto value = static_cast<uint8_t>(palette[(bits >> (3 * i)) & 7]);
+        block[i * CHANNELS] = block[(i * CHANNELS) + 1] = block[(i * CHANNELS) + 2] = value;
+        block[(i * CHANNELS) + 3] = 255;
+    }
+}
+
+uint16_t Pack565(const float *color)
+{
+    const int r = static_cast<int>((color[0] * 31.0f / 255.0f) + 0.5f);
+    const int g = static_cast<int>((color[1] * 63.0f / 255.0f) + 0.5f);
+    const int b = static_cast<int>((color[2] * 31.0f / 255.0f) + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void Unpack565(uint16_t packed, int *color)
+{
+    const int r = (packed >> 11) & 31;
+    const int g = (packed >> 5) & 63;
+    const int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+/// Four colors when c0 > c1, else three and black.
+void Bc1Palette(uint16_t c0, uint16_t c1, int (*palette)[3])
+{
+    Unpack565(c0, palette[0]);
+    Unpack565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c)
+    {
+        if (c0 > c1)
+        {
+            palette[2][c] = ((2 * palette[0][c]) + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + (2 * palette[1][c])) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+int Bc1Assign(const uint8_t *block, uint16_t c0, uint16_t c1, int *indices)
+{
+    int palette[4][3];
+    Bc1Palette(c0, c1, palette);
+    return AssignIndices(block, palette, 4, indices);
+}
+
+void EncodeBc1(const uint8_t *block, uint8_t *out)
+{
+    float colors[BLOCK_TEXELS][3];
+    float lit[BLOCK_TEXELS][3];
+    int litCount = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+            colors[i][c] = block[(i * CHANNELS) + c];
+        if (block[i * CHANNELS] + block[(i * CHANNELS) + 1] + block[(i * CHANNELS) + 2] > 24)
+        {
+            std::memcpy(lit[litCount], colors[i], sizeof(colors[i]));
+            ++litCount;
+        }
+    }
+
+    uint16_t best0 = 0;
+    uint16_t best1 = 0;
+    int bestIndices[BLOCK_TEXELS] = {};
+    int bestError = std::numeric_limits<int>::max();
+    int indices[BLOCK_TEXELS];
+    auto consider = [&](uint16_t c0, uint16_t c1)
+    {
+        const int error = Bc1Assign(block, c0, c1, indices);
+        if (error < bestError)
+        {
+            bestError = error;
+            best0 = c0;
+            best1 = c1;
+            std::memcpy(bestIndices, indices, sizeof(indices));
+        }
+        return error;
+    };
+
+    // Four colors along the principal axis, refit once to the chosen indices
+    float low[3];
+    float high[3];
+    AxisEndpoints(colors, BLOCK_TEXELS, low, high);
+    uint16_t c0 = Pack565(high);
+    uint16_t c1 = Pack565(low);
+    if (c0 < c1)
+        std::swap(c0, c1);
+    consider(c0, c1);
+    if (c0 > c1)
+    {
+        static constexpr float WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        float weights[BLOCK_TEXELS];
+        for (int i = 0; i < BLOCK_TEXELS; ++i)
+            weights[i] = WEIGHTS[indices[i]];
+        if (FitEndpoints(colors, weights, BLOCK_TEXELS, high, low))
+        {
+            c0 = Pack565(high);
+            c1 = Pack565(low);
+            if (c0 < c1)
+                std::swap(c0, c1);
+            if (c0 != c1)
+                consider(c0, c1);
+        }
+    }
+
+    // Three colors and black, for blocks where part of the gobo is opaque
+    if (litCount > 0 && litCount < BLOCK_TEXELS)
+    {
+        AxisEndpoints(lit, litCount, low, high);
+        c0 = Pack565(low);
+        c1 = Pack565(high);
+        if (c0 > c1)
+            std::swap(c0, c1);
+        consider(c0, c1);
+    }
+
+    out[0] = static_cast<uint8_t>(best0);
+    out[1] = static_cast<uint8_t>(best0 >> 8);
+    out[2] = static_cast<uint8_t>(best1);
+    out[3] = static_cast<uint8_t>(best1 >> 8);
+    uint32_t bits = 0;
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+        bits |= static_cast<uint32_t>(bestIndices[i]) << (2 * i);
+    for (int b = 0; b < 4; ++b)
+        out[4 + b] = static_cast<uint8_t>(bits >> (8 * b));
+}
+
+void DecodeBc1(const uint8_t *in, uint8_t *block)
+{
+    const auto c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    const auto c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    int palette[4][3];
+    Bc1Palette(c0, c1, palette);
+    const uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        const int index = static_cast<int>((bits >> (2 * i)) & 3);
+        for (int c = 0; c < 3; ++c)
+            block[(i * CHANNELS) + c] = static_cast<uint8_t>(palette[index][c]);
+        block[(i * CHANNELS) + 3] = (c0 <= c1 && index == 3) ? 0 : 255;
+    }
+}
+
+/// Writes bits least significant first, the order of BC7 fields.
+struct BitWriter
+{
+    uint8_t *out;
+    int position = 0;
+
+    void Write(uint32_t value, int count)
+    {
+        for (int i = 0; i < count; ++i, ++position)
+            if ((value >> i) & 1u)
+                out[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+    }
+};
+
+struct BitReader
+{
+    const uint8_t *in;
+    int position = 0;
+
+    uint32_t Read(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i, ++position)
+            value |= static_cast<uint32_t>((in[position >> 3] >> (position & 7)) & 1u) << i;
+        return value;
+    }
+};
+
+/// Rounds an RGB endpoint to 7 bits per channel plus the shared p-bit, whichever p fits best.
+void QuantizeBc7Endpoint(const float *color, int *quantized, int &pBit)
+{
+    int bestError = std::numeric_limits<int>::max();
+    for (int p = 0; p <= 1; ++p)
+    {
+        int error = 0;
+        int q[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            const float target = c < 3 ? color[c] : 255.0f;
+            q[c] = std::clamp(static_cast<int>(std::lround((target - static_cast<float>(p)) / 2.0f)), 0, 127);
+            const int d = ((q[c] << 1) | p) - static_cast<int>(std::lround(target));
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            pBit = p;
+            std::memcpy(quantized, q, sizeof(q));
+        }
+    }
+}
+
+void Bc7Palette(const int *e0, int p0, const int *e1, int p1, int (*palette)[3])
+{
+    for (int w = 0; w < 16; ++w)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            const int a = (e0[c] << 1) | p0;
+            const int b = (e1[c] << 1) | p1;
+            palette[w][c] = (((64 - BC7_WEIGHTS[w]) * a) + (BC7_WEIGHTS[w] * b) + 32) >> 6;
+        }
+    }
+}
+
+void EncodeBc7(const uint8_t *block, uint8_t *out)
+{
+    float colors[BLOCK_TEXELS][3];
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+        for (int c = 0; c < 3; ++c)
+            colors[i][c] = block[(i * CHANNELS) + c];
+
+    float low[3];
+    float high[3];
+    AxisEndpoints(colors, BLOCK_TEXELS, low, high);
+
+    int best0[4] = {};
+    int best1[4] = {};
+    int bestP0 = 0;
+    int bestP1 = 0;
+    int bestIndices[BLOCK_TEXELS] = {};
+    int bestError = std::numeric_limits<int>::max();
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        int e0[4];
+        int e1[4];
+        int p0 = 0;
+        int p1 = 0;
+        QuantizeBc7Endpoint(low, e0, p0);
+        QuantizeBc7Endpoint(high, e1, p1);
+        int palette[16][3];
+        Bc7Palette(e0, p0, e1, p1, palette);
+        int indices[BLOCK_TEXELS];
+        const int error = AssignIndices(block, palette, 16, indices);
+        if (error < bestError)
+        {
+            bestError = error;
+            std::memcpy(best0, e0, sizeof(e0));
+            std::memcpy(best1, e1, sizeof(e1));
+            bestP0 = p0;
+            bestP1 = p1;
+            std::memcpy(bestIndices, indices, sizeof(indices));
+        }
+        if (bestError == 0)
+            break;
+
+        // Refit the endpoints to the weights just chosen
+        float weights[BLOCK_TEXELS];
+        for (int i = 0; i < BLOCK_TEXELS; ++i)
+            weights[i] = static_cast<float>(BC7_WEIGHTS[indices[i]]) / 64.0f;
+        if (!FitEndpoints(colors, weights, BLOCK_TEXELS, low, high))
+            break;
+    }
+
+    // The first index has an implicit zero high bit: flip the endpoints if it would be set
+    if (bestIndices[0] >= 8)
+    {
+        std::swap(best0, best1);
+        std::swap(bestP0, bestP1);
+        for (int &index : bestIndices)
+            index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.Write(1u << 6, 7);
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.Write(static_cast<uint32_t>(best0[c]), 7);
+        writer.Write(static_cast<uint32_t>(best1[c]), 7);
+    }
+    writer.Write(static_cast<uint32_t>(bestP0), 1);
+    writer.Write(static_cast<uint32_t>(bestP1), 1);
+    writer.Write(static_cast<uint32_t>(bestIndices[0]), 3);
+    for (int i = 1; i < BLOCK_TEXELS; ++i)
+        writer.Write(static_cast<uint32_t>(bestIndices[i]), 4);
+}
+
+/// Decodes mode 6 blocks, the only mode EncodeBc7() writes; other modes come back black.
+void DecodeBc7(const uint8_t *in, uint8_t *block)
+{
+    std::memset(block, 0, BLOCK_TEXELS * CHANNELS);
+    BitReader reader{in};
+    if (reader.Read(7) != (1u << 6))
+        return;
+
+    int e[2][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        e[0][c] = static_cast<int>(reader.Read(7));
+        e[1][c] = static_cast<int>(reader.Read(7));
+    }
+    const int p0 = static_cast<int>(reader.Read(1));
+    const int p1 = static_cast<int>(reader.Read(1));
+    int palette[16][3];
+    Bc7Palette(e[0], p0, e[1], p1, palette);
+    for (int i = 0; i < BLOCK_TEXELS; ++i)
+    {
+        const int index = static_cast<int>(reader.Read(i == 0 ? 3 : 4));
+        for (int c = 0; c < 3; ++c)
+            block[(i * CHANNELS) + c] = static_cast<uint8_t>(palette[index][c]);
+        const int a = (((64 - BC7_WEIGHTS[index]) * ((e[0][3] << 1) | p0)) +
+                       (BC7_WEIGHTS[index] * ((e[1][3] << 1) | p1)) + 32) >> 6;
+        block[(i * CHANNELS) + 3] = static_cast<uint8_t>(a);
+    }
+}
+
+/// Linear RGBA float level to the texels a format stores: sRGB, or linear grey for BC4.
+void StoreTexels(const std::vector<float> &level, Format format, std::vector<uint8_t> &rgba)
+{
+    const uint8_t *table = SrgbEncodeTable();
+    const size_t texels = level.size() / CHANNELS;
+    rgba.resize(level.size());
+    for (size_t i = 0; i < texels; ++i)
+    {
+        const float *src = &level[i * CHANNELS];
+        uint8_t *dst = &rgba[i * CHANNELS];
+        if (IsSrgb(format))
+        {
+            for (int c = 0; c < 3; ++c)
+                dst[c] = EncodeSrgb(table, src[c]);
+        }
+        else
+        {
+            dst[0] = dst[1] = dst[2] = EncodeLinear((src[0] + src[1] + src[2]) / 3.0f);
+        }
+        dst[3] = 255;
+    }
+}
+
+} // namespace
+
+bool DecodeSlices(const std::vector<std::vector<uint8_t>> &filesData, Image &outImage)
+{
+    std::vector<Image> decoded;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    for (const auto &fileData : filesData)
+    {
+        Image image;
+        if (!DecodeImage(fileData, image))
+            continue;
+        maxWidth = (std::max)(maxWidth, image.width);
+        maxHeight = (std::max)(maxHeight, image.height);
+        decoded.push_back(std::move(image));
+    }
+    if (decoded.empty())
+        return false;
+
+    // Whole blocks, so the slices can be block compressed; smaller images are centered
+    outImage.width = (maxWidth + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    outImage.height = (maxHeight + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    outImage.layers = static_cast<int>(decoded.size());
+    outImage.rgba.assign(static_cast<size_t>(outImage.width) * outImage.height * CHANNELS * decoded.size(), 0);
+    for (size_t i = 0; i < decoded.size(); ++i)
+        CopyCentered(decoded[i], outImage, static_cast<int>(i));
+    return true;
+}
+
+bool DecodeImage(const std::vector<uint8_t> &fileData, Image &outImage)
+{
+    int w, h, c;
+    unsigned char *pixels =
+        stbi_load_from_memory(fileData.data(), static_cast<int>(fileData.size()), &w, &h, &c, CHANNELS);
+    if (!pixels)
+        return false;
+
+    // Convert transparent pixels to black (gobo mask)
+    for (int i = 0; i < w * h; ++i)
+    {
+        if (pixels[(i * CHANNELS) + 3] < 128)
+            pixels[i * CHANNELS] = pixels[(i * CHANNELS) + 1] = pixels[(i * CHANNELS) + 2] = 0;
+    }
+    outImage.width = w;
+    outImage.height = h;
+    outImage.layers = 1;
+    outImage.rgba.assign(pixels, pixels + (static_cast<size_t>(w) * h * CHANNELS));
+    stbi_image_free(pixels);
+    return true;
+}
+
+void CopyCentered(const Image &src, Image &dst, int layer)
+{
+    const int offsetX = (dst.width - src.width) / 2;
+    const int offsetY = (dst.height - src.height) / 2;
+    const size_t sliceBytes = static_cast<size_t>(dst.width) * dst.height * CHANNELS;
+    for (int y = 0; y < src.height; ++y)
+    {
+        const size_t row = ((static_cast<size_t>(y) + offsetY) * dst.width) + offsetX;
+        std::memcpy(&dst.rgba[(static_cast<size_t>(layer) * sliceBytes) + (row * CHANNELS)],
+                    &src.rgba[static_cast<size_t>(y) * src.width * CHANNELS],
+                    static_cast<size_t>(src.width) * CHANNELS);
+    }
+}
+
+void ShrinkToFit(Image &image, int maxSize)
+{
+    if (image.width <= maxSize && image.height <= maxSize)
+        return;
+
+    std::vector<std::vector<float>> levels;
+    BuildMipChain(image, 0, levels);
+    int mip = 0;
+    while (image.width > maxSize || image.height > maxSize)
+    {
+        image.width = (std::max)(image.width / 2, 1);
+        image.height = (std::max)(image.height / 2, 1);
+        ++mip;
+    }
+
+    const uint8_t *encode = SrgbEncodeTable();
+    const std::vector<float> &level = levels[static_cast<size_t>(mip)];
+    const size_t texels = static_cast<size_t>(image.width) * image.height;
+    image.layers = 1;
+    image.rgba.resize(texels * CHANNELS);
+    for (size_t i = 0; i < texels; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+            image.rgba[(i * CHANNELS) + c] = EncodeSrgb(encode, level[(i * CHANNELS) + c]);
+        image.rgba[(i * CHANNELS) + 3] = 255;
+    }
+}
+
+Format ChooseFormat(const Image &image)
+{
+    if (!Config::Gobo::COMPRESS)
+        return Format::RGBA8;
+
+    const size_t texels = image.rgba.size() / CHANNELS;
+    for (size_t i = 0; i < texels; ++i)
+    {
+        const uint8_t *texel = &image.rgba[i * CHANNELS];
+        const int spread = (std::max)({texel[0], texel[1], texel[2]}) - (std::min)({texel[0], texel[1], texel[2]});
+        if (spread > Config::Gobo::MONO_TOLERANCE)
+            return Config::Gobo::COLOR_BC7 ? Format::BC7 : Format::BC1;
+    }
+    return Format::BC4;
+}
+
+int MipCount(int width, int height)
+{
+    int levels = 1;
+    while (width > 1 || height > 1)
+    {
+        width = (std::max)(width / 2, 1);
+        height = (std::max)(height / 2, 1);
+        ++levels;
+    }
+    return levels;
+}
+
+uint64_t BakedSize(Format format, int width, int height, int layers)
+{
+    BakedTexture texture;
+    texture.format = format;
+    texture.width = width;
+    texture.height = height;
+    texture.layers = layers;
+    texture.mipLevels = MipCount(width, height);
+    return Layout(texture);
+}
+
+void Downsample(const float *src, int width, int height, float *dst)
+{
+    const int dstWidth = (std::max)(width / 2, 1);
+    const int dstHeight = (std::max)(height / 2, 1);
+    const int nextColumn = width > 1 ? CHANNELS : 0;
+    const size_t rowFloats = static_cast<size_t>(width) * CHANNELS;
+    const Simd::Float8 quarter = Simd::Set1(0.25f);
+    for (int y = 0; y < dstHeight; ++y)
+    {
+        const float *row0 = src + (static_cast<size_t>(2 * y) * rowFloats);
+        const float *row1 = height > 1 ? row0 + rowFloats : row0;
+        float *out = dst + (static_cast<size_t>(y) * dstWidth * CHANNELS);
+
+        // Two output texels from four source texels of each row: add the rows, then each pair
+        int x = 0;
+        for (; x + 2 <= dstWidth; x += 2)
+        {
+            const float *a = row0 + (static_cast<size_t>(x) * 2 * CHANNELS);
+            const float *b = row1 + (static_cast<size_t>(x) * 2 * CHANNELS);
+            const Simd::Float8 left = Simd::Load(a) + Simd::Load(b);
+            const Simd::Float8 right = Simd::Load(a + Simd::LANES) + Simd::Load(b + Simd::LANES);
+            Simd::Store(out + (static_cast<size_t>(x) * CHANNELS), Simd::SumHalves(left, right) * quarter);
+        }
+        for (; x < dstWidth; ++x)
+        {
+            const size_t texel = static_cast<size_t>(x) * 2 * CHANNELS;
+            for (int c = 0; c < CHANNELS; ++c)
+                out[(x * CHANNELS) + c] = 0.25f * (row0[texel + c] + row0[texel + nextColumn + c] + row1[texel + c] +
+                                                   row1[texel + nextColumn + c]);
+        }
+    }
+}
+
+void BuildMipChain(const Image &image, int layer, std::vector<std::vector<float>> &outLevels)
+{
+    const int mipLevels = MipCount(image.width, image.height);
+    outLevels.resize(static_cast<size_t>(mipLevels));
+
+    const float *decode = SrgbDecodeTable();
+    const size_t texels = static_cast<size_t>(image.width) * image.height;
+    const uint8_t *src = &image.rgba[static_cast<size_t>(layer) * texels * CHANNELS];
+    outLevels[0].resize(texels * CHANNELS);
+    for (size_t i = 0; i < texels; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+            outLevels[0][(i * CHANNELS) + c] = decode[src[(i * CHANNELS) + c]];
+        outLevels[0][(i * CHANNELS) + 3] = 1.0f;
+    }
+
+    int width = image.width;
+    int height = image.height;
+    for (int mip = 1; mip < mipLevels; ++mip)
+    {
+        const int nextWidth = (std::max)(width / 2, 1);
+        const int nextHeight = (std::max)(height / 2, 1);
+        outLevels[mip].resize(static_cast<size_t>(nextWidth) * nextHeight * CHANNELS);
+        Downsample(outLevels[mip - 1].data(), width, height, outLevels[mip].data());
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+bool Bake(const Image &image, Format format, BakedTexture &outTexture)
+{
+    if (image.width <= 0 || image.height <= 0 || image.layers <= 0 ||
+        image.rgba.size() != static_cast<size_t>(image.width) * image.height * image.layers * CHANNELS)
+        return false;
+    if (IsBlockCompressed(format) && ((image.width % BLOCK_SIZE) != 0 || (image.height % BLOCK_SIZE) != 0))
+        return false;
+
+    outTexture.format = format;
+    outTexture.width = image.width;
+    outTexture.height = image.height;
+    outTexture.layers = image.layers;
+    outTexture.mipLevels = MipCount(image.width, image.height);
+    outTexture.data.assign(Layout(outTexture), 0);
+
+    // Mip chains in linear light, one task per slice, then stored as the format's texels
+    const int mipLevels = outTexture.mipLevels;
+    std::vector<std::vector<uint8_t>> texels(outTexture.subresources.size());
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(image.layers),
+                                     [&](size_t layer)
+                                     {
+                                         std::vector<std::vector<float>> levels;
+                                         BuildMipChain(image, static_cast<int>(layer), levels);
+                                         for (int mip = 0; mip < mipLevels; ++mip)
+                                             StoreTexels(levels[mip], format, texels[mip + (layer * mipLevels)]);
+                                     });
+
+    if (!IsBlockCompressed(format))
+    {
+        for (size_t s = 0; s < texels.size(); ++s)
+            std::memcpy(&outTexture.data[outTexture.subresources[s].offset], texels[s].data(), texels[s].size());
+        return true;
+    }
+
+    // One task per row of blocks, over every level of every slice
+    struct BlockRow
+    {
+        size_t subresource;
+        int row;
+    };
+    std::vector<BlockRow> rows;
+    for (size_t s = 0; s < outTexture.subresources.size(); ++s)
+    {
+        const int blocksY = static_cast<int>((outTexture.subresources[s].height + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        for (int row = 0; row < blocksY; ++row)
+            rows.push_back({s, row});
+    }
+
+    const int blockBytes = BlockBytes(format);
+    ThreadPool::Shared().ParallelFor(
+        rows.size(),
+        [&](size_t item)
+        {
+            const BlockRow &row = rows[item];
+            const Subresource &level = outTexture.subresources[row.subresource];
+            const int width = static_cast<int>(level.width);
+            const int height = static_cast<int>(level.height);
+            uint8_t *out = &outTexture.data[level.offset + (static_cast<size_t>(row.row) * level.rowPitch)];
+            uint8_t block[BLOCK_TEXELS * CHANNELS];
+            for (int bx = 0; bx < (width + BLOCK_SIZE - 1) / BLOCK_SIZE; ++bx, out += blockBytes)
+            {
+                FetchBlock(texels[row.subresource].data(), width, height, bx, row.row, block);
+                if (format == Format::BC4)
+                    EncodeBc4(block, out);
+                else if (format == Format::BC1)
+                    EncodeBc1(block, out);
+                else
+                    EncodeBc7(block, out);
+            }
+        });
+    return true;
+}
+
+void DecodeLevel(const BakedTexture &texture, int layer, int mip, std::vector<uint8_t> &outRgba)
+{
+    const Subresource &level = texture.Level(layer, mip);
+    const uint8_t *src = &texture.data[level.offset];
+    outRgba.resize(static_cast<size_t>(level.width) * level.height * CHANNELS);
+    if (!IsBlockCompressed(texture.format))
+    {
+        std::memcpy(outRgba.data(), src, outRgba.size());
+        return;
+    }
+
+    const int blockBytes = BlockBytes(texture.format);
+    const int blocksX = static_cast<int>((level.width + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    const int blocksY = static_cast<int>((level.height + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    uint8_t block[BLOCK_TEXELS * CHANNELS];
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            const uint8_t *in =
+                src + (static_cast<size_t>(by) * level.rowPitch) + (static_cast<size_t>(bx) * blockBytes);
+            if (texture.format == Format::BC4)
+                DecodeBc4(in, block);
+            else if (texture.format == Format::BC1)
+                DecodeBc1(in, block);
+            else
+                DecodeBc7(in, block);
+
+            for (int y = 0; y < BLOCK_SIZE && (by * BLOCK_SIZE) + y < static_cast<int>(level.height); ++y)
+            {
+                for (int x = 0; x < BLOCK_SIZE && (bx * BLOCK_SIZE) + x < static_cast<int>(level.width); ++x)
+                {
+                    const size_t dst = ((static_cast<size_t>((by * BLOCK_SIZE) + y) * level.width) +
+                                        (bx * BLOCK_SIZE) + x) * CHANNELS;
+                    std::memcpy(&outRgba[dst], block + (((y * BLOCK_SIZE) + x) * CHANNELS), CHANNELS);
+                }
+            }
+        }
+    }
+}
+
+void DecodeLinearSlices(const BakedTexture &texture, std::vector<uint8_t> &outRgba)
+{
+    const float *decode = SrgbDecodeTable();
+    const size_t sliceBytes = static_cast<size_t>(texture.width) * texture.height * CHANNELS;
+    outRgba.resize(sliceBytes * texture.layers);
+    std::vector<uint8_t> slice;
+    for (int layer = 0; layer < texture.layers; ++layer)
+    {
+        DecodeLevel(texture, layer, 0, slice);
+        if (IsSrgb(texture.format))
+        {
+            for (size_t i = 0; i < slice.size(); ++i)
+                if ((i % CHANNELS) != 3)
+                    slice[i] = EncodeLinear(decode[slice[i]]);
+        }
+        std::memcpy(&outRgba[layer * sliceBytes], slice.data(), sliceBytes);
+    }
+}
+
+double MeasurePsnr(const Image &image, const BakedTexture &texture, int layer, int mip)
+{
+    const float *decode = SrgbDecodeTable();
+    double squaredError = 0.0;
+    size_t count = 0;
+    std::vector<std::vector<float>> levels;
+    std::vector<uint8_t> rgba;
+    for (int l = (layer < 0 ? 0 : layer); l < (layer < 0 ? texture.layers : layer + 1); ++l)
+    {
+        BuildMipChain(image, l, levels);
+        for (int m = (mip < 0 ? 0 : mip); m < (mip < 0 ? texture.mipLevels : mip + 1); ++m)
+        {
+            DecodeLevel(texture, l, m, rgba);
+            for (size_t i = 0; i < rgba.size(); ++i)
+            {
+                if ((i % CHANNELS) == 3)
+                    continue;
+                const float value = IsSrgb(texture.format) ? decode[rgba[i]] : static_cast<float>(rgba[i]) / 255.0f;
+                const double d = static_cast<double>(value) - levels[m][i];
+                squaredError += d * d;
+                ++count;
+            }
+        }
+    }
+    if (count == 0 || squaredError == 0.0)
+        return std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(static_cast<double>(count) / squaredError);
+}
+
+uint64_t CacheKey(const std::vector<std::vector<uint8_t>> &filesData)
+{
+    std::vector<uint64_t> hashes = {CACHE_VERSION, static_cast<uint64_t>(Config::Gobo::MONO_TOLERANCE),
+                                    Config::Gobo::COMPRESS ? 1u : 0u, Config::Gobo::COLOR_BC7 ? 1u : 0u};
+    for (const auto &fileData : filesData)
+        hashes.push_back(MeshCache::HashBytes(fileData.data(), fileData.size()));
+    return MeshCache::HashBytes(reinterpret_cast<const uint8_t *>(hashes.data()), hashes.size() * sizeof(uint64_t));
+}
+
+uint64_t CacheKey(const Image &image)
+{
+    const uint64_t hashes[] = {CACHE_VERSION,
+                               static_cast<uint64_t>(Config::Gobo::MONO_TOLERANCE),
+                               Config::Gobo::COMPRESS ? 1u : 0u,
+                               Config::Gobo::COLOR_BC7 ? 1u : 0u,
+                               static_cast<uint64_t>(image.width),
+                               static_cast<uint64_t>(image.height),
+                               static_cast<uint64_t>(image.layers),
+                               MeshCache::HashBytes(image.rgba.data(), image.rgba.size())};
+    return MeshCache::HashBytes(reinterpret_cast<const uint8_t *>(hashes), sizeof(hashes));
+}
+
+std::string GetCachePath(const std::string &sourceFile)
+{
+    return sourceFile + ".texcache";
+}
+
+bool WriteCache(const std::string &cacheFile, uint64_t key, const BakedTexture &texture)
+{
+    FileHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.width = static_cast<uint32_t>(texture.width);
+    header.height = static_cast<uint32_t>(texture.height);
+    header.layers = static_cast<uint32_t>(texture.layers);
+    header.mipLevels = static_cast<uint32_t>(texture.mipLevels);
+    header.key = key;
+    header.dataOffset = sizeof(FileHeader);
+    header.dataBytes = texture.data.size();
+    header.fileSize = header.dataOffset + header.dataBytes;
+
+    const std::string tempFile = cacheFile + ".tmp";
+    {
+        std::ofstream out(tempFile, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(texture.data.data()),
+                  static_cast<std::streamsize>(texture.data.size()));
+        if (!out)
+        {
+            out.close();
+            std::remove(tempFile.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, cacheFile, error);
+    if (error)
+    {
+        std::filesystem::remove(tempFile, error);
+        return false;
+    }
+    return true;
+}
+
+bool ReadCache(const std::string &cacheFile, uint64_t key, BakedTexture &outTexture)
+{
+    MappedFile file;
+    if (!file.Open(cacheFile) || file.GetSize() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.key != key || header.fileSize != file.GetSize() || header.format > static_cast<uint32_t>(Format::BC7) ||
+        header.width == 0 || header.height == 0 || header.layers == 0 || header.width > 16384 ||
+        header.height > 16384 || header.layers > 2048 || header.dataOffset != sizeof(FileHeader) ||
+        header.dataBytes != header.fileSize - header.dataOffset)
+        return false;
+    if (IsBlockCompressed(static_cast<Format>(header.format)) &&
+        ((header.width % BLOCK_SIZE) != 0 || (header.height % BLOCK_SIZE) != 0))
+        return false;
+
+    BakedTexture texture;
+    texture.format = static_cast<Format>(header.format);
+    texture.width = static_cast<int>(header.width);
+    texture.height = static_cast<int>(header.height);
+    texture.layers = static_cast<int>(header.layers);
+    texture.mipLevels = MipCount(texture.width, texture.height);
+    if (header.mipLevels != static_cast<uint32_t>(texture.mipLevels))
+        return false;
+
+    // The levels are where Bake() would put them, so the layout only needs the sizes to agree
+    if (Layout(texture) != header.dataBytes)
+        return false;
+    texture.data.assign(file.GetData() + header.dataOffset, file.GetData() + header.fileSize);
+    outTexture = std::move(texture);
+    return true;
+}
+
+bool BakeCached(const std::vector<std::vector<uint8_t>> &filesData, const std::string &cacheFile,
+                BakedTexture &outTexture)
+{
+    if (filesData.empty())
+        return false;
+
+    // Baked levels from the cache when the sources and settings are unchanged, else decode and bake
+    const uint64_t key = cacheFile.empty() ? 0 : CacheKey(filesData);
+    if (!cacheFile.empty() && ReadCache(cacheFile, key, outTexture))
+        return true;
+    Image image;
+    if (!DecodeSlices(filesData, image) || !Bake(image, ChooseFormat(image), outTexture))
+        return false;
+    if (!cacheFile.empty())
+        WriteCache(cacheFile, key, outTexture);
+    return true;
+}
+
+bool BakeCached(const Image &image, const std::string &cacheFile, BakedTexture &outTexture)
+{
+    if (image.layers == 0)
+        return false;
+
+    const uint64_t key = cacheFile.empty() ? 0 : CacheKey(image);
+    if (!cacheFile.empty() && ReadCache(cacheFile, key, outTexture))
+        return true;
+    if (!Bake(image, ChooseFormat(image), outTexture))
+        return false;
+    if (!cacheFile.empty())
+        WriteCache(cacheFile, key, outTexture);
+    return true;
+}
+
+} // namespace TextureBaker
@@ -0,0 +1,276 @@
+/**
+ * @file TextureBaker.h
+ * @brief Mip chains and BC1/BC4/BC7 block compression of gobo texture arrays, with a disk cache.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace TextureBaker
+ * @brief Turns decoded gobo images into the mip levels a texture array is created from.
+ *
+ * Gobo images are sRGB like any PNG. Mips are averaged in linear light: each level is a 2x2
+ * box of the one above, computed on linear floats with Float8 (odd sizes drop the last row or
+ * column). The levels are then stored in one of four formats, chosen per array since a
+ * Texture2DArray has a single format:
+ * - BC4: one channel, for arrays whose slices are all grey (the usual gobo masks). Stored in
+ *   linear light, as BC4 has no sRGB variant; the texture reads back (r, 0, 0, 1), so shaders
+ *   broadcast red.
+ * - BC7 or BC1: color arrays, stored as sRGB and decoded to linear by the sampler. The BC7
+ *   encoder only writes mode 6 (one endpoint pair with 4-bit weights per block).
+ * - RGBA8: uncompressed sRGB levels, when compression is turned off.
+ *
+ * Block encoding runs on the shared ThreadPool, one task per row of blocks across every level
+ * and slice. A baked texture can be written to a cache file keyed by a hash of the source
+ * images and the bake settings, so later runs skip decoding and encoding.
+ */
+namespace TextureBaker
+{
+
+/// Bump whenever the cache layout or the baking that produced it changes.
+constexpr uint32_t CACHE_VERSION = 1;
+
+/**
+ * @brief Storage format of a baked texture.
+ */
+enum class Format : uint32_t
+{
+    RGBA8 = 0, ///< R8G8B8A8_UNORM_SRGB, 4 bytes per texel.
+    BC1 = 1,   ///< BC1_UNORM_SRGB, 8 bytes per 4x4 block.
+    BC4 = 2,   ///< BC4_UNORM (linear), 8 bytes per 4x4 block.
+    BC7 = 3    ///< BC7_UNORM_SRGB, 16 bytes per 4x4 block.
+};
+
+/**
+ * @struct Image
+ * @brief Decoded slices of a texture array, all the same size.
+ */
+struct Image
+{
+    int width = 0;
+    int height = 0;
+    int layers = 0;
+    std::vector<uint8_t> rgba; ///< Slice by slice, row by row, 4 bytes per texel (sRGB).
+};
+
+/**
+ * @struct Subresource
+ * @brief One mip level of one slice inside BakedTexture::data.
+ */
+struct Subresource
+{
+    uint64_t offset = 0; ///< Byte offset into the data.
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowPitch = 0; ///< Bytes per row of texels, or of blocks for the BC formats.
+    uint32_t bytes = 0;
+};
+
+/**
+ * @struct BakedTexture
+ * @brief A texture array ready for upload: every level of every slice in one buffer.
+ */
+struct BakedTexture
+{
+    Format format = Format::RGBA8;
+    int width = 0;
+    int height = 0;
+    int layers = 0;
+    int mipLevels = 0;
+    std::vector<Subresource> subresources; ///< Index mip + layer * mipLevels, as D3D11CalcSubresource.
+    std::vector<uint8_t> data;
+
+    /**
+     * @brief Gets a level of a slice.
+     */
+    [[nodiscard]] const Subresource &Level(int layer, int mip) const
+    {
+        return subresources[static_cast<size_t>(mip) + (static_cast<size_t>(layer) * mipLevels)];
+    }
+};
+
+/**
+ * @brief Decodes image files (PNG, JPG, TGA...) into equally sized slices.
+ *
+ * Texels under 50% alpha become black, as a gobo is a mask. Smaller images are centered on a
+ * black slice as large as the largest one, rounded up to whole 4x4 blocks. Files that fail to
+ * decode are skipped.
+ *
+ * @param filesData Raw file data, one per slice.
+ * @param outImage Receives the slices.
+ * @return False if no file could be decoded.
+ */
+bool DecodeSlices(const std::vector<std::vector<uint8_t>> &filesData, Image &outImage);
+
+/**
+ * @brief Decodes one image file at its own size, with texels under 50% alpha made black.
+ *
+ * @param fileData Raw file data.
+ * @param outImage Receives a single slice.
+ * @return False if the file could not be decoded.
+ */
+bool DecodeImage(const std::vector<uint8_t> &fileData, Image &outImage);
+
+/**
+ * @brief Copies the first slice of an image to the center of a slice of a larger one; the
+ * texels around it are left as they are.
+ *
+ * @param src Source image, no larger than the destination.
+ * @param dst Destination image.
+ * @param layer Destination slice.
+ */
+void CopyCentered(const Image &src, Image &dst, int layer);
+
+/**
+ * @brief Halves an image in linear light, as its mips are, until it fits a square.
+ *
+ * @param image Image to shrink in place; only its first slice is kept.
+ * @param maxSize Largest width and height.
+ */
+void ShrinkToFit(Image &image, int maxSize);
+
+/**
+ * @brief Picks the format for an array from Config::Gobo: BC4 if every texel of every slice is
+ * grey within MONO_TOLERANCE, else BC7 or BC1; RGBA8 if compression is off.
+ */
+Format ChooseFormat(const Image &image);
+
+/**
+ * @brief Number of levels in a full mip chain down to 1x1.
+ */
+int MipCount(int width, int height);
+
+/**
+ * @brief Bytes of a baked texture: every level of every slice, as Bake() lays them out.
+ */
+uint64_t BakedSize(Format format, int width, int height, int layers);
+
+/**
+ * @brief Builds the mip chain of one slice in linear light.
+ *
+ * @param image Source slices.
+ * @param layer Slice to build.
+ * @param outLevels Receives one buffer per level, 4 linear floats per texel.
+ */
+void BuildMipChain(const Image &image, int layer, std::vector<std::vector<float>> &outLevels);
+
+/**
+ * @brief Halves a linear RGBA level with a 2x2 box.
+ *
+ * @param src width * height * 4 floats.
+ * @param width Source width.
+ * @param height Source height.
+ * @param dst Receives max(width / 2, 1) * max(height / 2, 1) * 4 floats.
+ */
+void Downsample(const float *src, int width, int height, float *dst);
+
+/**
+ * @brief Builds the mip chains of all slices and stores them in a format.
+ *
+ * @param image Source slices; the size must be a multiple of 4 for the BC formats.
+ * @param format Storage format.
+ * @param outTexture Receives the levels.
+ * @return False if the image is empty or not block aligned.
+ */
+bool Bake(const Image &image, Format format, BakedTexture &outTexture);
+
+/**
+ * @brief Decodes a level of a slice back to RGBA8, as the sampler reads it but before the sRGB
+ * decode (BC4 comes back grey).
+ *
+ * @param texture Baked texture.
+ * @param layer Slice.
+ * @param mip Level.
+ * @param outRgba Receives width * height * 4 bytes.
+ */
+void DecodeLevel(const BakedTexture &texture, int layer, int mip, std::vector<uint8_t> &outRgba);
+
+/**
+ * @brief Decodes the top level of every slice to linear RGBA8, the input of the gobo
+ * summed-area tables.
+ *
+ * @param texture Baked texture.
+ * @param outRgba Receives layers * height * width * 4 bytes.
+ */
+void DecodeLinearSlices(const BakedTexture &texture, std::vector<uint8_t> &outRgba);
+
+/**
+ * @brief Peak signal-to-noise ratio of baked texels against the exact linear mips.
+ *
+ * Both sides are compared in linear light over red, green and blue, as the shaders see them,
+ * so the figure includes the 8-bit rounding as well as the block compression.
+ *
+ * @param image Source slices the texture was baked from.
+ * @param texture Baked texture.
+ * @param layer Slice, or -1 for all of them.
+ * @param mip Level, or -1 for all of them.
+ * @return PSNR in dB (infinite if exact).
+ */
+double MeasurePsnr(const Image &image, const BakedTexture &texture, int layer, int mip);
+
+/**
+ * @brief Hashes the source files and the bake settings, the key of a cache file.
+ */
+uint64_t CacheKey(const std::vector<std::vector<uint8_t>> &filesData);
+
+/**
+ * @brief Hashes decoded slices and the bake settings, the key of a cache file for images that
+ * do not come straight from files (e.g. a GoboLibrary size class).
+ */
+uint64_t CacheKey(const Image &image);
+
+/**
+ * @brief Gets the cache file path used for a source file.
+ * @param sourceFile Path to the file the images come from (e.g. the GDTF).
+ * @return Source path with a ".texcache" suffix.
+ */
+std::string GetCachePath(const std::string &sourceFile);
+
+/**
+ * @brief Writes a cache file, under a temporary name renamed into place.
+ *
+ * @param cacheFile Destination path.
+ * @param key Key from CacheKey().
+ * @param texture Baked texture.
+ * @return true if the file was written.
+ */
+bool WriteCache(const std::string &cacheFile, uint64_t key, const BakedTexture &texture);
+
+/**
+ * @brief Reads a cache file if it is well-formed and was baked with the same key.
+ *
+ * @param cacheFile Path to the cache.
+ * @param key Key from CacheKey().
+ * @param outTexture Receives the levels.
+ * @return true if the cache was used.
+ */
+bool ReadCache(const std::string &cacheFile, uint64_t key, BakedTexture &outTexture);
+
+/**
+ * @brief Reads the cache, or decodes the files, bakes them in ChooseFormat() and writes the
+ * cache: the CPU half of Texture::CreateTextureArray().
+ *
+ * @param filesData Raw image files, one slice each.
+ * @param cacheFile Cache path; empty to always bake.
+ * @param outTexture Receives the levels.
+ * @return False if the files do not decode.
+ */
+bool BakeCached(const std::vector<std::vector<uint8_t>> &filesData, const std::string &cacheFile,
+                BakedTexture &outTexture);
+
+/**
+ * @brief Reads the cache, or bakes decoded slices in ChooseFormat() and writes the cache.
+ *
+ * @param image Slices, all the same size (a multiple of 4).
+ * @param cacheFile Cache path; empty to always bake.
+ * @param outTexture Receives the levels.
+ * @return False if the image is empty.
+ */
+bool BakeCached(const Image &image, const std::string &cacheFile, BakedTexture &outTexture);
+
+} // namespace TextureBaker
@@ -0,0 +1,134 @@
+#include "ClusterCuller.h"
+#include <algorithm>
+#include <cmath>
+#include "../Core/ThreadPool.h"
+#include "OcclusionBuffer.h"
+
+namespace ClusterCuller
+{
+
+namespace
+{
+
+/// Clusters per parallel work item; small meshes are culled on the calling thread.
+constexpr size_t CHUNK_SIZE = 256;
+
+DirectX::XMFLOAT4 NormalizePlane(float a, float b, float c, float d)
+{
+    const float length = std::sqrt((a * a) + (b * b) + (c * c));
+    if (length <= 0.0f)
+        return {0.0f, 0.0f, 0.0f, 1.0f};
+    return {a / length, b / length, c / length, d / length};
+}
+
+} // namespace
+
+Frustum MakeFrustum(DirectX::FXMMATRIX world, DirectX::CXMMATRIX viewProj, const DirectX::XMFLOAT3 &worldEye)
+{
+    // Planes of the combined matrix bound the volume in the space its input is in (Gribb-Hartmann)
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, world * viewProj);
+
+    Frustum frustum;
+    frustum.worldViewProj = m;
+    frustum.planes[0] = NormalizePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+    frustum.planes[1] = NormalizePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+    frustum.planes[2] = NormalizePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+    frustum.planes[3] = NormalizePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+    frustum.planes[4] = NormalizePlane(m._13, m._23, m._33, m._43); // D3D depth starts at 0
+    frustum.planes[5] = NormalizePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+
+    DirectX::XMMATRIX toMesh = DirectX::XMMatrixInverse(nullptr, world);
+    DirectX::XMStoreFloat3(&frustum.eye,
+                           DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&worldEye), toMesh));
+    return frustum;
+}
+
+int Classify(const MeshCluster &cluster, const Frustum &frustum, bool backfaceCulling, const OcclusionBuffer *occlusion)
+{
+    const DirectX::XMFLOAT4 &s = cluster.sphere;
+    for (const auto &p : frustum.planes)
+    {
+        if ((p.x * s.x) + (p.y * s.y) + (p.z * s.z) + p.w < -s.w)
+            return 1;
+    }
+
+    // Every triangle faces away when the eye lies inside the cone's back-facing region
+    // (bounded cone test from meshoptimizer's meshopt_Meshlet cone data)
+    const DirectX::XMFLOAT4 &c = cluster.cone;
+    if (backfaceCulling && c.w < 1.0f)
+    {
+        const float dx = s.x - frustum.eye.x;
+        const float dy = s.y - frustum.eye.y;
+        const float dz = s.z - frustum.eye.z;
+        const float distance = std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+        if ((dx * c.x) + (dy * c.y) + (dz * c.z) >= (c.w * distance) + s.w)
+            return 2;
+    }
+
+    if (occlusion && !occlusion->IsSphereVisible(s, DirectX::XMLoadFloat4x4(&frustum.worldViewProj)))
+        return 3;
+    return 0;
+}
+
+Stats Cull(const std::vector<MeshCluster> &clusters, const Frustum &frustum, std::vector<ClusterRange> &outRanges,
+           bool backfaceCulling, const OcclusionBuffer *occlusion)
+{
+    Stats stats;
+    stats.clusters = clusters.size();
+    outRanges.clear();
+    if (clusters.empty())
+        return stats;
+
+    std::vector<uint8_t> results(clusters.size());
+    auto cullChunk = [&](size_t chunk)
+    {
+        const size_t end = (std::min)(clusters.size(), (chunk + 1) * CHUNK_SIZE);
+        for (size_t i = chunk * CHUNK_SIZE; i < end; ++i)
+            results[i] = static_cast<uint8_t>(Classify(clusters[i], frustum, backfaceCulling, occlusion));
+    };
+
+    const size_t chunkCount = (clusters.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (chunkCount > 1)
+        ThreadPool::Shared().ParallelFor(chunkCount, cullChunk);
+    else
+        cullChunk(0);
+
+    // Compaction runs in cluster order, so the output does not depend on scheduling
+    for (size_t i = 0; i < clusters.size(); ++i)
+    {
+        const MeshCluster &cluster = clusters[i];
+        stats.triangles += cluster.indexCount / 3;
+        if (results[i] == 1)
+        {
+            ++stats.frustumCulled;
+            continue;
+        }
+        if (results[i] == 2)
+        {
+            ++stats.backfaceCulled;
+            continue;
+        }
+        if (results[i] == 3)
+        {
+            ++stats.occlusionCulled;
+            continue;
+        }
+
+        ++stats.visibleClusters;
+        if (!outRanges.empty() && outRanges.back().shape == cluster.shape &&
+            cluster.startIndex - (outRanges.back().startIndex + outRanges.back().indexCount) <= MERGE_GAP * 3)
+        {
+            outRanges.back().indexCount = cluster.startIndex + cluster.indexCount - outRanges.back().startIndex;
+        }
+        else
+        {
+            outRanges.push_back({cluster.shape, cluster.startIndex, cluster.indexCount});
+        }
+    }
+    for (const auto &range : outRanges)
+        stats.submittedTriangles += range.indexCount / 3;
+    return stats;
+}
+
+} // namespace ClusterCuller
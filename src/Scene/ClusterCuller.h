@@ -0,0 +1,94 @@
+/**
+ * @file ClusterCuller.h
+ * @brief Multithreaded frustum, back-face and occlusion culling of mesh clusters.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Resources/MeshData.h"
+
+class OcclusionBuffer;
+
+/**
+ * @namespace ClusterCuller
+ * @brief Rejects clusters that a camera or light cannot see and emits the surviving index ranges.
+ *
+ * All tests run in the mesh's own space, so cluster bounds never need transforming. Results
+ * depend only on the inputs: clusters are tested in parallel but compacted in order.
+ */
+namespace ClusterCuller
+{
+
+/// Culled runs up to this many triangles between two visible clusters are drawn anyway,
+/// since one more draw call costs more than a few hidden triangles.
+constexpr uint32_t MERGE_GAP = 16;
+
+/**
+ * @struct Frustum
+ * @brief View volume and eye position expressed in mesh space.
+ */
+struct Frustum
+{
+    DirectX::XMFLOAT4 planes[6] = {}; ///< Inward-facing normalized planes (left, right, bottom, top, near, far).
+    DirectX::XMFLOAT3 eye = {0.0f, 0.0f, 0.0f}; ///< Viewpoint, for back-face tests.
+    DirectX::XMFLOAT4X4 worldViewProj = {};      ///< Mesh-to-clip matrix, for occlusion tests.
+};
+
+/**
+ * @struct Stats
+ * @brief Counts gathered by one Cull() call.
+ */
+struct Stats
+{
+    size_t clusters = 0;           ///< Clusters tested.
+    size_t visibleClusters = 0;    ///< Clusters kept.
+    size_t frustumCulled = 0;      ///< Clusters outside the frustum.
+    size_t backfaceCulled = 0;     ///< Clusters facing entirely away from the eye.
+    size_t occlusionCulled = 0;    ///< Clusters hidden behind occluders.
+    size_t triangles = 0;          ///< Triangles in all clusters.
+    size_t submittedTriangles = 0; ///< Triangles in the kept clusters.
+};
+
+/**
+ * @brief Builds a mesh-space frustum for a camera or light.
+ *
+ * @param world Mesh world matrix.
+ * @param viewProj View-projection matrix (row-vector convention, not transposed).
+ * @param worldEye Camera or light position in world space.
+ * @return Frustum usable with clusters in mesh space.
+ */
+Frustum MakeFrustum(DirectX::FXMMATRIX world, DirectX::CXMMATRIX viewProj, const DirectX::XMFLOAT3 &worldEye);
+
+/**
+ * @brief Tests whether a cluster may contribute visible triangles.
+ *
+ * @param cluster Cluster with mesh-space bounds.
+ * @param frustum Mesh-space frustum.
+ * @param backfaceCulling False for passes that draw both faces.
+ * @param occlusion Finished occlusion buffer for the same view, or nullptr to skip the test.
+ * @return 0 when visible, 1 when outside the frustum, 2 when back-facing, 3 when occluded.
+ */
+int Classify(const MeshCluster &cluster, const Frustum &frustum, bool backfaceCulling = true,
+             const OcclusionBuffer *occlusion = nullptr);
+
+/**
+ * @brief Culls clusters and writes the visible ones as compacted index ranges.
+ *
+ * Neighbouring visible clusters of the same shape are merged into a single range. Ranges are
+ * ordered by shape, then index.
+ *
+ * @param clusters Clusters from ClusterBuilder::Build().
+ * @param frustum Mesh-space frustum.
+ * @param outRanges Receives the visible ranges (cleared first).
+ * @param backfaceCulling False for passes that draw both faces.
+ * @param occlusion Finished occlusion buffer for the same view, or nullptr to skip the test.
+ * @return Cluster and triangle counts.
+ */
+Stats Cull(const std::vector<MeshCluster> &clusters, const Frustum &frustum, std::vector<ClusterRange> &outRanges,
+           bool backfaceCulling = true, const OcclusionBuffer *occlusion = nullptr);
+
+} // namespace ClusterCuller
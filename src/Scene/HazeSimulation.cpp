@@ -0,0 +1,406 @@
+#include "HazeSimulation.h"
+#include <algorithm>
+#include <cmath>
+#include "../Core/ThreadPool.h"
+
+namespace
+{
+
+/// Runs body(z) for every z slice of the box, one task per slice.
+template <typename F> void ForSlices(int size, F &&body)
+{
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(size),
+                                     [&](size_t slice) { body(static_cast<int>(slice) + 1); });
+}
+
+/// Component of a world-space vector along one axis.
+float Axis(const DirectX::XMFLOAT3 &v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+} // namespace
+
+HazeSimulation::HazeSimulation(int size, const DirectX::XMFLOAT3 &boundsMin, const DirectX::XMFLOAT3 &boundsMax)
+    : m_size((std::max)(size, 2)), m_boundsMin(boundsMin)
+{
+    m_cellSize = {(boundsMax.x - boundsMin.x) / static_cast<float>(m_size),
+                  (boundsMax.y - boundsMin.y) / static_cast<float>(m_size),
+                  (boundsMax.z - boundsMin.z) / static_cast<float>(m_size)};
+    const size_t cells = Index(0, 0, m_size + 2);
+    for (int c = 0; c < 3; ++c)
+    {
+        m_velocity[c].resize(cells);
+        m_scratch[c].resize(cells);
+    }
+    m_pressure.resize(cells);
+    m_divergence.resize(cells);
+    m_density.resize(cells);
+    Reset();
+}
+
+void HazeSimulation::Reset()
+{
+    for (int c = 0; c < 3; ++c)
+        std::fill(m_velocity[c].begin(), m_velocity[c].end(), 0.0f);
+    std::fill(m_pressure.begin(), m_pressure.end(), 0.0f);
+    std::fill(m_density.begin(), m_density.end(), Config::Haze::INITIAL_DENSITY);
+    m_carry = 0.0f;
+    ++m_version;
+}
+
+int HazeSimulation::Update(float deltaTime)
+{
+    if (!m_enabled)
+        return 0;
+
+    const float tick = 1.0f / Config::Haze::TICK_RATE;
+    m_carry += deltaTime;
+    int ticks = 0;
+    while (m_carry >= tick && ticks < Config::Haze::MAX_TICKS_PER_UPDATE)
+    {
+        Step(tick);
+        m_carry -= tick;
+        ++ticks;
+    }
+    m_carry = std::fmod(m_carry, tick);
+    return ticks;
+}
+
+void HazeSimulation::Step(float dt)
+{
+    // Velocity: self-advection from the old field, viscosity, forces, projection
+    Advect(m_scratch, m_velocity, 3, dt);
+    for (int c = 0; c < 3; ++c)
+        m_velocity[c].swap(m_scratch[c]);
+    for (int c = 0; c < 3; ++c)
+        Diffuse(m_velocity[c], Config::Haze::VISCOSITY, dt, c + 1);
+    AddForces(dt);
+    Project();
+
+    // Haze: carried by the new velocity, spread, put out and lost
+    Advect(m_scratch, &m_density, 1, dt);
+    m_density.swap(m_scratch[0]);
+    Diffuse(m_density, Config::Haze::DIFFUSION, dt, 0);
+    Emit(dt);
+    if (m_dissipation > 0.0f)
+    {
+        const float keep = std::exp(-m_dissipation * dt);
+        for (float &d : m_density)
+            d *= keep;
+    }
+    ++m_version;
+}
+
+template <typename F> void HazeSimulation::ForSphere(const DirectX::XMFLOAT3 &center, float radius, F &&visit) const
+{
+    if (!(radius > 0.0f))
+        return;
+
+    // Cell i's center is at boundsMin + (i - 0.5) * cellSize
+    int lo[3];
+    int hi[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float c = (Axis(center, axis) - Axis(m_boundsMin, axis)) / Axis(m_cellSize, axis) + 0.5f;
+        const float r = radius / Axis(m_cellSize, axis);
+        lo[axis] = (std::max)(static_cast<int>(std::ceil(c - r)), 1);
+        hi[axis] = (std::min)(static_cast<int>(std::floor(c + r)), m_size);
+    }
+    for (int z = lo[2]; z <= hi[2]; ++z)
+    {
+        for (int y = lo[1]; y <= hi[1]; ++y)
+        {
+            for (int x = lo[0]; x <= hi[0]; ++x)
+            {
+                const float dx = m_boundsMin.x + ((static_cast<float>(x) - 0.5f) * m_cellSize.x) - center.x;
+                const float dy = m_boundsMin.y + ((static_cast<float>(y) - 0.5f) * m_cellSize.y) - center.y;
+                const float dz = m_boundsMin.z + ((static_cast<float>(z) - 0.5f) * m_cellSize.z) - center.z;
+                const float weight = 1.0f - (std::sqrt((dx * dx) + (dy * dy) + (dz * dz)) / radius);
+                if (weight > 0.0f)
+                    visit(Index(x, y, z), weight);
+            }
+        }
+    }
+}
+
+void HazeSimulation::AddForces(float dt)
+{
+    for (const Fan &fan : m_fans)
+    {
+        ForSphere(fan.position, fan.radius,
+                  [&](size_t i, float weight)
+                  {
+                      for (int c = 0; c < 3; ++c)
+                          m_velocity[c][i] += Axis(fan.direction, c) * fan.thrust * dt * weight / Axis(m_cellSize, c);
+                  });
+    }
+    for (const Emitter &emitter : m_emitters)
+    {
+        ForSphere(emitter.position, emitter.radius,
+                  [&](size_t i, float weight)
+                  {
+                      for (int c = 0; c < 3; ++c)
+                      {
+                          const float target = Axis(emitter.direction, c) * emitter.speed / Axis(m_cellSize, c);
+                          m_velocity[c][i] += (target - m_velocity[c][i]) * weight;
+                      }
+                  });
+    }
+    for (int c = 0; c < 3; ++c)
+        SetBoundary(m_velocity[c], c + 1);
+}
+
+void HazeSimulation::Emit(float dt)
+{
+    const float cellVolume = m_cellSize.x * m_cellSize.y * m_cellSize.z;
+    for (const Emitter &emitter : m_emitters)
+    {
+        // The output is spread so that exactly rate * dt is added, even over a few cells
+        float weights = 0.0f;
+        ForSphere(emitter.position, emitter.radius, [&](size_t, float weight) { weights += weight; });
+        const float amount = emitter.rate * dt / cellVolume;
+        if (weights > 0.0f)
+        {
+            ForSphere(emitter.position, emitter.radius,
+                      [&](size_t i, float weight) { m_density[i] += amount * weight / weights; });
+            continue;
+        }
+
+        // Smaller than a cell: all of it goes to the cell containing the nozzle
+        int cell[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float g = (Axis(emitter.position, axis) - Axis(m_boundsMin, axis)) / Axis(m_cellSize, axis);
+            cell[axis] = std::clamp(static_cast<int>(std::floor(g)) + 1, 1, m_size);
+        }
+        m_density[Index(cell[0], cell[1], cell[2])] += amount;
+    }
+    SetBoundary(m_density, 0);
+}
+
+void HazeSimulation::Project()
+{
+    const int n = m_size;
+    std::vector<float> &u = m_velocity[0];
+    std::vector<float> &v = m_velocity[1];
+    std::vector<float> &w = m_velocity[2];
+    const size_t dy = Index(0, 1, 0);
+    const size_t dz = Index(0, 0, 1);
+
+    // Poisson equation on the unit grid: laplacian(p) = div(velocity)
+    ForSlices(n,
+              [&](int z)
+              {
+                  for (int y = 1; y <= n; ++y)
+                  {
+                      const size_t row = Index(0, y, z);
+                      for (int x = 1; x <= n; ++x)
+                      {
+                          const size_t i = row + x;
+                          m_divergence[i] = -0.5f * ((u[i + 1] - u[i - 1]) + (v[i + dy] - v[i - dy]) +
+                                                     (w[i + dz] - w[i - dz]));
+                      }
+                  }
+              });
+    SetBoundary(m_divergence, 0);
+
+    std::vector<float> &next = m_scratch[2];
+    for (int iteration = 0; iteration < Config::Haze::PRESSURE_ITERATIONS; ++iteration)
+    {
+        ForSlices(n,
+                  [&](int z)
+                  {
+                      for (int y = 1; y <= n; ++y)
+                      {
+                          const size_t row = Index(0, y, z);
+                          for (int x = 1; x <= n; ++x)
+                          {
+                              const size_t i = row + x;
+                              next[i] = (m_divergence[i] + m_pressure[i - 1] + m_pressure[i + 1] + m_pressure[i - dy] +
+                                         m_pressure[i + dy] + m_pressure[i - dz] + m_pressure[i + dz]) *
+                                        (1.0f / 6.0f);
+                          }
+                      }
+                  });
+        SetBoundary(next, 0);
+        m_pressure.swap(next);
+    }
+
+    ForSlices(n,
+              [&](int z)
+              {
+                  for (int y = 1; y <= n; ++y)
+                  {
+                      const size_t row = Index(0, y, z);
+                      for (int x = 1; x <= n; ++x)
+                      {
+                          const size_t i = row + x;
+                          u[i] -= 0.5f * (m_pressure[i + 1] - m_pressure[i - 1]);
+                          v[i] -= 0.5f * (m_pressure[i + dy] - m_pressure[i - dy]);
+                          w[i] -= 0.5f * (m_pressure[i + dz] - m_pressure[i - dz]);
+                      }
+                  }
+              });
+    for (int c = 0; c < 3; ++c)
+        SetBoundary(m_velocity[c], c + 1);
+}
+
+void HazeSimulation::Advect(std::vector<float> *dst, const std::vector<float> *src, int fields, float dt) const
+{
+    const int n = m_size;
+    const float lo = 0.5f;
+    const float hi = static_cast<float>(n) + 0.5f;
+    const size_t dy = Index(0, 1, 0);
+    const size_t dz = Index(0, 0, 1);
+    const std::vector<float> &u = m_velocity[0];
+    const std::vector<float> &v = m_velocity[1];
+    const std::vector<float> &w = m_velocity[2];
+    ForSlices(n,
+              [&](int z)
+              {
+                  for (int y = 1; y <= n; ++y)
+                  {
+                      const size_t row = Index(0, y, z);
+                      for (int x = 1; x <= n; ++x)
+                      {
+                          // Trace back, then one set of trilinear weights for every field
+                          const size_t i = row + x;
+                          const float px = std::clamp(static_cast<float>(x) - (dt * u[i]), lo, hi);
+                          const float py = std::clamp(static_cast<float>(y) - (dt * v[i]), lo, hi);
+                          const float pz = std::clamp(static_cast<float>(z) - (dt * w[i]), lo, hi);
+                          const int x0 = static_cast<int>(px);
+                          const int y0 = static_cast<int>(py);
+                          const int z0 = static_cast<int>(pz);
+                          const float tx = px - static_cast<float>(x0);
+                          const float ty = py - static_cast<float>(y0);
+                          const float tz = pz - static_cast<float>(z0);
+                          const size_t c000 = Index(x0, y0, z0);
+                          for (int f = 0; f < fields; ++f)
+                          {
+                              const float *s = src[f].data() + c000;
+                              const float s00 = s[0] + (tx * (s[1] - s[0]));
+                              const float s10 = s[dy] + (tx * (s[dy + 1] - s[dy]));
+                              const float s01 = s[dz] + (tx * (s[dz + 1] - s[dz]));
+                              const float s11 = s[dy + dz] + (tx * (s[dy + dz + 1] - s[dy + dz]));
+                              const float s0 = s00 + (ty * (s10 - s00));
+                              const float s1 = s01 + (ty * (s11 - s01));
+                              dst[f][i] = s0 + (tz * (s1 - s0));
+                          }
+                      }
+                  }
+              });
+    for (int f = 0; f < fields; ++f)
+        SetBoundary(dst[f], fields == 3 ? f + 1 : 0);
+}
+
+void HazeSimulation::Diffuse(std::vector<float> &field, float rate, float dt, int boundary)
+{
+    if (!(rate > 0.0f))
+        return;
+
+    // (1 - dt * rate * laplacian) field = source, with the laplacian scaled per axis
+    const int n = m_size;
+    const float ax = dt * rate / (m_cellSize.x * m_cellSize.x);
+    const float ay = dt * rate / (m_cellSize.y * m_cellSize.y);
+    const float az = dt * rate / (m_cellSize.z * m_cellSize.z);
+    const float scale = 1.0f / (1.0f + (2.0f * (ax + ay + az)));
+    const size_t dy = Index(0, 1, 0);
+    const size_t dz = Index(0, 0, 1);
+    std::vector<float> &source = m_scratch[1];
+    std::vector<float> &next = m_scratch[2];
+    source = field;
+    for (int iteration = 0; iteration < Config::Haze::DIFFUSION_ITERATIONS; ++iteration)
+    {
+        ForSlices(n,
+                  [&](int z)
+                  {
+                      for (int y = 1; y <= n; ++y)
+                      {
+                          const size_t row = Index(0, y, z);
+                          for (int x = 1; x <= n; ++x)
+                          {
+                              const size_t i = row + x;
+                              next[i] = (source[i] + (ax * (field[i - 1] + field[i + 1])) +
+                                         (ay * (field[i - dy] + field[i + dy])) +
+                                         (az * (field[i - dz] + field[i + dz]))) *
+                                        scale;
+                          }
+                      }
+                  });
+        SetBoundary(next, boundary);
+        field.swap(next);
+    }
+}
+
+void HazeSimulation::SetBoundary(std::vector<float> &field, int boundary) const
+{
+    // x walls, then y walls over the x ghosts, then z walls over both: edges and corners are
+    // filled from cells that are already set
+    const int n = m_size;
+    const float sx = boundary == 1 ? -1.0f : 1.0f;
+    const float sy = boundary == 2 ? -1.0f : 1.0f;
+    const float sz = boundary == 3 ? -1.0f : 1.0f;
+    for (int z = 1; z <= n; ++z)
+    {
+        for (int y = 1; y <= n; ++y)
+        {
+            field[Index(0, y, z)] = sx * field[Index(1, y, z)];
+            field[Index(n + 1, y, z)] = sx * field[Index(n, y, z)];
+        }
+        for (int x = 0; x <= n + 1; ++x)
+        {
+            field[Index(x, 0, z)] = sy * field[Index(x, 1, z)];
+            field[Index(x, n + 1, z)] = sy * field[Index(x, n, z)];
+        }
+    }
+    for (int y = 0; y <= n + 1; ++y)
+    {
+        for (int x = 0; x <= n + 1; ++x)
+        {
+            field[Index(x, y, 0)] = sz * field[Index(x, y, 1)];
+            field[Index(x, y, n + 1)] = sz * field[Index(x, y, n)];
+        }
+    }
+}
+
+float HazeSimulation::SampleDensity(const DirectX::XMFLOAT3 &position) const
+{
+    // Grid coordinates where cell i's center is at i, clamped to the box's cell centers
+    float g[3];
+    int g0[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        g[axis] = (Axis(position, axis) - Axis(m_boundsMin, axis)) / Axis(m_cellSize, axis) + 0.5f;
+        g[axis] = std::clamp(g[axis], 1.0f, static_cast<float>(m_size));
+        g0[axis] = (std::min)(static_cast<int>(g[axis]), m_size - 1);
+        g[axis] -= static_cast<float>(g0[axis]);
+    }
+
+    float result = 0.0f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const int bx = corner & 1;
+        const int by = (corner >> 1) & 1;
+        const int bz = (corner >> 2) & 1;
+        const float weight = (bx ? g[0] : 1.0f - g[0]) * (by ? g[1] : 1.0f - g[1]) * (bz ? g[2] : 1.0f - g[2]);
+        result += weight * m_density[Index(g0[0] + bx, g0[1] + by, g0[2] + bz)];
+    }
+    return result;
+}
+
+DirectX::XMFLOAT3 HazeSimulation::GetVelocity(int x, int y, int z) const
+{
+    const size_t i = Index(x, y, z);
+    return {m_velocity[0][i] * m_cellSize.x, m_velocity[1][i] * m_cellSize.y, m_velocity[2][i] * m_cellSize.z};
+}
+
+double HazeSimulation::TotalHaze() const
+{
+    double sum = 0.0;
+    for (int z = 1; z <= m_size; ++z)
+        for (int y = 1; y <= m_size; ++y)
+            for (int x = 1; x <= m_size; ++x)
+                sum += m_density[Index(x, y, z)];
+    return sum * static_cast<double>(m_cellSize.x) * m_cellSize.y * m_cellSize.z;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file HazeSimulation.h
+ * @brief Haze density over the room, carried by a stable-fluids solver from hazers and fans.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <vector>
+#include "../Core/Config.h"
+
+/**
+ * @class HazeSimulation
+ * @brief Advects and diffuses a haze density grid over the room at a fixed tick.
+ *
+ * The grid has size^3 cells over a box (the room by default) plus a ring of ghost cells that
+ * holds the boundary conditions: walls are solid for the air and closed for the haze. Each
+ * tick follows Stam's stable fluids in the order of GPU Gems 3, chapter 38: self-advection of
+ * the velocity (semi-Lagrangian, trilinear), viscous diffusion, the fans' and hazers' forces,
+ * and a pressure projection that makes the velocity divergence-free; then the haze is
+ * advected, diffused, emitted and dissipated. Diffusion and pressure are Jacobi iterations, so
+ * every sweep is one task per z slice on the shared ThreadPool with no ordering between cells;
+ * the pressure is kept between ticks as the next solve's first guess.
+ *
+ * Velocities are stored in cells per second along each axis, so advection and projection work
+ * on the unit grid; the room's cells are close enough to cubic for the projection to stay
+ * physical. Density is relative: 1 is the density set in the volumetric pass, and the shader
+ * multiplies the two.
+ *
+ * The solver has no dependency on Direct3D and runs headless; Update() is what the scene calls
+ * each frame, Step() runs exactly one tick.
+ */
+class HazeSimulation
+{
+public:
+    /**
+     * @struct Emitter
+     * @brief A hazer: puts out haze, and air that carries it, over a sphere.
+     */
+    struct Emitter
+    {
+        DirectX::XMFLOAT3 position;  ///< Nozzle position in world space.
+        DirectX::XMFLOAT3 direction; ///< Unit output direction.
+        float radius;                ///< Radius of the sphere the output is spread over.
+        float rate;                  ///< Haze put out per second, in density units times cubic meters.
+        float speed;                 ///< Output speed in meters per second; the air inside is pulled toward it.
+    };
+
+    /**
+     * @struct Fan
+     * @brief Pushes the air inside a sphere along a direction.
+     */
+    struct Fan
+    {
+        DirectX::XMFLOAT3 position;  ///< Fan center in world space.
+        DirectX::XMFLOAT3 direction; ///< Unit blowing direction.
+        float radius;                ///< Radius of the sphere the thrust acts in.
+        float thrust;                ///< Acceleration at the center, in meters per second squared.
+    };
+
+    /**
+     * @brief Allocates the grid and fills it with the initial density.
+     *
+     * @param size Cells per side (at least 2).
+     * @param boundsMin Lower corner of the simulated box.
+     * @param boundsMax Upper corner of the simulated box.
+     */
+    explicit HazeSimulation(int size = Config::Haze::GRID_SIZE,
+                            const DirectX::XMFLOAT3 &boundsMin = {-Config::Room::HALF_WIDTH, Config::Room::FLOOR_Y,
+                                                                  -Config::Room::HALF_WIDTH},
+                            const DirectX::XMFLOAT3 &boundsMax = {Config::Room::HALF_WIDTH, Config::Room::CEILING_Y,
+                                                                  Config::Room::HALF_WIDTH});
+
+    /**
+     * @brief Still air and Config::Haze::INITIAL_DENSITY everywhere; emitters and fans are kept.
+     */
+    void Reset();
+
+    /**
+     * @brief Runs the ticks that fit in the elapsed time, at Config::Haze::TICK_RATE.
+     *
+     * Leftover time is carried to the next call. At most Config::Haze::MAX_TICKS_PER_UPDATE
+     * ticks run per call; time beyond that is dropped, so a slow frame slows the haze down
+     * instead of making the next frames slower.
+     *
+     * @param deltaTime Seconds since the last call.
+     * @return Number of ticks run.
+     */
+    int Update(float deltaTime);
+
+    /**
+     * @brief Runs one tick.
+     * @param dt Tick length in seconds.
+     */
+    void Step(float dt);
+
+    /**
+     * @brief Gets the hazers for modification.
+     * @return Reference to the emitter list.
+     */
+    std::vector<Emitter> &Emitters()
+    {
+        return m_emitters;
+    }
+
+    /**
+     * @brief Gets the fans for modification.
+     * @return Reference to the fan list.
+     */
+    std::vector<Fan> &Fans()
+    {
+        return m_fans;
+    }
+
+    /**
+     * @brief Gets the enabled state for modification.
+     * @return Reference to the enabled flag.
+     */
+    bool &Enabled()
+    {
+        return m_enabled;
+    }
+
+    /**
+     * @brief Checks if the simulation is enabled.
+     * @return True if the volumetric pass should use the simulated density.
+     */
+    [[nodiscard]] bool IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /**
+     * @brief Gets the fraction of the haze lost per second, for modification.
+     * @return Reference to the dissipation rate.
+     */
+    float &Dissipation()
+    {
+        return m_dissipation;
+    }
+
+    /**
+     * @brief Gets the number of cells per side.
+     * @return Grid size, without the ghost cells.
+     */
+    [[nodiscard]] int GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Gets a counter that changes with every tick and Reset(), to detect a new density.
+     * @return Density version.
+     */
+    [[nodiscard]] size_t GetVersion() const
+    {
+        return m_version;
+    }
+
+    /**
+     * @brief Gets the density grid, ghost cells included.
+     *
+     * Cell (x, y, z), each in [0, size + 1], is at Index(x, y, z); the cells of the box are 1 to
+     * size. The first box cell is at Index(1, 1, 1) with rows of size + 2 floats and slices of
+     * (size + 2)^2, which is how the volumetric pass uploads it without a copy.
+     *
+     * @return Reference to the density values.
+     */
+    [[nodiscard]] const std::vector<float> &GetDensity() const
+    {
+        return m_density;
+    }
+
+    /**
+     * @brief Index of cell (x, y, z) in the grids, ghost cells included.
+     */
+    [[nodiscard]] size_t Index(int x, int y, int z) const
+    {
+        const size_t stride = static_cast<size_t>(m_size) + 2;
+        return (((static_cast<size_t>(z) * stride) + y) * stride) + x;
+    }
+
+    /**
+     * @brief Samples the density trilinearly at a world position, as the shader does.
+     * @param position World position; outside the box it is clamped to the nearest cell center.
+     * @return Relative density.
+     */
+    [[nodiscard]] float SampleDensity(const DirectX::XMFLOAT3 &position) const;
+
+    /**
+     * @brief Gets the air velocity of a cell.
+     * @return Velocity in meters per second.
+     */
+    [[nodiscard]] DirectX::XMFLOAT3 GetVelocity(int x, int y, int z) const;
+
+    /**
+     * @brief Integrates the density over the box.
+     * @return Sum of density times cell volume, in the units of Emitter::rate times seconds.
+     */
+    [[nodiscard]] double TotalHaze() const;
+
+private:
+    /**
+     * @brief Applies the fans' thrust and pulls the air at the hazers toward their output.
+     */
+    void AddForces(float dt);
+
+    /**
+     * @brief Adds the hazers' output to the density, spread over each sphere.
+     */
+    void Emit(float dt);
+
+    /**
+     * @brief Removes the divergent part of the velocity with a Jacobi pressure solve.
+     */
+    void Project();
+
+    /**
+     * @brief Semi-Lagrangian advection by the velocity: each cell traces back and takes the
+     * trilinear value there. Three fields are the velocity components (boundaries 1 to 3),
+     * one is a scalar (boundary 0); they share the trace and the weights.
+     */
+    void Advect(std::vector<float> *dst, const std::vector<float> *src, int fields, float dt) const;
+
+    /**
+     * @brief Implicit diffusion by Jacobi iterations, which keep the total of a field with closed walls.
+     */
+    void Diffuse(std::vector<float> &field, float rate, float dt, int boundary);
+
+    /**
+     * @brief Fills the ghost cells: boundary 1, 2 or 3 mirrors that velocity component with its
+     * sign flipped (solid walls), 0 copies the field (closed walls).
+     */
+    void SetBoundary(std::vector<float> &field, int boundary) const;
+
+    /**
+     * @brief Visits the cells within a sphere with their weight, 1 at the center and 0 at the radius.
+     */
+    template <typename F> void ForSphere(const DirectX::XMFLOAT3 &center, float radius, F &&visit) const;
+
+    int m_size;
+    DirectX::XMFLOAT3 m_boundsMin;
+    DirectX::XMFLOAT3 m_cellSize; ///< Meters per cell along each axis.
+    bool m_enabled = true;
+    float m_dissipation = Config::Haze::DISSIPATION;
+    float m_carry = 0.0f;
+    size_t m_version = 0;
+
+    std::vector<Emitter> m_emitters;
+    std::vector<Fan> m_fans;
+
+    // Velocity in cells per second, the previous tick's pressure, and scratch grids for the
+    // advection targets, the diffusion's right-hand side and the Jacobi ping-pong
+    std::vector<float> m_velocity[3];
+    std::vector<float> m_scratch[3];
+    std::vector<float> m_pressure;
+    std::vector<float> m_divergence;
+    std::vector<float> m_density;
+};
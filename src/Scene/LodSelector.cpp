@@ -0,0 +1,51 @@
+#include "LodSelector.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace LodSelector
+{
+
+DirectX::XMFLOAT4 TransformSphere(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX world)
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, world);
+
+    DirectX::XMFLOAT4 result;
+    result.x = (sphere.x * m._11) + (sphere.y * m._21) + (sphere.z * m._31) + m._41;
+    result.y = (sphere.x * m._12) + (sphere.y * m._22) + (sphere.z * m._32) + m._42;
+    result.z = (sphere.x * m._13) + (sphere.y * m._23) + (sphere.z * m._33) + m._43;
+
+    // Rows of the upper 3x3 are the transformed axes
+    const float scaleX = (m._11 * m._11) + (m._12 * m._12) + (m._13 * m._13);
+    const float scaleY = (m._21 * m._21) + (m._22 * m._22) + (m._23 * m._23);
+    const float scaleZ = (m._31 * m._31) + (m._32 * m._32) + (m._33 * m._33);
+    result.w = sphere.w * std::sqrt((std::max)({scaleX, scaleY, scaleZ}));
+    return result;
+}
+
+float ProjectedSize(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX viewProj)
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, viewProj);
+
+    // Clip w is the view depth; the y column carries the projection's vertical scale times a
+    // unit view axis, so its length is that scale
+    const float depth = (sphere.x * m._14) + (sphere.y * m._24) + (sphere.z * m._34) + m._44;
+    if (depth <= sphere.w)
+        return FLT_MAX;
+    const float scaleY = std::sqrt((m._12 * m._12) + (m._22 * m._22) + (m._32 * m._32));
+
+    // Diameter in NDC is 2 * r * scale / depth over an NDC height of 2
+    return sphere.w * scaleY / depth;
+}
+
+size_t SelectLod(float projectedSize, const float *thresholds, size_t thresholdCount, size_t lodCount)
+{
+    size_t lod = 0;
+    while (lod < thresholdCount && projectedSize < thresholds[lod])
+        ++lod;
+    return lodCount > 0 ? (std::min)(lod, lodCount - 1) : 0;
+}
+
+} // namespace LodSelector
@@ -0,0 +1,55 @@
+/**
+ * @file LodSelector.h
+ * @brief Picks a mesh level of detail from its projected size on screen.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+
+/**
+ * @namespace LodSelector
+ * @brief Screen-size based LOD selection shared by the scene and shadow passes.
+ *
+ * Sizes are expressed as the projected diameter of a bounding sphere over the viewport
+ * height, so the same thresholds work for any resolution and field of view.
+ */
+namespace LodSelector
+{
+
+/**
+ * @brief Transforms a mesh-space bounding sphere to world space.
+ *
+ * The radius is scaled by the largest axis scale of the matrix, which keeps the sphere
+ * conservative under non-uniform scaling.
+ *
+ * @param sphere Center in xyz and radius in w.
+ * @param world World matrix (row-vector convention).
+ * @return The world-space sphere.
+ */
+DirectX::XMFLOAT4 TransformSphere(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX world);
+
+/**
+ * @brief Computes the projected diameter of a sphere as a fraction of the viewport height.
+ *
+ * Works for any perspective view-projection built from a rigid view matrix (camera or light).
+ *
+ * @param sphere World-space center in xyz and radius in w.
+ * @param viewProj View-projection matrix (row-vector convention, not transposed).
+ * @return The projected size, or FLT_MAX when the viewpoint is inside the sphere.
+ */
+float ProjectedSize(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX viewProj);
+
+/**
+ * @brief Picks the level of detail for a projected size.
+ *
+ * @param projectedSize Value returned by ProjectedSize().
+ * @param thresholds Decreasing sizes below which LOD 1, 2, ... are used.
+ * @param thresholdCount Number of thresholds.
+ * @param lodCount Number of levels the mesh has (1 means full detail only).
+ * @return The selected level, in [0, lodCount - 1].
+ */
+size_t SelectLod(float projectedSize, const float *thresholds, size_t thresholdCount, size_t lodCount);
+
+} // namespace LodSelector
@@ -4,6 +4,7 @@
  */
 
 #include "Node.h"
+#include <algorithm>
 #include <utility>
 
 namespace SceneGraph
@@ -25,6 +26,16 @@ void Node::AddChild(const std::shared_ptr<Node> &child)
     }
 }
 
+void Node::RemoveChild(const std::shared_ptr<Node> &child)
+{
+    const auto found = std::find(m_children.begin(), m_children.end(), child);
+    if (found != m_children.end())
+    {
+        child->m_parent.reset();
+        m_children.erase(found);
+    }
+}
+
 std::shared_ptr<Node> Node::FindChild(const std::string &name)
 {
     if (m_name == name)
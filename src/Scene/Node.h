@@ -40,6 +40,12 @@ public:
      */
     void AddChild(const std::shared_ptr<Node> &child);
 
+    /**
+     * @brief Removes a child node from this node.
+     * @param child The child to remove; nodes that are not children are ignored.
+     */
+    void RemoveChild(const std::shared_ptr<Node> &child);
+
     /**
      * @brief Updates the world transform for this node and recursively for all its children.
      * @param parentWorld The world matrix of the parent node (defaults to identity).
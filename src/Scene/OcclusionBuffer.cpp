@@ -0,0 +1,419 @@
+#include "OcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+#include "../Core/ThreadPool.h"
+
+namespace
+{
+
+/// Occluder triangles per transform task.
+constexpr size_t TRANSFORM_CHUNK = 256;
+
+/**
+ * @brief Builds the edge function from x0, y0 to x1, y1, positive inside when orientation is 1.
+ *
+ * Coefficients come from the endpoints in a fixed (y, then x) order and only the sign depends
+ * on the triangle, so two triangles sharing an edge evaluate exact opposites and no pixel
+ * center on the edge falls through the crack.
+ */
+OcclusionBuffer::Edge MakeEdge(float x0, float y0, float x1, float y1, float orientation)
+{
+    float sign = orientation;
+    if (y0 > y1 || (y0 == y1 && x0 > x1))
+    {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        sign = -sign;
+    }
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+    return {sign * -dy, sign * dx, sign * ((dy * x0) - (dx * y0))};
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+    : m_width((std::max)(4, (width + 3) & ~3)), m_height((std::max)(1, height))
+{
+    const int tile = Config::Occlusion::TILE_SIZE;
+    const int coarse = Config::Occlusion::COARSE_TILE_SIZE;
+    m_tilesX = (m_width + tile - 1) / tile;
+    m_tilesY = (m_height + tile - 1) / tile;
+    m_coarseX = (m_width + coarse - 1) / coarse;
+    m_coarseY = (m_height + coarse - 1) / coarse;
+    m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+    m_tileMax.assign(static_cast<size_t>(m_tilesX) * m_tilesY, 1.0f);
+    m_coarseMax.assign(static_cast<size_t>(m_coarseX) * m_coarseY, 1.0f);
+    m_bandTriangles.resize(static_cast<size_t>(m_tilesY));
+}
+
+void OcclusionBuffer::Begin(DirectX::FXMMATRIX viewProj)
+{
+    DirectX::XMStoreFloat4x4(&m_viewProj, viewProj);
+    m_triangles.clear();
+    m_rasterizedCount = 0;
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    std::fill(m_tileMax.begin(), m_tileMax.end(), 1.0f);
+    std::fill(m_coarseMax.begin(), m_coarseMax.end(), 1.0f);
+}
+
+bool OcclusionBuffer::Project(float x, float y, float z, const DirectX::XMFLOAT4X4 &m, float &sx, float &sy,
+                              float &depth) const
+{
+    const float cx = (x * m._11) + (y * m._21) + (z * m._31) + m._41;
+    const float cy = (x * m._12) + (y * m._22) + (z * m._32) + m._42;
+    const float cz = (x * m._13) + (y * m._23) + (z * m._33) + m._43;
+    const float cw = (x * m._14) + (y * m._24) + (z * m._34) + m._44;
+    if (cz < 0.0f || cw <= 0.0f)
+        return false;
+
+    const float invW = 1.0f / cw;
+    sx = ((cx * invW) * 0.5f + 0.5f) * static_cast<float>(m_width);
+    sy = (0.5f - ((cy * invW) * 0.5f)) * static_cast<float>(m_height);
+    depth = cz * invW;
+    return true;
+}
+
+void OcclusionBuffer::AddOccluders(const DirectX::XMFLOAT3 *positions, size_t triangleCount, DirectX::FXMMATRIX world)
+{
+    if (!positions || triangleCount == 0)
+        return;
+
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, world * DirectX::XMLoadFloat4x4(&m_viewProj));
+
+    const size_t first = m_triangles.size();
+    m_triangles.resize(first + triangleCount);
+    auto transformChunk = [&](size_t chunk)
+    {
+        const size_t end = (std::min)(triangleCount, (chunk + 1) * TRANSFORM_CHUNK);
+        for (size_t t = chunk * TRANSFORM_CHUNK; t < end; ++t)
+        {
+            ScreenTriangle &tri = m_triangles[first + t];
+            tri.valid = true;
+            for (int k = 0; k < 3 && tri.valid; ++k)
+            {
+                const DirectX::XMFLOAT3 &p = positions[(t * 3) + k];
+                tri.valid = Project(p.x, p.y, p.z, m, tri.x[k], tri.y[k], tri.z[k]);
+            }
+            if (!tri.valid)
+                continue;
+
+            // Pixels whose centers (i + 0.5) fall inside the bounds
+            const float minX = (std::min)({tri.x[0], tri.x[1], tri.x[2]});
+            const float maxX = (std::max)({tri.x[0], tri.x[1], tri.x[2]});
+            const float minY = (std::min)({tri.y[0], tri.y[1], tri.y[2]});
+            const float maxY = (std::max)({tri.y[0], tri.y[1], tri.y[2]});
+            if (maxX < 0.0f || maxY < 0.0f || minX > static_cast<float>(m_width) || minY > static_cast<float>(m_height))
+            {
+                tri.valid = false;
+                continue;
+            }
+            tri.minX = (std::max)(0, static_cast<int>(std::ceil(minX - 0.5f)));
+            tri.minY = (std::max)(0, static_cast<int>(std::ceil(minY - 0.5f)));
+            tri.maxX = (std::min)(m_width - 1, static_cast<int>(std::floor(maxX - 0.5f)));
+            tri.maxY = (std::min)(m_height - 1, static_cast<int>(std::floor(maxY - 0.5f)));
+            tri.valid = tri.minX <= tri.maxX && tri.minY <= tri.maxY;
+            if (!tri.valid)
+                continue;
+
+            const float x[3] = {tri.x[0], tri.x[1], tri.x[2]};
+            const float y[3] = {tri.y[0], tri.y[1], tri.y[2]};
+            const float z[3] = {tri.z[0], tri.z[1], tri.z[2]};
+            const float area = ((x[1] - x[0]) * (y[2] - y[0])) - ((x[2] - x[0]) * (y[1] - y[0]));
+            if (area == 0.0f)
+            {
+                tri.valid = false;
+                continue;
+            }
+
+            // Both windings are occluders; flip so the inside is positive
+            const float orientation = area > 0.0f ? 1.0f : -1.0f;
+            tri.edges[0] = MakeEdge(x[1], y[1], x[2], y[2], orientation);
+            tri.edges[1] = MakeEdge(x[2], y[2], x[0], y[0], orientation);
+            tri.edges[2] = MakeEdge(x[0], y[0], x[1], y[1], orientation);
+            for (int e = 0; e < 3; ++e)
+                tri.spanScale[e] = tri.edges[e].a != 0.0f ? -1.0f / tri.edges[e].a : 0.0f;
+
+            // Depth plane z = depthOrigin + dzdx * x + dzdy * y
+            const float invArea = 1.0f / area;
+            tri.dzdx = (((z[1] - z[0]) * (y[2] - y[0])) - ((z[2] - z[0]) * (y[1] - y[0]))) * invArea;
+            tri.dzdy = (((z[2] - z[0]) * (x[1] - x[0])) - ((z[1] - z[0]) * (x[2] - x[0]))) * invArea;
+            tri.depthOrigin = z[0] - (tri.dzdx * x[0]) - (tri.dzdy * y[0]);
+        }
+    };
+
+    const size_t chunkCount = (triangleCount + TRANSFORM_CHUNK - 1) / TRANSFORM_CHUNK;
+    if (chunkCount > 1)
+        ThreadPool::Shared().ParallelFor(chunkCount, transformChunk);
+    else
+        transformChunk(0);
+}
+
+void OcclusionBuffer::RasterizeBand(size_t band)
+{
+    const int rowBegin = static_cast<int>(band) * Config::Occlusion::TILE_SIZE;
+    const int rowEnd = (std::min)(m_height, rowBegin + Config::Occlusion::TILE_SIZE);
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (uint32_t index : m_bandTriangles[band])
+    {
+        const ScreenTriangle &tri = m_triangles[index];
+        const Edge *edges = tri.edges;
+        const float *spanScale = tri.spanScale;
+        const __m128 a0 = _mm_set1_ps(edges[0].a);
+        const __m128 a1 = _mm_set1_ps(edges[1].a);
+        const __m128 a2 = _mm_set1_ps(edges[2].a);
+        const __m128 dzdx4 = _mm_set1_ps(tri.dzdx);
+
+        const int y0 = (std::max)(tri.minY, rowBegin);
+        const int y1 = (std::min)(tri.maxY + 1, rowEnd);
+        for (int y = y0; y < y1; ++y)
+        {
+            const float py = static_cast<float>(y) + 0.5f;
+            const float rowValues[3] = {(edges[0].b * py) + edges[0].c, (edges[1].b * py) + edges[1].c,
+                                        (edges[2].b * py) + edges[2].c};
+
+            // Narrow the row to the triangle's span (padded by a pixel; the edge tests decide)
+            float spanMin = static_cast<float>(tri.minX);
+            float spanMax = static_cast<float>(tri.maxX);
+            for (int e = 0; e < 3; ++e)
+            {
+                if (edges[e].a > 0.0f)
+                    spanMin = (std::max)(spanMin, (rowValues[e] * spanScale[e]) - 1.5f);
+                else if (edges[e].a < 0.0f)
+                    spanMax = (std::min)(spanMax, (rowValues[e] * spanScale[e]) + 0.5f);
+                else if (rowValues[e] < 0.0f)
+                    spanMax = -1.0f;
+            }
+            if (spanMin > spanMax)
+                continue;
+            const int x0 = static_cast<int>(spanMin) & ~3;
+            const int x1 = static_cast<int>(spanMax) + 1;
+
+            const __m128 row0 = _mm_set1_ps(rowValues[0]);
+            const __m128 row1 = _mm_set1_ps(rowValues[1]);
+            const __m128 row2 = _mm_set1_ps(rowValues[2]);
+            const __m128 rowZ = _mm_set1_ps(tri.depthOrigin + (tri.dzdy * py));
+            float *depthRow = &m_depth[static_cast<size_t>(y) * m_width];
+
+            for (int x = x0; x < x1; x += 4)
+            {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                const __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                const __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                const __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+                const __m128 inside =
+                    _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                const __m128 z = _mm_add_ps(_mm_mul_ps(dzdx4, px), rowZ);
+                const __m128 depth = _mm_loadu_ps(depthRow + x);
+                const __m128 nearer = _mm_min_ps(depth, z);
+                _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, depth)));
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::Finish()
+{
+    // Bin triangles by band so each task only visits the triangles that touch it
+    const int tile = Config::Occlusion::TILE_SIZE;
+    m_rasterizedCount = 0;
+    for (auto &list : m_bandTriangles)
+        list.clear();
+    for (size_t i = 0; i < m_triangles.size(); ++i)
+    {
+        const ScreenTriangle &tri = m_triangles[i];
+        if (!tri.valid)
+            continue;
+        ++m_rasterizedCount;
+        for (int band = tri.minY / tile; band <= tri.maxY / tile; ++band)
+            m_bandTriangles[band].push_back(static_cast<uint32_t>(i));
+    }
+
+    // One task per row of fine tiles: rasterize its pixel rows, then reduce its tiles
+    ThreadPool::Shared().ParallelFor(static_cast<size_t>(m_tilesY),
+                                     [&](size_t band)
+                                     {
+                                         const int rowBegin = static_cast<int>(band) * tile;
+                                         const int rowEnd = (std::min)(m_height, rowBegin + tile);
+                                         RasterizeBand(band);
+
+                                         for (int tx = 0; tx < m_tilesX; ++tx)
+                                         {
+                                             // The width is a multiple of 4, so tiles split into whole quads
+                                             const int colEnd = (std::min)(m_width, (tx + 1) * tile);
+                                             __m128 farthest = _mm_setzero_ps();
+                                             for (int y = rowBegin; y < rowEnd; ++y)
+                                             {
+                                                 const float *row = &m_depth[static_cast<size_t>(y) * m_width];
+                                                 for (int x = tx * tile; x < colEnd; x += 4)
+                                                     farthest = _mm_max_ps(farthest, _mm_loadu_ps(row + x));
+                                             }
+                                             farthest = _mm_max_ps(farthest, _mm_movehl_ps(farthest, farthest));
+                                             farthest = _mm_max_ss(farthest, _mm_shuffle_ps(farthest, farthest, 1));
+                                             m_tileMax[(band * m_tilesX) + tx] = _mm_cvtss_f32(farthest);
+                                         }
+                                     });
+
+    const int ratio = Config::Occlusion::COARSE_TILE_SIZE / tile;
+    for (int cy = 0; cy < m_coarseY; ++cy)
+    {
+        for (int cx = 0; cx < m_coarseX; ++cx)
+        {
+            float farthest = 0.0f;
+            for (int ty = cy * ratio; ty < (std::min)(m_tilesY, (cy + 1) * ratio); ++ty)
+                for (int tx = cx * ratio; tx < (std::min)(m_tilesX, (cx + 1) * ratio); ++tx)
+                    farthest = (std::max)(farthest, m_tileMax[(static_cast<size_t>(ty) * m_tilesX) + tx]);
+            m_coarseMax[(static_cast<size_t>(cy) * m_coarseX) + cx] = farthest;
+        }
+    }
+}
+
+bool OcclusionBuffer::IsRectVisible(float minX, float minY, float maxX, float maxY, float nearestDepth) const
+{
+    if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(m_width) || minY >= static_cast<float>(m_height))
+        return true; // Off screen: left to frustum culling
+
+    // Every pixel the rectangle touches, not just covered centers
+    const int tile = Config::Occlusion::TILE_SIZE;
+    const int ratio = Config::Occlusion::COARSE_TILE_SIZE / tile;
+    const int px0 = (std::max)(0, static_cast<int>(std::floor(minX)));
+    const int py0 = (std::max)(0, static_cast<int>(std::floor(minY)));
+    const int px1 = (std::min)(m_width - 1, static_cast<int>(std::floor(maxX)));
+    const int py1 = (std::min)(m_height - 1, static_cast<int>(std::floor(maxY)));
+    const int tx0 = px0 / tile;
+    const int ty0 = py0 / tile;
+    const int tx1 = px1 / tile;
+    const int ty1 = py1 / tile;
+
+    for (int cy = ty0 / ratio; cy <= ty1 / ratio; ++cy)
+    {
+        for (int cx = tx0 / ratio; cx <= tx1 / ratio; ++cx)
+        {
+            if (m_coarseMax[(static_cast<size_t>(cy) * m_coarseX) + cx] < nearestDepth)
+                continue;
+            for (int ty = (std::max)(ty0, cy * ratio); ty <= (std::min)(ty1, ((cy + 1) * ratio) - 1); ++ty)
+            {
+                for (int tx = (std::max)(tx0, cx * ratio); tx <= (std::min)(tx1, ((cx + 1) * ratio) - 1); ++tx)
+                {
+                    if (m_tileMax[(static_cast<size_t>(ty) * m_tilesX) + tx] >= nearestDepth)
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool OcclusionBuffer::IsBoxVisible(const DirectX::XMFLOAT3 &boxMin, const DirectX::XMFLOAT3 &boxMax,
+                                   DirectX::FXMMATRIX worldViewProj) const
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, worldViewProj);
+
+    float minX = 1e30f;
+    float minY = 1e30f;
+    float maxX = -1e30f;
+    float maxY = -1e30f;
+    float nearest = 1.0f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const float x = (corner & 1) ? boxMax.x : boxMin.x;
+        const float y = (corner & 2) ? boxMax.y : boxMin.y;
+        const float z = (corner & 4) ? boxMax.z : boxMin.z;
+        float sx;
+        float sy;
+        float depth;
+        if (!Project(x, y, z, m, sx, sy, depth))
+            return true; // Crosses the near plane
+        minX = (std::min)(minX, sx);
+        minY = (std::min)(minY, sy);
+        maxX = (std::max)(maxX, sx);
+        maxY = (std::max)(maxY, sy);
+        nearest = (std::min)(nearest, depth);
+    }
+    return IsRectVisible(minX, minY, maxX, maxY, nearest);
+}
+
+bool OcclusionBuffer::IsSphereVisible(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX worldViewProj) const
+{
+    return IsBoxVisible({sphere.x - sphere.w, sphere.y - sphere.w, sphere.z - sphere.w},
+                        {sphere.x + sphere.w, sphere.y + sphere.w, sphere.z + sphere.w}, worldViewProj);
+}
+
+std::vector<DirectX::XMFLOAT3> OcclusionBuffer::SelectOccluders(const PackedMeshView &view, size_t maxTriangles)
+{
+    std::vector<DirectX::XMFLOAT3> positions;
+    if (!view.vertices || !view.indexBytes || view.vertexCount == 0 || maxTriangles == 0)
+        return positions;
+
+    DirectX::XMFLOAT3 lo = view.vertices[0].position;
+    DirectX::XMFLOAT3 hi = lo;
+    for (size_t i = 1; i < view.vertexCount; ++i)
+    {
+        const DirectX::XMFLOAT3 &p = view.vertices[i].position;
+        lo = {(std::min)(lo.x, p.x), (std::min)(lo.y, p.y), (std::min)(lo.z, p.z)};
+        hi = {(std::max)(hi.x, p.x), (std::max)(hi.y, p.y), (std::max)(hi.z, p.z)};
+    }
+    const float dx = hi.x - lo.x;
+    const float dy = hi.y - lo.y;
+    const float dz = hi.z - lo.z;
+    const float minArea = Config::Occlusion::MIN_TRIANGLE_AREA * ((dx * dx) + (dy * dy) + (dz * dz));
+
+    struct Candidate
+    {
+        float area;
+        uint32_t corners[3];
+        size_t order;
+    };
+    std::vector<Candidate> candidates;
+    const size_t rangeCount = view.rangeCount / (std::max)(view.levelCount, size_t(1));
+    for (size_t r = 0; r < rangeCount; ++r)
+    {
+        const IndexRange &range = view.ranges[r];
+        for (uint32_t i = 0; i + 2 < range.indexCount; i += 3)
+        {
+            Candidate c;
+            for (uint32_t k = 0; k < 3; ++k)
+                c.corners[k] = ReadPackedIndex(view, range, i + k);
+            if (c.corners[0] >= view.vertexCount || c.corners[1] >= view.vertexCount || c.corners[2] >= view.vertexCount)
+                continue;
+
+            const DirectX::XMFLOAT3 &p0 = view.vertices[c.corners[0]].position;
+            const DirectX::XMFLOAT3 &p1 = view.vertices[c.corners[1]].position;
+            const DirectX::XMFLOAT3 &p2 = view.vertices[c.corners[2]].position;
+            const float e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+            const float e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+            const float nx = (e1[1] * e2[2]) - (e1[2] * e2[1]);
+            const float ny = (e1[2] * e2[0]) - (e1[0] * e2[2]);
+            const float nz = (e1[0] * e2[1]) - (e1[1] * e2[0]);
+            c.area = 0.5f * std::sqrt((nx * nx) + (ny * ny) + (nz * nz));
+            c.order = candidates.size();
+            if (c.area >= minArea)
+                candidates.push_back(c);
+        }
+    }
+
+    // Largest first (ties in index order), then back to index order for locality
+    if (candidates.size() > maxTriangles)
+    {
+        std::nth_element(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(maxTriangles),
+                         candidates.end(), [](const Candidate &a, const Candidate &b)
+                         { return a.area > b.area || (a.area == b.area && a.order < b.order); });
+        candidates.resize(maxTriangles);
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate &a, const Candidate &b) { return a.order < b.order; });
+    }
+
+    positions.reserve(candidates.size() * 3);
+    for (const auto &c : candidates)
+        for (uint32_t corner : c.corners)
+            positions.push_back(view.vertices[corner].position);
+    return positions;
+}
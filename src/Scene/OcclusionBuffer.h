@@ -0,0 +1,195 @@
+/**
+ * @file OcclusionBuffer.h
+ * @brief Low-resolution CPU depth buffer for software occlusion culling.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../Core/Config.h"
+#include "../Resources/MeshData.h"
+
+/**
+ * @class OcclusionBuffer
+ * @brief Rasterizes occluder triangles into a small depth buffer and tests bounds against it.
+ *
+ * Depth is the D3D clip z / w in [0, 1], nearer is smaller. Each frame: Begin() with the
+ * camera, AddOccluders() for every occluder mesh, then Finish() rasterizes on the shared
+ * ThreadPool (one band of tile rows per task, four pixels at a time with SSE) and builds two
+ * levels of per-tile maximum depth. Visibility tests only read the tiles and may run from
+ * several threads at once.
+ *
+ * Occluders are sampled at pixel centers (both windings) and triangles crossing the near plane
+ * are skipped, so a pixel only holds a depth the real geometry has at its center.
+ */
+class OcclusionBuffer
+{
+public:
+    /**
+     * @brief Allocates the depth buffer and tile levels.
+     *
+     * @param width Width in pixels (rounded up to a multiple of 4).
+     * @param height Height in pixels.
+     */
+    explicit OcclusionBuffer(int width = Config::Occlusion::BUFFER_WIDTH, int height = Config::Occlusion::BUFFER_HEIGHT);
+
+    /**
+     * @brief Clears the buffer and sets the view for the next occluders.
+     * @param viewProj Camera view-projection matrix (row-vector convention, not transposed).
+     */
+    void Begin(DirectX::FXMMATRIX viewProj);
+
+    /**
+     * @brief Transforms occluder triangles to screen space and queues them for Finish().
+     *
+     * @param positions Three mesh-space positions per triangle.
+     * @param triangleCount Number of triangles.
+     * @param world World matrix of the occluder mesh.
+     */
+    void AddOccluders(const DirectX::XMFLOAT3 *positions, size_t triangleCount, DirectX::FXMMATRIX world);
+
+    /**
+     * @brief Rasterizes the queued occluders and builds the tile levels.
+     */
+    void Finish();
+
+    /**
+     * @brief Tests whether any part of a box may be visible.
+     *
+     * @param boxMin Minimum corner in object space.
+     * @param boxMax Maximum corner in object space.
+     * @param worldViewProj Object-to-clip matrix (row-vector convention).
+     * @return False only when the whole box lies behind occluders.
+     */
+    [[nodiscard]] bool IsBoxVisible(const DirectX::XMFLOAT3 &boxMin, const DirectX::XMFLOAT3 &boxMax,
+                                    DirectX::FXMMATRIX worldViewProj) const;
+
+    /**
+     * @brief Tests whether any part of a sphere may be visible.
+     *
+     * @param sphere Center in xyz and radius in w, in object space.
+     * @param worldViewProj Object-to-clip matrix (row-vector convention).
+     * @return False only when the whole sphere lies behind occluders.
+     */
+    [[nodiscard]] bool IsSphereVisible(const DirectX::XMFLOAT4 &sphere, DirectX::FXMMATRIX worldViewProj) const;
+
+    /**
+     * @brief Tests a screen rectangle against the tile levels.
+     *
+     * @param minX Left edge in pixels.
+     * @param minY Top edge in pixels.
+     * @param maxX Right edge in pixels.
+     * @param maxY Bottom edge in pixels.
+     * @param nearestDepth Smallest depth of the tested object.
+     * @return False when every covered tile is entirely nearer than nearestDepth.
+     */
+    [[nodiscard]] bool IsRectVisible(float minX, float minY, float maxX, float maxY, float nearestDepth) const;
+
+    /**
+     * @brief Gets the depth of one pixel after Finish().
+     * @return Depth in [0, 1]; 1 where no occluder was drawn.
+     */
+    [[nodiscard]] float GetDepth(int x, int y) const
+    {
+        return m_depth[(static_cast<size_t>(y) * m_width) + x];
+    }
+
+    /**
+     * @brief Gets the buffer width in pixels.
+     */
+    [[nodiscard]] int GetWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the buffer height in pixels.
+     */
+    [[nodiscard]] int GetHeight() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Gets the number of occluder triangles queued since Begin().
+     */
+    [[nodiscard]] size_t GetOccluderCount() const
+    {
+        return m_triangles.size();
+    }
+
+    /**
+     * @brief Gets the number of queued triangles that were in front of the camera and on screen.
+     */
+    [[nodiscard]] size_t GetRasterizedCount() const
+    {
+        return m_rasterizedCount;
+    }
+
+    /**
+     * @brief Picks a mesh's largest triangles as occluders.
+     *
+     * Uses the full-detail level. Triangles smaller than Config::Occlusion::MIN_TRIANGLE_AREA
+     * times the squared bounding box diagonal are never picked.
+     *
+     * @param view Packed mesh arrays.
+     * @param maxTriangles Largest number of triangles to return.
+     * @return Three mesh-space positions per triangle, in index order.
+     */
+    static std::vector<DirectX::XMFLOAT3> SelectOccluders(const PackedMeshView &view,
+                                                          size_t maxTriangles = Config::Occlusion::MAX_OCCLUDER_TRIANGLES);
+
+public:
+    /**
+     * @struct Edge
+     * @brief Edge function E(x, y) = a * x + (b * y + c) in pixels, positive inside.
+     */
+    struct Edge
+    {
+        float a, b, c;
+    };
+
+private:
+    /**
+     * @struct ScreenTriangle
+     * @brief Occluder triangle in pixel coordinates with its edge functions and depth plane.
+     */
+    struct ScreenTriangle
+    {
+        float x[3];                            ///< Pixel x of each corner.
+        float y[3];                            ///< Pixel y of each corner (down).
+        float z[3];                            ///< Depth of each corner.
+        int minX, minY, maxX, maxY;            ///< Covered pixel bounds, inclusive.
+        bool valid;                            ///< False when culled during setup.
+        Edge edges[3];                         ///< Edge functions, one per side.
+        float spanScale[3];                    ///< -1 / a of each edge (0 when a is 0), to find row spans.
+        float depthOrigin, dzdx, dzdy;         ///< Depth plane: depthOrigin + dzdx * x + dzdy * y.
+    };
+
+    /**
+     * @brief Rasterizes the triangles binned to one row of fine tiles.
+     */
+    void RasterizeBand(size_t band);
+
+    /**
+     * @brief Projects a point to pixel coordinates, returning false when it is behind the near plane.
+     */
+    bool Project(float x, float y, float z, const DirectX::XMFLOAT4X4 &m, float &sx, float &sy, float &depth) const;
+
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+    int m_coarseX;
+    int m_coarseY;
+    DirectX::XMFLOAT4X4 m_viewProj = {};
+    std::vector<float> m_depth;            ///< Per-pixel depth.
+    std::vector<float> m_tileMax;          ///< Farthest depth of each fine tile.
+    std::vector<float> m_coarseMax;        ///< Farthest depth of each coarse tile.
+    std::vector<ScreenTriangle> m_triangles;
+    std::vector<std::vector<uint32_t>> m_bandTriangles; ///< Triangle indices touching each row of fine tiles.
+    size_t m_rasterizedCount = 0;
+};
@@ -1,7 +1,23 @@
 #include "Scene.h"
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <utility>
+#include "../Geometry/GeometryGenerator.h"
+#include "../Resources/TextureBaker.h"
+#include "ClusterCuller.h"
+#include "MeshNode.h"
+
+namespace
+{
+
+// Fixtures hang a little above their anchor, to touch the truss
+constexpr float TRUSS_OFFSET = 0.45f;
+
+} // namespace
 
 Scene::Scene()
     : m_camDistance(Config::CameraDefaults::DISTANCE), m_camPitch(Config::CameraDefaults::PITCH),
@@ -12,142 +28,81 @@ Scene::Scene()
 {
     // Create default spotlight
     m_spotlights.emplace_back();
+
+    // Default haze rig: a hazer at the back of the stage blowing toward it, a fan behind the hazer
+    m_haze.Emitters().push_back({{-20.0f, 1.0f, 10.0f},
+                                 {0.98f, 0.2f, 0.0f},
+                                 Config::Haze::HAZER_RADIUS,
+                                 Config::Haze::HAZER_RATE,
+                                 Config::Haze::HAZER_SPEED});
+    m_haze.Fans().push_back(
+        {{-26.0f, 2.0f, 10.0f}, {1.0f, 0.0f, 0.0f}, Config::Haze::FAN_RADIUS, Config::Haze::FAN_THRUST});
 }
 
 bool Scene::Initialize(ID3D11Device *device)
 {
-    // Load stage mesh
+    SceneAssets assets;
+    return assets.Load("data/models/stage.obj", Config::Fixtures::DEFAULT_GDTF) && Initialize(device, assets);
+}
+
+bool Scene::Initialize(ID3D11Device *device, SceneAssets &assets)
+{
+    // Upload stage mesh
     m_stageMesh = std::make_unique<Mesh>();
-    if (!m_stageMesh->LoadFromOBJ(device, "data/models/stage.obj"))
+    if (!m_stageMesh->Create(device, assets.stage))
     {
         return false;
     }
-
-    // Calculate stage offset
-    float stageMinY = m_stageMesh->GetMinY();
-    m_stageOffset = Config::Room::FLOOR_Y - stageMinY;
-
-    // Find anchor points from mesh
-    m_anchorPositions.clear();
-    for (const auto &shape : m_stageMesh->GetShapes())
-    {
-        if (shape.name.find("Anchor.") == 0)
-        {
-            DirectX::XMFLOAT3 pos = shape.center;
-            pos.y += m_stageOffset;
-            m_anchorPositions.push_back(pos);
-        }
-    }
-
-    // Fallback if no anchors found
-    if (m_anchorPositions.empty())
-    {
-        m_fixturePos = {0.0f, Config::Spotlight::DEFAULT_HEIGHT, 0.0f};
-        for (const auto &shape : m_stageMesh->GetShapes())
-        {
-            if (shape.name == "Cylinder.000")
-            {
-                m_fixturePos = shape.center;
-                break;
-            }
-        }
-        m_fixturePos.y += m_stageOffset;
-        m_anchorPositions.push_back(m_fixturePos);
-    }
-    else
-    {
-        m_fixturePos = m_anchorPositions[0];
-    }
+    m_stageOffset = assets.stageOffset;
+    m_anchorPositions = assets.anchorPositions;
+    m_fixturePos = assets.fixturePos;
 
     // Initialize spotlights
     m_spotlights.clear();
     m_fixtureNodes.clear();
+    m_fixtureLights.clear();
+
+    // Upload the GDTF fixture's models once; every instance shares them
+    const std::vector<std::shared_ptr<Mesh>> fixtureMeshes = GDTF::GDTFLoader::CreateMeshes(device, assets.fixture);
 
-    // Load GDTF fixture model once
-    GDTF::GDTFParser parser;
-    std::shared_ptr<SceneGraph::Node> gdtfRoot;
-    if (parser.Load(Config::Fixtures::DEFAULT_GDTF))
+    if (assets.goboStreamer)
     {
-        gdtfRoot = GDTF::GDTFLoader::BuildSceneGraph(device, parser);
+        InitializeGoboStreaming(device, assets);
     }
-
-    // Load gobo texture from GDTF (always includes Open as first slot)
-    m_goboTexture = std::make_unique<Texture>();
-    m_goboSlotNames.clear();
-    auto goboImages = parser.ExtractGoboImages();
-    m_goboTexture->CreateTextureArray(device, goboImages);
-
-    // Populate gobo slot names from GDTF
-    m_goboSlotNames.emplace_back("Open");
-    for (const auto &wheel : parser.GetGoboWheels())
+    else
     {
-        if (wheel.name.find("Gobo") == std::string::npos)
-            continue;
-        for (const auto &slot : wheel.slots)
-        {
-            if (!slot.media_file_name.empty())
-                m_goboSlotNames.push_back(slot.name);
-        }
+        m_goboLibrary = std::move(assets.goboLibrary);
+        m_goboFixture = assets.goboFixture;
+        UploadGoboLibrary(device, assets.goboClasses);
+        m_goboSlotNames = std::move(assets.goboSlotNames);
     }
 
     for (const auto &pos : m_anchorPositions)
     {
-        Spotlight light;
-        light.SetPosition(pos);
-
-        // Point towards center of stage
-        DirectX::XMVECTOR posVec = DirectX::XMLoadFloat3(&pos);
-        DirectX::XMVECTOR dirVec = DirectX::XMVector3Normalize(DirectX::XMVectorNegate(posVec));
-        DirectX::XMFLOAT3 dir;
-        DirectX::XMStoreFloat3(&dir, dirVec);
-        light.SetDirection(dir);
-
-        // Default gobo: index 1 if available, otherwise Open (0)
-        int defaultGobo = (m_goboSlotNames.size() > 1) ? 1 : 0;
-        light.SetGoboIndex(defaultGobo);
-
-        m_spotlights.push_back(light);
+        m_spotlights.push_back(CreateAnchorLight(pos));
 
         // Add GDTF fixture node at this anchor
-        if (gdtfRoot)
+        if (assets.fixture.IsLoaded())
         {
-            auto instanceRoot = GDTF::GDTFLoader::BuildSceneGraph(device, parser);
-            if (instanceRoot)
-            {
-                // Placement node handles the world position (Anchor point)
-                auto placementNode = std::make_shared<SceneGraph::Node>("Placement");
-                placementNode->SetTranslation(pos.x, pos.y, pos.z);
-
-                // Orientation node handles the flip (so the fixture hangs correctly)
-                auto orientationNode = std::make_shared<SceneGraph::Node>("Orientation");
-                // Rotate 90 degrees around X (Pitch) to make GDTF "Forward" point down (-Y)
-                orientationNode->SetRotation(DirectX::XM_PIDIV2, 0.0f, 0.0f);
-                // Scale 2x
-                orientationNode->SetScale(2.0f, 2.0f, 2.0f);
-
-                // Bring it up a little to touch the truss
-                placementNode->SetTranslation(pos.x, pos.y + 0.45f, pos.z);
-
-                placementNode->AddChild(orientationNode);
-                orientationNode->AddChild(instanceRoot);
-
-                // Link spotlight to nodes for animation
-                auto panNode = instanceRoot->FindChild("Yoke");
-                auto tiltNode = instanceRoot->FindChild("Head");
-                auto beamNode = instanceRoot->FindChild("Beam");
-
-                // Fallback: search for nodes containing the names if exact match fails
-                if (!panNode)
-                    panNode = instanceRoot->FindChild("Pan");
-                if (!tiltNode)
-                    tiltNode = instanceRoot->FindChild("Tilt");
-
-                m_spotlights.back().LinkNodes(panNode, tiltNode, beamNode);
-
-                m_fixtureNodes.push_back(placementNode);
-            }
+            auto placementNode = CreatePlacementNode(pos);
+            AttachFixture(placementNode, assets.fixture, fixtureMeshes, &m_spotlights.back());
+            m_fixtureNodes.push_back(placementNode);
+            m_fixtureLights.push_back(static_cast<int>(m_spotlights.size()) - 1);
         }
     }
+
+    // Fixtures patched later show this box until their type has loaded
+    constexpr float halfWidth = Config::Fixtures::PROXY_HALF_WIDTH;
+    MaterialData proxyMaterial;
+    proxyMaterial.diffuse = {0.3f, 0.3f, 0.3f};
+    const MeshData proxyBox = GeometryGenerator::CreateBoxMesh(
+        {-halfWidth, -Config::Fixtures::PROXY_HEIGHT, -halfWidth}, {halfWidth, 0.0f, halfWidth}, proxyMaterial);
+    m_fixtureProxyMesh = std::make_shared<Mesh>();
+    if (!m_fixtureProxyMesh->Create(device, proxyBox))
+    {
+        m_fixtureProxyMesh.reset();
+    }
+
     // Initialize camera
     m_camera.SetPerspective(Config::CameraDefaults::FOV, Config::Display::ASPECT_RATIO,
                             Config::CameraDefaults::CLIP_NEAR, Config::CameraDefaults::CLIP_FAR);
@@ -169,6 +124,9 @@ void Scene::Update(float deltaTime)
     // Apply demo effects
     m_effectsEngine.Update(m_spotlights, m_time);
 
+    // Advance the haze at its own fixed tick
+    m_haze.Update(deltaTime);
+
     // Sync spotlights with their respective nodes
     for (auto &light : m_spotlights)
     {
@@ -194,6 +152,266 @@ void Scene::UpdateCamera()
 void Scene::AddSpotlight(const Spotlight &light)
 {
     m_spotlights.push_back(light);
+
+    // A light made outside the scene has a slot but no library location yet
+    if (light.GetGoboClass() < 0)
+        SetGoboSlot(m_spotlights.back(), light.GetGoboIndex());
+}
+
+GDTF::FixtureLoader::Handle Scene::AddFixture(const std::string &gdtfFile, const DirectX::XMFLOAT3 &position)
+{
+    const GDTF::FixtureLoader::Handle type = m_fixtureLoader.Request(gdtfFile);
+    auto placement = CreatePlacementNode(position);
+
+    int light = -1;
+    if (m_spotlights.size() < static_cast<size_t>(Config::Spotlight::MAX_SPOTLIGHTS))
+    {
+        m_spotlights.push_back(CreateAnchorLight(position));
+        light = static_cast<int>(m_spotlights.size()) - 1;
+    }
+    m_fixtureNodes.push_back(placement);
+    m_fixtureLights.push_back(light);
+
+    // Another fixture of the same type may have brought it in already
+    const auto typeIndex = static_cast<size_t>(type);
+    if (typeIndex < m_patchedTypeMeshes.size() && !m_patchedTypeMeshes[typeIndex].empty())
+    {
+        AttachFixture(placement, *m_fixtureLoader.GetAsset(type), m_patchedTypeMeshes[typeIndex],
+                      light >= 0 ? &m_spotlights[static_cast<size_t>(light)] : nullptr);
+        return type;
+    }
+    if (m_fixtureLoader.GetState(type) == GDTF::FixtureLoader::State::Failed)
+        return type; // The light stays, without a body
+
+    PatchedFixture patched;
+    patched.type = type;
+    patched.placement = placement;
+    patched.proxy = std::make_shared<SceneGraph::MeshNode>(m_fixtureProxyMesh, "Proxy");
+    patched.light = light;
+    patched.center = {position.x, position.y + TRUSS_OFFSET - (Config::Fixtures::PROXY_HEIGHT * 0.5f), position.z};
+    placement->AddChild(patched.proxy);
+    m_patchedFixtures.push_back(std::move(patched));
+    return type;
+}
+
+void Scene::UpdateFixtureLoads(ID3D11Device *device)
+{
+    if (m_fixtureLoader.GetPendingCount() == 0)
+        return;
+
+    // Types with a box in view load first, then the ones closest to the camera
+    const DirectX::XMFLOAT3 eye = GetCameraPosition();
+    const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(
+        DirectX::XMMatrixIdentity(), m_camera.GetViewMatrix() * m_camera.GetProjectionMatrix(), eye);
+    constexpr float halfWidth = Config::Fixtures::PROXY_HALF_WIDTH;
+    constexpr float halfHeight = Config::Fixtures::PROXY_HEIGHT * 0.5f;
+    const float radius = sqrtf((2.0f * halfWidth * halfWidth) + (halfHeight * halfHeight));
+
+    const size_t typeCount = static_cast<size_t>(m_fixtureLoader.GetCount());
+    std::vector<char> visible(typeCount, 0);
+    std::vector<float> distance(typeCount, FLT_MAX);
+    for (const PatchedFixture &patched : m_patchedFixtures)
+    {
+        const DirectX::XMVECTOR center = DirectX::XMLoadFloat3(&patched.center);
+        bool inside = true;
+        for (const DirectX::XMFLOAT4 &plane : frustum.planes)
+        {
+            if (DirectX::XMVectorGetX(DirectX::XMPlaneDotCoord(DirectX::XMLoadFloat4(&plane), center)) < -radius)
+            {
+                inside = false;
+                break;
+            }
+        }
+        const float toEye = DirectX::XMVectorGetX(
+            DirectX::XMVector3Length(DirectX::XMVectorSubtract(center, DirectX::XMLoadFloat3(&eye))));
+        const auto type = static_cast<size_t>(patched.type);
+        visible[type] = static_cast<char>(visible[type] || inside);
+        distance[type] = (std::min)(distance[type], toEye);
+    }
+    for (size_t type = 0; type < typeCount; ++type)
+        m_fixtureLoader.SetPriority(static_cast<GDTF::FixtureLoader::Handle>(type), visible[type] != 0, distance[type]);
+
+    // Swap the finished types in for their boxes; the scene graph only changes between frames
+    m_fixtureLoader.Update(m_fixtureLoadsCompleted, Config::Fixtures::SWAPS_PER_FRAME);
+    m_patchedTypeMeshes.resize(typeCount);
+    for (GDTF::FixtureLoader::Handle type : m_fixtureLoadsCompleted)
+    {
+        const std::shared_ptr<const GDTF::FixtureAsset> asset = m_fixtureLoader.GetAsset(type);
+        if (asset)
+            m_patchedTypeMeshes[static_cast<size_t>(type)] = GDTF::GDTFLoader::CreateMeshes(device, *asset);
+
+        for (auto patched = m_patchedFixtures.begin(); patched != m_patchedFixtures.end();)
+        {
+            if (patched->type != type)
+            {
+                ++patched;
+                continue;
+            }
+            patched->placement->RemoveChild(patched->proxy);
+            if (asset)
+            {
+                Spotlight *light = patched->light >= 0 && static_cast<size_t>(patched->light) < m_spotlights.size()
+                                       ? &m_spotlights[static_cast<size_t>(patched->light)]
+                                       : nullptr;
+                AttachFixture(patched->placement, *asset, m_patchedTypeMeshes[static_cast<size_t>(type)], light);
+            }
+            patched = m_patchedFixtures.erase(patched);
+        }
+    }
+    m_fixtureLoadsCompleted.clear();
+}
+
+Spotlight Scene::CreateAnchorLight(const DirectX::XMFLOAT3 &pos) const
+{
+    Spotlight light;
+    light.SetPosition(pos);
+
+    // Point towards center of stage
+    DirectX::XMVECTOR posVec = DirectX::XMLoadFloat3(&pos);
+    DirectX::XMVECTOR dirVec = DirectX::XMVector3Normalize(DirectX::XMVectorNegate(posVec));
+    DirectX::XMFLOAT3 dir;
+    DirectX::XMStoreFloat3(&dir, dirVec);
+    light.SetDirection(dir);
+
+    // Default gobo: index 1 if available, otherwise Open (0)
+    int defaultGobo = (m_goboSlotNames.size() > 1) ? 1 : 0;
+    SetGoboSlot(light, defaultGobo);
+    return light;
+}
+
+std::shared_ptr<SceneGraph::Node> Scene::CreatePlacementNode(const DirectX::XMFLOAT3 &pos)
+{
+    // Placement node handles the world position (Anchor point)
+    auto placementNode = std::make_shared<SceneGraph::Node>("Placement");
+    placementNode->SetTranslation(pos.x, pos.y + TRUSS_OFFSET, pos.z);
+    return placementNode;
+}
+
+void Scene::AttachFixture(const std::shared_ptr<SceneGraph::Node> &placement, const GDTF::FixtureAsset &asset,
+                          const std::vector<std::shared_ptr<Mesh>> &meshes, Spotlight *light)
+{
+    auto instanceRoot = GDTF::GDTFLoader::Instantiate(asset, meshes);
+    if (!instanceRoot)
+        return;
+
+    // Orientation node handles the flip (so the fixture hangs correctly)
+    auto orientationNode = std::make_shared<SceneGraph::Node>("Orientation");
+    // Rotate 90 degrees around X (Pitch) to make GDTF "Forward" point down (-Y)
+    orientationNode->SetRotation(DirectX::XM_PIDIV2, 0.0f, 0.0f);
+    // Scale 2x
+    orientationNode->SetScale(2.0f, 2.0f, 2.0f);
+
+    placement->AddChild(orientationNode);
+    orientationNode->AddChild(instanceRoot);
+    if (!light)
+        return;
+
+    // Link spotlight to nodes for animation
+    auto panNode = instanceRoot->FindChild("Yoke");
+    auto tiltNode = instanceRoot->FindChild("Head");
+    auto beamNode = instanceRoot->FindChild("Beam");
+
+    // Fallback: search for nodes containing the names if exact match fails
+    if (!panNode)
+        panNode = instanceRoot->FindChild("Pan");
+    if (!tiltNode)
+        tiltNode = instanceRoot->FindChild("Tilt");
+
+    light->LinkNodes(panNode, tiltNode, beamNode);
+}
+
+void Scene::SetGoboSlot(Spotlight &light, int slot) const
+{
+    if (m_goboStreamer)
+    {
+        if (slot < 0 || static_cast<size_t>(slot) >= m_goboSlotKeys.size())
+            slot = 0;
+        const int layer = m_goboStreamer->GetLayer(m_goboSlotKeys[static_cast<size_t>(slot)]);
+        light.SetGobo(slot, 0, layer >= 0 ? layer : GoboStreamer::PLACEHOLDER_LAYER);
+        return;
+    }
+
+    if (m_goboFixture < 0)
+        return;
+    const auto &slots = m_goboLibrary.GetSlots(m_goboFixture);
+    if (slot < 0 || static_cast<size_t>(slot) >= slots.size() || slots[static_cast<size_t>(slot)].sizeClass < 0)
+        slot = 0;
+    const GoboLibrary::SlotRef &ref = slots[static_cast<size_t>(slot)];
+    light.SetGobo(slot, ref.sizeClass, ref.layer);
+}
+
+void Scene::PrefetchGoboSlot(int slot)
+{
+    if (m_goboStreamer && slot >= 0 && static_cast<size_t>(slot) < m_goboSlotKeys.size())
+        m_goboStreamer->Prefetch(m_goboSlotKeys[static_cast<size_t>(slot)]);
+}
+
+void Scene::UpdateGobos(ID3D11DeviceContext *context)
+{
+    if (!m_goboStreamer)
+        return;
+
+    // Each light shows its slot; a wheel turns through the neighbouring slots, so those come next
+    const int slotCount = static_cast<int>(m_goboSlotKeys.size());
+    for (const Spotlight &light : m_spotlights)
+    {
+        const int slot = light.GetGoboIndex();
+        if (slot < 0 || slot >= slotCount)
+            continue;
+        m_goboStreamer->Request(m_goboSlotKeys[static_cast<size_t>(slot)]);
+        for (int step = 1; step <= Config::Gobo::STREAM_LOOKAHEAD; ++step)
+        {
+            PrefetchGoboSlot(slot - step);
+            PrefetchGoboSlot(slot + step);
+        }
+    }
+
+    // Copy what finished decoding (and the placeholder, on the first frame) into the pool; a slice
+    // the pool rejects leaves its layer undefined, so its slot falls back to the placeholder
+    m_goboStreamer->Update(m_goboUploads, Config::Gobo::STREAM_UPLOADS_PER_FRAME);
+    for (const GoboStreamer::Upload &upload : m_goboUploads)
+    {
+        if (!m_goboTextures[0]->UpdateLayer(context, upload.layer, upload.baked))
+            m_goboStreamer->RejectUpload(upload.key);
+    }
+    m_goboUploads.clear();
+
+    for (Spotlight &light : m_spotlights)
+        SetGoboSlot(light, light.GetGoboIndex());
+}
+
+void Scene::InitializeGoboStreaming(ID3D11Device *device, SceneAssets &assets)
+{
+    GoboStreamer &streamer = *assets.goboStreamer;
+    auto pool = std::make_unique<Texture>();
+    if (!pool->CreateLayerPool(device, streamer.GetLayerSize(), streamer.GetCapacity(), streamer.GetFormat()))
+        return; // Lights go without a gobo
+    m_goboTextures.clear();
+    m_goboTextures.push_back(std::move(pool));
+
+    // The placeholder is uploaded with the first frame's slots
+    m_goboStreamer = std::move(assets.goboStreamer);
+    m_goboSlotKeys = std::move(assets.goboSlotKeys);
+    m_goboUploads = std::move(assets.goboUploads);
+    m_goboSlotNames = std::move(assets.goboSlotNames);
+}
+
+void Scene::UploadGoboLibrary(ID3D11Device *device, const std::vector<TextureBaker::BakedTexture> &baked)
+{
+    const int classCount = m_goboLibrary.GetSizeClassCount();
+    m_goboTextures.resize(static_cast<size_t>(classCount));
+    m_goboRevisions.resize(static_cast<size_t>(classCount), 0);
+    for (size_t i = 0; i < baked.size() && i < m_goboTextures.size(); ++i)
+    {
+        if (baked[i].layers == 0)
+            continue; // Unchanged, or did not bake: lights of this class keep the previous array
+
+        auto created = std::make_unique<Texture>();
+        if (!created->CreateFromBaked(device, baked[i], true))
+            continue;
+        m_goboTextures[i] = std::move(created);
+        m_goboRevisions[i] = m_goboLibrary.GetSizeClass(static_cast<int>(i)).revision;
+    }
 }
 
 void Scene::RemoveSpotlight(size_t index)
@@ -201,5 +419,19 @@ void Scene::RemoveSpotlight(size_t index)
     if (index < m_spotlights.size() && m_spotlights.size() > 1)
     {
         m_spotlights.erase(m_spotlights.begin() + static_cast<std::ptrdiff_t>(index));
+
+        // Fixtures keep driving the same lights, which moved down one
+        const int removed = static_cast<int>(index);
+        auto renumber = [removed](int &light)
+        {
+            if (light == removed)
+                light = -1;
+            else if (light > removed)
+                --light;
+        };
+        for (int &light : m_fixtureLights)
+            renumber(light);
+        for (PatchedFixture &patched : m_patchedFixtures)
+            renumber(patched.light);
     }
 }
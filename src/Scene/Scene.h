@@ -3,13 +3,18 @@
 #include <memory>
 #include <vector>
 #include "../Core/Config.h"
+#include "../GDTF/FixtureLoader.h"
 #include "../GDTF/GDTFLoader.h"
 #include "../GDTF/GDTFParser.h"
+#include "../Resources/GoboLibrary.h"
+#include "../Resources/GoboStreamer.h"
 #include "../Resources/Mesh.h"
 #include "../Resources/Texture.h"
 #include "Camera.h"
 #include "CeilingLights.h"
 #include "EffectsEngine.h"
+#include "HazeSimulation.h"
+#include "SceneAssets.h"
 #include "Spotlight.h"
 
 // Scene container class
@@ -37,13 +42,24 @@ public:
     ~Scene() = default;
 
     /**
-     * @brief Initializes scene resources like meshes and textures.
+     * @brief Initializes scene resources like meshes and textures, loading them on this thread.
      *
      * @param device Pointer to the ID3D11Device used for resource creation.
      * @return true if initialization was successful, false otherwise.
      */
     bool Initialize(ID3D11Device *device);
 
+    /**
+     * @brief Initializes the scene from assets loaded beforehand (see SceneAssets::Load()), which
+     * may have run on another thread: creates the buffers and textures in one batch and builds
+     * the spotlights and fixture instances.
+     *
+     * @param device Pointer to the ID3D11Device used for resource creation.
+     * @param assets Loaded assets; the gobo data is moved out of them.
+     * @return true if initialization was successful, false otherwise.
+     */
+    bool Initialize(ID3D11Device *device, SceneAssets &assets);
+
     /**
      * @brief Updates the scene state for a single frame.
      *
@@ -201,23 +217,60 @@ public:
     }
 
     /**
-     * @brief Gets the gobo texture pointer.
-     * @return Pointer to the gobo Texture.
+     * @brief Gets the texture array of a gobo library size class, or the streaming pool (class 0)
+     * when slots are streamed.
+     * @param sizeClass Size class index (see Spotlight::GetGoboClass()).
+     * @return Pointer to the gobo Texture, or nullptr if there is none.
      */
-    Texture *GetGoboTexture()
+    [[nodiscard]] Texture *GetGoboTexture(int sizeClass) const
     {
-        return m_goboTexture.get();
+        if (sizeClass < 0 || static_cast<size_t>(sizeClass) >= m_goboTextures.size())
+            return nullptr;
+        return m_goboTextures[static_cast<size_t>(sizeClass)].get();
     }
 
     /**
-     * @brief Gets the gobo texture pointer (const).
-     * @return Const pointer to the gobo Texture.
+     * @brief Gets the gobo images shared by the loaded fixture types.
+     * @return Const reference to the GoboLibrary.
      */
-    [[nodiscard]] const Texture *GetGoboTexture() const
+    [[nodiscard]] const GoboLibrary &GetGoboLibrary() const
     {
-        return m_goboTexture.get();
+        return m_goboLibrary;
     }
 
+    /**
+     * @brief Gets the gobo slot streamer.
+     * @return Pointer to the GoboStreamer, or nullptr when every gobo is loaded at startup.
+     */
+    [[nodiscard]] const GoboStreamer *GetGoboStreamer() const
+    {
+        return m_goboStreamer.get();
+    }
+
+    /**
+     * @brief Selects a gobo slot of the fixture's wheels, through the fixture's library remap or,
+     * when streaming, the pool layer the slot is resident in (the placeholder until it is).
+     *
+     * @param light Spotlight to change.
+     * @param slot 0-based slot (0 is Open); slots out of range or without an image pick Open.
+     */
+    void SetGoboSlot(Spotlight &light, int slot) const;
+
+    /**
+     * @brief Starts streaming a slot that is about to be selected (e.g. the next cue).
+     * @param slot 0-based slot; ignored when not streaming or out of range.
+     */
+    void PrefetchGoboSlot(int slot);
+
+    /**
+     * @brief Streams the slots the lights select and their wheel neighbours, copies the slots
+     * decoded since the last frame into the pool and points the lights at their layers. Does
+     * nothing when every gobo is loaded at startup.
+     *
+     * @param context Pointer to the ID3D11DeviceContext.
+     */
+    void UpdateGobos(ID3D11DeviceContext *context);
+
     /**
      * @brief Gets the list of anchor positions.
      * @return Const reference to the vector of anchor positions.
@@ -245,6 +298,48 @@ public:
         return m_fixtureNodes;
     }
 
+    /**
+     * @brief Gets the spotlight each fixture placement node drives.
+     * @return Indices into GetSpotlights(), parallel to GetFixtureNodes(); -1 for a fixture
+     * without a light.
+     */
+    [[nodiscard]] const std::vector<int> &GetFixtureLights() const
+    {
+        return m_fixtureLights;
+    }
+
+    /**
+     * @brief Patches a fixture: hangs a box at the position right away and loads its type in
+     * the background (see UpdateFixtureLoads()). Types already loaded are instantiated at once.
+     *
+     * The fixture drives a new spotlight while there are fewer than
+     * Config::Spotlight::MAX_SPOTLIGHTS.
+     *
+     * @param gdtfFile Path to the fixture type's .gdtf.
+     * @param position Anchor position the fixture hangs from.
+     * @return Handle of the fixture type in GetFixtureLoader().
+     */
+    GDTF::FixtureLoader::Handle AddFixture(const std::string &gdtfFile, const DirectX::XMFLOAT3 &position);
+
+    /**
+     * @brief Ranks the fixture types still loading by how visible and close their boxes are,
+     * and swaps the types that finished loading in for their boxes, a few per frame.
+     *
+     * Called once per frame before Update(), so the swap happens between frames.
+     *
+     * @param device Pointer to the ID3D11Device, for the models of the finished types.
+     */
+    void UpdateFixtureLoads(ID3D11Device *device);
+
+    /**
+     * @brief Gets the background loader of the patched fixture types.
+     * @return Const reference to the FixtureLoader.
+     */
+    [[nodiscard]] const GDTF::FixtureLoader &GetFixtureLoader() const
+    {
+        return m_fixtureLoader;
+    }
+
     /**
      * @brief Gets the list of gobo slot names for the current wheel.
      * @return Const reference to the vector of strings.
@@ -334,7 +429,73 @@ public:
         return m_effectsEngine;
     }
 
+    /**
+     * @brief Gets the haze simulation for modification.
+     * @return Reference to the HazeSimulation.
+     */
+    HazeSimulation &GetHaze()
+    {
+        return m_haze;
+    }
+
+    /**
+     * @brief Gets the haze simulation.
+     * @return Const reference to the HazeSimulation.
+     */
+    [[nodiscard]] const HazeSimulation &GetHaze() const
+    {
+        return m_haze;
+    }
+
 private:
+    /**
+     * @brief Creates the texture arrays of the gobo size classes baked by
+     * SceneAssets::BakeGoboClasses(), and records their revisions.
+     */
+    void UploadGoboLibrary(ID3D11Device *device, const std::vector<TextureBaker::BakedTexture> &baked);
+
+    /**
+     * @brief Creates the streaming pool and takes over the streamer the assets registered every
+     * wheel slot with; the placeholder goes up with the first frame's slots.
+     */
+    void InitializeGoboStreaming(ID3D11Device *device, SceneAssets &assets);
+
+    /**
+     * @brief Creates a spotlight at an anchor, aimed at the centre of the stage, with the
+     * default gobo.
+     */
+    [[nodiscard]] Spotlight CreateAnchorLight(const DirectX::XMFLOAT3 &pos) const;
+
+    /**
+     * @brief Hangs an instance of a fixture type below a placement node and links a spotlight to
+     * its yoke, head and beam.
+     *
+     * @param placement Node at the anchor (see CreatePlacementNode()).
+     * @param asset Loaded fixture type.
+     * @param meshes The type's uploaded models.
+     * @param light Spotlight the fixture drives, or nullptr.
+     */
+    static void AttachFixture(const std::shared_ptr<SceneGraph::Node> &placement, const GDTF::FixtureAsset &asset,
+                              const std::vector<std::shared_ptr<Mesh>> &meshes, Spotlight *light);
+
+    /**
+     * @brief Creates the node a fixture hangs from, just above an anchor.
+     */
+    static std::shared_ptr<SceneGraph::Node> CreatePlacementNode(const DirectX::XMFLOAT3 &pos);
+
+    /**
+     * @struct PatchedFixture
+     * @brief A fixture patched with AddFixture() whose type has not finished loading.
+     */
+    struct PatchedFixture
+    {
+        GDTF::FixtureLoader::Handle type = 0;
+        std::shared_ptr<SceneGraph::Node> placement;
+        std::shared_ptr<SceneGraph::Node> proxy;
+        int light = -1;           ///< Index into m_spotlights, -1 without a light.
+        DirectX::XMFLOAT3 center; ///< World centre of the box, for ranking.
+    };
+
     // Camera
     Camera m_camera;
     float m_camDistance;
@@ -348,7 +509,17 @@ private:
 
     // Meshes and textures
     std::unique_ptr<Mesh> m_stageMesh;
-    std::unique_ptr<Texture> m_goboTexture;
+
+    // Gobos: one texture array per library size class, rebaked when its revision changes
+    GoboLibrary m_goboLibrary;
+    std::vector<std::unique_ptr<Texture>> m_goboTextures;
+    std::vector<uint32_t> m_goboRevisions;
+    int m_goboFixture{-1};
+
+    // Streamed gobos (Config::Gobo::STREAMING): m_goboTextures holds the pool alone
+    std::unique_ptr<GoboStreamer> m_goboStreamer;
+    std::vector<GoboStreamer::Key> m_goboSlotKeys;
+    std::vector<GoboStreamer::Upload> m_goboUploads;
 
     // Derived from mesh
     std::vector<DirectX::XMFLOAT3> m_anchorPositions;
@@ -357,8 +528,16 @@ private:
 
     // GDTF Fixtures
     std::vector<std::shared_ptr<SceneGraph::Node>> m_fixtureNodes;
+    std::vector<int> m_fixtureLights; ///< Spotlight of each fixture node, -1 for none.
     std::vector<std::string> m_goboSlotNames;
 
+    // Fixtures patched at runtime: boxes until their type has loaded in the background
+    GDTF::FixtureLoader m_fixtureLoader{Config::Fixtures::MAX_BACKGROUND_LOADS};
+    std::shared_ptr<Mesh> m_fixtureProxyMesh;
+    std::vector<std::vector<std::shared_ptr<Mesh>>> m_patchedTypeMeshes; ///< By loader handle.
+    std::vector<PatchedFixture> m_patchedFixtures;
+    std::vector<GDTF::FixtureLoader::Handle> m_fixtureLoadsCompleted;
+
     // Room materials
     float m_roomSpecular;
     float m_roomShininess;
@@ -370,6 +549,9 @@ private:
     // Effects Engine
     EffectsEngine m_effectsEngine;
 
+    // Haze density over the room
+    HazeSimulation m_haze;
+
     // Time
     float m_time{0.0f};
 };
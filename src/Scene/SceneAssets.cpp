@@ -0,0 +1,192 @@
+/**
+ * @file SceneAssets.cpp
+ * @brief Implementation of the CPU loading phase of the scene.
+ */
+
+#include "SceneAssets.h"
+#include "../Core/Config.h"
+#include "../Core/ThreadPool.h"
+
+bool SceneAssets::Load(const std::string &stageFile, const std::string &fixtureFile)
+{
+    TaskGraph graph;
+    AddTasks(graph, stageFile, fixtureFile);
+    return graph.Run(ThreadPool::Shared());
+}
+
+TaskGraph::TaskId SceneAssets::AddTasks(TaskGraph &graph, const std::string &stageFile,
+                                        const std::string &fixtureFile)
+{
+    auto loadStage = [this, stageFile]() { return LoadStage(stageFile); };
+    const TaskGraph::TaskId stageTask = graph.Add("stage " + stageFile, loadStage);
+
+    // Load GDTF fixture model once; the gobos come from the same archive. A fixture that does
+    // not load is not an error: the scene goes without its models and gobos
+    auto parser = std::make_shared<GDTF::GDTFParser>();
+    auto parse = [parser, fixtureFile]()
+    {
+        parser->Load(fixtureFile);
+        return true;
+    };
+    const TaskGraph::TaskId parseTask = graph.Add("GDTF " + fixtureFile, parse);
+
+    // Every extraction opens the archive on its own, so models and gobos extract side by side;
+    // each model found in the geometry tree is then imported as a task of its own
+    auto extract = [this, &graph, parser]()
+    {
+        if (!fixture.Extract(*parser))
+            return true;
+        const std::vector<std::string> &files = fixture.GetModelFiles();
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            graph.Spawn("model " + files[i], [this, i]() {
+                fixture.ImportModel(i);
+                return true;
+            });
+        }
+        return true;
+    };
+    auto finish = [this]()
+    {
+        fixture.Finish();
+        return true;
+    };
+    auto loadGobos = [this, parser, fixtureFile]()
+    {
+        LoadGobos(*parser, fixtureFile);
+        return true;
+    };
+    const TaskGraph::TaskId extractTask = graph.Add("fixture geometry", extract, {parseTask});
+    const TaskGraph::TaskId modelsTask = graph.Add("fixture models", finish, {extractTask});
+    const TaskGraph::TaskId gobosTask = graph.Add("gobos", loadGobos, {parseTask});
+
+    return graph.Add("scene assets", []() { return true; }, {stageTask, modelsTask, gobosTask});
+}
+
+bool SceneAssets::LoadStage(const std::string &stageFile)
+{
+    if (!stage.LoadOBJ(stageFile))
+    {
+        return false;
+    }
+
+    // Calculate stage offset
+    stageOffset = Config::Room::FLOOR_Y - stage.GetMinY();
+
+    // Find anchor points from mesh
+    anchorPositions.clear();
+    for (const auto &shape : stage.GetShapes())
+    {
+        if (shape.name.find("Anchor.") == 0)
+        {
+            DirectX::XMFLOAT3 pos = shape.center;
+            pos.y += stageOffset;
+            anchorPositions.push_back(pos);
+        }
+    }
+
+    // Fallback if no anchors found
+    if (anchorPositions.empty())
+    {
+        fixturePos = {0.0f, Config::Spotlight::DEFAULT_HEIGHT, 0.0f};
+        for (const auto &shape : stage.GetShapes())
+        {
+            if (shape.name == "Cylinder.000")
+            {
+                fixturePos = shape.center;
+                break;
+            }
+        }
+        fixturePos.y += stageOffset;
+        anchorPositions.push_back(fixturePos);
+    }
+    else
+    {
+        fixturePos = anchorPositions[0];
+    }
+    return true;
+}
+
+bool SceneAssets::LoadFixture(GDTF::GDTFParser &parser)
+{
+    return fixture.Load(parser);
+}
+
+void SceneAssets::LoadGobos(GDTF::GDTFParser &parser, const std::string &fixtureFile)
+{
+    goboSlotNames.assign(1, "Open");
+    if (Config::Gobo::STREAMING)
+    {
+        // Any wheel may hold color images, so the pool takes the color format
+        const TextureBaker::Format format = !Config::Gobo::COMPRESS ? TextureBaker::Format::RGBA8
+                                            : Config::Gobo::COLOR_BC7 ? TextureBaker::Format::BC7
+                                                                      : TextureBaker::Format::BC1;
+        goboStreamer = std::make_unique<GoboStreamer>(Config::Gobo::STREAM_POOL_LAYERS,
+                                                      Config::Gobo::STREAM_LAYER_SIZE, format,
+                                                      Config::Gobo::STREAM_MAX_DECODES);
+
+        // Open is the first slot and the placeholder, uploaded with the first frame's slots
+        goboSlotKeys.assign(1, goboStreamer->AddMedia(GDTF::GDTFParser::CreateOpenGoboImage()));
+        goboUploads.clear();
+        GoboStreamer::Upload placeholder;
+        if (goboStreamer->SetPlaceholder(goboSlotKeys[0], placeholder))
+            goboUploads.push_back(std::move(placeholder));
+
+        // Every wheel's images (gobos, animation positions, prisms) only keep their file until selected
+        for (GDTF::WheelMedia &media : parser.ExtractWheelMedia())
+        {
+            goboSlotNames.push_back(media.slot);
+            goboSlotKeys.push_back(goboStreamer->AddMedia(std::move(media.data)));
+        }
+        return;
+    }
+
+    // Add the fixture's gobos to the library (Open is always the first slot); only images new
+    // to the library take memory, and only the size classes they land in are baked again
+    goboFixture = goboLibrary.AddFixture(fixtureFile, parser.ExtractGoboImages());
+    BakeGoboClasses(goboLibrary, {}, goboClasses);
+
+    // Populate gobo slot names from GDTF
+    for (const auto &wheel : parser.GetGoboWheels())
+    {
+        if (wheel.name.find("Gobo") == std::string::npos)
+            continue;
+        for (const auto &slot : wheel.slots)
+        {
+            if (!slot.media_file_name.empty())
+                goboSlotNames.push_back(slot.name);
+        }
+    }
+}
+
+void SceneAssets::BakeGoboClasses(const GoboLibrary &library, const std::vector<uint32_t> &uploadedRevisions,
+                                  std::vector<TextureBaker::BakedTexture> &outBaked)
+{
+    const int classCount = library.GetSizeClassCount();
+    outBaked.assign(static_cast<size_t>(classCount), {});
+    for (int i = 0; i < classCount; ++i)
+    {
+        const GoboLibrary::SizeClass &sizeClass = library.GetSizeClass(i);
+        const auto index = static_cast<size_t>(i);
+        if (index < uploadedRevisions.size() && uploadedRevisions[index] == sizeClass.revision)
+            continue;
+
+        // Immutable arrays cannot grow: a class that gained slices is baked and created again
+        const std::string cacheFile = TextureBaker::GetCachePath(std::string(Config::Gobo::LIBRARY_CACHE_PREFIX) +
+                                                                 "_" + std::to_string(sizeClass.size));
+        if (!TextureBaker::BakeCached(sizeClass.image, cacheFile, outBaked[index]))
+            outBaked[index] = {}; // Lights of this class keep the previous array, or go without a gobo
+    }
+}
+
+uint64_t SceneAssets::GetUploadBytes() const
+{
+    uint64_t bytes = stage.GetUploadBytes();
+    for (const MeshAsset &mesh : fixture.GetMeshes())
+        bytes += mesh.GetUploadBytes();
+    for (const auto &baked : goboClasses)
+        bytes += baked.data.size();
+    for (const auto &upload : goboUploads)
+        bytes += upload.baked.data.size();
+    return bytes;
+}
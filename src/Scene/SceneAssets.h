@@ -0,0 +1,122 @@
+/**
+ * @file SceneAssets.h
+ * @brief Everything the scene loads from disk, prepared on the CPU for one batched upload.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Core/TaskGraph.h"
+#include "../GDTF/FixtureAsset.h"
+#include "../GDTF/GDTFParser.h"
+#include "../Resources/GoboLibrary.h"
+#include "../Resources/GoboStreamer.h"
+#include "../Resources/MeshAsset.h"
+#include "../Resources/TextureBaker.h"
+
+/**
+ * @struct SceneAssets
+ * @brief The first of the two loading phases: the stage mesh, the fixture type and its gobos,
+ * loaded and processed without a device.
+ *
+ * Load() parses the stage OBJ (or maps its cache), finds the anchors the fixtures hang from,
+ * imports the GDTF's models and decodes and bakes its gobos, touching nothing but these
+ * members, so it can run on any thread (behind a loading screen, or in a test). It runs the
+ * tasks AddTasks() adds to a TaskGraph, so the stage, each fixture model and the gobos load
+ * side by side. The second phase, Scene::Initialize(device, assets), only creates buffers and
+ * textures from them.
+ */
+struct SceneAssets
+{
+    // Stage
+    MeshAsset stage;
+    float stageOffset = 0.0f;                       ///< Lift that puts the stage on Config::Room::FLOOR_Y.
+    std::vector<DirectX::XMFLOAT3> anchorPositions; ///< Where fixtures hang, never empty after LoadStage().
+    DirectX::XMFLOAT3 fixturePos = {0.0f, 0.0f, 0.0f};
+
+    // Fixture type
+    GDTF::FixtureAsset fixture;
+    std::vector<std::string> goboSlotNames; ///< Open first, then the fixture's slots.
+
+    // Gobos loaded at startup: the library and its size classes, baked
+    GoboLibrary goboLibrary;
+    int goboFixture = -1;
+    std::vector<TextureBaker::BakedTexture> goboClasses;
+
+    // Streamed gobos (Config::Gobo::STREAMING): the registered slots and the placeholder
+    std::unique_ptr<GoboStreamer> goboStreamer;
+    std::vector<GoboStreamer::Key> goboSlotKeys;
+    std::vector<GoboStreamer::Upload> goboUploads;
+
+    /**
+     * @brief Runs LoadStage(), then LoadFixture() and LoadGobos() on the parsed GDTF.
+     *
+     * A GDTF that does not load leaves the scene without fixture models and with the Open gobo
+     * alone.
+     *
+     * @param stageFile Path to the stage .obj.
+     * @param fixtureFile Path to the .gdtf.
+     * @return False if the stage cannot be loaded.
+     */
+    bool Load(const std::string &stageFile, const std::string &fixtureFile);
+
+    /**
+     * @brief Adds what Load() does to a task graph, as tasks that overlap: the stage, the GDTF
+     * description, one import per fixture model once it is parsed, and the gobos.
+     *
+     * The assets must outlive the graph's Run(). Only the stage task can fail; a GDTF that does
+     * not load behaves as in Load().
+     *
+     * @param graph Graph the tasks are added to.
+     * @param stageFile Path to the stage .obj.
+     * @param fixtureFile Path to the .gdtf.
+     * @return A task that completes once all the assets are loaded, for tasks that use them.
+     */
+    TaskGraph::TaskId AddTasks(TaskGraph &graph, const std::string &stageFile, const std::string &fixtureFile);
+
+    /**
+     * @brief Loads the stage mesh and derives the stage offset and the anchor positions from its
+     * shapes ("Anchor.*", or the truss cylinder when there is none).
+     *
+     * @param stageFile Path to the stage .obj.
+     * @return False if the file cannot be loaded.
+     */
+    bool LoadStage(const std::string &stageFile);
+
+    /**
+     * @brief Imports the fixture type's geometry tree and models.
+     *
+     * @param parser A GDTFParser that has loaded the fixture.
+     * @return False if the GDTF has no geometry.
+     */
+    bool LoadFixture(GDTF::GDTFParser &parser);
+
+    /**
+     * @brief Prepares the fixture's wheel images: registered with a new GoboStreamer, Open
+     * decoded as its placeholder, when streaming; otherwise added to the library and baked.
+     *
+     * @param parser A GDTFParser that has loaded the fixture (or not: Open is always there).
+     * @param fixtureFile Path of the .gdtf, the fixture's name in the library.
+     */
+    void LoadGobos(GDTF::GDTFParser &parser, const std::string &fixtureFile);
+
+    /**
+     * @brief Bakes the size classes of a library that changed since they were last uploaded.
+     *
+     * @param library Gobo library.
+     * @param uploadedRevisions Revision each class had at its last upload (missing: never uploaded).
+     * @param outBaked Receives one texture per class, with no layers for the unchanged ones.
+     */
+    static void BakeGoboClasses(const GoboLibrary &library, const std::vector<uint32_t> &uploadedRevisions,
+                                std::vector<TextureBaker::BakedTexture> &outBaked);
+
+    /**
+     * @brief Gets the number of bytes the upload copies to the GPU: mesh buffers, baked gobo
+     * classes and the placeholder slice.
+     */
+    [[nodiscard]] uint64_t GetUploadBytes() const;
+};
@@ -0,0 +1,16 @@
+#include "ShadowCasters.h"
+
+namespace ShadowCasters
+{
+
+void Select(const std::vector<int> &fixtureLights, size_t fixtureCount, int light, std::vector<size_t> &outFixtures)
+{
+    outFixtures.clear();
+    for (size_t f = 0; f < fixtureCount; ++f)
+    {
+        if (f >= fixtureLights.size() || fixtureLights[f] != light)
+            outFixtures.push_back(f);
+    }
+}
+
+} // namespace ShadowCasters
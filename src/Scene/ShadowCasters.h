@@ -0,0 +1,33 @@
+/**
+ * @file ShadowCasters.h
+ * @brief Picks the fixtures that cast into a spotlight's shadow map.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @namespace ShadowCasters
+ * @brief Fixture shadow casting (Config::Shadow::FIXTURE_CASTERS).
+ *
+ * A fixture's own light sits inside its head, so that fixture would cover the whole shadow map;
+ * every other fixture casts into it. Which light a fixture drives comes from the scene's
+ * fixture-to-light map, since fixtures without a light (or past MAX_SPOTLIGHTS) shift the
+ * indices apart.
+ */
+namespace ShadowCasters
+{
+
+/**
+ * @brief Collects the fixtures that cast into a light's shadow map.
+ *
+ * @param fixtureLights Light each fixture drives, -1 for none (Scene::GetFixtureLights()).
+ * @param fixtureCount Number of fixture nodes; fixtures past the map drive no light.
+ * @param light Index of the light whose shadow map is rendered.
+ * @param outFixtures Receives the casting fixtures' indices, in order (cleared first).
+ */
+void Select(const std::vector<int> &fixtureLights, size_t fixtureCount, int light, std::vector<size_t> &outFixtures);
+
+} // namespace ShadowCasters
@@ -82,9 +82,11 @@ void Spotlight::SetGoboRotation(float rotation)
     m_data.coneGobo.z = rotation;
 }
 
-void Spotlight::SetGoboIndex(int index)
+void Spotlight::SetGobo(int slot, int sizeClass, int layer)
 {
-    m_data.coneGobo.w = static_cast<float>(index);
+    m_goboSlot = slot;
+    m_goboClass = sizeClass;
+    m_data.coneGobo.w = static_cast<float>(layer);
 }
 
 void Spotlight::SetGoboShake(float amount)
@@ -12,15 +12,18 @@ class Node;
 /**
  * @struct SpotlightData
  * @brief GPU-aligned structure for the spotlight constant buffer.
+ *
+ * Spotlight leaves dirAngle.w and goboOff.zw at 0; VolumetricPass fills them in its own copy
+ * each frame, and the scene shader does not read them.
  */
-__declspec(align(16)) struct SpotlightData
+struct alignas(16) SpotlightData
 {
     DirectX::XMMATRIX lightViewProj; ///< Light's view-projection matrix for shadow mapping.
     DirectX::XMFLOAT4 posRange;      ///< xyz: position, w: range.
-    DirectX::XMFLOAT4 dirAngle;      ///< xyz: direction, w: spot angle (not used in current shader).
+    DirectX::XMFLOAT4 dirAngle;      ///< xyz: direction, w: nearest view depth of the beam (tile mask on).
     DirectX::XMFLOAT4 colorInt;      ///< xyz: RGB color, w: intensity.
-    DirectX::XMFLOAT4 coneGobo;      ///< x: beam angle, y: field angle, z: rotation, w: unused.
-    DirectX::XMFLOAT4 goboOff;       ///< xy: gobo texture offset (shake), zw: unused.
+    DirectX::XMFLOAT4 coneGobo;      ///< x: beam angle, y: field angle, z: rotation, w: gobo array layer.
+    DirectX::XMFLOAT4 goboOff;       ///< xy: gobo offset (shake), z: analytic beam core, w: steps (0: volParams.x).
 };
 
 /**
@@ -109,10 +112,16 @@ public:
     void SetGoboRotation(float rotation);
 
     /**
-     * @brief Sets the active gobo index (slot number).
-     * @param index 0-based index of the gobo in the texture array.
+     * @brief Sets the active gobo.
+     *
+     * The slot is the position on the fixture's wheel; the size class and layer say where its
+     * image lives in the GoboLibrary (see Scene::SetGoboSlot()).
+     *
+     * @param slot 0-based slot on the wheel (0 is Open).
+     * @param sizeClass GoboLibrary size class, the texture array the light samples.
+     * @param layer Slice of that array.
      */
-    void SetGoboIndex(int index);
+    void SetGobo(int slot, int sizeClass, int layer);
 
     /**
      * @brief Sets the intensity of the gobo "shake" animation.
@@ -222,12 +231,21 @@ public:
     }
 
     /**
-     * @brief Gets the gobo index.
-     * @return Index value.
+     * @brief Gets the gobo slot on the fixture's wheel.
+     * @return Slot index (0 is Open).
      */
     [[nodiscard]] int GetGoboIndex() const
     {
-        return static_cast<int>(m_data.coneGobo.w);
+        return m_goboSlot;
+    }
+
+    /**
+     * @brief Gets the GoboLibrary size class of the active gobo.
+     * @return Size class index, or -1 if none was set.
+     */
+    [[nodiscard]] int GetGoboClass() const
+    {
+        return m_goboClass;
     }
 
     /**
@@ -271,6 +289,8 @@ public:
 private:
     SpotlightData m_data;
     float m_goboShakeAmount{0.0f};
+    int m_goboSlot{0};
+    int m_goboClass{-1};
 
     // GDTF Animation
     float m_pan{0.0f};
@@ -1,4 +1,6 @@
 #include "UIRenderer.h"
+#include <filesystem>
+#include <system_error>
 #include "../Core/Config.h"
 #include "../Rendering/RenderPipeline.h"
 #include "../Scene/Scene.h"
@@ -137,6 +139,34 @@ void UIRenderer::RenderControls(UIContext &ctx)
         ImGui::SliderFloat("Room Shininess", &scene.RoomShininess(), 1.0f, 128.0f);
     }
 
+    if (ImGui::CollapsingHeader("Haze"))
+    {
+        HazeSimulation &haze = scene.GetHaze();
+
+        ImGui::Checkbox("Simulate Haze", &haze.Enabled());
+
+        if (haze.IsEnabled())
+        {
+            ImGui::SliderFloat("Dissipation", &haze.Dissipation(), 0.0f, 0.5f, "%.3f /s");
+            for (size_t i = 0; i < haze.Emitters().size(); ++i)
+            {
+                ImGui::PushID(static_cast<int>(i));
+                ImGui::SliderFloat("Hazer Output", &haze.Emitters()[i].rate, 0.0f, 4.0f * Config::Haze::HAZER_RATE);
+                ImGui::PopID();
+            }
+            for (size_t i = 0; i < haze.Fans().size(); ++i)
+            {
+                ImGui::PushID(static_cast<int>(i));
+                ImGui::SliderFloat("Fan Thrust", &haze.Fans()[i].thrust, 0.0f, 4.0f * Config::Haze::FAN_THRUST);
+                ImGui::PopID();
+            }
+            if (ImGui::Button("Reset Haze"))
+            {
+                haze.Reset();
+            }
+        }
+    }
+
     auto &spotlights = scene.GetSpotlights();
     for (size_t i = 0; i < spotlights.size(); ++i)
     {
@@ -193,7 +223,11 @@ void UIRenderer::RenderControls(UIContext &ctx)
                         const bool isSelected = (static_cast<size_t>(currentGobo) == n);
                         if (ImGui::Selectable(goboNames[n].c_str(), isSelected))
                         {
-                            spotlight.SetGoboIndex(static_cast<int>(n));
+                            scene.SetGoboSlot(spotlight, static_cast<int>(n));
+                        }
+                        else if (ImGui::IsItemHovered())
+                        {
+                            scene.PrefetchGoboSlot(static_cast<int>(n));
                         }
                         if (isSelected)
                         {
@@ -225,6 +259,64 @@ void UIRenderer::RenderControls(UIContext &ctx)
                            Config::Volumetric::DEFAULT_INTENSITY);
         ImGui::SliderFloat("Anisotropy (G)", &volParams.params.w, Config::Volumetric::MIN_ANISOTROPY,
                            Config::Volumetric::MAX_ANISOTROPY);
+        bool analytic = ctx.pipeline->IsAnalyticScatteringEnabled();
+        if (ImGui::Checkbox("Analytic Beam Cores", &analytic))
+        {
+            ctx.pipeline->SetAnalyticScatteringEnabled(analytic);
+        }
+        bool temporal = ctx.pipeline->IsTemporalAccumulationEnabled();
+        if (ImGui::Checkbox("Temporal Accumulation", &temporal))
+        {
+            ctx.pipeline->SetTemporalAccumulationEnabled(temporal);
+        }
+        bool budget = ctx.pipeline->IsStepBudgetEnabled();
+        if (ImGui::Checkbox("Per-Light Step Budget", &budget))
+        {
+            ctx.pipeline->SetStepBudgetEnabled(budget);
+        }
+        const VolumetricBudget::Stats &budgetStats = ctx.pipeline->GetVolumetricBudgetStats();
+        for (int i = 0; i < Config::Spotlight::MAX_SPOTLIGHTS; ++i)
+        {
+            if (budgetStats.steps[i] > 0.0f)
+                ImGui::Text("Light %d: %.0f steps", i + 1, budgetStats.steps[i]);
+        }
+        ImGui::Text("Samples: %.1fM of %.1fM requested", budgetStats.samples / 1.0e6, budgetStats.fullSamples / 1.0e6);
+        ImGui::Text("GPU: %.2f ms predicted, %.2f ms measured", budgetStats.predictedMs, budgetStats.measuredMs);
+        bool tileMask = ctx.pipeline->IsTileMaskEnabled();
+        if (ImGui::Checkbox("Beam Tile Mask", &tileMask))
+        {
+            ctx.pipeline->SetTileMaskEnabled(tileMask);
+        }
+        const ConeBounds::TileMask &mask = ctx.pipeline->GetVolumetricTileMask();
+        ImGui::Text("Tiles: %zu of %d", mask.activeTiles, mask.tilesX * mask.tilesY);
+        bool shadowIntervals = ctx.pipeline->IsShadowIntervalsEnabled();
+        if (ImGui::Checkbox("Shadow Min-Max Intervals", &shadowIntervals))
+        {
+            ctx.pipeline->SetShadowIntervalsEnabled(shadowIntervals);
+        }
+        bool epipolar = ctx.pipeline->IsEpipolarEnabled();
+        if (ImGui::Checkbox("Epipolar Sampling", &epipolar))
+        {
+            ctx.pipeline->SetEpipolarEnabled(epipolar);
+        }
+        bool lightSampling = ctx.pipeline->IsLightSamplingEnabled();
+        if (ImGui::Checkbox("Stochastic Light Sampling", &lightSampling))
+        {
+            ctx.pipeline->SetLightSamplingEnabled(lightSampling);
+        }
+        bool goboFootprint = ctx.pipeline->IsGoboFootprintEnabled();
+        if (ImGui::Checkbox("Gobo Footprint Filtering", &goboFootprint))
+        {
+            ctx.pipeline->SetGoboFootprintEnabled(goboFootprint);
+        }
+        if (const GoboStreamer *streamer = scene.GetGoboStreamer())
+        {
+            const GoboStreamer::Stats &goboStats = streamer->GetStats();
+            ImGui::Text("Gobo pool: %d / %d layers, %d pending", streamer->GetResidentCount(),
+                        streamer->GetCapacity(), streamer->GetPendingCount());
+            ImGui::Text("Gobo hits: %.1f%%, %llu evictions", goboStats.HitRate() * 100.0,
+                        static_cast<unsigned long long>(goboStats.evictions));
+        }
     }
 
     if (ImGui::CollapsingHeader("Post Processing"))
@@ -247,9 +339,79 @@ void UIRenderer::RenderControls(UIContext &ctx)
         }
     }
 
+    RenderFixtureControls(scene);
+
+    if (ImGui::CollapsingHeader("Culling"))
+    {
+        bool cullingEnabled = ctx.pipeline->IsClusterCullingEnabled();
+        if (ImGui::Checkbox("Stage Cluster Culling", &cullingEnabled))
+        {
+            ctx.pipeline->SetClusterCullingEnabled(cullingEnabled);
+        }
+        const ClusterCuller::Stats &camera = ctx.pipeline->GetSceneCullStats();
+        ImGui::Text("Camera: %zu / %zu triangles (%zu / %zu clusters)", camera.submittedTriangles, camera.triangles,
+                    camera.visibleClusters, camera.clusters);
+        const ClusterCuller::Stats &shadow = ctx.pipeline->GetShadowCullStats();
+        ImGui::Text("Shadows: %zu / %zu triangles (all lights)", shadow.submittedTriangles, shadow.triangles);
+
+        bool occlusionEnabled = ctx.pipeline->IsOcclusionCullingEnabled();
+        if (ImGui::Checkbox("Occlusion Culling", &occlusionEnabled))
+        {
+            ctx.pipeline->SetOcclusionCullingEnabled(occlusionEnabled);
+        }
+        const OcclusionBuffer &occlusion = ctx.pipeline->GetOcclusionBuffer();
+        ImGui::Text("Occluders: %zu / %zu triangles rasterized", occlusion.GetRasterizedCount(),
+                    occlusion.GetOccluderCount());
+        ImGui::Text("Occluded: %zu clusters, %zu / %zu fixture meshes", camera.occlusionCulled,
+                    ctx.pipeline->GetFixtureMeshesOccluded(), ctx.pipeline->GetFixtureMeshesTested());
+    }
+
     ImGui::End();
 }
 
+void UIRenderer::RenderFixtureControls(Scene &scene)
+{
+    if (!ImGui::CollapsingHeader("Fixtures"))
+        return;
+
+    // The directory is listed once; patching never waits on the disk
+    if (!m_fixtureFilesScanned || ImGui::Button("Rescan"))
+    {
+        m_fixtureFiles.clear();
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(Config::Fixtures::DIRECTORY, error))
+        {
+            if (entry.path().extension() == ".gdtf")
+                m_fixtureFiles.push_back(entry.path().generic_string());
+        }
+        m_fixtureFilesScanned = true;
+    }
+
+    ImGui::DragFloat3("Patch Position", &m_patchPosition.x, 0.1f);
+    for (size_t i = 0; i < m_fixtureFiles.size(); ++i)
+    {
+        ImGui::PushID(static_cast<int>(i));
+        if (ImGui::Button("Add"))
+            scene.AddFixture(m_fixtureFiles[i], m_patchPosition);
+        ImGui::SameLine();
+        ImGui::TextUnformatted(std::filesystem::path(m_fixtureFiles[i]).filename().string().c_str());
+        ImGui::PopID();
+    }
+
+    const GDTF::FixtureLoader &loader = scene.GetFixtureLoader();
+    if (loader.GetCount() > 0)
+    {
+        ImGui::Separator();
+        ImGui::Text("Loading: %d / %d types", loader.GetPendingCount(), loader.GetCount());
+    }
+    for (int type = 0; type < loader.GetCount(); ++type)
+    {
+        static const char *const stateNames[] = {"queued", "loading", "ready", "failed"};
+        ImGui::Text("%s: %s", std::filesystem::path(loader.GetFile(type)).filename().string().c_str(),
+                    stateNames[static_cast<int>(loader.GetState(type))]);
+    }
+}
+
 void UIRenderer::EndFrame()
 {
     if (!m_initialized)
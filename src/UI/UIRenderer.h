@@ -3,6 +3,9 @@
 #include <windows.h>
 #include <DirectXMath.h>
 #include <d3d11.h>
+#include <string>
+#include <vector>
+#include "../Core/Config.h"
 
 // Forward declarations
 class Scene;
@@ -76,5 +79,15 @@ public:
     void EndFrame();
 
 private:
+    /**
+     * @brief Renders the Fixtures section: .gdtf files to patch and the types loading.
+     */
+    void RenderFixtureControls(Scene &scene);
+
     bool m_initialized = false;
+
+    // Fixture patching
+    std::vector<std::string> m_fixtureFiles; ///< .gdtf files in Config::Fixtures::DIRECTORY.
+    bool m_fixtureFilesScanned = false;
+    DirectX::XMFLOAT3 m_patchPosition = {0.0f, Config::Spotlight::DEFAULT_HEIGHT, 0.0f};
 };
@@ -0,0 +1,184 @@
+#include "Rendering/AnalyticScattering.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace
+{
+
+/**
+ * @brief Converged numeric integral of phase / (d^2 + 1) along a segment (midpoint rule, double).
+ */
+double Reference(const DirectX::XMFLOAT3 &light, const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir,
+                 float t0, float t1, float g, int steps = 20000)
+{
+    const double dt = (static_cast<double>(t1) - t0) / steps;
+    double sum = 0.0;
+    for (int i = 0; i < steps; ++i)
+    {
+        const double t = t0 + ((i + 0.5) * dt);
+        const double px = origin.x + (dir.x * t) - light.x;
+        const double py = origin.y + (dir.y * t) - light.y;
+        const double pz = origin.z + (dir.z * t) - light.z;
+        const double dist2 = (px * px) + (py * py) + (pz * pz);
+        const double cosTheta = ((dir.x * px) + (dir.y * py) + (dir.z * pz)) / (std::max)(std::sqrt(dist2), 1e-4);
+        sum += AnalyticScattering::HenyeyGreenstein(static_cast<float>(cosTheta), g) / (dist2 + 1.0) * dt;
+    }
+    return sum;
+}
+
+DirectX::XMFLOAT3 Normalize(float x, float y, float z)
+{
+    const float length = std::sqrt((x * x) + (y * y) + (z * z));
+    return {x / length, y / length, z / length};
+}
+
+} // namespace
+
+void TestTableShape()
+{
+    AnalyticScattering::Table table;
+    assert(!AnalyticScattering::BuildTable(0.5f, table, 1, 16));
+    assert(AnalyticScattering::BuildTable(0.5f, table, 16, 32));
+    assert(table.width == 16 && table.height == 32 && table.values.size() == 16u * 32u);
+    assert(table.anisotropy == 0.5f);
+
+    // Rows are a running integral: zero at -pi/2 and increasing
+    for (int i = 0; i < table.width; ++i)
+    {
+        assert(table.values[i] == 0.0f);
+        for (int j = 1; j < table.height; ++j)
+            assert(table.values[(j * table.width) + i] > table.values[((j - 1) * table.width) + i]);
+    }
+
+    // Lookups hit the samples exactly and clamp outside the range
+    const float last = table.values.back();
+    assert(std::fabs(AnalyticScattering::Lookup(table, 1.0f, 1.5707964f) - last) < 1e-6f);
+    assert(AnalyticScattering::Lookup(table, 2.0f, 10.0f) == last);
+    assert(AnalyticScattering::Lookup(table, -1.0f, -10.0f) == 0.0f);
+
+    std::cout << "Table shape test passed." << std::endl;
+}
+
+void TestIsotropicClosedForm()
+{
+    AnalyticScattering::Table table;
+    assert(AnalyticScattering::BuildTable(0.0f, table));
+
+    const DirectX::XMFLOAT3 light = {0.0f, 10.0f, 0.0f};
+    const DirectX::XMFLOAT3 origin = {-20.0f, 4.0f, -3.0f};
+    const DirectX::XMFLOAT3 dir = Normalize(1.0f, 0.1f, 0.2f);
+    for (float t1 : {1.0f, 10.0f, 20.0f, 60.0f})
+    {
+        const float closed = AnalyticScattering::IntegrateIsotropic(light, origin, dir, 0.5f, t1);
+        const float tabulated = AnalyticScattering::Integrate(table, light, origin, dir, 0.5f, t1);
+        const double numeric = Reference(light, origin, dir, 0.5f, t1, 0.0f);
+        assert(std::fabs(closed - numeric) <= 1e-4 * numeric);
+        assert(std::fabs(tabulated - closed) <= 1e-4f * closed);
+    }
+    assert(AnalyticScattering::Integrate(table, light, origin, dir, 5.0f, 5.0f) == 0.0f);
+    assert(AnalyticScattering::IntegrateIsotropic(light, origin, dir, 6.0f, 5.0f) == 0.0f);
+
+    std::cout << "Isotropic closed form test passed." << std::endl;
+}
+
+void TestRandomizedSegments()
+{
+    // Random lights, rays passing at most a few meters from them and random segments, including
+    // rays that graze the light where the phase function changes fastest
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    AnalyticScattering::Table table;
+    double errorSum = 0.0;
+    double errorMax = 0.0;
+    int count = 0;
+    for (float g : {-0.6f, 0.0f, 0.3f, 0.509f, 0.9f})
+    {
+        assert(AnalyticScattering::BuildTable(g, table));
+        for (int i = 0; i < 30; ++i)
+        {
+            const DirectX::XMFLOAT3 light = {-10.0f + (20.0f * unit(rng)), 5.0f + (10.0f * unit(rng)),
+                                             -10.0f + (20.0f * unit(rng))};
+            const DirectX::XMFLOAT3 origin = {-30.0f + (60.0f * unit(rng)), 10.0f * unit(rng),
+                                              -40.0f + (30.0f * unit(rng))};
+            const float miss = i % 3 == 0 ? 0.05f : 3.0f;
+            const float tx = light.x + (miss * ((2.0f * unit(rng)) - 1.0f)) - origin.x;
+            const float ty = light.y - (3.0f * miss * unit(rng)) - origin.y;
+            const float tz = light.z + (miss * ((2.0f * unit(rng)) - 1.0f)) - origin.z;
+            const DirectX::XMFLOAT3 dir = Normalize(tx, ty, tz);
+            const float t0 = std::sqrt((tx * tx) + (ty * ty) + (tz * tz)) * unit(rng);
+            const float t1 = t0 + 0.1f + (60.0f * unit(rng));
+
+            const double expected = Reference(light, origin, dir, t0, t1, g);
+            const double error =
+                std::fabs(AnalyticScattering::Integrate(table, light, origin, dir, t0, t1) - expected) / expected;
+            errorSum += error;
+            errorMax = (std::max)(errorMax, error);
+            ++count;
+        }
+    }
+    assert(errorSum / count < 0.002);
+    assert(errorMax < 0.02);
+
+    std::cout << "Randomized segments test passed (mean error " << 100.0 * errorSum / count << "%, max "
+              << 100.0 * errorMax << "%)." << std::endl;
+}
+
+void TestSegmentProbes()
+{
+    const DirectX::XMFLOAT3 light = {0.0f, 10.0f, 0.0f};
+    const DirectX::XMFLOAT3 origin = {-20.0f, 5.0f, 0.0f};
+    const DirectX::XMFLOAT3 dir = {1.0f, 0.0f, 0.0f};
+    float t[8];
+    float weight[8];
+    AnalyticScattering::SegmentProbes(light, origin, dir, 10.0f, 30.0f, 0.509f, 8, t, weight);
+
+    for (int k = 0; k < 8; ++k)
+    {
+        assert(t[k] > 10.0f && t[k] < 30.0f);
+        assert(k == 0 || t[k] > t[k - 1]);
+        const float u = t[k] - 20.0f;
+        const float expected = AnalyticScattering::HenyeyGreenstein(u / std::sqrt(25.0f + (u * u)), 0.509f);
+        assert(std::fabs(weight[k] - expected) < 1e-5f);
+    }
+
+    // Equal steps in angle: symmetric around the closest point, denser near it
+    assert(std::fabs((t[0] - 20.0f) + (t[7] - 20.0f)) < 1e-3f);
+    assert(t[4] - t[3] < t[1] - t[0]);
+
+    // A shadow edge halfway: the probe-weighted visibility estimates the lit share of the integral
+    AnalyticScattering::Table table;
+    assert(AnalyticScattering::BuildTable(0.509f, table));
+    double lit = 0.0;
+    double total = 0.0;
+    for (int k = 0; k < 8; ++k)
+    {
+        lit += t[k] < 20.0f ? weight[k] : 0.0;
+        total += weight[k];
+    }
+    const double share = AnalyticScattering::Integrate(table, light, origin, dir, 10.0f, 20.0f) /
+                         AnalyticScattering::Integrate(table, light, origin, dir, 10.0f, 30.0f);
+    assert(std::fabs((lit / total) - share) < 0.1);
+
+    std::cout << "Segment probes test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestTableShape();
+        TestIsotropicClosedForm();
+        TestRandomizedSegments();
+        TestSegmentProbes();
+        std::cout << "All AnalyticScattering tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,383 @@
+#include "Scene/ClusterCuller.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "Core/Config.h"
+#include "Geometry/ClusterBuilder.h"
+#include "Geometry/MeshOptimizer.h"
+
+/**
+ * @brief Packed test mesh that keeps the arrays a PackedMeshView points into.
+ */
+struct TestMesh
+{
+    MeshData data;
+    std::vector<uint8_t> indexBytes;
+    std::vector<IndexRange> ranges;
+
+    PackedMeshView View() const
+    {
+        PackedMeshView view;
+        view.vertices = data.vertices.data();
+        view.vertexCount = data.vertices.size();
+        view.indexBytes = indexBytes.data();
+        view.indexByteCount = indexBytes.size();
+        view.ranges = ranges.data();
+        view.rangeCount = ranges.size();
+        return view;
+    }
+
+    void Pack()
+    {
+        MeshOptimizer::PackIndices(data.indices, data.shapes, indexBytes, ranges);
+    }
+};
+
+/**
+ * @brief Appends a size x size grid of quads at height y as a new shape.
+ *
+ * @param faceUp True for triangles whose front faces +Y.
+ */
+void AddGrid(MeshData &data, int size, float y, bool faceUp)
+{
+    ShapeInfo shape;
+    shape.startIndex = static_cast<uint32_t>(data.indices.size());
+    shape.baseVertex = static_cast<int32_t>(data.vertices.size());
+    for (int z = 0; z <= size; ++z)
+        for (int x = 0; x <= size; ++x)
+            data.vertices.push_back({{static_cast<float>(x), y, static_cast<float>(z)}, {0, faceUp ? 1.0f : -1.0f, 0}, {0, 0}});
+
+    for (int z = 0; z < size; ++z)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const uint32_t a = (z * (size + 1)) + x;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + size + 1;
+            const uint32_t d = c + 1;
+            // (a, c, b) has front normal +Y under clockwise front faces
+            const uint32_t quad[6] = {a, c, b, b, c, d};
+            for (int i = 0; i < 6; ++i)
+                data.indices.push_back(quad[faceUp ? i : (i / 3 * 3) + (2 - (i % 3))]);
+        }
+    }
+    shape.indexCount = static_cast<uint32_t>(data.indices.size()) - shape.startIndex;
+    data.shapes.push_back(shape);
+}
+
+/**
+ * @brief Appends a closed UV sphere with outward front faces as a new shape.
+ */
+void AddSphere(MeshData &data, int rings, int segments, float radius)
+{
+    ShapeInfo shape;
+    shape.startIndex = static_cast<uint32_t>(data.indices.size());
+    shape.baseVertex = static_cast<int32_t>(data.vertices.size());
+    for (int r = 0; r <= rings; ++r)
+    {
+        const float phi = Config::Math::PI * static_cast<float>(r) / static_cast<float>(rings);
+        for (int s = 0; s <= segments; ++s)
+        {
+            const float theta = 2.0f * Config::Math::PI * static_cast<float>(s) / static_cast<float>(segments);
+            const DirectX::XMFLOAT3 n = {std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)};
+            data.vertices.push_back({{n.x * radius, n.y * radius, n.z * radius}, n, {0, 0}});
+        }
+    }
+    for (int r = 0; r < rings; ++r)
+    {
+        for (int s = 0; s < segments; ++s)
+        {
+            const uint32_t a = (r * (segments + 1)) + s;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + segments + 1;
+            const uint32_t d = c + 1;
+            const uint32_t quad[6] = {a, b, c, b, d, c};
+            for (uint32_t i : quad)
+                data.indices.push_back(i);
+        }
+    }
+    shape.indexCount = static_cast<uint32_t>(data.indices.size()) - shape.startIndex;
+    data.shapes.push_back(shape);
+}
+
+/**
+ * @brief Reads index i of a shape, with the base vertex applied.
+ */
+uint32_t FetchIndex(const TestMesh &mesh, size_t shape, uint32_t i)
+{
+    return mesh.data.indices[mesh.data.shapes[shape].startIndex + i] + mesh.data.shapes[shape].baseVertex;
+}
+
+DirectX::XMMATRIX MakeViewProj(DirectX::XMFLOAT3 eye, DirectX::XMFLOAT3 target, DirectX::XMFLOAT3 up)
+{
+    DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1),
+                                                       DirectX::XMVectorSet(target.x, target.y, target.z, 1),
+                                                       DirectX::XMVectorSet(up.x, up.y, up.z, 0));
+    return view * DirectX::XMMatrixPerspectiveFovLH(Config::CameraDefaults::FOV, 16.0f / 9.0f, 0.1f, 1000.0f);
+}
+
+void TestClusterLayout()
+{
+    TestMesh mesh;
+    AddGrid(mesh.data, 40, 0.0f, true);
+    AddSphere(mesh.data, 24, 48, 5.0f);
+    mesh.Pack();
+    const std::vector<MeshCluster> clusters = ClusterBuilder::Build(mesh.View());
+    assert(!clusters.empty());
+
+    // Clusters tile each shape's indices in order, without gaps or overlap
+    uint32_t expectedShape = 0;
+    uint32_t expectedStart = 0;
+    for (const auto &cluster : clusters)
+    {
+        if (cluster.shape != expectedShape)
+        {
+            assert(expectedStart == mesh.data.shapes[expectedShape].indexCount);
+            assert(cluster.shape == expectedShape + 1);
+            expectedShape = cluster.shape;
+            expectedStart = 0;
+        }
+        assert(cluster.startIndex == expectedStart);
+        assert(cluster.indexCount > 0 && cluster.indexCount % 3 == 0);
+        assert(cluster.indexCount / 3 <= ClusterBuilder::MAX_TRIANGLES);
+        expectedStart += cluster.indexCount;
+
+        // The sphere encloses every vertex
+        for (uint32_t i = 0; i < cluster.indexCount; ++i)
+        {
+            const DirectX::XMFLOAT3 &p = mesh.data.vertices[FetchIndex(mesh, cluster.shape, cluster.startIndex + i)].position;
+            const float dx = p.x - cluster.sphere.x;
+            const float dy = p.y - cluster.sphere.y;
+            const float dz = p.z - cluster.sphere.z;
+            assert(std::sqrt((dx * dx) + (dy * dy) + (dz * dz)) <= cluster.sphere.w + 1e-4f);
+        }
+    }
+    assert(expectedShape == 1 && expectedStart == mesh.data.shapes[1].indexCount);
+
+    // Flat clusters have a zero-width cone along the face normal
+    for (const auto &cluster : clusters)
+    {
+        if (cluster.shape == 0)
+            assert(std::abs(cluster.cone.y - 1.0f) < 1e-5f && cluster.cone.w < 1e-3f);
+    }
+    std::cout << "Cluster layout passed." << std::endl;
+}
+
+void TestBackfaceCulling()
+{
+    TestMesh mesh;
+    AddGrid(mesh.data, 16, 0.0f, true);
+    AddGrid(mesh.data, 16, 0.0f, false);
+    mesh.Pack();
+    const std::vector<MeshCluster> clusters = ClusterBuilder::Build(mesh.View());
+    const DirectX::XMMATRIX world = DirectX::XMMatrixIdentity();
+    std::vector<ClusterRange> ranges;
+
+    // From above only the upward shape is visible, merged into a single range
+    const DirectX::XMFLOAT3 above = {8, 20, 8};
+    ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(world, MakeViewProj(above, {8, 0, 8.01f}, {0, 1, 0}), above);
+    ClusterCuller::Stats stats = ClusterCuller::Cull(clusters, frustum, ranges);
+    assert(ranges.size() == 1 && ranges[0].shape == 0 && ranges[0].indexCount == mesh.data.shapes[0].indexCount);
+    assert(stats.submittedTriangles * 2 == stats.triangles && stats.frustumCulled == 0);
+    assert(stats.backfaceCulled + stats.visibleClusters == stats.clusters);
+
+    // From below the other way round
+    const DirectX::XMFLOAT3 below = {8, -20, 8};
+    frustum = ClusterCuller::MakeFrustum(world, MakeViewProj(below, {8, 0, 8.01f}, {0, 1, 0}), below);
+    ClusterCuller::Cull(clusters, frustum, ranges);
+    assert(ranges.size() == 1 && ranges[0].shape == 1);
+
+    // Passes drawing both faces keep both shapes
+    stats = ClusterCuller::Cull(clusters, frustum, ranges, false);
+    assert(ranges.size() == 2 && stats.submittedTriangles == stats.triangles);
+
+    // A world transform moves the eye into mesh space: lifting the mesh above the camera flips the result
+    const DirectX::XMMATRIX lifted = DirectX::XMMatrixTranslation(0, 40, 0);
+    frustum = ClusterCuller::MakeFrustum(lifted, MakeViewProj(above, {8, 40, 8.01f}, {0, 1, 0}), above);
+    ClusterCuller::Cull(clusters, frustum, ranges);
+    assert(ranges.size() == 1 && ranges[0].shape == 1);
+    std::cout << "Back-face culling passed." << std::endl;
+}
+
+void TestConservative()
+{
+    TestMesh mesh;
+    AddGrid(mesh.data, 64, -6.0f, true);
+    AddSphere(mesh.data, 32, 64, 5.0f);
+    mesh.Pack();
+    const std::vector<MeshCluster> clusters = ClusterBuilder::Build(mesh.View());
+    const DirectX::XMMATRIX world = DirectX::XMMatrixIdentity();
+
+    const DirectX::XMFLOAT3 eyes[] = {{0, 2, -20}, {15, 10, 3}, {-3, -4, 9}, {30, 1, 30}};
+    const DirectX::XMFLOAT3 targets[] = {{0, 0, 0}, {40, -6, 40}, {0, 0, 0}, {0, 0, 0}};
+    std::vector<ClusterRange> ranges;
+    for (int view = 0; view < 4; ++view)
+    {
+        const DirectX::XMMATRIX viewProj = MakeViewProj(eyes[view], targets[view], {0, 1, 0});
+        const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(world, viewProj, eyes[view]);
+        const ClusterCuller::Stats stats = ClusterCuller::Cull(clusters, frustum, ranges);
+        assert(stats.submittedTriangles < stats.triangles);
+
+        std::vector<std::vector<bool>> kept(mesh.data.shapes.size());
+        for (size_t s = 0; s < kept.size(); ++s)
+            kept[s].assign(mesh.data.shapes[s].indexCount / 3, false);
+        for (const auto &range : ranges)
+            for (uint32_t t = range.startIndex / 3; t < (range.startIndex + range.indexCount) / 3; ++t)
+                kept[range.shape][t] = true;
+
+        // Every front-facing triangle with a corner inside the view volume must be kept
+        DirectX::XMFLOAT4X4 m;
+        DirectX::XMStoreFloat4x4(&m, viewProj);
+        for (size_t s = 0; s < kept.size(); ++s)
+        {
+            for (uint32_t t = 0; t < kept[s].size(); ++t)
+            {
+                const DirectX::XMFLOAT3 &p0 = mesh.data.vertices[FetchIndex(mesh, s, t * 3)].position;
+                const DirectX::XMFLOAT3 &p1 = mesh.data.vertices[FetchIndex(mesh, s, (t * 3) + 1)].position;
+                const DirectX::XMFLOAT3 &p2 = mesh.data.vertices[FetchIndex(mesh, s, (t * 3) + 2)].position;
+                const float e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+                const float e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+                const float n[3] = {(e1[1] * e2[2]) - (e1[2] * e2[1]), (e1[2] * e2[0]) - (e1[0] * e2[2]),
+                                    (e1[0] * e2[1]) - (e1[1] * e2[0])};
+                const float facing = (n[0] * (eyes[view].x - p0.x)) + (n[1] * (eyes[view].y - p0.y)) +
+                                     (n[2] * (eyes[view].z - p0.z));
+                if (facing <= 0.0f)
+                    continue;
+
+                bool inside = false;
+                for (const DirectX::XMFLOAT3 *p : {&p0, &p1, &p2})
+                {
+                    const float cx = (p->x * m._11) + (p->y * m._21) + (p->z * m._31) + m._41;
+                    const float cy = (p->x * m._12) + (p->y * m._22) + (p->z * m._32) + m._42;
+                    const float cz = (p->x * m._13) + (p->y * m._23) + (p->z * m._33) + m._43;
+                    const float cw = (p->x * m._14) + (p->y * m._24) + (p->z * m._34) + m._44;
+                    inside |= std::abs(cx) <= cw && std::abs(cy) <= cw && cz >= 0.0f && cz <= cw;
+                }
+                assert(!inside || kept[s][t]);
+            }
+        }
+    }
+    std::cout << "Conservative culling passed." << std::endl;
+}
+
+void TestGroupTriangles()
+{
+    // A sphere whose triangles arrive in scrambled order cuts into tiny clusters
+    TestMesh scrambled;
+    AddSphere(scrambled.data, 32, 64, 5.0f);
+    AddGrid(scrambled.data, 24, -6.0f, true);
+    for (auto &shape : scrambled.data.shapes)
+    {
+        uint32_t *tris = scrambled.data.indices.data() + shape.startIndex;
+        const uint32_t count = shape.indexCount / 3;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t j = (i * 7919u) % count;
+            for (uint32_t k = 0; k < 3; ++k)
+                std::swap(tris[(i * 3) + k], tris[(j * 3) + k]);
+        }
+    }
+    TestMesh grouped = scrambled;
+    scrambled.Pack();
+    ClusterBuilder::GroupTriangles(grouped.data);
+    grouped.Pack();
+
+    // Grouping only reorders whole triangles within each shape
+    for (size_t s = 0; s < grouped.data.shapes.size(); ++s)
+    {
+        auto triangles = [&](const TestMesh &mesh)
+        {
+            std::vector<std::array<uint32_t, 3>> list;
+            for (uint32_t t = 0; t < mesh.data.shapes[s].indexCount / 3; ++t)
+                list.push_back({FetchIndex(mesh, s, t * 3), FetchIndex(mesh, s, (t * 3) + 1), FetchIndex(mesh, s, (t * 3) + 2)});
+            std::sort(list.begin(), list.end());
+            return list;
+        };
+        assert(triangles(scrambled) == triangles(grouped));
+    }
+
+    const std::vector<MeshCluster> before = ClusterBuilder::Build(scrambled.View());
+    const std::vector<MeshCluster> after = ClusterBuilder::Build(grouped.View());
+    const size_t triangles = grouped.data.indices.size() / 3;
+    assert(after.size() * 4 < before.size());
+    assert(after.size() * 32 < triangles);
+
+    // The sphere's groups are narrow enough to be back-face culled from outside
+    size_t cullable = 0;
+    for (const auto &cluster : after)
+        cullable += cluster.cone.w < 1.0f ? 1 : 0;
+    assert(cullable * 10 >= after.size() * 9);
+
+    // Seen from one side, a good share of the sphere is dropped, leaving a few draw ranges
+    const DirectX::XMFLOAT3 eye = {0, 0, -30};
+    const ClusterCuller::Frustum frustum =
+        ClusterCuller::MakeFrustum(DirectX::XMMatrixIdentity(), MakeViewProj(eye, {0, 0, 0}, {0, 1, 0}), eye);
+    std::vector<ClusterRange> ranges;
+    const ClusterCuller::Stats stats = ClusterCuller::Cull(after, frustum, ranges);
+    assert(stats.backfaceCulled * 4 > stats.clusters);
+    assert(ranges.size() * 3 < stats.visibleClusters);
+    std::cout << "Triangle grouping passed." << std::endl;
+}
+
+void TestDeterminism()
+{
+    // Enough clusters to be culled across several worker chunks
+    TestMesh mesh;
+    AddGrid(mesh.data, 200, 0.0f, true);
+    AddSphere(mesh.data, 64, 128, 20.0f);
+    mesh.Pack();
+    const std::vector<MeshCluster> clusters = ClusterBuilder::Build(mesh.View());
+    assert(clusters.size() > 1000);
+
+    const std::vector<MeshCluster> rebuilt = ClusterBuilder::Build(mesh.View());
+    assert(rebuilt.size() == clusters.size());
+    assert(std::memcmp(rebuilt.data(), clusters.data(), clusters.size() * sizeof(MeshCluster)) == 0);
+
+    const DirectX::XMFLOAT3 eye = {10, 30, -60};
+    const ClusterCuller::Frustum frustum =
+        ClusterCuller::MakeFrustum(DirectX::XMMatrixIdentity(), MakeViewProj(eye, {40, 0, 60}, {0, 1, 0}), eye);
+    std::vector<ClusterRange> first;
+    const ClusterCuller::Stats stats = ClusterCuller::Cull(clusters, frustum, first);
+    assert(stats.frustumCulled > 0 && stats.backfaceCulled > 0 && stats.visibleClusters > 0);
+
+    for (int run = 0; run < 20; ++run)
+    {
+        std::vector<ClusterRange> ranges;
+        const ClusterCuller::Stats again = ClusterCuller::Cull(clusters, frustum, ranges);
+        assert(ranges.size() == first.size());
+        assert(std::memcmp(ranges.data(), first.data(), ranges.size() * sizeof(ClusterRange)) == 0);
+        assert(again.submittedTriangles == stats.submittedTriangles && again.visibleClusters == stats.visibleClusters);
+    }
+
+    // Ranges are sorted, disjoint, and adjacent visible clusters are merged
+    for (size_t i = 1; i < first.size(); ++i)
+    {
+        assert(first[i].shape >= first[i - 1].shape);
+        if (first[i].shape == first[i - 1].shape)
+            assert(first[i].startIndex > first[i - 1].startIndex + first[i - 1].indexCount);
+    }
+    assert(first.size() < stats.visibleClusters);
+    std::cout << "Deterministic culling passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestClusterLayout();
+        TestBackfaceCulling();
+        TestConservative();
+        TestGroupTriangles();
+        TestDeterminism();
+        std::cout << "All ClusterCuller tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
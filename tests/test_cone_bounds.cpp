@@ -0,0 +1,250 @@
+#include "Rendering/ConeBounds.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+constexpr float NEAR_W = 0.01f; ///< Points closer to the camera plane are not checked.
+constexpr float TOLERANCE = 1e-4f;
+
+const DirectX::XMFLOAT3 ROOM_MIN = {-50.0f, -0.05f, -50.0f};
+const DirectX::XMFLOAT3 ROOM_MAX = {50.0f, 100.0f, 50.0f};
+
+/**
+ * @brief World-to-clip matrix of a 16:9 camera looking at a target.
+ */
+DirectX::XMFLOAT4X4 MakeViewProj(const DirectX::XMFLOAT3 &eye, const DirectX::XMFLOAT3 &target)
+{
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                                             DirectX::XMVectorSet(target.x, target.y, target.z, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        1.0f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+    DirectX::XMFLOAT4X4 viewProj;
+    DirectX::XMStoreFloat4x4(&viewProj, view * proj);
+    return viewProj;
+}
+
+bool InsideOutline(const std::vector<DirectX::XMFLOAT2> &outline, const DirectX::XMFLOAT2 &p)
+{
+    float area = 0.0f;
+    for (size_t i = 0; i < outline.size(); ++i)
+    {
+        const DirectX::XMFLOAT2 &a = outline[i];
+        const DirectX::XMFLOAT2 &b = outline[(i + 1) % outline.size()];
+        area += (a.x * b.y) - (b.x * a.y);
+    }
+    const float orientation = area < 0.0f ? -1.0f : 1.0f;
+    for (size_t i = 0; i < outline.size(); ++i)
+    {
+        const DirectX::XMFLOAT2 &a = outline[i];
+        const DirectX::XMFLOAT2 &b = outline[(i + 1) % outline.size()];
+        const float cross = ((b.x - a.x) * (p.y - a.y)) - ((b.y - a.y) * (p.x - a.x));
+        const float edge = std::sqrt(((b.x - a.x) * (b.x - a.x)) + ((b.y - a.y) * (b.y - a.y)));
+        if (cross * orientation < -TOLERANCE * edge)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if the tile holding a screen point, or a neighbour within the tolerance, is marked.
+ */
+bool TileMarked(const ConeBounds::TileMask &mask, const DirectX::XMFLOAT2 &p, uint8_t bit)
+{
+    for (float du : {-TOLERANCE, 0.0f, TOLERANCE})
+    {
+        for (float dv : {-TOLERANCE, 0.0f, TOLERANCE})
+        {
+            const int tx = static_cast<int>(std::floor((p.x + du) * WIDTH / mask.tileSize));
+            const int ty = static_cast<int>(std::floor((p.y + dv) * HEIGHT / mask.tileSize));
+            if (tx < 0 || ty < 0 || tx >= mask.tilesX || ty >= mask.tilesY)
+                continue;
+            if ((mask.lights[(static_cast<size_t>(ty) * mask.tilesX) + tx] & bit) != 0)
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Samples points of a light's beam inside the room and checks each against its bounds.
+ *
+ * @return Number of points that were on screen and checked.
+ */
+int CheckBeam(const SpotlightData &light, const DirectX::XMFLOAT4X4 &m, const DirectX::XMFLOAT3 &eye)
+{
+    const ConeBounds::Bounds bounds = ConeBounds::Compute(light, m, eye, ROOM_MIN, ROOM_MAX);
+    ConeBounds::TileMask mask;
+    ConeBounds::BuildTileMask({bounds}, WIDTH, HEIGHT, Config::Volumetric::TILE_SIZE, mask);
+
+    const DirectX::XMFLOAT3 axis = {light.dirAngle.x, light.dirAngle.y, light.dirAngle.z};
+    const DirectX::XMFLOAT3 side = std::fabs(axis.y) < 0.99f ? DirectX::XMFLOAT3{0.0f, 1.0f, 0.0f}
+                                                              : DirectX::XMFLOAT3{1.0f, 0.0f, 0.0f};
+    DirectX::XMFLOAT3 u = {(axis.y * side.z) - (axis.z * side.y), (axis.z * side.x) - (axis.x * side.z),
+                           (axis.x * side.y) - (axis.y * side.x)};
+    const float uLength = std::sqrt((u.x * u.x) + (u.y * u.y) + (u.z * u.z));
+    u = {u.x / uLength, u.y / uLength, u.z / uLength};
+    const DirectX::XMFLOAT3 v = {(axis.y * u.z) - (axis.z * u.y), (axis.z * u.x) - (axis.x * u.z),
+                                 (axis.x * u.y) - (axis.y * u.x)};
+    const float field = light.coneGobo.y;
+    const float tanField = std::sqrt(1.0f - (field * field)) / field;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    int checked = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        // Volume, lateral surface and base of the capped cone
+        const int kind = i % 3;
+        const float along = light.posRange.w * (kind == 2 ? 1.0f : std::cbrt(uniform(rng)));
+        const float angle = 2.0f * 3.14159265f * uniform(rng);
+        const float radius = along * tanField * (kind == 1 ? 1.0f : std::sqrt(uniform(rng)));
+        const float cu = std::cos(angle) * radius;
+        const float cv = std::sin(angle) * radius;
+        const DirectX::XMFLOAT3 p = {light.posRange.x + (axis.x * along) + (u.x * cu) + (v.x * cv),
+                                     light.posRange.y + (axis.y * along) + (u.y * cu) + (v.y * cv),
+                                     light.posRange.z + (axis.z * along) + (u.z * cu) + (v.z * cv)};
+        if (p.x < ROOM_MIN.x || p.y < ROOM_MIN.y || p.z < ROOM_MIN.z || p.x > ROOM_MAX.x || p.y > ROOM_MAX.y ||
+            p.z > ROOM_MAX.z)
+            continue;
+
+        const float x = (p.x * m._11) + (p.y * m._21) + (p.z * m._31) + m._41;
+        const float y = (p.x * m._12) + (p.y * m._22) + (p.z * m._32) + m._42;
+        const float w = (p.x * m._14) + (p.y * m._24) + (p.z * m._34) + m._44;
+        if (w < NEAR_W)
+            continue;
+        const DirectX::XMFLOAT2 uv = {(x / w * 0.5f) + 0.5f, 0.5f - (y / w * 0.5f)};
+        if (uv.x < 0.0f || uv.y < 0.0f || uv.x > 1.0f || uv.y > 1.0f)
+            continue;
+
+        ++checked;
+        assert(bounds.visible);
+        assert(w >= bounds.nearDepth * (1.0f - TOLERANCE) && w <= bounds.farDepth * (1.0f + TOLERANCE));
+        assert(uv.x >= bounds.min.x - TOLERANCE && uv.x <= bounds.max.x + TOLERANCE);
+        assert(uv.y >= bounds.min.y - TOLERANCE && uv.y <= bounds.max.y + TOLERANCE);
+        assert(InsideOutline(bounds.outline, uv));
+        assert(TileMarked(mask, uv, 1));
+
+        const int px = static_cast<int>(uv.x * WIDTH);
+        const int py = static_cast<int>(uv.y * HEIGHT);
+        assert(px >= mask.left - 1 && px <= mask.right && py >= mask.top - 1 && py <= mask.bottom);
+    }
+    return checked;
+}
+
+} // namespace
+
+void TestContainment()
+{
+    const DirectX::XMFLOAT3 eye = {0.0f, 8.0f, -40.0f};
+    const DirectX::XMFLOAT4X4 viewProj = MakeViewProj(eye, {0.0f, 5.0f, 0.0f});
+
+    // Hanging lights aimed at the floor, from the front and the sides of the stage
+    int checked = 0;
+    checked += CheckBeam(TestLights::Beam({0.0f, 20.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, 0.71f, 500.0f), viewProj, eye);
+    checked += CheckBeam(TestLights::Beam({-20.0f, 15.0f, 10.0f}, {0.5f, -1.0f, -0.3f}, 0.9f, 500.0f), viewProj, eye);
+    checked += CheckBeam(TestLights::Beam({30.0f, 30.0f, 30.0f}, {-1.0f, -0.6f, -1.0f}, 0.97f, 40.0f), viewProj, eye);
+
+    // Beam passing by the camera and leaving the room behind it: clipped by the near plane
+    checked += CheckBeam(TestLights::Beam({0.0f, 10.0f, 20.0f}, {0.0f, -0.1f, -1.0f}, 0.95f, 500.0f), viewProj, eye);
+
+    // Camera inside the beam
+    checked += CheckBeam(TestLights::Beam({0.0f, 30.0f, -40.0f}, {0.0f, -1.0f, 0.0f}, 0.8f, 500.0f), viewProj, eye);
+    assert(checked > 100000);
+
+    std::cout << "Containment test passed (" << checked << " beam points)." << std::endl;
+}
+
+void TestCulling()
+{
+    const DirectX::XMFLOAT3 eye = {0.0f, 8.0f, -40.0f};
+    const DirectX::XMFLOAT4X4 viewProj = MakeViewProj(eye, {0.0f, 5.0f, 0.0f});
+
+    // Behind the camera, pointing away
+    const ConeBounds::Bounds behind = ConeBounds::Compute(
+        TestLights::Beam({0.0f, 10.0f, -45.0f}, {0.0f, 0.0f, -1.0f}, 0.9f, 500.0f), viewProj, eye, ROOM_MIN, ROOM_MAX);
+    assert(!behind.visible);
+
+    // Outside the room, pointing away from it
+    const ConeBounds::Bounds outside = ConeBounds::Compute(
+        TestLights::Beam({0.0f, 150.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.9f, 500.0f), viewProj, eye, ROOM_MIN, ROOM_MAX);
+    assert(!outside.visible);
+
+    // Far to the side, out of the field of view
+    const ConeBounds::Bounds off =
+        ConeBounds::Compute(TestLights::Beam({-48.0f, 50.0f, -45.0f}, {-1.0f, 0.0f, 0.0f}, 0.97f, 500.0f), viewProj,
+                            eye, ROOM_MIN, ROOM_MAX);
+    assert(!off.visible);
+
+    // Switched off
+    SpotlightData dark = TestLights::Beam({0.0f, 20.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, 0.71f, 500.0f);
+    dark.colorInt.w = 0.0f;
+    assert(!ConeBounds::Compute(dark, viewProj, eye, ROOM_MIN, ROOM_MAX).visible);
+
+    // A narrow beam in the distance is a small part of the screen and mask
+    const ConeBounds::Bounds narrow = ConeBounds::Compute(
+        TestLights::Beam({10.0f, 20.0f, 20.0f}, {0.0f, -1.0f, 0.0f}, 0.99f, 500.0f), viewProj, eye, ROOM_MIN, ROOM_MAX);
+    assert(narrow.visible && !narrow.containsCamera);
+    assert(narrow.area > 0.0f && narrow.area < 0.05f);
+    assert(narrow.nearDepth > 40.0f);
+
+    ConeBounds::TileMask mask;
+    ConeBounds::BuildTileMask({behind, narrow}, WIDTH, HEIGHT, Config::Volumetric::TILE_SIZE, mask);
+    const size_t tiles = static_cast<size_t>(mask.tilesX) * mask.tilesY;
+    assert(mask.activeTiles > 0 && mask.activeTiles < tiles / 10);
+    for (uint8_t tile : mask.lights)
+        assert((tile & 1) == 0);
+    assert(mask.right > mask.left && mask.bottom > mask.top);
+    assert(mask.right - mask.left < WIDTH / 2);
+
+    // No visible light: empty mask and scissor
+    ConeBounds::BuildTileMask({behind, off}, WIDTH, HEIGHT, Config::Volumetric::TILE_SIZE, mask);
+    assert(mask.activeTiles == 0);
+    assert(mask.right <= mask.left);
+
+    std::cout << "Culling test passed (narrow beam " << narrow.area * 100.0f << "% of the screen)." << std::endl;
+}
+
+void TestContainsCamera()
+{
+    const DirectX::XMFLOAT3 eye = {0.0f, 8.0f, -40.0f};
+    const DirectX::XMFLOAT4X4 viewProj = MakeViewProj(eye, {0.0f, 5.0f, 0.0f});
+
+    const ConeBounds::Bounds inside = ConeBounds::Compute(
+        TestLights::Beam({0.0f, 30.0f, -40.0f}, {0.0f, -1.0f, 0.0f}, 0.8f, 500.0f), viewProj, eye, ROOM_MIN, ROOM_MAX);
+    assert(inside.visible && inside.containsCamera);
+    assert(inside.nearDepth == 0.0f);
+    assert(std::fabs(inside.area - 1.0f) < 1e-6f);
+
+    ConeBounds::TileMask mask;
+    ConeBounds::BuildTileMask({inside}, WIDTH, HEIGHT, Config::Volumetric::TILE_SIZE, mask);
+    assert(mask.activeTiles == static_cast<size_t>(mask.tilesX) * mask.tilesY);
+    assert(mask.left == 0 && mask.top == 0 && mask.right == WIDTH && mask.bottom == HEIGHT);
+
+    std::cout << "Contains camera test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestContainment();
+        TestCulling();
+        TestContainsCamera();
+        std::cout << "All ConeBounds tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include "Rendering/EpipolarSampling.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+constexpr int LINES = 512;
+constexpr int SAMPLES = 512;
+constexpr int INITIAL_STEP = 16;
+constexpr float THRESHOLD = 0.1f;
+
+const DirectX::XMFLOAT2 LIGHTS[] = {
+    {700.0f, 300.0f},   // On screen
+    {-400.0f, 500.0f},  // Left of the screen
+    {2500.0f, 1600.0f}, // Past the bottom-right corner
+    {960.0f, -3000.0f}, // Far above
+};
+
+bool OnBorder(const DirectX::XMFLOAT2 &p)
+{
+    constexpr float EPSILON = 1e-2f;
+    const bool inside = p.x >= -EPSILON && p.x <= WIDTH + EPSILON && p.y >= -EPSILON && p.y <= HEIGHT + EPSILON;
+    const bool edge = std::fabs(p.x) < EPSILON || std::fabs(p.x - WIDTH) < EPSILON || std::fabs(p.y) < EPSILON ||
+                      std::fabs(p.y - HEIGHT) < EPSILON;
+    return inside && edge;
+}
+
+/// Distance between two fractional line indices, around the wrap.
+float LineDistance(float a, float b)
+{
+    const float d = std::fabs(a - b);
+    return (std::min)(d, static_cast<float>(LINES) - d);
+}
+
+/**
+ * @brief Camera distance of a synthetic scene: a far wall with a nearer box in front.
+ */
+float SceneDistance(float x, float y)
+{
+    const bool box = x >= 900.0f && x < 1300.0f && y >= 350.0f && y < 800.0f;
+    return box ? 12.0f + (x * 0.002f) : 40.0f + (y * 0.01f);
+}
+
+/**
+ * @brief Synthetic in-scattering: varies around the light (continuously at it), decays away from it and jumps
+ * with the depth.
+ */
+float SceneRadiance(const DirectX::XMFLOAT2 &light, float x, float y, float distance)
+{
+    const float dx = x - light.x;
+    const float dy = y - light.y;
+    const float angle = std::atan2(dy, dx);
+    const float radius = std::sqrt((dx * dx) + (dy * dy));
+    const float spokes = 0.5f * std::sin(angle * 6.0f) * (std::min)(radius / 100.0f, 1.0f);
+    return (1.0f + spokes) * std::exp(-radius / 1500.0f) * (distance / 40.0f);
+}
+
+void TestLines()
+{
+    for (const DirectX::XMFLOAT2 &light : LIGHTS)
+    {
+        EpipolarSampling::Lines lines;
+        assert(EpipolarSampling::GenerateLines(light, WIDTH, HEIGHT, LINES, lines));
+        assert(lines.lines.size() == LINES);
+        const bool onScreen = light.x >= 0.0f && light.x <= WIDTH && light.y >= 0.0f && light.y <= HEIGHT;
+
+        int valid = 0;
+        for (int k = 0; k < LINES; ++k)
+        {
+            const EpipolarSampling::Line &line = lines.lines[k];
+            assert(OnBorder(line.exit));
+            if (!line.valid)
+            {
+                assert(!onScreen);
+                continue;
+            }
+            ++valid;
+            if (onScreen)
+                assert(line.entry.x == light.x && line.entry.y == light.y);
+            else
+                assert(OnBorder(line.entry));
+
+            // Samples map back to their line and index
+            for (int s = 1; s < SAMPLES; s += 37)
+            {
+                const DirectX::XMFLOAT2 p = EpipolarSampling::SamplePosition(line, s, SAMPLES);
+                const EpipolarSampling::Coordinate c = EpipolarSampling::PixelToEpipolar(lines, p.x, p.y, SAMPLES);
+                assert(LineDistance(c.line, static_cast<float>(k)) < 1e-2f);
+                assert(std::fabs(c.sample - static_cast<float>(s)) < 0.05f);
+            }
+        }
+        assert(onScreen ? valid == LINES : (valid > 0 && valid < LINES));
+    }
+
+    EpipolarSampling::Lines lines;
+    assert(!EpipolarSampling::GenerateLines({0.0f, 0.0f}, WIDTH, HEIGHT, 6, lines));
+    assert(!EpipolarSampling::GenerateLines({0.0f, 0.0f}, 0, HEIGHT, LINES, lines));
+    std::cout << "Lines test passed." << std::endl;
+}
+
+void TestCoverage()
+{
+    // Every pixel lies between two lines, at least one of which crosses the screen
+    for (const DirectX::XMFLOAT2 &light : LIGHTS)
+    {
+        EpipolarSampling::Lines lines;
+        EpipolarSampling::GenerateLines(light, WIDTH, HEIGHT, LINES, lines);
+        for (int y = 0; y < HEIGHT; y += 7)
+        {
+            for (int x = 0; x < WIDTH; x += 7)
+            {
+                const float px = static_cast<float>(x) + 0.5f;
+                const float py = static_cast<float>(y) + 0.5f;
+                const EpipolarSampling::Coordinate c = EpipolarSampling::PixelToEpipolar(lines, px, py, SAMPLES);
+                assert(c.line >= 0.0f && c.line < static_cast<float>(LINES));
+                assert(c.sample >= 0.0f && c.sample <= static_cast<float>(SAMPLES - 1));
+                const int line0 = static_cast<int>(c.line) % LINES;
+                assert(lines.lines[line0].valid || lines.lines[(line0 + 1) % LINES].valid);
+            }
+        }
+    }
+    std::cout << "Coverage test passed." << std::endl;
+}
+
+void TestRefine()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    std::uniform_int_distribution<int> breaks(0, 40);
+    std::vector<float> distances(SAMPLES);
+    std::vector<uint16_t> left(SAMPLES);
+    std::vector<uint16_t> right(SAMPLES);
+
+    // Smooth depth: only the regular samples are marched
+    for (int s = 0; s < SAMPLES; ++s)
+        distances[s] = 20.0f + (static_cast<float>(s) * 0.01f);
+    size_t count = EpipolarSampling::RefineLine(distances.data(), SAMPLES, INITIAL_STEP, THRESHOLD, left.data(),
+                                                right.data());
+    assert(count == (SAMPLES + INITIAL_STEP - 1) / INITIAL_STEP + 1);
+
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        float level = 20.0f;
+        for (int s = 0; s < SAMPLES; ++s)
+        {
+            if (breaks(rng) == 0)
+                level = level > 15.0f ? 8.0f : 30.0f;
+            distances[s] = level * (1.0f + jitter(rng));
+        }
+        count = EpipolarSampling::RefineLine(distances.data(), SAMPLES, INITIAL_STEP, THRESHOLD, left.data(),
+                                             right.data());
+
+        // Brute force: sources, then the nearest ones on either side without a break in between
+        std::vector<bool> source(SAMPLES);
+        size_t expected = 0;
+        for (int s = 0; s < SAMPLES; ++s)
+        {
+            source[s] = s % INITIAL_STEP == 0 || s == SAMPLES - 1 ||
+                        (s > 0 && EpipolarSampling::IsBreak(distances[s - 1], distances[s], THRESHOLD)) ||
+                        (s < SAMPLES - 1 && EpipolarSampling::IsBreak(distances[s], distances[s + 1], THRESHOLD));
+            expected += source[s] ? 1 : 0;
+        }
+        assert(count == expected);
+        for (int s = 0; s < SAMPLES; ++s)
+        {
+            assert(left[s] <= s && right[s] >= s);
+            assert(source[left[s]] && source[right[s]]);
+            assert(right[s] - left[s] <= INITIAL_STEP);
+            for (int j = left[s] + 1; j < right[s]; ++j)
+                assert(!source[j] || j == s);
+            for (int j = left[s]; j < right[s]; ++j)
+                assert(!EpipolarSampling::IsBreak(distances[j], distances[j + 1], THRESHOLD));
+            if (source[s])
+                assert(left[s] == s && right[s] == s);
+        }
+    }
+    std::cout << "Refine test passed." << std::endl;
+}
+
+void TestReconstruct()
+{
+    for (const DirectX::XMFLOAT2 &light : LIGHTS)
+    {
+        EpipolarSampling::Lines lines;
+        EpipolarSampling::GenerateLines(light, WIDTH, HEIGHT, LINES, lines);
+
+        // Sample pass: depth at each sample, sources, radiance at the sources, interpolation
+        std::vector<float> distances(static_cast<size_t>(LINES) * SAMPLES, 0.0f);
+        std::vector<DirectX::XMFLOAT3> values(distances.size(), {0.0f, 0.0f, 0.0f});
+        std::vector<uint16_t> left(SAMPLES);
+        std::vector<uint16_t> right(SAMPLES);
+        size_t marched = 0;
+        for (int k = 0; k < LINES; ++k)
+        {
+            if (!lines.lines[k].valid)
+                continue;
+            float *lineDistances = &distances[static_cast<size_t>(k) * SAMPLES];
+            DirectX::XMFLOAT3 *lineValues = &values[static_cast<size_t>(k) * SAMPLES];
+            std::vector<DirectX::XMFLOAT2> positions(SAMPLES);
+            for (int s = 0; s < SAMPLES; ++s)
+            {
+                positions[s] = EpipolarSampling::SamplePosition(lines.lines[k], s, SAMPLES);
+                const float px = std::floor((std::min)(positions[s].x, WIDTH - 1.0f)) + 0.5f;
+                const float py = std::floor((std::min)(positions[s].y, HEIGHT - 1.0f)) + 0.5f;
+                lineDistances[s] = SceneDistance(px, py);
+            }
+            marched += EpipolarSampling::RefineLine(lineDistances, SAMPLES, INITIAL_STEP, THRESHOLD, left.data(),
+                                                    right.data());
+            for (int s = 0; s < SAMPLES; ++s)
+            {
+                if (left[s] == s)
+                {
+                    const float r = SceneRadiance(light, positions[s].x, positions[s].y, lineDistances[s]);
+                    lineValues[s] = {r, r, r};
+                }
+            }
+            EpipolarSampling::InterpolateLine(left.data(), right.data(), SAMPLES, lineValues);
+        }
+
+        // Resolve: pixels match their own depth's samples or fall back to marching
+        size_t pixels = 0;
+        size_t fallback = 0;
+        double error = 0.0;
+        double total = 0.0;
+        float worst = 0.0f;
+        for (int y = 0; y < HEIGHT; y += 3)
+        {
+            for (int x = 0; x < WIDTH; x += 3)
+            {
+                const float px = static_cast<float>(x) + 0.5f;
+                const float py = static_cast<float>(y) + 0.5f;
+                const float distance = SceneDistance(px, py);
+                const float expected = SceneRadiance(light, px, py, distance);
+                DirectX::XMFLOAT3 value;
+                ++pixels;
+                if (!EpipolarSampling::Reconstruct(lines, SAMPLES, values.data(), distances.data(), px, py, distance,
+                                                   THRESHOLD, value))
+                {
+                    ++fallback;
+                    continue;
+                }
+                error += std::fabs(value.x - expected);
+                total += expected;
+                worst = (std::max)(worst, std::fabs(value.x - expected) / expected);
+            }
+        }
+        const double meanError = error / total;
+        std::cout << "  light (" << light.x << ", " << light.y << "): " << marched << " marched samples, "
+                  << 100.0 * static_cast<double>(fallback) / static_cast<double>(pixels) << "% pixels marched, "
+                  << 100.0 * meanError << "% mean error, " << 100.0f * worst << "% worst" << std::endl;
+        assert(marched < static_cast<size_t>(WIDTH) * HEIGHT / 20);
+        assert(fallback * 50 < pixels);
+        assert(meanError < 0.01);
+        assert(worst < 0.2f);
+    }
+    std::cout << "Reconstruct test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestLines();
+        TestCoverage();
+        TestRefine();
+        TestReconstruct();
+        std::cout << "All EpipolarSampling tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "GDTF/FixtureLoader.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Handle = GDTF::FixtureLoader::Handle;
+using State = GDTF::FixtureLoader::State;
+
+// Files that do not exist load quickly, and fail
+std::string MissingFile(int index)
+{
+    return "test_fixture_loader_missing_" + std::to_string(index) + ".gdtf";
+}
+
+void TestRequest()
+{
+    GDTF::FixtureLoader loader(1);
+    const Handle first = loader.Request(MissingFile(0));
+    const Handle second = loader.Request(MissingFile(1));
+    assert(first != second);
+    assert(loader.Request(MissingFile(0)) == first);
+    assert(loader.GetCount() == 2 && loader.GetPendingCount() == 2);
+
+    // Nothing is read until the first Update()
+    assert(loader.GetState(first) == State::Queued && loader.GetState(second) == State::Queued);
+    assert(loader.GetFile(second) == MissingFile(1) && !loader.GetAsset(first));
+    std::cout << "Request test passed." << std::endl;
+}
+
+void TestPriority()
+{
+    // One load at a time: the visible type goes first, then the nearest, whatever the order
+    GDTF::FixtureLoader loader(1);
+    const Handle far = loader.Request(MissingFile(0));
+    const Handle near = loader.Request(MissingFile(1));
+    const Handle visible = loader.Request(MissingFile(2));
+    loader.SetPriority(far, false, 30.0f);
+    loader.SetPriority(near, false, 5.0f);
+    loader.SetPriority(visible, true, 50.0f);
+
+    std::vector<Handle> completed;
+    loader.Update(completed, 4);
+    assert(completed.empty());
+    assert(loader.GetState(visible) != State::Queued);
+    assert(loader.GetState(near) == State::Queued && loader.GetState(far) == State::Queued);
+
+    loader.WaitIdle();
+    loader.Update(completed, 4);
+    assert(completed.size() == 1 && completed[0] == visible);
+    assert(loader.GetState(visible) == State::Failed && !loader.GetAsset(visible));
+    assert(loader.GetState(near) != State::Queued && loader.GetState(far) == State::Queued);
+
+    // Priorities change while types wait
+    loader.SetPriority(far, true, 30.0f);
+    loader.WaitIdle();
+    completed.clear();
+    loader.Update(completed, 4);
+    assert(completed.size() == 1 && completed[0] == near);
+    assert(loader.GetState(far) != State::Queued);
+    std::cout << "Priority test passed." << std::endl;
+}
+
+void TestCompletedPerUpdate()
+{
+    // Types that finish together are reported a few per frame, in the order they finished
+    GDTF::FixtureLoader loader(4);
+    for (int i = 0; i < 4; ++i)
+        loader.Request(MissingFile(i));
+
+    std::vector<Handle> completed;
+    loader.Update(completed, 1);
+    loader.WaitIdle();
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        loader.Update(completed, 1);
+        assert(completed.size() == static_cast<size_t>(frame) + 1);
+    }
+    assert(loader.GetPendingCount() == 0);
+    for (Handle handle : completed)
+        assert(loader.GetState(handle) == State::Failed);
+
+    // A type requested again is not loaded again
+    assert(loader.GetState(loader.Request(MissingFile(2))) == State::Failed);
+    loader.Update(completed, 4);
+    assert(completed.size() == 4 && loader.GetPendingCount() == 0);
+    std::cout << "CompletedPerUpdate test passed." << std::endl;
+}
+
+void TestDestroyWhileLoading()
+{
+    // The destructor waits for the loads in flight
+    GDTF::FixtureLoader loader(2);
+    loader.Request(MissingFile(0));
+    loader.Request(MissingFile(1));
+    std::vector<Handle> completed;
+    loader.Update(completed, 1);
+    std::cout << "DestroyWhileLoading test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestRequest();
+        TestPriority();
+        TestCompletedPerUpdate();
+        TestDestroyWhileLoading();
+        std::cout << "All FixtureLoader tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
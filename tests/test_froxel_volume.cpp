@@ -0,0 +1,199 @@
+#include "Rendering/FroxelVolume.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr int WIDTH = 64;
+constexpr int HEIGHT = 36;
+
+/**
+ * @brief Camera a few meters back from the lights, looking at the origin.
+ */
+VolumetricReference::Inputs MakeInputs(const std::vector<SpotlightData> &lights, int steps)
+{
+    VolumetricReference::Inputs inputs;
+    inputs.width = WIDTH;
+    inputs.height = HEIGHT;
+    inputs.cameraPos = {1.0f, 3.0f, -12.0f};
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(1.0f, 3.0f, -12.0f, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 3.0f, 0.0f, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        1.0f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 100.0f);
+    DirectX::XMStoreFloat4x4(&inputs.invViewProj, DirectX::XMMatrixInverse(nullptr, view * proj));
+    inputs.lights = lights.data();
+    inputs.lightCount = lights.size();
+    inputs.params.params = {static_cast<float>(steps), Config::Volumetric::DEFAULT_DENSITY,
+                            Config::Volumetric::DEFAULT_INTENSITY, Config::Volumetric::DEFAULT_ANISOTROPY};
+    return inputs;
+}
+
+double Sum(const std::vector<float> &rgb)
+{
+    double sum = 0.0;
+    for (float v : rgb)
+        sum += v;
+    return sum;
+}
+
+} // namespace
+
+void TestSliceDistribution()
+{
+    FroxelVolume volume(16, 8, 32, 0.5f, 128.0f);
+    assert(volume.GetWidth() == 16 && volume.GetHeight() == 8 && volume.GetDepth() == 32);
+    assert(std::fabs(volume.BoundaryDistance(0.0f) - 0.5f) < 1e-6f);
+    assert(std::fabs(volume.BoundaryDistance(32.0f) - 128.0f) < 1e-3f);
+
+    // Exponential: each slice is the same ratio longer than the previous one
+    const float ratio = volume.BoundaryDistance(1.0f) / volume.BoundaryDistance(0.0f);
+    for (int z = 1; z < 32; ++z)
+        assert(std::fabs((volume.BoundaryDistance(static_cast<float>(z + 1)) / volume.BoundaryDistance(static_cast<float>(z))) -
+                         ratio) < 1e-4f);
+
+    std::cout << "Slice distribution test passed." << std::endl;
+}
+
+void TestNoLights()
+{
+    const std::vector<SpotlightData> lights;
+    const VolumetricReference::Inputs inputs = MakeInputs(lights, 32);
+    FroxelVolume volume(20, 12, 16);
+    volume.Inject(inputs);
+    volume.Integrate();
+    std::vector<float> rgb;
+    assert(volume.Resolve(inputs, rgb));
+    assert(rgb.size() == static_cast<size_t>(WIDTH) * HEIGHT * 3);
+    assert(Sum(rgb) == 0.0);
+
+    VolumetricReference::Inputs empty = inputs;
+    empty.width = 0;
+    assert(!volume.Resolve(empty, rgb));
+
+    std::cout << "No lights test passed." << std::endl;
+}
+
+void TestIntegration()
+{
+    // A width that is not a multiple of the eight-froxel batch
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                               TestLights::AimedAt({-4.0f, 8.0f, 2.0f}, {0.0f, 0.0f, 0.0f})};
+    const VolumetricReference::Inputs inputs = MakeInputs(lights, 32);
+    FroxelVolume volume(21, 12, 24, 0.5f, 60.0f);
+    volume.Inject(inputs);
+    volume.Integrate();
+
+    // At a froxel center the lookup at a boundary is the sum of the slices in front of it
+    double total = 0.0;
+    for (int y = 0; y < 12; ++y)
+    {
+        for (int x = 0; x < 21; ++x)
+        {
+            const float u = (static_cast<float>(x) + 0.5f) / 21.0f;
+            const float v = (static_cast<float>(y) + 0.5f) / 12.0f;
+            float gathered[3];
+            volume.Sample(u, v, 0.25f, gathered);
+            assert(gathered[0] == 0.0f && gathered[1] == 0.0f && gathered[2] == 0.0f);
+
+            double sum[3] = {0.0, 0.0, 0.0};
+            for (int z = 0; z < 24; ++z)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    assert(volume.GetScattering(x, y, z, c) >= 0.0f);
+                    sum[c] += volume.GetScattering(x, y, z, c);
+                }
+                volume.Sample(u, v, volume.BoundaryDistance(static_cast<float>(z + 1)), gathered);
+                for (int c = 0; c < 3; ++c)
+                    assert(std::fabs(gathered[c] - sum[c]) <= 1e-4 * (1.0 + sum[c]));
+            }
+            volume.Sample(u, v, 1000.0f, gathered);
+            assert(std::fabs(gathered[0] - sum[0]) <= 1e-4 * (1.0 + sum[0]));
+            total += sum[0];
+        }
+    }
+    assert(total > 0.0);
+
+    std::cout << "Integration test passed." << std::endl;
+}
+
+void TestMatchesRayMarch()
+{
+    // Per-pixel march with many steps against the froxel lookup: same image up to the grid's blur
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                               TestLights::AimedAt({-4.0f, 8.0f, 2.0f}, {1.0f, 0.0f, 0.0f})};
+    const VolumetricReference::Inputs inputs = MakeInputs(lights, 256);
+    std::vector<float> marched;
+    assert(VolumetricReference::Render(inputs, marched));
+
+    FroxelVolume volume(WIDTH, HEIGHT, 128, 0.5f, 100.0f);
+    volume.Inject(inputs);
+    volume.Integrate();
+    std::vector<float> froxel;
+    assert(volume.Resolve(inputs, froxel));
+
+    const double marchedSum = Sum(marched);
+    const double froxelSum = Sum(froxel);
+    assert(marchedSum > 0.0);
+    assert(std::fabs(froxelSum - marchedSum) < 0.02 * marchedSum);
+
+    double difference = 0.0;
+    for (size_t i = 0; i < marched.size(); ++i)
+        difference += std::fabs(froxel[i] - marched[i]);
+    assert(difference < 0.05 * marchedSum);
+
+    std::cout << "Matches ray march test passed (total " << 100.0 * (froxelSum / marchedSum - 1.0)
+              << "%, per pixel " << 100.0 * difference / marchedSum << "%)." << std::endl;
+}
+
+void TestSceneDepth()
+{
+    // Geometry at the light's cone stops the lookup; geometry at the camera gathers nothing
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f})};
+    VolumetricReference::Inputs inputs = MakeInputs(lights, 32);
+    FroxelVolume volume(32, 18, 48);
+    volume.Inject(inputs);
+    volume.Integrate();
+
+    std::vector<float> open;
+    assert(volume.Resolve(inputs, open));
+
+    std::vector<float> depth(static_cast<size_t>(WIDTH) * HEIGHT, 0.99f);
+    inputs.depth = depth.data();
+    std::vector<float> blocked;
+    assert(volume.Resolve(inputs, blocked));
+    for (size_t i = 0; i < open.size(); ++i)
+        assert(blocked[i] <= open[i] + 1e-6f);
+    assert(Sum(blocked) < Sum(open));
+
+    std::fill(depth.begin(), depth.end(), 0.0f);
+    assert(volume.Resolve(inputs, blocked));
+    assert(Sum(blocked) == 0.0);
+
+    std::cout << "Scene depth test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestSliceDistribution();
+        TestNoLights();
+        TestIntegration();
+        TestMatchesRayMarch();
+        TestSceneDepth();
+        std::cout << "All FroxelVolume tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "Resources/GoboLibrary.h"
+#include "Core/Config.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "test_images.h"
+
+namespace
+{
+
+using TestImages::PatternTga;
+using TextureBaker::Format;
+
+/// Texel of a slice in the library, as stored (sRGB RGBA8).
+const uint8_t *Texel(const GoboLibrary &library, const GoboLibrary::SlotRef &ref, int x, int y)
+{
+    const GoboLibrary::SizeClass &sizeClass = library.GetSizeClass(ref.sizeClass);
+    const size_t index = ((static_cast<size_t>(ref.layer) * sizeClass.size + y) * sizeClass.size) + x;
+    return &sizeClass.image.rgba[index * 4];
+}
+
+bool SameRef(const GoboLibrary::SlotRef &a, const GoboLibrary::SlotRef &b)
+{
+    return a.sizeClass == b.sizeClass && a.layer == b.layer;
+}
+
+void TestDedupe()
+{
+    // Two fixture types with the same stock gobos in a different order, plus one of their own
+    GoboLibrary library;
+    const int a = library.AddFixture("A", {PatternTga(256, 256, 1), PatternTga(256, 256, 2), PatternTga(256, 256, 3)});
+    const int b = library.AddFixture("B", {PatternTga(256, 256, 3), PatternTga(256, 256, 4), PatternTga(256, 256, 1)});
+    assert(a == 0 && b == 1);
+    const std::vector<GoboLibrary::SlotRef> slotsA = library.GetSlots(a);
+    const std::vector<GoboLibrary::SlotRef> slotsB = library.GetSlots(b);
+    assert(slotsA.size() == 3 && slotsB.size() == 3);
+    assert(SameRef(slotsA[2], slotsB[0]));
+    assert(SameRef(slotsA[0], slotsB[2]));
+    assert(!SameRef(slotsA[1], slotsB[1]));
+    assert(library.GetSizeClassCount() == 1);
+    assert(library.GetSizeClass(0).image.layers == 4);
+
+    // Sharing goes by decoded pixels, not file bytes: the same image stored bottom-up
+    const std::vector<uint8_t> topDown = PatternTga(64, 64, 5);
+    std::vector<uint8_t> bottomUp = topDown;
+    bottomUp[17] = 0;
+    for (size_t y = 0; y < 64; ++y)
+        std::memcpy(&bottomUp[18 + ((63 - y) * 64 * 4)], &topDown[18 + (y * 64 * 4)], 64 * 4);
+    const int c = library.AddFixture("C", {PatternTga(64, 64, 0), topDown});
+    const int d = library.AddFixture("D", {bottomUp});
+    assert(SameRef(library.GetSlots(c)[1], library.GetSlots(d)[0]));
+
+    // A single texel of difference is a different gobo
+    std::vector<uint8_t> changed = PatternTga(256, 256, 1);
+    changed[18 + (4 * ((100 * 256) + 100))] ^= 1;
+    const int e = library.AddFixture("E", {changed});
+    assert(!SameRef(library.GetSlots(e)[0], slotsA[0]));
+
+    // Every slot reads back its own image
+    const uint8_t *stored = Texel(library, library.GetSlots(e)[0], 100, 100);
+    const uint8_t *original = Texel(library, slotsA[0], 100, 100);
+    assert(stored[2] == (original[2] ^ 1) && stored[0] == original[0]); // The TGA stores blue first
+    std::cout << "Dedupe test passed." << std::endl;
+}
+
+void TestSizeClasses()
+{
+    assert(GoboLibrary::SizeClassFor(1, 1) == Config::Gobo::MIN_SIZE_CLASS);
+    assert(GoboLibrary::SizeClassFor(256, 256) == 256);
+    assert(GoboLibrary::SizeClassFor(257, 10) == 512);
+    assert(GoboLibrary::SizeClassFor(100, 60) == 128);
+
+    // Images go to the class they fit, centered on black, instead of the largest of their wheel
+    GoboLibrary library;
+    const int fixture =
+        library.AddFixture("A", {PatternTga(512, 512, 1), PatternTga(100, 60, 2), PatternTga(128, 128, 3)});
+    const std::vector<GoboLibrary::SlotRef> slots = library.GetSlots(fixture);
+    assert(library.GetSizeClassCount() == 2);
+    assert(library.GetSizeClass(slots[0].sizeClass).size == 512);
+    assert(slots[1].sizeClass == slots[2].sizeClass);
+    assert(library.GetSizeClass(slots[1].sizeClass).size == 128);
+    assert(slots[1].layer == 0 && slots[2].layer == 1);
+
+    // The 100x60 image sits at (14, 34): black around it, its first texel at the corner
+    const uint8_t *corner = Texel(library, slots[1], 14, 34);
+    const uint8_t *outside = Texel(library, slots[1], 13, 34);
+    const uint8_t *below = Texel(library, slots[1], 14, 94);
+    assert(corner[0] == static_cast<uint8_t>(2 * 31) && corner[3] == 255);
+    assert(outside[0] == 0 && outside[3] == 0 && below[0] == 0 && below[3] == 0);
+    std::cout << "SizeClasses test passed." << std::endl;
+}
+
+void TestIncremental()
+{
+    GoboLibrary library;
+    const int a = library.AddFixture("A", {PatternTga(256, 256, 1), PatternTga(512, 512, 2)});
+    const std::vector<GoboLibrary::SlotRef> slotsA = library.GetSlots(a);
+    const uint32_t revision256 = library.GetSizeClass(slotsA[0].sizeClass).revision;
+    const uint32_t revision512 = library.GetSizeClass(slotsA[1].sizeClass).revision;
+    const uint8_t before = Texel(library, slotsA[0], 40, 50)[0];
+
+    // A new type that only adds 256 gobos leaves the 512 class alone, and earlier slots in place
+    const int b = library.AddFixture("B", {PatternTga(256, 256, 1), PatternTga(256, 256, 7)});
+    assert(b == 1);
+    assert(library.GetSizeClass(slotsA[0].sizeClass).revision == revision256 + 1);
+    assert(library.GetSizeClass(slotsA[1].sizeClass).revision == revision512);
+    assert(SameRef(library.GetSlots(a)[0], slotsA[0]) && SameRef(library.GetSlots(a)[1], slotsA[1]));
+    assert(Texel(library, slotsA[0], 40, 50)[0] == before);
+
+    // Loading a type again is free; an image that does not decode keeps the other slots aligned
+    assert(library.AddFixture("B", {}) == b);
+    assert(library.GetSizeClass(slotsA[0].sizeClass).revision == revision256 + 1);
+    const int c = library.AddFixture("C", {std::vector<uint8_t>{1, 2, 3}, PatternTga(256, 256, 7)});
+    assert(library.GetSlots(c)[0].sizeClass == -1);
+    assert(SameRef(library.GetSlots(c)[1], library.GetSlots(b)[1]));
+    assert(library.AddFixture("D", {std::vector<uint8_t>{1, 2, 3}}) == -1);
+    assert(library.FindFixture("C") == c && library.FindFixture("D") == -1);
+    std::cout << "Incremental test passed." << std::endl;
+}
+
+void TestMemoryReport()
+{
+    // Eight types share a 512 open gobo and four stock 256 gobos; each also has one of its own.
+    // On their own, each would pad six slices to 512
+    GoboLibrary library;
+    for (int type = 0; type < 8; ++type)
+    {
+        std::vector<std::vector<uint8_t>> files = {PatternTga(512, 512, 0)};
+        for (int gobo = 1; gobo <= 4; ++gobo)
+            files.push_back(PatternTga(256, 256, gobo));
+        files.push_back(PatternTga(256, 256, 10 + type));
+        library.AddFixture("type" + std::to_string(type), files);
+    }
+    const GoboLibrary::MemoryReport report = library.GetMemoryReport();
+    assert(report.fixtures == 8);
+    assert(report.slots == 48);
+    assert(report.uniqueSlices == 1 + 4 + 8);
+    const Format grey = Config::Gobo::COMPRESS ? Format::BC4 : Format::RGBA8;
+    assert(report.classBytes.size() == 2);
+    assert(report.libraryBytes ==
+           TextureBaker::BakedSize(grey, 512, 512, 1) + TextureBaker::BakedSize(grey, 256, 256, 12));
+    assert(report.perFixtureBytes == 8 * TextureBaker::BakedSize(grey, 512, 512, 6));
+    assert(report.libraryBytes * 8 < report.perFixtureBytes);
+
+    // A color slice makes its whole class a color array, and a color fixture type one too
+    library.AddFixture("color", {PatternTga(256, 256, 3, true)});
+    const Format color = !Config::Gobo::COMPRESS ? Format::RGBA8 : Config::Gobo::COLOR_BC7 ? Format::BC7 : Format::BC1;
+    const int colorClass = library.GetSlots(library.FindFixture("color"))[0].sizeClass;
+    assert(library.GetSizeClass(colorClass).format == color);
+    const GoboLibrary::MemoryReport withColor = library.GetMemoryReport();
+    assert(withColor.perFixtureBytes == report.perFixtureBytes + TextureBaker::BakedSize(color, 256, 256, 1));
+    std::cout << "MemoryReport test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestDedupe();
+        TestSizeClasses();
+        TestIncremental();
+        TestMemoryReport();
+        std::cout << "All GoboLibrary tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include "Resources/GoboStreamer.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "test_images.h"
+
+namespace
+{
+
+using TestImages::PatternTga;
+using TestImages::SolidTga;
+using TextureBaker::Format;
+
+constexpr int LAYER_SIZE = 64;
+constexpr int MAX_UPLOADS = 8;
+
+/// Runs one frame and waits for the decodes it started, so the next frame collects them.
+std::vector<GoboStreamer::Upload> Frame(GoboStreamer &streamer)
+{
+    std::vector<GoboStreamer::Upload> uploads;
+    streamer.Update(uploads, MAX_UPLOADS);
+    streamer.WaitIdle();
+    return uploads;
+}
+
+void TestPlaceholder()
+{
+    GoboStreamer streamer(4, LAYER_SIZE, Format::RGBA8, 2);
+    const GoboStreamer::Key open = streamer.AddMedia(PatternTga(64, 64, 0));
+    const GoboStreamer::Key gobo = streamer.AddMedia(PatternTga(64, 64, 1));
+    assert(streamer.AddMedia(PatternTga(64, 64, 1)) == gobo);
+
+    GoboStreamer::Upload placeholder;
+    assert(streamer.SetPlaceholder(open, placeholder));
+    assert(placeholder.layer == GoboStreamer::PLACEHOLDER_LAYER);
+    assert(placeholder.baked.width == LAYER_SIZE && placeholder.baked.layers == 1);
+    assert(streamer.Request(open) == GoboStreamer::PLACEHOLDER_LAYER);
+
+    // A miss shows the placeholder until the decode lands, then the slot's own layer
+    assert(streamer.Request(gobo) == GoboStreamer::PLACEHOLDER_LAYER);
+    assert(streamer.GetLayer(gobo) == -1 && streamer.GetPendingCount() == 1);
+    assert(Frame(streamer).empty());
+    assert(streamer.Request(gobo) == GoboStreamer::PLACEHOLDER_LAYER);
+    const std::vector<GoboStreamer::Upload> uploads = Frame(streamer);
+    assert(uploads.size() == 1 && uploads[0].key == gobo && uploads[0].layer == 1);
+    assert(uploads[0].baked.mipLevels == TextureBaker::MipCount(LAYER_SIZE, LAYER_SIZE));
+    assert(streamer.Request(gobo) == 1);
+
+    const GoboStreamer::Stats &stats = streamer.GetStats();
+    assert(stats.requests == 4 && stats.hits == 2 && stats.misses == 2);
+    assert(stats.decodes == 1 && stats.uploads == 1 && stats.evictions == 0);
+    assert(stats.HitRate() == 0.5);
+
+    // A file that does not decode stays on the placeholder, and is not retried
+    const GoboStreamer::Key broken = streamer.AddMedia({1, 2, 3});
+    streamer.Request(broken);
+    Frame(streamer);
+    assert(Frame(streamer).empty());
+    assert(streamer.Request(broken) == GoboStreamer::PLACEHOLDER_LAYER);
+    assert(streamer.GetStats().failedDecodes == 1 && streamer.GetPendingCount() == 0);
+
+    // A slice the pool does not take frees its layer for the next slot and falls back to the placeholder
+    const GoboStreamer::Key rejected = streamer.AddMedia(PatternTga(64, 64, 2));
+    streamer.Request(rejected);
+    Frame(streamer);
+    const std::vector<GoboStreamer::Upload> rejectedUploads = Frame(streamer);
+    assert(rejectedUploads.size() == 1 && rejectedUploads[0].layer == 2);
+    streamer.RejectUpload(rejected);
+    assert(streamer.GetLayer(rejected) == -1 && streamer.GetStats().rejectedUploads == 1);
+    assert(streamer.Request(rejected) == GoboStreamer::PLACEHOLDER_LAYER);
+    assert(Frame(streamer).empty() && streamer.GetPendingCount() == 0);
+    assert(streamer.GetResidentCount() == 2 && streamer.Request(gobo) == 1);
+    std::cout << "Placeholder test passed." << std::endl;
+}
+
+void TestDecodeSlice()
+{
+    // Larger images are halved until they fit, then centered: 100x60 -> 50x30 at (7, 17) in 64x64
+    TextureBaker::BakedTexture baked;
+    assert(GoboStreamer::DecodeSlice(SolidTga(100, 60, 255), LAYER_SIZE, Format::RGBA8, baked));
+    std::vector<uint8_t> top;
+    TextureBaker::DecodeLevel(baked, 0, 0, top);
+    auto red = [&](int x, int y) { return top[((static_cast<size_t>(y) * LAYER_SIZE) + x) * 4]; };
+    assert(red(7, 17) == 255 && red(56, 46) == 255);
+    assert(red(6, 17) == 0 && red(7, 16) == 0 && red(57, 46) == 0 && red(56, 47) == 0);
+
+    // Block compressed pools take the same slices
+    assert(GoboStreamer::DecodeSlice(PatternTga(256, 256, 3), LAYER_SIZE, Format::BC7, baked));
+    assert(baked.format == Format::BC7 && baked.width == LAYER_SIZE);
+    assert(!GoboStreamer::DecodeSlice({0, 1}, LAYER_SIZE, Format::RGBA8, baked));
+    std::cout << "DecodeSlice test passed." << std::endl;
+}
+
+void TestEviction()
+{
+    // Three layers besides the placeholder
+    GoboStreamer streamer(4, LAYER_SIZE, Format::RGBA8, 4);
+    std::vector<GoboStreamer::Key> keys;
+    for (int i = 0; i < 5; ++i)
+        keys.push_back(streamer.AddMedia(PatternTga(32, 32, i + 1)));
+
+    // Slots 0..2 become resident, slot 0 least recently used
+    for (int i = 0; i < 3; ++i)
+        streamer.Request(keys[static_cast<size_t>(i)]);
+    Frame(streamer);
+    Frame(streamer);
+    assert(streamer.GetResidentCount() == 3);
+    streamer.Request(keys[0]);
+    Frame(streamer);
+    streamer.Request(keys[1]);
+    streamer.Request(keys[2]);
+    Frame(streamer);
+
+    // Slot 3 takes slot 0's layer, the least recently used
+    const int layer0 = streamer.GetLayer(keys[0]);
+    streamer.Request(keys[3]);
+    Frame(streamer);
+    streamer.Request(keys[3]);
+    const std::vector<GoboStreamer::Upload> uploads = Frame(streamer);
+    assert(uploads.size() == 1 && uploads[0].layer == layer0);
+    assert(streamer.GetLayer(keys[0]) == -1 && streamer.GetLayer(keys[3]) == layer0);
+    assert(streamer.GetStats().evictions == 1);
+
+    // Layers requested this frame are pinned: a fourth slot on stage waits instead of thrashing
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        for (int i = 1; i < 5; ++i)
+            streamer.Request(keys[static_cast<size_t>(i)]);
+        Frame(streamer);
+    }
+    assert(streamer.GetStats().evictions == 1);
+    assert(streamer.GetLayer(keys[4]) == -1 && streamer.GetPendingCount() == 1);
+
+    // Once a light moves off slot 1, slot 4 gets its layer
+    const int layer1 = streamer.GetLayer(keys[1]);
+    for (int i = 2; i < 5; ++i)
+        streamer.Request(keys[static_cast<size_t>(i)]);
+    Frame(streamer);
+    assert(streamer.GetLayer(keys[4]) == layer1 && streamer.GetLayer(keys[1]) == -1);
+    assert(streamer.GetStats().evictions == 2);
+
+    // An evicted slot streams again when it is selected later
+    streamer.Request(keys[0]);
+    Frame(streamer);
+    Frame(streamer);
+    assert(streamer.GetLayer(keys[0]) > 0 && streamer.GetStats().decodes == 6);
+    std::cout << "Eviction test passed." << std::endl;
+}
+
+void TestPrefetch()
+{
+    GoboStreamer streamer(4, LAYER_SIZE, Format::RGBA8, 1);
+    std::vector<GoboStreamer::Key> keys;
+    for (int i = 0; i < 4; ++i)
+        keys.push_back(streamer.AddMedia(PatternTga(32, 32, i + 1)));
+
+    // A prefetched slot is resident by the time it is requested
+    streamer.Prefetch(keys[0]);
+    Frame(streamer);
+    Frame(streamer);
+    assert(streamer.Request(keys[0]) > 0);
+    assert(streamer.Request(keys[0]) > 0);
+    GoboStreamer::Stats stats = streamer.GetStats();
+    assert(stats.prefetches == 1 && stats.prefetchHits == 1 && stats.misses == 0);
+
+    // Requests start before prefetches queued earlier
+    streamer.ResetStats();
+    streamer.Prefetch(keys[1]);
+    streamer.Request(keys[2]);
+    Frame(streamer);
+    Frame(streamer);
+    assert(streamer.GetLayer(keys[2]) > 0 && streamer.GetLayer(keys[1]) == -1);
+    Frame(streamer);
+    assert(streamer.GetLayer(keys[1]) > 0 && streamer.GetResidentCount() == 3);
+
+    // A prefetch never evicts a layer requested or prefetched this frame
+    streamer.Prefetch(keys[3]);
+    Frame(streamer);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        streamer.Request(keys[0]);
+        streamer.Request(keys[2]);
+        streamer.Prefetch(keys[1]);
+        Frame(streamer);
+    }
+    assert(streamer.GetLayer(keys[3]) == -1 && streamer.GetStats().evictions == 0);
+
+    // Requesting the waiting prefetch promotes it: it takes the layer no longer wanted
+    streamer.Request(keys[0]);
+    streamer.Request(keys[2]);
+    streamer.Request(keys[3]);
+    Frame(streamer);
+    assert(streamer.GetLayer(keys[3]) > 0 && streamer.GetLayer(keys[1]) == -1);
+    stats = streamer.GetStats();
+    assert(stats.evictions == 1 && stats.prefetchHits == 0);
+    std::cout << "Prefetch test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestPlaceholder();
+        TestDecodeSlice();
+        TestEviction();
+        TestPrefetch();
+        std::cout << "All GoboStreamer tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "Scene/HazeSimulation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+constexpr int SIZE = 24;
+constexpr float DT = 1.0f / Config::Haze::TICK_RATE;
+const DirectX::XMFLOAT3 BOX_MIN = {0.0f, 0.0f, 0.0f};
+const DirectX::XMFLOAT3 BOX_MAX = {24.0f, 24.0f, 24.0f};
+
+/// Mean x of the haze above the initial density, in cells.
+double ExcessCenterX(const HazeSimulation &haze)
+{
+    double sum = 0.0;
+    double weighted = 0.0;
+    for (int z = 1; z <= SIZE; ++z)
+    {
+        for (int y = 1; y <= SIZE; ++y)
+        {
+            for (int x = 1; x <= SIZE; ++x)
+            {
+                const double density = haze.GetDensity()[haze.Index(x, y, z)];
+                const double excess = (std::max)(density - Config::Haze::INITIAL_DENSITY, 0.0);
+                sum += excess;
+                weighted += excess * x;
+            }
+        }
+    }
+    return weighted / sum;
+}
+
+void TestConservation()
+{
+    // Still air: advection is the identity and diffusion keeps the total, so the haze grows by
+    // exactly what the hazer puts out
+    HazeSimulation haze(SIZE, BOX_MIN, BOX_MAX);
+    haze.Dissipation() = 0.0f;
+    haze.Emitters().push_back({{12.0f, 12.0f, 12.0f}, {1.0f, 0.0f, 0.0f}, 3.0f, 50.0f, 0.0f});
+    const double initial = haze.TotalHaze();
+    assert(std::fabs(initial - (Config::Haze::INITIAL_DENSITY * SIZE * SIZE * SIZE)) < 1e-2);
+
+    for (int tick = 1; tick <= 30; ++tick)
+    {
+        haze.Step(DT);
+        const double expected = initial + (50.0 * DT * tick);
+        assert(std::fabs(haze.TotalHaze() - expected) < expected * 1e-4);
+    }
+
+    // Spread around the nozzle (between cells 12 and 13) symmetrically, and nothing moved the air
+    const std::vector<float> &density = haze.GetDensity();
+    assert(density[haze.Index(12, 12, 12)] > density[haze.Index(6, 12, 12)]);
+    assert(std::fabs(density[haze.Index(10, 12, 12)] - density[haze.Index(15, 12, 12)]) < 1e-4f);
+    const DirectX::XMFLOAT3 velocity = haze.GetVelocity(12, 12, 12);
+    assert(velocity.x == 0.0f && velocity.y == 0.0f && velocity.z == 0.0f);
+
+    // A nozzle smaller than a cell still puts everything out
+    HazeSimulation tiny(SIZE, BOX_MIN, BOX_MAX);
+    tiny.Dissipation() = 0.0f;
+    tiny.Emitters().push_back({{3.2f, 7.9f, 20.5f}, {0.0f, 1.0f, 0.0f}, 0.1f, 10.0f, 0.0f});
+    tiny.Step(DT);
+    assert(std::fabs(tiny.TotalHaze() - (initial + (10.0 * DT))) < 1e-2);
+    std::cout << "Conservation test passed." << std::endl;
+}
+
+void TestProjection()
+{
+    // A fan in the middle of the box: after projection the flow has little divergence left
+    // compared with its velocity gradients
+    HazeSimulation haze(SIZE, BOX_MIN, BOX_MAX);
+    haze.Fans().push_back({{12.0f, 12.0f, 12.0f}, {1.0f, 0.0f, 0.0f}, 5.0f, 20.0f});
+    for (int tick = 0; tick < 10; ++tick)
+        haze.Step(DT);
+
+    double divergence = 0.0;
+    double gradient = 0.0;
+    for (int z = 2; z < SIZE; ++z)
+    {
+        for (int y = 2; y < SIZE; ++y)
+        {
+            for (int x = 2; x < SIZE; ++x)
+            {
+                const float dudx = 0.5f * (haze.GetVelocity(x + 1, y, z).x - haze.GetVelocity(x - 1, y, z).x);
+                const float dvdy = 0.5f * (haze.GetVelocity(x, y + 1, z).y - haze.GetVelocity(x, y - 1, z).y);
+                const float dwdz = 0.5f * (haze.GetVelocity(x, y, z + 1).z - haze.GetVelocity(x, y, z - 1).z);
+                divergence += std::fabs(dudx + dvdy + dwdz);
+                gradient += std::fabs(dudx) + std::fabs(dvdy) + std::fabs(dwdz);
+            }
+        }
+    }
+    std::cout << "  relative divergence " << divergence / gradient << std::endl;
+    assert(gradient > 0.0 && divergence < 0.25 * gradient);
+
+    // The air is pushed along the fan, and it is still there at the walls' normal component
+    assert(haze.GetVelocity(12, 12, 12).x > 1.0f);
+    for (int y = 1; y <= SIZE; ++y)
+        assert(haze.GetVelocity(0, y, 12).x == -haze.GetVelocity(1, y, 12).x);
+    std::cout << "Projection test passed." << std::endl;
+}
+
+void TestTransport()
+{
+    // The same hazer with and without a fan blowing along +x: the fan carries the haze away
+    auto run = [](bool fan)
+    {
+        HazeSimulation haze(SIZE, BOX_MIN, BOX_MAX);
+        haze.Emitters().push_back({{8.0f, 12.0f, 12.0f}, {1.0f, 0.0f, 0.0f}, 2.0f, 200.0f, 0.0f});
+        if (fan)
+            haze.Fans().push_back({{6.0f, 12.0f, 12.0f}, {1.0f, 0.0f, 0.0f}, 5.0f, 30.0f});
+        for (int tick = 0; tick < 60; ++tick)
+            haze.Step(DT);
+
+        // Finite and never negative, whatever the flow did
+        for (float d : haze.GetDensity())
+            assert(std::isfinite(d) && d >= 0.0f);
+        return ExcessCenterX(haze);
+    };
+    const double still = run(false);
+    const double blown = run(true);
+    std::cout << "  haze center x " << still << " still, " << blown << " with the fan" << std::endl;
+    assert(std::fabs(still - 8.5) < 0.5);
+    assert(blown > still + 1.0);
+    std::cout << "Transport test passed." << std::endl;
+}
+
+void TestFixedTick()
+{
+    HazeSimulation haze(SIZE, BOX_MIN, BOX_MAX);
+    const size_t version = haze.GetVersion();
+
+    // Frames shorter than a tick accumulate until one fits
+    assert(haze.Update(DT * 0.6f) == 0);
+    assert(haze.GetVersion() == version);
+    assert(haze.Update(DT * 0.6f) == 1);
+    assert(haze.GetVersion() == version + 1);
+
+    // A long frame runs at most MAX_TICKS_PER_UPDATE ticks and drops the rest
+    assert(haze.Update(DT * 10.0f) == Config::Haze::MAX_TICKS_PER_UPDATE);
+    assert(haze.Update(DT * 0.5f) <= 1);
+
+    // Disabled, nothing runs
+    haze.Enabled() = false;
+    assert(haze.Update(DT * 3.0f) == 0);
+
+    // Sampling at cell centers reads the cells; outside the box it clamps
+    haze.Enabled() = true;
+    haze.Reset();
+    haze.Emitters().push_back({{4.5f, 4.5f, 4.5f}, {1.0f, 0.0f, 0.0f}, 0.1f, 1.0f, 0.0f});
+    haze.Step(DT);
+    const float cell = haze.GetDensity()[haze.Index(5, 5, 5)];
+    assert(std::fabs(haze.SampleDensity({4.5f, 4.5f, 4.5f}) - cell) < 1e-6f);
+    assert(std::fabs(haze.SampleDensity({-3.0f, -3.0f, -3.0f}) - haze.GetDensity()[haze.Index(1, 1, 1)]) < 1e-6f);
+    const float between = haze.SampleDensity({5.0f, 4.5f, 4.5f});
+    assert(std::fabs(between - (0.5f * (cell + haze.GetDensity()[haze.Index(6, 5, 5)]))) < 1e-6f);
+    std::cout << "Fixed tick test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestConservation();
+        TestProjection();
+        TestTransport();
+        TestFixedTick();
+        std::cout << "All HazeSimulation tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
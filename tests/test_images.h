@@ -0,0 +1,82 @@
+/**
+ * @file test_images.h
+ * @brief Synthetic image files for the gobo tests, in the format GDTFParser builds the open gobo.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TestImages
+{
+
+/**
+ * @brief Uncompressed 32-bit TGA, top-left origin.
+ *
+ * @param width Width in texels.
+ * @param height Height in texels.
+ * @param texel Called with (x, y); returns the texel as {red, green, blue, alpha}.
+ * @return The file's bytes.
+ */
+template <typename Texel> std::vector<uint8_t> MakeTga(int width, int height, Texel texel)
+{
+    std::vector<uint8_t> tga(18 + (static_cast<size_t>(width) * height * 4));
+    tga[2] = 2;
+    tga[12] = static_cast<uint8_t>(width);
+    tga[13] = static_cast<uint8_t>(width >> 8);
+    tga[14] = static_cast<uint8_t>(height);
+    tga[15] = static_cast<uint8_t>(height >> 8);
+    tga[16] = 32;
+    tga[17] = 0x20;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const std::array<uint8_t, 4> rgba = texel(x, y);
+            uint8_t *bgra = &tga[18 + ((static_cast<size_t>(y) * width + x) * 4)];
+            bgra[0] = rgba[2];
+            bgra[1] = rgba[1];
+            bgra[2] = rgba[0];
+            bgra[3] = rgba[3];
+        }
+    }
+    return tga;
+}
+
+/**
+ * @brief Opaque TGA filled with a pattern that differs for every seed.
+ *
+ * @param width Width in texels.
+ * @param height Height in texels.
+ * @param seed Pattern seed.
+ * @param tinted Give red the inverse of the grey level, so the image is not monochrome.
+ * @return The file's bytes.
+ */
+inline std::vector<uint8_t> PatternTga(int width, int height, int seed, bool tinted = false)
+{
+    return MakeTga(width, height, [seed, tinted](int x, int y) {
+        const auto value = static_cast<uint8_t>(((x * (seed + 1)) + (y * 7) + (seed * 31)) & 0xFF);
+        const uint8_t red = tinted ? static_cast<uint8_t>(255 - value) : value;
+        return std::array<uint8_t, 4>{red, value, value, 255};
+    });
+}
+
+/**
+ * @brief TGA of a single grey level.
+ *
+ * @param width Width in texels.
+ * @param height Height in texels.
+ * @param value Grey level.
+ * @param alpha Alpha of every texel.
+ * @return The file's bytes.
+ */
+inline std::vector<uint8_t> SolidTga(int width, int height, uint8_t value, uint8_t alpha = 255)
+{
+    return MakeTga(width, height,
+                   [value, alpha](int, int) { return std::array<uint8_t, 4>{value, value, value, alpha}; });
+}
+
+} // namespace TestImages
@@ -0,0 +1,225 @@
+#include "Rendering/LightSampling.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+constexpr int TILE = 16;
+constexpr float MIN_DISTANCE = 1.0f;
+constexpr float UNIFORM_MIX = 0.1f;
+
+/// Probability of each outcome, read from the table's columns.
+std::vector<double> TableMass(const std::vector<LightSampling::AliasEntry> &entries)
+{
+    const int count = static_cast<int>(entries.size());
+    std::vector<double> mass(entries.size(), 0.0);
+    for (int i = 0; i < count; ++i)
+    {
+        const double threshold = entries[i].threshold;
+        mass[i] += threshold / count;
+        mass[static_cast<size_t>(entries[i].alias)] += (1.0 - threshold) / count;
+    }
+    return mass;
+}
+
+DirectX::XMFLOAT3 ScreenToWorld(const DirectX::XMFLOAT4X4 &inv, float u, float v, float depth)
+{
+    const float cx = (u * 2.0f) - 1.0f;
+    const float cy = ((1.0f - v) * 2.0f) - 1.0f;
+    const float x = (cx * inv._11) + (cy * inv._21) + (depth * inv._31) + inv._41;
+    const float y = (cx * inv._12) + (cy * inv._22) + (depth * inv._32) + inv._42;
+    const float z = (cx * inv._13) + (cy * inv._23) + (depth * inv._33) + inv._43;
+    const float w = (cx * inv._14) + (cy * inv._24) + (depth * inv._34) + inv._44;
+    return {x / w, y / w, z / w};
+}
+
+void TestAliasTable()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (int count : {1, 2, 5, 13, 64})
+    {
+        std::vector<float> weights(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i)
+            weights[i] = i % 4 == 3 ? 0.0f : uniform(rng) * uniform(rng) * 10.0f;
+        if (count == 1)
+            weights[0] = 2.0f;
+        std::vector<LightSampling::AliasEntry> entries(static_cast<size_t>(count));
+        float sum = LightSampling::BuildAliasTable(weights.data(), count, entries.data());
+        assert(sum > 0.0f);
+
+        // The columns add up to the normalized weights, and the pdfs are those weights
+        const std::vector<double> mass = TableMass(entries);
+        for (int i = 0; i < count; ++i)
+        {
+            assert(entries[i].threshold >= 0.0f && entries[i].threshold <= 1.0f);
+            assert(std::fabs(mass[i] - (weights[i] / sum)) < 1e-5);
+            assert(std::fabs(entries[i].pdf - (weights[i] / sum)) < 1e-6f);
+        }
+
+        // Drawn frequencies match the weights (chi-square, p = 0.001)
+        constexpr int DRAWS = 400000;
+        std::vector<int> histogram(static_cast<size_t>(count), 0);
+        for (int d = 0; d < DRAWS; ++d)
+        {
+            const int i = LightSampling::Sample(entries.data(), count, uniform(rng) * 0.99999994f);
+            assert(i >= 0 && i < count);
+            ++histogram[i];
+        }
+        double chiSquare = 0.0;
+        int degrees = -1;
+        for (int i = 0; i < count; ++i)
+        {
+            const double expected = DRAWS * static_cast<double>(weights[i]) / sum;
+            if (expected == 0.0)
+            {
+                assert(histogram[i] == 0);
+                continue;
+            }
+            chiSquare += (histogram[i] - expected) * (histogram[i] - expected) / expected;
+            ++degrees;
+        }
+        const double critical = degrees + (3.1 * std::sqrt(2.0 * degrees)) + 3.0;
+        std::cout << "  " << count << " outcomes: chi-square " << chiSquare << " (" << degrees << " degrees)"
+                  << std::endl;
+        assert(chiSquare < critical);
+
+        // Both ends of the unit interval stay in range
+        assert(LightSampling::Sample(entries.data(), count, 0.0f) < count);
+        assert(LightSampling::Sample(entries.data(), count, 0.99999994f) < count);
+    }
+
+    // Nothing to pick: every column keeps its own outcome with no probability
+    std::vector<float> zeros(4, 0.0f);
+    std::vector<LightSampling::AliasEntry> entries(4);
+    assert(LightSampling::BuildAliasTable(zeros.data(), 4, entries.data()) == 0.0f);
+    for (int i = 0; i < 4; ++i)
+        assert(entries[i].pdf == 0.0f && LightSampling::Sample(entries.data(), 4, (i + 0.5f) / 4.0f) == i);
+    std::cout << "Alias table test passed." << std::endl;
+}
+
+void TestTileTables()
+{
+    const DirectX::XMFLOAT3 cameraPos = {2.0f, 6.0f, -30.0f};
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(
+        DirectX::XMVectorSet(cameraPos.x, cameraPos.y, cameraPos.z, 1.0f), DirectX::XMVectorSet(0.0f, 4.0f, 0.0f, 1.0f),
+        DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        DirectX::XM_PIDIV4, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+    DirectX::XMFLOAT4X4 invViewProj;
+    DirectX::XMStoreFloat4x4(&invViewProj, DirectX::XMMatrixInverse(nullptr, view * proj));
+
+    // Many lights over the stage, with random screen rectangles; some off
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<LightSampling::Light> lights(37);
+    for (size_t j = 0; j < lights.size(); ++j)
+    {
+        LightSampling::Light &light = lights[j];
+        light.position = {(uniform(rng) - 0.5f) * 60.0f, 5.0f + (uniform(rng) * 20.0f), (uniform(rng) - 0.5f) * 60.0f};
+        light.power = j % 9 == 4 ? 0.0f : 10.0f + (uniform(rng) * 90.0f);
+        const float u = uniform(rng);
+        const float v = uniform(rng);
+        light.screenMin = {u - (uniform(rng) * 0.4f), v - (uniform(rng) * 0.4f)};
+        light.screenMax = {u + (uniform(rng) * 0.4f), v + (uniform(rng) * 0.4f)};
+    }
+    lights[0].screenMin = {0.0f, 0.0f}; // Every tile sees at least one light
+    lights[0].screenMax = {1.0f, 1.0f};
+
+    LightSampling::Tables tables;
+    assert(LightSampling::BuildTileTables(lights, invViewProj, cameraPos, WIDTH, HEIGHT, TILE, MIN_DISTANCE,
+                                          UNIFORM_MIX, tables));
+    assert(tables.tilesX == 120 && tables.tilesY == 68 && tables.lightCount == 37);
+    assert(tables.entries.size() == static_cast<size_t>(120) * 68 * 37);
+
+    const float tileU = static_cast<float>(TILE) / WIDTH;
+    const float tileV = static_cast<float>(TILE) / HEIGHT;
+    const int count = tables.lightCount;
+    for (int ty = 0; ty < tables.tilesY; ++ty)
+    {
+        for (int tx = 0; tx < tables.tilesX; ++tx)
+        {
+            // The tile's ray and weights, one tile and one light at a time
+            const float centerU = 0.5f * static_cast<float>((tx * TILE) + (std::min)((tx + 1) * TILE, WIDTH)) / WIDTH;
+            const float centerV = 0.5f * static_cast<float>((ty * TILE) + (std::min)((ty + 1) * TILE, HEIGHT)) / HEIGHT;
+            const DirectX::XMFLOAT3 farPoint = ScreenToWorld(invViewProj, centerU, centerV, 1.0f);
+            DirectX::XMFLOAT3 dir = {farPoint.x - cameraPos.x, farPoint.y - cameraPos.y, farPoint.z - cameraPos.z};
+            const float length = std::sqrt((dir.x * dir.x) + (dir.y * dir.y) + (dir.z * dir.z));
+            dir = {dir.x / length, dir.y / length, dir.z / length};
+            const DirectX::XMFLOAT2 tileMin = {tx * tileU, ty * tileV};
+            const DirectX::XMFLOAT2 tileMax = {(tx + 1) * tileU, (ty + 1) * tileV};
+            std::vector<float> weights(static_cast<size_t>(count));
+            float sum = 0.0f;
+            int nonZero = 0;
+            for (int j = 0; j < count; ++j)
+            {
+                weights[j] = LightSampling::TileWeight(lights[j], cameraPos, dir, tileMin, tileMax, MIN_DISTANCE);
+                sum += weights[j];
+                nonZero += weights[j] > 0.0f ? 1 : 0;
+            }
+            assert(sum > 0.0f);
+
+            const size_t first = ((static_cast<size_t>(ty) * tables.tilesX) + tx) * count;
+            const std::vector<LightSampling::AliasEntry> entries(tables.entries.begin() + first,
+                                                                 tables.entries.begin() + first + count);
+            const std::vector<double> mass = TableMass(entries);
+            double pdfSum = 0.0;
+            for (int j = 0; j < count; ++j)
+            {
+                const float expected =
+                    weights[j] > 0.0f ? ((1.0f - UNIFORM_MIX) * weights[j] / sum) + (UNIFORM_MIX / nonZero) : 0.0f;
+                assert(std::fabs(entries[j].pdf - expected) < 1e-4f * (std::max)(expected, 1e-3f));
+                assert(std::fabs(mass[j] - entries[j].pdf) < 1e-5);
+                assert(weights[j] > 0.0f || entries[j].pdf == 0.0f);
+                pdfSum += entries[j].pdf;
+            }
+            assert(std::fabs(pdfSum - 1.0) < 1e-4);
+        }
+    }
+
+    // A light is favoured by the tiles whose rays pass near it
+    std::vector<LightSampling::Light> pair(2);
+    pair[0].position = {0.0f, 4.0f, 0.0f};
+    pair[1].position = {20.0f, 4.0f, 0.0f};
+    for (LightSampling::Light &light : pair)
+    {
+        light.power = 50.0f;
+        light.screenMin = {0.0f, 0.0f};
+        light.screenMax = {1.0f, 1.0f};
+    }
+    assert(LightSampling::BuildTileTables(pair, invViewProj, cameraPos, WIDTH, HEIGHT, TILE, MIN_DISTANCE, UNIFORM_MIX,
+                                          tables));
+    const size_t center = ((static_cast<size_t>(tables.tilesY / 2) * tables.tilesX) + (tables.tilesX / 2)) * 2;
+    assert(tables.entries[center].pdf > 0.8f);
+
+    assert(!LightSampling::BuildTileTables({}, invViewProj, cameraPos, WIDTH, HEIGHT, TILE, MIN_DISTANCE, UNIFORM_MIX,
+                                           tables));
+    assert(!LightSampling::BuildTileTables(pair, invViewProj, cameraPos, WIDTH, HEIGHT, 0, MIN_DISTANCE, UNIFORM_MIX,
+                                           tables));
+    std::cout << "Tile tables test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestAliasTable();
+        TestTileTables();
+        std::cout << "All LightSampling tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file test_lights.h
+ * @brief Spotlights for the volumetric tests, set up through Spotlight so their GPU data
+ * (shadow matrix included) is what the renderer uploads.
+ */
+
+#pragma once
+
+#include <DirectXMath.h>
+#include "Core/Config.h"
+#include "Scene/Spotlight.h"
+
+namespace TestLights
+{
+
+/**
+ * @brief Spotlight at a position shining along a direction.
+ *
+ * @param pos Light position.
+ * @param dir Beam direction (normalized by Spotlight).
+ * @param range Range, also the far plane of the shadow matrix.
+ * @param intensity Light intensity.
+ * @param field Cosine of the field half-angle.
+ * @return The light's GPU data.
+ */
+inline SpotlightData Along(const DirectX::XMFLOAT3 &pos, const DirectX::XMFLOAT3 &dir, float range = 30.0f,
+                           float intensity = 10.0f, float field = Config::Spotlight::DEFAULT_FIELD_ANGLE)
+{
+    Spotlight light;
+    light.SetPosition(pos);
+    light.SetDirection(dir);
+    light.SetRange(range);
+    light.SetIntensity(intensity);
+    light.SetFieldAngle(field);
+    light.UpdateLightMatrix();
+    return light.GetGPUData();
+}
+
+/**
+ * @brief Spotlight at a position aimed at a target.
+ *
+ * @param pos Light position.
+ * @param target Point the beam axis goes through.
+ * @param range Range, also the far plane of the shadow matrix.
+ * @return The light's GPU data.
+ */
+inline SpotlightData AimedAt(const DirectX::XMFLOAT3 &pos, const DirectX::XMFLOAT3 &target, float range = 30.0f)
+{
+    return Along(pos, {target.x - pos.x, target.y - pos.y, target.z - pos.z}, range);
+}
+
+/**
+ * @brief Spotlight at the default intensity with a given cone, for the bounds and budget tests.
+ *
+ * @param pos Light position.
+ * @param dir Beam direction (normalized by Spotlight).
+ * @param field Cosine of the field half-angle.
+ * @param range Range.
+ * @return The light's GPU data.
+ */
+inline SpotlightData Beam(const DirectX::XMFLOAT3 &pos, const DirectX::XMFLOAT3 &dir, float field, float range)
+{
+    return Along(pos, dir, range, Config::Spotlight::DEFAULT_INTENSITY, field);
+}
+
+} // namespace TestLights
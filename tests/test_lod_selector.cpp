@@ -0,0 +1,118 @@
+#include "Scene/LodSelector.h"
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include "Core/Config.h"
+
+bool NearEqual(float a, float b, float epsilon = 1e-4f)
+{
+    return std::abs(a - b) < epsilon;
+}
+
+void TestSelectLod()
+{
+    const float thresholds[] = {0.12f, 0.06f, 0.03f};
+    assert(LodSelector::SelectLod(0.5f, thresholds, 3, 4) == 0);
+    assert(LodSelector::SelectLod(0.12f, thresholds, 3, 4) == 0);
+    assert(LodSelector::SelectLod(0.1f, thresholds, 3, 4) == 1);
+    assert(LodSelector::SelectLod(0.05f, thresholds, 3, 4) == 2);
+    assert(LodSelector::SelectLod(0.01f, thresholds, 3, 4) == 3);
+    assert(LodSelector::SelectLod(FLT_MAX, thresholds, 3, 4) == 0);
+
+    // Meshes with fewer levels use their coarsest one
+    assert(LodSelector::SelectLod(0.01f, thresholds, 3, 2) == 1);
+    assert(LodSelector::SelectLod(0.01f, thresholds, 3, 1) == 0);
+    assert(LodSelector::SelectLod(0.01f, thresholds, 3, 0) == 0);
+    std::cout << "LOD selection passed." << std::endl;
+}
+
+void TestProjectedSize()
+{
+    // 90 degree vertical FOV: a sphere of radius 1 at distance 10 spans a tenth of the height
+    DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0, 0, 0, 1), DirectX::XMVectorSet(0, 0, 1, 1),
+                                                       DirectX::XMVectorSet(0, 1, 0, 0));
+    DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(Config::Math::PI_DIV_2, 1.0f, 0.1f, 100.0f);
+    const DirectX::XMMATRIX viewProj = view * proj;
+
+    assert(NearEqual(LodSelector::ProjectedSize({0, 0, 10, 1}, viewProj), 0.1f));
+    assert(NearEqual(LodSelector::ProjectedSize({0, 0, 20, 1}, viewProj), 0.05f));
+    assert(NearEqual(LodSelector::ProjectedSize({0, 0, 20, 2}, viewProj), 0.1f));
+    // Off-axis spheres use their view depth, not their distance
+    assert(NearEqual(LodSelector::ProjectedSize({5, 3, 10, 1}, viewProj), 0.1f));
+    // Viewpoint inside the sphere or the sphere behind it: always full detail
+    assert(LodSelector::ProjectedSize({0, 0, 0.5f, 1}, viewProj) == FLT_MAX);
+    assert(LodSelector::ProjectedSize({0, 0, -10, 1}, viewProj) == FLT_MAX);
+
+    // The size does not depend on where the viewpoint is or which way it looks
+    DirectX::XMMATRIX moved = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(30, 12, -4, 1),
+                                                        DirectX::XMVectorSet(30, 2, -4, 1), DirectX::XMVectorSet(0, 0, 1, 0));
+    assert(NearEqual(LodSelector::ProjectedSize({30, 2, -4, 1}, moved * proj), 0.1f));
+
+    // A narrower FOV magnifies
+    DirectX::XMMATRIX tele = DirectX::XMMatrixPerspectiveFovLH(Config::CameraDefaults::FOV, 16.0f / 9.0f, 0.1f, 100.0f);
+    const float expected = 1.0f / std::tan(Config::CameraDefaults::FOV * 0.5f) / 10.0f;
+    assert(NearEqual(LodSelector::ProjectedSize({0, 0, 10, 1}, view * tele), expected));
+    std::cout << "Projected size passed." << std::endl;
+}
+
+void TestTransformSphere()
+{
+    DirectX::XMMATRIX world = DirectX::XMMatrixScaling(2, 2, 2) * DirectX::XMMatrixTranslation(1, 2, 3);
+    DirectX::XMFLOAT4 sphere = LodSelector::TransformSphere({1, 0, 0, 0.5f}, world);
+    assert(NearEqual(sphere.x, 3) && NearEqual(sphere.y, 2) && NearEqual(sphere.z, 3) && NearEqual(sphere.w, 1));
+
+    // Non-uniform scale keeps the sphere conservative, rotation does not change it
+    world = DirectX::XMMatrixScaling(1, 3, 1) * DirectX::XMMatrixRotationY(0.7f);
+    sphere = LodSelector::TransformSphere({0, 0, 0, 1}, world);
+    assert(NearEqual(sphere.w, 3));
+    std::cout << "Sphere transform passed." << std::endl;
+}
+
+void TestSceneAndShadowThresholds()
+{
+    // Thresholds decrease level by level, and shadows never use a finer level than the scene
+    for (int i = 0; i < Config::Lod::MAX_LEVELS - 1; ++i)
+    {
+        if (i > 0)
+        {
+            assert(Config::Lod::SCENE_SCREEN_SIZES[i] < Config::Lod::SCENE_SCREEN_SIZES[i - 1]);
+            assert(Config::Lod::SHADOW_SCREEN_SIZES[i] < Config::Lod::SHADOW_SCREEN_SIZES[i - 1]);
+        }
+        assert(Config::Lod::SHADOW_SCREEN_SIZES[i] >= Config::Lod::SCENE_SCREEN_SIZES[i]);
+    }
+
+    // A fixture walking away from the camera steps through every level in both passes
+    size_t lastScene = 0;
+    size_t lastShadow = 0;
+    for (float size = 1.0f; size > 0.001f; size *= 0.9f)
+    {
+        const size_t scene = LodSelector::SelectLod(size, Config::Lod::SCENE_SCREEN_SIZES, Config::Lod::MAX_LEVELS - 1,
+                                                    Config::Lod::MAX_LEVELS);
+        const size_t shadow = LodSelector::SelectLod(size, Config::Lod::SHADOW_SCREEN_SIZES,
+                                                     Config::Lod::MAX_LEVELS - 1, Config::Lod::MAX_LEVELS);
+        assert(scene >= lastScene && shadow >= lastShadow && shadow >= scene);
+        lastScene = scene;
+        lastShadow = shadow;
+    }
+    assert(lastScene == Config::Lod::MAX_LEVELS - 1 && lastShadow == Config::Lod::MAX_LEVELS - 1);
+    std::cout << "Scene and shadow thresholds passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestSelectLod();
+        TestProjectedSize();
+        TestTransformSphere();
+        TestSceneAndShadowThresholds();
+        std::cout << "All LodSelector tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
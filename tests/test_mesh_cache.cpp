@@ -0,0 +1,220 @@
+#include "Geometry/MeshOptimizer.h"
+#include "Resources/MeshCache.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static const char *SOURCE_FILE = "test_mesh_cache_source.obj";
+static const char *CACHE_FILE = "test_mesh_cache_source.obj.meshcache";
+
+MeshData MakeMesh()
+{
+    MeshData mesh;
+    for (int i = 0; i < 12; ++i)
+    {
+        Vertex v = {};
+        v.position = {static_cast<float>(i), static_cast<float>(i % 3) - 1.0f, 0.5f};
+        v.normal = {0.0f, 1.0f, 0.0f};
+        v.uv = {0.25f * static_cast<float>(i), 0.0f};
+        mesh.vertices.push_back(v);
+    }
+    mesh.indices = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+    ShapeInfo a;
+    a.name = "Anchor.001";
+    a.center = {1.0f, 2.0f, 3.0f};
+    a.material.diffuse = {0.8f, 0.1f, 0.1f};
+    a.material.shininess = 250.0f;
+    a.indexCount = 6;
+    ShapeInfo b;
+    b.name = "Truss";
+    b.startIndex = 6;
+    b.indexCount = 6;
+    b.baseVertex = 6;
+    for (uint32_t i = 6; i < 12; ++i)
+        mesh.indices[i] -= 6;
+    mesh.shapes = {a, b};
+    mesh.minY = -1.0f;
+    return mesh;
+}
+
+void WriteSource(const std::string &text)
+{
+    std::ofstream out(SOURCE_FILE, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+MeshCache::Derived MakeDerived(const MeshData &mesh)
+{
+    MeshCache::Derived derived;
+    derived.positionBounds.min = {0.0f, -1.0f, 0.5f};
+    derived.positionBounds.extent = {11.0f, 2.0f, 0.0f};
+    derived.positions.resize(mesh.vertices.size());
+    for (size_t i = 0; i < derived.positions.size(); ++i)
+        derived.positions[i].position[0] = static_cast<uint16_t>(i * 5957);
+
+    MeshCluster cluster;
+    cluster.sphere = {5.5f, 0.0f, 0.5f, 6.0f};
+    cluster.shape = 1;
+    cluster.startIndex = 3;
+    cluster.indexCount = 3;
+    derived.clusters = {MeshCluster(), cluster};
+    derived.clusters[0].indexCount = 6;
+    derived.occluderTriangles = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+    return derived;
+}
+
+bool WriteCache(const MeshData &mesh, const std::vector<MeshCache::SourceStamp> &stamps,
+                const MeshCache::Derived &derived)
+{
+    std::vector<uint8_t> bytes;
+    std::vector<IndexRange> ranges;
+    MeshOptimizer::PackIndices(mesh.indices, mesh.shapes, bytes, ranges);
+
+    PackedMeshView view;
+    view.vertices = mesh.vertices.data();
+    view.vertexCount = mesh.vertices.size();
+    view.indexBytes = bytes.data();
+    view.indexByteCount = bytes.size();
+    view.ranges = ranges.data();
+    view.rangeCount = ranges.size();
+    return MeshCache::Write(CACHE_FILE, stamps, view, mesh.shapes, mesh.minY, derived);
+}
+
+bool WriteCache(const MeshData &mesh, const std::vector<MeshCache::SourceStamp> &stamps)
+{
+    return WriteCache(mesh, stamps, MakeDerived(mesh));
+}
+
+void TestRoundTrip()
+{
+    WriteSource("o Anchor.001\nv 0 0 0\n");
+    auto stamps = MeshCache::ComputeStamps({SOURCE_FILE, "test_mesh_cache_missing.mtl"});
+    assert(stamps.size() == 2);
+    assert(stamps[0].size == 21 && stamps[0].hash != 0);
+    assert(stamps[1].size == 0 && stamps[1].hash == 0);
+
+    MeshData mesh = MakeMesh();
+    assert(WriteCache(mesh, stamps));
+
+    MeshCache cache;
+    assert(cache.Open(CACHE_FILE, stamps));
+    const PackedMeshView &view = cache.GetView();
+    assert(view.vertexCount == mesh.vertices.size());
+    assert(std::memcmp(view.vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) == 0);
+    assert(reinterpret_cast<uintptr_t>(view.vertices) % 16 == 0);
+    assert(view.rangeCount == 2);
+    assert(view.ranges[1].baseVertex == 6 && view.ranges[1].indexSize == 2);
+
+    const uint16_t *narrow = reinterpret_cast<const uint16_t *>(view.indexBytes);
+    for (uint32_t i = 0; i < 12; ++i)
+        assert(narrow[i] == mesh.indices[i]);
+
+    assert(cache.GetShapes().size() == 2);
+    assert(cache.GetShapes()[0].name == "Anchor.001");
+    assert(cache.GetShapes()[1].name == "Truss");
+    assert(cache.GetShapes()[0].center.z == 3.0f);
+    assert(cache.GetShapes()[0].material.shininess == 250.0f);
+    assert(cache.GetShapes()[1].startIndex == 6 && cache.GetShapes()[1].baseVertex == 6);
+    assert(cache.GetMinY() == -1.0f);
+
+    // Derived data comes back as written, so a cache hit does not rebuild it
+    const MeshCache::Derived expected = MakeDerived(mesh);
+    const MeshCache::Derived derived = cache.TakeDerived();
+    assert(derived.positionBounds.min.y == -1.0f && derived.positionBounds.extent.x == 11.0f);
+    assert(derived.positions.size() == mesh.vertices.size());
+    assert(std::memcmp(derived.positions.data(), expected.positions.data(),
+                       expected.positions.size() * sizeof(VertexQuantizer::QuantizedPosition)) == 0);
+    assert(derived.clusters.size() == 2 && derived.clusters[1].shape == 1 && derived.clusters[1].startIndex == 3);
+    assert(derived.clusters[1].sphere.w == 6.0f);
+    assert(derived.occluderTriangles.size() == 3 && derived.occluderTriangles[2].y == 1.0f);
+    std::cout << "Round trip test passed." << std::endl;
+}
+
+void TestInvalidation()
+{
+    WriteSource("o Anchor.001\nv 0 0 0\n");
+    auto stamps = MeshCache::ComputeStamps({SOURCE_FILE});
+    assert(WriteCache(MakeMesh(), stamps));
+
+    MeshCache cache;
+    assert(cache.Open(CACHE_FILE, stamps));
+
+    // Same size, different content
+    auto changed = stamps;
+    changed[0].hash ^= 1;
+    assert(!cache.Open(CACHE_FILE, changed));
+
+    changed = stamps;
+    changed[0].modifiedAt += 1;
+    assert(!cache.Open(CACHE_FILE, changed));
+
+    changed = stamps;
+    changed[0].size += 1;
+    assert(!cache.Open(CACHE_FILE, changed));
+
+    // A companion file appearing changes the stamp list
+    assert(!cache.Open(CACHE_FILE, MeshCache::ComputeStamps({SOURCE_FILE, SOURCE_FILE})));
+
+    // Editing the source in place changes its hash even at equal size
+    WriteSource("o Anchor.002\nv 0 0 0\n");
+    auto edited = MeshCache::ComputeStamps({SOURCE_FILE});
+    assert(edited[0].size == stamps[0].size && edited[0].hash != stamps[0].hash);
+    assert(!cache.Open(CACHE_FILE, edited));
+
+    // Clusters reaching past their index range are rejected
+    MeshData mesh = MakeMesh();
+    MeshCache::Derived outside = MakeDerived(mesh);
+    outside.clusters[1].indexCount = 6;
+    assert(WriteCache(mesh, stamps, outside));
+    assert(!cache.Open(CACHE_FILE, stamps));
+    outside = MakeDerived(mesh);
+    outside.clusters[1].shape = 2;
+    assert(WriteCache(mesh, stamps, outside));
+    assert(!cache.Open(CACHE_FILE, stamps));
+    assert(WriteCache(mesh, stamps));
+
+    // Truncated and foreign files are rejected
+    {
+        std::ifstream in(CACHE_FILE, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(CACHE_FILE, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    assert(!cache.Open(CACHE_FILE, stamps));
+    WriteSource("not a cache");
+    assert(!cache.Open(SOURCE_FILE, stamps));
+    assert(!cache.Open("test_mesh_cache_nothing.meshcache", stamps));
+
+    std::cout << "Invalidation test passed." << std::endl;
+}
+
+void TestHash()
+{
+    std::vector<uint8_t> data(3 * 1024 * 1024 + 5);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<uint8_t>((i * 31) ^ (i >> 7));
+
+    uint64_t h = MeshCache::HashBytes(data.data(), data.size());
+    assert(h == MeshCache::HashBytes(data.data(), data.size()));
+    data[2 * 1024 * 1024 + 3] ^= 0x10;
+    assert(h != MeshCache::HashBytes(data.data(), data.size()));
+    assert(MeshCache::HashBytes(data.data(), 7) != MeshCache::HashBytes(data.data(), 8));
+    std::cout << "Hash test passed." << std::endl;
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestInvalidation();
+    TestHash();
+
+    std::remove(SOURCE_FILE);
+    std::remove(CACHE_FILE);
+    std::cout << "All MeshCache tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "Geometry/MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Builds a de-indexed N x N quad grid (one vertex per triangle corner), like the OBJ loader emits.
+MeshData MakeDeindexedGrid(int n)
+{
+    MeshData mesh;
+    auto corner = [n](int x, int z)
+    {
+        Vertex v = {};
+        v.position = {static_cast<float>(x), 0.0f, static_cast<float>(z)};
+        v.normal = {0.0f, 1.0f, 0.0f};
+        v.uv = {static_cast<float>(x) / static_cast<float>(n), static_cast<float>(z) / static_cast<float>(n)};
+        return v;
+    };
+
+    for (int z = 0; z < n; ++z)
+    {
+        for (int x = 0; x < n; ++x)
+        {
+            const Vertex quad[6] = {corner(x, z),     corner(x + 1, z),     corner(x + 1, z + 1),
+                                    corner(x, z),     corner(x + 1, z + 1), corner(x, z + 1)};
+            for (const auto &v : quad)
+            {
+                mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+                mesh.vertices.push_back(v);
+            }
+        }
+    }
+    return mesh;
+}
+
+// Sorted list of triangles expressed as positions, independent of vertex/index order
+std::vector<std::array<float, 9>> CollectTriangles(const MeshData &mesh)
+{
+    std::vector<std::array<float, 9>> tris;
+    auto emit = [&](uint32_t start, uint32_t count, int32_t base)
+    {
+        for (uint32_t i = start; i < start + count; i += 3)
+        {
+            std::array<float, 9> t = {};
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                const Vertex &v = mesh.vertices[mesh.indices[i + k] + base];
+                t[k * 3] = v.position.x;
+                t[(k * 3) + 1] = v.position.y;
+                t[(k * 3) + 2] = v.position.z;
+            }
+            tris.push_back(t);
+        }
+    };
+
+    if (mesh.shapes.empty())
+        emit(0, static_cast<uint32_t>(mesh.indices.size()), 0);
+    for (const auto &shape : mesh.shapes)
+        emit(shape.startIndex, shape.indexCount, shape.baseVertex);
+
+    std::sort(tris.begin(), tris.end());
+    return tris;
+}
+
+void TestWeld()
+{
+    std::cout << "Testing vertex welding..." << std::endl;
+    MeshData mesh = MakeDeindexedGrid(8);
+    assert(mesh.vertices.size() == 8 * 8 * 6);
+
+    MeshOptimizer::WeldVertices(mesh.vertices, mesh.indices);
+    assert(mesh.vertices.size() == 9 * 9);
+    assert(mesh.indices.size() == 8 * 8 * 6);
+    std::cout << "Vertex welding passed." << std::endl;
+}
+
+void TestCacheOptimization()
+{
+    std::cout << "Testing vertex cache optimization..." << std::endl;
+    MeshData mesh = MakeDeindexedGrid(64);
+    MeshOptimizer::WeldVertices(mesh.vertices, mesh.indices);
+
+    // Row-major order of a wide grid thrashes a 16-entry FIFO
+    float before = MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size());
+    std::vector<uint32_t> original = mesh.indices;
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+    float after = MeshOptimizer::ComputeACMR(mesh.indices, mesh.vertices.size());
+
+    assert(after < before);
+    assert(after < 0.8f);
+
+    // Same triangles, just reordered
+    std::vector<uint32_t> a = original;
+    std::vector<uint32_t> b = mesh.indices;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    assert(a == b);
+    std::cout << "Vertex cache optimization passed (ACMR " << before << " -> " << after << ")." << std::endl;
+}
+
+void TestFetchOptimization()
+{
+    std::cout << "Testing vertex fetch optimization..." << std::endl;
+    MeshData mesh = MakeDeindexedGrid(4);
+    MeshOptimizer::WeldVertices(mesh.vertices, mesh.indices);
+    std::reverse(mesh.indices.begin(), mesh.indices.end());
+
+    auto trisBefore = CollectTriangles(mesh);
+    MeshOptimizer::OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    // Every new vertex is referenced for the first time in increasing order
+    uint32_t next = 0;
+    for (uint32_t index : mesh.indices)
+    {
+        assert(index <= next);
+        if (index == next)
+            next++;
+    }
+    assert(next == mesh.vertices.size());
+    assert(CollectTriangles(mesh) == trisBefore);
+    std::cout << "Vertex fetch optimization passed." << std::endl;
+}
+
+void TestProcessMeshShapes()
+{
+    std::cout << "Testing ProcessMesh with shapes..." << std::endl;
+    MeshData mesh = MakeDeindexedGrid(16);
+    const auto half = static_cast<uint32_t>(mesh.indices.size() / 2);
+
+    ShapeInfo first;
+    first.name = "First";
+    first.startIndex = 0;
+    first.indexCount = half;
+    ShapeInfo second;
+    second.name = "Second";
+    second.startIndex = half;
+    second.indexCount = static_cast<uint32_t>(mesh.indices.size()) - half;
+    mesh.shapes = {first, second};
+
+    auto trisBefore = CollectTriangles(mesh);
+    MeshOptimizer::Stats stats = MeshOptimizer::ProcessMesh(mesh);
+
+    assert(stats.verticesBefore == 16 * 16 * 6);
+    assert(stats.verticesAfter < stats.verticesBefore);
+    assert(stats.acmrAfter < stats.acmrBefore);
+    assert(stats.triangles == 16 * 16 * 2);
+    assert(stats.batches == 1);
+
+    assert(mesh.shapes.size() == 2);
+    assert(mesh.shapes[0].name == "First" && mesh.shapes[1].name == "Second");
+    assert(mesh.shapes[1].startIndex == mesh.shapes[0].indexCount);
+    assert(CollectTriangles(mesh) == trisBefore);
+    std::cout << "ProcessMesh with shapes passed." << std::endl;
+}
+
+void TestSixteenBitBatches()
+{
+    std::cout << "Testing 16-bit index batching..." << std::endl;
+
+    // Three shapes of ~30K unique vertices each: at most two fit under one base vertex
+    MeshData mesh;
+    for (int s = 0; s < 3; ++s)
+    {
+        ShapeInfo shape;
+        shape.startIndex = static_cast<uint32_t>(mesh.indices.size());
+        for (int t = 0; t < 10000; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                Vertex v = {};
+                v.position = {static_cast<float>(s), static_cast<float>(t), static_cast<float>(k)};
+                mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+                mesh.vertices.push_back(v);
+            }
+        }
+        shape.indexCount = static_cast<uint32_t>(mesh.indices.size()) - shape.startIndex;
+        mesh.shapes.push_back(shape);
+    }
+
+    auto trisBefore = CollectTriangles(mesh);
+    MeshOptimizer::Stats stats = MeshOptimizer::ProcessMesh(mesh);
+    assert(stats.batches == 2);
+
+    for (const auto &shape : mesh.shapes)
+    {
+        for (uint32_t i = shape.startIndex; i < shape.startIndex + shape.indexCount; ++i)
+            assert(mesh.indices[i] < MeshOptimizer::MAX_16BIT_VERTICES);
+    }
+    assert(CollectTriangles(mesh) == trisBefore);
+    std::cout << "16-bit index batching passed." << std::endl;
+}
+
+void TestPackIndices()
+{
+    std::cout << "Testing mixed 16/32-bit index packing..." << std::endl;
+
+    // Shape 0 and 2 fit in 16 bits, shape 1 does not
+    std::vector<uint32_t> indices = {0, 1, 2, 3, 4, 5, 0, 70000, 2, 7, 8, 9};
+    std::vector<ShapeInfo> shapes(3);
+    for (uint32_t s = 0; s < 3; ++s)
+    {
+        shapes[s].startIndex = s == 0 ? 0 : (s == 1 ? 6 : 9);
+        shapes[s].indexCount = s == 0 ? 6 : 3;
+        shapes[s].baseVertex = static_cast<int32_t>(s) * 10;
+    }
+
+    std::vector<uint8_t> bytes;
+    std::vector<IndexRange> ranges;
+    MeshOptimizer::PackIndices(indices, shapes, bytes, ranges);
+    assert(ranges.size() == 3);
+    assert(ranges[0].indexSize == 2 && ranges[0].startIndex == 0 && ranges[0].byteOffset == 0);
+    assert(ranges[2].indexSize == 2 && ranges[2].startIndex == 6 && ranges[2].baseVertex == 20);
+    assert(ranges[1].indexSize == 4 && ranges[1].startIndex == 0);
+
+    // 9 narrow indices (18 bytes) padded to 20, then 3 wide indices
+    assert(ranges[1].byteOffset == 20);
+    assert(bytes.size() == 20 + 12);
+
+    for (size_t r = 0; r < ranges.size(); ++r)
+    {
+        for (uint32_t i = 0; i < ranges[r].indexCount; ++i)
+        {
+            const uint8_t *src = bytes.data() + ranges[r].byteOffset + ((ranges[r].startIndex + i) * ranges[r].indexSize);
+            uint32_t value = 0;
+            std::memcpy(&value, src, ranges[r].indexSize);
+            assert(value == indices[shapes[r].startIndex + i]);
+        }
+    }
+
+    // No shapes: a single range over everything
+    MeshOptimizer::PackIndices(indices, {}, bytes, ranges);
+    assert(ranges.size() == 1 && ranges[0].indexCount == indices.size() && ranges[0].indexSize == 4);
+    std::cout << "Index packing passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestWeld();
+        TestCacheOptimization();
+        TestFetchOptimization();
+        TestProcessMeshShapes();
+        TestSixteenBitBatches();
+        TestPackIndices();
+        std::cout << "All MeshOptimizer tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
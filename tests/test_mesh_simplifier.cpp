@@ -0,0 +1,290 @@
+#include "Geometry/MeshSimplifier.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "Geometry/MeshOptimizer.h"
+
+// Indexed N x N grid in the XZ plane, facing +y
+MeshData MakeGrid(int n)
+{
+    MeshData mesh;
+    for (int z = 0; z <= n; ++z)
+    {
+        for (int x = 0; x <= n; ++x)
+        {
+            Vertex v = {};
+            v.position = {static_cast<float>(x), 0.0f, static_cast<float>(z)};
+            v.normal = {0.0f, 1.0f, 0.0f};
+            mesh.vertices.push_back(v);
+        }
+    }
+    for (int z = 0; z < n; ++z)
+    {
+        for (int x = 0; x < n; ++x)
+        {
+            const auto i = static_cast<uint32_t>((z * (n + 1)) + x);
+            const auto row = static_cast<uint32_t>(n + 1);
+            mesh.indices.insert(mesh.indices.end(), {i, i + row + 1, i + 1, i, i + row, i + row + 1});
+        }
+    }
+    return mesh;
+}
+
+// Unit cube with each face subdivided n x n and its own normal, so the cube edges are seams
+MeshData MakeHardCube(int n)
+{
+    MeshData mesh;
+    const float axes[6][3][3] = {
+        {{1, 0, 0}, {0, 0, 1}, {0, 1, 0}},   {{-1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, {{0, 1, 0}, {1, 0, 0}, {0, 0, 1}},
+        {{0, -1, 0}, {0, 0, 1}, {1, 0, 0}},  {{0, 0, 1}, {0, 1, 0}, {1, 0, 0}},  {{0, 0, -1}, {1, 0, 0}, {0, 1, 0}}};
+    for (const auto &face : axes)
+    {
+        const float *normal = face[0];
+        const float *u = face[1];
+        const float *v = face[2];
+        const auto base = static_cast<uint32_t>(mesh.vertices.size());
+        for (int j = 0; j <= n; ++j)
+        {
+            for (int i = 0; i <= n; ++i)
+            {
+                const float s = (static_cast<float>(i) / static_cast<float>(n)) - 0.5f;
+                const float t = (static_cast<float>(j) / static_cast<float>(n)) - 0.5f;
+                Vertex vertex = {};
+                vertex.position = {(normal[0] * 0.5f) + (u[0] * s) + (v[0] * t),
+                                   (normal[1] * 0.5f) + (u[1] * s) + (v[1] * t),
+                                   (normal[2] * 0.5f) + (u[2] * s) + (v[2] * t)};
+                vertex.normal = {normal[0], normal[1], normal[2]};
+                mesh.vertices.push_back(vertex);
+            }
+        }
+        const auto row = static_cast<uint32_t>(n + 1);
+        for (int j = 0; j < n; ++j)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                const uint32_t k = base + (static_cast<uint32_t>(j) * row) + static_cast<uint32_t>(i);
+                mesh.indices.insert(mesh.indices.end(), {k, k + row, k + 1, k + 1, k + row, k + row + 1});
+            }
+        }
+    }
+    return mesh;
+}
+
+// Smooth unit UV sphere with shared poles and a welded longitude seam
+MeshData MakeSphere(int rings, int segments)
+{
+    MeshData mesh;
+    mesh.vertices.push_back({{0, 1, 0}, {0, 1, 0}, {0, 0}});
+    for (int r = 1; r < rings; ++r)
+    {
+        const double phi = 3.14159265358979 * r / rings;
+        for (int s = 0; s < segments; ++s)
+        {
+            const double theta = 2.0 * 3.14159265358979 * s / segments;
+            DirectX::XMFLOAT3 p = {static_cast<float>(std::sin(phi) * std::cos(theta)),
+                                   static_cast<float>(std::cos(phi)),
+                                   static_cast<float>(std::sin(phi) * std::sin(theta))};
+            mesh.vertices.push_back({p, p, {0, 0}});
+        }
+    }
+    mesh.vertices.push_back({{0, -1, 0}, {0, -1, 0}, {0, 0}});
+    const auto south = static_cast<uint32_t>(mesh.vertices.size() - 1);
+    auto ringVertex = [segments](int r, int s) { return static_cast<uint32_t>(1 + ((r - 1) * segments) + (s % segments)); };
+
+    for (int s = 0; s < segments; ++s)
+    {
+        mesh.indices.insert(mesh.indices.end(), {0, ringVertex(1, s + 1), ringVertex(1, s)});
+        mesh.indices.insert(mesh.indices.end(), {south, ringVertex(rings - 1, s), ringVertex(rings - 1, s + 1)});
+    }
+    for (int r = 1; r < rings - 1; ++r)
+    {
+        for (int s = 0; s < segments; ++s)
+        {
+            const uint32_t a = ringVertex(r, s);
+            const uint32_t b = ringVertex(r, s + 1);
+            const uint32_t c = ringVertex(r + 1, s);
+            const uint32_t d = ringVertex(r + 1, s + 1);
+            mesh.indices.insert(mesh.indices.end(), {a, b, d, a, d, c});
+        }
+    }
+    return mesh;
+}
+
+// Sum of signed triangle areas projected on each axis (zero vector for a closed surface)
+double Area(const MeshData &mesh, const std::vector<uint32_t> &indices)
+{
+    double area = 0.0;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const auto &p0 = mesh.vertices[indices[i]].position;
+        const auto &p1 = mesh.vertices[indices[i + 1]].position;
+        const auto &p2 = mesh.vertices[indices[i + 2]].position;
+        const double e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+        const double e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+        const double c[3] = {(e1[1] * e2[2]) - (e1[2] * e2[1]), (e1[2] * e2[0]) - (e1[0] * e2[2]),
+                             (e1[0] * e2[1]) - (e1[1] * e2[0])};
+        area += 0.5 * std::sqrt((c[0] * c[0]) + (c[1] * c[1]) + (c[2] * c[2]));
+    }
+    return area;
+}
+
+// Every triangle must keep the orientation of the surface it approximates
+bool FacesOutward(const MeshData &mesh, const std::vector<uint32_t> &indices)
+{
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const auto &p0 = mesh.vertices[indices[i]].position;
+        const auto &p1 = mesh.vertices[indices[i + 1]].position;
+        const auto &p2 = mesh.vertices[indices[i + 2]].position;
+        const double e1[3] = {p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+        const double e2[3] = {p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+        const double c[3] = {(e1[1] * e2[2]) - (e1[2] * e2[1]), (e1[2] * e2[0]) - (e1[0] * e2[2]),
+                             (e1[0] * e2[1]) - (e1[1] * e2[0])};
+        const double centroid[3] = {p0.x + p1.x + p2.x, p0.y + p1.y + p2.y, p0.z + p1.z + p2.z};
+        if ((c[0] * centroid[0]) + (c[1] * centroid[1]) + (c[2] * centroid[2]) <= 0.0)
+            return false;
+    }
+    return true;
+}
+
+void TestFlatGrid()
+{
+    MeshData grid = MakeGrid(16);
+    std::vector<uint32_t> result;
+    float error = MeshSimplifier::Simplify(grid.vertices.data(), grid.vertices.size(), grid.indices, 0, 0.01f, result);
+
+    // A plane collapses down to a handful of triangles without any error and keeps its outline
+    assert(error < 1e-4f);
+    assert(result.size() / 3 < 32);
+    assert(std::abs(Area(grid, result) - 256.0) < 1e-3);
+    for (uint32_t corner : {0u, 16u, 17u * 16u, (17u * 17u) - 1u})
+        assert(std::find(result.begin(), result.end(), corner) != result.end());
+    std::cout << "Flat grid simplification passed (" << grid.indices.size() / 3 << " -> " << result.size() / 3
+              << " triangles)." << std::endl;
+}
+
+void TestHardEdges()
+{
+    MeshData cube = MakeHardCube(6);
+    std::vector<uint32_t> result;
+    float error = MeshSimplifier::Simplify(cube.vertices.data(), cube.vertices.size(), cube.indices, 0, 0.01f, result);
+
+    // Faces flatten, but the seams keep every face on its own vertices and normal
+    assert(error < 1e-4f);
+    assert(result.size() / 3 <= 6 * 8);
+    assert(std::abs(Area(cube, result) - 6.0) < 1e-3);
+    assert(FacesOutward(cube, result));
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const auto &n0 = cube.vertices[result[i]].normal;
+        for (int k = 1; k < 3; ++k)
+        {
+            const auto &n = cube.vertices[result[i + k]].normal;
+            assert(n.x == n0.x && n.y == n0.y && n.z == n0.z);
+        }
+    }
+    std::cout << "Hard edge simplification passed (" << cube.indices.size() / 3 << " -> " << result.size() / 3
+              << " triangles)." << std::endl;
+}
+
+void TestErrorBound()
+{
+    MeshData sphere = MakeSphere(24, 48);
+    const size_t triangles = sphere.indices.size() / 3;
+
+    std::vector<uint32_t> loose;
+    std::vector<uint32_t> tight;
+    float looseError =
+        MeshSimplifier::Simplify(sphere.vertices.data(), sphere.vertices.size(), sphere.indices, 0, 0.05f, loose);
+    float tightError =
+        MeshSimplifier::Simplify(sphere.vertices.data(), sphere.vertices.size(), sphere.indices, 0, 0.005f, tight);
+
+    // Curved surfaces stop at the error limit, and a looser limit goes further
+    assert(looseError <= 0.05f && tightError <= 0.005f);
+    assert(loose.size() < tight.size() && tight.size() / 3 < triangles);
+    assert(FacesOutward(sphere, loose) && FacesOutward(sphere, tight));
+    assert(std::abs(Area(sphere, loose) - Area(sphere, sphere.indices)) < 0.1 * Area(sphere, sphere.indices));
+
+    // A target above the error limit is honoured
+    std::vector<uint32_t> half;
+    MeshSimplifier::Simplify(sphere.vertices.data(), sphere.vertices.size(), sphere.indices, (triangles / 2) * 3, 1.0f,
+                             half);
+    assert(half.size() <= (triangles / 2) * 3 && half.size() > (triangles / 3) * 3);
+    std::cout << "Error bound passed (" << triangles << " -> " << tight.size() / 3 << " at error " << tightError
+              << ", " << loose.size() / 3 << " at error " << looseError << ")." << std::endl;
+}
+
+void TestLodChain()
+{
+    // Two shapes on separate vertex blocks, as ProcessMesh leaves them
+    MeshData sphere = MakeSphere(24, 48);
+    MeshData mesh = sphere;
+    const auto sphereIndices = static_cast<uint32_t>(sphere.indices.size());
+    const auto sphereVertices = static_cast<int32_t>(sphere.vertices.size());
+    mesh.vertices.insert(mesh.vertices.end(), sphere.vertices.begin(), sphere.vertices.end());
+    mesh.indices.insert(mesh.indices.end(), sphere.indices.begin(), sphere.indices.end());
+    mesh.shapes.resize(2);
+    mesh.shapes[0].indexCount = sphereIndices;
+    mesh.shapes[1].startIndex = sphereIndices;
+    mesh.shapes[1].indexCount = sphereIndices;
+    mesh.shapes[1].baseVertex = sphereVertices;
+
+    const float ratios[] = {0.5f, 0.25f, 0.125f};
+    const float errors[] = {0.02f, 0.05f, 0.1f};
+    std::vector<MeshSimplifier::LevelReport> reports = MeshSimplifier::BuildLodChain(mesh, ratios, errors, 3);
+
+    assert(reports.size() == mesh.lods.size() + 1 && mesh.lods.size() >= 2);
+    assert(reports[0].triangles == mesh.indices.size() / 3 && reports[0].error == 0.0f);
+    for (size_t level = 0; level < mesh.lods.size(); ++level)
+    {
+        const LodLevel &lod = mesh.lods[level];
+        assert(reports[level + 1].triangles < reports[level].triangles);
+        assert(reports[level + 1].triangles == lod.indices.size() / 3);
+        // Errors are relative to the bounding radius (sqrt(3) for the unit sphere's box)
+        assert(lod.error <= errors[level] * std::sqrt(3.0f));
+
+        // Shapes keep their base vertex and only reference their own vertex block
+        assert(lod.shapes.size() == 2);
+        assert(lod.shapes[0].startIndex == 0 && lod.shapes[1].startIndex == lod.shapes[0].indexCount);
+        assert(lod.shapes[0].indexCount + lod.shapes[1].indexCount == lod.indices.size());
+        for (const auto &shape : lod.shapes)
+        {
+            assert(shape.baseVertex == mesh.shapes[&shape - lod.shapes.data()].baseVertex);
+            for (uint32_t i = shape.startIndex; i < shape.startIndex + shape.indexCount; ++i)
+                assert(lod.indices[i] < static_cast<uint32_t>(sphereVertices));
+        }
+        assert(lod.shapes[0].indexCount == lod.shapes[1].indexCount);
+    }
+    std::cout << "LOD chain passed (" << reports[0].triangles;
+    for (size_t i = 1; i < reports.size(); ++i)
+        std::cout << " -> " << reports[i].triangles;
+    std::cout << " triangles)." << std::endl;
+
+    // A mesh that cannot be reduced gets no levels
+    MeshData triangle;
+    triangle.vertices = {{{0, 0, 0}, {0, 1, 0}, {0, 0}}, {{0, 0, 1}, {0, 1, 0}, {0, 0}}, {{1, 0, 0}, {0, 1, 0}, {0, 0}}};
+    triangle.indices = {0, 1, 2};
+    reports = MeshSimplifier::BuildLodChain(triangle, ratios, errors, 3);
+    assert(reports.size() == 1 && triangle.lods.empty());
+    std::cout << "Irreducible mesh passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestFlatGrid();
+        TestHardEdges();
+        TestErrorBound();
+        TestLodChain();
+        std::cout << "All MeshSimplifier tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "GDTF/NativeModelLoader.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace GDTF;
+
+// Little-endian byte writer for building test files in memory
+struct Writer
+{
+    std::vector<uint8_t> bytes;
+
+    template <typename T> void Put(T value)
+    {
+        const auto *p = reinterpret_cast<const uint8_t *>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+    void PutString(const std::string &s)
+    {
+        bytes.insert(bytes.end(), s.begin(), s.end());
+        bytes.push_back(0);
+    }
+    void Append(const std::vector<uint8_t> &other)
+    {
+        bytes.insert(bytes.end(), other.begin(), other.end());
+    }
+};
+
+std::vector<uint8_t> MakeChunk(uint16_t id, const std::vector<uint8_t> &body)
+{
+    Writer w;
+    w.Put(id);
+    w.Put(static_cast<uint32_t>(body.size() + 6));
+    w.Append(body);
+    return w.bytes;
+}
+
+struct Face
+{
+    uint16_t a, b, c;
+    uint32_t group;
+};
+
+struct Object3DS
+{
+    std::string name;
+    std::vector<float> positions; // xyz triples
+    std::vector<float> uvs;       // uv pairs
+    std::vector<Face> faces;
+    std::vector<std::pair<std::string, std::vector<uint16_t>>> materialFaces;
+    std::vector<float> matrix = {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+};
+
+std::vector<uint8_t> Make3DS(const std::vector<Object3DS> &objects, const std::vector<std::string> &materials)
+{
+    Writer editor;
+    for (const auto &name : materials)
+    {
+        Writer n;
+        n.PutString(name);
+        editor.Append(MakeChunk(0xAFFF, MakeChunk(0xA000, n.bytes)));
+    }
+
+    for (const auto &object : objects)
+    {
+        Writer trimesh;
+        Writer vertices;
+        vertices.Put(static_cast<uint16_t>(object.positions.size() / 3));
+        for (float f : object.positions)
+            vertices.Put(f);
+        trimesh.Append(MakeChunk(0x4110, vertices.bytes));
+
+        if (!object.uvs.empty())
+        {
+            Writer uvs;
+            uvs.Put(static_cast<uint16_t>(object.uvs.size() / 2));
+            for (float f : object.uvs)
+                uvs.Put(f);
+            trimesh.Append(MakeChunk(0x4140, uvs.bytes));
+        }
+
+        Writer matrix;
+        for (float f : object.matrix)
+            matrix.Put(f);
+        trimesh.Append(MakeChunk(0x4160, matrix.bytes));
+
+        Writer faces;
+        faces.Put(static_cast<uint16_t>(object.faces.size()));
+        for (const auto &face : object.faces)
+        {
+            faces.Put(face.a);
+            faces.Put(face.b);
+            faces.Put(face.c);
+            faces.Put(static_cast<uint16_t>(7));
+        }
+        for (const auto &group : object.materialFaces)
+        {
+            Writer g;
+            g.PutString(group.first);
+            g.Put(static_cast<uint16_t>(group.second.size()));
+            for (uint16_t f : group.second)
+                g.Put(f);
+            faces.Append(MakeChunk(0x4130, g.bytes));
+        }
+        Writer smoothing;
+        for (const auto &face : object.faces)
+            smoothing.Put(face.group);
+        faces.Append(MakeChunk(0x4150, smoothing.bytes));
+        trimesh.Append(MakeChunk(0x4120, faces.bytes));
+
+        Writer obj;
+        obj.PutString(object.name);
+        obj.Append(MakeChunk(0x4100, trimesh.bytes));
+        editor.Append(MakeChunk(0x4000, obj.bytes));
+    }
+
+    Writer version;
+    version.Put(static_cast<uint32_t>(3));
+    Writer main;
+    main.Append(MakeChunk(0x0002, version.bytes));
+    main.Append(MakeChunk(0x3D3D, editor.bytes));
+    return MakeChunk(0x4D4D, main.bytes);
+}
+
+bool Near(float a, float b, float eps = 1e-5f)
+{
+    return std::fabs(a - b) <= eps;
+}
+
+bool NearVec(const DirectX::XMFLOAT3 &a, float x, float y, float z, float eps = 1e-5f)
+{
+    return Near(a.x, x, eps) && Near(a.y, y, eps) && Near(a.z, z, eps);
+}
+
+// Unit quad in the xy plane, counter-clockwise seen from +z
+Object3DS MakeQuad()
+{
+    Object3DS quad;
+    quad.name = "Quad";
+    quad.positions = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+    quad.uvs = {0, 0, 1, 0, 1, 1, 0, 1};
+    quad.faces = {{0, 1, 2, 1}, {0, 2, 3, 1}};
+    return quad;
+}
+
+void Test3DSConversion()
+{
+    std::cout << "Testing 3DS conversion..." << std::endl;
+
+    std::vector<uint8_t> file = Make3DS({MakeQuad()}, {});
+    MeshData data;
+    assert(NativeModelLoader::Load(file.data(), file.size(), "models/3ds/Quad.3DS", data));
+    assert(data.vertices.size() == 6 && data.indices.size() == 6);
+    assert(data.shapes.size() == 1 && data.shapes[0].name == "Quad" && data.shapes[0].indexCount == 6);
+
+    // Corners are written in face order; winding is reversed, z mirrored and v flipped
+    assert(data.indices[0] == 2 && data.indices[1] == 1 && data.indices[2] == 0);
+    assert(NearVec(data.vertices[1].position, 1, 0, 0));
+    assert(NearVec(data.vertices[2].position, 1, 1, -0.0f));
+    assert(Near(data.vertices[2].uv.x, 1.0f) && Near(data.vertices[2].uv.y, 0.0f));
+    assert(Near(data.vertices[0].uv.y, 1.0f));
+    for (const auto &v : data.vertices)
+        assert(NearVec(v.normal, 0, 0, -1));
+
+    std::cout << "3DS conversion passed." << std::endl;
+}
+
+void Test3DSSmoothingGroups()
+{
+    std::cout << "Testing 3DS smoothing groups..." << std::endl;
+
+    // Two faces folded 90 degrees along the x axis, each with its own vertices on the shared edge
+    Object3DS fold;
+    fold.name = "Fold";
+    fold.positions = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, -1};
+    fold.faces = {{0, 1, 2, 1}, {3, 4, 5, 1}};
+
+    MeshData smooth;
+    std::vector<uint8_t> file = Make3DS({fold}, {});
+    assert(NativeModelLoader::Load3DS(file.data(), file.size(), smooth));
+    const float h = std::sqrt(0.5f);
+    // Edge corners average the two face normals (+z and +y), mirrored to -z
+    assert(NearVec(smooth.vertices[0].normal, 0, h, -h));
+    assert(NearVec(smooth.vertices[4].normal, 0, h, -h));
+    // Corners away from the edge only see their own face
+    assert(NearVec(smooth.vertices[2].normal, 0, 0, -1));
+
+    fold.faces[1].group = 2;
+    MeshData flat;
+    file = Make3DS({fold}, {});
+    assert(NativeModelLoader::Load3DS(file.data(), file.size(), flat));
+    assert(NearVec(flat.vertices[0].normal, 0, 0, -1));
+    assert(NearVec(flat.vertices[3].normal, 0, 1, 0));
+
+    std::cout << "3DS smoothing groups passed." << std::endl;
+}
+
+void Test3DSMaterialsAndMatrix()
+{
+    std::cout << "Testing 3DS materials and mesh matrix..." << std::endl;
+
+    // Three faces: the second uses "Lens", the rest have no material
+    Object3DS strip;
+    strip.name = "Strip";
+    strip.positions = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 2, 0, 0};
+    strip.faces = {{0, 1, 2, 1}, {0, 2, 3, 1}, {1, 4, 2, 1}};
+    strip.materialFaces = {{"Lens", {1}}};
+
+    // Vertices are stored in world space; the mesh matrix translates by (10, 0, 0)
+    Object3DS moved = MakeQuad();
+    moved.name = "Moved";
+    for (size_t i = 0; i < moved.positions.size(); i += 3)
+        moved.positions[i] += 10.0f;
+    moved.matrix[9] = 10.0f;
+
+    std::vector<uint8_t> file = Make3DS({strip, moved}, {"Body", "Lens"});
+    MeshData data;
+    assert(NativeModelLoader::Load3DS(file.data(), file.size(), data));
+    assert(data.vertices.size() == 15);
+
+    // Material order first ("Lens"), then the default material, then the next object
+    assert(data.shapes.size() == 3);
+    assert(data.shapes[0].name == "Strip" && data.shapes[0].indexCount == 3 && data.shapes[0].startIndex == 0);
+    assert(data.shapes[1].name == "Strip" && data.shapes[1].indexCount == 6 && data.shapes[1].startIndex == 3);
+    assert(data.shapes[2].name == "Moved" && data.shapes[2].startIndex == 9);
+    assert(NearVec(data.vertices[0].position, 0, 0, 0) && NearVec(data.vertices[1].position, 1, 1, 0));
+    assert(NearVec(data.vertices[9].position, 0, 0, 0) && NearVec(data.vertices[10].position, 1, 0, 0));
+
+    std::cout << "3DS materials and mesh matrix passed." << std::endl;
+}
+
+void Test3DSRejects()
+{
+    std::cout << "Testing 3DS rejection..." << std::endl;
+
+    std::vector<uint8_t> file = Make3DS({MakeQuad()}, {});
+    MeshData data;
+
+    // Truncated chunk, wrong hint, no geometry, foreign data
+    std::vector<uint8_t> truncated(file.begin(), file.end() - 10);
+    assert(!NativeModelLoader::Load3DS(truncated.data(), truncated.size(), data));
+    assert(!NativeModelLoader::Load(file.data(), file.size(), "model.obj", data));
+    std::vector<uint8_t> empty = Make3DS({}, {"Body"});
+    assert(!NativeModelLoader::Load3DS(empty.data(), empty.size(), data));
+    const char text[] = "o Cube\nv 0 0 0\n";
+    assert(!NativeModelLoader::Load(reinterpret_cast<const uint8_t *>(text), sizeof(text), "cube.3ds", data));
+
+    std::cout << "3DS rejection passed." << std::endl;
+}
+
+// Builds a GLB with one primitive; optional attributes are left out when empty
+std::vector<uint8_t> MakeGLB(const std::vector<float> &positions, const std::vector<float> &normals,
+                             const std::vector<float> &uvs, const std::vector<uint16_t> &indices, int mode = 4)
+{
+    Writer bin;
+    std::string views;
+    std::string accessors;
+    std::string attributes;
+    int count = 0;
+    auto addView = [&](const void *data, size_t size, const std::string &accessor)
+    {
+        size_t offset = bin.bytes.size();
+        const auto *p = static_cast<const uint8_t *>(data);
+        bin.bytes.insert(bin.bytes.end(), p, p + size);
+        while (bin.bytes.size() % 4)
+            bin.bytes.push_back(0);
+        views += std::string(count ? "," : "") + "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) +
+                 ",\"byteLength\":" + std::to_string(size) + "}";
+        accessors += std::string(count ? "," : "") + "{\"bufferView\":" + std::to_string(count) + "," + accessor + "}";
+        return count++;
+    };
+
+    const std::string vertexCount = std::to_string(positions.size() / 3);
+    int position = addView(positions.data(), positions.size() * 4,
+                           "\"componentType\":5126,\"count\":" + vertexCount + ",\"type\":\"VEC3\"");
+    attributes = "\"POSITION\":" + std::to_string(position);
+    if (!normals.empty())
+    {
+        int normal = addView(normals.data(), normals.size() * 4,
+                             "\"componentType\":5126,\"count\":" + vertexCount + ",\"type\":\"VEC3\"");
+        attributes += ",\"NORMAL\":" + std::to_string(normal);
+    }
+    if (!uvs.empty())
+    {
+        int uv = addView(uvs.data(), uvs.size() * 4,
+                         "\"componentType\":5126,\"count\":" + vertexCount + ",\"type\":\"VEC2\"");
+        attributes += ",\"TEXCOORD_0\":" + std::to_string(uv);
+    }
+    std::string primitive = "{\"attributes\":{" + attributes + "},\"mode\":" + std::to_string(mode);
+    if (!indices.empty())
+    {
+        int index = addView(indices.data(), indices.size() * 2,
+                            "\"componentType\":5123,\"count\":" + std::to_string(indices.size()) +
+                                ",\"type\":\"SCALAR\"");
+        primitive += ",\"indices\":" + std::to_string(index);
+    }
+    primitive += "}";
+
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":" +
+                       std::to_string(bin.bytes.size()) + "}],\"bufferViews\":[" + views + "],\"accessors\":[" +
+                       accessors + "],\"meshes\":[{\"name\":\"Lens\",\"primitives\":[" + primitive + "]}]}";
+    while (json.size() % 4)
+        json += ' ';
+
+    Writer glb;
+    glb.Put(static_cast<uint32_t>(0x46546C67)); // "glTF"
+    glb.Put(static_cast<uint32_t>(2));
+    glb.Put(static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.bytes.size()));
+    glb.Put(static_cast<uint32_t>(json.size()));
+    glb.Put(static_cast<uint32_t>(0x4E4F534A)); // "JSON"
+    glb.bytes.insert(glb.bytes.end(), json.begin(), json.end());
+    glb.Put(static_cast<uint32_t>(bin.bytes.size()));
+    glb.Put(static_cast<uint32_t>(0x004E4942)); // "BIN"
+    glb.Append(bin.bytes);
+    return glb.bytes;
+}
+
+void TestGLB()
+{
+    std::cout << "Testing GLB loading..." << std::endl;
+
+    const std::vector<float> positions = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+    const std::vector<float> normals = {0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1};
+    const std::vector<float> uvs = {0, 1, 1, 1, 1, 0, 0, 0};
+    const std::vector<uint16_t> indices = {0, 1, 2, 0, 2, 3};
+
+    std::vector<uint8_t> file = MakeGLB(positions, normals, uvs, indices);
+    MeshData data;
+    assert(NativeModelLoader::Load(file.data(), file.size(), "models/gltf/lens.glb", data));
+    assert(data.vertices.size() == 4 && data.indices.size() == 6);
+    assert(data.shapes.size() == 1 && data.shapes[0].name == "Lens" && data.shapes[0].indexCount == 6);
+    assert(data.indices[0] == 2 && data.indices[1] == 1 && data.indices[2] == 0);
+    assert(NearVec(data.vertices[2].position, 1, 1, 0));
+    assert(NearVec(data.vertices[0].normal, 0, 0, -1));
+    // UVs are kept as stored: glTF and D3D share the top-left origin
+    assert(Near(data.vertices[0].uv.y, 1.0f) && Near(data.vertices[2].uv.y, 0.0f));
+
+    // Missing normals are generated; unindexed primitives get sequential indices
+    const std::vector<float> corners = {0, 0, 0, 1, 0, 0, 1, 1, 0};
+    file = MakeGLB(corners, {}, {}, {});
+    assert(NativeModelLoader::Load(file.data(), file.size(), "lens", data));
+    assert(data.indices.size() == 3 && data.indices[0] == 2 && data.indices[2] == 0);
+    assert(NearVec(data.vertices[1].normal, 0, 0, -1));
+    assert(data.vertices[1].uv.x == 0.0f);
+
+    // Strips, out-of-range indices and truncated files are left to the fallback
+    file = MakeGLB(positions, normals, uvs, indices, 5);
+    assert(!NativeModelLoader::LoadGLB(file.data(), file.size(), data));
+    file = MakeGLB(positions, normals, uvs, {0, 1, 4});
+    assert(!NativeModelLoader::LoadGLB(file.data(), file.size(), data));
+    file = MakeGLB(positions, normals, uvs, indices);
+    file.resize(file.size() - 16);
+    assert(!NativeModelLoader::LoadGLB(file.data(), file.size(), data));
+
+    std::cout << "GLB loading passed." << std::endl;
+}
+
+void TestScalePositions()
+{
+    std::cout << "Testing position scaling..." << std::endl;
+
+    std::vector<Vertex> vertices(5);
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const float f = static_cast<float>(i);
+        vertices[i].position = {f * 100.0f - 200.0f, 1000.0f + f, -f * 10.0f};
+        vertices[i].normal = {0.0f, 1.0f, 0.0f};
+    }
+
+    DirectX::XMFLOAT3 lo;
+    DirectX::XMFLOAT3 hi;
+    NativeModelLoader::ScalePositions(vertices.data(), vertices.size(), NativeModelLoader::MILLIMETERS_TO_METERS, lo,
+                                      hi);
+    assert(NearVec(lo, -0.2f, 1.0f, -0.04f) && NearVec(hi, 0.2f, 1.004f, 0.0f));
+    assert(NearVec(vertices[3].position, 0.1f, 1.003f, -0.03f));
+    // Only positions change
+    assert(vertices[3].normal.y == 1.0f);
+
+    NativeModelLoader::ScalePositions(vertices.data(), 0, 2.0f, lo, hi);
+    assert(lo.x == 0.0f && hi.x == 0.0f);
+
+    std::cout << "Position scaling passed." << std::endl;
+}
+
+int main()
+{
+    Test3DSConversion();
+    Test3DSSmoothingGroups();
+    Test3DSMaterialsAndMatrix();
+    Test3DSRejects();
+    TestGLB();
+    TestScalePositions();
+    std::cout << "All NativeModelLoader tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "Resources/ObjLoader.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static const char *TEST_MTL = "newmtl Red\n"
+                              "Ns 250.0\n"
+                              "Kd 0.8 0.1 0.1\n"
+                              "Ks 0.5 0.5 0.5\n"
+                              "newmtl Blue\n"
+                              "Ns 0\n"
+                              "Kd 0.1 0.1 0.9\n";
+
+// Two objects, a group switch, a material switch inside an object, a quad, a pentagon,
+// negative indices and comments/blank lines between statements.
+static const char *TEST_OBJ = "# test\n"
+                              "mtllib test_obj_loader.mtl\n"
+                              "o Empty\n"
+                              "o Anchor.001\n"
+                              "v 0 0 0\n"
+                              "v 1 0 0\n"
+                              "v 1 1 0\n"
+                              "v 0 1 0\n"
+                              "vt 0 0\n"
+                              "vt 1 0\n"
+                              "vt 1 1\n"
+                              "vt 0 1\n"
+                              "vn 0 0 1\n"
+                              "usemtl Red\n"
+                              "f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+                              "\n"
+                              "usemtl Blue\n"
+                              "f -4/-4/-1 -2/-2/-1 -1/-1/-1\n"
+                              "g Second\n"
+                              "v 0 -2 5\n"
+                              "v 2 -2 5\n"
+                              "v 2 2 5\n"
+                              "v 1 3 5\n"
+                              "v 0 2 5\n"
+                              "f 5//1 6//1 7//1 8//1 9//1\n"
+                              "o Third\n"
+                              "f 1 2 3\n";
+
+bool Near(float a, float b)
+{
+    return std::fabs(a - b) < 1e-5f;
+}
+
+void TestParse(size_t chunkBytes)
+{
+    MeshData data;
+    bool ok = ObjLoader::LoadFromMemory(TEST_OBJ, std::strlen(TEST_OBJ), "", data, chunkBytes);
+    assert(ok);
+
+    // Quad (2) + triangle (1) + pentagon (3) + triangle (1)
+    assert(data.vertices.size() == 7 * 3);
+    assert(data.indices.size() == data.vertices.size());
+    for (size_t i = 0; i < data.indices.size(); ++i)
+        assert(data.indices[i] == i);
+
+    // "Empty" has no faces and is dropped
+    assert(data.shapes.size() == 3);
+    assert(data.shapes[0].name == "Anchor.001");
+    assert(data.shapes[0].startIndex == 0 && data.shapes[0].indexCount == 9);
+    assert(data.shapes[1].name == "Second");
+    assert(data.shapes[1].startIndex == 9 && data.shapes[1].indexCount == 9);
+    assert(data.shapes[2].name == "Third");
+    assert(data.shapes[2].startIndex == 18 && data.shapes[2].indexCount == 3);
+
+    // Equal diagonals: the quad splits into (0, 1, 3) and (1, 2, 3), V flipped
+    assert(Near(data.vertices[2].position.x, 0.0f) && Near(data.vertices[2].position.y, 1.0f));
+    assert(Near(data.vertices[3].position.x, 1.0f) && Near(data.vertices[3].position.y, 0.0f));
+    assert(Near(data.vertices[4].position.x, 1.0f) && Near(data.vertices[4].position.y, 1.0f));
+    assert(Near(data.vertices[4].uv.x, 1.0f) && Near(data.vertices[4].uv.y, 0.0f));
+    assert(Near(data.vertices[2].uv.x, 0.0f) && Near(data.vertices[2].uv.y, 0.0f));
+    assert(Near(data.vertices[0].normal.z, 1.0f));
+
+    // Negative indices resolve against the vertices seen so far
+    assert(Near(data.vertices[6].position.x, 0.0f) && Near(data.vertices[6].position.y, 0.0f));
+    assert(Near(data.vertices[7].position.x, 1.0f) && Near(data.vertices[7].position.y, 1.0f));
+    assert(Near(data.vertices[8].position.y, 1.0f) && Near(data.vertices[8].position.x, 0.0f));
+
+    // Missing texcoords stay zero
+    assert(Near(data.vertices[9].uv.x, 0.0f) && Near(data.vertices[9].uv.y, 0.0f));
+
+    assert(Near(data.shapes[0].center.x, 0.5f) && Near(data.shapes[0].center.y, 0.5f));
+    assert(Near(data.shapes[1].center.y, 0.5f) && Near(data.shapes[1].center.z, 5.0f));
+    assert(Near(data.minY, -2.0f));
+}
+
+void TestMaterials()
+{
+    {
+        std::ofstream mtl("test_obj_loader.mtl");
+        mtl << TEST_MTL;
+        std::ofstream obj("test_obj_loader.obj");
+        obj << TEST_OBJ;
+    }
+
+    MeshData data;
+    bool ok = ObjLoader::Load("test_obj_loader.obj", data);
+    assert(ok);
+    assert(data.shapes.size() == 3);
+
+    // Shapes take the material of their first face
+    assert(Near(data.shapes[0].material.diffuse.x, 0.8f));
+    assert(Near(data.shapes[0].material.specular.y, 0.5f));
+    assert(Near(data.shapes[0].material.shininess, 250.0f));
+
+    // The material carries over into later shapes; Ns 0 falls back to 32
+    assert(Near(data.shapes[1].material.diffuse.z, 0.9f));
+    assert(Near(data.shapes[1].material.shininess, 32.0f));
+    assert(Near(data.shapes[2].material.diffuse.z, 0.9f));
+
+    std::remove("test_obj_loader.mtl");
+    std::remove("test_obj_loader.obj");
+
+    MeshData missing;
+    assert(!ObjLoader::Load("does_not_exist.obj", missing));
+}
+
+void TestChunkedMatchesSingle()
+{
+    // Many small objects so every chunk boundary lands inside a different statement
+    std::string text = "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+    for (int i = 0; i < 200; ++i)
+    {
+        text += "o Part" + std::to_string(i) + "\n";
+        text += "v " + std::to_string(i) + " 0 1\n";
+        text += "v " + std::to_string(i) + " 1 1\n";
+        text += "f 1 -1 -2\n";
+        text += "f 2 3 -1\n";
+    }
+
+    MeshData single;
+    MeshData chunked;
+    ObjLoader::LoadFromMemory(text.data(), text.size(), "", single, text.size() + 1);
+    ObjLoader::LoadFromMemory(text.data(), text.size(), "", chunked, 7);
+
+    assert(single.shapes.size() == 200);
+    assert(chunked.shapes.size() == single.shapes.size());
+    assert(chunked.vertices.size() == single.vertices.size());
+    for (size_t i = 0; i < single.vertices.size(); ++i)
+    {
+        assert(Near(chunked.vertices[i].position.x, single.vertices[i].position.x));
+        assert(Near(chunked.vertices[i].position.y, single.vertices[i].position.y));
+        assert(Near(chunked.vertices[i].position.z, single.vertices[i].position.z));
+    }
+    for (size_t s = 0; s < single.shapes.size(); ++s)
+    {
+        assert(chunked.shapes[s].name == single.shapes[s].name);
+        assert(chunked.shapes[s].startIndex == single.shapes[s].startIndex);
+        assert(chunked.shapes[s].indexCount == single.shapes[s].indexCount);
+    }
+    assert(Near(single.shapes[42].center.x, 21.0f));
+}
+
+int main()
+{
+    TestParse(ObjLoader::DEFAULT_CHUNK_BYTES);
+    TestParse(16);
+    std::cout << "Parse test passed." << std::endl;
+
+    TestMaterials();
+    std::cout << "Material test passed." << std::endl;
+
+    TestChunkedMatchesSingle();
+    std::cout << "Chunked parse test passed." << std::endl;
+
+    std::cout << "All ObjLoader tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,278 @@
+#include "Scene/OcclusionBuffer.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Scene/ClusterCuller.h"
+
+namespace
+{
+
+constexpr float ASPECT = 16.0f / 9.0f;
+constexpr float NEAR_Z = 0.1f;
+constexpr float FAR_Z = 100.0f;
+
+/**
+ * @brief Camera at the origin looking down +Z with a 90 degree vertical field of view.
+ */
+DirectX::XMMATRIX MakeViewProj()
+{
+    DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0, 0, 0, 1), DirectX::XMVectorSet(0, 0, 1, 1),
+                                                       DirectX::XMVectorSet(0, 1, 0, 0));
+    return view * DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, ASPECT, NEAR_Z, FAR_Z);
+}
+
+/**
+ * @brief Appends a quad facing the camera at depth z as two triangles sharing a diagonal.
+ *
+ * @param flip True to emit the triangles with the opposite winding.
+ */
+void AddWall(std::vector<DirectX::XMFLOAT3> &tris, float minX, float minY, float maxX, float maxY, float z, bool flip = false)
+{
+    const DirectX::XMFLOAT3 a = {minX, minY, z};
+    const DirectX::XMFLOAT3 b = {maxX, minY, z};
+    const DirectX::XMFLOAT3 c = {minX, maxY, z};
+    const DirectX::XMFLOAT3 d = {maxX, maxY, z};
+    const DirectX::XMFLOAT3 quad[6] = {a, c, b, b, c, d};
+    for (int i = 0; i < 6; ++i)
+        tris.push_back(quad[flip ? (i / 3 * 3) + (2 - (i % 3)) : i]);
+}
+
+/**
+ * @brief Clip z / w of a point straight ahead at view depth z.
+ */
+float ExpectedDepth(float z)
+{
+    return (FAR_Z / (FAR_Z - NEAR_Z)) * (1.0f - (NEAR_Z / z));
+}
+
+void Render(OcclusionBuffer &buffer, const std::vector<DirectX::XMFLOAT3> &tris)
+{
+    buffer.Begin(MakeViewProj());
+    buffer.AddOccluders(tris.data(), tris.size() / 3, DirectX::XMMatrixIdentity());
+    buffer.Finish();
+}
+
+} // namespace
+
+void TestOccludedBoxes()
+{
+    OcclusionBuffer buffer;
+    std::vector<DirectX::XMFLOAT3> wall;
+    AddWall(wall, -2.0f, -2.0f, 2.0f, 2.0f, 5.0f);
+    Render(buffer, wall);
+    assert(buffer.GetRasterizedCount() == 2);
+
+    const DirectX::XMMATRIX viewProj = MakeViewProj();
+    // Directly behind the wall
+    assert(!buffer.IsBoxVisible({-1, -1, 10}, {1, 1, 12}, viewProj));
+    assert(!buffer.IsSphereVisible({0, 0, 20, 1}, viewProj));
+    // In front of the wall
+    assert(buffer.IsBoxVisible({-1, -1, 3}, {1, 1, 4}, viewProj));
+    // Straddling the wall's silhouette (its edge projects to x = 0.4 in NDC)
+    assert(buffer.IsBoxVisible({3, -1, 10}, {5, 1, 12}, viewProj));
+    // Intersecting the wall
+    assert(buffer.IsBoxVisible({-1, -1, 4.5f}, {1, 1, 6}, viewProj));
+    // Crossing the near plane, and entirely outside the screen
+    assert(buffer.IsBoxVisible({-1, -1, -1}, {1, 1, 12}, viewProj));
+    assert(buffer.IsBoxVisible({-1, 200, 10}, {1, 202, 12}, viewProj));
+
+    // The same box moved by its world matrix
+    const DirectX::XMMATRIX world = DirectX::XMMatrixTranslation(0.0f, 0.0f, 8.0f);
+    assert(!buffer.IsBoxVisible({-1, -1, 2}, {1, 1, 4}, world * viewProj));
+    assert(buffer.IsBoxVisible({-1, -1, -5}, {1, 1, -4}, world * viewProj));
+    std::cout << "Occluded boxes passed." << std::endl;
+}
+
+void TestDepthAndCracks()
+{
+    // A wall larger than the view: every pixel center lies on one of its two triangles
+    OcclusionBuffer buffer;
+    for (bool flip : {false, true})
+    {
+        std::vector<DirectX::XMFLOAT3> wall;
+        AddWall(wall, -30.0f, -30.0f, 30.0f, 30.0f, 5.0f, flip);
+        Render(buffer, wall);
+        for (int y = 0; y < buffer.GetHeight(); ++y)
+            for (int x = 0; x < buffer.GetWidth(); ++x)
+                assert(std::fabs(buffer.GetDepth(x, y) - ExpectedDepth(5.0f)) < 1e-5f);
+    }
+
+    // A fan of thin triangles around the screen center leaves no gaps either
+    std::vector<DirectX::XMFLOAT3> fan;
+    const int slices = 97;
+    for (int i = 0; i < slices; ++i)
+    {
+        const float a0 = DirectX::XM_2PI * static_cast<float>(i) / slices;
+        const float a1 = DirectX::XM_2PI * static_cast<float>(i + 1) / slices;
+        fan.push_back({0.0f, 0.0f, 5.0f});
+        fan.push_back({40.0f * std::cos(a0), 40.0f * std::sin(a0), 5.0f});
+        fan.push_back({40.0f * std::cos(a1), 40.0f * std::sin(a1), 5.0f});
+    }
+    Render(buffer, fan);
+    for (int y = 0; y < buffer.GetHeight(); ++y)
+        for (int x = 0; x < buffer.GetWidth(); ++x)
+            assert(buffer.GetDepth(x, y) < 1.0f);
+
+    // A tilted quad: depth grows with distance and nearer occluders win
+    std::vector<DirectX::XMFLOAT3> tris;
+    tris.push_back({-30, -30, 4});
+    tris.push_back({-30, 30, 4});
+    tris.push_back({30, -30, 12});
+    AddWall(tris, -1.0f, -1.0f, 1.0f, 1.0f, 2.0f);
+    Render(buffer, tris);
+    const int cx = buffer.GetWidth() / 2;
+    const int cy = buffer.GetHeight() / 2;
+    assert(std::fabs(buffer.GetDepth(cx, cy) - ExpectedDepth(2.0f)) < 1e-5f);
+    assert(buffer.GetDepth(10, cy) < buffer.GetDepth(cx - 60, cy) && buffer.GetDepth(cx - 60, cy) < 1.0f);
+    std::cout << "Depth and cracks passed." << std::endl;
+}
+
+void TestNearPlane()
+{
+    // A triangle reaching behind the camera is skipped rather than clipped
+    OcclusionBuffer buffer;
+    std::vector<DirectX::XMFLOAT3> tris = {{-10, -10, -1}, {-10, 10, 5}, {10, 0, 5}};
+    Render(buffer, tris);
+    assert(buffer.GetOccluderCount() == 1 && buffer.GetRasterizedCount() == 0);
+    for (int y = 0; y < buffer.GetHeight(); ++y)
+        for (int x = 0; x < buffer.GetWidth(); ++x)
+            assert(buffer.GetDepth(x, y) == 1.0f);
+    assert(buffer.IsBoxVisible({-1, -1, 10}, {1, 1, 12}, MakeViewProj()));
+    std::cout << "Near plane passed." << std::endl;
+}
+
+void TestDeterminism()
+{
+    // Many overlapping triangles: the threaded result is identical run to run
+    std::vector<DirectX::XMFLOAT3> tris;
+    uint32_t seed = 12345;
+    auto next = [&seed]()
+    {
+        seed = (seed * 1664525u) + 1013904223u;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    };
+    for (int i = 0; i < 3000; ++i)
+    {
+        const float x = (next() * 20.0f) - 10.0f;
+        const float y = (next() * 12.0f) - 6.0f;
+        const float z = 3.0f + (next() * 20.0f);
+        tris.push_back({x, y, z});
+        tris.push_back({x + (next() * 3.0f), y + (next() * 3.0f), z + next()});
+        tris.push_back({x + (next() * 3.0f), y - (next() * 3.0f), z - next()});
+    }
+
+    OcclusionBuffer buffer;
+    Render(buffer, tris);
+    std::vector<float> first;
+    for (int y = 0; y < buffer.GetHeight(); ++y)
+        for (int x = 0; x < buffer.GetWidth(); ++x)
+            first.push_back(buffer.GetDepth(x, y));
+    for (int run = 0; run < 3; ++run)
+    {
+        Render(buffer, tris);
+        size_t i = 0;
+        for (int y = 0; y < buffer.GetHeight(); ++y)
+        {
+            for (int x = 0; x < buffer.GetWidth(); ++x)
+            {
+                const float depth = buffer.GetDepth(x, y);
+                assert(std::memcmp(&first[i++], &depth, sizeof(float)) == 0);
+            }
+        }
+    }
+    std::cout << "Determinism passed." << std::endl;
+}
+
+void TestSelectOccluders()
+{
+    // One large quad and a scatter of tiny triangles
+    MeshData data;
+    const DirectX::XMFLOAT3 corners[4] = {{0, 0, 0}, {10, 0, 0}, {0, 10, 0}, {10, 10, 0}};
+    for (int i = 0; i < 40; ++i)
+    {
+        const float x = static_cast<float>(i % 10);
+        const float y = static_cast<float>(i / 10);
+        data.vertices.push_back({{x, y, 1}, {0, 0, -1}, {0, 0}});
+        data.vertices.push_back({{x + 0.01f, y, 1}, {0, 0, -1}, {0, 0}});
+        data.vertices.push_back({{x, y + 0.01f, 1}, {0, 0, -1}, {0, 0}});
+        for (uint32_t k = 0; k < 3; ++k)
+            data.indices.push_back((i * 3) + k);
+    }
+    const uint32_t base = static_cast<uint32_t>(data.vertices.size());
+    for (const auto &c : corners)
+        data.vertices.push_back({c, {0, 0, -1}, {0, 0}});
+    for (uint32_t i : {0u, 2u, 1u, 1u, 2u, 3u})
+        data.indices.push_back(base + i);
+
+    IndexRange range;
+    range.indexCount = static_cast<uint32_t>(data.indices.size());
+    PackedMeshView view;
+    view.vertices = data.vertices.data();
+    view.vertexCount = data.vertices.size();
+    view.indexBytes = reinterpret_cast<const uint8_t *>(data.indices.data());
+    view.indexByteCount = data.indices.size() * sizeof(uint32_t);
+    view.ranges = &range;
+    view.rangeCount = 1;
+
+    // Tiny triangles fall under the area threshold
+    std::vector<DirectX::XMFLOAT3> picked = OcclusionBuffer::SelectOccluders(view);
+    assert(picked.size() == 6);
+    assert(picked[0].x == 0.0f && picked[0].y == 0.0f && picked[1].y == 10.0f && picked[5].x == 10.0f);
+
+    // The budget keeps the largest triangles
+    picked = OcclusionBuffer::SelectOccluders(view, 1);
+    assert(picked.size() == 3 && picked[1].y == 10.0f && picked[2].x == 10.0f);
+    std::cout << "Occluder selection passed." << std::endl;
+}
+
+void TestClusterOcclusion()
+{
+    OcclusionBuffer buffer;
+    std::vector<DirectX::XMFLOAT3> wall;
+    AddWall(wall, -4.0f, -4.0f, 4.0f, 4.0f, 5.0f);
+    Render(buffer, wall);
+
+    const DirectX::XMFLOAT3 eye = {0, 0, 0};
+    const ClusterCuller::Frustum frustum = ClusterCuller::MakeFrustum(DirectX::XMMatrixIdentity(), MakeViewProj(), eye);
+    std::vector<MeshCluster> clusters(3);
+    clusters[0].sphere = {0, 0, 20, 1};  // Behind the wall
+    clusters[1].sphere = {0, 0, 3, 1};   // In front of it
+    clusters[2].sphere = {30, 0, 20, 1}; // Beside it
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        clusters[i].cone = {0, 0, 0, 1};
+        clusters[i].startIndex = i * 3;
+        clusters[i].indexCount = 3;
+    }
+    assert(ClusterCuller::Classify(clusters[0], frustum, true, &buffer) == 3);
+    assert(ClusterCuller::Classify(clusters[0], frustum) == 0);
+    assert(ClusterCuller::Classify(clusters[1], frustum, true, &buffer) == 0);
+    assert(ClusterCuller::Classify(clusters[2], frustum, true, &buffer) == 0);
+
+    std::vector<ClusterRange> ranges;
+    const ClusterCuller::Stats stats = ClusterCuller::Cull(clusters, frustum, ranges, true, &buffer);
+    assert(stats.occlusionCulled == 1 && stats.visibleClusters == 2);
+    std::cout << "Cluster occlusion passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestOccludedBoxes();
+        TestDepthAndCracks();
+        TestNearPlane();
+        TestDeterminism();
+        TestSelectOccluders();
+        TestClusterOcclusion();
+        std::cout << "All OcclusionBuffer tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
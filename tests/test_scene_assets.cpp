@@ -0,0 +1,213 @@
+#include "Core/Config.h"
+#include "Resources/MeshAsset.h"
+#include "Scene/SceneAssets.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static const char *STAGE_FILE = "test_scene_assets_stage.obj";
+static const char *STAGE_CACHE = "test_scene_assets_stage.obj.meshcache";
+static const char *MISSING_GDTF = "test_scene_assets_missing.gdtf";
+
+// Two anchors hanging over a floor quad whose lowest point is y = -1
+static const char *STAGE_OBJ = "o Floor\n"
+                               "v -4 -1 -4\nv 4 -1 -4\nv 4 -1 4\nv -4 -1 4\n"
+                               "f 1 2 3\nf 1 3 4\n"
+                               "o Anchor.001\n"
+                               "v 1 5 0\nv 2 5 0\nv 1 6 0\n"
+                               "f 5 6 7\n"
+                               "o Anchor.002\n"
+                               "v -2 5 1\nv -1 5 1\nv -2 6 1\n"
+                               "f 8 9 10\n";
+
+static const char *TRUSS_OBJ = "o Floor\n"
+                               "v -4 0 -4\nv 4 0 -4\nv 4 0 4\n"
+                               "f 1 2 3\n"
+                               "o Cylinder.000\n"
+                               "v 0 8 0\nv 2 8 0\nv 0 10 0\n"
+                               "f 4 5 6\n";
+
+void WriteStage(const char *text)
+{
+    std::remove(STAGE_CACHE);
+    std::ofstream out(STAGE_FILE, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+MeshData MakeMesh()
+{
+    MeshData mesh;
+    for (int i = 0; i < 6; ++i)
+    {
+        Vertex v = {};
+        v.position = {static_cast<float>(i % 3), static_cast<float>(i / 3), static_cast<float>(i)};
+        v.normal = {0.0f, 1.0f, 0.0f};
+        mesh.vertices.push_back(v);
+    }
+    mesh.indices = {0, 1, 2, 1, 3, 2, 0, 1, 2};
+
+    ShapeInfo a;
+    a.name = "Yoke";
+    a.indexCount = 6;
+    ShapeInfo b;
+    b.name = "Head";
+    b.startIndex = 6;
+    b.indexCount = 3;
+    b.baseVertex = 3;
+    mesh.shapes = {a, b};
+    mesh.minY = 0.0f;
+
+    // One simplified level: a single triangle per shape
+    LodLevel lod;
+    lod.indices = {0, 1, 2, 0, 1, 2};
+    lod.shapes = mesh.shapes;
+    lod.shapes[0].indexCount = 3;
+    lod.shapes[1].startIndex = 3;
+    mesh.lods.push_back(lod);
+    return mesh;
+}
+
+void TestBuild()
+{
+    const MeshData mesh = MakeMesh();
+    MeshAsset asset;
+    asset.Build(mesh);
+
+    const PackedMeshView &view = asset.GetView();
+    assert(view.vertexCount == mesh.vertices.size());
+    assert(view.levelCount == 2 && view.rangeCount == 4);
+    assert(view.ranges[2].byteOffset % 4 == 0 && view.ranges[2].byteOffset > 0);
+    assert(asset.GetShapes().size() == 2 && asset.GetShapes()[1].name == "Head");
+    assert(asset.GetPositions().size() == mesh.vertices.size());
+    assert(!asset.GetClusters().empty());
+    assert(asset.GetUploadBytes() > mesh.vertices.size() * sizeof(Vertex));
+
+    // The view follows the arrays when the asset moves to another thread's owner
+    const Vertex *vertices = view.vertices;
+    MeshAsset moved = std::move(asset);
+    assert(moved.GetView().vertices == vertices && moved.GetView().rangeCount == 4);
+
+    // Opting in to the compact format halves the vertex upload and decodes back within the bounds' precision
+    const size_t fullBytes = moved.GetUploadBytes();
+    assert(moved.GetQuantizedVertices().empty());
+    moved.QuantizeVertices();
+    assert(moved.GetQuantizedVertices().size() == mesh.vertices.size());
+    assert(fullBytes - moved.GetUploadBytes() == mesh.vertices.size() * (sizeof(Vertex) / 2));
+    const VertexQuantizer::Bounds &bounds = moved.GetPositionBounds();
+    const Vertex decoded = VertexQuantizer::Decode(moved.GetQuantizedVertices()[1], bounds);
+    assert(std::fabs(decoded.position.x - mesh.vertices[1].position.x) <= VertexQuantizer::MaxPositionError(bounds));
+    std::cout << "Build test passed." << std::endl;
+}
+
+void TestLoadOBJ()
+{
+    WriteStage(STAGE_OBJ);
+
+    // First load parses and writes the cache, the second maps it
+    MeshAsset parsed;
+    assert(parsed.LoadOBJ(STAGE_FILE));
+    assert(std::ifstream(STAGE_CACHE).good());
+    MeshAsset cached;
+    assert(cached.LoadOBJ(STAGE_FILE));
+
+    assert(parsed.GetShapes().size() == 3 && cached.GetShapes().size() == 3);
+    assert(parsed.GetView().vertexCount == cached.GetView().vertexCount);
+    assert(parsed.GetView().indexByteCount == cached.GetView().indexByteCount);
+    assert(parsed.GetClusters().size() == cached.GetClusters().size());
+    assert(parsed.GetPositions().size() == cached.GetPositions().size());
+    assert(parsed.GetMinY() == -1.0f && cached.GetMinY() == -1.0f);
+
+    MeshAsset missing;
+    assert(!missing.LoadOBJ("test_scene_assets_missing.obj"));
+    std::cout << "LoadOBJ test passed." << std::endl;
+}
+
+void TestStage()
+{
+    // Anchors are lifted with the stage so its lowest point sits on the floor
+    WriteStage(STAGE_OBJ);
+    SceneAssets assets;
+    assert(assets.LoadStage(STAGE_FILE));
+    const float lift = Config::Room::FLOOR_Y + 1.0f;
+    assert(std::abs(assets.stageOffset - lift) < 1e-6f);
+    assert(assets.anchorPositions.size() == 2);
+    assert(std::abs(assets.anchorPositions[0].y - (5.5f + lift)) < 1e-4f);
+    assert(assets.fixturePos.x == assets.anchorPositions[0].x);
+
+    // Without anchors, one fixture hangs from the truss cylinder
+    WriteStage(TRUSS_OBJ);
+    SceneAssets truss;
+    assert(truss.LoadStage(STAGE_FILE));
+    assert(truss.anchorPositions.size() == 1);
+    assert(std::abs(truss.fixturePos.y - (9.0f + Config::Room::FLOOR_Y)) < 1e-4f);
+    std::cout << "Stage test passed." << std::endl;
+}
+
+void TestLoad()
+{
+    // A fixture that does not load leaves the stage and the Open gobo
+    WriteStage(STAGE_OBJ);
+    SceneAssets assets;
+    assert(assets.Load(STAGE_FILE, MISSING_GDTF));
+    assert(!assets.fixture.IsLoaded() && assets.fixture.GetMeshes().empty());
+    assert(assets.goboSlotNames.size() == 1 && assets.goboSlotNames[0] == "Open");
+    if (Config::Gobo::STREAMING)
+    {
+        assert(assets.goboStreamer && assets.goboSlotKeys.size() == 1);
+        assert(assets.goboUploads.size() == 1 && assets.goboUploads[0].layer == GoboStreamer::PLACEHOLDER_LAYER);
+    }
+    else
+    {
+        assert(assets.goboFixture == 0 && !assets.goboClasses.empty() && assets.goboClasses[0].layers == 1);
+    }
+    assert(assets.GetUploadBytes() > assets.stage.GetUploadBytes());
+
+    // Assets load off the main thread and hand over to it intact
+    SceneAssets background;
+    bool loaded = false;
+    std::thread([&]() { loaded = background.Load(STAGE_FILE, MISSING_GDTF); }).join();
+    assert(loaded && background.anchorPositions.size() == 2);
+    assert(background.GetUploadBytes() == assets.GetUploadBytes());
+
+    assert(!SceneAssets().Load("test_scene_assets_missing.obj", MISSING_GDTF));
+    std::cout << "Load test passed." << std::endl;
+}
+
+void TestBakeGoboClasses()
+{
+    GoboLibrary library;
+    library.AddFixture("Fixture", {GDTF::GDTFParser::CreateOpenGoboImage()});
+    std::vector<TextureBaker::BakedTexture> baked;
+    SceneAssets::BakeGoboClasses(library, {}, baked);
+    assert(baked.size() == 1 && baked[0].layers == 1);
+
+    // Classes already uploaded at their current revision are skipped
+    SceneAssets::BakeGoboClasses(library, {library.GetSizeClass(0).revision}, baked);
+    assert(baked.size() == 1 && baked[0].layers == 0);
+    std::cout << "BakeGoboClasses test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestBuild();
+        TestLoadOBJ();
+        TestStage();
+        TestLoad();
+        TestBakeGoboClasses();
+        std::remove(STAGE_FILE);
+        std::remove(STAGE_CACHE);
+        std::cout << "All SceneAssets tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
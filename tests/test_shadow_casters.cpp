@@ -0,0 +1,51 @@
+#include "Scene/ShadowCasters.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+void TestOwnFixtureSkipped()
+{
+    // Every fixture drives the light of the same index
+    std::vector<size_t> casters;
+    ShadowCasters::Select({0, 1, 2}, 3, 1, casters);
+    assert((casters == std::vector<size_t>{0, 2}));
+    std::cout << "Own fixture test passed." << std::endl;
+}
+
+void TestMappedLights()
+{
+    // Fixture 1 has no light, so fixture 2 drives light 1: the map decides, not the fixture index
+    const std::vector<int> fixtureLights = {0, -1, 1};
+    std::vector<size_t> casters;
+    ShadowCasters::Select(fixtureLights, 3, 1, casters);
+    assert((casters == std::vector<size_t>{0, 1}));
+    ShadowCasters::Select(fixtureLights, 3, 0, casters);
+    assert((casters == std::vector<size_t>{1, 2}));
+
+    // A light no fixture drives (a removed fixture's) has every fixture cast into it
+    ShadowCasters::Select(fixtureLights, 3, 2, casters);
+    assert((casters == std::vector<size_t>{0, 1, 2}));
+
+    // Fixtures past the map drive no light
+    ShadowCasters::Select({0}, 3, 0, casters);
+    assert((casters == std::vector<size_t>{1, 2}));
+    ShadowCasters::Select(fixtureLights, 0, 0, casters);
+    assert(casters.empty());
+    std::cout << "Mapped lights test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestOwnFixtureSkipped();
+        TestMappedLights();
+        std::cout << "All ShadowCasters tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,350 @@
+#include "Rendering/ShadowMinMax.h"
+#include "Rendering/VolumetricReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr int MAP_SIZE = 256;
+constexpr float RANGE = 30.0f;
+
+/**
+ * @brief Nearest hit of a ray with the rig and the floor.
+ *
+ * The comparison bias is large next to the spread of perspective depths far from the light,
+ * so only casters close to it (truss bars at y = 17, a plate at y = 16) shadow the beam.
+ */
+float CastStage(const DirectX::XMFLOAT3 &origin, const DirectX::XMFLOAT3 &dir)
+{
+    float nearest = 1e30f;
+    const auto plane = [&](float height, auto solid) {
+        if (std::fabs(dir.y) < 1e-6f)
+            return;
+        const float t = (height - origin.y) / dir.y;
+        const float x = origin.x + (dir.x * t);
+        const float z = origin.z + (dir.z * t);
+        if (t > 0.0f && t < nearest && solid(x, z))
+            nearest = t;
+    };
+    plane(17.0f, [](float x, float) { return std::fmod(std::fabs(x) + 0.5f, 3.0f) < 1.0f; });
+    plane(16.0f, [](float x, float z) { return std::fabs(x - 2.0f) < 1.5f && std::fabs(z + 2.0f) < 1.5f; });
+    plane(0.0f, [](float, float) { return true; });
+    return nearest;
+}
+
+/**
+ * @brief Renders the stage's depth from a light, as ShadowPass would.
+ */
+VolumetricReference::TextureArray RenderShadowMap(const SpotlightData &light)
+{
+    const DirectX::XMMATRIX viewProj = DirectX::XMMatrixTranspose(light.lightViewProj);
+    const DirectX::XMMATRIX inverse = DirectX::XMMatrixInverse(nullptr, viewProj);
+    VolumetricReference::TextureArray map;
+    map.width = MAP_SIZE;
+    map.height = MAP_SIZE;
+    map.layers = 1;
+    map.channels = 1;
+    map.texels.assign(static_cast<size_t>(MAP_SIZE) * MAP_SIZE, 1.0f);
+    for (int y = 0; y < MAP_SIZE; ++y)
+    {
+        for (int x = 0; x < MAP_SIZE; ++x)
+        {
+            const float ndcX = ((static_cast<float>(x) + 0.5f) / MAP_SIZE * 2.0f) - 1.0f;
+            const float ndcY = 1.0f - ((static_cast<float>(y) + 0.5f) / MAP_SIZE * 2.0f);
+            DirectX::XMFLOAT3 nearPoint;
+            DirectX::XMFLOAT3 farPoint;
+            const DirectX::XMVECTOR nearNdc = DirectX::XMVectorSet(ndcX, ndcY, 0.0f, 1.0f);
+            const DirectX::XMVECTOR farNdc = DirectX::XMVectorSet(ndcX, ndcY, 1.0f, 1.0f);
+            DirectX::XMStoreFloat3(&nearPoint, DirectX::XMVector3TransformCoord(nearNdc, inverse));
+            DirectX::XMStoreFloat3(&farPoint, DirectX::XMVector3TransformCoord(farNdc, inverse));
+            const DirectX::XMFLOAT3 dir = {farPoint.x - nearPoint.x, farPoint.y - nearPoint.y,
+                                           farPoint.z - nearPoint.z};
+            const float t = CastStage(nearPoint, dir);
+            if (t > 1.0f)
+                continue; // Beyond the far plane
+            DirectX::XMFLOAT3 hit = {nearPoint.x + (dir.x * t), nearPoint.y + (dir.y * t), nearPoint.z + (dir.z * t)};
+            DirectX::XMFLOAT3 clip;
+            DirectX::XMStoreFloat3(&clip,
+                                   DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(hit.x, hit.y, hit.z, 1.0f),
+                                                                    viewProj));
+            map.texels[(static_cast<size_t>(y) * MAP_SIZE) + x] = (std::min)(1.0f, clip.z);
+        }
+    }
+    return map;
+}
+
+/**
+ * @brief Shadow factor the shader computes at a point.
+ */
+float ShadowAt(const VolumetricReference::Inputs &inputs, const VolumetricReference::LightSetup &light,
+               const DirectX::XMFLOAT3 &p)
+{
+    const DirectX::XMFLOAT4X4 &m = light.lightViewProj;
+    const float clipX = (p.x * m._11) + (p.y * m._12) + (p.z * m._13) + m._14;
+    const float clipY = (p.x * m._21) + (p.y * m._22) + (p.z * m._23) + m._24;
+    const float clipZ = (p.x * m._31) + (p.y * m._32) + (p.z * m._33) + m._34;
+    const float clipW = (p.x * m._41) + (p.y * m._42) + (p.z * m._43) + m._44;
+    const bool inFront = clipW > 0.0f;
+    DirectX::XMFLOAT3 gobo;
+    return VolumetricReference::ShadowAndGobo(inputs, light, inFront ? clipX / clipW : 0.0f,
+                                              inFront ? clipY / clipW : 0.0f, inFront ? clipZ / clipW : 0.0f,
+                                              inFront, gobo);
+}
+
+DirectX::XMFLOAT3 Lerp(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b, float t)
+{
+    return {a.x + ((b.x - a.x) * t), a.y + ((b.y - a.y) * t), a.z + ((b.z - a.z) * t)};
+}
+
+/**
+ * @brief One light with its shadow map, mips and reference renderer inputs.
+ */
+struct Scene
+{
+    std::vector<SpotlightData> lights;
+    VolumetricReference::TextureArray shadowMap;
+    ShadowMinMax::MipChain chain;
+    VolumetricReference::Inputs inputs;
+    VolumetricReference::LightSetup setup;
+};
+
+Scene MakeScene(const DirectX::XMFLOAT3 &pos, const DirectX::XMFLOAT3 &target)
+{
+    Scene scene;
+    scene.lights = {TestLights::AimedAt(pos, target, RANGE)};
+    scene.shadowMap = RenderShadowMap(scene.lights[0]);
+    const bool built = ShadowMinMax::Build(scene.shadowMap.texels.data(), MAP_SIZE,
+                                           Config::Shadow::MINMAX_LEVELS, scene.chain);
+    assert(built);
+    (void)built;
+    scene.inputs.lights = scene.lights.data();
+    scene.inputs.lightCount = 1;
+    scene.inputs.shadowMaps = &scene.shadowMap;
+    scene.setup = VolumetricReference::SetupLights(scene.inputs)[0];
+    return scene;
+}
+
+} // namespace
+
+void TestBuild()
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> depth(64 * 64);
+    for (float &d : depth)
+        d = uniform(rng);
+
+    ShadowMinMax::MipChain chain;
+    assert(ShadowMinMax::Build(depth.data(), 64, 10, chain));
+    assert(chain.levels.size() == 6); // 32 down to 1
+    for (size_t level = 0; level < chain.levels.size(); ++level)
+    {
+        const int size = chain.sizes[level];
+        const int block = 64 / size;
+        assert(block == (2 << level));
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                float lo = 2.0f;
+                float hi = -1.0f;
+                for (int j = 0; j < block; ++j)
+                {
+                    for (int i = 0; i < block; ++i)
+                    {
+                        lo = (std::min)(lo, depth[((y * block + j) * 64) + (x * block) + i]);
+                        hi = (std::max)(hi, depth[((y * block + j) * 64) + (x * block) + i]);
+                    }
+                }
+                const DirectX::XMFLOAT2 &texel = chain.levels[level][(static_cast<size_t>(y) * size) + x];
+                assert(texel.x == lo && texel.y == hi);
+            }
+        }
+    }
+
+    // Sizes that are not a power of two are rejected
+    assert(!ShadowMinMax::Build(depth.data(), 48, 4, chain));
+    assert(chain.levels.empty());
+    assert(ShadowMinMax::Classify(chain, {}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}) ==
+           ShadowMinMax::Visibility::Mixed);
+
+    std::cout << "Build test passed." << std::endl;
+}
+
+void TestClassify()
+{
+    const Scene scenes[2] = {MakeScene({0.0f, 20.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                             MakeScene({-6.0f, 20.0f, -3.0f}, {4.0f, 0.0f, 3.0f})};
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    int counts[3] = {0, 0, 0};
+    for (const Scene &scene : scenes)
+    {
+        const VolumetricReference::LightSetup &light = scene.setup;
+        const DirectX::XMFLOAT3 side = {0.0f, 0.0f, 1.0f};
+        const DirectX::XMFLOAT3 u = {(light.dir.y * side.z) - (light.dir.z * side.y),
+                                     (light.dir.z * side.x) - (light.dir.x * side.z),
+                                     (light.dir.x * side.y) - (light.dir.y * side.x)};
+        const float uLength = std::sqrt((u.x * u.x) + (u.y * u.y) + (u.z * u.z));
+        const DirectX::XMFLOAT3 uAxis = {u.x / uLength, u.y / uLength, u.z / uLength};
+        const DirectX::XMFLOAT3 vAxis = {(light.dir.y * uAxis.z) - (light.dir.z * uAxis.y),
+                                         (light.dir.z * uAxis.x) - (light.dir.x * uAxis.z),
+                                         (light.dir.x * uAxis.y) - (light.dir.y * uAxis.x)};
+        const float tanField = std::sqrt(1.0f - (light.field * light.field)) / light.field;
+
+        for (int i = 0; i < 4000; ++i)
+        {
+            // A point of the beam, and a segment from it in any direction
+            const float along = 0.5f + (24.0f * uniform(rng));
+            const float angle = 6.2831853f * uniform(rng);
+            const float radius = along * tanField * std::sqrt(uniform(rng));
+            const DirectX::XMFLOAT3 a = {
+                light.pos.x + (light.dir.x * along) + (uAxis.x * std::cos(angle) * radius) +
+                    (vAxis.x * std::sin(angle) * radius),
+                light.pos.y + (light.dir.y * along) + (uAxis.y * std::cos(angle) * radius) +
+                    (vAxis.y * std::sin(angle) * radius),
+                light.pos.z + (light.dir.z * along) + (uAxis.z * std::cos(angle) * radius) +
+                    (vAxis.z * std::sin(angle) * radius)};
+            const float length = (i % 4 == 0) ? 15.0f * uniform(rng) : 2.0f * uniform(rng);
+            const float theta = std::acos((2.0f * uniform(rng)) - 1.0f);
+            const float phi = 6.2831853f * uniform(rng);
+            const DirectX::XMFLOAT3 b = {a.x + (length * std::sin(theta) * std::cos(phi)),
+                                         a.y + (length * std::cos(theta)),
+                                         a.z + (length * std::sin(theta) * std::sin(phi))};
+
+            const ShadowMinMax::Visibility visibility =
+                ShadowMinMax::Classify(scene.chain, light.lightViewProj, a, b);
+            ++counts[static_cast<int>(visibility)];
+            if (visibility == ShadowMinMax::Visibility::Mixed)
+                continue;
+
+            // Brute force: the claim holds at every point of the segment
+            for (int s = 0; s <= 256; ++s)
+            {
+                const float shadow = ShadowAt(scene.inputs, light, Lerp(a, b, static_cast<float>(s) / 256.0f));
+                if (visibility == ShadowMinMax::Visibility::Lit)
+                    assert(shadow >= 1.0f - 1e-5f);
+                else
+                    assert(shadow == 0.0f);
+            }
+        }
+    }
+    const int total = counts[0] + counts[1] + counts[2];
+    assert(counts[0] > total / 10 && counts[1] > total / 100);
+
+    std::cout << "Classify test passed (" << counts[0] << " lit, " << counts[1] << " shadowed, " << counts[2]
+              << " mixed)." << std::endl;
+}
+
+void TestShadowFetches()
+{
+    const Scene scene = MakeScene({0.0f, 20.0f, 0.0f}, {0.0f, 0.0f, 0.0f});
+    const VolumetricReference::LightSetup &light = scene.setup;
+
+    // March a grid of camera rays as the shader does, with and without the interval classification
+    constexpr int RAYS_X = 96;
+    constexpr int RAYS_Y = 54;
+    constexpr int STEPS = 64;
+    constexpr int INTERVALS = Config::Volumetric::SHADOW_INTERVALS;
+    const DirectX::XMFLOAT3 camera = {0.0f, 8.0f, -28.0f};
+    size_t bruteFetches = 0;
+    size_t fetches = 0;
+    double bruteSum = 0.0;
+    double sum = 0.0;
+    for (int ry = 0; ry < RAYS_Y; ++ry)
+    {
+        for (int rx = 0; rx < RAYS_X; ++rx)
+        {
+            DirectX::XMFLOAT3 dir = {((static_cast<float>(rx) + 0.5f) / RAYS_X - 0.5f) * 1.6f,
+                                     (0.5f - (static_cast<float>(ry) + 0.5f) / RAYS_Y) * 0.9f, 1.0f};
+            dir.y -= 0.2f;
+            const float length = std::sqrt((dir.x * dir.x) + (dir.y * dir.y) + (dir.z * dir.z));
+            dir = {dir.x / length, dir.y / length, dir.z / length};
+            const float rayLength = dir.y < 0.0f ? -camera.y / dir.y : 100.0f; // The floor ends the ray
+
+            const DirectX::XMFLOAT2 cone =
+                VolumetricReference::RayConeIntersect(camera, dir, light.pos, light.dir, light.field, light.range);
+            if (cone.x < 0.0f)
+                continue;
+            const float tEnter = (std::max)(0.0f, cone.x);
+            const float tExit = (std::min)(rayLength, (std::min)(cone.y, light.range));
+            if (tEnter >= tExit)
+                continue;
+
+            const float noise = std::fmod(static_cast<float>((rx * 7) + (ry * 13)) * 0.618034f, 1.0f);
+            int interval = -1;
+            ShadowMinMax::Visibility visibility = ShadowMinMax::Visibility::Mixed;
+            for (int s = 0; s < STEPS; ++s)
+            {
+                const float tNormalized = (static_cast<float>(s) + noise) / STEPS;
+                const float tQuad = 1.0f - ((1.0f - tNormalized) * (1.0f - tNormalized));
+                const DirectX::XMFLOAT3 p = Lerp(camera, {camera.x + dir.x, camera.y + dir.y, camera.z + dir.z},
+                                                 tEnter + (tQuad * (tExit - tEnter)));
+                const DirectX::XMFLOAT3 toLight = {light.pos.x - p.x, light.pos.y - p.y, light.pos.z - p.z};
+                const float dist = std::sqrt((toLight.x * toLight.x) + (toLight.y * toLight.y) +
+                                             (toLight.z * toLight.z));
+                const float cosAngle =
+                    -((toLight.x * light.dir.x) + (toLight.y * light.dir.y) + (toLight.z * light.dir.z)) / dist;
+                if (dist >= light.range || cosAngle <= light.field)
+                    continue;
+
+                const float shadow = ShadowAt(scene.inputs, light, p);
+                ++bruteFetches;
+                bruteSum += shadow;
+
+                // Interval k covers t_normalized in [k / INTERVALS, (k + 1) / INTERVALS)
+                const int k = (std::min)(static_cast<int>(tNormalized * INTERVALS), INTERVALS - 1);
+                if (k != interval)
+                {
+                    interval = k;
+                    const auto quad = [](float x) { return 1.0f - ((1.0f - x) * (1.0f - x)); };
+                    const float ta = tEnter + (quad(static_cast<float>(k) / INTERVALS) * (tExit - tEnter));
+                    const float tb = tEnter + (quad(static_cast<float>(k + 1) / INTERVALS) * (tExit - tEnter));
+                    const DirectX::XMFLOAT3 end = {camera.x + dir.x, camera.y + dir.y, camera.z + dir.z};
+                    visibility = ShadowMinMax::Classify(scene.chain, light.lightViewProj, Lerp(camera, end, ta),
+                                                        Lerp(camera, end, tb));
+                }
+                if (visibility == ShadowMinMax::Visibility::Lit)
+                {
+                    sum += 1.0;
+                }
+                else if (visibility == ShadowMinMax::Visibility::Mixed)
+                {
+                    ++fetches;
+                    sum += shadow;
+                }
+            }
+        }
+    }
+    assert(bruteFetches > 10000);
+    assert(std::fabs(sum - bruteSum) <= 1e-4 * bruteSum);
+    const double reduction = 1.0 - (static_cast<double>(fetches) / static_cast<double>(bruteFetches));
+    assert(reduction > 0.5);
+
+    std::cout << "Shadow fetch test passed (" << fetches << " of " << bruteFetches << " fetches, "
+              << reduction * 100.0 << "% fewer)." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestBuild();
+        TestClassify();
+        TestShadowFetches();
+        std::cout << "All ShadowMinMax tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
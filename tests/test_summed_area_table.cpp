@@ -0,0 +1,168 @@
+#include "Resources/SummedAreaTable.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using SummedAreaTable::CHANNELS;
+
+std::vector<uint8_t> RandomImage(int width, int height, int layers, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> value(0, 255);
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * layers * CHANNELS);
+    for (uint8_t &c : rgba)
+        c = static_cast<uint8_t>(value(rng));
+    return rgba;
+}
+
+uint64_t BruteSum(const std::vector<uint8_t> &rgba, int width, int height, int layer, int x0, int y0, int x1, int y1,
+                  int channel)
+{
+    uint64_t sum = 0;
+    for (int y = (std::max)(y0, 0); y < (std::min)(y1, height); ++y)
+        for (int x = (std::max)(x0, 0); x < (std::min)(x1, width); ++x)
+            sum += rgba[((((static_cast<size_t>(layer) * height) + y) * width) + x) * CHANNELS + channel];
+    return sum;
+}
+
+void TestBoxSums()
+{
+    // Odd sizes, so the column bands and the last band's width are exercised
+    constexpr int WIDTH = 157;
+    constexpr int HEIGHT = 93;
+    constexpr int LAYERS = 3;
+    const std::vector<uint8_t> rgba = RandomImage(WIDTH, HEIGHT, LAYERS, 3);
+    SummedAreaTable::Table table;
+    assert(SummedAreaTable::Build(rgba.data(), WIDTH, HEIGHT, LAYERS, table));
+    assert(table.sums.size() == static_cast<size_t>(WIDTH + 1) * (HEIGHT + 1) * LAYERS * CHANNELS);
+
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> xs(-5, WIDTH + 5);
+    std::uniform_int_distribution<int> ys(-5, HEIGHT + 5);
+    for (int trial = 0; trial < 3000; ++trial)
+    {
+        const int layer = trial % LAYERS;
+        int x0 = xs(rng);
+        int x1 = xs(rng);
+        int y0 = ys(rng);
+        int y1 = ys(rng);
+        if (x1 < x0)
+            std::swap(x0, x1);
+        if (y1 < y0)
+            std::swap(y0, y1);
+        uint32_t sum[CHANNELS];
+        SummedAreaTable::BoxSum(table, layer, x0, y0, x1, y1, sum);
+        for (int c = 0; c < CHANNELS; ++c)
+            assert(sum[c] == BruteSum(rgba, WIDTH, HEIGHT, layer, x0, y0, x1, y1, c));
+    }
+    std::cout << "Box sums test passed." << std::endl;
+}
+
+void TestPrecision()
+{
+    // A white 512 x 512 slice sums past 2^24, where float entries would stop being exact
+    constexpr int SIZE = 512;
+    constexpr int LAYERS = 4;
+    std::vector<uint8_t> rgba(static_cast<size_t>(SIZE) * SIZE * LAYERS * CHANNELS, 255);
+    std::vector<uint8_t> random = RandomImage(SIZE, SIZE, 1, 21);
+    std::copy(random.begin(), random.end(), rgba.begin() + (static_cast<size_t>(SIZE) * SIZE * 3 * CHANNELS));
+    SummedAreaTable::Table table;
+    assert(SummedAreaTable::Build(rgba.data(), SIZE, SIZE, LAYERS, table));
+
+    uint32_t sum[CHANNELS];
+    SummedAreaTable::BoxSum(table, 0, 0, 0, SIZE, SIZE, sum);
+    assert(sum[0] == 512u * 512u * 255u && sum[0] > (1u << 24));
+
+    // Single texels at the far corner come back exact from the integer entries, and averages are
+    // exact in [0, 1]; the same differences in float lose whole units
+    float worstFloat = 0.0f;
+    for (int y = SIZE - 8; y < SIZE; ++y)
+    {
+        for (int x = SIZE - 8; x < SIZE; ++x)
+        {
+            SummedAreaTable::BoxSum(table, 0, x, y, x + 1, y + 1, sum);
+            assert(sum[0] == 255u && sum[3] == 255u);
+            SummedAreaTable::BoxSum(table, 3, x, y, x + 1, y + 1, sum);
+            for (int c = 0; c < CHANNELS; ++c)
+                assert(sum[c] == BruteSum(random, SIZE, SIZE, 0, x, y, x + 1, y + 1, c));
+
+            float average[CHANNELS];
+            SummedAreaTable::FootprintAverage(table, 0, (x + 0.5f) / SIZE, (y + 0.5f) / SIZE, 0.5f, 0.5f, average);
+            assert(average[0] == 1.0f);
+
+            const float s11 = static_cast<float>(table.sums[table.Index(3, x + 1, y + 1)]);
+            const float s10 = static_cast<float>(table.sums[table.Index(3, x + 1, y)]);
+            const float s01 = static_cast<float>(table.sums[table.Index(3, x, y + 1)]);
+            const float s00 = static_cast<float>(table.sums[table.Index(3, x, y)]);
+            const float texel = static_cast<float>(BruteSum(random, SIZE, SIZE, 0, x, y, x + 1, y + 1, 0));
+            worstFloat = (std::max)(worstFloat, std::fabs((s11 - s10 - s01 + s00) - texel));
+        }
+    }
+    std::cout << "  float entries would be off by up to " << worstFloat << " of 255" << std::endl;
+
+    assert(!SummedAreaTable::Build(rgba.data(), 0, SIZE, 1, table));
+    assert(!SummedAreaTable::Build(nullptr, SIZE, SIZE, 1, table));
+    assert(!SummedAreaTable::Build(rgba.data(), 65536, 65536, 1, table));
+    std::cout << "Precision test passed." << std::endl;
+}
+
+void TestFootprint()
+{
+    constexpr int SIZE = 64;
+    const std::vector<uint8_t> rgba = RandomImage(SIZE, SIZE, 1, 5);
+    SummedAreaTable::Table table;
+    assert(SummedAreaTable::Build(rgba.data(), SIZE, SIZE, 1, table));
+
+    // A footprint inside the image averages the texels its rounded corners enclose
+    float average[CHANNELS];
+    SummedAreaTable::FootprintAverage(table, 0, 20.3f / SIZE, 30.8f / SIZE, 4.1f, 2.6f, average);
+    const int x0 = 16;
+    const int x1 = 24;
+    const int y0 = 28;
+    const int y1 = 33;
+    for (int c = 0; c < CHANNELS; ++c)
+    {
+        const float expected = static_cast<float>(BruteSum(rgba, SIZE, SIZE, 0, x0, y0, x1, y1, c)) /
+                               (255.0f * static_cast<float>((x1 - x0) * (y1 - y0)));
+        assert(std::fabs(average[c] - expected) < 1e-6f);
+    }
+
+    // Tiny footprints still cover the texel under the center
+    SummedAreaTable::FootprintAverage(table, 0, 10.5f / SIZE, 12.5f / SIZE, 0.1f, 0.1f, average);
+    assert(std::fabs(average[1] - (rgba[((12 * SIZE) + 10) * CHANNELS + 1] / 255.0f)) < 1e-6f);
+
+    // Half outside: the border is black, so a white image averages to the inside fraction
+    std::vector<uint8_t> white(static_cast<size_t>(SIZE) * SIZE * CHANNELS, 255);
+    assert(SummedAreaTable::Build(white.data(), SIZE, SIZE, 1, table));
+    SummedAreaTable::FootprintAverage(table, 0, 0.0f, 0.5f, 8.0f, 8.0f, average);
+    assert(std::fabs(average[0] - 0.5f) < 1e-6f);
+    SummedAreaTable::FootprintAverage(table, 0, 1.0f, 1.0f, 8.0f, 8.0f, average);
+    assert(std::fabs(average[0] - 0.25f) < 1e-6f);
+    std::cout << "Footprint test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestBoxSums();
+        TestPrecision();
+        TestFootprint();
+        std::cout << "All SummedAreaTable tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
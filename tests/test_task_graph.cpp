@@ -0,0 +1,213 @@
+#include "Core/TaskGraph.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using State = TaskGraph::State;
+
+constexpr auto SLEEP = std::chrono::milliseconds(60);
+
+void TestDependencies()
+{
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const char *name)
+    {
+        return [&, name]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+            return true;
+        };
+    };
+    const TaskGraph::TaskId a = graph.Add("a", record("a"));
+    const TaskGraph::TaskId b = graph.Add("b", record("b"), {a});
+    const TaskGraph::TaskId c = graph.Add("c", record("c"), {a});
+    const TaskGraph::TaskId d = graph.Add("d", record("d"), {b, c, b});
+    assert(graph.Run(pool));
+
+    assert(order.size() == 4 && order.front() == "a" && order.back() == "d");
+    for (TaskGraph::TaskId id : {a, b, c, d})
+        assert(graph.GetState(id) == State::Succeeded);
+    const std::vector<TaskGraph::Timing> timeline = graph.GetTimeline();
+    assert(timeline[3].startMs >= timeline[1].endMs && timeline[3].startMs >= timeline[2].endMs);
+    assert(graph.GetTotalMs() >= timeline[3].endMs);
+    std::cout << "Dependencies test passed." << std::endl;
+}
+
+void TestOverlap()
+{
+    // Independent tasks run side by side: three sleeps take about one
+    ThreadPool pool(3);
+    TaskGraph graph;
+    for (int i = 0; i < 3; ++i)
+    {
+        graph.Add("sleep " + std::to_string(i), []() {
+            std::this_thread::sleep_for(SLEEP);
+            return true;
+        });
+    }
+    assert(graph.Run(pool));
+    const double sleepMs = std::chrono::duration<double, std::milli>(SLEEP).count();
+    assert(graph.GetTotalMs() < sleepMs * 2.5);
+    std::cout << "Overlap test passed." << std::endl;
+}
+
+void TestCallerAffinity()
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id workerRan;
+    std::thread::id callerRan;
+    const TaskGraph::TaskId load = graph.Add("load", [&]() {
+        workerRan = std::this_thread::get_id();
+        return true;
+    });
+    graph.Add("window", [&]() {
+        callerRan = std::this_thread::get_id();
+        return true;
+    }, {load}, TaskGraph::Affinity::Caller);
+    assert(graph.Run(pool));
+    assert(callerRan == caller && workerRan != caller);
+    assert(graph.GetTimeline()[1].onCaller && !graph.GetTimeline()[0].onCaller);
+    std::cout << "CallerAffinity test passed." << std::endl;
+}
+
+void TestFailure()
+{
+    // A failed task skips what depends on it, directly or not; the rest still runs
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> ran{0};
+    auto count = [&ran]()
+    {
+        ++ran;
+        return true;
+    };
+    const TaskGraph::TaskId failing = graph.Add("failing", []() { return false; });
+    const TaskGraph::TaskId throwing = graph.Add("throwing", []() -> bool { throw std::runtime_error("boom"); });
+    const TaskGraph::TaskId skipped = graph.Add("skipped", count, {failing});
+    const TaskGraph::TaskId transitive = graph.Add("transitive", count, {skipped}, TaskGraph::Affinity::Caller);
+    const TaskGraph::TaskId independent = graph.Add("independent", count);
+    assert(!graph.Run(pool));
+
+    assert(graph.GetState(failing) == State::Failed && graph.GetState(throwing) == State::Failed);
+    assert(graph.GetState(skipped) == State::Skipped && graph.GetState(transitive) == State::Skipped);
+    assert(graph.GetState(independent) == State::Succeeded && ran == 1);
+    std::cout << "Failure test passed." << std::endl;
+}
+
+void TestSpawn()
+{
+    // Children found while running hold back the parent's dependents until they are done
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::atomic<int> children{0};
+    int seen = -1;
+    const TaskGraph::TaskId parent = graph.Add("parent", [&]() {
+        for (int i = 0; i < 6; ++i)
+        {
+            graph.Spawn("child " + std::to_string(i), [&children]() {
+                std::this_thread::sleep_for(SLEEP / 6);
+                ++children;
+                return true;
+            });
+        }
+        return true;
+    });
+    graph.Add("after", [&]() {
+        seen = children;
+        return true;
+    }, {parent});
+    assert(graph.Run(pool));
+    assert(seen == 6);
+    const std::vector<TaskGraph::Timing> timeline = graph.GetTimeline();
+    assert(timeline.size() == 8 && timeline[2].depth == 1 && timeline[2].name == "child 0");
+
+    // A failing child fails its parent, and the parent's dependents are skipped
+    TaskGraph failing;
+    const TaskGraph::TaskId spawner = failing.Add("spawner", [&failing]() {
+        failing.Spawn("bad child", []() { return false; });
+        return true;
+    });
+    const TaskGraph::TaskId dependent = failing.Add("dependent", []() { return true; }, {spawner});
+    assert(!failing.Run(pool));
+    assert(failing.GetState(spawner) == State::Failed && failing.GetState(dependent) == State::Skipped);
+    std::cout << "Spawn test passed." << std::endl;
+}
+
+void TestNestedParallelFor()
+{
+    // Tasks may use the pool themselves without starving the graph, even with one worker
+    ThreadPool pool(1);
+    TaskGraph graph;
+    std::atomic<int> sum{0};
+    for (int t = 0; t < 3; ++t)
+    {
+        graph.Add("parallel " + std::to_string(t), [&]() {
+            pool.ParallelFor(100, [&sum](size_t i) { sum += static_cast<int>(i); });
+            return true;
+        });
+    }
+    assert(graph.Run(pool));
+    assert(sum == 3 * 4950);
+    std::cout << "NestedParallelFor test passed." << std::endl;
+}
+
+void TestTimeline()
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    const TaskGraph::TaskId device = graph.Add("device", []() { return true; }, {}, TaskGraph::Affinity::Caller);
+    const TaskGraph::TaskId shaders = graph.Add("shaders", []() { return false; }, {device});
+    graph.Add("upload", []() { return true; }, {shaders});
+
+    std::ostringstream out;
+    assert(!graph.Run(pool));
+    graph.WriteTimeline(out);
+    const std::string text = out.str();
+    assert(text.find("device") != std::string::npos && text.find("caller") != std::string::npos);
+    assert(text.find("shaders") != std::string::npos && text.find("FAILED") != std::string::npos);
+    assert(text.find("skipped") != std::string::npos && text.find("Total") != std::string::npos);
+
+    // An empty graph has nothing to wait for
+    TaskGraph empty;
+    assert(empty.Run(pool) && empty.GetTimeline().empty());
+    std::cout << "Timeline test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestDependencies();
+        TestOverlap();
+        TestCallerAffinity();
+        TestFailure();
+        TestSpawn();
+        TestNestedParallelFor();
+        TestTimeline();
+        std::cout << "All TaskGraph tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "Rendering/TemporalReprojection.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "Rendering/VolumetricReference.h"
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr int WIDTH = 48;
+constexpr int HEIGHT = 27;
+
+/**
+ * @brief Camera at a position looking at a target, with the test's aspect ratio.
+ */
+TemporalReprojection::View MakeView(const DirectX::XMFLOAT3 &eye, const DirectX::XMFLOAT3 &target)
+{
+    TemporalReprojection::View view;
+    view.width = WIDTH;
+    view.height = HEIGHT;
+    view.cameraPos = eye;
+    const DirectX::XMMATRIX viewMatrix =
+        DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                  DirectX::XMVectorSet(target.x, target.y, target.z, 1.0f),
+                                  DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        1.0f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 100.0f);
+    DirectX::XMStoreFloat4x4(&view.viewProj, viewMatrix * proj);
+    DirectX::XMStoreFloat4x4(&view.invViewProj, DirectX::XMMatrixInverse(nullptr, viewMatrix * proj));
+    return view;
+}
+
+/**
+ * @brief Mean absolute difference relative to the mean of the reference.
+ */
+double RelativeError(const std::vector<float> &image, const std::vector<float> &reference)
+{
+    double difference = 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < image.size(); ++i)
+    {
+        difference += std::fabs(image[i] - reference[i]);
+        total += reference[i];
+    }
+    return difference / total;
+}
+
+} // namespace
+
+void TestNoiseOffset()
+{
+    assert(TemporalReprojection::NoiseOffset(0) == 0.0f);
+
+    // Any run of 16 frames leaves no gap wider than two sixteenths of [0, 1)
+    for (uint32_t start : {0u, 5u, 1000u, 123456u})
+    {
+        std::vector<float> offsets;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const float offset = TemporalReprojection::NoiseOffset(start + i);
+            assert(offset >= 0.0f && offset < 1.0f);
+            offsets.push_back(offset);
+        }
+        std::sort(offsets.begin(), offsets.end());
+        float gap = offsets.front() + 1.0f - offsets.back();
+        for (size_t i = 1; i < offsets.size(); ++i)
+            gap = (std::max)(gap, offsets[i] - offsets[i - 1]);
+        assert(gap < 2.0f / 16.0f);
+    }
+
+    std::cout << "Noise offset test passed." << std::endl;
+}
+
+void TestReproject()
+{
+    const TemporalReprojection::View view = MakeView({0.0f, 2.0f, -10.0f}, {0.0f, 2.0f, 0.0f});
+
+    // The point the camera looks at lands in the middle; behind the camera fails
+    DirectX::XMFLOAT2 uv;
+    assert(TemporalReprojection::Reproject(view.viewProj, {0.0f, 2.0f, 0.0f}, uv));
+    assert(std::fabs(uv.x - 0.5f) < 1e-5f && std::fabs(uv.y - 0.5f) < 1e-5f);
+    assert(!TemporalReprojection::Reproject(view.viewProj, {0.0f, 2.0f, -20.0f}, uv));
+    assert(!TemporalReprojection::Reproject(view.viewProj, {100.0f, 2.0f, 0.0f}, uv));
+
+    // Above and to the right on screen: v decreases, u increases
+    assert(TemporalReprojection::Reproject(view.viewProj, {1.0f, 3.0f, 0.0f}, uv));
+    assert(uv.x > 0.5f && uv.y < 0.5f);
+
+    // A pixel reconstructed through the inverse projects back to its own center
+    const TemporalReprojection::View moved = MakeView({3.0f, 2.5f, -9.0f}, {0.0f, 2.0f, 0.0f});
+    const DirectX::XMMATRIX inv = DirectX::XMLoadFloat4x4(&moved.invViewProj);
+    const DirectX::XMVECTOR world = DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(-0.25f, 0.5f, 0.99f, 1.0f), inv);
+    DirectX::XMFLOAT3 point;
+    DirectX::XMStoreFloat3(&point, world);
+    assert(TemporalReprojection::Reproject(moved.viewProj, point, uv));
+    assert(std::fabs(uv.x - 0.375f) < 1e-3f && std::fabs(uv.y - 0.25f) < 1e-3f);
+
+    std::cout << "Reproject test passed." << std::endl;
+}
+
+void TestClampAndBlend()
+{
+    const DirectX::XMFLOAT3 clamped =
+        TemporalReprojection::ClampToNeighborhood({2.0f, -1.0f, 0.5f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f});
+    assert(clamped.x == 1.0f && clamped.y == 0.0f && clamped.z == 0.5f);
+
+    const DirectX::XMFLOAT3 blended = TemporalReprojection::ResolvePixel({1.0f, 0.0f, 2.0f}, {0.0f, 1.0f, 2.0f}, 0.25f);
+    assert(std::fabs(blended.x - 0.25f) < 1e-6f && std::fabs(blended.y - 0.75f) < 1e-6f && blended.z == 2.0f);
+
+    assert(TemporalReprojection::IsHistoryValid(10.0f, 10.4f));
+    assert(!TemporalReprojection::IsHistoryValid(10.0f, 11.0f));
+    assert(!TemporalReprojection::IsHistoryValid(10.0f, 5.0f));
+
+    std::cout << "Clamp and blend test passed." << std::endl;
+}
+
+void TestLightStateChanged()
+{
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                               TestLights::AimedAt({4.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f})};
+    assert(!TemporalReprojection::LightStateChanged(lights, lights));
+    assert(TemporalReprojection::LightStateChanged(lights, {lights[0]}));
+
+    // Animated gobo rotation and shake keep the history
+    std::vector<SpotlightData> changed = lights;
+    changed[1].coneGobo.z += 0.3f;
+    changed[1].goboOff = {0.01f, -0.02f, 0.0f, 0.0f};
+    assert(!TemporalReprojection::LightStateChanged(lights, changed));
+
+    changed = lights;
+    changed[1].colorInt.x = 0.5f;
+    assert(TemporalReprojection::LightStateChanged(lights, changed));
+    changed = lights;
+    changed[0].dirAngle.x += 0.05f;
+    assert(TemporalReprojection::LightStateChanged(lights, changed));
+    changed = lights;
+    changed[0].coneGobo.w = 2.0f;
+    assert(TemporalReprojection::LightStateChanged(lights, changed));
+
+    std::cout << "Light state changed test passed." << std::endl;
+}
+
+void TestRejection()
+{
+    // Static camera: the history is kept where the surface is the same and dropped where a
+    // nearer surface appeared
+    const TemporalReprojection::View first = MakeView({0.0f, 2.0f, -10.0f}, {0.0f, 2.0f, 0.0f});
+    std::vector<float> depth(static_cast<size_t>(WIDTH) * HEIGHT, 0.995f);
+    TemporalReprojection::View view = first;
+    view.depth = depth.data();
+
+    TemporalReprojection::History history;
+    const std::vector<float> bright(static_cast<size_t>(WIDTH) * HEIGHT * 3, 1.0f);
+    std::vector<float> dark(bright.size(), 0.0f);
+    assert(!TemporalReprojection::Accumulate(view, std::vector<float>(5), false, history));
+    assert(TemporalReprojection::Accumulate(view, bright, false, history));
+    assert(history.rgb == bright);
+
+    // Current frame dark except a bright pixel in each neighborhood, so clamping keeps the history
+    for (int y = 0; y < HEIGHT; y += 3)
+        for (int x = 0; x < WIDTH; x += 3)
+            for (int c = 0; c < 3; ++c)
+                dark[((static_cast<size_t>(y + 1) * WIDTH + x + 1) * 3) + c] = 1.0f;
+    for (int y = 0; y < 9; ++y)
+        for (int x = 0; x < 9; ++x)
+            depth[(static_cast<size_t>(y) * WIDTH) + x] = 0.5f; // Nearer surface in the top-left corner
+
+    assert(TemporalReprojection::Accumulate(view, dark, false, history));
+    const size_t kept = ((static_cast<size_t>(13) * WIDTH) + 24) * 3; // Dark pixel away from the corner
+    assert(dark[kept] == 0.0f);
+    assert(std::fabs(history.rgb[kept] - (1.0f - Config::Volumetric::TEMPORAL_BLEND)) < 1e-5f);
+    const size_t rejected = ((static_cast<size_t>(3) * WIDTH) + 3) * 3;
+    assert(dark[rejected] == 0.0f && history.rgb[rejected] == 0.0f);
+
+    // Reset drops everything
+    assert(TemporalReprojection::Accumulate(view, dark, true, history));
+    assert(history.rgb == dark);
+
+    std::cout << "Rejection test passed." << std::endl;
+}
+
+void TestConvergence()
+{
+    // Accumulating a quarter of the steps with the rotating noise comes close to a full-step frame
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                               TestLights::AimedAt({-4.0f, 8.0f, 2.0f}, {1.0f, 0.0f, 0.0f})};
+    const TemporalReprojection::View view = MakeView({1.0f, 3.0f, -12.0f}, {0.0f, 3.0f, 0.0f});
+    VolumetricReference::Inputs inputs;
+    inputs.width = WIDTH;
+    inputs.height = HEIGHT;
+    inputs.invViewProj = view.invViewProj;
+    inputs.cameraPos = view.cameraPos;
+    inputs.lights = lights.data();
+    inputs.lightCount = lights.size();
+    inputs.params.params = {1024.0f, Config::Volumetric::DEFAULT_DENSITY, Config::Volumetric::DEFAULT_INTENSITY,
+                            Config::Volumetric::DEFAULT_ANISOTROPY};
+    std::vector<float> reference;
+    assert(VolumetricReference::Render(inputs, reference));
+
+    inputs.params.params.x = 32.0f;
+    std::vector<float> single;
+    assert(VolumetricReference::Render(inputs, single));
+    inputs.params.params.x = 8.0f;
+    std::vector<float> quarter;
+    assert(VolumetricReference::Render(inputs, quarter));
+
+    TemporalReprojection::History history;
+    std::vector<float> frame;
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        inputs.params.jitter.z = TemporalReprojection::NoiseOffset(i);
+        assert(VolumetricReference::Render(inputs, frame));
+        assert(TemporalReprojection::Accumulate(view, frame, false, history));
+    }
+
+    const double singleError = RelativeError(single, reference);
+    const double quarterError = RelativeError(quarter, reference);
+    const double accumulatedError = RelativeError(history.rgb, reference);
+    assert(accumulatedError < quarterError / 4.0);
+    assert(accumulatedError < 2.0 * singleError);
+
+    std::cout << "Convergence test passed (8 steps: " << 100.0 * quarterError << "%, 32 steps: " << 100.0 * singleError
+              << "%, 8 steps accumulated: " << 100.0 * accumulatedError << "%)." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestNoiseOffset();
+        TestReproject();
+        TestClampAndBlend();
+        TestLightStateChanged();
+        TestRejection();
+        TestConvergence();
+        std::cout << "All TemporalReprojection tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+#include "Resources/TextureBaker.h"
+#include "Core/Config.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "test_images.h"
+
+namespace
+{
+
+using TestImages::SolidTga;
+using TextureBaker::Format;
+
+/// A disc with an anti-aliased edge, like a gobo mask, optionally tinted.
+TextureBaker::Image MakeDisc(int size, int layers, bool tinted)
+{
+    TextureBaker::Image image;
+    image.width = size;
+    image.height = size;
+    image.layers = layers;
+    image.rgba.resize(static_cast<size_t>(size) * size * layers * 4);
+    for (int layer = 0; layer < layers; ++layer)
+    {
+        const float radius = size * (0.3f + (0.05f * layer));
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                const float dx = (x + 0.5f) - (size * 0.5f);
+                const float dy = (y + 0.5f) - (size * 0.5f);
+                const float coverage = std::clamp(radius - std::sqrt((dx * dx) + (dy * dy)) + 0.5f, 0.0f, 1.0f);
+                uint8_t *texel = &image.rgba[((((static_cast<size_t>(layer) * size) + y) * size) + x) * 4];
+                const auto value = static_cast<uint8_t>((coverage * 255.0f) + 0.5f);
+                texel[0] = value;
+                texel[1] = tinted ? static_cast<uint8_t>(value * x / size) : value;
+                texel[2] = tinted ? static_cast<uint8_t>(value * y / size) : value;
+                texel[3] = 255;
+            }
+        }
+    }
+    return image;
+}
+
+void TestDownsample()
+{
+    // Odd sizes and single rows or columns: the SIMD pairs and the scalar tail agree with a
+    // plain 2x2 box that drops the last odd row and column
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    const int sizes[][2] = {{37, 20}, {16, 16}, {9, 1}, {1, 9}, {1, 1}, {6, 3}};
+    for (const auto &size : sizes)
+    {
+        const int width = size[0];
+        const int height = size[1];
+        std::vector<float> src(static_cast<size_t>(width) * height * 4);
+        for (float &v : src)
+            v = value(rng);
+        const int dstWidth = (std::max)(width / 2, 1);
+        const int dstHeight = (std::max)(height / 2, 1);
+        std::vector<float> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+        TextureBaker::Downsample(src.data(), width, height, dst.data());
+
+        for (int y = 0; y < dstHeight; ++y)
+        {
+            for (int x = 0; x < dstWidth; ++x)
+            {
+                const int x0 = 2 * x;
+                const int y0 = 2 * y;
+                const int x1 = (std::min)(x0 + 1, width - 1);
+                const int y1 = (std::min)(y0 + 1, height - 1);
+                for (int c = 0; c < 4; ++c)
+                {
+                    auto at = [&](int sx, int sy) { return src[((static_cast<size_t>(sy) * width) + sx) * 4 + c]; };
+                    const float expected = 0.25f * (at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1));
+                    assert(std::fabs(dst[((static_cast<size_t>(y) * dstWidth) + x) * 4 + c] - expected) < 1e-6f);
+                }
+            }
+        }
+    }
+    assert(TextureBaker::MipCount(512, 512) == 10);
+    assert(TextureBaker::MipCount(512, 128) == 10);
+    assert(TextureBaker::MipCount(1, 1) == 1);
+    std::cout << "Downsample test passed." << std::endl;
+}
+
+void TestGammaCorrectMips()
+{
+    // A black and white checkerboard averages to half the light, which is 188 in sRGB, not 128;
+    // as a mask (BC4, linear) it is stored as 128
+    TextureBaker::Image image;
+    image.width = 8;
+    image.height = 8;
+    image.layers = 1;
+    image.rgba.resize(8 * 8 * 4);
+    for (int i = 0; i < 64; ++i)
+    {
+        const uint8_t value = (((i % 8) + (i / 8)) % 2) ? 255 : 0;
+        image.rgba[i * 4] = image.rgba[(i * 4) + 1] = image.rgba[(i * 4) + 2] = value;
+        image.rgba[(i * 4) + 3] = 255;
+    }
+
+    TextureBaker::BakedTexture baked;
+    assert(TextureBaker::Bake(image, Format::RGBA8, baked));
+    assert(baked.mipLevels == 4 && baked.subresources.size() == 4);
+    std::vector<uint8_t> level;
+    for (int mip = 1; mip < baked.mipLevels; ++mip)
+    {
+        TextureBaker::DecodeLevel(baked, 0, mip, level);
+        for (size_t i = 0; i < level.size(); i += 4)
+            assert(level[i] == 188 && level[i + 1] == 188 && level[i + 2] == 188);
+    }
+    assert(TextureBaker::MeasurePsnr(image, baked, 0, 0) == std::numeric_limits<double>::infinity());
+
+    assert(TextureBaker::Bake(image, Format::BC4, baked));
+    TextureBaker::DecodeLevel(baked, 0, 0, level);
+    for (size_t i = 0; i < level.size(); i += 4)
+        assert(level[i] == image.rgba[i]);
+    TextureBaker::DecodeLevel(baked, 0, 1, level);
+    assert(level.size() == 4 * 4 * 4 && level[0] == 128);
+
+    // The summed-area table input is linear either way
+    std::vector<uint8_t> linear;
+    assert(TextureBaker::Bake(image, Format::BC7, baked));
+    TextureBaker::DecodeLinearSlices(baked, linear);
+    assert(linear.size() == image.rgba.size());
+    for (size_t i = 0; i < linear.size(); i += 4)
+        assert(std::abs(static_cast<int>(linear[i]) - image.rgba[i]) <= 1);
+    std::cout << "Gamma-correct mips test passed." << std::endl;
+}
+
+void TestCompression()
+{
+    // A grey mask goes to BC4, which keeps the black and white exactly
+    const TextureBaker::Image mask = MakeDisc(128, 3, false);
+    assert(TextureBaker::ChooseFormat(mask) == Format::BC4);
+    TextureBaker::BakedTexture baked;
+    assert(TextureBaker::Bake(mask, Format::BC4, baked));
+    assert(baked.data.size() == 3 * (8u * (1024 + 256 + 64 + 16 + 4 + 1 + 1 + 1)));
+    std::vector<uint8_t> level;
+    TextureBaker::DecodeLevel(baked, 1, 0, level);
+    for (size_t i = 0; i < level.size(); i += 4)
+        if (mask.rgba[(128 * 128 * 4) + i] == 0 || mask.rgba[(128 * 128 * 4) + i] == 255)
+            assert(level[i] == mask.rgba[(128 * 128 * 4) + i]);
+
+    const double bc4 = TextureBaker::MeasurePsnr(mask, baked, -1, -1);
+    assert(TextureBaker::Bake(mask, Format::RGBA8, baked));
+    const double rgba8 = TextureBaker::MeasurePsnr(mask, baked, -1, -1);
+    std::cout << "  mask PSNR " << bc4 << " dB as BC4, " << rgba8 << " dB as RGBA8" << std::endl;
+    assert(bc4 > 40.0);
+
+    // Tinted, it goes to BC7 (or BC1); both stay close to the uncompressed levels
+    const TextureBaker::Image tinted = MakeDisc(128, 2, true);
+    assert(TextureBaker::ChooseFormat(tinted) == (Config::Gobo::COLOR_BC7 ? Format::BC7 : Format::BC1));
+    assert(TextureBaker::Bake(tinted, Format::BC7, baked));
+    assert(baked.data.size() == 2 * (16u * (1024 + 256 + 64 + 16 + 4 + 1 + 1 + 1)));
+    const double bc7 = TextureBaker::MeasurePsnr(tinted, baked, -1, -1);
+    assert(TextureBaker::Bake(tinted, Format::BC1, baked));
+    const double bc1 = TextureBaker::MeasurePsnr(tinted, baked, -1, -1);
+    std::cout << "  tinted PSNR " << bc7 << " dB as BC7, " << bc1 << " dB as BC1" << std::endl;
+    assert(bc7 > 40.0 && bc1 > 30.0 && bc7 > bc1);
+
+    // Flat blocks come back (nearly) exact in every format
+    TextureBaker::Image flat;
+    flat.width = flat.height = 4;
+    flat.layers = 1;
+    flat.rgba.assign(64, 0);
+    for (size_t i = 0; i < flat.rgba.size(); i += 4)
+    {
+        flat.rgba[i] = 200;
+        flat.rgba[i + 1] = 90;
+        flat.rgba[i + 2] = 31;
+        flat.rgba[i + 3] = 255;
+    }
+    for (Format format : {Format::BC1, Format::BC7})
+    {
+        assert(TextureBaker::Bake(flat, format, baked));
+        TextureBaker::DecodeLevel(baked, 0, 0, level);
+        for (size_t i = 0; i < level.size(); i += 4)
+            for (int c = 0; c < 3; ++c)
+                assert(std::abs(level[i + c] - flat.rgba[i + c]) <= (format == Format::BC7 ? 1 : 4));
+    }
+
+    // Block formats need whole blocks
+    flat.width = 6;
+    flat.rgba.resize(6 * 4 * 4);
+    assert(!TextureBaker::Bake(flat, Format::BC4, baked));
+    assert(TextureBaker::Bake(flat, Format::RGBA8, baked));
+    std::cout << "Compression test passed." << std::endl;
+}
+
+void TestDecodeSlices()
+{
+    // Slices take the largest size rounded up to whole blocks; smaller images are centered, and
+    // transparent texels are black
+    std::vector<std::vector<uint8_t>> files = {SolidTga(10, 6, 200, 255), SolidTga(4, 2, 90, 255),
+                                               SolidTga(2, 2, 255, 0), {1, 2, 3}};
+    TextureBaker::Image image;
+    assert(TextureBaker::DecodeSlices(files, image));
+    assert(image.width == 12 && image.height == 8 && image.layers == 3);
+    auto at = [&](int layer, int x, int y) { return image.rgba[((((layer * 8) + y) * 12) + x) * 4]; };
+    assert(at(0, 0, 0) == 0 && at(0, 1, 1) == 200 && at(0, 10, 6) == 200 && at(0, 11, 7) == 0);
+    assert(at(1, 4, 3) == 90 && at(1, 7, 4) == 90 && at(1, 3, 3) == 0 && at(1, 8, 4) == 0 && at(1, 4, 5) == 0);
+    int count = 0;
+    for (int y = 0; y < 8; ++y)
+        for (int x = 0; x < 12; ++x)
+            count += at(1, x, y) == 90;
+    assert(count == 8);
+    assert(at(2, 5, 3) == 0 && at(2, 6, 4) == 0);
+
+    assert(!TextureBaker::DecodeSlices({}, image));
+    assert(!TextureBaker::DecodeSlices({{1, 2, 3}}, image));
+    std::cout << "Decode slices test passed." << std::endl;
+}
+
+void TestCache()
+{
+    const std::vector<std::vector<uint8_t>> files = {SolidTga(16, 16, 255, 255), SolidTga(8, 8, 30, 255)};
+    TextureBaker::Image image;
+    assert(TextureBaker::DecodeSlices(files, image));
+    TextureBaker::BakedTexture baked;
+    assert(TextureBaker::Bake(image, TextureBaker::ChooseFormat(image), baked));
+
+    const uint64_t key = TextureBaker::CacheKey(files);
+    const std::string path = TextureBaker::GetCachePath("test_texture_baker.tga");
+    assert(path == "test_texture_baker.tga.texcache");
+    assert(TextureBaker::WriteCache(path, key, baked));
+
+    TextureBaker::BakedTexture cached;
+    assert(TextureBaker::ReadCache(path, key, cached));
+    assert(cached.format == baked.format && cached.width == 16 && cached.height == 16 && cached.layers == 2);
+    assert(cached.mipLevels == baked.mipLevels && cached.data == baked.data);
+    assert(cached.subresources.size() == baked.subresources.size());
+    for (size_t s = 0; s < cached.subresources.size(); ++s)
+        assert(cached.subresources[s].offset == baked.subresources[s].offset &&
+               cached.subresources[s].rowPitch == baked.subresources[s].rowPitch);
+
+    // Other sources, or a damaged file, are rejected
+    std::vector<std::vector<uint8_t>> changed = files;
+    changed[1][40] ^= 1;
+    assert(TextureBaker::CacheKey(changed) != key);
+    assert(!TextureBaker::ReadCache(path, TextureBaker::CacheKey(changed), cached));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.put(0);
+    }
+    assert(!TextureBaker::ReadCache(path, key, cached));
+    std::remove(path.c_str());
+    assert(!TextureBaker::ReadCache(path, key, cached));
+    std::cout << "Cache test passed." << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        TestDownsample();
+        TestGammaCorrectMips();
+        TestCompression();
+        TestDecodeSlices();
+        TestCache();
+        std::cout << "All TextureBaker tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "Geometry/VertexQuantizer.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace VertexQuantizer;
+
+// Angular error bound for 16-bit octahedral normals (half a step of 2/32767 on the octahedron,
+// stretched by at most ~2x when projected back to the sphere), in degrees
+static constexpr float NORMAL_ERROR_BOUND_DEG = 0.01f;
+
+void TestPositions()
+{
+    std::cout << "Testing position quantization..." << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<Vertex> vertices(10000);
+    for (auto &v : vertices)
+    {
+        v = {};
+        v.position = {dist(rng) * 50.0f, (dist(rng) + 1.0f) * 12.0f, dist(rng) * 30.0f + 100.0f};
+    }
+
+    Bounds bounds = ComputeBounds(vertices.data(), vertices.size());
+    assert(bounds.extent.x > 99.0f && bounds.extent.x <= 100.0f);
+    const float bound = MaxPositionError(bounds);
+    assert(std::fabs(bound - (0.5f * bounds.extent.x / 65535.0f)) < 1e-9f);
+
+    for (const auto &v : vertices)
+    {
+        uint16_t q[3];
+        EncodePosition(v.position, bounds, q);
+        DirectX::XMFLOAT3 p = DecodePosition(q, bounds);
+        // Allow a couple of float ulps at the magnitude of the coordinates on top of the quantization bound
+        assert(std::fabs(p.x - v.position.x) <= bound + 1e-5f);
+        assert(std::fabs(p.y - v.position.y) <= bound + 1e-5f);
+        assert(std::fabs(p.z - v.position.z) <= bound + 2e-5f);
+    }
+
+    // Corners are exact, outside values clamp, flat axes decode to the minimum
+    uint16_t q[3];
+    EncodePosition(bounds.min, bounds, q);
+    assert(q[0] == 0 && q[1] == 0 && q[2] == 0);
+    EncodePosition({1e6f, -1e6f, 1e6f}, bounds, q);
+    assert(q[0] == 65535 && q[1] == 0 && q[2] == 65535);
+
+    Bounds flat;
+    flat.min = {1.0f, 2.0f, 3.0f};
+    flat.extent = {4.0f, 0.0f, 0.0f};
+    EncodePosition({3.0f, 2.0f, 3.0f}, flat, q);
+    DirectX::XMFLOAT3 p = DecodePosition(q, flat);
+    assert(std::fabs(p.x - 3.0f) < 1e-4f && p.y == 2.0f && p.z == 3.0f);
+
+    std::cout << "Position quantization passed (bound " << bound << ")." << std::endl;
+}
+
+// Angle between two directions, via atan2 in double so tiny angles are not lost to rounding
+float AngleDeg(const DirectX::XMFLOAT3 &a, const DirectX::XMFLOAT3 &b)
+{
+    const double ax = a.x, ay = a.y, az = a.z, bx = b.x, by = b.y, bz = b.z;
+    const double cx = (ay * bz) - (az * by), cy = (az * bx) - (ax * bz), cz = (ax * by) - (ay * bx);
+    const double cross = std::sqrt((cx * cx) + (cy * cy) + (cz * cz));
+    const double dot = (ax * bx) + (ay * by) + (az * bz);
+    return static_cast<float>(std::atan2(cross, dot) * 180.0 / 3.14159265358979);
+}
+
+void TestOctahedralNormals()
+{
+    std::cout << "Testing octahedral normals..." << std::endl;
+
+    // Axes and diagonals, including the folded lower hemisphere
+    const DirectX::XMFLOAT3 special[] = {{0, 0, 1},  {0, 0, -1}, {1, 0, 0},  {-1, 0, 0},   {0, 1, 0},
+                                         {0, -1, 0}, {1, 1, -1}, {-1, 1, -1}, {1, -1, -1}, {-1, -1, 1}};
+    for (const auto &n : special)
+    {
+        int16_t q[2];
+        EncodeOctahedral(n, q);
+        assert(AngleDeg(n, DecodeOctahedral(q)) <= NORMAL_ERROR_BOUND_DEG);
+    }
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    float worst = 0.0f;
+    for (int i = 0; i < 200000; ++i)
+    {
+        DirectX::XMFLOAT3 n = {dist(rng), dist(rng), dist(rng)};
+        int16_t q[2];
+        EncodeOctahedral(n, q);
+        DirectX::XMFLOAT3 d = DecodeOctahedral(q);
+        float length = std::sqrt((d.x * d.x) + (d.y * d.y) + (d.z * d.z));
+        assert(std::fabs(length - 1.0f) < 1e-5f);
+        worst = std::fmax(worst, AngleDeg(n, d));
+    }
+    assert(worst <= NORMAL_ERROR_BOUND_DEG);
+
+    // Zero normal decodes to +Z instead of NaN
+    int16_t q[2];
+    EncodeOctahedral({0, 0, 0}, q);
+    DirectX::XMFLOAT3 d = DecodeOctahedral(q);
+    assert(d.z == 1.0f);
+
+    std::cout << "Octahedral normals passed (max error " << worst << " deg)." << std::endl;
+}
+
+void TestHalfFloat()
+{
+    std::cout << "Testing half floats..." << std::endl;
+
+    // Exactly representable values round-trip
+    const float exact[] = {0.0f, -0.0f, 1.0f, -2.5f, 0.5f, 0.25f, 65504.0f, 6.103515625e-05f, 5.9604645e-08f};
+    for (float f : exact)
+        assert(HalfToFloat(FloatToHalf(f)) == f);
+
+    assert(FloatToHalf(1.0f) == 0x3C00);
+    assert(FloatToHalf(-2.0f) == 0xC000);
+    assert(FloatToHalf(65520.0f) == 0x7C00); // Rounds to infinity
+    assert(std::isinf(HalfToFloat(FloatToHalf(1e10f))));
+    assert(std::isnan(HalfToFloat(FloatToHalf(std::nanf("")))));
+    assert(FloatToHalf(1e-10f) == 0);
+
+    // Ties round to even: 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+    assert(FloatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);
+    assert(FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3C02);
+
+    // Relative error bound 2^-11 over the normal range used by texture coordinates
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-64.0f, 64.0f);
+    for (int i = 0; i < 100000; ++i)
+    {
+        float f = dist(rng);
+        if (std::fabs(f) < 6.2e-5f)
+            continue;
+        float h = HalfToFloat(FloatToHalf(f));
+        assert(std::fabs(h - f) <= std::fabs(f) * std::ldexp(1.0f, -11));
+    }
+
+    // Every half value decodes and re-encodes to itself (NaN payloads aside)
+    for (uint32_t bits = 0; bits < 0x10000; ++bits)
+    {
+        auto h = static_cast<uint16_t>(bits);
+        float f = HalfToFloat(h);
+        if (!std::isnan(f))
+            assert(FloatToHalf(f) == h);
+    }
+
+    std::cout << "Half floats passed." << std::endl;
+}
+
+void TestVertexRoundTrip()
+{
+    std::cout << "Testing full vertex round trip..." << std::endl;
+
+    std::vector<Vertex> vertices;
+    for (int i = 0; i < 64; ++i)
+    {
+        Vertex v;
+        float t = static_cast<float>(i) / 63.0f;
+        v.position = {t * 10.0f, 1.0f - t, -t * 3.0f};
+        v.normal = {std::cos(t * 6.28f), std::sin(t * 6.28f), t - 0.5f};
+        v.uv = {t, 1.0f - t};
+        vertices.push_back(v);
+    }
+
+    Bounds bounds = ComputeBounds(vertices.data(), vertices.size());
+    std::vector<QuantizedVertex> compact = QuantizeVertices(vertices.data(), vertices.size(), bounds);
+    std::vector<QuantizedPosition> positions = QuantizePositions(vertices.data(), vertices.size(), bounds);
+    assert(compact.size() == vertices.size() && positions.size() == vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        // The position stream carries the same encoding as the full format
+        for (int k = 0; k < 3; ++k)
+            assert(positions[i].position[k] == compact[i].position[k]);
+
+        Vertex d = Decode(compact[i], bounds);
+        assert(std::fabs(d.position.x - vertices[i].position.x) <= MaxPositionError(bounds) + 1e-6f);
+        assert(AngleDeg(d.normal, vertices[i].normal) <= NORMAL_ERROR_BOUND_DEG);
+        assert(std::fabs(d.uv.x - vertices[i].uv.x) <= 1.0f / 2048.0f);
+    }
+
+    Report report = Analyze(vertices.data(), vertices.size());
+    assert(report.fullBytes == 64 * 32);
+    assert(report.quantizedBytes == 64 * 16);
+    assert(report.positionBytes == 64 * 8);
+    assert(report.maxPositionError <= MaxPositionError(bounds) + 1e-6f);
+    assert(report.maxNormalErrorDeg <= NORMAL_ERROR_BOUND_DEG);
+    assert(report.maxUvError <= 1.0f / 2048.0f);
+
+    std::cout << "Full vertex round trip passed." << std::endl;
+}
+
+int main()
+{
+    TestPositions();
+    TestOctahedralNormals();
+    TestHalfFloat();
+    TestVertexRoundTrip();
+    std::cout << "All VertexQuantizer tests passed!" << std::endl;
+    return 0;
+}
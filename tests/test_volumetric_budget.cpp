@@ -0,0 +1,239 @@
+#include "Rendering/VolumetricBudget.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr float FOV = 1.0f;
+constexpr int PIXELS = 1920 * 1080;
+
+/**
+ * @brief World-to-clip matrix of a square camera looking at a target.
+ */
+DirectX::XMFLOAT4X4 MakeViewProj(const DirectX::XMFLOAT3 &eye, const DirectX::XMFLOAT3 &target)
+{
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(eye.x, eye.y, eye.z, 1.0f),
+                                                             DirectX::XMVectorSet(target.x, target.y, target.z, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(FOV, 1.0f, 0.1f, 1000.0f);
+    DirectX::XMFLOAT4X4 viewProj;
+    DirectX::XMStoreFloat4x4(&viewProj, view * proj);
+    return viewProj;
+}
+
+/**
+ * @brief Estimate of a light with its cone bounded only by its range.
+ */
+VolumetricBudget::LightEstimate Estimate(const SpotlightData &light, const DirectX::XMFLOAT4X4 &viewProj,
+                                         const DirectX::XMFLOAT3 &eye, float length)
+{
+    const ConeBounds::Bounds bounds =
+        ConeBounds::Compute(light, viewProj, eye, {-1e4f, -1e4f, -1e4f}, {1e4f, 1e4f, 1e4f});
+    return VolumetricBudget::EstimateLight(light, bounds, eye, length);
+}
+
+} // namespace
+
+void TestBeamLength()
+{
+    const DirectX::XMFLOAT3 lo = {-50.0f, 0.0f, -50.0f};
+    const DirectX::XMFLOAT3 hi = {50.0f, 100.0f, 50.0f};
+
+    // Straight down from 15 units: the floor ends the beam
+    const SpotlightData down = TestLights::Beam({0.0f, 15.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, 0.71f, 500.0f);
+    assert(std::fabs(VolumetricBudget::BeamLength(down, lo, hi) - 15.0f) < 1e-4f);
+
+    // Diagonal: the wall at x = 50 comes first
+    const SpotlightData diagonal = TestLights::Beam({0.0f, 40.0f, 0.0f}, {1.0f, -0.5f, 0.0f}, 0.71f, 500.0f);
+    assert(std::fabs(VolumetricBudget::BeamLength(diagonal, lo, hi) - (50.0f * std::sqrt(1.25f))) < 1e-3f);
+
+    // The range ends it before the room does
+    const SpotlightData shortRange = TestLights::Beam({0.0f, 15.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, 0.71f, 5.0f);
+    assert(VolumetricBudget::BeamLength(shortRange, lo, hi) == 5.0f);
+
+    // Outside the room, pointing away
+    const SpotlightData outside = TestLights::Beam({0.0f, 200.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.71f, 500.0f);
+    assert(VolumetricBudget::BeamLength(outside, lo, hi) == 0.0f);
+
+    std::cout << "Beam length test passed." << std::endl;
+}
+
+void TestCoverage()
+{
+    const DirectX::XMFLOAT3 eye = {0.0f, 0.0f, 0.0f};
+    const DirectX::XMFLOAT4X4 viewProj = MakeViewProj(eye, {0.0f, 0.0f, 1.0f});
+
+    // Cone pointing at the camera, base facing it at distance 20: a polygon around a disk
+    const float field = 0.95f;
+    const float range = 10.0f;
+    const SpotlightData facing = TestLights::Beam({0.0f, 0.0f, 30.0f}, {0.0f, 0.0f, -1.0f}, field, range);
+    const VolumetricBudget::LightEstimate e = Estimate(facing, viewProj, eye, range);
+    const float radius = range * std::sqrt(1.0f - (field * field)) / field;
+    const float ndcRadius = radius / (20.0f * std::tan(FOV * 0.5f));
+    const int n = Config::Volumetric::CONE_BOUNDS_SEGMENTS;
+    const float polygon = n * ndcRadius * ndcRadius * std::tan(Config::Math::PI / n);
+    assert(std::fabs(e.coverage - (polygon / 4.0f)) < 1e-3f * polygon);
+    // Seen along the axis, a ray crosses the whole cone
+    assert(std::fabs(e.marchLength - range) < 1e-3f);
+
+    // The same cone seen from the side is crossed in a much shorter chord
+    const DirectX::XMFLOAT3 sideEye = {-25.0f, 0.0f, 25.0f};
+    const VolumetricBudget::LightEstimate side =
+        Estimate(facing, MakeViewProj(sideEye, {0.0f, 0.0f, 25.0f}), sideEye, range);
+    assert(side.coverage > 0.0f && side.marchLength < 0.5f * range);
+
+    // From inside the cone everything is covered
+    const VolumetricBudget::LightEstimate inside =
+        Estimate(facing, MakeViewProj({0.0f, 0.0f, 25.0f}, {0.0f, 0.0f, 0.0f}),
+                                        {0.0f, 0.0f, 25.0f}, range);
+    assert(inside.coverage == 1.0f);
+
+    // Behind the camera or switched off: nothing
+    const SpotlightData behind = TestLights::Beam({0.0f, 0.0f, -30.0f}, {0.0f, 0.0f, -1.0f}, field, range);
+    assert(Estimate(behind, viewProj, eye, range).coverage == 0.0f);
+    SpotlightData off = facing;
+    off.colorInt.w = 0.0f;
+    assert(Estimate(off, viewProj, eye, range).coverage == 0.0f);
+
+    // A cone crossing the camera plane is clipped rather than dropped, and fills part of the screen
+    const SpotlightData crossing = TestLights::Beam({2.0f, 0.0f, -5.0f}, {0.0f, 0.0f, 1.0f}, 0.99f, 20.0f);
+    const float crossingCoverage = Estimate(crossing, viewProj, eye, 20.0f).coverage;
+    assert(crossingCoverage > 0.0f && crossingCoverage < 1.0f);
+
+    // A wider cone covers more
+    const SpotlightData wide = TestLights::Beam({0.0f, 0.0f, 30.0f}, {0.0f, 0.0f, -1.0f}, 0.9f, range);
+    assert(Estimate(wide, viewProj, eye, range).coverage > e.coverage);
+
+    std::cout << "Coverage test passed (facing " << 100.0f * e.coverage << "%, side " << 100.0f * side.coverage
+              << "%, crossing " << 100.0f * crossingCoverage << "%)." << std::endl;
+}
+
+void TestImportance()
+{
+    const DirectX::XMFLOAT3 eye = {0.0f, 0.0f, 0.0f};
+    const DirectX::XMFLOAT4X4 viewProj = MakeViewProj(eye, {0.0f, 0.0f, 1.0f});
+    SpotlightData light = TestLights::Beam({0.0f, 5.0f, 20.0f}, {0.0f, -1.0f, 0.0f}, 0.8f, 10.0f);
+    const float base = Estimate(light, viewProj, eye, 10.0f).importance;
+    assert(base > 0.0f);
+
+    // Proportional to intensity, lower for a longer (dimmer on average) cone
+    light.colorInt.w *= 2.0f;
+    assert(std::fabs(Estimate(light, viewProj, eye, 10.0f).importance - 2.0f * base) <
+           1e-4f * base);
+    light.colorInt.w *= 0.5f;
+    assert(Estimate(light, viewProj, eye, 5.0f).importance > base);
+
+    std::cout << "Importance test passed." << std::endl;
+}
+
+void TestAllocate()
+{
+    // A wide wash filling a third of the screen and a narrow distant beam, equally bright per ray
+    VolumetricBudget::LightEstimate wash;
+    wash.coverage = 0.33f;
+    wash.marchLength = 30.0f;
+    wash.importance = 1.0f;
+    VolumetricBudget::LightEstimate narrow;
+    narrow.coverage = 0.01f;
+    narrow.marchLength = 2.0f;
+    narrow.importance = 15.0f;
+    const std::vector<VolumetricBudget::LightEstimate> estimates = {wash, narrow};
+
+    // Unlimited: the wash gets all the steps, the short beam a tenth, held at the minimum
+    std::vector<float> steps;
+    const double full = VolumetricBudget::Allocate(estimates, PIXELS, 1e30, 16.0f, 128.0f, steps);
+    assert(steps.size() == 2 && steps[0] == 128.0f && steps[1] == 16.0f);
+    assert(full == VolumetricBudget::CountSamples(estimates, PIXELS, steps));
+
+    // Half the budget: the request is scaled down and stays within it
+    const double half = VolumetricBudget::Allocate(estimates, PIXELS, full * 0.5, 16.0f, 128.0f, steps);
+    assert(half <= full * 0.5 && half > full * 0.45);
+    assert(steps[0] < 128.0f && steps[0] >= 16.0f && steps[1] == 16.0f);
+
+    // Every budget respects the minimum; more budget never means fewer steps
+    float previous = 0.0f;
+    for (double budget = 0.0; budget <= full; budget += full / 16.0)
+    {
+        VolumetricBudget::Allocate(estimates, PIXELS, budget, 16.0f, 128.0f, steps);
+        assert(steps[0] >= 16.0f && steps[1] >= 16.0f);
+        assert(steps[0] >= previous);
+        previous = steps[0];
+    }
+
+    // A dim light asks for a share of the steps, never less than the floor
+    VolumetricBudget::LightEstimate dim = wash;
+    dim.importance = 1e-6f;
+    VolumetricBudget::Allocate({wash, dim}, PIXELS, 1e30, 16.0f, 128.0f, steps);
+    assert(steps[0] == 128.0f && steps[1] == 128.0f * Config::Volumetric::BUDGET_MIN_IMPORTANCE);
+
+    // Nothing on screen costs nothing
+    VolumetricBudget::Allocate({VolumetricBudget::LightEstimate()}, PIXELS, 1e30, 16.0f, 128.0f, steps);
+    assert(steps[0] == 16.0f);
+    assert(VolumetricBudget::CountSamples({VolumetricBudget::LightEstimate()}, PIXELS, steps) == 0.0);
+
+    std::cout << "Allocate test passed." << std::endl;
+}
+
+void TestCostModel()
+{
+    // Synthetic GPU: 0.3 ms fixed, 0.5 ms per million covered pixels, 0.04 ms per million samples
+    const auto gpu = [](double pixels, double samples) { return 0.3 + (0.5 * pixels / 1e6) + (0.04 * samples / 1e6); };
+
+    VolumetricBudget::CostModel model;
+    assert(!model.IsCalibrated() && model.Predict(1e6, 1e8) == 0.0);
+
+    // Frames with a varying number of lights and budgets
+    for (int frame = 0; frame < 40; ++frame)
+    {
+        const double pixels = 4e5 + (frame % 5) * 3e5;
+        const double samples = pixels * (16.0 + (frame % 7) * 16.0);
+        model.Observe(pixels, samples, gpu(pixels, samples));
+    }
+    assert(model.IsCalibrated());
+
+    const double pixels = 1.1e6;
+    const double samples = pixels * 90.0;
+    const double predicted = model.Predict(pixels, samples);
+    assert(std::fabs(predicted - gpu(pixels, samples)) < 0.01 * gpu(pixels, samples));
+
+    // The budget for a target time costs that time
+    const double budget = model.SamplesFor(3.0, pixels);
+    assert(std::fabs(gpu(pixels, budget) - 3.0) < 0.03);
+    assert(model.SamplesFor(0.1, pixels) == 0.0);
+
+    // The GPU slows down: the model follows
+    const auto slower = [&](double p, double s) { return 2.0 * gpu(p, s); };
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        const double p = 4e5 + (frame % 5) * 3e5;
+        const double s = p * (16.0 + (frame % 7) * 16.0);
+        model.Observe(p, s, slower(p, s));
+    }
+    assert(std::fabs(model.Predict(pixels, samples) - slower(pixels, samples)) < 0.02 * slower(pixels, samples));
+
+    std::cout << "Cost model test passed (predicted " << predicted << " ms, actual " << gpu(pixels, samples)
+              << " ms)." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestBeamLength();
+        TestCoverage();
+        TestImportance();
+        TestAllocate();
+        TestCostModel();
+        std::cout << "All VolumetricBudget tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
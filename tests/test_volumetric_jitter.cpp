@@ -3,11 +3,10 @@
 #include <iostream>
 
 int main() {
-    // We expect VolumetricBuffer to be 32 bytes (2 x float4)
-    // Currently it is 16 bytes (1 x float4)
-    // This test ensures we have added the necessary padding/data for jitter
-    if (sizeof(VolumetricBuffer) != 32) {
-        std::cerr << "VolumetricBuffer size mismatch! Expected 32, got " << sizeof(VolumetricBuffer) << std::endl;
+    // We expect VolumetricBuffer to be 48 bytes (3 x float4)
+    // This test ensures the shader's cbuffer layout (params, jitter, screen size) is matched
+    if (sizeof(VolumetricBuffer) != 48) {
+        std::cerr << "VolumetricBuffer size mismatch! Expected 48, got " << sizeof(VolumetricBuffer) << std::endl;
         return 1;
     }
     std::cout << "Test Passed" << std::endl;
@@ -0,0 +1,279 @@
+#include "Rendering/VolumetricReference.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "stb_image_write.h"
+#include "test_lights.h"
+
+namespace
+{
+
+constexpr int WIDTH = 37; // Odd sizes leave partial tiles and partial eight-pixel batches
+constexpr int HEIGHT = 23;
+
+/**
+ * @brief Camera a few meters back from a light hanging over the origin.
+ */
+VolumetricReference::Inputs MakeInputs(const std::vector<SpotlightData> &lights)
+{
+    VolumetricReference::Inputs inputs;
+    inputs.width = WIDTH;
+    inputs.height = HEIGHT;
+    inputs.cameraPos = {1.0f, 3.0f, -12.0f};
+    const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(1.0f, 3.0f, -12.0f, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 3.0f, 0.0f, 1.0f),
+                                                             DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const DirectX::XMMATRIX proj = DirectX::XMMatrixPerspectiveFovLH(
+        1.0f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 100.0f);
+    DirectX::XMStoreFloat4x4(&inputs.invViewProj, DirectX::XMMatrixInverse(nullptr, view * proj));
+    inputs.lights = lights.data();
+    inputs.lightCount = lights.size();
+    inputs.params.params = {24.0f, Config::Volumetric::DEFAULT_DENSITY, Config::Volumetric::DEFAULT_INTENSITY,
+                            Config::Volumetric::DEFAULT_ANISOTROPY};
+    return inputs;
+}
+
+/**
+ * @brief Single-layer texture filled with one value.
+ */
+VolumetricReference::TextureArray MakeTexture(int channels, float value)
+{
+    VolumetricReference::TextureArray texture;
+    texture.width = 16;
+    texture.height = 16;
+    texture.layers = 1;
+    texture.channels = channels;
+    texture.texels.assign(static_cast<size_t>(16) * 16 * channels, value);
+    return texture;
+}
+
+float Sum(const std::vector<float> &rgb)
+{
+    float sum = 0.0f;
+    for (float v : rgb)
+        sum += v;
+    return sum;
+}
+
+} // namespace
+
+void TestRayConeIntersect()
+{
+    const DirectX::XMFLOAT3 apex = {0.0f, 10.0f, 0.0f};
+    const DirectX::XMFLOAT3 down = {0.0f, -1.0f, 0.0f};
+    const float cosAngle = std::cos(0.5f);
+
+    // Horizontal ray through the cone five meters below the apex
+    DirectX::XMFLOAT2 t = VolumetricReference::RayConeIntersect({-20.0f, 5.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, apex, down,
+                                                                cosAngle, 30.0f);
+    const float halfWidth = 5.0f * std::tan(0.5f);
+    assert(std::fabs(t.x - (20.0f - halfWidth)) < 1e-3f);
+    assert(std::fabs(t.y - (20.0f + halfWidth)) < 1e-3f);
+
+    // Above the apex the ray only crosses the backward nappe
+    t = VolumetricReference::RayConeIntersect({-20.0f, 15.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, apex, down, cosAngle, 30.0f);
+    assert(t.x < 0.0f && t.y < 0.0f);
+
+    // From inside the cone the march starts at the camera
+    t = VolumetricReference::RayConeIntersect({0.0f, 5.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, apex, down, cosAngle, 30.0f);
+    assert(t.x == 0.0f);
+    assert(std::fabs(t.y - halfWidth) < 1e-3f);
+
+    std::cout << "RayConeIntersect test passed." << std::endl;
+}
+
+void TestVectorPathMatchesScalar()
+{
+    // Two lights (one rotated gobo), a checkered gobo and a half-shadowed map exercise every branch
+    std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                         TestLights::AimedAt({-4.0f, 7.0f, 2.0f}, {-1.0f, 0.0f, 0.0f})};
+    lights[0].coneGobo.z = 0.3f;
+    lights.push_back(lights[0]);
+    lights.back().colorInt.w = 0.0f; // Disabled lights are skipped
+
+    VolumetricReference::TextureArray gobo = MakeTexture(4, 1.0f);
+    for (int y = 0; y < gobo.height; ++y)
+        for (int x = 0; x < gobo.width; ++x)
+            if (((x / 4) + (y / 4)) % 2)
+                for (int c = 0; c < 3; ++c)
+                    gobo.texels[((y * gobo.width + x) * 4) + c] = 0.0f;
+    VolumetricReference::TextureArray shadow = MakeTexture(1, 1.0f);
+    shadow.layers = 2;
+    shadow.texels.resize(static_cast<size_t>(16) * 16 * 2, 1.0f);
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 8; ++x)
+            shadow.texels[(y * 16) + x] = 0.0f;
+
+    VolumetricReference::Inputs inputs = MakeInputs(lights);
+    inputs.gobos = &gobo;
+    inputs.shadowMaps = &shadow;
+
+    std::vector<float> rgb;
+    assert(VolumetricReference::Render(inputs, rgb));
+    assert(rgb.size() == static_cast<size_t>(WIDTH) * HEIGHT * 3);
+    assert(Sum(rgb) > 0.0f);
+
+    float peak = 0.0f;
+    for (float v : rgb)
+        peak = (std::max)(peak, v);
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        for (int x = 0; x < WIDTH; ++x)
+        {
+            const DirectX::XMFLOAT3 expected = VolumetricReference::ShadePixel(inputs, x, y);
+            const float *actual = &rgb[((y * WIDTH) + x) * 3];
+            assert(std::fabs(actual[0] - expected.x) <= 1e-4f * peak + 1e-6f);
+            assert(std::fabs(actual[1] - expected.y) <= 1e-4f * peak + 1e-6f);
+            assert(std::fabs(actual[2] - expected.z) <= 1e-4f * peak + 1e-6f);
+        }
+    }
+
+    std::cout << "Vector path matches scalar test passed." << std::endl;
+}
+
+void TestGoboAndShadowTerms()
+{
+    const std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f})};
+    VolumetricReference::Inputs inputs = MakeInputs(lights);
+
+    std::vector<float> open;
+    assert(VolumetricReference::Render(inputs, open));
+    assert(Sum(open) > 0.0f);
+
+    // A black gobo blocks everything
+    const VolumetricReference::TextureArray black = MakeTexture(4, 0.0f);
+    inputs.gobos = &black;
+    std::vector<float> rgb;
+    assert(VolumetricReference::Render(inputs, rgb));
+    assert(Sum(rgb) == 0.0f);
+
+    // A shadow map at the far plane changes nothing
+    const VolumetricReference::TextureArray farDepth = MakeTexture(1, 1.0f);
+    inputs.gobos = nullptr;
+    inputs.shadowMaps = &farDepth;
+    assert(VolumetricReference::Render(inputs, rgb));
+    for (size_t i = 0; i < rgb.size(); ++i)
+        assert(std::fabs(rgb[i] - open[i]) <= 1e-5f * (1.0f + open[i]));
+
+    // An occluder right at the light shadows the cone (only the filtered map edge leaks)
+    const VolumetricReference::TextureArray nearDepth = MakeTexture(1, 0.0f);
+    inputs.shadowMaps = &nearDepth;
+    assert(VolumetricReference::Render(inputs, rgb));
+    assert(Sum(rgb) < 1e-3f * Sum(open));
+
+    // Scene depth in front of the cone stops the march
+    const std::vector<float> depth(static_cast<size_t>(WIDTH) * HEIGHT, 0.0f);
+    inputs.shadowMaps = nullptr;
+    inputs.depth = depth.data();
+    assert(VolumetricReference::Render(inputs, rgb));
+    assert(Sum(rgb) == 0.0f);
+
+    std::cout << "Gobo and shadow terms test passed." << std::endl;
+}
+
+void TestDeterminism()
+{
+    std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                         TestLights::AimedAt({3.0f, 6.0f, -1.0f}, {1.0f, 0.0f, 1.0f})};
+    lights[0].coneGobo.z = 0.7f;
+    const VolumetricReference::Inputs inputs = MakeInputs(lights);
+    std::vector<float> first;
+    std::vector<float> second;
+    assert(VolumetricReference::Render(inputs, first));
+    assert(VolumetricReference::Render(inputs, second));
+    assert(std::memcmp(first.data(), second.data(), first.size() * sizeof(float)) == 0);
+
+    VolumetricReference::Inputs empty = inputs;
+    empty.width = 0;
+    assert(!VolumetricReference::Render(empty, first));
+
+    std::cout << "Determinism test passed." << std::endl;
+}
+
+void TestPerLightStepCount()
+{
+    // goboOff.w overrides the global step count for its light only
+    std::vector<SpotlightData> lights = {TestLights::AimedAt({0.0f, 8.0f, 0.0f}, {0.0f, 0.0f, 0.0f}),
+                                         TestLights::AimedAt({3.0f, 6.0f, -1.0f}, {1.0f, 0.0f, 1.0f})};
+    VolumetricReference::Inputs inputs = MakeInputs(lights);
+    inputs.params.params.x = 8.0f;
+    std::vector<float> expected;
+    assert(VolumetricReference::Render(inputs, expected));
+
+    lights[0].goboOff.w = 8.0f;
+    lights[1].goboOff.w = 8.0f;
+    inputs.params.params.x = 64.0f;
+    std::vector<float> overridden;
+    assert(VolumetricReference::Render(inputs, overridden));
+    assert(std::memcmp(expected.data(), overridden.data(), expected.size() * sizeof(float)) == 0);
+
+    lights[1].goboOff.w = 0.0f;
+    assert(VolumetricReference::Render(inputs, overridden));
+    assert(std::memcmp(expected.data(), overridden.data(), expected.size() * sizeof(float)) != 0);
+
+    std::cout << "Per-light step count test passed." << std::endl;
+}
+
+void TestLoadGobosAndWriteHdr()
+{
+    // 2x2 image with one transparent pixel and a 4x4 opaque one: the first is padded and centered
+    const unsigned char small[16] = {255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 255, 255, 255, 10};
+    const std::vector<unsigned char> large(4 * 4 * 4, 200);
+    std::vector<std::vector<uint8_t>> files(2);
+    auto append = [](void *context, void *data, int size)
+    {
+        auto *file = static_cast<std::vector<uint8_t> *>(context);
+        file->insert(file->end(), static_cast<uint8_t *>(data), static_cast<uint8_t *>(data) + size);
+    };
+    assert(stbi_write_png_to_func(append, &files[0], 2, 2, 4, small, 2 * 4));
+    assert(stbi_write_png_to_func(append, &files[1], 4, 4, 4, large.data(), 4 * 4));
+    files.push_back({1, 2, 3}); // Undecodable files are skipped
+
+    VolumetricReference::TextureArray gobos;
+    assert(VolumetricReference::LoadGobos(files, gobos));
+    assert(gobos.width == 4 && gobos.height == 4 && gobos.layers == 2 && gobos.channels == 4);
+    auto texel = [&](int layer, int x, int y) { return &gobos.texels[(((layer * 4) + y) * 4 + x) * 4]; };
+    assert(texel(0, 0, 0)[0] == 0.0f && texel(0, 0, 0)[3] == 0.0f); // Padding
+    assert(texel(0, 1, 1)[0] == 1.0f && texel(0, 1, 1)[1] == 0.0f); // Red corner, offset by one
+    assert(texel(0, 2, 2)[0] == 0.0f && texel(0, 2, 2)[2] == 0.0f); // Transparent white masked to black
+    assert(std::fabs(texel(1, 3, 3)[1] - 200.0f / 255.0f) < 1e-6f);
+    assert(!VolumetricReference::LoadGobos({{1, 2, 3}}, gobos));
+
+    const std::string fileName = "test_volumetric_reference.hdr";
+    const std::vector<float> rgb(static_cast<size_t>(WIDTH) * HEIGHT * 3, 0.25f);
+    assert(VolumetricReference::WriteHdr(fileName, WIDTH, HEIGHT, rgb));
+    assert(!VolumetricReference::WriteHdr(fileName, WIDTH, HEIGHT + 1, rgb));
+    std::ifstream file(fileName, std::ios::binary);
+    std::string header(10, '\0');
+    file.read(header.data(), 10);
+    file.close();
+    assert(header == "#?RADIANCE");
+    std::remove(fileName.c_str());
+
+    std::cout << "LoadGobos and WriteHdr test passed." << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        TestRayConeIntersect();
+        TestVectorPathMatchesScalar();
+        TestGoboAndShadowTerms();
+        TestDeterminism();
+        TestPerLightStepCount();
+        TestLoadGobosAndWriteHdr();
+        std::cout << "All VolumetricReference tests passed!" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}